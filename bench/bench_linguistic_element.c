@@ -0,0 +1,353 @@
+/**
+ * @file bench_linguistic_element.c
+ * @brief Hash throughput and collision benchmark for linguistic elements.
+ *
+ * Hashes a vocabulary with the byte-at-a-time FNV-1a the map used to rely on
+ * and with hash_linguistic_element, then counts collisions of the full hash,
+ * of its top 32 bits and of different token class sets, and times
+ * LinguisticElementMap adds, with their tail latency, and lookups. The
+ * vocabulary is read from the file given as the first argument, one word per
+ * line, or else generated.
+ * Results are printed as one JSON object per line.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "linguistic_element.h"
+
+#define BENCH_GENERATED_WORDS 200000
+#define BENCH_HASH_ROUNDS 20
+#define BENCH_MAX_WORD 64
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// hash_linguistic_element before it went word-at-a-time, kept as the baseline
+static uint64_t legacy_hash(const Token *tokens, size_t token_count)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < token_count; i++)
+    {
+        for (size_t j = 0; j < tokens[i].length; j++)
+        {
+            hash ^= (uint64_t)(unsigned char)tokens[i].text[j];
+            hash *= 1099511628211ULL;
+        }
+        uint64_t class_hash = 0;
+        for (TokenClassSet classes = tokens[i].classes; classes; classes &= classes - 1)
+        {
+            class_hash ^= (uint64_t)__builtin_ctz(classes);
+        }
+        hash ^= class_hash;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+typedef uint64_t (*HashFn)(const Token *tokens, size_t token_count);
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_words(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+// Reads one word per line and drops duplicates, so every collision is a real one
+static size_t load_words(const char *path, char ***words)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        return 0;
+    }
+
+    size_t count = 0;
+    size_t capacity = 1024;
+    char **list = malloc(capacity * sizeof(char *));
+    char line[BENCH_MAX_WORD * 4];
+    while (list && fgets(line, sizeof(line), file))
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0')
+        {
+            continue;
+        }
+        if (count == capacity)
+        {
+            capacity *= 2;
+            list = realloc(list, capacity * sizeof(char *));
+            if (!list)
+            {
+                break;
+            }
+        }
+        list[count++] = strdup(line);
+    }
+    fclose(file);
+    if (!list)
+    {
+        return 0;
+    }
+
+    qsort(list, count, sizeof(char *), compare_words);
+    size_t unique = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (unique > 0 && strcmp(list[unique - 1], list[i]) == 0)
+        {
+            free(list[i]);
+            continue;
+        }
+        list[unique++] = list[i];
+    }
+    *words = list;
+    return unique;
+}
+
+// Pronounceable words of consonant-vowel syllables; each index spells a different word
+static size_t generate_words(size_t count, char ***words)
+{
+    static const char consonants[] = "bcdfghjklmnprstvwxyz";
+    static const char vowels[] = "aeiou";
+    char **list = malloc(count * sizeof(char *));
+    if (!list)
+    {
+        return 0;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        char word[BENCH_MAX_WORD];
+        size_t length = 0;
+        // Offset so that most words have three or four syllables, like real vocabulary
+        size_t n = i + 10000;
+        while (n > 0 && length + 2 < sizeof(word))
+        {
+            size_t syllable = n % 100;
+            word[length++] = consonants[syllable / 5];
+            word[length++] = vowels[syllable % 5];
+            n /= 100;
+        }
+        word[length] = '\0';
+        list[i] = strdup(word);
+    }
+    *words = list;
+    return count;
+}
+
+static void bench_hash(const char *name, HashFn hash, const Token *tokens, size_t count, size_t bytes)
+{
+    uint64_t sink = 0;
+    uint64_t start = now_ns();
+    for (size_t round = 0; round < BENCH_HASH_ROUNDS; round++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            sink += hash(&tokens[i], 1);
+        }
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    double hashes = (double)count * BENCH_HASH_ROUNDS;
+    printf("{\"benchmark\":\"%s_throughput\",\"words\":%zu,\"ns_per_hash\":%.2f,\"mb_per_s\":%.1f,\"sink\":%llu}\n",
+           name, count, elapsed / hashes, (double)bytes * BENCH_HASH_ROUNDS / (elapsed / 1e9) / 1e6,
+           (unsigned long long)(sink & 1));
+}
+
+// Counts neighbours of a sorted array that agree in the bits kept by mask
+static size_t count_duplicates(const uint64_t *sorted, size_t count, uint64_t mask)
+{
+    size_t duplicates = 0;
+    for (size_t i = 1; i < count; i++)
+    {
+        duplicates += (sorted[i] & mask) == (sorted[i - 1] & mask);
+    }
+    return duplicates;
+}
+
+static void bench_collisions(const char *name, HashFn hash, Token *tokens, size_t count)
+{
+    uint64_t *hashes = malloc(count * sizeof(uint64_t));
+    if (!hashes)
+    {
+        return;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        hashes[i] = hash(&tokens[i], 1);
+    }
+    qsort(hashes, count, sizeof(uint64_t), compare_u64);
+
+    // The same word with another class set is a different element, even where the class ids XOR alike
+    size_t class_collisions = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        Token token = tokens[i];
+        token.classes = TOKEN_CLASS_BIT(CLS_NOUN) | TOKEN_CLASS_BIT(CLS_VERB);
+        uint64_t noun_verb = hash(&token, 1);
+        token.classes = TOKEN_CLASS_BIT(CLS_VERB);
+        class_collisions += hash(&token, 1) == noun_verb;
+        token.classes = TOKEN_CLASS_BIT(CLS_NOUN);
+        uint64_t noun = hash(&token, 1);
+        token.classes = 0;
+        class_collisions += hash(&token, 1) == noun;
+    }
+
+    // Birthday bound for a uniform 32-bit hash
+    double expected = (double)count * (count - 1) / 2 / 4294967296.0;
+    printf("{\"benchmark\":\"%s_collisions\",\"words\":%zu,\"full_64\":%zu,\"top_32\":%zu,\"expected_top_32\":%.2f,"
+           "\"class_variants\":%zu,\"class_variant_pairs\":%zu}\n",
+           name, count, count_duplicates(hashes, count, ~0ULL), count_duplicates(hashes, count, 0xffffffff00000000ULL),
+           expected, class_collisions, count * 2);
+    free(hashes);
+}
+
+// Times every add into a growing map, or into one reserved up front, and reports the tail latency
+static void bench_map_add(const char *name, LinguisticElementMap *map, const Token *tokens, const uint64_t *hashes, size_t count,
+                          uint64_t *samples)
+{
+    size_t failures = 0;
+    uint64_t total = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        ExtendedLinguisticElement element = {
+            .base = {.type = ELEMENT_VOCAB, .tokens = (Token *)&tokens[i], .token_count = 1, .hash = hashes[i]}};
+        uint64_t start = now_ns();
+        failures += linguistic_element_map_add(map, &element) != ERROR_SUCCESS;
+        samples[i] = now_ns() - start;
+        total += samples[i];
+    }
+
+    qsort(samples, count, sizeof(uint64_t), compare_u64);
+    printf("{\"benchmark\":\"%s\",\"elements\":%zu,\"capacity\":%zu,\"ns_per_add\":%.2f,\"p99_ns\":%llu,\"p999_ns\":%llu,"
+           "\"max_ns\":%llu,\"failures\":%zu}\n",
+           name, map->element_count, map->table.capacity, (double)total / count, (unsigned long long)samples[count * 99 / 100],
+           (unsigned long long)samples[count * 999 / 1000], (unsigned long long)samples[count - 1], failures);
+}
+
+static void bench_map(const Token *tokens, size_t count)
+{
+    LimdyArena arena;
+    LinguisticElementMap map;
+    LinguisticElementMap reserved;
+    if (limdy_arena_init(&arena, 0) != ERROR_SUCCESS || linguistic_element_map_init_arena(&map, 16, &arena) != ERROR_SUCCESS ||
+        linguistic_element_map_init_arena(&reserved, 16, &arena) != ERROR_SUCCESS ||
+        linguistic_element_map_reserve(&reserved, count) != ERROR_SUCCESS)
+    {
+        fprintf(stderr, "Failed to create benchmark map\n");
+        return;
+    }
+
+    uint64_t *hashes = malloc(count * sizeof(uint64_t));
+    uint64_t *samples = malloc(count * sizeof(uint64_t));
+    if (!hashes || !samples)
+    {
+        free(hashes);
+        free(samples);
+        limdy_arena_release(&arena);
+        return;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        hashes[i] = hash_linguistic_element(&tokens[i], 1);
+    }
+
+    bench_map_add("map_add", &map, tokens, hashes, count, samples);
+    bench_map_add("map_add_reserved", &reserved, tokens, hashes, count, samples);
+
+    size_t found = 0;
+    uint64_t start = now_ns();
+    for (size_t round = 0; round < BENCH_HASH_ROUNDS; round++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            found += linguistic_element_map_find_tokens(&map, hashes[i], &tokens[i], 1) != NULL;
+        }
+    }
+    uint64_t hit_ns = now_ns() - start;
+
+    size_t missed = 0;
+    start = now_ns();
+    for (size_t round = 0; round < BENCH_HASH_ROUNDS; round++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            missed += linguistic_element_map_find(&map, hashes[i] ^ (round + 1)) == NULL;
+        }
+    }
+    uint64_t miss_ns = now_ns() - start;
+
+    double lookups = (double)count * BENCH_HASH_ROUNDS;
+    printf("{\"benchmark\":\"map_find_hit\",\"lookups\":%.0f,\"ns_per_find\":%.2f,\"found\":%zu}\n", lookups, hit_ns / lookups, found);
+    printf("{\"benchmark\":\"map_find_miss\",\"lookups\":%.0f,\"ns_per_find\":%.2f,\"missed\":%zu}\n", lookups, miss_ns / lookups, missed);
+
+    free(hashes);
+    free(samples);
+    linguistic_element_map_free(&map);
+    linguistic_element_map_free(&reserved);
+    limdy_arena_release(&arena);
+}
+
+int main(int argc, char **argv)
+{
+    LimdyMemoryPoolConfig config = {
+        .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+        .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+        .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+        .max_pools = 1,
+        .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+    if (limdy_memory_pool_init(&config) != ERROR_SUCCESS)
+    {
+        fprintf(stderr, "Failed to initialize memory pool system\n");
+        return EXIT_FAILURE;
+    }
+
+    char **words = NULL;
+    size_t count = argc > 1 ? load_words(argv[1], &words) : generate_words(BENCH_GENERATED_WORDS, &words);
+    Token *tokens = count ? calloc(count, sizeof(Token)) : NULL;
+    if (!tokens)
+    {
+        fprintf(stderr, "Failed to load vocabulary\n");
+        return EXIT_FAILURE;
+    }
+
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        tokens[i].text = words[i];
+        tokens[i].length = strlen(words[i]);
+        bytes += tokens[i].length;
+    }
+
+    bench_hash("hash_fnv1a_legacy", legacy_hash, tokens, count, bytes);
+    bench_hash("hash_linguistic_element", hash_linguistic_element, tokens, count, bytes);
+    bench_collisions("hash_fnv1a_legacy", legacy_hash, tokens, count);
+    bench_collisions("hash_linguistic_element", hash_linguistic_element, tokens, count);
+    bench_map(tokens, count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        free(words[i]);
+    }
+    free(words);
+    free(tokens);
+    limdy_memory_pool_cleanup();
+    return EXIT_SUCCESS;
+}
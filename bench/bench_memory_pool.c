@@ -0,0 +1,147 @@
+/**
+ * @file bench_memory_pool.c
+ * @brief Allocation latency benchmark for a fragmenting pool workload.
+ *
+ * Fills a LIMDY_LARGE_POOL_SIZE pool with randomly sized blocks, frees a
+ * random half of them so the pool is badly fragmented, then measures the
+ * latency of every alloc/free pair while the churn continues. Results are
+ * printed as one JSON object per line.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "memory_pool.h"
+
+#define BENCH_LIVE_BLOCKS 20000
+#define BENCH_OPERATIONS 200000
+#define BENCH_MIN_SIZE 16
+#define BENCH_MAX_SIZE 512
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t next_random(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static size_t random_size(void)
+{
+    return BENCH_MIN_SIZE + next_random() % (BENCH_MAX_SIZE - BENCH_MIN_SIZE);
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void print_percentiles(const char *name, uint64_t *samples, size_t count)
+{
+    qsort(samples, count, sizeof(uint64_t), compare_u64);
+    printf("{\"benchmark\":\"%s\",\"samples\":%zu,\"p50_ns\":%llu,\"p90_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu,\"max_ns\":%llu}\n",
+           name, count,
+           (unsigned long long)samples[count / 2],
+           (unsigned long long)samples[count * 9 / 10],
+           (unsigned long long)samples[count * 99 / 100],
+           (unsigned long long)samples[count * 999 / 1000],
+           (unsigned long long)samples[count - 1]);
+}
+
+int main(void)
+{
+    LimdyMemoryPoolConfig config = {
+        .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+        .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+        .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+        .max_pools = 1,
+        .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+    // Allocation failures are counted, not logged
+    error_set_min_level(ERROR_LEVEL_FATAL);
+
+    if (limdy_memory_pool_init(&config) != ERROR_SUCCESS)
+    {
+        fprintf(stderr, "Failed to initialize memory pool system\n");
+        return EXIT_FAILURE;
+    }
+
+    LimdyMemoryPool *pool = NULL;
+    if (limdy_memory_pool_create(LIMDY_LARGE_POOL_SIZE, &pool) != ERROR_SUCCESS)
+    {
+        fprintf(stderr, "Failed to create benchmark pool\n");
+        return EXIT_FAILURE;
+    }
+
+    void **live = calloc(BENCH_LIVE_BLOCKS, sizeof(void *));
+    uint64_t *alloc_samples = malloc(BENCH_OPERATIONS * sizeof(uint64_t));
+    uint64_t *free_samples = malloc(BENCH_OPERATIONS * sizeof(uint64_t));
+    if (!live || !alloc_samples || !free_samples)
+    {
+        fprintf(stderr, "Failed to allocate benchmark buffers\n");
+        return EXIT_FAILURE;
+    }
+
+    // Fill, then punch random holes so the pool is fragmented before measuring
+    for (size_t i = 0; i < BENCH_LIVE_BLOCKS; i++)
+    {
+        live[i] = limdy_memory_pool_alloc_from(pool, random_size());
+    }
+    for (size_t i = 0; i < BENCH_LIVE_BLOCKS; i++)
+    {
+        if (next_random() & 1)
+        {
+            limdy_memory_pool_free_to(pool, live[i]);
+            live[i] = NULL;
+        }
+    }
+
+    size_t alloc_count = 0;
+    size_t free_count = 0;
+    size_t failures = 0;
+    for (size_t op = 0; op < BENCH_OPERATIONS; op++)
+    {
+        size_t slot = next_random() % BENCH_LIVE_BLOCKS;
+        if (live[slot])
+        {
+            uint64_t start = now_ns();
+            limdy_memory_pool_free_to(pool, live[slot]);
+            free_samples[free_count++] = now_ns() - start;
+            live[slot] = NULL;
+        }
+        else
+        {
+            size_t size = random_size();
+            uint64_t start = now_ns();
+            live[slot] = limdy_memory_pool_alloc_from(pool, size);
+            alloc_samples[alloc_count++] = now_ns() - start;
+            failures += live[slot] == NULL;
+        }
+    }
+
+    print_percentiles("pool_fragmenting_alloc", alloc_samples, alloc_count);
+    print_percentiles("pool_fragmenting_free", free_samples, free_count);
+    printf("{\"benchmark\":\"pool_fragmenting_failures\",\"count\":%zu}\n", failures);
+
+    free(live);
+    free(alloc_samples);
+    free(free_samples);
+    limdy_memory_pool_destroy(pool);
+    limdy_memory_pool_cleanup();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,1482 @@
+/**
+ * @file limdy_bench.c
+ * @brief Regression benchmark suite for the Limdy project.
+ *
+ * Microbenchmarks cover the memory pool (alloc, free and realloc, both
+ * through the slab allocator and the pools), the pool size and address
+ * indexes, hash_linguistic_element, LinguisticElementMap adds and finds and
+ * opening and querying a mapped bank, the built-in tokenizer, the review
+ * scheduler and batch answer scoring with each vector kernel. Batch
+ * exercise generation runs at 1, 2, 4, ... workers. Worker startup is
+ * timed cold and warm from a snapshot. The end-to-end
+ * benchmark runs translator_aligner_process with synthetic
+ * services at 1, 2, 4, ... up to the maximum thread count.
+ *
+ * Every result is one JSON object per line, after a first line describing
+ * the run, so results of two releases can be compared line by line:
+ *
+ *     limdy_bench [--threads N] [--filter SUBSTRING] [--quick]
+ *
+ * Micro timings are taken over batches of LIMDY_BENCH_BATCH operations, so
+ * percentiles are of per-operation batch averages and not of single calls.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "memory_pool.h"
+#include "limdy_utils.h"
+#include "rbtree.h"
+#include "arena.h"
+#include "linguistic_element.h"
+#include "banker.h"
+#include "teacher.h"
+#include "exerciser.h"
+#include "assessor.h"
+#include "renderer.h"
+#include "translator_aligner.h"
+#include "limdy.h"
+
+#define LIMDY_BENCH_VERSION 1
+#define LIMDY_BENCH_BATCH 64
+#define BENCH_POOL_OPERATIONS 200000
+#define BENCH_REALLOC_CHAINS 20000
+#define BENCH_RBTREE_POOLS 4096
+#define BENCH_HASH_TOKENS 100000
+#define BENCH_HASH_ROUNDS 10
+#define BENCH_MAP_ELEMENTS 100000
+#define BENCH_BANK_PATH "limdy_bench.bank"
+#define BENCH_BANK_OPENS 256
+#define BENCH_E2E_TEXTS 256
+#define BENCH_E2E_WORDS 24
+#define BENCH_E2E_CALLS 4000
+#define BENCH_TOKENIZE_ROUNDS 200
+#define BENCH_TEACHER_USERS 1000
+#define BENCH_TEACHER_ITEMS 1000000
+#define BENCH_TEACHER_QUERIES 100000
+#define BENCH_TEACHER_DUE 10
+#define BENCH_EXERCISER_ROUNDS 20
+#define BENCH_ASSESSOR_ROUNDS 200
+#define BENCH_SNAPSHOT_DIR "limdy_bench.snapshot.d"
+#define BENCH_MAX_WORD 16
+#define BENCH_LARGE_POOL_SIZE (256 * 1024 * 1024)
+
+typedef struct
+{
+    const char *filter;
+    size_t max_threads;
+    size_t scale_down; // Divides every operation count
+} BenchOptions;
+
+static BenchOptions options = {NULL, 0, 1};
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t next_random(uint64_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static bool bench_selected(const char *name)
+{
+    return !options.filter || strstr(name, options.filter) != NULL;
+}
+
+static size_t scaled(size_t count)
+{
+    size_t result = count / options.scale_down;
+    return result < LIMDY_BENCH_BATCH ? LIMDY_BENCH_BATCH : result;
+}
+
+/**
+ * @brief Per-operation timings of one microbenchmark, one sample per batch.
+ */
+typedef struct
+{
+    double *samples;
+    size_t count;
+    size_t capacity;
+    size_t operations;
+    uint64_t total_ns;
+} BenchTimer;
+
+static bool timer_init(BenchTimer *timer, size_t operations)
+{
+    timer->capacity = operations / LIMDY_BENCH_BATCH + 1;
+    timer->samples = malloc(timer->capacity * sizeof(double));
+    timer->count = 0;
+    timer->operations = 0;
+    timer->total_ns = 0;
+    return timer->samples != NULL;
+}
+
+static void timer_add(BenchTimer *timer, uint64_t elapsed_ns, size_t operations)
+{
+    if (operations == 0)
+    {
+        return;
+    }
+    if (timer->count < timer->capacity)
+    {
+        timer->samples[timer->count++] = (double)elapsed_ns / operations;
+    }
+    timer->operations += operations;
+    timer->total_ns += elapsed_ns;
+}
+
+static double timer_percentile(const BenchTimer *timer, double percentile)
+{
+    size_t index = (size_t)(percentile / 100.0 * (timer->count - 1) + 0.5);
+    return timer->samples[index];
+}
+
+static void timer_report(const char *name, BenchTimer *timer)
+{
+    if (timer->count == 0)
+    {
+        free(timer->samples);
+        return;
+    }
+    qsort(timer->samples, timer->count, sizeof(double), compare_double);
+    double ns_per_op = (double)timer->total_ns / timer->operations;
+    printf("{\"benchmark\":\"%s\",\"group\":\"micro\",\"operations\":%zu,\"ns_per_op\":%.2f,\"ops_per_sec\":%.0f,"
+           "\"p50_ns\":%.2f,\"p90_ns\":%.2f,\"p99_ns\":%.2f,\"max_ns\":%.2f}\n",
+           name, timer->operations, ns_per_op, ns_per_op > 0 ? 1e9 / ns_per_op : 0.0, timer_percentile(timer, 50),
+           timer_percentile(timer, 90), timer_percentile(timer, 99), timer->samples[timer->count - 1]);
+    free(timer->samples);
+}
+
+// Pronounceable words of consonant-vowel syllables; each index spells a different word
+static void spell_word(size_t index, char *word, size_t size)
+{
+    static const char consonants[] = "bcdfghjklmnprstvwxyz";
+    static const char vowels[] = "aeiou";
+    size_t length = 0;
+    size_t n = index + 10000;
+    while (n > 0 && length + 2 < size)
+    {
+        size_t syllable = n % 100;
+        word[length++] = consonants[syllable / 5];
+        word[length++] = vowels[syllable % 5];
+        n /= 100;
+    }
+    word[length] = '\0';
+}
+
+static Token *generate_tokens(size_t count, char **storage)
+{
+    Token *tokens = calloc(count, sizeof(Token));
+    char *text = malloc(count * BENCH_MAX_WORD);
+    if (!tokens || !text)
+    {
+        free(tokens);
+        free(text);
+        return NULL;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        tokens[i].text = text + i * BENCH_MAX_WORD;
+        spell_word(i, tokens[i].text, BENCH_MAX_WORD);
+        tokens[i].length = strlen(tokens[i].text);
+    }
+    *storage = text;
+    return tokens;
+}
+
+/**
+ * @brief Allocates and frees batches of one size, measuring each phase.
+ */
+static void bench_alloc_free(const char *alloc_name, const char *free_name, size_t size)
+{
+    if (!bench_selected(alloc_name) && !bench_selected(free_name))
+    {
+        return;
+    }
+
+    size_t operations = scaled(BENCH_POOL_OPERATIONS);
+    BenchTimer alloc_timer, free_timer;
+    if (!timer_init(&alloc_timer, operations) || !timer_init(&free_timer, operations))
+    {
+        free(alloc_timer.samples);
+        return;
+    }
+
+    void *blocks[LIMDY_BENCH_BATCH];
+    for (size_t done = 0; done < operations; done += LIMDY_BENCH_BATCH)
+    {
+        uint64_t start = now_ns();
+        for (size_t i = 0; i < LIMDY_BENCH_BATCH; i++)
+        {
+            blocks[i] = limdy_memory_pool_alloc(size);
+        }
+        uint64_t middle = now_ns();
+        for (size_t i = 0; i < LIMDY_BENCH_BATCH; i++)
+        {
+            limdy_memory_pool_free(blocks[i]);
+        }
+        uint64_t end = now_ns();
+        timer_add(&alloc_timer, middle - start, LIMDY_BENCH_BATCH);
+        timer_add(&free_timer, end - middle, LIMDY_BENCH_BATCH);
+    }
+
+    timer_report(alloc_name, &alloc_timer);
+    timer_report(free_name, &free_timer);
+}
+
+static void bench_realloc(void)
+{
+    const char *name = "pool_realloc_grow";
+    if (!bench_selected(name))
+    {
+        return;
+    }
+
+    // Each chain doubles one allocation from 16 bytes to 4 KiB
+    size_t chains = scaled(BENCH_REALLOC_CHAINS);
+    BenchTimer timer;
+    if (!timer_init(&timer, chains * 8))
+    {
+        return;
+    }
+    for (size_t chain = 0; chain < chains; chain++)
+    {
+        void *block = limdy_memory_pool_alloc(16);
+        uint64_t start = now_ns();
+        for (size_t size = 32; size <= 4096; size *= 2)
+        {
+            void *grown = limdy_memory_pool_realloc(block, size);
+            if (grown)
+            {
+                block = grown;
+            }
+        }
+        timer_add(&timer, now_ns() - start, 8);
+        limdy_memory_pool_free(block);
+    }
+    timer_report(name, &timer);
+}
+
+static int bench_compare_size(const LimdyRBNode *a, const LimdyRBNode *b)
+{
+    const LimdyMemoryPool *pool_a = LIMDY_RB_ENTRY(a, LimdyMemoryPool, size_node);
+    const LimdyMemoryPool *pool_b = LIMDY_RB_ENTRY(b, LimdyMemoryPool, size_node);
+    if (pool_a->total_size != pool_b->total_size)
+    {
+        return pool_a->total_size < pool_b->total_size ? -1 : 1;
+    }
+    return (pool_a > pool_b) - (pool_a < pool_b);
+}
+
+static int bench_compare_size_key(const void *key, const LimdyRBNode *node)
+{
+    size_t size = *(const size_t *)key;
+    size_t total_size = LIMDY_RB_ENTRY(node, LimdyMemoryPool, size_node)->total_size;
+    return (size > total_size) - (size < total_size);
+}
+
+static int bench_compare_address(const LimdyRBNode *a, const LimdyRBNode *b)
+{
+    uintptr_t memory_a = (uintptr_t)LIMDY_RB_ENTRY(a, LimdyMemoryPool, address_node)->memory;
+    uintptr_t memory_b = (uintptr_t)LIMDY_RB_ENTRY(b, LimdyMemoryPool, address_node)->memory;
+    return (memory_a > memory_b) - (memory_a < memory_b);
+}
+
+static int bench_compare_address_key(const void *key, const LimdyRBNode *node)
+{
+    uintptr_t address = (uintptr_t)key;
+    uintptr_t memory = (uintptr_t)LIMDY_RB_ENTRY(node, LimdyMemoryPool, address_node)->memory;
+    return (address > memory) - (address < memory);
+}
+
+static void bench_rbtree(void)
+{
+    if (!bench_selected("rbtree"))
+    {
+        return;
+    }
+
+    // The indexes only read total_size and memory, so pools need not be live
+    size_t count = scaled(BENCH_RBTREE_POOLS);
+    LimdyMemoryPool *pools = calloc(count, sizeof(LimdyMemoryPool));
+    size_t *sizes = malloc(count * sizeof(size_t));
+    BenchTimer insert_timer, find_timer, owner_timer, remove_timer;
+    if (!pools || !sizes || !timer_init(&insert_timer, count) || !timer_init(&find_timer, count) ||
+        !timer_init(&owner_timer, count) || !timer_init(&remove_timer, count))
+    {
+        free(pools);
+        free(sizes);
+        return;
+    }
+
+    // Pools of up to 16MB laid out one after another from a fake base address
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    uintptr_t address = (uintptr_t)1 << 40;
+    for (size_t i = 0; i < count; i++)
+    {
+        pools[i].total_size = 4096 + (next_random(&state) % (1u << 24));
+        pools[i].memory = (void *)address;
+        address += ALIGN_SIZE(pools[i].total_size, LIMDY_SLAB_SPAN_SIZE);
+        limdy_rbtree_node_clear(&pools[i].size_node);
+        limdy_rbtree_node_clear(&pools[i].address_node);
+        sizes[i] = next_random(&state) % (1u << 24);
+    }
+
+    LimdyRBTree size_index, address_index;
+    limdy_rbtree_init(&size_index, bench_compare_size);
+    limdy_rbtree_init(&address_index, bench_compare_address);
+    size_t found = 0;
+    for (size_t done = 0; done < count; done += LIMDY_BENCH_BATCH)
+    {
+        size_t batch = count - done < LIMDY_BENCH_BATCH ? count - done : LIMDY_BENCH_BATCH;
+        uint64_t start = now_ns();
+        for (size_t i = done; i < done + batch; i++)
+        {
+            limdy_rbtree_insert(&size_index, &pools[i].size_node);
+        }
+        timer_add(&insert_timer, now_ns() - start, batch);
+        for (size_t i = done; i < done + batch; i++)
+        {
+            limdy_rbtree_insert(&address_index, &pools[i].address_node);
+        }
+    }
+    for (size_t done = 0; done < count; done += LIMDY_BENCH_BATCH)
+    {
+        size_t batch = count - done < LIMDY_BENCH_BATCH ? count - done : LIMDY_BENCH_BATCH;
+        uint64_t start = now_ns();
+        for (size_t i = done; i < done + batch; i++)
+        {
+            found += limdy_rbtree_lower_bound(&size_index, &sizes[i], bench_compare_size_key) != NULL;
+        }
+        timer_add(&find_timer, now_ns() - start, batch);
+    }
+    size_t owners = 0;
+    for (size_t done = 0; done < count; done += LIMDY_BENCH_BATCH)
+    {
+        size_t batch = count - done < LIMDY_BENCH_BATCH ? count - done : LIMDY_BENCH_BATCH;
+        uint64_t start = now_ns();
+        for (size_t i = done; i < done + batch; i++)
+        {
+            LimdyMemoryPool *pool = &pools[(i * 7919) % count];
+            const char *ptr = (const char *)pool->memory + sizes[i] % pool->total_size;
+            LimdyRBNode *node = limdy_rbtree_floor(&address_index, ptr, bench_compare_address_key);
+            owners += node && LIMDY_RB_ENTRY(node, LimdyMemoryPool, address_node) == pool;
+        }
+        timer_add(&owner_timer, now_ns() - start, batch);
+    }
+
+    // Validation runs outside the timings
+    bool valid = limdy_rbtree_validate(&size_index) && limdy_rbtree_validate(&address_index);
+
+    for (size_t done = 0; done < count; done += LIMDY_BENCH_BATCH)
+    {
+        size_t batch = count - done < LIMDY_BENCH_BATCH ? count - done : LIMDY_BENCH_BATCH;
+        uint64_t start = now_ns();
+        for (size_t i = done; i < done + batch; i++)
+        {
+            limdy_rbtree_remove(&size_index, &pools[i].size_node);
+        }
+        timer_add(&remove_timer, now_ns() - start, batch);
+        if (done % (16 * LIMDY_BENCH_BATCH) == 0)
+        {
+            valid = valid && limdy_rbtree_validate(&size_index);
+        }
+    }
+    limdy_rbtree_destroy(&size_index);
+    limdy_rbtree_destroy(&address_index);
+
+    timer_report("rbtree_insert", &insert_timer);
+    timer_report("rbtree_find_best_fit", &find_timer);
+    timer_report("rbtree_find_owner", &owner_timer);
+    timer_report("rbtree_remove", &remove_timer);
+    if (found == 0)
+    {
+        fprintf(stderr, "rbtree_find_best_fit found nothing\n");
+    }
+    if (owners != count)
+    {
+        fprintf(stderr, "rbtree_find_owner missed %zu owners\n", count - owners);
+    }
+    if (!valid)
+    {
+        fprintf(stderr, "rbtree_validate failed\n");
+    }
+    free(pools);
+    free(sizes);
+}
+
+static void bench_hash(const char *name, const Token *tokens, size_t count, size_t tokens_per_element)
+{
+    if (!bench_selected(name))
+    {
+        return;
+    }
+
+    size_t elements = count - tokens_per_element + 1;
+    BenchTimer timer;
+    if (!timer_init(&timer, elements * BENCH_HASH_ROUNDS))
+    {
+        return;
+    }
+
+    volatile uint64_t sink = 0;
+    for (size_t round = 0; round < BENCH_HASH_ROUNDS; round++)
+    {
+        for (size_t done = 0; done < elements; done += LIMDY_BENCH_BATCH)
+        {
+            size_t batch = elements - done < LIMDY_BENCH_BATCH ? elements - done : LIMDY_BENCH_BATCH;
+            uint64_t hash = 0;
+            uint64_t start = now_ns();
+            for (size_t i = done; i < done + batch; i++)
+            {
+                hash ^= hash_linguistic_element(&tokens[i], tokens_per_element);
+            }
+            timer_add(&timer, now_ns() - start, batch);
+            sink ^= hash;
+        }
+    }
+    timer_report(name, &timer);
+}
+
+static void bench_map(const Token *tokens, size_t count)
+{
+    if (!bench_selected("map_"))
+    {
+        return;
+    }
+
+    LimdyArena arena;
+    LinguisticElementMap map;
+    uint64_t *hashes = malloc(count * sizeof(uint64_t));
+    BenchTimer add_timer, hit_timer, miss_timer;
+    if (!hashes || limdy_arena_init(&arena, 0) != ERROR_SUCCESS)
+    {
+        free(hashes);
+        return;
+    }
+    if (linguistic_element_map_init_arena(&map, 16, &arena) != ERROR_SUCCESS || !timer_init(&add_timer, count) ||
+        !timer_init(&hit_timer, count) || !timer_init(&miss_timer, count))
+    {
+        limdy_arena_release(&arena);
+        free(hashes);
+        return;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        hashes[i] = hash_linguistic_element(&tokens[i], 1);
+    }
+
+    for (size_t done = 0; done < count; done += LIMDY_BENCH_BATCH)
+    {
+        size_t batch = count - done < LIMDY_BENCH_BATCH ? count - done : LIMDY_BENCH_BATCH;
+        uint64_t start = now_ns();
+        for (size_t i = done; i < done + batch; i++)
+        {
+            ExtendedLinguisticElement element = {
+                .base = {.type = ELEMENT_VOCAB, .tokens = (Token *)&tokens[i], .token_count = 1, .hash = hashes[i]}};
+            linguistic_element_map_add(&map, &element);
+        }
+        timer_add(&add_timer, now_ns() - start, batch);
+    }
+
+    size_t found = 0;
+    for (size_t done = 0; done < count; done += LIMDY_BENCH_BATCH)
+    {
+        size_t batch = count - done < LIMDY_BENCH_BATCH ? count - done : LIMDY_BENCH_BATCH;
+        uint64_t start = now_ns();
+        for (size_t i = done; i < done + batch; i++)
+        {
+            found += linguistic_element_map_find_tokens(&map, hashes[i], &tokens[i], 1) != NULL;
+        }
+        timer_add(&hit_timer, now_ns() - start, batch);
+    }
+    for (size_t done = 0; done < count; done += LIMDY_BENCH_BATCH)
+    {
+        size_t batch = count - done < LIMDY_BENCH_BATCH ? count - done : LIMDY_BENCH_BATCH;
+        uint64_t start = now_ns();
+        for (size_t i = done; i < done + batch; i++)
+        {
+            found += linguistic_element_map_find(&map, ~hashes[i]) != NULL;
+        }
+        timer_add(&miss_timer, now_ns() - start, batch);
+    }
+
+    timer_report("map_add", &add_timer);
+    timer_report("map_find_hit", &hit_timer);
+    timer_report("map_find_miss", &miss_timer);
+    if (found != count)
+    {
+        fprintf(stderr, "map_find found %zu of %zu elements\n", found, count);
+    }
+    linguistic_element_map_free(&map);
+    limdy_arena_release(&arena);
+    free(hashes);
+}
+
+static void bench_bank(const Token *tokens, size_t count)
+{
+    if (!bench_selected("bank_"))
+    {
+        return;
+    }
+
+    BankerWriter *writer;
+    if (banker_writer_create(&writer) != ERROR_SUCCESS)
+    {
+        return;
+    }
+    uint64_t *hashes = malloc(count * sizeof(uint64_t));
+    bool written = hashes != NULL;
+    for (size_t i = 0; written && i < count; i++)
+    {
+        hashes[i] = hash_linguistic_element(&tokens[i], 1);
+        LinguisticElement element = {.type = ELEMENT_VOCAB, .tokens = (Token *)&tokens[i], .token_count = 1, .hash = hashes[i]};
+        written = banker_writer_add(writer, &element) == ERROR_SUCCESS;
+    }
+    written = written && banker_writer_write(writer, BENCH_BANK_PATH) == ERROR_SUCCESS;
+    banker_writer_destroy(writer);
+
+    BenchTimer open_timer, hit_timer, miss_timer;
+    if (!written || !timer_init(&open_timer, BENCH_BANK_OPENS) || !timer_init(&hit_timer, count) || !timer_init(&miss_timer, count))
+    {
+        remove(BENCH_BANK_PATH);
+        free(hashes);
+        return;
+    }
+
+    // Opening maps the bank and checks its header, whatever its size
+    for (size_t done = 0; done < BENCH_BANK_OPENS; done += LIMDY_BENCH_BATCH)
+    {
+        uint64_t start = now_ns();
+        for (size_t i = 0; i < LIMDY_BENCH_BATCH; i++)
+        {
+            Banker *bank;
+            if (banker_open(BENCH_BANK_PATH, &bank) == ERROR_SUCCESS)
+            {
+                banker_close(bank);
+            }
+        }
+        timer_add(&open_timer, now_ns() - start, LIMDY_BENCH_BATCH);
+    }
+
+    Banker *bank;
+    size_t found = 0;
+    if (banker_open(BENCH_BANK_PATH, &bank) == ERROR_SUCCESS)
+    {
+        BankerElement element;
+        for (size_t done = 0; done < count; done += LIMDY_BENCH_BATCH)
+        {
+            size_t batch = count - done < LIMDY_BENCH_BATCH ? count - done : LIMDY_BENCH_BATCH;
+            uint64_t start = now_ns();
+            for (size_t i = done; i < done + batch; i++)
+            {
+                found += banker_find_tokens(bank, hashes[i], &tokens[i], 1, &element);
+            }
+            timer_add(&hit_timer, now_ns() - start, batch);
+        }
+        for (size_t done = 0; done < count; done += LIMDY_BENCH_BATCH)
+        {
+            size_t batch = count - done < LIMDY_BENCH_BATCH ? count - done : LIMDY_BENCH_BATCH;
+            uint64_t start = now_ns();
+            for (size_t i = done; i < done + batch; i++)
+            {
+                found += banker_find(bank, ~hashes[i], &element);
+            }
+            timer_add(&miss_timer, now_ns() - start, batch);
+        }
+        banker_close(bank);
+    }
+
+    timer_report("bank_open", &open_timer);
+    timer_report("bank_find_hit", &hit_timer);
+    timer_report("bank_find_miss", &miss_timer);
+    if (found != count)
+    {
+        fprintf(stderr, "bank_find found %zu of %zu elements\n", found, count);
+    }
+    remove(BENCH_BANK_PATH);
+    free(hashes);
+}
+
+// Synthetic services: the "translation" reverses every word, so source and target tokens pair up
+static ErrorCode synthetic_translate(const char *text, const char *source_lang, const char *target_lang, char **translated_text)
+{
+    (void)source_lang;
+    (void)target_lang;
+    size_t length = strlen(text);
+    char *translated = malloc(length + 1);
+    if (!translated)
+    {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    size_t i = 0;
+    while (i <= length)
+    {
+        size_t end = i;
+        while (end < length && text[end] != ' ')
+        {
+            end++;
+        }
+        for (size_t j = i; j < end; j++)
+        {
+            translated[j] = text[end - 1 - (j - i)];
+        }
+        translated[end] = text[end];
+        i = end + 1;
+    }
+    *translated_text = translated;
+    return ERROR_SUCCESS;
+}
+
+static size_t count_words(const char *text)
+{
+    size_t words = 0;
+    bool in_word = false;
+    for (; *text; text++)
+    {
+        bool letter = *text != ' ';
+        words += letter && !in_word;
+        in_word = letter;
+    }
+    return words;
+}
+
+static ErrorCode synthetic_attention(const char *source_text, const char *target_text, LimdyMatrix *attention)
+{
+    size_t rows = count_words(source_text);
+    size_t cols = count_words(target_text);
+    RETURN_IF_ERROR(limdy_matrix_init(attention, rows, cols));
+    for (size_t i = 0; i < rows; i++)
+    {
+        float *row = limdy_matrix_row(attention, i);
+        for (size_t j = 0; j < cols; j++)
+        {
+            row[j] = i == j ? 0.9f : 0.1f / (float)cols;
+        }
+    }
+    return ERROR_SUCCESS;
+}
+
+static void synthetic_free_translation(char *translated_text, float **attention_matrix, size_t rows)
+{
+    (void)attention_matrix;
+    (void)rows;
+    free(translated_text);
+}
+
+static ErrorCode synthetic_tokenize_spans(const char *text, size_t length, Language lang, Token *spans, size_t capacity, size_t *token_count)
+{
+    (void)lang;
+    size_t count = 0;
+    size_t i = 0;
+    while (i < length)
+    {
+        while (i < length && text[i] == ' ')
+        {
+            i++;
+        }
+        size_t start = i;
+        while (i < length && text[i] != ' ')
+        {
+            i++;
+        }
+        if (i > start)
+        {
+            if (count < capacity)
+            {
+                spans[count].offset = start;
+                spans[count].length = i - start;
+            }
+            count++;
+        }
+    }
+    *token_count = count;
+    return ERROR_SUCCESS;
+}
+
+static ErrorCode synthetic_tokenize(const char *text, Language lang, Token **tokens, size_t *token_count)
+{
+    (void)text;
+    (void)lang;
+    (void)tokens;
+    (void)token_count;
+    return ERROR_RENDERER_TOKENIZATION_FAILED;
+}
+
+static void synthetic_free_tokens(Token *tokens, size_t token_count)
+{
+    (void)tokens;
+    (void)token_count;
+}
+
+static ErrorCode synthetic_classify(Token *tokens, size_t token_count)
+{
+    (void)tokens;
+    (void)token_count;
+    return ERROR_SUCCESS;
+}
+
+static TranslationService synthetic_translation_service = {
+    .translate = synthetic_translate,
+    .get_attention_dense = synthetic_attention,
+    .free_translation = synthetic_free_translation};
+
+typedef struct
+{
+    TranslatorAligner *ta;
+    char **texts;
+    size_t first_text;
+    size_t calls;
+    double *latencies; // Per call, in nanoseconds
+    size_t failures;
+} E2EWorker;
+
+static void *e2e_worker(void *arg)
+{
+    E2EWorker *worker = arg;
+    for (size_t call = 0; call < worker->calls; call++)
+    {
+        const char *text = worker->texts[(worker->first_text + call) % BENCH_E2E_TEXTS];
+        char **aligned_text = NULL;
+        size_t aligned_size = 0;
+        uint64_t start = now_ns();
+        ErrorCode error = translator_aligner_process(worker->ta, text, "en", "xx", &aligned_text, &aligned_size);
+        worker->latencies[call] = (double)(now_ns() - start);
+        if (error == ERROR_SUCCESS)
+        {
+            free_aligned_text(aligned_text, aligned_size);
+        }
+        else
+        {
+            worker->failures++;
+        }
+    }
+    return NULL;
+}
+
+static char **e2e_texts(void)
+{
+    char **texts = calloc(BENCH_E2E_TEXTS, sizeof(char *));
+    if (!texts)
+    {
+        return NULL;
+    }
+    uint64_t state = 0x2545F4914F6CDD1Dull;
+    for (size_t t = 0; t < BENCH_E2E_TEXTS; t++)
+    {
+        texts[t] = malloc(BENCH_E2E_WORDS * BENCH_MAX_WORD);
+        if (!texts[t])
+        {
+            return texts;
+        }
+        size_t length = 0;
+        for (size_t w = 0; w < BENCH_E2E_WORDS; w++)
+        {
+            char word[BENCH_MAX_WORD];
+            spell_word(next_random(&state) % 5000, word, sizeof(word));
+            length += (size_t)sprintf(texts[t] + length, w == 0 ? "%s" : " %s", word);
+        }
+    }
+    return texts;
+}
+
+/**
+ * @brief A worker's caches: what a new replica builds at startup.
+ */
+typedef struct
+{
+    LimdyMemoryPool *pool;
+    Renderer *renderer;
+    TranslationMemory *memory;
+} StartupWorker;
+
+static void startup_worker_destroy(StartupWorker *worker)
+{
+    translation_memory_destroy(worker->memory);
+    if (worker->renderer)
+    {
+        renderer_destroy(worker->renderer);
+    }
+    limdy_memory_pool_destroy(worker->pool);
+}
+
+/**
+ * @brief Starts a worker and warms it on every text: cold from the services, or warm from a snapshot.
+ *
+ * @return The number of texts that failed.
+ */
+static size_t startup_worker_run(StartupWorker *worker, char **texts, LimdySnapshot *snapshot)
+{
+    memset(worker, 0, sizeof(StartupWorker));
+    TranslationMemoryConfig config = LIMDY_TRANSLATION_MEMORY_CONFIG_DEFAULT;
+    if (limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &worker->pool) != ERROR_SUCCESS ||
+        (snapshot && limdy_snapshot_translation_store(snapshot, &config.store) != ERROR_SUCCESS) ||
+        translation_memory_create(&config, &worker->memory) != ERROR_SUCCESS)
+    {
+        return BENCH_E2E_TEXTS;
+    }
+
+    // The renderer frees its services to its pool
+    TokenizationService *tokenization = limdy_memory_pool_alloc_from(worker->pool, sizeof(TokenizationService));
+    ClassificationService *classification = limdy_memory_pool_alloc_from(worker->pool, sizeof(ClassificationService));
+    if (!tokenization || !classification)
+    {
+        return BENCH_E2E_TEXTS;
+    }
+    *tokenization = (TokenizationService){
+        .tokenize = synthetic_tokenize, .free_tokens = synthetic_free_tokens, .tokenize_spans = synthetic_tokenize_spans};
+    *classification = (ClassificationService){.classify = synthetic_classify};
+    worker->renderer = renderer_create(worker->pool, tokenization, classification);
+    if (!worker->renderer || renderer_enable_cache(worker->renderer, BENCH_E2E_TEXTS * 2) != ERROR_SUCCESS ||
+        (snapshot && limdy_snapshot_attach_renderer(snapshot, worker->renderer) != ERROR_SUCCESS))
+    {
+        return BENCH_E2E_TEXTS;
+    }
+
+    size_t failures = 0;
+    for (size_t t = 0; t < BENCH_E2E_TEXTS; t++)
+    {
+        const TranslationMemoryHit *hit;
+        ErrorCode error = translation_memory_lookup(worker->memory, texts[t], "en", "xx", &hit);
+        if (error == ERROR_SUCCESS)
+        {
+            translation_memory_release(hit);
+        }
+        else
+        {
+            char *translated = NULL;
+            LimdyMatrix attention = {0};
+            error = synthetic_translate(texts[t], "en", "xx", &translated);
+            error = error == ERROR_SUCCESS ? synthetic_attention(texts[t], translated, &attention) : error;
+            error = error == ERROR_SUCCESS ? translation_memory_insert(worker->memory, texts[t], "en", "xx", translated, &attention)
+                                           : error;
+            limdy_matrix_free(&attention);
+            free(translated);
+        }
+
+        const RendererResult *result;
+        if (error == ERROR_SUCCESS && renderer_tokenize_shared(worker->renderer, texts[t], LANG_ENGLISH, &result) == ERROR_SUCCESS)
+        {
+            renderer_release_shared(worker->renderer, result);
+        }
+        else
+        {
+            failures++;
+        }
+    }
+    return failures;
+}
+
+static void bench_startup(void)
+{
+    if (!bench_selected("startup"))
+    {
+        return;
+    }
+
+    char **texts = e2e_texts();
+    bool ready = texts != NULL;
+    for (size_t t = 0; ready && t < BENCH_E2E_TEXTS; t++)
+    {
+        ready = texts[t] != NULL;
+    }
+
+    // A cold worker pays for every text; its caches become the snapshot
+    LimdyStartupReport cold = {0}, warm = {0};
+    StartupWorker worker;
+    size_t failures = 0;
+    if (ready)
+    {
+        limdy_startup_begin(&cold);
+        failures += startup_worker_run(&worker, texts, NULL);
+        limdy_startup_end(&cold, NULL);
+
+        LimdySnapshotWriter *writer;
+        ready = limdy_snapshot_writer_create(&writer) == ERROR_SUCCESS;
+        if (ready)
+        {
+            ready = limdy_snapshot_writer_add_translations(writer, worker.memory) == ERROR_SUCCESS &&
+                    limdy_snapshot_writer_add_renders(writer, worker.renderer->cache) == ERROR_SUCCESS &&
+                    limdy_snapshot_writer_write(writer, BENCH_SNAPSHOT_DIR) == ERROR_SUCCESS;
+            limdy_snapshot_writer_destroy(writer);
+        }
+        startup_worker_destroy(&worker);
+    }
+
+    // A warm worker opens the snapshot and pages in the same texts
+    LimdySnapshot *snapshot = NULL;
+    if (ready)
+    {
+        limdy_startup_begin(&warm);
+        ready = limdy_snapshot_open(BENCH_SNAPSHOT_DIR, &snapshot) == ERROR_SUCCESS;
+        failures += ready ? startup_worker_run(&worker, texts, snapshot) : 0;
+        limdy_startup_end(&warm, snapshot);
+        if (ready)
+        {
+            startup_worker_destroy(&worker);
+        }
+    }
+
+    if (ready)
+    {
+        printf("{\"benchmark\":\"startup\",\"group\":\"e2e\",\"texts\":%d,\"failures\":%zu,\"cold_ns\":%llu,"
+               "\"warm_ns\":%llu,\"speedup\":%.2f}\n",
+               BENCH_E2E_TEXTS, failures, (unsigned long long)cold.startup_ns, (unsigned long long)warm.startup_ns,
+               warm.startup_ns > 0 ? (double)cold.startup_ns / (double)warm.startup_ns : 0.0);
+    }
+    else
+    {
+        fprintf(stderr, "Failed to set up the startup benchmark\n");
+    }
+
+    limdy_snapshot_close(snapshot);
+    remove(BENCH_SNAPSHOT_DIR "/" LIMDY_SNAPSHOT_IMAGE_NAME);
+    rmdir(BENCH_SNAPSHOT_DIR);
+    for (size_t t = 0; texts && t < BENCH_E2E_TEXTS; t++)
+    {
+        free(texts[t]);
+    }
+    free(texts);
+}
+
+static void bench_teacher(void)
+{
+    if (!bench_selected("teacher_"))
+    {
+        return;
+    }
+
+    size_t items = scaled(BENCH_TEACHER_ITEMS);
+    size_t queries = scaled(BENCH_TEACHER_QUERIES);
+    Teacher *teacher;
+    if (teacher_create(items, &teacher) != ERROR_SUCCESS)
+    {
+        fprintf(stderr, "Failed to create the scheduler\n");
+        return;
+    }
+
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    BenchTimer add_timer, record_timer, due_timer;
+    bool ready = timer_init(&add_timer, items);
+    ready = timer_init(&record_timer, queries) && ready;
+    ready = timer_init(&due_timer, queries) && ready;
+    for (size_t done = 0; ready && done < items; done += LIMDY_BENCH_BATCH)
+    {
+        uint64_t start = now_ns();
+        for (size_t i = done; i < done + LIMDY_BENCH_BATCH; i++)
+        {
+            uint64_t due = next_random(&state) % 1000000;
+            ready = teacher_add(teacher, (uint32_t)(i % BENCH_TEACHER_USERS), i, due) == ERROR_SUCCESS && ready;
+        }
+        timer_add(&add_timer, now_ns() - start, LIMDY_BENCH_BATCH);
+    }
+
+    for (size_t done = 0; ready && done < queries; done += LIMDY_BENCH_BATCH)
+    {
+        size_t picks[LIMDY_BENCH_BATCH];
+        for (size_t i = 0; i < LIMDY_BENCH_BATCH; i++)
+        {
+            picks[i] = next_random(&state) % items;
+        }
+        uint64_t start = now_ns();
+        for (size_t i = 0; i < LIMDY_BENCH_BATCH; i++)
+        {
+            teacher_record(teacher, (uint32_t)(picks[i] % BENCH_TEACHER_USERS), picks[i], TEACHER_GRADE_GOOD, 1000000 + done);
+        }
+        timer_add(&record_timer, now_ns() - start, LIMDY_BENCH_BATCH);
+    }
+
+    TeacherReview reviews[BENCH_TEACHER_DUE];
+    for (size_t done = 0; ready && done < queries; done += LIMDY_BENCH_BATCH)
+    {
+        size_t count = 0;
+        uint64_t start = now_ns();
+        for (size_t i = done; i < done + LIMDY_BENCH_BATCH; i++)
+        {
+            teacher_next_due(teacher, (uint32_t)(i % BENCH_TEACHER_USERS), UINT64_MAX, reviews, BENCH_TEACHER_DUE, &count);
+        }
+        timer_add(&due_timer, now_ns() - start, LIMDY_BENCH_BATCH);
+    }
+
+    timer_report("teacher_add", &add_timer);
+    timer_report("teacher_record", &record_timer);
+    timer_report("teacher_next_due_10", &due_timer);
+    teacher_destroy(teacher);
+}
+
+static void bench_tokenize(const char *name, Language lang)
+{
+    if (!bench_selected(name))
+    {
+        return;
+    }
+
+    char **texts = e2e_texts();
+    size_t *lengths = malloc(BENCH_E2E_TEXTS * sizeof(size_t));
+    bool ready = texts && lengths;
+    for (size_t t = 0; ready && t < BENCH_E2E_TEXTS; t++)
+    {
+        ready = texts[t] != NULL;
+        lengths[t] = ready ? strlen(texts[t]) : 0;
+    }
+    BenchTimer timer;
+    ready = ready && timer_init(&timer, scaled(BENCH_TOKENIZE_ROUNDS) * BENCH_E2E_TEXTS);
+
+    Token spans[BENCH_E2E_WORDS];
+    size_t failures = 0;
+    for (size_t round = 0; ready && round < scaled(BENCH_TOKENIZE_ROUNDS); round++)
+    {
+        for (size_t done = 0; done < BENCH_E2E_TEXTS; done += LIMDY_BENCH_BATCH)
+        {
+            uint64_t start = now_ns();
+            for (size_t t = done; t < done + LIMDY_BENCH_BATCH; t++)
+            {
+                size_t count;
+                failures += token_tokenize_spans(texts[t], lengths[t], lang, spans, BENCH_E2E_WORDS, &count) != ERROR_SUCCESS;
+            }
+            timer_add(&timer, now_ns() - start, LIMDY_BENCH_BATCH);
+        }
+    }
+    if (ready)
+    {
+        timer_report(name, &timer);
+    }
+    if (failures)
+    {
+        fprintf(stderr, "%s: %zu tokenizations failed\n", name, failures);
+    }
+
+    for (size_t t = 0; texts && t < BENCH_E2E_TEXTS; t++)
+    {
+        free(texts[t]);
+    }
+    free(texts);
+    free(lengths);
+}
+
+/**
+ * @brief Runs one round of concurrent translator_aligner_process calls.
+ *
+ * @return Calls per second, or 0 if the round could not run.
+ */
+static double e2e_round(TranslatorAligner *ta, char **texts, size_t threads, double baseline)
+{
+    size_t calls = scaled(BENCH_E2E_CALLS);
+    size_t per_thread = calls / threads;
+    E2EWorker *workers = calloc(threads, sizeof(E2EWorker));
+    pthread_t *handles = calloc(threads, sizeof(pthread_t));
+    double *latencies = malloc(per_thread * threads * sizeof(double));
+    if (!workers || !handles || !latencies || per_thread == 0)
+    {
+        free(workers);
+        free(handles);
+        free(latencies);
+        return 0.0;
+    }
+
+    uint64_t start = now_ns();
+    size_t started = 0;
+    for (size_t i = 0; i < threads; i++)
+    {
+        workers[i] = (E2EWorker){ta, texts, i * BENCH_E2E_TEXTS / threads, per_thread, latencies + i * per_thread, 0};
+        if (pthread_create(&handles[i], NULL, e2e_worker, &workers[i]) != 0)
+        {
+            break;
+        }
+        started++;
+    }
+    size_t failures = 0;
+    for (size_t i = 0; i < started; i++)
+    {
+        pthread_join(handles[i], NULL);
+        failures += workers[i].failures;
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    size_t total = per_thread * started;
+    double per_second = 0.0;
+    if (total > 0)
+    {
+        qsort(latencies, total, sizeof(double), compare_double);
+        per_second = (double)total * 1e9 / (double)elapsed;
+        printf("{\"benchmark\":\"e2e_translator_aligner_process\",\"group\":\"e2e\",\"threads\":%zu,\"calls\":%zu,"
+               "\"failures\":%zu,\"calls_per_sec\":%.1f,\"speedup\":%.2f,\"p50_ns\":%.0f,\"p90_ns\":%.0f,\"p99_ns\":%.0f,"
+               "\"max_ns\":%.0f}\n",
+               started, total, failures, per_second, baseline > 0 ? per_second / baseline : 1.0, latencies[total / 2],
+               latencies[total * 9 / 10], latencies[total * 99 / 100], latencies[total - 1]);
+    }
+
+    free(workers);
+    free(handles);
+    free(latencies);
+    return per_second;
+}
+
+static void bench_e2e(void)
+{
+    if (!bench_selected("e2e"))
+    {
+        return;
+    }
+
+    LimdyMemoryPool *renderer_pool;
+    if (limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &renderer_pool) != ERROR_SUCCESS)
+    {
+        fprintf(stderr, "Failed to create renderer pool\n");
+        return;
+    }
+
+    // The renderer frees its services to its pool
+    TokenizationService *tokenization = limdy_memory_pool_alloc_from(renderer_pool, sizeof(TokenizationService));
+    ClassificationService *classification = limdy_memory_pool_alloc_from(renderer_pool, sizeof(ClassificationService));
+    if (!tokenization || !classification)
+    {
+        limdy_memory_pool_destroy(renderer_pool);
+        return;
+    }
+    *tokenization = (TokenizationService){
+        .tokenize = synthetic_tokenize, .free_tokens = synthetic_free_tokens, .tokenize_spans = synthetic_tokenize_spans};
+    *classification = (ClassificationService){.classify = synthetic_classify};
+
+    Renderer *renderer = renderer_create(renderer_pool, tokenization, classification);
+    TranslatorAligner *ta = renderer ? translator_aligner_create(&synthetic_translation_service, NULL, renderer) : NULL;
+    char **texts = e2e_texts();
+    if (ta && texts)
+    {
+        double baseline = 0.0;
+        for (size_t threads = 1; threads <= options.max_threads; threads *= 2)
+        {
+            double per_second = e2e_round(ta, texts, threads, baseline);
+            baseline = threads == 1 ? per_second : baseline;
+            if (threads < options.max_threads && threads * 2 > options.max_threads)
+            {
+                e2e_round(ta, texts, options.max_threads, baseline);
+            }
+        }
+    }
+    else
+    {
+        fprintf(stderr, "Failed to set up the end-to-end benchmark\n");
+    }
+
+    for (size_t t = 0; texts && t < BENCH_E2E_TEXTS; t++)
+    {
+        free(texts[t]);
+    }
+    free(texts);
+    if (ta)
+    {
+        translator_aligner_destroy(ta);
+    }
+    if (renderer)
+    {
+        renderer_destroy(renderer);
+    }
+    limdy_memory_pool_destroy(renderer_pool);
+}
+
+static double exerciser_round(const ExerciserRequest *requests, size_t request_count, size_t threads, double baseline)
+{
+    Exerciser *exerciser;
+    LimdyArena arena;
+    if (exerciser_create(threads, &exerciser) != ERROR_SUCCESS)
+    {
+        return 0.0;
+    }
+    limdy_arena_init(&arena, 0);
+
+    size_t rounds = scaled(BENCH_EXERCISER_ROUNDS * LIMDY_BENCH_BATCH) / LIMDY_BENCH_BATCH;
+    size_t exercises = 0;
+    uint64_t start = now_ns();
+    for (size_t round = 0; round < rounds; round++)
+    {
+        ExerciseBatch batch;
+        if (exerciser_generate(exerciser, requests, request_count, &arena, &batch) == ERROR_SUCCESS)
+        {
+            exercises += batch.exercise_count;
+        }
+        limdy_arena_reset(&arena);
+    }
+    uint64_t elapsed = now_ns() - start;
+    limdy_arena_release(&arena);
+    exerciser_destroy(exerciser);
+
+    double per_second = elapsed ? (double)exercises * 1e9 / (double)elapsed : 0.0;
+    printf("{\"benchmark\":\"exerciser_generate\",\"group\":\"batch\",\"threads\":%zu,\"requests\":%zu,\"exercises\":%zu,"
+           "\"exercises_per_sec\":%.1f,\"speedup\":%.2f}\n",
+           threads, request_count, exercises, per_second, baseline > 0 ? per_second / baseline : 1.0);
+    return per_second;
+}
+
+static void bench_exerciser(void)
+{
+    if (!bench_selected("exerciser_"))
+    {
+        return;
+    }
+
+    LimdyMemoryPool *renderer_pool;
+    if (limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &renderer_pool) != ERROR_SUCCESS)
+    {
+        fprintf(stderr, "Failed to create renderer pool\n");
+        return;
+    }
+    TokenizationService *tokenization = limdy_memory_pool_alloc_from(renderer_pool, sizeof(TokenizationService));
+    ClassificationService *classification = limdy_memory_pool_alloc_from(renderer_pool, sizeof(ClassificationService));
+    if (!tokenization || !classification)
+    {
+        limdy_memory_pool_destroy(renderer_pool);
+        return;
+    }
+    *tokenization = (TokenizationService){.tokenize_spans = token_tokenize_spans};
+    *classification = (ClassificationService){.classify = synthetic_classify};
+    Renderer *renderer = renderer_create(renderer_pool, tokenization, classification);
+
+    // One cloze per word and one matching per four words of every text of a class
+    ExerciseTemplate *cloze = NULL;
+    ExerciseTemplate *matching = NULL;
+    exercise_template_compile(&(ExerciseTemplateConfig){.type = EXERCISE_CLOZE, .pattern = "Fill in: {body}"}, &cloze);
+    exercise_template_compile(&(ExerciseTemplateConfig){.type = EXERCISE_MATCHING, .pattern = "Match:\n{body}"}, &matching);
+    char **texts = e2e_texts();
+    RendererResult *results = calloc(BENCH_E2E_TEXTS, sizeof(RendererResult));
+    ExerciserRequest *requests = calloc(BENCH_E2E_TEXTS * 2, sizeof(ExerciserRequest));
+    LimdyArena result_arena;
+    limdy_arena_init(&result_arena, 0);
+    bool ready = renderer && cloze && matching && texts && results && requests;
+    for (size_t t = 0; ready && t < BENCH_E2E_TEXTS; t++)
+    {
+        results[t].arena = &result_arena;
+        ready = texts[t] && renderer_render(renderer, texts[t], LANG_ENGLISH, &results[t]) == ERROR_SUCCESS;
+        requests[t * 2] = (ExerciserRequest){&results[t], &results[t].vocab_map, cloze};
+        requests[t * 2 + 1] = (ExerciserRequest){&results[t], &results[t].vocab_map, matching};
+    }
+
+    double baseline = 0.0;
+    for (size_t threads = 1; ready && threads <= options.max_threads; threads *= 2)
+    {
+        double per_second = exerciser_round(requests, BENCH_E2E_TEXTS * 2, threads, baseline);
+        baseline = threads == 1 ? per_second : baseline;
+        if (threads < options.max_threads && threads * 2 > options.max_threads)
+        {
+            exerciser_round(requests, BENCH_E2E_TEXTS * 2, options.max_threads, baseline);
+        }
+    }
+    if (!ready)
+    {
+        fprintf(stderr, "Failed to set up the exerciser benchmark\n");
+    }
+
+    limdy_arena_release(&result_arena);
+    for (size_t t = 0; texts && t < BENCH_E2E_TEXTS; t++)
+    {
+        free(texts[t]);
+    }
+    free(texts);
+    free(results);
+    free(requests);
+    exercise_template_destroy(cloze);
+    exercise_template_destroy(matching);
+    if (renderer)
+    {
+        renderer_destroy(renderer);
+    }
+    limdy_memory_pool_destroy(renderer_pool);
+}
+
+static void bench_assessor(void)
+{
+    if (!bench_selected("assessor_"))
+    {
+        return;
+    }
+
+    // Every answer leaves out the first word of its text
+    char **texts = e2e_texts();
+    Token *expected = malloc(BENCH_E2E_TEXTS * BENCH_E2E_WORDS * sizeof(Token));
+    AssessorSubmission *submissions = malloc(BENCH_E2E_TEXTS * sizeof(AssessorSubmission));
+    Assessor *assessor = NULL;
+    bool ready = texts && expected && submissions && assessor_create(&(TokenizationService){.tokenize_spans = token_tokenize_spans},
+                                                                     &assessor) == ERROR_SUCCESS;
+    for (size_t t = 0; ready && t < BENCH_E2E_TEXTS; t++)
+    {
+        size_t count = 0;
+        Token *tokens = expected + t * BENCH_E2E_WORDS;
+        ready = texts[t] && token_tokenize_spans(texts[t], strlen(texts[t]), LANG_ENGLISH, tokens, BENCH_E2E_WORDS, &count) == ERROR_SUCCESS;
+        for (size_t i = 0; ready && i < count; i++)
+        {
+            tokens[i].text = texts[t] + tokens[i].offset;
+        }
+        const char *answer = ready ? strchr(texts[t], ' ') : NULL;
+        ready = answer != NULL;
+        submissions[t] = ready ? (AssessorSubmission){tokens, count, answer + 1, strlen(answer + 1)} : (AssessorSubmission){0};
+    }
+
+    static const struct
+    {
+        LimdyAttentionKernel kernel;
+        const char *name;
+    } kernels[] = {{LIMDY_ATTENTION_KERNEL_SCALAR, "assessor_score_batch_scalar"},
+                   {LIMDY_ATTENTION_KERNEL_SSE2, "assessor_score_batch_sse2"},
+                   {LIMDY_ATTENTION_KERNEL_AVX2, "assessor_score_batch_avx2"},
+                   {LIMDY_ATTENTION_KERNEL_NEON, "assessor_score_batch_neon"}};
+    AssessorScore scores[LIMDY_BENCH_BATCH];
+    LimdyArena arena;
+    limdy_arena_init(&arena, 0);
+    for (size_t k = 0; ready && k < sizeof(kernels) / sizeof(kernels[0]); k++)
+    {
+        BenchTimer timer;
+        if (!bench_selected(kernels[k].name) || assessor_set_kernel(assessor, kernels[k].kernel) != ERROR_SUCCESS ||
+            !timer_init(&timer, scaled(BENCH_ASSESSOR_ROUNDS) * BENCH_E2E_TEXTS))
+        {
+            continue;
+        }
+        size_t failures = 0;
+        for (size_t round = 0; round < scaled(BENCH_ASSESSOR_ROUNDS); round++)
+        {
+            for (size_t done = 0; done < BENCH_E2E_TEXTS; done += LIMDY_BENCH_BATCH)
+            {
+                uint64_t start = now_ns();
+                failures += assessor_score_batch(assessor, submissions + done, LIMDY_BENCH_BATCH, LANG_ENGLISH, &arena, scores) != ERROR_SUCCESS;
+                limdy_arena_reset(&arena);
+                timer_add(&timer, now_ns() - start, LIMDY_BENCH_BATCH);
+            }
+        }
+        timer_report(kernels[k].name, &timer);
+        if (failures)
+        {
+            fprintf(stderr, "%s: %zu batches failed\n", kernels[k].name, failures);
+        }
+    }
+    if (!ready)
+    {
+        fprintf(stderr, "Failed to set up the assessor benchmark\n");
+    }
+
+    limdy_arena_release(&arena);
+    assessor_destroy(assessor);
+    for (size_t t = 0; texts && t < BENCH_E2E_TEXTS; t++)
+    {
+        free(texts[t]);
+    }
+    free(texts);
+    free(expected);
+    free(submissions);
+}
+
+static bool parse_options(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            long threads = strtol(argv[++i], NULL, 10);
+            if (threads < 1)
+            {
+                return false;
+            }
+            options.max_threads = (size_t)threads;
+        }
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        {
+            options.filter = argv[++i];
+        }
+        else if (strcmp(argv[i], "--quick") == 0)
+        {
+            options.scale_down = 10;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    if (options.max_threads == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        options.max_threads = cpus > 0 ? (size_t)cpus : 1;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (!parse_options(argc, argv))
+    {
+        fprintf(stderr, "usage: %s [--threads N] [--filter SUBSTRING] [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The scheduler's item array and index outgrow the default large pool
+    LimdyMemoryPoolConfig config = {
+        .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+        .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+        .large_pool_size = BENCH_LARGE_POOL_SIZE,
+        .max_pools = 4,
+        .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+    error_init();
+    // Failures are counted, not logged
+    error_set_min_level(ERROR_LEVEL_FATAL);
+    if (limdy_memory_pool_init(&config) != ERROR_SUCCESS)
+    {
+        fprintf(stderr, "Failed to initialize memory pool system\n");
+        return EXIT_FAILURE;
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("{\"suite\":\"limdy_bench\",\"version\":%d,\"timestamp\":%lld,\"cpus\":%ld,\"max_threads\":%zu,\"batch\":%d,\"quick\":%s}\n",
+           LIMDY_BENCH_VERSION, (long long)time(NULL), cpus, options.max_threads, LIMDY_BENCH_BATCH,
+           options.scale_down > 1 ? "true" : "false");
+
+    bench_alloc_free("slab_alloc_64", "slab_free_64", 64);
+    bench_alloc_free("pool_alloc_1k", "pool_free_1k", 1024);
+    bench_alloc_free("pool_alloc_16k", "pool_free_16k", 16 * 1024);
+    bench_realloc();
+    bench_rbtree();
+
+    char *token_text = NULL;
+    size_t token_count = scaled(BENCH_HASH_TOKENS);
+    Token *tokens = generate_tokens(token_count, &token_text);
+    if (tokens)
+    {
+        bench_hash("hash_linguistic_element_1", tokens, token_count, 1);
+        bench_hash("hash_linguistic_element_4", tokens, token_count, 4);
+        bench_map(tokens, token_count < scaled(BENCH_MAP_ELEMENTS) ? token_count : scaled(BENCH_MAP_ELEMENTS));
+        bench_bank(tokens, token_count);
+        free(tokens);
+        free(token_text);
+    }
+
+    bench_tokenize("tokenize_spans_english", LANG_ENGLISH);
+    bench_tokenize("tokenize_spans_spanish", LANG_SPANISH);
+    bench_teacher();
+    bench_exerciser();
+    bench_assessor();
+    bench_startup();
+    bench_e2e();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file assessor.h
+ * @brief Batch scoring of submitted answers against expected tokens.
+ *
+ * The Assessor compares each submitted answer with the tokens it should
+ * have been, such as the tokens of the element an exercise practiced, and
+ * scores it by token edit distance: the fewest tokens to insert, delete or
+ * replace to turn the answer into the expected tokens. Answers are split
+ * with the tokenization service's zero-copy span tokenizer. Tokens are
+ * equal when their bytes are, ignoring ASCII case, so "Hola, mundo" answers
+ * "hola mundo" exactly.
+ *
+ * Distances are computed with Myers' bit-parallel algorithm, one machine word
+ * per 64 expected tokens and one step per answer token. Answers whose
+ * expected tokens fit in one word are scored LIMDY_ASSESSOR_LANES at a time,
+ * one per vector lane, with the instruction sets of attention_kernel.h
+ * chosen at runtime; longer ones run word by word on their own. Every
+ * kernel gives the same distances. A batch takes one scratch allocation from
+ * an arena and allocates nothing per answer.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#ifndef LIMDY_COMPONENTS_ASSESSOR_H
+#define LIMDY_COMPONENTS_ASSESSOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "error_handler.h"
+#include "arena.h"
+#include "token.h"
+#include "attention_kernel.h"
+
+/**
+ * @brief Number of answers scored together by the vector kernels.
+ */
+#define LIMDY_ASSESSOR_LANES 4
+
+/**
+ * @brief Expected tokens that fit in one machine word and so in a vector lane.
+ */
+#define LIMDY_ASSESSOR_WORD_TOKENS 64
+
+/**
+ * @brief An answer and the tokens it is compared with.
+ */
+typedef struct
+{
+    const Token *expected;  /**< Expected tokens, e.g. an element's; only text and length are read */
+    size_t expected_count;
+    const char *answer;     /**< Submitted text, not necessarily NUL terminated */
+    size_t answer_length;
+} AssessorSubmission;
+
+/**
+ * @brief Score of one answer.
+ */
+typedef struct
+{
+    uint32_t distance;       /**< Token edit distance between the answer and the expected tokens */
+    uint32_t expected_count; /**< Number of expected tokens */
+    uint32_t answer_count;   /**< Number of tokens in the answer */
+    float score;             /**< 1 - distance / max(expected_count, answer_count), or 1 when both are empty */
+} AssessorScore;
+
+/**
+ * @brief Opaque answer assessor.
+ */
+typedef struct Assessor Assessor;
+
+/**
+ * @brief Create an assessor.
+ *
+ * @param tokenization_service Service whose tokenize_spans splits answers; it must outlive the assessor.
+ * @param assessor Pointer to store the created assessor.
+ * @return ErrorCode indicating success or failure; ERROR_INVALID_ARGUMENT if the service has no span tokenizer.
+ */
+ErrorCode assessor_create(const TokenizationService *tokenization_service, Assessor **assessor);
+
+/**
+ * @brief Destroy an assessor.
+ *
+ * @param assessor The assessor, or NULL.
+ */
+void assessor_destroy(Assessor *assessor);
+
+/**
+ * @brief Select the instruction set the assessor scores with.
+ *
+ * @param assessor The assessor.
+ * @param kernel The kernel to use, or LIMDY_ATTENTION_KERNEL_AUTO for the best one the CPU supports.
+ * @return ErrorCode indicating success, or LIMDY_ATTENTION_ERROR_UNSUPPORTED if the CPU lacks it.
+ */
+ErrorCode assessor_set_kernel(Assessor *assessor, LimdyAttentionKernel kernel);
+
+/**
+ * @brief Get the name of the kernel an assessor scores with.
+ *
+ * @param assessor The assessor.
+ * @return A static string such as "avx2" or "scalar".
+ */
+const char *assessor_kernel_name(const Assessor *assessor);
+
+/**
+ * @brief Score a batch of answers.
+ *
+ * @param assessor The assessor.
+ * @param submissions The answers and their expected tokens.
+ * @param submission_count Number of submissions.
+ * @param lang The language the answers are written in.
+ * @param scratch Arena for the batch's scratch memory; the caller resets it.
+ * @param scores Array of submission_count entries to store the scores, in submission order.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode assessor_score_batch(const Assessor *assessor, const AssessorSubmission *submissions, size_t submission_count, Language lang,
+                               LimdyArena *scratch, AssessorScore *scores);
+
+/**
+ * @brief Score one answer and find which of its tokens matched expected ones.
+ *
+ * The links are the matched pairs of one cheapest edit, with the expected
+ * token as source and the answer token as target, in increasing order of
+ * both; tokens left out are the ones to insert, delete or replace. Of
+ * several cheapest edits, the one matching the latest tokens is picked.
+ *
+ * @param assessor The assessor.
+ * @param submission The answer and its expected tokens.
+ * @param lang The language the answer is written in.
+ * @param scratch Arena for scratch memory; the caller resets it.
+ * @param score Pointer to store the score.
+ * @param links Array of at least submission->expected_count entries to store the matches.
+ * @param link_count Pointer to store the number of links written.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode assessor_align(const Assessor *assessor, const AssessorSubmission *submission, Language lang, LimdyArena *scratch,
+                         AssessorScore *score, AlignmentLink *links, size_t *link_count);
+
+/**
+ * @brief Base error code for assessor errors.
+ */
+#define LIMDY_ASSESSOR_ERROR_BASE (ERROR_CUSTOM_BASE + 260)
+
+/**
+ * @brief Error code for a tokenizer that reports more tokens than an answer has bytes.
+ */
+#define LIMDY_ASSESSOR_ERROR_TOKENIZER (LIMDY_ASSESSOR_ERROR_BASE + 1)
+
+#endif // LIMDY_COMPONENTS_ASSESSOR_H
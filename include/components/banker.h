@@ -0,0 +1,207 @@
+/**
+ * @file banker.h
+ * @brief Memory-mapped storage engine for banks of linguistic elements.
+ *
+ * A bank is a read-only file holding LinguisticElements. It is written once
+ * by a BankerWriter and opened with banker_open(), which maps the file and
+ * checks its header. Nothing is deserialized, so opening takes the same time
+ * for a bank of any size. Lookups read the mapped pages in place, and
+ * processes that open the same bank share its pages through the page cache.
+ *
+ * The format is relocatable, since sections refer to each other by index
+ * and offset, never by pointer. It is versioned and in native byte order.
+ * After a fixed header, the sections are, each 8-byte aligned:
+ * - elements, each with its hash, type and its run of tokens;
+ * - tokens, each a string table offset, a length and its class set;
+ * - the string table, where every distinct token text is stored once and
+ *   NUL terminated;
+ * - the hash index, an open-addressed table of (hash, element) pairs with
+ *   linear probing, at most half full.
+ *
+ * Element and token references are bounds-checked as they are read, so a
+ * damaged bank fails lookups instead of reading outside the mapping.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#ifndef LIMDY_COMPONENTS_BANKER_H
+#define LIMDY_COMPONENTS_BANKER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "error_handler.h"
+#include "linguistic_element.h"
+
+/**
+ * @brief Version of the bank format written by this build; banks of other versions are refused.
+ */
+#define LIMDY_BANKER_FORMAT_VERSION 2
+
+/**
+ * @brief Opaque builder of a bank file.
+ */
+typedef struct BankerWriter BankerWriter;
+
+/**
+ * @brief Opaque handle to an opened, memory-mapped bank.
+ */
+typedef struct Banker Banker;
+
+/**
+ * @brief An element of an opened bank, read in place.
+ */
+typedef struct
+{
+    const Banker *bank;         /**< Bank holding the element */
+    LinguisticElementType type; /**< Type of the element */
+    uint64_t hash;              /**< Hash the element was added with */
+    size_t token_count;         /**< Number of tokens */
+    size_t first_token;         /**< Index of the first token in the bank's token section */
+} BankerElement;
+
+/**
+ * @brief A token of an element in an opened bank, read in place.
+ */
+typedef struct
+{
+    const char *text;      /**< The text, NUL terminated, inside the mapping */
+    size_t length;         /**< Length of the text in bytes */
+    TokenClassSet classes; /**< Classes of the token */
+} BankerToken;
+
+/**
+ * @brief Create an empty bank writer.
+ *
+ * @param writer Pointer to store the created writer.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode banker_writer_create(BankerWriter **writer);
+
+/**
+ * @brief Add a copy of an element to the bank being written.
+ *
+ * Elements keep the hash they carry, which should come from
+ * hash_linguistic_element() so that banker_find_tokens() can find them.
+ *
+ * @param writer The writer.
+ * @param element The element to add.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode banker_writer_add(BankerWriter *writer, const LinguisticElement *element);
+
+/**
+ * @brief Add a copy of every element of a map to the bank being written.
+ *
+ * @param writer The writer.
+ * @param map The map whose elements to add.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode banker_writer_add_map(BankerWriter *writer, LinguisticElementMap *map);
+
+/**
+ * @brief Write the bank to a file.
+ *
+ * The bank is written to a temporary file next to @p path and renamed over
+ * it, so readers either see the old bank or the complete new one. The
+ * writer can go on adding elements and write again.
+ *
+ * @param writer The writer.
+ * @param path Path of the bank file.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode banker_writer_write(BankerWriter *writer, const char *path);
+
+/**
+ * @brief Destroy a bank writer.
+ *
+ * @param writer The writer, or NULL.
+ */
+void banker_writer_destroy(BankerWriter *writer);
+
+/**
+ * @brief Map a bank file for reading.
+ *
+ * Checks the header and the bounds of every section; takes constant time
+ * whatever the size of the bank.
+ *
+ * @param path Path of the bank file.
+ * @param bank Pointer to store the opened bank.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode banker_open(const char *path, Banker **bank);
+
+/**
+ * @brief Unmap a bank. Elements and tokens read from it become invalid.
+ *
+ * @param bank The bank, or NULL.
+ */
+void banker_close(Banker *bank);
+
+/**
+ * @brief Get the number of elements in a bank.
+ *
+ * @param bank The bank.
+ * @return The number of elements.
+ */
+size_t banker_element_count(const Banker *bank);
+
+/**
+ * @brief Get an element by its position, for iterating over a bank.
+ *
+ * @param bank The bank.
+ * @param index Position of the element, below banker_element_count().
+ * @param element Pointer to store the element.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode banker_element_at(const Banker *bank, size_t index, BankerElement *element);
+
+/**
+ * @brief Find an element by hash, without comparing tokens.
+ *
+ * @param bank The bank.
+ * @param hash The hash to look up.
+ * @param element Pointer to store the first element added with this hash.
+ * @return true if an element was found.
+ */
+bool banker_find(const Banker *bank, uint64_t hash, BankerElement *element);
+
+/**
+ * @brief Find the element made of exactly these tokens.
+ *
+ * @param bank The bank.
+ * @param hash hash_linguistic_element() of the tokens.
+ * @param tokens The tokens to match, texts and classes.
+ * @param token_count Number of tokens.
+ * @param element Pointer to store the element.
+ * @return true if an element was found.
+ */
+bool banker_find_tokens(const Banker *bank, uint64_t hash, const Token *tokens, size_t token_count, BankerElement *element);
+
+/**
+ * @brief Read one token of an element.
+ *
+ * @param element The element.
+ * @param index Position of the token, below the element's token_count.
+ * @param token Pointer to store the token.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode banker_element_token(const BankerElement *element, size_t index, BankerToken *token);
+
+/**
+ * @brief Base error code for bank errors.
+ */
+#define LIMDY_BANKER_ERROR_BASE (ERROR_CUSTOM_BASE + 230)
+
+/**
+ * @brief Error code for a file that is not a bank, or a damaged one.
+ */
+#define LIMDY_BANKER_ERROR_BAD_FORMAT (LIMDY_BANKER_ERROR_BASE + 1)
+
+/**
+ * @brief Error code for a bank written in another format version.
+ */
+#define LIMDY_BANKER_ERROR_VERSION (LIMDY_BANKER_ERROR_BASE + 2)
+
+#endif // LIMDY_COMPONENTS_BANKER_H
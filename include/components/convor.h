@@ -0,0 +1,134 @@
+/**
+ * @file convor.h
+ * @brief Conversation orchestrator: incremental rendering, translation and alignment of conversations.
+ *
+ * A Conversation keeps everything earlier turns produced: the rendered
+ * tokens of every utterance in one RendererResult, with its vocab and
+ * phrase maps, and each turn's translation and alignment. A new turn only
+ * tokenizes, translates and aligns its own utterance, then appends its
+ * tokens and elements to the persistent result, so a turn costs the same
+ * however long the conversation has run. Partial translations are passed
+ * on to the caller as the translation service produces them.
+ *
+ * The conversation's result matches rendering all utterances as one text,
+ * except that no phrase spans two turns. Token offsets count from the
+ * start of the conversation, with the utterances joined by one byte.
+ *
+ * A Conversation is not synchronized; callers sharing one between threads
+ * lock around it. Conversations on the same TranslatorAligner run
+ * concurrently.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-15
+ */
+
+#ifndef LIMDY_COMPONENTS_CONVOR_H
+#define LIMDY_COMPONENTS_CONVOR_H
+
+#include <stddef.h>
+#include "error_handler.h"
+#include "renderer.h"
+#include "translator_aligner.h"
+
+/**
+ * @brief Tokens a new conversation makes room for before it first grows.
+ */
+#define LIMDY_CONVOR_INITIAL_TOKENS 256
+
+/**
+ * @brief One turn of a conversation.
+ */
+typedef struct
+{
+    const char *text;            /**< The utterance, null-terminated */
+    size_t first_token;          /**< Index of the turn's first token in the conversation's result */
+    size_t token_count;          /**< Number of tokens in the utterance */
+    const char *translated_text; /**< The whole translation, null-terminated */
+    AlignmentResult alignment;   /**< Links between the utterance's tokens and its translation */
+} ConversationTurn;
+
+/**
+ * @brief Opaque conversation state.
+ */
+typedef struct Conversation Conversation;
+
+/**
+ * @brief Create a conversation.
+ *
+ * Utterances are tokenized with the aligner's renderer, which also sets
+ * which phrases are extracted.
+ *
+ * @param ta The translator and aligner; must outlive the conversation.
+ * @param lang The language of the utterances.
+ * @param source_lang The source language passed to the translator.
+ * @param target_lang The target language passed to the translator.
+ * @param conversation Pointer to store the created conversation.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode conversation_create(TranslatorAligner *ta, Language lang, const char *source_lang, const char *target_lang,
+                              Conversation **conversation);
+
+/**
+ * @brief Destroy a conversation and everything its turns produced.
+ *
+ * @param conversation The conversation, or NULL.
+ */
+void conversation_destroy(Conversation *conversation);
+
+/**
+ * @brief Add a turn: tokenize, translate and align one utterance.
+ *
+ * Only the utterance is processed; its tokens and elements are appended to
+ * the conversation's result. A turn that fails before its elements are
+ * recorded leaves the conversation as it was. One that fails while
+ * recording them is not counted and its tokens are dropped, but the maps
+ * may keep part of its elements; the conversation then refuses further
+ * turns with LIMDY_CONVOR_ERROR_INCOMPLETE and must be destroyed.
+ *
+ * @param conversation The conversation.
+ * @param utterance The text of the turn; copied.
+ * @param partial Function to call with each partial translation, or NULL.
+ * @param context Argument to pass to @p partial.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode conversation_add_turn(Conversation *conversation, const char *utterance, TranslationPartialFn partial, void *context);
+
+/**
+ * @brief Get the number of turns so far.
+ *
+ * @param conversation The conversation.
+ * @return The number of turns.
+ */
+size_t conversation_turn_count(const Conversation *conversation);
+
+/**
+ * @brief Get a turn.
+ *
+ * @param conversation The conversation.
+ * @param index Index of the turn, below the turn count.
+ * @return The turn, valid until the next turn is added, or NULL for an index out of range.
+ */
+const ConversationTurn *conversation_turn(const Conversation *conversation, size_t index);
+
+/**
+ * @brief Get the rendered result of all turns so far.
+ *
+ * The tokens and maps are valid until the next turn is added, which may
+ * move the tokens and every occurrence with them.
+ *
+ * @param conversation The conversation.
+ * @return The result, or NULL for a NULL conversation.
+ */
+const RendererResult *conversation_result(const Conversation *conversation);
+
+/**
+ * @brief Base error code for conversation errors.
+ */
+#define LIMDY_CONVOR_ERROR_BASE (ERROR_CUSTOM_BASE + 280)
+
+/**
+ * @brief Error code for a conversation whose maps a failed turn left part-updated.
+ */
+#define LIMDY_CONVOR_ERROR_INCOMPLETE (LIMDY_CONVOR_ERROR_BASE + 1)
+
+#endif // LIMDY_COMPONENTS_CONVOR_H
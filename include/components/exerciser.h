@@ -0,0 +1,192 @@
+/**
+ * @file exerciser.h
+ * @brief Batch generation of exercises from rendered text.
+ *
+ * The Exerciser turns the elements of rendered texts into exercises: cloze
+ * (an occurrence in context with the element blanked out), matching
+ * (several blanked contexts and the shuffled elements that fill them) and
+ * reordering (the shuffled tokens of a phrase). It works in batches: one
+ * call takes the texts of a whole class, each with the map whose elements
+ * to practice and a template, and returns every exercise at once.
+ *
+ * Templates are compiled once into literal segments and placeholders, so
+ * rendering a prompt is a copy per segment. The elements of a batch are
+ * cut into fixed chunks of map slots that run on a worker pool in two
+ * passes. The first pass measures every chunk exactly. After a single
+ * arena allocation for the batch, the second pass writes each chunk into
+ * its own slice of it. Workers never lock or allocate, and the output is
+ * the same for any number of workers. Shuffles are seeded by element hash,
+ * so a batch generated twice is byte for byte the same.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#ifndef LIMDY_COMPONENTS_EXERCISER_H
+#define LIMDY_COMPONENTS_EXERCISER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "error_handler.h"
+#include "arena.h"
+#include "renderer.h"
+
+/**
+ * @brief Default number of tokens kept on each side of a cloze blank.
+ */
+#define LIMDY_EXERCISER_CONTEXT_TOKENS 8
+
+/**
+ * @brief Default number of elements in a matching exercise.
+ */
+#define LIMDY_EXERCISER_GROUP_SIZE 4
+
+/**
+ * @brief Largest number of elements in a matching exercise.
+ */
+#define LIMDY_EXERCISER_MAX_GROUP_SIZE 16
+
+/**
+ * @brief Longest element, in tokens, that a reordering exercise is made of.
+ */
+#define LIMDY_EXERCISER_MAX_REORDER_TOKENS 32
+
+/**
+ * @brief Map slots handled by one task; also the span matching groups are formed in.
+ */
+#define LIMDY_EXERCISER_CHUNK_SLOTS 512
+
+/**
+ * @brief Kinds of exercises.
+ */
+typedef enum
+{
+    EXERCISE_CLOZE,
+    EXERCISE_MATCHING,
+    EXERCISE_REORDERING,
+    EXERCISE_TYPE_COUNT
+} ExerciseType;
+
+/**
+ * @brief Settings a template is compiled from.
+ *
+ * The pattern is the prompt text, where "{body}" stands for the generated
+ * exercise and "{{" for a literal brace.
+ */
+typedef struct
+{
+    ExerciseType type;
+    const char *pattern;   /**< Prompt around the exercise body */
+    size_t context_tokens; /**< Cloze and matching: tokens on each side of a blank; 0 for the default */
+    size_t group_size;     /**< Matching: elements per exercise, 2 or more; 0 for the default */
+} ExerciseTemplateConfig;
+
+/**
+ * @brief Opaque compiled template.
+ */
+typedef struct ExerciseTemplate ExerciseTemplate;
+
+/**
+ * @brief The elements of one text to generate exercises for.
+ */
+typedef struct
+{
+    const RendererResult *result;              /**< Rendered text the occurrences point into */
+    LinguisticElementMap *map;                 /**< Elements to practice, e.g. the result's phrase map */
+    const ExerciseTemplate *exercise_template; /**< How to present them */
+} ExerciserRequest;
+
+/**
+ * @brief A generated exercise. Texts are NUL terminated and live in the batch's arena.
+ */
+typedef struct
+{
+    ExerciseType type;
+    size_t request;                 /**< Index of the request it was generated for */
+    const uint64_t *element_hashes; /**< Hashes of the practiced elements, in answer order */
+    size_t element_count;
+    const char *prompt;
+    size_t prompt_length;
+    const char *answer;
+    size_t answer_length;
+} Exercise;
+
+/**
+ * @brief Exercises of one batch, in request order and then map slot order.
+ */
+typedef struct
+{
+    Exercise *exercises;
+    size_t exercise_count;
+} ExerciseBatch;
+
+/**
+ * @brief Opaque batch exercise generator.
+ */
+typedef struct Exerciser Exerciser;
+
+/**
+ * @brief Compile a template.
+ *
+ * @param config The template settings.
+ * @param exercise_template Pointer to store the compiled template.
+ * @return ErrorCode indicating success or failure; LIMDY_EXERCISER_ERROR_BAD_TEMPLATE for a malformed pattern.
+ */
+ErrorCode exercise_template_compile(const ExerciseTemplateConfig *config, ExerciseTemplate **exercise_template);
+
+/**
+ * @brief Destroy a compiled template.
+ *
+ * @param exercise_template The template, or NULL.
+ */
+void exercise_template_destroy(ExerciseTemplate *exercise_template);
+
+/**
+ * @brief Create an exercise generator.
+ *
+ * @param thread_count Number of workers, 0 for one per online CPU, or 1 to generate on the calling thread only.
+ * @param exerciser Pointer to store the created generator.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode exerciser_create(size_t thread_count, Exerciser **exerciser);
+
+/**
+ * @brief Destroy an exercise generator.
+ *
+ * @param exerciser The generator, or NULL.
+ */
+void exerciser_destroy(Exerciser *exerciser);
+
+/**
+ * @brief Generate the exercises of a batch of requests.
+ *
+ * Cloze and matching blank out the element's first occurrence in its
+ * result, or for elements without occurrences, such as those loaded from
+ * a snapshot, the tokens the element was copied from. Elements the template cannot use are
+ * skipped: elements found nowhere in their result for cloze and matching,
+ * and single tokens or elements longer than
+ * LIMDY_EXERCISER_MAX_REORDER_TOKENS for reordering.
+ * The batch takes one allocation from @p arena and is released with it.
+ * Requests are only read, so several batches may read the same results.
+ *
+ * @param exerciser The generator.
+ * @param requests The requests.
+ * @param request_count Number of requests.
+ * @param arena Arena to allocate the batch from.
+ * @param batch Pointer to store the batch.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode exerciser_generate(Exerciser *exerciser, const ExerciserRequest *requests, size_t request_count, LimdyArena *arena,
+                             ExerciseBatch *batch);
+
+/**
+ * @brief Base error code for exerciser errors.
+ */
+#define LIMDY_EXERCISER_ERROR_BASE (ERROR_CUSTOM_BASE + 250)
+
+/**
+ * @brief Error code for a template pattern with an unknown or unterminated placeholder.
+ */
+#define LIMDY_EXERCISER_ERROR_BAD_TEMPLATE (LIMDY_EXERCISER_ERROR_BASE + 1)
+
+#endif // LIMDY_COMPONENTS_EXERCISER_H
@@ -3,9 +3,12 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
 #include "limdy_types.h"
 #include "error_handler.h"
 #include "memory_pool.h"
+#include "arena.h"
 #include "token.h"
 #include "limdy_utils.h"
 
@@ -16,7 +19,7 @@ typedef enum
     ELEMENT_SYNTAX
 } LinguisticElementType;
 
-// Base LinguisticElement (can be used for both disk and memory)
+// Base LinguisticElement (can be used for both disk and memory; banker.h stores them on disk)
 typedef struct
 {
     LinguisticElementType type;
@@ -29,25 +32,110 @@ typedef struct
 typedef struct
 {
     LinguisticElement base;
-    Token ***occurrences; // Array of arrays of token pointers
+    Token **occurrences; // First token of each occurrence, which runs on for base.token_count tokens
     size_t occurrence_count;
 } ExtendedLinguisticElement;
 
+// Control bytes are matched a group at a time, one SIMD compare per group
+#define LIMDY_LINGUISTIC_ELEMENT_GROUP_SIZE 16
+
+// Swiss-table layout: probing only reads the control bytes, 7 hash bits per slot, empty or moved, and
+// the hashes of slots whose bits match; payloads are touched once the hash is found
+typedef struct
+{
+    uint8_t *control;                    // capacity + GROUP_SIZE bytes; the tail mirrors the first group
+    uint64_t *hashes;                    // Full hash of each slot
+    ExtendedLinguisticElement *elements; // Payload of each slot, valid where the control byte is full
+    size_t capacity;                     // Power of two, at least one group; 0 for no table
+} LinguisticElementTable;
+
+// Growing does not rehash in one go: the outgrown table is kept and each insertion moves a few of its
+// groups into the new one, so no single insertion pays for the whole map
 typedef struct
 {
-    ExtendedLinguisticElement *elements;
-    size_t element_count;
-    size_t capacity;
-    LimdyMemoryPool *pool; // Memory pool for this map
+    LinguisticElementTable table; // Table new elements go into
+    LinguisticElementTable old;   // Table being drained by a resize, or capacity 0
+    size_t migrated;              // Slots of old already drained
+    size_t element_count;         // Elements in both tables
+    LimdyMemoryPool *pool;        // Memory pool for this map
+    LimdyArena *arena;            // Arena backing this map instead of pool, or NULL
 } LinguisticElementMap;
 
+// Number of independently locked shards of a ConcurrentLinguisticElementMap
+#define LIMDY_LINGUISTIC_ELEMENT_MAP_SHARDS 16
+
+// Arena chunk size of each shard of a ConcurrentLinguisticElementMap
+#define LIMDY_LINGUISTIC_ELEMENT_SHARD_CHUNK_SIZE (64 * 1024)
+
+// One shard of a concurrent map: a plain map with its own lock and arena
+typedef struct
+{
+    pthread_mutex_t mutex;
+    LinguisticElementMap map;
+    LimdyArena arena;
+} LinguisticElementMapShard;
+
+// Map shared by many threads, e.g. for vocab extraction across a corpus.
+// Elements are spread over shards by hash, so threads recording different
+// elements rarely wait on each other.
+typedef struct
+{
+    LinguisticElementMapShard shards[LIMDY_LINGUISTIC_ELEMENT_MAP_SHARDS];
+} ConcurrentLinguisticElementMap;
+
+// Called once per element by linguistic_element_concurrent_map_for_each
+typedef void (*LinguisticElementVisitFn)(void *context, const ExtendedLinguisticElement *element);
+
 // Function prototypes
+// A plain map belongs to one RendererResult and is not synchronized, so single-threaded use pays for no
+// locking; maps shared between threads use ConcurrentLinguisticElementMap
 ErrorCode linguistic_element_map_init(LinguisticElementMap *map, size_t initial_capacity, LimdyMemoryPool *pool);
+// Arena-backed maps never free individual allocations; the arena is reset as a whole
+ErrorCode linguistic_element_map_init_arena(LinguisticElementMap *map, size_t initial_capacity, LimdyArena *arena);
+// Makes room for element_count elements in all, so filling the map up to that size never resizes it.
+// Unlike growth through adding, this rehashes existing elements at once; call it before filling.
+ErrorCode linguistic_element_map_reserve(LinguisticElementMap *map, size_t element_count);
+// Replaces the element with the same tokens if there is one; elements whose hashes merely collide are
+// kept side by side
 ErrorCode linguistic_element_map_add(LinguisticElementMap *map, ExtendedLinguisticElement *element);
-ErrorCode linguistic_element_map_add_occurrence(LinguisticElementMap *map, uint64_t hash, Token **tokens, size_t token_count);
+// Adds an occurrence to the element whose tokens equal the token_count consecutive tokens. The occurrence
+// points at the caller's tokens, which must outlive the map.
+ErrorCode linguistic_element_map_add_occurrence(LinguisticElementMap *map, uint64_t hash, Token *tokens, size_t token_count);
+// Adds an occurrence of the element made of token_count consecutive tokens under the given hash, creating
+// the element from a copy of the tokens on first sight. The occurrence points at the caller's tokens, which
+// must outlive the map.
+ErrorCode linguistic_element_map_record(LinguisticElementMap *map, LinguisticElementType type, uint64_t hash, Token *tokens,
+                                        size_t token_count);
+// Lookups never move elements: a found element stays put until the next addition to the map
+// Gets an element with the given hash, without comparing tokens
 ExtendedLinguisticElement *linguistic_element_map_find(LinguisticElementMap *map, uint64_t hash);
+// Gets the element with the given hash made of exactly these tokens
+ExtendedLinguisticElement *linguistic_element_map_find_tokens(LinguisticElementMap *map, uint64_t hash, const Token *tokens,
+                                                              size_t token_count);
+// Number of slots to iterate with linguistic_element_map_slot, counting both tables during a resize
+size_t linguistic_element_map_slot_count(const LinguisticElementMap *map);
+// Gets the element in slot index (below the slot count), or NULL if the slot is empty
+ExtendedLinguisticElement *linguistic_element_map_slot(LinguisticElementMap *map, size_t index);
+// Allocates storage owned by the map, from its arena or else its pool; it is released with the map when an
+// element's tokens point at it
+void *linguistic_element_map_alloc(LinguisticElementMap *map, size_t size);
+// Returns storage from linguistic_element_map_alloc that the map does not hold; a no-op for arena-backed maps
+void linguistic_element_map_release(LinguisticElementMap *map, void *ptr);
 void linguistic_element_map_free(LinguisticElementMap *map);
 
+// The element table is split over the shards, so initial_capacity is the expected total
+ErrorCode linguistic_element_concurrent_map_init(ConcurrentLinguisticElementMap *map, size_t initial_capacity);
+// Adds an occurrence of the element made of token_count consecutive tokens, creating the element on first
+// sight. The occurrence points at the caller's tokens, which must outlive the map. Thread-safe.
+ErrorCode linguistic_element_concurrent_map_record(ConcurrentLinguisticElementMap *map, LinguisticElementType type,
+                                                   Token *tokens, size_t token_count);
+// Gets how often an element was recorded; false if it never was. Thread-safe.
+bool linguistic_element_concurrent_map_occurrences(ConcurrentLinguisticElementMap *map, uint64_t hash, size_t *occurrence_count);
+size_t linguistic_element_concurrent_map_size(ConcurrentLinguisticElementMap *map);
+// Visits every element one shard at a time; visit must not record into the same map
+void linguistic_element_concurrent_map_for_each(ConcurrentLinguisticElementMap *map, LinguisticElementVisitFn visit, void *context);
+void linguistic_element_concurrent_map_free(ConcurrentLinguisticElementMap *map);
+
 // Hash function declaration
 uint64_t hash_linguistic_element(const Token *tokens, size_t token_count);
 
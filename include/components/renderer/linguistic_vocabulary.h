@@ -0,0 +1,196 @@
+/**
+ * @file linguistic_vocabulary.h
+ * @brief Compact, interned store of linguistic elements and their occurrences.
+ *
+ * A vocabulary interns every distinct token text once and names it by a
+ * 32-bit LinguisticTokenId; an element is the sequence of its tokens' IDs
+ * and is named by a 32-bit LinguisticElementId. Each occurrence is a packed
+ * 12-byte (element, offset, length) triple locating the element in its
+ * source text, instead of an array of Token pointers per occurrence.
+ *
+ * Records live in chunked, append-only vectors carved from the vocabulary's
+ * own arena, so they never move and nothing is freed until the vocabulary
+ * is. Tokens are interned by text alone; their classes are not part of
+ * their identity. A vocabulary is not thread-safe.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#ifndef LIMDY_COMPONENTS_RENDERER_LINGUISTIC_VOCABULARY_H
+#define LIMDY_COMPONENTS_RENDERER_LINGUISTIC_VOCABULARY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "error_handler.h"
+#include "arena.h"
+#include "token.h"
+#include "linguistic_element.h"
+
+/**
+ * @brief Records per chunk of each append-only vector; a power of two.
+ */
+#define LIMDY_LINGUISTIC_VOCABULARY_CHUNK_RECORDS 4096
+
+/**
+ * @brief ID of an interned token text.
+ */
+typedef uint32_t LinguisticTokenId;
+
+/**
+ * @brief ID of an element of a vocabulary.
+ */
+typedef uint32_t LinguisticElementId;
+
+/**
+ * @brief One occurrence of an element in a source text.
+ */
+typedef struct
+{
+    LinguisticElementId element_id; /**< The element that occurred */
+    uint32_t offset;                /**< Byte offset of its first token in the source */
+    uint32_t length;                /**< Bytes from its first token's start to its last token's end */
+} LinguisticOccurrence;
+
+/**
+ * @brief An element of a vocabulary.
+ */
+typedef struct
+{
+    uint64_t hash;                   /**< Hash of the token IDs */
+    const LinguisticTokenId *tokens; /**< IDs of the element's tokens */
+    uint32_t token_count;            /**< Number of tokens */
+    uint32_t occurrence_count;       /**< Number of occurrences recorded */
+    LinguisticElementType type;      /**< Type given when the element was first recorded */
+} LinguisticVocabularyElement;
+
+/**
+ * @brief Append-only vector of fixed-size records, grown a chunk at a time.
+ */
+typedef struct
+{
+    char **chunks;      /**< Chunks of LIMDY_LINGUISTIC_VOCABULARY_CHUNK_RECORDS records */
+    size_t chunk_slots; /**< Entries in the chunks array */
+    size_t count;       /**< Records appended */
+    size_t record_size; /**< Size of each record */
+} LinguisticChunkedVector;
+
+/**
+ * @brief Structure representing a vocabulary.
+ */
+typedef struct
+{
+    LimdyArena arena;                    /**< Backing of every record, string and table */
+    LinguisticChunkedVector tokens;      /**< Interned token texts, by LinguisticTokenId */
+    LinguisticChunkedVector elements;    /**< LinguisticVocabularyElement, by LinguisticElementId */
+    LinguisticChunkedVector occurrences; /**< LinguisticOccurrence, in recording order */
+    uint32_t *token_table;               /**< Open-addressing index of tokens by text; ID + 1, 0 if empty */
+    size_t token_table_capacity;         /**< Slots in token_table; a power of two */
+    uint32_t *element_table;             /**< Open-addressing index of elements by token IDs; ID + 1, 0 if empty */
+    size_t element_table_capacity;       /**< Slots in element_table; a power of two */
+} LinguisticVocabulary;
+
+/**
+ * @brief Initialize a vocabulary in caller-provided storage.
+ *
+ * @param vocabulary The vocabulary to initialize.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode linguistic_vocabulary_init(LinguisticVocabulary *vocabulary);
+
+/**
+ * @brief Free everything a vocabulary holds.
+ *
+ * @param vocabulary The vocabulary to free.
+ */
+void linguistic_vocabulary_free(LinguisticVocabulary *vocabulary);
+
+/**
+ * @brief Intern a token text, copying it on first sight.
+ *
+ * @param vocabulary The vocabulary.
+ * @param text The text; it need not be null-terminated.
+ * @param length Length of the text in bytes.
+ * @param id Pointer to store the text's ID.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode linguistic_vocabulary_intern(LinguisticVocabulary *vocabulary, const char *text, size_t length, LinguisticTokenId *id);
+
+/**
+ * @brief Get the text of an interned token.
+ *
+ * @param vocabulary The vocabulary.
+ * @param id The token's ID.
+ * @param length Pointer to store the text's length, or NULL.
+ * @return The null-terminated text, valid for the vocabulary's lifetime.
+ */
+const char *linguistic_vocabulary_token_text(const LinguisticVocabulary *vocabulary, LinguisticTokenId id, size_t *length);
+
+/**
+ * @brief Record an occurrence of the element made of token_count consecutive tokens.
+ *
+ * The element and its tokens are interned on first sight. The tokens'
+ * offsets locate the occurrence, so they must all refer to one source.
+ *
+ * @param vocabulary The vocabulary.
+ * @param type The element's type, kept from its first recording.
+ * @param tokens The tokens of the occurrence.
+ * @param token_count Number of tokens, at least one.
+ * @param element_id Pointer to store the element's ID, or NULL.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode linguistic_vocabulary_record(LinguisticVocabulary *vocabulary, LinguisticElementType type, const Token *tokens,
+                                       size_t token_count, LinguisticElementId *element_id);
+
+/**
+ * @brief Find the element made of token_count consecutive tokens.
+ *
+ * @param vocabulary The vocabulary.
+ * @param tokens The tokens.
+ * @param token_count Number of tokens.
+ * @param element_id Pointer to store the element's ID.
+ * @return true if the element was recorded, false otherwise.
+ */
+bool linguistic_vocabulary_find(const LinguisticVocabulary *vocabulary, const Token *tokens, size_t token_count,
+                                LinguisticElementId *element_id);
+
+/**
+ * @brief Get an element by ID.
+ *
+ * @param vocabulary The vocabulary.
+ * @param id The element's ID, below linguistic_vocabulary_element_count().
+ * @return The element, valid for the vocabulary's lifetime.
+ */
+const LinguisticVocabularyElement *linguistic_vocabulary_element(const LinguisticVocabulary *vocabulary, LinguisticElementId id);
+
+/**
+ * @brief Get an occurrence by its recording order.
+ *
+ * @param vocabulary The vocabulary.
+ * @param index The occurrence's index, below linguistic_vocabulary_occurrence_count().
+ * @return The occurrence, valid for the vocabulary's lifetime.
+ */
+const LinguisticOccurrence *linguistic_vocabulary_occurrence(const LinguisticVocabulary *vocabulary, size_t index);
+
+/**
+ * @brief Number of distinct token texts interned.
+ */
+size_t linguistic_vocabulary_token_count(const LinguisticVocabulary *vocabulary);
+
+/**
+ * @brief Number of distinct elements recorded.
+ */
+size_t linguistic_vocabulary_element_count(const LinguisticVocabulary *vocabulary);
+
+/**
+ * @brief Number of occurrences recorded.
+ */
+size_t linguistic_vocabulary_occurrence_count(const LinguisticVocabulary *vocabulary);
+
+/**
+ * @brief Error code for a vocabulary that ran out of 32-bit IDs or offsets.
+ */
+#define LIMDY_LINGUISTIC_VOCABULARY_ERROR_FULL (LIMDY_LINGUISTIC_ELEMENT_ERROR_BASE + 3)
+
+#endif // LIMDY_COMPONENTS_RENDERER_LINGUISTIC_VOCABULARY_H
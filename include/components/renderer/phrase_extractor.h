@@ -0,0 +1,121 @@
+/**
+ * @file phrase_extractor.h
+ * @brief Single-pass n-gram phrase extraction over a token stream.
+ *
+ * The extractor walks the tokens once, keeping one polynomial rolling hash
+ * per phrase length over the tokens' own hashes, so each window is hashed in
+ * O(1) from the one before it. A phrase enters the map once it has been seen
+ * min_occurrences times, with all of those occurrences, and every later
+ * occurrence is added as it is seen.
+ *
+ * A PhraseExtractorState carries the counts from one call to the next, so a
+ * stream that grows, such as a conversation, is extracted one part at a time
+ * with the same phrases, counts and occurrences as in one pass, except that
+ * no phrase spans two parts.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#ifndef LIMDY_COMPONENTS_RENDERER_PHRASE_EXTRACTOR_H
+#define LIMDY_COMPONENTS_RENDERER_PHRASE_EXTRACTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "error_handler.h"
+#include "token.h"
+#include "linguistic_element.h"
+
+/**
+ * @brief Longest phrase the extractor supports, in tokens.
+ */
+#define LIMDY_PHRASE_EXTRACTOR_MAX_LENGTH 8
+
+/**
+ * @brief Default configuration: phrases of 2 to 4 tokens seen at least twice.
+ */
+#define LIMDY_PHRASE_EXTRACTOR_CONFIG_DEFAULT ((PhraseExtractorConfig){2, 4, 2})
+
+/**
+ * @brief Which phrases to extract.
+ */
+typedef struct
+{
+    size_t min_length;      /**< Shortest phrase, in tokens; at least 1 */
+    size_t max_length;      /**< Longest phrase, in tokens; at most LIMDY_PHRASE_EXTRACTOR_MAX_LENGTH */
+    size_t min_occurrences; /**< Occurrences a phrase needs before it is kept; at least 1 */
+} PhraseExtractorConfig;
+
+/**
+ * @brief Check that a configuration is within the limits documented on its fields.
+ *
+ * @param config The configuration to check.
+ * @return ERROR_SUCCESS, or ERROR_INVALID_ARGUMENT if it is out of range.
+ */
+ErrorCode phrase_extractor_validate_config(const PhraseExtractorConfig *config);
+
+/**
+ * @brief Hash of a phrase as the extractor computes it.
+ *
+ * Phrase elements are keyed by this hash rather than by
+ * hash_linguistic_element(), so use it to look phrases up.
+ *
+ * @param tokens The phrase's tokens.
+ * @param token_count Number of tokens.
+ * @return The phrase's hash.
+ */
+uint64_t phrase_extractor_hash(const Token *tokens, size_t token_count);
+
+/**
+ * @brief Extract the phrases of a token stream into a map.
+ *
+ * Phrases are recorded as ELEMENT_PHRASE elements, with occurrences
+ * pointing at @p tokens, which must outlive the map.
+ *
+ * @param config Which phrases to extract.
+ * @param tokens The token stream.
+ * @param token_count Number of tokens.
+ * @param map The map to record the phrases into.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode phrase_extractor_extract(const PhraseExtractorConfig *config, Token *tokens, size_t token_count, LinguisticElementMap *map);
+
+/**
+ * @brief Opaque phrase counts kept between extractions of a growing stream.
+ */
+typedef struct PhraseExtractorState PhraseExtractorState;
+
+/**
+ * @brief Create a state for extracting a stream a part at a time.
+ *
+ * @param config Which phrases to extract; copied into the state.
+ * @param state Pointer to store the created state.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode phrase_extractor_state_create(const PhraseExtractorConfig *config, PhraseExtractorState **state);
+
+/**
+ * @brief Destroy a state.
+ *
+ * @param state The state, or NULL.
+ */
+void phrase_extractor_state_destroy(PhraseExtractorState *state);
+
+/**
+ * @brief Extract the phrases of the next part of a stream into a map.
+ *
+ * @p tokens is the whole stream so far, parts of earlier calls included,
+ * since a phrase reaching min_occurrences records earlier occurrences too.
+ * It may have moved since the last call, but occurrences already recorded
+ * still point at the old tokens; the caller moving it rebases them.
+ *
+ * @param state The state of the stream.
+ * @param tokens The token stream.
+ * @param first Index of the part's first token; at least the end of the last part.
+ * @param count Number of tokens in the part.
+ * @param map The map to record the phrases into, the same as for earlier parts.
+ * @return ErrorCode indicating success or failure; ERROR_INVALID_ARGUMENT if the part starts before the end of the last one.
+ */
+ErrorCode phrase_extractor_extract_more(PhraseExtractorState *state, Token *tokens, size_t first, size_t count, LinguisticElementMap *map);
+
+#endif // LIMDY_COMPONENTS_RENDERER_PHRASE_EXTRACTOR_H
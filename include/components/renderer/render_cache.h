@@ -0,0 +1,116 @@
+/**
+ * @file render_cache.h
+ * @brief Bounded, concurrent cache of tokenized and classified text.
+ *
+ * Entries are keyed by the text and its Language and hold an immutable,
+ * reference-counted RendererResult. The cache is split into shards, each
+ * with its own lock, hash chains and CLOCK ring: a hit only sets the
+ * entry's reference bit, and eviction sweeps the ring clearing bits until
+ * it finds an entry that was not used since the last sweep. An evicted
+ * entry stays valid until its last holder releases it.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#ifndef LIMDY_COMPONENTS_RENDERER_RENDER_CACHE_H
+#define LIMDY_COMPONENTS_RENDERER_RENDER_CACHE_H
+
+#include <stddef.h>
+#include "error_handler.h"
+#include "limdy_types.h"
+#include "renderer.h"
+
+/**
+ * @brief Number of independently locked shards.
+ */
+#define LIMDY_RENDER_CACHE_SHARDS 16
+
+/**
+ * @brief Arena chunk size of a cache entry.
+ */
+#define LIMDY_RENDER_CACHE_ENTRY_CHUNK_SIZE 1024
+
+/**
+ * @brief Function called with each cached entry.
+ *
+ * @param context The context passed to render_cache_for_each().
+ * @param text The entry's text.
+ * @param lang The language of the text.
+ * @param result The entry's result.
+ * @return ErrorCode indicating success or failure; a failure stops the walk.
+ */
+typedef ErrorCode (*RenderCacheVisitFn)(void *context, const char *text, Language lang, const RendererResult *result);
+
+/**
+ * @brief Create a cache.
+ *
+ * @param capacity Maximum number of entries, spread evenly over the shards.
+ * @param cache Pointer to store the created cache.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode render_cache_create(size_t capacity, RenderCache **cache);
+
+/**
+ * @brief Destroy a cache. Results still held stay valid until released.
+ *
+ * @param cache The cache to destroy.
+ */
+void render_cache_destroy(RenderCache *cache);
+
+/**
+ * @brief Get the result for a text, filling and inserting it on a miss.
+ *
+ * The fill function runs without any lock held. With a NULL cache every
+ * call fills a fresh, unshared result.
+ *
+ * @param cache The cache, or NULL.
+ * @param text The text to look up.
+ * @param lang The language of the text.
+ * @param fill Function producing the result on a miss.
+ * @param context Argument passed to @p fill.
+ * @param result Pointer to store the result; release it with render_cache_release().
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode render_cache_get(RenderCache *cache, const char *text, Language lang, RenderCacheFillFn fill, void *context,
+                           const RendererResult **result);
+
+/**
+ * @brief Drop a reference obtained from render_cache_get().
+ *
+ * @param result The result to release.
+ */
+void render_cache_release(const RendererResult *result);
+
+/**
+ * @brief Visit every cached entry.
+ *
+ * Entries are visited a shard at a time with the shard locked, so @p visit
+ * must not call into the cache.
+ *
+ * @param cache The cache.
+ * @param visit Function called once per entry.
+ * @param context Argument passed to @p visit.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode render_cache_for_each(RenderCache *cache, RenderCacheVisitFn visit, void *context);
+
+/**
+ * @brief Get the cache's counters.
+ *
+ * @param cache The cache.
+ * @param stats Pointer to store the counters.
+ */
+void render_cache_get_stats(RenderCache *cache, RenderCacheStats *stats);
+
+/**
+ * @brief Base error code for render cache errors.
+ */
+#define LIMDY_RENDER_CACHE_ERROR_BASE (ERROR_CUSTOM_BASE + 270)
+
+/**
+ * @brief Error code of a cache source that does not hold a text.
+ */
+#define LIMDY_RENDER_CACHE_ERROR_MISS (LIMDY_RENDER_CACHE_ERROR_BASE + 1)
+
+#endif // LIMDY_COMPONENTS_RENDERER_RENDER_CACHE_H
@@ -15,26 +15,76 @@
 
 #include <stddef.h>
 #include <stdbool.h>
-#include <pthread.h>
 #include "error_handler.h"
 #include "memory_pool.h"
+#include "arena.h"
 #include "limdy_types.h"
 #include "token.h"
 #include "linguistic_element.h"
+#include "phrase_extractor.h"
+#include "thread_pool.h"
+
+/**
+ * @brief Bytes per token assumed when sizing the first span array.
+ */
+#define LIMDY_RENDERER_BYTES_PER_TOKEN_ESTIMATE 4
+
+/**
+ * @brief Default target size of a segment rendered on its own in parallel mode.
+ */
+#define LIMDY_RENDERER_SEGMENT_BYTES 4096
 
 /**
  * @brief Structure holding the results of rendering.
+ *
+ * Storage comes from @c arena when it is set, otherwise from @c pool. An
+ * arena is owned by the caller, who releases the whole result in O(1) by
+ * resetting it; a pool is owned by the result and destroyed with it.
+ *
+ * Token spans point into @c source: the caller's text for tokenizers with
+ * span support, which must then outlive the result, or otherwise one
+ * interned block allocated together with the token array.
  */
 typedef struct
 {
     Token *tokens;
     size_t token_count;
+    const char *source;
     LinguisticElementMap vocab_map;
     LinguisticElementMap phrase_map;
     LinguisticElementMap syntax_map;
     LimdyMemoryPool *pool;
+    LimdyArena *arena;
 } RendererResult;
 
+/**
+ * @brief Opaque cache of tokenized text; see render_cache.h.
+ */
+typedef struct RenderCache RenderCache;
+
+/**
+ * @brief Function producing the result for a missing cache entry.
+ *
+ * @param context The context passed with the function.
+ * @param text The entry's own copy of the text, valid for the entry's lifetime.
+ * @param lang The language of the text.
+ * @param result Arena-backed result to fill.
+ * @return ErrorCode indicating success or failure.
+ */
+typedef ErrorCode (*RenderCacheFillFn)(void *context, const char *text, Language lang, RendererResult *result);
+
+/**
+ * @brief Counters of a Renderer's tokenization cache.
+ */
+typedef struct
+{
+    size_t hits;      /**< Lookups answered from the cache */
+    size_t misses;    /**< Lookups that ran the services */
+    size_t evictions; /**< Entries dropped to make room */
+    size_t entries;   /**< Entries currently cached */
+    size_t capacity;  /**< Maximum number of entries */
+} RenderCacheStats;
+
 /**
  * @brief Interface for classification services.
  */
@@ -46,13 +96,22 @@ typedef struct ClassificationService
 
 /**
  * @brief Structure representing a Renderer.
+ *
+ * A Renderer is never modified after creation and keeps all per-call state
+ * in the RendererResult, so calls on one Renderer run concurrently. The
+ * services it wraps must be reentrant.
  */
 typedef struct
 {
     LimdyMemoryPool *pool;
     TokenizationService *tokenization_service;
     ClassificationService *classification_service;
-    pthread_mutex_t mutex;
+    RenderCache *cache;                 /**< Tokenization cache, or NULL when disabled */
+    PhraseExtractorConfig phrase_config; /**< Phrases renderer_extract_elements() records */
+    LimdyThreadPool *workers;            /**< Workers of parallel mode, or NULL when disabled */
+    size_t segment_bytes;                /**< Target size of a parallel segment */
+    RenderCacheFillFn cache_source;      /**< Asked before tokenizing a text the cache misses, or NULL */
+    void *cache_source_context;          /**< Argument passed to cache_source */
 } Renderer;
 
 /**
@@ -75,7 +134,9 @@ void renderer_destroy(Renderer *renderer);
 /**
  * @brief Tokenize text in the specified language.
  *
- * This function is thread-safe.
+ * This function is thread-safe. With a span tokenizer the tokens refer to
+ * @p text directly, which must outlive the result; otherwise the token
+ * array and all token text take a single allocation.
  *
  * @param renderer The Renderer to use.
  * @param text The text to tokenize.
@@ -99,7 +160,9 @@ ErrorCode renderer_classify(Renderer *renderer, RendererResult *result);
 /**
  * @brief Extract linguistic elements (vocab, phrases, syntax) from classified text.
  *
- * This function is thread-safe.
+ * This function is thread-safe. Each distinct token is one vocab element and
+ * phrases are keyed by phrase_extractor_hash(); the occurrences of both
+ * point into the result's tokens.
  *
  * @param renderer The Renderer to use.
  * @param result Pointer to the RendererResult to extract elements from.
@@ -110,7 +173,10 @@ ErrorCode renderer_extract_elements(Renderer *renderer, RendererResult *result);
 /**
  * @brief Perform full rendering (tokenization, classification, and extraction) on text.
  *
- * This function is thread-safe.
+ * This function is thread-safe. The @c pool or @c arena already set on the
+ * result is kept; every other field is reinitialized. In parallel mode,
+ * texts of at least two segments are tokenized and classified segment by
+ * segment on the workers; the result is the same as the serial one.
  *
  * @param renderer The Renderer to use.
  * @param text The text to render.
@@ -120,10 +186,114 @@ ErrorCode renderer_extract_elements(Renderer *renderer, RendererResult *result);
  */
 ErrorCode renderer_render(Renderer *renderer, const char *text, Language lang, RendererResult *result);
 
+/**
+ * @brief Enable the tokenization cache.
+ *
+ * Call before the Renderer is shared between threads.
+ *
+ * @param renderer The Renderer to configure.
+ * @param capacity Maximum number of cached texts.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode renderer_enable_cache(Renderer *renderer, size_t capacity);
+
+/**
+ * @brief Set where cache misses are looked up before tokenizing.
+ *
+ * Call before the Renderer is shared between threads. The source fills the
+ * result of a text it holds and returns LIMDY_RENDER_CACHE_ERROR_MISS for
+ * one it does not, which is then tokenized and classified as usual. It may
+ * be called from several threads at once.
+ *
+ * @param renderer The Renderer to configure.
+ * @param source The source, or NULL to tokenize every miss.
+ * @param context Argument passed to @p source.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode renderer_set_cache_source(Renderer *renderer, RenderCacheFillFn source, void *context);
+
+/**
+ * @brief Enable parallel mode for renderer_render().
+ *
+ * The text is split after sentence ends (., !, ? or a newline, followed by
+ * whitespace) into segments of about @p segment_bytes, and each segment is
+ * tokenized and passed to the classifier as one batch on a worker. This
+ * needs a span tokenizer that never joins text across a sentence end;
+ * otherwise rendering stays serial. Elements are extracted from the merged
+ * tokens, so they match serial rendering too.
+ *
+ * Call before the Renderer is shared between threads.
+ *
+ * @param renderer The Renderer to configure.
+ * @param thread_count Number of workers, or 0 for one per online CPU.
+ * @param segment_bytes Target segment size, or 0 for LIMDY_RENDERER_SEGMENT_BYTES.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode renderer_enable_parallel(Renderer *renderer, size_t thread_count, size_t segment_bytes);
+
+/**
+ * @brief Set which phrases renderer_extract_elements() records.
+ *
+ * Call before the Renderer is shared between threads. The default is
+ * LIMDY_PHRASE_EXTRACTOR_CONFIG_DEFAULT.
+ *
+ * @param renderer The Renderer to configure.
+ * @param config The phrase extractor configuration.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode renderer_set_phrase_config(Renderer *renderer, const PhraseExtractorConfig *config);
+
+/**
+ * @brief Tokenize and classify text into a shared, immutable result.
+ *
+ * This function is thread-safe. With the cache enabled, repeated texts are
+ * answered without calling the services; without it every call produces a
+ * fresh result. Either way the result must not be modified.
+ *
+ * @param renderer The Renderer to use.
+ * @param text The text to tokenize.
+ * @param lang The language of the text.
+ * @param result Pointer to store the result; release it with renderer_release_shared().
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode renderer_tokenize_shared(Renderer *renderer, const char *text, Language lang, const RendererResult **result);
+
+/**
+ * @brief Release a result obtained from renderer_tokenize_shared().
+ *
+ * @param renderer The Renderer that produced the result.
+ * @param result The result to release.
+ */
+void renderer_release_shared(Renderer *renderer, const RendererResult *result);
+
+/**
+ * @brief Get the counters of the tokenization cache.
+ *
+ * All counters are zero while the cache is disabled.
+ *
+ * @param renderer The Renderer to query.
+ * @param stats Pointer to store the counters.
+ */
+void renderer_get_cache_stats(Renderer *renderer, RenderCacheStats *stats);
+
+/**
+ * @brief Allocate storage owned by a RendererResult.
+ *
+ * Storage comes from the result's arena when it is set, otherwise from its
+ * pool, and is released with the result. Used by cache sources that fill
+ * a result themselves.
+ *
+ * @param result The result the storage belongs to.
+ * @param size Number of bytes.
+ * @return The storage, or NULL on failure.
+ */
+void *renderer_result_alloc(RendererResult *result, size_t size);
+
 /**
  * @brief Free the resources of a RendererResult.
  *
- * This function is thread-safe.
+ * This function is thread-safe. Arena-backed results only drop their
+ * references; the caller resets the arena.
  *
  * @param renderer The Renderer that created the result.
  * @param result The RendererResult to free.
@@ -0,0 +1,118 @@
+/**
+ * @file renderer_stream.h
+ * @brief Incremental rendering of text that arrives in chunks.
+ *
+ * A stream takes a document as a sequence of pushed chunks and hands back
+ * rendered batches as soon as they are complete, instead of rendering the
+ * whole document at the end. Pushed chunks are copied into a bounded queue
+ * and rendered by the stream's own worker thread, so reading the next chunk
+ * overlaps with tokenizing and classifying the previous ones; a push blocks
+ * only while the queue is full.
+ *
+ * The last token of every chunk is held back and tokenized again together
+ * with the next chunk, so a token split across chunks comes out whole. Only
+ * the held-back text, the queued chunks and the batch being rendered are in
+ * memory at any time. Elements are extracted per batch: phrases spanning two
+ * batches and counts across the document are left to the callback.
+ *
+ * Streaming needs a tokenization service with tokenize_spans.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#ifndef LIMDY_COMPONENTS_RENDERER_RENDERER_STREAM_H
+#define LIMDY_COMPONENTS_RENDERER_RENDERER_STREAM_H
+
+#include <stddef.h>
+#include "error_handler.h"
+#include "limdy_types.h"
+#include "renderer.h"
+
+/**
+ * @brief Default configuration: four chunks ahead of the worker, tokens of up to 64 KB.
+ */
+#define LIMDY_RENDERER_STREAM_CONFIG_DEFAULT ((RendererStreamConfig){4, 64 * 1024})
+
+/**
+ * @brief Opaque structure representing a stream.
+ */
+typedef struct RendererStream RendererStream;
+
+/**
+ * @brief Limits of a stream.
+ */
+typedef struct
+{
+    size_t max_pending_chunks; /**< Chunks queued ahead of the worker before a push blocks; at least 1 */
+    size_t max_carry;          /**< Bytes held back for a token still open at the end of a chunk; longer tokens are split */
+} RendererStreamConfig;
+
+/**
+ * @brief Function receiving each rendered batch, on the stream's worker thread.
+ *
+ * The batch is tokenized, classified and has its elements extracted. Its
+ * tokens, text and maps are only valid during the call; copy what must be
+ * kept. Returning an error stops the stream, and the error is reported by
+ * the next renderer_stream_push() or renderer_stream_finish().
+ *
+ * @param context The context passed to renderer_stream_create().
+ * @param batch The rendered batch; token offsets are relative to its source.
+ * @param document_offset Offset of the batch's source in the whole document.
+ * @return ErrorCode indicating success or failure.
+ */
+typedef ErrorCode (*RendererStreamFn)(void *context, const RendererResult *batch, size_t document_offset);
+
+/**
+ * @brief Create a stream rendering one document.
+ *
+ * @param renderer The Renderer to use; it must outlive the stream.
+ * @param lang The language of the document.
+ * @param config Limits of the stream, or NULL for LIMDY_RENDERER_STREAM_CONFIG_DEFAULT.
+ * @param callback Function receiving each batch.
+ * @param context Context passed to the callback.
+ * @param stream Pointer to store the created stream.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode renderer_stream_create(Renderer *renderer, Language lang, const RendererStreamConfig *config,
+                                 RendererStreamFn callback, void *context, RendererStream **stream);
+
+/**
+ * @brief Queue the next chunk of the document.
+ *
+ * The chunk is copied, so the caller may reuse its buffer as soon as this
+ * returns. Blocks while max_pending_chunks chunks are waiting.
+ *
+ * @param stream The stream.
+ * @param chunk The chunk's bytes; it need not be null-terminated.
+ * @param length Length of the chunk in bytes.
+ * @return ErrorCode indicating success or failure, including errors of earlier batches.
+ */
+ErrorCode renderer_stream_push(RendererStream *stream, const char *chunk, size_t length);
+
+/**
+ * @brief Render everything still queued or held back and wait for the last batch.
+ *
+ * @param stream The stream.
+ * @return ErrorCode indicating success or failure of the whole stream.
+ */
+ErrorCode renderer_stream_finish(RendererStream *stream);
+
+/**
+ * @brief Destroy a stream, discarding whatever was not rendered yet.
+ *
+ * @param stream The stream to destroy.
+ */
+void renderer_stream_destroy(RendererStream *stream);
+
+/**
+ * @brief Base error code for stream errors.
+ */
+#define LIMDY_RENDERER_STREAM_ERROR_BASE (ERROR_CUSTOM_BASE + 220)
+
+/**
+ * @brief Error code for a push to a stream that was already finished.
+ */
+#define LIMDY_RENDERER_STREAM_ERROR_FINISHED (LIMDY_RENDERER_STREAM_ERROR_BASE + 1)
+
+#endif // LIMDY_COMPONENTS_RENDERER_RENDERER_STREAM_H
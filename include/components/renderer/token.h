@@ -2,7 +2,10 @@
 #define LIMDY_COMPONENTS_RENDERER_TOKEN_H
 
 #include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include "limdy_types.h"
+#include "error_handler.h"
 
 #define TOKEN_PLACEHOLDER ((char *)1)
 
@@ -18,17 +21,66 @@ typedef enum
     CLS_COUNT
 } TokenClass;
 
+/**
+ * @brief Set of token classes, one bit per TokenClass.
+ */
+typedef uint32_t TokenClassSet;
+
+_Static_assert(CLS_COUNT <= 32, "TokenClassSet has one bit per token class");
+
+/**
+ * @brief The set holding only @p cls.
+ */
+#define TOKEN_CLASS_BIT(cls) ((TokenClassSet)1 << (cls))
+
+/**
+ * @brief Largest text a token can refer into; offsets and lengths are 32-bit.
+ */
+#define LIMDY_TOKEN_MAX_TEXT_LENGTH UINT32_MAX
+
 /**
  * @brief Structure representing a token.
+ *
+ * A token is a span of @c length bytes at @c offset in the buffer its
+ * RendererResult refers to as @c source; @c text points at the same bytes.
+ * The text is not null-terminated in general, so always use @c length.
+ * Classes are held inline as a set, so a token is plain data that is
+ * copied with memcpy and owns no other memory.
  */
 typedef struct
 {
     char *text;
-    size_t length;
-    TokenClass *classes;
-    size_t class_count;
+    uint32_t length;
+    uint32_t offset;
+    TokenClassSet classes;
 } Token;
 
+_Static_assert(sizeof(Token) <= 24, "Token is a small fixed-size record");
+
+/**
+ * @brief Check whether a token has a class.
+ */
+static inline bool token_has_class(const Token *token, TokenClass cls)
+{
+    return (token->classes & TOKEN_CLASS_BIT(cls)) != 0;
+}
+
+/**
+ * @brief Add a class to a token.
+ */
+static inline void token_add_class(Token *token, TokenClass cls)
+{
+    token->classes |= TOKEN_CLASS_BIT(cls);
+}
+
+/**
+ * @brief Get the number of classes of a token.
+ */
+static inline size_t token_class_count(const Token *token)
+{
+    return (size_t)__builtin_popcount(token->classes);
+}
+
 /**
  * @brief Interface for tokenization services.
  */
@@ -37,6 +89,67 @@ typedef struct TokenizationService
     ErrorCode (*tokenize)(const char *text, Language lang, Token **tokens, size_t *token_count);
     void (*free_tokens)(Token *tokens, size_t token_count);
     void (*destroy)(struct TokenizationService *service);
+
+    /**
+     * @brief Optional zero-copy tokenizer, used instead of tokenize when set.
+     *
+     * Writes up to @p capacity spans, setting only @c offset and @c length
+     * (relative to @p text) of each, and stores the total number of tokens in
+     * @p token_count. A total above @p capacity makes the renderer retry with
+     * a larger array.
+     *
+     * @param text The text to tokenize.
+     * @param length Length of the text in bytes.
+     * @param lang The language of the text.
+     * @param spans Preallocated array to fill.
+     * @param capacity Number of entries in @p spans.
+     * @param token_count Pointer to store the number of tokens in the text.
+     * @return ErrorCode indicating success or failure.
+     */
+    ErrorCode (*tokenize_spans)(const char *text, size_t length, Language lang, Token *spans, size_t capacity, size_t *token_count);
 } TokenizationService;
 
-#endif // LIMDY_COMPONENTS_RENDERER_TOKEN_H
\ No newline at end of file
+/**
+ * @brief Languages with a built-in tokenizer, as X(language, name, apostrophes, inverted_marks).
+ *
+ * Every language gets its own copy of the tokenizer loop, specialized at
+ * compile time on its rules: whether an apostrophe between letters joins a
+ * word ("don't") and whether the inverted marks "¿" and "¡" open a clause.
+ * Bytes of other UTF-8 characters are word bytes in every language.
+ */
+#define LIMDY_TOKENIZER_LANGUAGES(X)       \
+    X(LANG_ENGLISH, english, true, false) \
+    X(LANG_SPANISH, spanish, false, true)
+
+/**
+ * @brief Built-in word tokenizer, usable as TokenizationService::tokenize_spans.
+ *
+ * Tokens are runs of letters, digits and non-ASCII characters; whitespace
+ * and punctuation separate them and produce no tokens. The language picks
+ * one of the specialized loops of LIMDY_TOKENIZER_LANGUAGES; the renderer
+ * recognizes this tokenizer and calls it without going through the service.
+ *
+ * @param text The text to tokenize.
+ * @param length Length of the text in bytes.
+ * @param lang The language of the text.
+ * @param spans Preallocated array to fill.
+ * @param capacity Number of entries in @p spans.
+ * @param token_count Pointer to store the number of tokens in the text.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode token_tokenize_spans(const char *text, size_t length, Language lang, Token *spans, size_t capacity, size_t *token_count);
+
+/**
+ * @brief Run a service's span tokenizer, calling the built-in one directly.
+ */
+static inline ErrorCode tokenization_service_tokenize_spans(const TokenizationService *service, const char *text, size_t length,
+                                                            Language lang, Token *spans, size_t capacity, size_t *token_count)
+{
+    if (service->tokenize_spans == token_tokenize_spans)
+    {
+        return token_tokenize_spans(text, length, lang, spans, capacity, token_count);
+    }
+    return service->tokenize_spans(text, length, lang, spans, capacity, token_count);
+}
+
+#endif // LIMDY_COMPONENTS_RENDERER_TOKEN_H
@@ -0,0 +1,208 @@
+/**
+ * @file teacher.h
+ * @brief Spaced-repetition scheduler for reviews of linguistic elements.
+ *
+ * A Teacher keeps one review item per (user, element) pair, where elements
+ * are named by the hash they have in a LinguisticElementMap. Nothing else
+ * about an element is stored, so millions of pairs take a few dozen bytes
+ * each. Every user's items sit in a 4-ary min-heap ordered by next review
+ * time, laid out so that the four children of a node share a cache line.
+ * Recording a review result updates the item's interval and moves it within
+ * its user's heap in O(log n). The next K due items of a user are read off
+ * the heap in O(K log K) without changing it.
+ *
+ * Intervals follow SM-2: each item has an ease factor, successful reviews
+ * multiply its interval by the ease, and a failed review starts it over.
+ * Times are in seconds on any clock the caller keeps consistent.
+ *
+ * A Teacher is not synchronized; callers sharing one between threads lock
+ * around it.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#ifndef LIMDY_COMPONENTS_TEACHER_H
+#define LIMDY_COMPONENTS_TEACHER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "error_handler.h"
+#include "linguistic_element.h"
+
+/**
+ * @brief Ease factor of a new item, in thousandths.
+ */
+#define LIMDY_TEACHER_INITIAL_EASE 2500
+
+/**
+ * @brief Lowest ease factor an item can fall to, in thousandths.
+ */
+#define LIMDY_TEACHER_MIN_EASE 1300
+
+/**
+ * @brief Interval after the first successful review, in seconds.
+ */
+#define LIMDY_TEACHER_FIRST_INTERVAL (24u * 60 * 60)
+
+/**
+ * @brief Interval after the second successful review, in seconds.
+ */
+#define LIMDY_TEACHER_SECOND_INTERVAL (6u * 24 * 60 * 60)
+
+/**
+ * @brief Interval of an item that was just forgotten, in seconds.
+ */
+#define LIMDY_TEACHER_RELEARN_INTERVAL (10u * 60)
+
+/**
+ * @brief Longest interval between two reviews, in seconds.
+ */
+#define LIMDY_TEACHER_MAX_INTERVAL (3650u * 24 * 60 * 60)
+
+/**
+ * @brief Opaque review scheduler.
+ */
+typedef struct Teacher Teacher;
+
+/**
+ * @brief How well a user recalled an element at a review.
+ */
+typedef enum
+{
+    TEACHER_GRADE_AGAIN, // Forgotten; the item starts over
+    TEACHER_GRADE_HARD,  // Recalled with difficulty
+    TEACHER_GRADE_GOOD,  // Recalled
+    TEACHER_GRADE_EASY   // Recalled without effort
+} TeacherGrade;
+
+/**
+ * @brief Schedule of one (user, element) pair.
+ */
+typedef struct
+{
+    uint64_t element_hash; /**< Hash of the element in its LinguisticElementMap */
+    uint64_t due;          /**< Time of the next review */
+    uint32_t interval;     /**< Seconds between the last review and the next */
+    uint16_t ease;         /**< Ease factor in thousandths */
+    uint16_t repetitions;  /**< Successful reviews in a row */
+    uint32_t lapses;       /**< Times the element was forgotten */
+} TeacherReview;
+
+/**
+ * @brief Create an empty scheduler.
+ *
+ * @param initial_capacity Number of items to make room for up front.
+ * @param teacher Pointer to store the created scheduler.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode teacher_create(size_t initial_capacity, Teacher **teacher);
+
+/**
+ * @brief Destroy a scheduler.
+ *
+ * @param teacher The scheduler, or NULL.
+ */
+void teacher_destroy(Teacher *teacher);
+
+/**
+ * @brief Start scheduling an element for a user, due right away.
+ *
+ * Adding an element the user already has keeps its schedule.
+ *
+ * @param teacher The scheduler.
+ * @param user The user.
+ * @param element_hash Hash of the element in its LinguisticElementMap.
+ * @param now The current time.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode teacher_add(Teacher *teacher, uint32_t user, uint64_t element_hash, uint64_t now);
+
+/**
+ * @brief Start scheduling every element of a map for a user.
+ *
+ * Elements are added by hash, so elements whose hashes collide share one
+ * item.
+ *
+ * @param teacher The scheduler.
+ * @param user The user.
+ * @param map The map whose elements to add.
+ * @param now The current time.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode teacher_add_map(Teacher *teacher, uint32_t user, LinguisticElementMap *map, uint64_t now);
+
+/**
+ * @brief Record the result of a review and reschedule the element.
+ *
+ * @param teacher The scheduler.
+ * @param user The user.
+ * @param element_hash Hash of the reviewed element.
+ * @param grade How well the user recalled it.
+ * @param now The time of the review.
+ * @return ErrorCode indicating success or failure; LIMDY_TEACHER_ERROR_NOT_FOUND if the user does not have the element.
+ */
+ErrorCode teacher_record(Teacher *teacher, uint32_t user, uint64_t element_hash, TeacherGrade grade, uint64_t now);
+
+/**
+ * @brief Get the schedule of an element for a user.
+ *
+ * @param teacher The scheduler.
+ * @param user The user.
+ * @param element_hash Hash of the element.
+ * @param review Pointer to store the schedule.
+ * @return true if the user has the element.
+ */
+bool teacher_find(const Teacher *teacher, uint32_t user, uint64_t element_hash, TeacherReview *review);
+
+/**
+ * @brief Get a user's earliest due items, earliest first.
+ *
+ * Runs in O(K log K) for K items, however many items the user has, and
+ * leaves the schedule unchanged.
+ *
+ * @param teacher The scheduler.
+ * @param user The user.
+ * @param until Only items due at or before this time are returned; UINT64_MAX for any.
+ * @param reviews Array to fill.
+ * @param capacity Most items to return.
+ * @param review_count Pointer to store the number of items returned.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode teacher_next_due(const Teacher *teacher, uint32_t user, uint64_t until, TeacherReview *reviews, size_t capacity,
+                           size_t *review_count);
+
+/**
+ * @brief Get the number of elements scheduled for a user.
+ *
+ * @param teacher The scheduler.
+ * @param user The user.
+ * @return The number of items of the user.
+ */
+size_t teacher_user_item_count(const Teacher *teacher, uint32_t user);
+
+/**
+ * @brief Get the number of items of all users.
+ *
+ * @param teacher The scheduler.
+ * @return The number of items.
+ */
+size_t teacher_item_count(const Teacher *teacher);
+
+/**
+ * @brief Base error code for scheduler errors.
+ */
+#define LIMDY_TEACHER_ERROR_BASE (ERROR_CUSTOM_BASE + 240)
+
+/**
+ * @brief Error code for an element the user does not have.
+ */
+#define LIMDY_TEACHER_ERROR_NOT_FOUND (LIMDY_TEACHER_ERROR_BASE + 1)
+
+/**
+ * @brief Error code for a scheduler holding as many items as it can index.
+ */
+#define LIMDY_TEACHER_ERROR_FULL (LIMDY_TEACHER_ERROR_BASE + 2)
+
+#endif // LIMDY_COMPONENTS_TEACHER_H
@@ -0,0 +1,264 @@
+/**
+ * @file translation_memory.h
+ * @brief Translation memory placed in front of a TranslationService.
+ *
+ * A translation memory maps (text, source language, target language) to the
+ * translated text and its attention matrix, stored compactly as rows x cols
+ * floats without row padding. It is split into shards, each with its own
+ * lock, hash chains and CLOCK ring, and is bounded by an entry count, a byte
+ * budget and an optional time to live. Entries live in a pool owned by the
+ * memory, so its footprint never exceeds the configured budget.
+ *
+ * An optional TranslationMemoryStore persists entries as they are added and
+ * replays them when the memory is created, so a warm restart does not begin
+ * with an empty cache. A file-backed store is provided. Stores that can look
+ * up single records instead page them in on the first miss of their text.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#ifndef LIMDY_COMPONENTS_TRANSLATION_MEMORY_H
+#define LIMDY_COMPONENTS_TRANSLATION_MEMORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "error_handler.h"
+#include "limdy_matrix.h"
+
+/**
+ * @brief Number of independently locked shards.
+ */
+#define LIMDY_TRANSLATION_MEMORY_SHARDS 16
+
+/**
+ * @brief Default configuration: 4096 entries in 8MB, never expiring, not persisted.
+ */
+#define LIMDY_TRANSLATION_MEMORY_CONFIG_DEFAULT ((TranslationMemoryConfig){4096, 8 * 1024 * 1024, 0, NULL})
+
+/**
+ * @brief A cached translation, valid until released.
+ */
+typedef struct
+{
+    const char *translated_text; /**< The translated text */
+    const float *attention;      /**< rows x cols attention scores, row after row */
+    size_t rows;                 /**< Number of rows in the attention matrix */
+    size_t cols;                 /**< Number of columns in the attention matrix */
+} TranslationMemoryHit;
+
+/**
+ * @brief One persisted entry, as passed to and from a store.
+ */
+typedef struct
+{
+    const char *text;            /**< The source text */
+    const char *source_lang;     /**< The source language */
+    const char *target_lang;     /**< The target language */
+    const char *translated_text; /**< The translated text */
+    const float *attention;      /**< rows x cols attention scores, row after row */
+    size_t rows;                 /**< Number of rows in the attention matrix */
+    size_t cols;                 /**< Number of columns in the attention matrix */
+    uint64_t expires_at;         /**< Expiry in milliseconds since the epoch, or 0 for never */
+} TranslationMemoryRecord;
+
+/**
+ * @brief Function receiving the records replayed by a store.
+ *
+ * @param context The context passed to the store's load.
+ * @param record The record; its strings and scores are only valid during the call.
+ * @return ErrorCode indicating success or failure; a failure stops the replay.
+ */
+typedef ErrorCode (*TranslationMemoryVisitFn)(void *context, const TranslationMemoryRecord *record);
+
+/**
+ * @brief Interface for the persistent backing of a translation memory.
+ *
+ * Implementations embed this structure as their first member. save may be
+ * called from several threads at once.
+ */
+typedef struct TranslationMemoryStore
+{
+    /**
+     * @brief Replay every persisted record, oldest first.
+     *
+     * @param store The store.
+     * @param visit Function called once per record.
+     * @param context Argument passed to @p visit.
+     * @return ErrorCode indicating success or failure.
+     */
+    ErrorCode (*load)(struct TranslationMemoryStore *store, TranslationMemoryVisitFn visit, void *context);
+
+    /**
+     * @brief Persist one record.
+     *
+     * @param store The store.
+     * @param record The record to persist.
+     * @return ErrorCode indicating success or failure.
+     */
+    ErrorCode (*save)(struct TranslationMemoryStore *store, const TranslationMemoryRecord *record);
+
+    /**
+     * @brief Flush and free the store.
+     *
+     * @param store The store to destroy.
+     */
+    void (*destroy)(struct TranslationMemoryStore *store);
+
+    /**
+     * @brief Optional lookup of one record, tried when a text misses the memory.
+     *
+     * May be called from several threads at once.
+     *
+     * @param store The store.
+     * @param text The source text.
+     * @param source_lang The source language.
+     * @param target_lang The target language.
+     * @param visit Function called with the record if the store holds one.
+     * @param context Argument passed to @p visit.
+     * @return ErrorCode indicating success or failure; LIMDY_TRANSLATION_MEMORY_ERROR_MISS if no record is held.
+     */
+    ErrorCode (*find)(struct TranslationMemoryStore *store, const char *text, const char *source_lang, const char *target_lang,
+                      TranslationMemoryVisitFn visit, void *context);
+} TranslationMemoryStore;
+
+/**
+ * @brief Limits and backing of a translation memory.
+ */
+typedef struct
+{
+    size_t max_entries;             /**< Maximum number of entries, spread evenly over the shards */
+    size_t max_bytes;               /**< Maximum bytes of entry storage, spread evenly over the shards */
+    uint64_t ttl_ms;                /**< Lifetime of new entries in milliseconds, or 0 for no expiry */
+    TranslationMemoryStore *store;  /**< Persistent backing owned by the memory, or NULL */
+} TranslationMemoryConfig;
+
+/**
+ * @brief Counters of a translation memory.
+ */
+typedef struct
+{
+    size_t hits;        /**< Lookups answered from memory */
+    size_t misses;      /**< Lookups that found nothing usable */
+    size_t expirations; /**< Entries dropped because their lifetime ended */
+    size_t evictions;   /**< Entries dropped to make room */
+    size_t entries;     /**< Entries currently held */
+    size_t bytes;       /**< Bytes of entry storage currently held */
+    size_t loaded;      /**< Entries replayed from the store at creation */
+    size_t paged_in;    /**< Entries found by the store's find on a miss, counted as hits */
+} TranslationMemoryStats;
+
+/**
+ * @brief Opaque structure representing a translation memory.
+ */
+typedef struct TranslationMemory TranslationMemory;
+
+/**
+ * @brief Create a translation memory, replaying its store if it has one.
+ *
+ * The memory owns the store from this call on, even if creation fails.
+ * Records that have already expired are skipped.
+ *
+ * @param config The limits and backing to use.
+ * @param memory Pointer to store the created memory.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translation_memory_create(const TranslationMemoryConfig *config, TranslationMemory **memory);
+
+/**
+ * @brief Destroy a translation memory and its store.
+ *
+ * Every hit must have been released first.
+ *
+ * @param memory The memory to destroy.
+ */
+void translation_memory_destroy(TranslationMemory *memory);
+
+/**
+ * @brief Look up a translation.
+ *
+ * @param memory The memory.
+ * @param text The source text.
+ * @param source_lang The source language.
+ * @param target_lang The target language.
+ * @param hit Pointer to store the hit; release it with translation_memory_release().
+ * @return ERROR_SUCCESS on a hit, LIMDY_TRANSLATION_MEMORY_ERROR_MISS if nothing usable is held.
+ */
+ErrorCode translation_memory_lookup(TranslationMemory *memory, const char *text, const char *source_lang, const char *target_lang,
+                                    const TranslationMemoryHit **hit);
+
+/**
+ * @brief Drop a reference obtained from translation_memory_lookup().
+ *
+ * @param hit The hit to release.
+ */
+void translation_memory_release(const TranslationMemoryHit *hit);
+
+/**
+ * @brief Add a translation and persist it to the store.
+ *
+ * An entry larger than a shard's byte budget is not held. If the text is
+ * already held the existing entry is kept.
+ *
+ * @param memory The memory.
+ * @param text The source text.
+ * @param source_lang The source language.
+ * @param target_lang The target language.
+ * @param translated_text The translated text.
+ * @param attention The attention matrix, or NULL for none.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translation_memory_insert(TranslationMemory *memory, const char *text, const char *source_lang, const char *target_lang,
+                                    const char *translated_text, const LimdyMatrix *attention);
+
+/**
+ * @brief Visit every entry the memory holds that has not expired.
+ *
+ * Entries are visited a shard at a time with the shard locked, so @p visit
+ * must not call into the memory. A failed visit stops the walk.
+ *
+ * @param memory The memory.
+ * @param visit Function called once per entry; the record is only valid during the call.
+ * @param context Argument passed to @p visit.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translation_memory_for_each(TranslationMemory *memory, TranslationMemoryVisitFn visit, void *context);
+
+/**
+ * @brief Get the memory's counters.
+ *
+ * @param memory The memory.
+ * @param stats Pointer to store the counters.
+ */
+void translation_memory_get_stats(TranslationMemory *memory, TranslationMemoryStats *stats);
+
+/**
+ * @brief Open an append-only file store, creating the file if needed.
+ *
+ * Records are appended in native byte order, each with a checksum. A record
+ * cut short by a crash ends the replay and is truncated away, so later
+ * appends stay readable. Replaying keeps the newest record of a text, and
+ * records that expired are skipped rather than removed from the file.
+ *
+ * @param path Path of the file.
+ * @param store Pointer to store the created store.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translation_memory_file_store_create(const char *path, TranslationMemoryStore **store);
+
+/**
+ * @brief Base error code for translation memory errors.
+ */
+#define LIMDY_TRANSLATION_MEMORY_ERROR_BASE (ERROR_CUSTOM_BASE + 210)
+
+/**
+ * @brief Error code for a lookup that found nothing usable.
+ */
+#define LIMDY_TRANSLATION_MEMORY_ERROR_MISS (LIMDY_TRANSLATION_MEMORY_ERROR_BASE + 1)
+
+/**
+ * @brief Error code for a store file that is not a translation memory.
+ */
+#define LIMDY_TRANSLATION_MEMORY_ERROR_BAD_STORE (LIMDY_TRANSLATION_MEMORY_ERROR_BASE + 2)
+
+#endif // LIMDY_COMPONENTS_TRANSLATION_MEMORY_H
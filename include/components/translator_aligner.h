@@ -15,25 +15,87 @@
 #define LIMDY_COMPONENTS_TRANSLATOR_ALIGNER_H
 
 #include <stddef.h>
+#include <stdbool.h>
 #include <pthread.h>
 #include "error_handler.h"
 #include "renderer.h"
 #include "memory_pool.h"
+#include "arena.h"
+#include "limdy_matrix.h"
+#include "attention_kernel.h"
+#include "thread_pool.h"
+#include "translation_memory.h"
+
+/**
+ * @brief Maximum number of idle result pools a translator keeps for reuse.
+ */
+#define LIMDY_TRANSLATOR_POOL_CACHE_SIZE 8
+
+/**
+ * @brief Granularity of result pool sizes; matches the pool memory alignment.
+ */
+#define LIMDY_TRANSLATOR_POOL_GRANULE LIMDY_SLAB_SPAN_SIZE
+
+/**
+ * @brief Arena chunk size of an asynchronous request; small so many can be in flight.
+ */
+#define LIMDY_TRANSLATION_REQUEST_ARENA_CHUNK_SIZE 4096
+
+/**
+ * @brief Free list of result pools owned by a translator.
+ *
+ * New pools are sized from a running average of the bytes earlier results
+ * actually used, so a typical request fits without a 10MB pool per result.
+ */
+typedef struct TranslationPoolRecycler
+{
+    LimdyMemoryPool *pools[LIMDY_TRANSLATOR_POOL_CACHE_SIZE]; /**< Idle pools ready for reuse */
+    size_t count;                                             /**< Number of idle pools */
+    size_t estimate;                                          /**< Running average of bytes used per result */
+    pthread_mutex_t mutex;                                    /**< Protects the free list and estimate */
+} TranslationPoolRecycler;
 
 /**
  * @brief Structure to hold the result of a translation operation.
  */
 typedef struct
 {
-    char *translated_text;    /**< The translated text */
-    float **attention_matrix; /**< Attention matrix (from the translator) for alignment */
-    size_t rows;              /**< Number of rows in the attention matrix */
-    size_t cols;              /**< Number of columns in the attention matrix */
-    LimdyMemoryPool *pool;    /**< Memory pool for this translation result */
+    char *translated_text;              /**< The translated text */
+    LimdyMatrix attention;              /**< Dense attention matrix (from the translator) for alignment */
+    float **attention_matrix;           /**< Row pointers into attention, for float ** consumers */
+    size_t rows;                        /**< Number of rows in the attention matrix */
+    size_t cols;                        /**< Number of columns in the attention matrix */
+    LimdyMemoryPool *pool;              /**< Memory pool for this translation result */
+    LimdyArena *arena;                  /**< Caller-owned arena used instead of a pool, or NULL */
+    TranslationPoolRecycler *recycler;  /**< Recycler the pool is returned to, or NULL */
 } TranslationResult;
 
+/**
+ * @brief Completion function handed to TranslationService::translate_async.
+ *
+ * The text and matrix stay owned by the service and are only read until
+ * the function returns.
+ *
+ * @param context The context passed to translate_async.
+ * @param error ErrorCode indicating success or failure.
+ * @param translated_text The translated text, or NULL on failure.
+ * @param attention The dense attention matrix, or NULL on failure.
+ */
+typedef void (*TranslationDoneFn)(void *context, ErrorCode error, const char *translated_text, LimdyMatrix *attention);
+
+/**
+ * @brief Function receiving a translation while it is being produced.
+ *
+ * @param context The context passed along with the function.
+ * @param partial_text The translation so far, not null-terminated; only read during the call.
+ * @param length Length of the partial text in bytes.
+ */
+typedef void (*TranslationPartialFn)(void *context, const char *partial_text, size_t length);
+
 /**
  * @brief Interface for translation services.
+ *
+ * Functions may be called from several threads at once and must be reentrant.
  */
 typedef struct
 {
@@ -59,10 +121,94 @@ typedef struct
      * @return ErrorCode indicating success or failure.
      */
     ErrorCode (*get_attention_matrix)(const char *source_text, const char *target_text, float ***attention_matrix, size_t *rows, size_t *cols);
+
+    /**
+     * @brief Optional function pointer for getting a dense attention matrix.
+     *
+     * Used instead of get_attention_matrix when set. The service initializes
+     * the matrix, typically with limdy_matrix_init(); an owned matrix is
+     * released along with the translation result.
+     *
+     * @param source_text The source text.
+     * @param target_text The target (translated) text.
+     * @param attention The zeroed matrix to fill.
+     * @return ErrorCode indicating success or failure.
+     */
+    ErrorCode (*get_attention_dense)(const char *source_text, const char *target_text, LimdyMatrix *attention);
+
+    /**
+     * @brief Optional function pointer for releasing service output.
+     *
+     * Called once the translator has copied the text and matrix into the
+     * result. When NULL, the service keeps ownership of what it returned.
+     *
+     * @param translated_text The text returned by translate.
+     * @param attention_matrix The matrix returned by get_attention_matrix, or NULL if it failed.
+     * @param rows Number of rows in the attention matrix.
+     */
+    void (*free_translation)(char *translated_text, float **attention_matrix, size_t rows);
+
+    /**
+     * @brief Optional function pointer for translating many texts in one call.
+     *
+     * Each attention matrix is filled as by get_attention_dense. Texts are
+     * released through free_translation (with a NULL matrix) when it is set.
+     * On failure the service releases anything it produced.
+     *
+     * @param texts The texts to translate.
+     * @param count Number of texts.
+     * @param source_lang The source language.
+     * @param target_lang The target language.
+     * @param translated_texts Array of count entries to store the translations.
+     * @param attention Array of count zeroed matrices to fill.
+     * @return ErrorCode indicating success or failure.
+     */
+    ErrorCode (*translate_batch)(const char **texts, size_t count, const char *source_lang, const char *target_lang,
+                                 char **translated_texts, LimdyMatrix *attention);
+
+    /**
+     * @brief Optional function pointer for starting a translation without blocking.
+     *
+     * Returns once the request is sent. @p done is called exactly once, from
+     * any thread, when the translation and its attention matrix are ready;
+     * it is not called if this function itself fails. The input strings stay
+     * valid until then.
+     *
+     * @param text The text to translate.
+     * @param source_lang The source language.
+     * @param target_lang The target language.
+     * @param done Function to call on completion.
+     * @param context Argument to pass to @p done.
+     * @return ErrorCode indicating whether the request was started.
+     */
+    ErrorCode (*translate_async)(const char *text, const char *source_lang, const char *target_lang,
+                                 TranslationDoneFn done, void *context);
+
+    /**
+     * @brief Optional function pointer for translating with partial results.
+     *
+     * Like translate, but calls @p partial on the calling thread whenever
+     * the translation so far grows, each partial text extending the one
+     * before, and returns the whole translation at the end.
+     *
+     * @param text The text to translate.
+     * @param source_lang The source language.
+     * @param target_lang The target language.
+     * @param partial Function to call with each partial translation.
+     * @param context Argument to pass to @p partial.
+     * @param translated_text Pointer to store the translated text.
+     * @return ErrorCode indicating success or failure.
+     */
+    ErrorCode (*translate_stream)(const char *text, const char *source_lang, const char *target_lang,
+                                  TranslationPartialFn partial, void *context, char **translated_text);
 } TranslationService;
 
 /**
  * @brief Interface for alignment services.
+ *
+ * Functions may be called from several threads at once and must be reentrant.
+ * The alignment array is allocated with limdy_memory_pool_alloc() and freed
+ * by the aligner.
  */
 typedef struct
 {
@@ -84,27 +230,52 @@ typedef struct
                               const char **target_tokens, size_t target_token_count,
                               float **attention_matrix, size_t rows, size_t cols,
                               int **alignment, size_t *alignment_size);
+
+    /**
+     * @brief Optional function pointer for aligning tokens with a dense attention matrix.
+     *
+     * Used instead of align_tokens when set, so rows can be read contiguously.
+     *
+     * @param source_tokens Array of source language tokens.
+     * @param source_token_count Number of source tokens.
+     * @param target_tokens Array of target language tokens.
+     * @param target_token_count Number of target tokens.
+     * @param attention The dense attention matrix from the translator.
+     * @param alignment Pointer to store the alignment result.
+     * @param alignment_size Pointer to store the size of the alignment.
+     * @return ErrorCode indicating success or failure.
+     */
+    ErrorCode (*align_tokens_dense)(const char **source_tokens, size_t source_token_count,
+                                    const char **target_tokens, size_t target_token_count,
+                                    const LimdyMatrix *attention,
+                                    int **alignment, size_t *alignment_size);
 } AlignmentService;
 
 /**
  * @brief Structure representing a translator.
+ *
+ * Immutable after creation apart from the internally locked recycler and
+ * translation memory, so one translator can serve many threads as long as
+ * its service is reentrant.
  */
 typedef struct
 {
-    TranslationService *service; /**< The translation service */
-    pthread_mutex_t mutex;       /**< Mutex for thread-safe operations */
-    LimdyMemoryPool *pool;       /**< Memory pool for allocations */
+    TranslationService *service;      /**< The translation service */
+    TranslationPoolRecycler recycler; /**< Reusable pools for translation results */
+    TranslationMemory *memory;        /**< Translations consulted before the service, or NULL when disabled */
 } Translator;
 
 /**
  * @brief Structure representing an aligner.
+ *
+ * Immutable once configured; alignment works in a per-thread scratch arena
+ * and allocates its output per call.
  */
 typedef struct
 {
-    AlignmentService *service; /**< The alignment service */
+    AlignmentService *service; /**< The alignment service, or NULL for the built-in attention aligner */
     Renderer *renderer;        /**< The renderer for tokenization & processing */
-    pthread_mutex_t mutex;     /**< Mutex for thread-safe operations */
-    LimdyMemoryPool *pool;     /**< Memory pool for allocations */
+    LimdyAlignOptions options; /**< Options for the built-in attention aligner */
 } Aligner;
 
 /**
@@ -112,12 +283,69 @@ typedef struct
  */
 typedef struct
 {
-    Translator *translator; /**< The translator */
-    Aligner *aligner;       /**< The aligner */
-    pthread_mutex_t mutex;  /**< Mutex for thread-safe operations */
-    LimdyMemoryPool *pool;  /**< Memory pool for allocations */
+    Translator *translator;   /**< The translator */
+    Aligner *aligner;         /**< The aligner */
+    pthread_mutex_t mutex;    /**< Guards the lazy start of workers */
+    LimdyThreadPool *workers; /**< Workers for batch alignment, started on first use */
 } TranslatorAligner;
 
+/**
+ * @brief Aligned entries for a batch of texts, in a single allocation.
+ *
+ * The entries of text i are entries[offsets[i]] up to, but not including,
+ * entries[offsets[i + 1]].
+ */
+typedef struct
+{
+    size_t count;       /**< Number of texts in the batch */
+    size_t *offsets;    /**< count + 1 offsets into entries */
+    ErrorCode *status;  /**< Alignment result of each text */
+    char **entries;     /**< All aligned entries in input order */
+    size_t entry_count; /**< Total number of entries */
+    char *buffer;       /**< Allocation backing all of the above */
+} AlignedTextBatch;
+
+/**
+ * @brief A token of an alignment result.
+ */
+typedef struct
+{
+    const char *text; /**< Copy of the token's text in the result's buffer, null-terminated */
+    size_t length;    /**< Length of the text in bytes */
+    size_t offset;    /**< Offset of the token in the text it was tokenized from */
+} AlignedToken;
+
+/**
+ * @brief Structured result of an alignment, in a single allocation.
+ *
+ * Links whose source or target index has no token are dropped, so every
+ * link indexes both token arrays. Nothing is formatted until
+ * alignment_result_format() is called.
+ */
+typedef struct
+{
+    AlignmentLink *links;        /**< Links in the order the aligner produced them */
+    size_t link_count;           /**< Number of links */
+    AlignedToken *source_tokens; /**< Every token of the source text */
+    size_t source_count;         /**< Number of source tokens */
+    AlignedToken *target_tokens; /**< Every token of the target text */
+    size_t target_count;         /**< Number of target tokens */
+    void *buffer;                /**< Allocation backing all of the above */
+} AlignmentResult;
+
+/**
+ * @brief Growable buffer that formatted alignments are appended to.
+ *
+ * Zero-initialize it before the first use. A buffer reused across calls
+ * only allocates when a longer text than before is appended.
+ */
+typedef struct
+{
+    char *data;      /**< The formatted text, null-terminated, or NULL before the first append */
+    size_t length;   /**< Length of the text in bytes */
+    size_t capacity; /**< Bytes allocated for data */
+} AlignedTextBuffer;
+
 /**
  * @brief Create a new translator.
  *
@@ -129,13 +357,42 @@ Translator *translator_create(TranslationService *service);
 /**
  * @brief Destroy a translator and free its resources.
  *
+ * Results from translator_translate must be freed before this is called.
+ *
  * @param translator The translator to destroy.
  */
 void translator_destroy(Translator *translator);
 
+/**
+ * @brief Enable the translation memory.
+ *
+ * Translations are looked up in the memory before the service is called and
+ * added to it afterwards. With a store in @p config the memory starts with
+ * the entries it holds. Call before the translator is shared between threads.
+ *
+ * @param translator The translator to configure.
+ * @param config The limits and backing of the memory; the translator owns the store from this call on.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translator_enable_memory(Translator *translator, const TranslationMemoryConfig *config);
+
+/**
+ * @brief Get the counters of the translation memory.
+ *
+ * All counters are zero while the memory is disabled.
+ *
+ * @param translator The translator to query.
+ * @param stats Pointer to store the counters.
+ */
+void translator_get_memory_stats(Translator *translator, TranslationMemoryStats *stats);
+
 /**
  * @brief Perform a translation operation.
  *
+ * If @c result->arena is set on entry the result is backed by that arena and
+ * no pool is used; otherwise the result gets a pool from the translator's
+ * recycler, sized to fit the translated text and attention matrix.
+ *
  * @param translator The translator to use.
  * @param text The text to translate.
  * @param source_lang The source language.
@@ -145,15 +402,63 @@ void translator_destroy(Translator *translator);
  */
 ErrorCode translator_translate(Translator *translator, const char *text, const char *source_lang, const char *target_lang, TranslationResult *result);
 
+/**
+ * @brief Perform a translation operation, passing on partial translations as they are produced.
+ *
+ * Like translator_translate(). Services with a translate_stream hook report
+ * every partial translation; for others, and for texts answered by the
+ * translation memory, @p partial is called once with the whole translation.
+ *
+ * @param translator The translator to use.
+ * @param text The text to translate.
+ * @param source_lang The source language.
+ * @param target_lang The target language.
+ * @param partial Function to call with each partial translation.
+ * @param context Argument to pass to @p partial.
+ * @param result Pointer to store the translation result.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translator_translate_stream(Translator *translator, const char *text, const char *source_lang, const char *target_lang,
+                                      TranslationPartialFn partial, void *context, TranslationResult *result);
+
+/**
+ * @brief Translate a batch of texts.
+ *
+ * Texts held by the translation memory are answered from it. The rest go
+ * to the service's translate_batch hook when it has one, and are otherwise
+ * translated one by one. On failure no results are left allocated.
+ *
+ * @param translator The translator to use.
+ * @param texts The texts to translate.
+ * @param count Number of texts.
+ * @param source_lang The source language.
+ * @param target_lang The target language.
+ * @param results Array of count results to fill.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translator_translate_batch(Translator *translator, const char **texts, size_t count, const char *source_lang, const char *target_lang, TranslationResult *results);
+
 /**
  * @brief Create a new aligner.
  *
- * @param service The alignment service to use.
+ * A NULL service, or one with neither align function set, selects the
+ * built-in attention aligner (see attention_kernel.h).
+ *
+ * @param service The alignment service to use, or NULL.
  * @param renderer The renderer to use for tokenization.
  * @return Pointer to the created Aligner, or NULL on failure.
  */
 Aligner *aligner_create(AlignmentService *service, Renderer *renderer);
 
+/**
+ * @brief Set the options used by the built-in attention aligner.
+ *
+ * @param aligner The aligner to configure.
+ * @param options The options to use.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode aligner_set_options(Aligner *aligner, const LimdyAlignOptions *options);
+
 /**
  * @brief Destroy an aligner and free its resources.
  *
@@ -176,11 +481,93 @@ void aligner_destroy(Aligner *aligner);
  */
 ErrorCode aligner_align(Aligner *aligner, const char *source_text, const char *target_text, float **attention_matrix, size_t rows, size_t cols, char ***aligned_text, size_t *aligned_size);
 
+/**
+ * @brief Perform an alignment operation with a dense attention matrix.
+ *
+ * @param aligner The aligner to use.
+ * @param source_text The source text.
+ * @param target_text The target (translated) text.
+ * @param attention The dense attention matrix from the translator.
+ * @param aligned_text Pointer to store the aligned text.
+ * @param aligned_size Pointer to store the size of the aligned text.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode aligner_align_matrix(Aligner *aligner, const char *source_text, const char *target_text, const LimdyMatrix *attention, char ***aligned_text, size_t *aligned_size);
+
+/**
+ * @brief Perform an alignment operation, returning the links and tokens.
+ *
+ * @param aligner The aligner to use.
+ * @param source_text The source text.
+ * @param target_text The target (translated) text.
+ * @param attention_matrix The attention matrix from the translator.
+ * @param rows Number of rows in the attention matrix.
+ * @param cols Number of columns in the attention matrix.
+ * @param result Pointer to store the result; free with free_alignment_result().
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode aligner_align_result(Aligner *aligner, const char *source_text, const char *target_text, float **attention_matrix, size_t rows, size_t cols, AlignmentResult *result);
+
+/**
+ * @brief Perform an alignment operation with a dense attention matrix, returning the links and tokens.
+ *
+ * @param aligner The aligner to use.
+ * @param source_text The source text.
+ * @param target_text The target (translated) text.
+ * @param attention The dense attention matrix from the translator.
+ * @param result Pointer to store the result; free with free_alignment_result().
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode aligner_align_matrix_result(Aligner *aligner, const char *source_text, const char *target_text, const LimdyMatrix *attention, AlignmentResult *result);
+
+/**
+ * @brief Align already tokenized source text with a dense attention matrix, returning the links and tokens.
+ *
+ * The source is not tokenized again, so callers that keep the source
+ * tokens, such as conversations, tokenize each text once.
+ *
+ * @param aligner The aligner to use.
+ * @param source_tokens The tokens of the source text, e.g. a RendererResult from renderer_tokenize().
+ * @param target_text The target (translated) text.
+ * @param attention The dense attention matrix from the translator.
+ * @param result Pointer to store the result; free with free_alignment_result().
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode aligner_align_tokens_result(Aligner *aligner, const RendererResult *source_tokens, const char *target_text,
+                                      const LimdyMatrix *attention, AlignmentResult *result);
+
+/**
+ * @brief Append the aligned pairs of a result to a buffer.
+ *
+ * Each link is written as "[source] [target]" followed by a newline, in
+ * the same form as the entries of aligner_align(). The buffer grows at most
+ * once per call.
+ *
+ * @param result The alignment result to format.
+ * @param buffer The buffer to append to.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode alignment_result_format(const AlignmentResult *result, AlignedTextBuffer *buffer);
+
+/**
+ * @brief Free the storage of an alignment result.
+ *
+ * @param result The result to free.
+ */
+void free_alignment_result(AlignmentResult *result);
+
+/**
+ * @brief Free the storage of a formatting buffer.
+ *
+ * @param buffer The buffer to free; it is left empty and can be reused.
+ */
+void aligned_text_buffer_free(AlignedTextBuffer *buffer);
+
 /**
  * @brief Create a new translator-aligner.
  *
  * @param trans_service The translation service to use.
- * @param align_service The alignment service to use.
+ * @param align_service The alignment service to use, or NULL for the built-in attention aligner.
  * @param renderer The renderer to use for tokenization.
  * @return Pointer to the created TranslatorAligner, or NULL on failure.
  */
@@ -206,9 +593,103 @@ void translator_aligner_destroy(TranslatorAligner *ta);
  */
 ErrorCode translator_aligner_process(TranslatorAligner *ta, const char *text, const char *source_lang, const char *target_lang, char ***aligned_text, size_t *aligned_size);
 
+/**
+ * @brief Translate and align a batch of texts.
+ *
+ * The batch is translated in one service call where supported, then the
+ * texts are aligned in parallel on the translator-aligner's workers. A text
+ * that fails to align gets no entries and its status records the error; the
+ * function itself only fails if translation or allocation does.
+ *
+ * @param ta The translator-aligner to use.
+ * @param texts The texts to translate and align.
+ * @param count Number of texts.
+ * @param source_lang The source language.
+ * @param target_lang The target language.
+ * @param batch Pointer to store the aligned entries; free with free_aligned_text_batch().
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translator_aligner_process_batch(TranslatorAligner *ta, const char **texts, size_t count, const char *source_lang, const char *target_lang, AlignedTextBatch *batch);
+
+/**
+ * @brief Free the storage of an aligned batch.
+ *
+ * @param batch The batch to free.
+ */
+void free_aligned_text_batch(AlignedTextBatch *batch);
+
+/**
+ * @brief Opaque handle to an asynchronous translate-and-align request.
+ */
+typedef struct TranslationRequest TranslationRequest;
+
+/**
+ * @brief Function called when an asynchronous request completes.
+ *
+ * Runs on a worker or service thread. The aligned text is owned by the
+ * request and stays valid until the request is released.
+ *
+ * @param request The completed request.
+ * @param error ErrorCode indicating success or failure.
+ * @param aligned_text The aligned text, or NULL on failure.
+ * @param aligned_size The size of the aligned text.
+ * @param user_data The user data passed to translator_aligner_submit().
+ */
+typedef void (*TranslationCallback)(TranslationRequest *request, ErrorCode error, char **aligned_text, size_t aligned_size, void *user_data);
+
+/**
+ * @brief Start translating and aligning a text without blocking.
+ *
+ * The source is tokenized on a worker while the translation is in flight,
+ * and alignment runs on a worker once both are done. Services with a
+ * translate_async hook keep no thread busy during the remote call; others
+ * run their synchronous translate on a worker. Every request must have
+ * completed before the translator-aligner is destroyed.
+ *
+ * @param ta The translator-aligner to use.
+ * @param text The text to translate and align.
+ * @param source_lang The source language.
+ * @param target_lang The target language.
+ * @param callback Function called on completion, or NULL.
+ * @param user_data Argument passed to the callback.
+ * @param request Pointer to store the request handle; release it with translation_request_release().
+ * @return ErrorCode indicating whether the request was started.
+ */
+ErrorCode translator_aligner_submit(TranslatorAligner *ta, const char *text, const char *source_lang, const char *target_lang,
+                                    TranslationCallback callback, void *user_data, TranslationRequest **request);
+
+/**
+ * @brief Check whether a request has completed.
+ *
+ * @param request The request to check.
+ * @return true once the request has completed, false otherwise.
+ */
+bool translation_request_is_done(TranslationRequest *request);
+
+/**
+ * @brief Wait for a request to complete.
+ *
+ * @param request The request to wait for.
+ * @param aligned_text Pointer to store the aligned text, owned by the request; may be NULL.
+ * @param aligned_size Pointer to store the size of the aligned text; may be NULL.
+ * @return The request's ErrorCode.
+ */
+ErrorCode translation_request_wait(TranslationRequest *request, char ***aligned_text, size_t *aligned_size);
+
+/**
+ * @brief Release the caller's handle to a request.
+ *
+ * A request still in flight completes normally and is freed afterwards.
+ *
+ * @param request The request to release.
+ */
+void translation_request_release(TranslationRequest *request);
+
 /**
  * @brief Free the resources of a translation result.
  *
+ * Pools that came from a translator are reset and handed back to it.
+ *
  * @param result The translation result to free.
  */
 void free_translation_result(TranslationResult *result);
@@ -222,9 +703,22 @@ void free_translation_result(TranslationResult *result);
  */
 ErrorCode allocate_translation_result(TranslationResult *result, size_t pool_size);
 
+/**
+ * @brief Initialize a translation result backed by a caller-owned arena.
+ *
+ * Nothing is freed individually; resetting the arena releases the result.
+ *
+ * @param result Pointer to the TranslationResult structure to initialize.
+ * @param arena The arena to allocate from.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode allocate_translation_result_from_arena(TranslationResult *result, LimdyArena *arena);
+
 /**
  * @brief Free the resources of aligned text.
  *
+ * The entries share one allocation with the array that points to them.
+ *
  * @param aligned_text The aligned text to free.
  * @param size The size of the aligned text.
  */
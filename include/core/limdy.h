@@ -0,0 +1,270 @@
+/**
+ * @file limdy.h
+ * @brief Process-level facilities of the Limdy project: warm-start snapshots.
+ *
+ * A new worker starts cold: its translation memory, tokenization cache and
+ * element maps are empty and fill only as requests repeat. A snapshot saves
+ * that state from a warm worker so a new one can start from it.
+ *
+ * A snapshot is a directory. It holds one image, which carries the
+ * translation memory and tokenization cache entries, and one bank (see
+ * banker.h) per saved LinguisticElementMap. The image uses the same scheme
+ * as a bank: it is read-only, relocatable and versioned, written to a
+ * temporary file and renamed into place, and mapped rather than read.
+ * After a fixed header, the sections are, each 8-byte aligned:
+ * - translation records, each with its hash, expiry and the blob offsets
+ *   of its strings and attention scores;
+ * - render records, each with its hash, language, the blob offset of its
+ *   text and of its token source, and its run of tokens;
+ * - tokens, each an offset into the source, a length and its class set;
+ * - maps, each the blob offset of its name; map i is the bank "map-<i>.bank";
+ * - the blob of strings and attention scores;
+ * - two hash indexes, of translations and of renders, open-addressed
+ *   tables of (hash, record) pairs with linear probing, at most half full.
+ *
+ * Opening a snapshot only maps the image and checks its header, so it takes
+ * the same time whatever the snapshot holds. Nothing is loaded up front:
+ * the translation memory and the renderer ask the snapshot when they miss,
+ * which pages in the one record they need, and an element map is read from
+ * its bank on the first call that asks for it. Records are bounds-checked
+ * as they are read, so a damaged image fails lookups instead of reading
+ * outside the mapping.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-15
+ */
+
+#ifndef LIMDY_CORE_LIMDY_H
+#define LIMDY_CORE_LIMDY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "error_handler.h"
+#include "translation_memory.h"
+#include "render_cache.h"
+#include "renderer.h"
+#include "linguistic_element.h"
+
+/**
+ * @brief Version of the snapshot image written by this build; images of other versions are refused.
+ */
+#define LIMDY_SNAPSHOT_FORMAT_VERSION 1
+
+/**
+ * @brief Name of the image inside a snapshot directory.
+ */
+#define LIMDY_SNAPSHOT_IMAGE_NAME "limdy.snapshot"
+
+/**
+ * @brief Opaque builder of a snapshot.
+ */
+typedef struct LimdySnapshotWriter LimdySnapshotWriter;
+
+/**
+ * @brief Opaque handle to an opened, memory-mapped snapshot.
+ */
+typedef struct LimdySnapshot LimdySnapshot;
+
+/**
+ * @brief Contents of a snapshot and how much of it was used.
+ */
+typedef struct
+{
+    size_t translations;           /**< Translation memory entries in the image */
+    size_t renders;                /**< Tokenization cache entries in the image */
+    size_t maps;                   /**< Element maps in the snapshot */
+    size_t translations_paged_in;  /**< Translation records handed to a memory */
+    size_t renders_paged_in;       /**< Render records handed to a renderer */
+    size_t maps_loaded;            /**< Element maps read from their banks */
+} LimdySnapshotStats;
+
+/**
+ * @brief Timing of one worker startup, cold or warm.
+ */
+typedef struct
+{
+    uint64_t started_ns; /**< Monotonic time limdy_startup_begin() was called */
+    uint64_t startup_ns; /**< Time from limdy_startup_begin() to limdy_startup_end() */
+    bool warm;           /**< Whether the worker started from a snapshot */
+} LimdyStartupReport;
+
+/**
+ * @brief Create an empty snapshot writer.
+ *
+ * @param writer Pointer to store the created writer.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_writer_create(LimdySnapshotWriter **writer);
+
+/**
+ * @brief Add a copy of every unexpired entry of a translation memory.
+ *
+ * Entries keep their expiry time. Adding the same text twice keeps the
+ * first copy.
+ *
+ * @param writer The writer.
+ * @param memory The memory to copy; it stays usable by other threads.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_writer_add_translations(LimdySnapshotWriter *writer, TranslationMemory *memory);
+
+/**
+ * @brief Add a copy of every entry of a tokenization cache.
+ *
+ * Only tokens and their classes are saved. Entries whose tokens do not
+ * point into their text or into one interned block are skipped.
+ *
+ * @param writer The writer.
+ * @param cache The cache to copy, such as a Renderer's cache; it stays usable by other threads.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_writer_add_renders(LimdySnapshotWriter *writer, RenderCache *cache);
+
+/**
+ * @brief Add a copy of the elements of a map under a name.
+ *
+ * Elements are saved with their tokens and hash; occurrences point into
+ * texts the snapshot does not hold and are not saved.
+ *
+ * @param writer The writer.
+ * @param name Name to load the map by; unique within the snapshot.
+ * @param map The map to copy.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_writer_add_map(LimdySnapshotWriter *writer, const char *name, LinguisticElementMap *map);
+
+/**
+ * @brief Write the snapshot to a directory, creating it if needed.
+ *
+ * The banks are written first and the image last, each through a temporary
+ * file renamed over the old one, so a reader opening the directory sees a
+ * complete image whose banks exist. The writer can go on adding and write
+ * again.
+ *
+ * @param writer The writer.
+ * @param directory Path of the snapshot directory.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_writer_write(LimdySnapshotWriter *writer, const char *directory);
+
+/**
+ * @brief Destroy a snapshot writer.
+ *
+ * @param writer The writer, or NULL.
+ */
+void limdy_snapshot_writer_destroy(LimdySnapshotWriter *writer);
+
+/**
+ * @brief Map a snapshot for reading.
+ *
+ * This function is O(1) in the size of the snapshot.
+ *
+ * @param directory Path of the snapshot directory.
+ * @param snapshot Pointer to store the opened snapshot.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_open(const char *directory, LimdySnapshot **snapshot);
+
+/**
+ * @brief Unmap a snapshot.
+ *
+ * Stores and renderers using the snapshot must be destroyed or detached first.
+ *
+ * @param snapshot The snapshot, or NULL.
+ */
+void limdy_snapshot_close(LimdySnapshot *snapshot);
+
+/**
+ * @brief Create a translation memory store that pages entries in from the snapshot.
+ *
+ * The store replays nothing when the memory is created; it is asked for
+ * each text the memory misses. It does not persist new entries, which are
+ * saved by the next snapshot. Pass it in the TranslationMemoryConfig of the
+ * memory to warm; the snapshot must outlive the memory.
+ *
+ * @param snapshot The snapshot.
+ * @param store Pointer to store the created store, owned by the memory it is given to.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_translation_store(LimdySnapshot *snapshot, TranslationMemoryStore **store);
+
+/**
+ * @brief Make a Renderer page tokenization results in from the snapshot.
+ *
+ * Texts the renderer's cache misses are looked up in the snapshot before
+ * they are tokenized. Call before the Renderer is shared between threads;
+ * the snapshot must outlive the renderer or be detached with
+ * renderer_set_cache_source(renderer, NULL, NULL).
+ *
+ * @param snapshot The snapshot.
+ * @param renderer The Renderer to warm.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_attach_renderer(LimdySnapshot *snapshot, Renderer *renderer);
+
+/**
+ * @brief Read a saved map's elements into a map.
+ *
+ * The bank is opened on this call and closed before it returns. Elements
+ * are copied with storage from the map's arena or pool, so the map does not
+ * depend on the snapshot. Elements the map already holds are kept.
+ *
+ * @param snapshot The snapshot.
+ * @param name Name the map was added with.
+ * @param map Initialized map to fill.
+ * @return ErrorCode indicating success or failure; LIMDY_SNAPSHOT_ERROR_NO_MAP if no map has that name.
+ */
+ErrorCode limdy_snapshot_load_map(LimdySnapshot *snapshot, const char *name, LinguisticElementMap *map);
+
+/**
+ * @brief Get what a snapshot holds and how much of it was paged in.
+ *
+ * This function is thread-safe.
+ *
+ * @param snapshot The snapshot.
+ * @param stats Pointer to store the counters.
+ */
+void limdy_snapshot_get_stats(const LimdySnapshot *snapshot, LimdySnapshotStats *stats);
+
+/**
+ * @brief Start timing a worker's startup.
+ *
+ * @param report The report to start.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_startup_begin(LimdyStartupReport *report);
+
+/**
+ * @brief Finish timing a worker's startup, once its services are ready.
+ *
+ * The time is logged and recorded in the startup.warm_ns histogram when
+ * @p snapshot is set, or startup.cold_ns otherwise.
+ *
+ * @param report The report started with limdy_startup_begin().
+ * @param snapshot The snapshot the worker started from, or NULL for a cold start.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_startup_end(LimdyStartupReport *report, const LimdySnapshot *snapshot);
+
+/**
+ * @brief Base error code for snapshot errors.
+ */
+#define LIMDY_SNAPSHOT_ERROR_BASE (ERROR_CUSTOM_BASE + 190)
+
+/**
+ * @brief Error code for an image that is not a snapshot, or a damaged one.
+ */
+#define LIMDY_SNAPSHOT_ERROR_BAD_FORMAT (LIMDY_SNAPSHOT_ERROR_BASE + 1)
+
+/**
+ * @brief Error code for an image written in another format version.
+ */
+#define LIMDY_SNAPSHOT_ERROR_VERSION (LIMDY_SNAPSHOT_ERROR_BASE + 2)
+
+/**
+ * @brief Error code for a map name the snapshot does not hold.
+ */
+#define LIMDY_SNAPSHOT_ERROR_NO_MAP (LIMDY_SNAPSHOT_ERROR_BASE + 3)
+
+#endif // LIMDY_CORE_LIMDY_H
@@ -0,0 +1,143 @@
+/**
+ * @file arena.h
+ * @brief Bump-pointer arena for short-lived, freed-as-a-whole allocations.
+ *
+ * An arena hands out memory by bumping a cursor through a chain of chunks.
+ * There are no per-allocation headers and no individual frees: everything
+ * is thrown away at once with limdy_arena_reset(), which keeps the chunks
+ * for the next request, or limdy_arena_destroy(). An arena is not
+ * thread-safe; use one per request or per thread.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#ifndef LIMDY_UTILS_ARENA_H
+#define LIMDY_UTILS_ARENA_H
+
+#include <stddef.h>
+#include "error_handler.h"
+
+/**
+ * @brief Default size of an arena chunk (64KB).
+ */
+#define LIMDY_ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+/**
+ * @brief Memory alignment used for arena allocations.
+ */
+#define LIMDY_ARENA_ALIGNMENT 16
+
+/**
+ * @brief A block of arena memory. Chunks form a singly linked chain.
+ */
+typedef struct LimdyArenaChunk
+{
+    struct LimdyArenaChunk *next; /**< Next chunk in the chain */
+    size_t size;                  /**< Usable bytes in this chunk */
+} LimdyArenaChunk;
+
+/**
+ * @brief Structure representing an arena.
+ */
+typedef struct
+{
+    LimdyArenaChunk *head;    /**< First chunk; allocation restarts here after a reset */
+    LimdyArenaChunk *current; /**< Chunk currently being bumped through */
+    char *cursor;             /**< Next free byte in the current chunk */
+    char *limit;              /**< End of the current chunk */
+    size_t chunk_size;        /**< Size of regular chunks */
+    size_t used;              /**< Bytes handed out since the last reset */
+} LimdyArena;
+
+/**
+ * @brief Initialize an arena in caller-provided storage.
+ *
+ * No memory is reserved until the first allocation.
+ *
+ * @param arena The arena to initialize.
+ * @param chunk_size Size of each chunk, or 0 for LIMDY_ARENA_DEFAULT_CHUNK_SIZE.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_arena_init(LimdyArena *arena, size_t chunk_size);
+
+/**
+ * @brief Create a heap-allocated arena.
+ *
+ * @param chunk_size Size of each chunk, or 0 for LIMDY_ARENA_DEFAULT_CHUNK_SIZE.
+ * @param arena Pointer to store the new arena.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_arena_create(size_t chunk_size, LimdyArena **arena);
+
+/**
+ * @brief Allocate memory from an arena.
+ *
+ * @param arena The arena to allocate from.
+ * @param size The number of bytes to allocate.
+ * @return A pointer aligned to LIMDY_ARENA_ALIGNMENT, or NULL if allocation fails.
+ */
+void *limdy_arena_alloc(LimdyArena *arena, size_t size);
+
+/**
+ * @brief Allocate memory with a specific alignment from an arena.
+ *
+ * @param arena The arena to allocate from.
+ * @param size The number of bytes to allocate.
+ * @param alignment Required alignment, a power of two.
+ * @return A pointer to the allocated memory, or NULL if allocation fails.
+ */
+void *limdy_arena_alloc_aligned(LimdyArena *arena, size_t size, size_t alignment);
+
+/**
+ * @brief Copy a string of known length into an arena, adding a terminator.
+ *
+ * @param arena The arena to allocate from.
+ * @param text The text to copy.
+ * @param length Number of bytes to copy.
+ * @return The NUL-terminated copy, or NULL if allocation fails.
+ */
+char *limdy_arena_strndup(LimdyArena *arena, const char *text, size_t length);
+
+/**
+ * @brief Throw away everything allocated from an arena in O(1).
+ *
+ * All chunks are kept and reused by later allocations.
+ *
+ * @param arena The arena to reset.
+ */
+void limdy_arena_reset(LimdyArena *arena);
+
+/**
+ * @brief Release all chunks of an arena initialized with limdy_arena_init.
+ *
+ * @param arena The arena to release.
+ */
+void limdy_arena_release(LimdyArena *arena);
+
+/**
+ * @brief Destroy an arena created with limdy_arena_create.
+ *
+ * @param arena The arena to destroy.
+ */
+void limdy_arena_destroy(LimdyArena *arena);
+
+/**
+ * @brief Get the number of bytes handed out since the last reset.
+ *
+ * @param arena The arena to query.
+ * @return The number of bytes allocated, including alignment padding.
+ */
+size_t limdy_arena_used(const LimdyArena *arena);
+
+/**
+ * @brief Base error code for arena errors.
+ */
+#define LIMDY_ARENA_ERROR_BASE (ERROR_CUSTOM_BASE + 150)
+
+/**
+ * @brief Error code for arena allocation failure.
+ */
+#define LIMDY_ARENA_ERROR_ALLOC_FAILED (LIMDY_ARENA_ERROR_BASE + 1)
+
+#endif // LIMDY_UTILS_ARENA_H
@@ -0,0 +1,142 @@
+/**
+ * @file attention_kernel.h
+ * @brief Vectorized kernels that turn an attention matrix into word alignments.
+ *
+ * Rows of the matrix are source tokens and columns are target tokens. The
+ * kernels compute the best target for every source token (row argmax) and
+ * the best source for every target token (column argmax), then symmetrize
+ * the two directions by intersection or grow-diag-final. The argmax passes
+ * have SSE2, AVX2 and NEON implementations chosen at runtime, with a scalar
+ * fallback; all of them produce identical results.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#ifndef LIMDY_UTILS_ATTENTION_KERNEL_H
+#define LIMDY_UTILS_ATTENTION_KERNEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "error_handler.h"
+#include "limdy_matrix.h"
+#include "arena.h"
+
+/**
+ * @brief A single link between a source token and a target token.
+ */
+typedef struct
+{
+    uint32_t source_index; /**< Row of the attention matrix */
+    uint32_t target_index; /**< Column of the attention matrix */
+    float score;           /**< Attention weight of the link */
+} AlignmentLink;
+
+/**
+ * @brief How the two argmax directions are combined.
+ */
+typedef enum
+{
+    LIMDY_ALIGN_INTERSECTION,     /**< Links that are the argmax in both directions */
+    LIMDY_ALIGN_GROW_DIAG_FINAL,  /**< Intersection grown towards the union */
+    LIMDY_ALIGN_UNION             /**< Links that are the argmax in either direction */
+} LimdyAlignMode;
+
+/**
+ * @brief Options for limdy_attention_align().
+ */
+typedef struct
+{
+    LimdyAlignMode mode; /**< Symmetrization strategy */
+    float threshold;     /**< Links scoring below this are dropped */
+} LimdyAlignOptions;
+
+/**
+ * @brief Instruction set used by the argmax kernels.
+ */
+typedef enum
+{
+    LIMDY_ATTENTION_KERNEL_AUTO,   /**< Best kernel supported by the running CPU */
+    LIMDY_ATTENTION_KERNEL_SCALAR, /**< Portable C */
+    LIMDY_ATTENTION_KERNEL_SSE2,   /**< x86 SSE2 */
+    LIMDY_ATTENTION_KERNEL_AVX2,   /**< x86 AVX2 */
+    LIMDY_ATTENTION_KERNEL_NEON    /**< ARM NEON */
+} LimdyAttentionKernel;
+
+/**
+ * @brief Default alignment options: grow-diag-final with no threshold.
+ */
+#define LIMDY_ALIGN_OPTIONS_DEFAULT ((LimdyAlignOptions){LIMDY_ALIGN_GROW_DIAG_FINAL, 0.0f})
+
+/**
+ * @brief Select the kernel used by subsequent calls.
+ *
+ * @param kernel The kernel to use, or LIMDY_ATTENTION_KERNEL_AUTO.
+ * @return ErrorCode indicating success, or LIMDY_ATTENTION_ERROR_UNSUPPORTED if the CPU lacks it.
+ */
+ErrorCode limdy_attention_set_kernel(LimdyAttentionKernel kernel);
+
+/**
+ * @brief Get the name of the kernel currently in use.
+ *
+ * @return A static string such as "avx2" or "scalar".
+ */
+const char *limdy_attention_kernel_name(void);
+
+/**
+ * @brief Find the highest-scoring column of every row.
+ *
+ * Ties resolve to the lowest column.
+ *
+ * @param matrix The attention matrix.
+ * @param index Array of matrix->rows entries to store column indexes.
+ * @param score Array of matrix->rows entries to store the maxima.
+ */
+void limdy_attention_row_argmax(const LimdyMatrix *matrix, uint32_t *index, float *score);
+
+/**
+ * @brief Find the highest-scoring row of every column.
+ *
+ * Ties resolve to the lowest row.
+ *
+ * @param matrix The attention matrix.
+ * @param index Array of matrix->stride entries to store row indexes.
+ * @param score Array of matrix->stride entries to store the maxima.
+ */
+void limdy_attention_col_argmax(const LimdyMatrix *matrix, uint32_t *index, float *score);
+
+/**
+ * @brief Get the number of links limdy_attention_align() can produce at most.
+ *
+ * @param rows Number of rows in the attention matrix.
+ * @param cols Number of columns in the attention matrix.
+ * @return The required capacity of the links array.
+ */
+size_t limdy_attention_align_capacity(size_t rows, size_t cols);
+
+/**
+ * @brief Align source and target tokens from an attention matrix.
+ *
+ * Links are ordered by source index, then target index.
+ *
+ * @param matrix The attention matrix.
+ * @param options Alignment options, or NULL for LIMDY_ALIGN_OPTIONS_DEFAULT.
+ * @param scratch Arena for temporary buffers; the caller resets it.
+ * @param links Array of at least limdy_attention_align_capacity() entries.
+ * @param link_count Pointer to store the number of links written.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_attention_align(const LimdyMatrix *matrix, const LimdyAlignOptions *options, LimdyArena *scratch,
+                                AlignmentLink *links, size_t *link_count);
+
+/**
+ * @brief Base error code for attention kernel errors.
+ */
+#define LIMDY_ATTENTION_ERROR_BASE (ERROR_CUSTOM_BASE + 170)
+
+/**
+ * @brief Error code for a kernel the running CPU does not support.
+ */
+#define LIMDY_ATTENTION_ERROR_UNSUPPORTED (LIMDY_ATTENTION_ERROR_BASE + 1)
+
+#endif // LIMDY_UTILS_ATTENTION_KERNEL_H
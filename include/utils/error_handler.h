@@ -6,6 +6,13 @@
  * It provides a centralized way to define error codes, log errors, and handle
  * them consistently across the application.
  *
+ * Logging an error does not format it. The format string and its packed
+ * arguments are kept and only rendered when someone reads them: the handler
+ * or stderr, error_get_last() or error_get_history(). The history is a
+ * lock-free ring, so threads logging at once never wait for each other.
+ * Output is rate limited per call site, so a burst of one error does not
+ * flood the handler.
+ *
  * @author Mirza Bicer
  * @date 2024-08-23
  */
@@ -16,6 +23,16 @@
 #include <stddef.h>
 #include <stdarg.h>
 
+/**
+ * @brief Number of errors kept in the history; a power of two.
+ */
+#define LIMDY_ERROR_HISTORY_SIZE 128
+
+/**
+ * @brief Default number of errors per call site per second passed to the handler.
+ */
+#define LIMDY_ERROR_RATE_LIMIT_DEFAULT 10
+
 /**
  * @brief Enumeration of error severity levels.
  */
@@ -70,6 +87,16 @@ typedef struct
     char message[256];    /**< The error message */
 } ErrorContext;
 
+/**
+ * @brief Counters of the error handling system.
+ */
+typedef struct
+{
+    size_t logged;     /**< Errors logged at or above the minimum level */
+    size_t suppressed; /**< Errors kept from the handler by rate limiting */
+    size_t dropped;    /**< Errors lost to the history because its ring was lapped mid-write */
+} ErrorStats;
+
 /**
  * @brief Function pointer type for custom error handlers.
  */
@@ -103,9 +130,23 @@ void error_set_handler(ErrorHandler handler);
  */
 void error_set_min_level(ErrorLevel level);
 
+/**
+ * @brief Set how many errors per call site per second reach the handler.
+ *
+ * Suppressed errors still become the last error and enter the history; the
+ * first error passed on after a suppressed run says how many were dropped.
+ *
+ * @param per_second Errors per call site per second, or 0 for no limit.
+ */
+void error_set_rate_limit(unsigned per_second);
+
 /**
  * @brief Log an error.
  *
+ * Arguments are packed by the conversions of @p format and rendered when
+ * the error is read, so strings are copied but pointed-to data is not.
+ * Formats with more conversions than can be packed are formatted at once.
+ *
  * @param code The error code.
  * @param level The error severity level.
  * @param file The file where the error occurred.
@@ -119,6 +160,9 @@ void error_log(ErrorCode code, ErrorLevel level, const char *file, int line, con
 /**
  * @brief Get the last error context.
  *
+ * The message of the calling thread's last error is formatted on the first
+ * call after it was logged.
+ *
  * @return Pointer to the last error context.
  */
 const ErrorContext *error_get_last(void);
@@ -128,6 +172,24 @@ const ErrorContext *error_get_last(void);
  */
 void error_clear(void);
 
+/**
+ * @brief Copy out the most recent errors of all threads, oldest first.
+ *
+ * Errors being overwritten while they are read are skipped.
+ *
+ * @param contexts Array to fill with formatted errors.
+ * @param capacity Number of entries in @p contexts.
+ * @return Number of errors copied, at most LIMDY_ERROR_HISTORY_SIZE.
+ */
+size_t error_get_history(ErrorContext *contexts, size_t capacity);
+
+/**
+ * @brief Get the counters of the error handling system.
+ *
+ * @param stats Pointer to store the counters.
+ */
+void error_get_stats(ErrorStats *stats);
+
 /**
  * @brief Convenience macro for logging debug messages.
  */
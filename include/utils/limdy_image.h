@@ -0,0 +1,184 @@
+/**
+ * @file limdy_image.h
+ * @brief Read-only binary images shared by the bank and snapshot formats.
+ *
+ * An image is one file: a fixed header followed by sections at aligned
+ * offsets. Every header starts with a LimdyImageHeader, whose checksum
+ * covers the rest of the header, so the section offsets and counts are
+ * trusted once the header checks out. Images are written to a temporary
+ * file that is renamed over the old one, so readers never see a partial
+ * image, and they are read by mapping the whole file read-only.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-15
+ */
+
+#ifndef LIMDY_UTILS_IMAGE_H
+#define LIMDY_UTILS_IMAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "error_handler.h"
+
+/**
+ * @brief Size of the magic string at the start of every image.
+ */
+#define LIMDY_IMAGE_MAGIC_SIZE 8
+
+/**
+ * @brief Alignment in bytes of every section offset.
+ */
+#define LIMDY_IMAGE_SECTION_ALIGNMENT 8
+
+/**
+ * @brief Smallest capacity of a hash index section.
+ */
+#define LIMDY_IMAGE_MIN_INDEX_CAPACITY 16
+
+/**
+ * @brief Fields every image header starts with.
+ */
+typedef struct
+{
+    char magic[LIMDY_IMAGE_MAGIC_SIZE]; /**< Format magic, not NUL terminated */
+    uint32_t version;                   /**< Format version */
+    uint32_t header_size;               /**< Size of the full header */
+    uint32_t checksum;                  /**< FNV-1a of the rest of the header, from file_size on */
+    uint32_t reserved;                  /**< Zero */
+    uint64_t file_size;                 /**< Size of the whole file */
+} LimdyImageHeader;
+
+/**
+ * @brief Description of one image format.
+ */
+typedef struct
+{
+    const char *name;           /**< What the image is called in log messages */
+    const char *magic;          /**< LIMDY_IMAGE_MAGIC_SIZE bytes of magic */
+    uint32_t version;           /**< Current format version */
+    size_t header_size;         /**< Size of the full header, which starts with a LimdyImageHeader */
+    ErrorCode error_bad_format; /**< Returned for a damaged or foreign file */
+    ErrorCode error_version;    /**< Returned for a file of another version */
+    /**
+     * Checks the format's own header fields once the common ones are valid,
+     * typically with limdy_image_section_fits().
+     */
+    bool (*header_valid)(const void *header);
+} LimdyImageFormat;
+
+/**
+ * @brief One section to write, at an offset from limdy_image_align().
+ */
+typedef struct
+{
+    uint64_t offset;  /**< Offset of the section in the file */
+    const void *data; /**< Section contents, or NULL if size is 0 */
+    size_t size;      /**< Size of the section in bytes */
+} LimdyImageSection;
+
+/**
+ * @brief Slot of a hash index section, an open-addressing table with linear probing.
+ */
+typedef struct
+{
+    uint64_t hash;   /**< Hash of the record */
+    uint64_t record; /**< Record position + 1, or 0 for an empty slot */
+} LimdyImageIndexEntry;
+
+/**
+ * @brief A mapped image.
+ */
+typedef struct
+{
+    void *mapping; /**< Start of the file; the header */
+    size_t size;   /**< Size of the mapping */
+} LimdyImage;
+
+/**
+ * @brief Round an offset up to the next section boundary.
+ *
+ * @param offset The offset.
+ * @return The aligned offset.
+ */
+size_t limdy_image_align(size_t offset);
+
+/**
+ * @brief Check that a section of a validated header lies within the file.
+ *
+ * @param header The header.
+ * @param offset Offset of the section.
+ * @param count Number of records in the section.
+ * @param size Size of one record.
+ * @return True if the section is aligned, after the header and within the file.
+ */
+bool limdy_image_section_fits(const LimdyImageHeader *header, uint64_t offset, uint64_t count, size_t size);
+
+/**
+ * @brief Check that a hash index section of a validated header is well formed.
+ *
+ * @param header The header.
+ * @param offset Offset of the index.
+ * @param capacity Number of slots; a power of two.
+ * @param count Number of records indexed, less than the capacity.
+ * @return True if the index fits in the file and leaves a free slot.
+ */
+bool limdy_image_index_fits(const LimdyImageHeader *header, uint64_t offset, uint64_t capacity, uint64_t count);
+
+/**
+ * @brief Lay out the hash index of records that each start with their 64-bit hash.
+ *
+ * The capacity is a power of two of more than twice the count. Records are
+ * placed in order, so of equal hashes the first added is probed first.
+ *
+ * @param records The records.
+ * @param count Number of records.
+ * @param record_size Size of one record.
+ * @param capacity Pointer to store the capacity.
+ * @return The index, to be freed with limdy_memory_pool_free(), or NULL on failure.
+ */
+LimdyImageIndexEntry *limdy_image_build_index(const void *records, size_t count, size_t record_size, size_t *capacity);
+
+/**
+ * @brief Write an image, replacing any file at the path.
+ *
+ * Fills in the common header fields, with the file ending where the last
+ * section ends, then writes the header and the sections in order.
+ *
+ * @param format The image format.
+ * @param path Path of the image file.
+ * @param header The full header, with the format's own fields set.
+ * @param sections Sections in increasing offset order.
+ * @param section_count Number of sections.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_image_write(const LimdyImageFormat *format, const char *path, LimdyImageHeader *header,
+                            const LimdyImageSection *sections, size_t section_count);
+
+/**
+ * @brief Map an image for reading and validate its header.
+ *
+ * @param format The image format.
+ * @param path Path of the image file.
+ * @param image The image to fill.
+ * @return ErrorCode indicating success or failure; the format's error codes for a bad file.
+ */
+ErrorCode limdy_image_map(const LimdyImageFormat *format, const char *path, LimdyImage *image);
+
+/**
+ * @brief Unmap an image.
+ *
+ * @param image The image, or NULL.
+ */
+void limdy_image_unmap(LimdyImage *image);
+
+/**
+ * @brief Advise the kernel that part of a mapped image is about to be read.
+ *
+ * @param image The image.
+ * @param offset Offset of the range.
+ * @param size Size of the range in bytes.
+ */
+void limdy_image_will_need(const LimdyImage *image, uint64_t offset, size_t size);
+
+#endif // LIMDY_UTILS_IMAGE_H
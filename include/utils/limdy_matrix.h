@@ -0,0 +1,130 @@
+/**
+ * @file limdy_matrix.h
+ * @brief Dense row-major float matrix for attention scores.
+ *
+ * A LimdyMatrix keeps all of its rows in one 64-byte aligned buffer. Each
+ * row starts on a 64-byte boundary (the stride is rounded up to a whole cache
+ * line), so kernels can stream through a row with aligned vector loads and
+ * never chase per-row pointers. Adapters convert to and from the older
+ * float ** (array of row pointers) shape.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#ifndef LIMDY_UTILS_MATRIX_H
+#define LIMDY_UTILS_MATRIX_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "error_handler.h"
+#include "limdy_alignment.h"
+
+/**
+ * @brief Alignment in bytes of matrix storage and of every row.
+ */
+#define LIMDY_MATRIX_ALIGNMENT 64
+
+/**
+ * @brief Structure representing a dense row-major matrix.
+ */
+typedef struct
+{
+    float *data;   /**< First element; LIMDY_MATRIX_ALIGNMENT aligned */
+    size_t rows;   /**< Number of rows */
+    size_t cols;   /**< Number of meaningful columns per row */
+    size_t stride; /**< Distance between rows in floats (>= cols) */
+    bool owned;    /**< Whether limdy_matrix_free releases data */
+} LimdyMatrix;
+
+/**
+ * @brief Get the row stride, in floats, used for a given column count.
+ *
+ * @param cols Number of columns.
+ * @return The stride in floats.
+ */
+size_t limdy_matrix_stride(size_t cols);
+
+/**
+ * @brief Get the number of bytes of storage a matrix needs.
+ *
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @return Size in bytes for limdy_matrix_wrap().
+ */
+size_t limdy_matrix_bytes(size_t rows, size_t cols);
+
+/**
+ * @brief Allocate a zeroed matrix that owns its storage.
+ *
+ * @param matrix The matrix to initialize.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_matrix_init(LimdyMatrix *matrix, size_t rows, size_t cols);
+
+/**
+ * @brief Initialize a matrix over caller-provided storage.
+ *
+ * @param matrix The matrix to initialize.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @param storage At least limdy_matrix_bytes(rows, cols) bytes, LIMDY_MATRIX_ALIGNMENT aligned.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_matrix_wrap(LimdyMatrix *matrix, size_t rows, size_t cols, void *storage);
+
+/**
+ * @brief Free a matrix's storage if it owns it and clear the matrix.
+ *
+ * @param matrix The matrix to free.
+ */
+void limdy_matrix_free(LimdyMatrix *matrix);
+
+/**
+ * @brief Get a pointer to the start of a row.
+ *
+ * @param matrix The matrix.
+ * @param row Row index.
+ * @return Pointer to the first element of the row.
+ */
+static inline float *limdy_matrix_row(const LimdyMatrix *matrix, size_t row)
+{
+    return matrix->data + row * matrix->stride;
+}
+
+/**
+ * @brief Copy a float ** matrix into a dense matrix of the same shape.
+ *
+ * @param matrix The destination, already sized to rows x cols.
+ * @param rows_in Array of matrix->rows row pointers, each with matrix->cols floats.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_matrix_copy_from_rows(LimdyMatrix *matrix, float *const *rows_in);
+
+/**
+ * @brief Expose a dense matrix in the float ** shape without copying.
+ *
+ * @param matrix The matrix to view.
+ * @param row_pointers Array of at least matrix->rows entries to fill.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_matrix_row_pointers(const LimdyMatrix *matrix, float **row_pointers);
+
+/**
+ * @brief Base error code for matrix errors.
+ */
+#define LIMDY_MATRIX_ERROR_BASE (ERROR_CUSTOM_BASE + 160)
+
+/**
+ * @brief Error code for matrix storage allocation failure.
+ */
+#define LIMDY_MATRIX_ERROR_ALLOC_FAILED (LIMDY_MATRIX_ERROR_BASE + 1)
+
+/**
+ * @brief Error code for storage that is not suitably aligned.
+ */
+#define LIMDY_MATRIX_ERROR_MISALIGNED (LIMDY_MATRIX_ERROR_BASE + 2)
+
+#endif // LIMDY_UTILS_MATRIX_H
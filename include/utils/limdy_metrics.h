@@ -0,0 +1,224 @@
+/**
+ * @file limdy_metrics.h
+ * @brief Hot-path counters, histograms and span tracing for the Limdy project.
+ *
+ * Every metric is a fixed entry of LimdyCounter or LimdyHistogram. Each
+ * thread updates its own copy without atomic read-modify-writes or locks,
+ * and limdy_metrics_snapshot() merges the copies of all threads when read.
+ * Histograms have one bucket per power of two, so recording is a count
+ * leading zeros and three stores.
+ *
+ * Spans are recorded only while tracing is on: every timed stage becomes a
+ * span named after its histogram, and LIMDY_TRACE_BEGIN()/LIMDY_TRACE_END()
+ * mark others. Each thread keeps its last LIMDY_TRACE_EVENTS_PER_THREAD
+ * spans, which limdy_trace_write_chrome_json() exports in the Chrome trace
+ * event format (chrome://tracing, Perfetto).
+ *
+ * All of it is compiled in only when LIMDY_METRICS is defined. Otherwise the
+ * macros expand to nothing and the functions to empty inline stubs, so
+ * instrumented code carries no cost.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#ifndef LIMDY_UTILS_METRICS_H
+#define LIMDY_UTILS_METRICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "error_handler.h"
+
+/**
+ * @brief Allocation size classes: class c holds sizes up to 16 << c bytes, the last one everything larger.
+ */
+#define LIMDY_METRICS_SIZE_CLASSES 16
+
+/**
+ * @brief Buckets per histogram; bucket b holds values of bit length b.
+ */
+#define LIMDY_METRICS_HISTOGRAM_BUCKETS 65
+
+/**
+ * @brief Spans kept per thread; older ones are overwritten.
+ */
+#define LIMDY_TRACE_EVENTS_PER_THREAD 4096
+
+/**
+ * @brief Counters. Per-size-class counters take LIMDY_METRICS_SIZE_CLASSES consecutive entries.
+ */
+typedef enum
+{
+    LIMDY_COUNTER_ALLOCATIONS = 0,                                                  /**< Pool allocations, + size class */
+    LIMDY_COUNTER_ALLOCATION_FAILURES = LIMDY_METRICS_SIZE_CLASSES,                 /**< Failed pool allocations, + size class */
+    LIMDY_COUNTER_FREES = LIMDY_COUNTER_ALLOCATION_FAILURES + LIMDY_METRICS_SIZE_CLASSES, /**< Pool frees */
+    LIMDY_COUNTER_POOL_FRAGMENTED_FAILURES, /**< Pool allocations that failed with enough bytes free, but not in one block */
+    LIMDY_COUNTER_RENDER_CACHE_HITS,        /**< Tokenization cache hits */
+    LIMDY_COUNTER_RENDER_CACHE_MISSES,      /**< Tokenization cache misses */
+    LIMDY_COUNTER_RENDER_CACHE_EVICTIONS,   /**< Tokenization cache evictions */
+    LIMDY_COUNTER_COUNT
+} LimdyCounter;
+
+/**
+ * @brief Histograms. Latencies are in nanoseconds.
+ */
+typedef enum
+{
+    LIMDY_HISTOGRAM_ALLOCATION_NS = 0,                           /**< Pool allocation latency, + size class */
+    LIMDY_HISTOGRAM_MAP_PROBE_GROUPS = LIMDY_METRICS_SIZE_CLASSES, /**< Control groups visited per map probe */
+    LIMDY_HISTOGRAM_TOKENIZE_NS,                                 /**< renderer_tokenize() */
+    LIMDY_HISTOGRAM_CLASSIFY_NS,                                 /**< renderer_classify() */
+    LIMDY_HISTOGRAM_EXTRACT_NS,                                  /**< renderer_extract_elements() */
+    LIMDY_HISTOGRAM_TRANSLATE_NS,                                /**< Translation service calls */
+    LIMDY_HISTOGRAM_ALIGN_NS,                                    /**< Alignment of one text */
+    LIMDY_HISTOGRAM_STARTUP_COLD_NS,                             /**< Worker startup without a snapshot */
+    LIMDY_HISTOGRAM_STARTUP_WARM_NS,                             /**< Worker startup from a snapshot */
+    LIMDY_HISTOGRAM_COUNT
+} LimdyHistogram;
+
+/**
+ * @brief A histogram merged over all threads.
+ */
+typedef struct
+{
+    uint64_t count;                                    /**< Values recorded */
+    uint64_t sum;                                      /**< Sum of the values */
+    uint64_t max;                                      /**< Largest value */
+    uint64_t buckets[LIMDY_METRICS_HISTOGRAM_BUCKETS]; /**< Values per bit length */
+} LimdyHistogramSnapshot;
+
+/**
+ * @brief Every metric merged over all threads.
+ */
+typedef struct
+{
+    uint64_t counters[LIMDY_COUNTER_COUNT];
+    LimdyHistogramSnapshot histograms[LIMDY_HISTOGRAM_COUNT];
+} LimdyMetricsSnapshot;
+
+/**
+ * @brief Size class of an allocation of @p size bytes.
+ */
+static inline size_t limdy_metrics_size_class(size_t size)
+{
+    size_t size_class = 0;
+    while (size > ((size_t)16 << size_class) && size_class < LIMDY_METRICS_SIZE_CLASSES - 1)
+    {
+        size_class++;
+    }
+    return size_class;
+}
+
+#ifdef LIMDY_METRICS
+
+/**
+ * @brief Monotonic time in nanoseconds.
+ */
+uint64_t limdy_metrics_now_ns(void);
+
+/**
+ * @brief Add to a counter of the calling thread.
+ */
+void limdy_metrics_count(LimdyCounter counter, uint64_t delta);
+
+/**
+ * @brief Record a value in a histogram of the calling thread.
+ */
+void limdy_metrics_record(LimdyHistogram histogram, uint64_t value);
+
+/**
+ * @brief Record the time since @p start_ns in a histogram, and as a span while tracing.
+ */
+void limdy_metrics_record_since(LimdyHistogram histogram, uint64_t start_ns);
+
+/**
+ * @brief Merge the metrics of all threads, including threads that have exited.
+ *
+ * @param snapshot Pointer to store the merged metrics.
+ */
+void limdy_metrics_snapshot(LimdyMetricsSnapshot *snapshot);
+
+/**
+ * @brief Zero every metric. Updates made meanwhile by other threads may survive.
+ */
+void limdy_metrics_reset(void);
+
+/**
+ * @brief Start or stop recording spans.
+ */
+void limdy_trace_enable(bool enabled);
+
+/**
+ * @brief Start a span; returns 0 without reading the clock while tracing is off.
+ */
+uint64_t limdy_trace_begin(void);
+
+/**
+ * @brief End a span started by limdy_trace_begin().
+ *
+ * @param name Name of the span; must outlive the trace, such as a string literal.
+ * @param start_ns The value limdy_trace_begin() returned.
+ */
+void limdy_trace_end(const char *name, uint64_t start_ns);
+
+/**
+ * @brief Write the recorded spans of all threads as Chrome trace JSON.
+ *
+ * Call while traced threads are quiet; spans recorded meanwhile may be missed.
+ *
+ * @param path File to write.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_trace_write_chrome_json(const char *path);
+
+#define LIMDY_METRIC_COUNT(counter, delta) limdy_metrics_count((counter), (delta))
+#define LIMDY_METRIC_RECORD(histogram, value) limdy_metrics_record((histogram), (value))
+#define LIMDY_METRIC_TIME_BEGIN(var) uint64_t var = limdy_metrics_now_ns()
+#define LIMDY_METRIC_TIME_END(var, histogram) limdy_metrics_record_since((histogram), (var))
+#define LIMDY_TRACE_BEGIN(var) uint64_t var = limdy_trace_begin()
+#define LIMDY_TRACE_END(var, name) limdy_trace_end((name), (var))
+
+#else
+
+static inline uint64_t limdy_metrics_now_ns(void) { return 0; }
+static inline void limdy_metrics_count(LimdyCounter counter, uint64_t delta) { (void)counter, (void)delta; }
+static inline void limdy_metrics_record(LimdyHistogram histogram, uint64_t value) { (void)histogram, (void)value; }
+static inline void limdy_metrics_record_since(LimdyHistogram histogram, uint64_t start_ns) { (void)histogram, (void)start_ns; }
+static inline void limdy_metrics_snapshot(LimdyMetricsSnapshot *snapshot) { memset(snapshot, 0, sizeof(*snapshot)); }
+static inline void limdy_metrics_reset(void) {}
+static inline void limdy_trace_enable(bool enabled) { (void)enabled; }
+static inline uint64_t limdy_trace_begin(void) { return 0; }
+static inline void limdy_trace_end(const char *name, uint64_t start_ns) { (void)name, (void)start_ns; }
+static inline ErrorCode limdy_trace_write_chrome_json(const char *path) { (void)path; return ERROR_SUCCESS; }
+
+#define LIMDY_METRIC_COUNT(counter, delta) ((void)0)
+#define LIMDY_METRIC_RECORD(histogram, value) ((void)0)
+#define LIMDY_METRIC_TIME_BEGIN(var) ((void)0)
+#define LIMDY_METRIC_TIME_END(var, histogram) ((void)0)
+#define LIMDY_TRACE_BEGIN(var) ((void)0)
+#define LIMDY_TRACE_END(var, name) ((void)0)
+
+#endif // LIMDY_METRICS
+
+/**
+ * @brief Name of a counter, such as "allocations.64".
+ */
+const char *limdy_counter_name(LimdyCounter counter);
+
+/**
+ * @brief Name of a histogram, such as "stage.tokenize_ns".
+ */
+const char *limdy_histogram_name(LimdyHistogram histogram);
+
+/**
+ * @brief Estimate a percentile of a histogram from its buckets.
+ *
+ * @param histogram The merged histogram.
+ * @param percentile Between 0 and 100.
+ * @return Upper bound of the bucket holding the percentile, capped at the maximum; 0 if empty.
+ */
+uint64_t limdy_histogram_percentile(const LimdyHistogramSnapshot *histogram, double percentile);
+
+#endif // LIMDY_UTILS_METRICS_H
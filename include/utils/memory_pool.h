@@ -21,9 +21,10 @@
 #include <stdbool.h>
 #include <pthread.h>
 #include "utils/error_handler.h"
+#include "utils/rbtree/rbtree.h"
 
 #define ALIGN_SIZE(size, align) (((size) + (align) - 1) & ~((align) - 1))
-#define MIN_BLOCK_SIZE (sizeof(struct MemoryBlock))
+#define MIN_BLOCK_SIZE (sizeof(struct MemoryBlock) + LIMDY_MEMORY_ALIGNMENT) // Header plus room for the free-list links
 #define MEMORY_BLOCK_MAGIC 0xDEADBEEF
 
 /**
@@ -71,6 +72,79 @@
  */
 #define LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB 64
 
+/**
+ * @brief Size and alignment of a slab span (64KB).
+ *
+ * Slab objects are carved out of spans of this size, which lets the owner of
+ * a slab pointer be found from its address alone.
+ */
+#define LIMDY_SLAB_SPAN_SIZE (64 * 1024)
+
+/**
+ * @brief Maximum number of objects a thread can cache per slab size class.
+ */
+#define LIMDY_THREAD_CACHE_CAPACITY 64
+
+/**
+ * @brief Number of objects moved between a thread cache and the shared slab allocator at once.
+ */
+#define LIMDY_THREAD_CACHE_BATCH 32
+
+/**
+ * @brief Number of first-level (power-of-two) free-list bins in a pool.
+ */
+#define LIMDY_POOL_FL_COUNT 32
+
+/**
+ * @brief log2 of the number of second-level bins each power-of-two range is split into.
+ */
+#define LIMDY_POOL_SL_BITS 3
+
+/**
+ * @brief Number of second-level free-list bins per first-level bin.
+ */
+#define LIMDY_POOL_SL_COUNT (1 << LIMDY_POOL_SL_BITS)
+
+/**
+ * @brief Default resident-to-used ratio above which a pool releases its free pages.
+ *
+ * 0 leaves trimming off: each check costs a mincore pass over the whole pool,
+ * so only pools that call limdy_memory_pool_set_trim_ratio() pay for it.
+ */
+#define LIMDY_POOL_TRIM_RATIO_DEFAULT 0.0
+
+/**
+ * @brief Capacity limdy_memory_pool_reserve() gives an empty array.
+ */
+#define LIMDY_POOL_RESERVE_MIN_CAPACITY 16
+
+/**
+ * @brief Number of frees to a pool between checks of its trim ratio.
+ */
+#define LIMDY_POOL_TRIM_INTERVAL 16384
+
+/**
+ * @brief Size of a huge page (2MB); huge-page pools are rounded up to a multiple of it.
+ */
+#define LIMDY_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+/**
+ * @brief Highest number of NUMA nodes that get a pool set of their own.
+ *
+ * Threads on nodes beyond it use the pool set created by limdy_memory_pool_init.
+ */
+#define LIMDY_MAX_NUMA_NODES 8
+
+/**
+ * @brief Pages backing the memory of a pool.
+ */
+typedef enum
+{
+    LIMDY_POOL_PAGES_DEFAULT = 0,      /**< Ordinary pages */
+    LIMDY_POOL_PAGES_TRANSPARENT_HUGE, /**< Aligned to huge pages and advised for transparent huge pages */
+    LIMDY_POOL_PAGES_EXPLICIT_HUGE     /**< Reserved huge pages (hugetlbfs), transparent ones if none are free */
+} LimdyPoolPageMode;
+
 /**
  * @brief Opaque structure representing a memory pool.
  */
@@ -84,23 +158,55 @@ typedef struct
     size_t small_block_size;      /**< Size of small memory blocks */
     size_t small_pool_size;       /**< Size of small memory pools */
     size_t large_pool_size;       /**< Size of the large memory pool */
-    size_t max_pools;             /**< Maximum number of memory pools */
+    size_t max_pools;             /**< Number of shared small pools serving limdy_memory_pool_alloc */
     size_t slab_objects_per_slab; /**< Number of objects per slab */
+    LimdyPoolPageMode page_mode;  /**< Pages backing every pool */
+    bool numa_local;              /**< Bind pools to the NUMA node of the creating thread, one pool set per node */
 } LimdyMemoryPoolConfig;
 
+/**
+ * @brief Fragmentation and residency of a single memory pool.
+ */
 typedef struct
 {
-    void *slabs[LIMDY_SLAB_SIZES];
-    size_t slab_sizes[LIMDY_SLAB_SIZES];
-    size_t free_objects[LIMDY_SLAB_SIZES];
+    size_t total_size;         /**< Capacity of the pool */
+    size_t used_size;          /**< Bytes taken by allocated blocks, headers included */
+    size_t free_size;          /**< Bytes available in free blocks */
+    size_t free_blocks;        /**< Number of free blocks */
+    size_t largest_free_block; /**< Largest single allocation that can succeed */
+    size_t resident_size;      /**< Bytes of the pool backed by physical memory */
+    double fragmentation;      /**< 1 - largest_free_block / free_size; 0 when free space is one block */
+    double resident_ratio;     /**< resident_size / used_size (at least one page); 1 is ideal */
+} LimdyMemoryPoolFragmentation;
+
+/**
+ * @brief Shared slab allocator backing the per-thread caches.
+ *
+ * Threads only take the mutex when their cache for a size class runs empty
+ * or overflows, and then move LIMDY_THREAD_CACHE_BATCH objects at once.
+ */
+typedef struct
+{
+    void *slabs[LIMDY_SLAB_SIZES];        /**< Free list head per size class */
+    size_t slab_sizes[LIMDY_SLAB_SIZES];   /**< Object size per size class */
+    size_t free_objects[LIMDY_SLAB_SIZES]; /**< Free objects on each shared free list */
+    void **spans;                          /**< Every span handed out, for cleanup */
+    size_t span_count;                     /**< Number of spans in use */
+    size_t span_capacity;                  /**< Capacity of the spans array */
     pthread_mutex_t mutex;
 } LimdySlabAllocator;
 
+/**
+ * @brief Header in front of every block in a pool.
+ *
+ * next/prev link all blocks in address order. While a block is free, the
+ * first two words of its data hold its links within its size-class bin.
+ */
 struct MemoryBlock
 {
     uint32_t magic;
+    uint32_t in_use;
     size_t size;
-    size_t in_use;
     struct MemoryBlock *next;
     struct MemoryBlock *prev;
     uintptr_t data[];
@@ -109,26 +215,36 @@ struct MemoryBlock
 struct LimdyMemoryPool
 {
     void *memory;
-    struct MemoryBlock *free_list;
+    struct MemoryBlock *free_list; // First block in address order
     size_t total_size;
     size_t used_size;
+    uint32_t fl_bitmap;                      // First-level bins with at least one free block
+    uint32_t sl_bitmap[LIMDY_POOL_FL_COUNT]; // Non-empty second-level bins per first level
+    struct MemoryBlock *bins[LIMDY_POOL_FL_COUNT][LIMDY_POOL_SL_COUNT];
+    double trim_ratio;       // Resident-to-used ratio that triggers a trim, or 0 for never
+    size_t frees_until_trim; // Frees left before the trim ratio is checked
+    size_t page_size;        // Granule free pages are released in
+    size_t mapped_size;      // Bytes mapped for memory, or 0 if it came from the aligned allocator
+    int numa_node;           // Node the memory is bound to, or -1
     pthread_mutex_t mutex;
     pthread_rwlock_t rwlock; // For read-heavy operations
+    struct LimdyMemoryPool *next_created; // Links for pools from limdy_memory_pool_create
+    struct LimdyMemoryPool *prev_created;
+    LimdyRBNode size_node;    // Link in the size index of its pool set
+    LimdyRBNode address_node; // Link in the address index of every pool
 };
 
-static LimdyMemoryPool *small_pools[LIMDY_MAX_POOLS];
-static LimdyMemoryPool *large_pool;
-static size_t num_small_pools = 0;
-static pthread_mutex_t global_mutex = PTHREAD_MUTEX_INITIALIZER;
-static LimdyMemoryPoolConfig global_config;
-static LimdyRBTree pool_rbtree;
-
 /**
  * @brief Initialize the memory pool system.
  *
  * This function must be called before any other memory pool functions.
  * It sets up the global memory pool system based on the provided configuration.
  *
+ * With numa_local set, the shared pools are created on the node of the calling
+ * thread, and the first allocation from a thread on another node creates a
+ * pool set for that node. Huge pages and NUMA binding are only available on
+ * Linux; elsewhere pools fall back to ordinary memory.
+ *
  * @param config Pointer to the configuration structure.
  * @return ErrorCode indicating success or failure.
  */
@@ -138,7 +254,8 @@ ErrorCode limdy_memory_pool_init(const LimdyMemoryPoolConfig *config);
  * @brief Clean up the memory pool system.
  *
  * This function should be called when the memory pool system is no longer needed.
- * It frees all allocated memory and destroys all pools.
+ * It frees all allocated memory and destroys all pools. Other threads must have
+ * stopped using the pool system; their slab caches are invalidated and dropped.
  */
 void limdy_memory_pool_cleanup(void);
 
@@ -146,6 +263,7 @@ void limdy_memory_pool_cleanup(void);
  * @brief Allocate memory from the pool.
  *
  * This function allocates memory from the appropriate pool or slab based on the requested size.
+ * Small sizes are served from a per-thread cache without taking any lock in the common case.
  *
  * @param size The number of bytes to allocate.
  * @return A pointer to the allocated memory, or NULL if allocation fails.
@@ -174,6 +292,21 @@ void limdy_memory_pool_free(void *ptr);
  */
 void *limdy_memory_pool_realloc(void *ptr, size_t new_size);
 
+/**
+ * @brief Grow an array allocated from the pool to hold at least needed items.
+ *
+ * The capacity doubles, starting from LIMDY_POOL_RESERVE_MIN_CAPACITY, until
+ * it covers needed, so filling an array one item at a time costs amortized
+ * O(1) per item. On failure the array and its capacity are left as they were.
+ *
+ * @param array Pointer to the array, which may hold NULL for an empty one.
+ * @param capacity Pointer to the number of items the array has room for.
+ * @param needed The number of items the array must have room for.
+ * @param item_size The size of one item.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_memory_pool_reserve(void **array, size_t *capacity, size_t needed, size_t item_size);
+
 /**
  * @brief Get current memory usage statistics.
  *
@@ -187,7 +320,11 @@ void limdy_memory_pool_get_stats(size_t *total_allocated, size_t *total_used);
 /**
  * @brief Create a new memory pool.
  *
- * This function creates a new memory pool with the specified size.
+ * This function creates a new memory pool with the specified size. The pool
+ * belongs to the caller: it is never used to serve limdy_memory_pool_alloc,
+ * and pointers from it can still be released with limdy_memory_pool_free.
+ * The number of such pools is not limited by max_pools. It is backed by the
+ * configured pages and, with numa_local, bound to the calling thread's node.
  *
  * @param pool_size The size of the new pool to create.
  * @param new_pool Pointer to store the newly created pool.
@@ -198,13 +335,62 @@ ErrorCode limdy_memory_pool_create(size_t pool_size, LimdyMemoryPool **new_pool)
 /**
  * @brief Defragment a memory pool.
  *
- * This function attempts to reduce fragmentation in the specified memory pool.
+ * Coalesces any adjacent free blocks and returns the pages inside free
+ * blocks to the operating system with madvise(MADV_DONTNEED), so the pool's
+ * resident size follows its live data. Released pages read back as zeros
+ * when reused.
  *
  * @param pool Pointer to the pool to defragment.
  * @return ErrorCode indicating success or failure.
  */
 ErrorCode limdy_memory_pool_defragment(LimdyMemoryPool *pool);
 
+/**
+ * @brief Set when frees to a pool defragment it automatically.
+ *
+ * Every LIMDY_POOL_TRIM_INTERVAL frees, a pool whose resident_ratio exceeds
+ * @p ratio is defragmented. Pools start with LIMDY_POOL_TRIM_RATIO_DEFAULT,
+ * which leaves this off.
+ *
+ * @param pool Pointer to the pool to configure.
+ * @param ratio Resident-to-used ratio that triggers defragmentation, or 0 to
+ *              only defragment on demand.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_memory_pool_set_trim_ratio(LimdyMemoryPool *pool, double ratio);
+
+/**
+ * @brief Get the fragmentation and resident size of a single memory pool.
+ *
+ * Walks every block of the pool and queries residency with mincore(), so it
+ * is meant for monitoring rather than hot paths.
+ *
+ * @param pool Pointer to the pool to query.
+ * @param stats Pointer to store the statistics.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_memory_pool_get_fragmentation(LimdyMemoryPool *pool, LimdyMemoryPoolFragmentation *stats);
+
+/**
+ * @brief Reset a memory pool to a single free block.
+ *
+ * Every allocation made from the pool becomes invalid. This lets a caller
+ * reuse a pool without destroying and recreating it.
+ *
+ * @param pool Pointer to the pool to reset.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_memory_pool_reset(LimdyMemoryPool *pool);
+
+/**
+ * @brief Get the size and usage of a single memory pool.
+ *
+ * @param pool Pointer to the pool to query.
+ * @param total_size Pointer to store the pool's capacity in bytes.
+ * @param used_size Pointer to store the number of bytes currently allocated.
+ */
+void limdy_memory_pool_get_pool_stats(LimdyMemoryPool *pool, size_t *total_size, size_t *used_size);
+
 /**
  * @brief Destroy a memory pool.
  *
@@ -258,6 +444,18 @@ void limdy_memory_pool_free_to(LimdyMemoryPool *pool, void *ptr);
  */
 bool limdy_memory_pool_contains(const LimdyMemoryPool *pool, const void *ptr);
 
+/**
+ * @brief Find the memory pool holding a pointer.
+ *
+ * Looks the pointer up in an address index of every pool, shared or created
+ * with limdy_memory_pool_create, in O(log n) of the number of pools. Slab
+ * objects belong to no pool.
+ *
+ * @param ptr Pointer to look up.
+ * @return The pool holding the pointer, or NULL if there is none.
+ */
+LimdyMemoryPool *limdy_memory_pool_owner(const void *ptr);
+
 /**
  * @brief Base error code for memory pool errors.
  */
@@ -1,9 +1,10 @@
 /**
  * @file rbtree.c
- * @brief Implementation of Red-Black Tree for memory pool management.
+ * @brief Implementation of the intrusive Red-Black Tree.
  *
  * This file contains the implementation of the Red-Black Tree data structure
  * used to efficiently manage and search memory pools in the Limdy project.
+ * It never allocates: every node is embedded in the structure it indexes.
  *
  * @author Mirza Bicer
  * @date 2024-08-24
@@ -13,19 +14,6 @@
 #include "limdy_utils.h"
 #include <stdlib.h>
 
-static LimdyRBNode *create_node(LimdyMemoryPool *pool)
-{
-    LimdyRBNode *node = (LimdyRBNode *)limdy_memory_pool_alloc(sizeof(LimdyRBNode));
-    if (node == NULL)
-    {
-        return NULL;
-    }
-    node->pool = pool;
-    node->color = LIMDY_RB_RED;
-    node->parent = node->left = node->right = NULL;
-    return node;
-}
-
 static void left_rotate(LimdyRBTree *tree, LimdyRBNode *x)
 {
     LimdyRBNode *y = x->right;
@@ -157,6 +145,21 @@ static LimdyRBNode *tree_minimum(LimdyRBNode *node)
     return node;
 }
 
+static LimdyRBNode *tree_successor(LimdyRBNode *node)
+{
+    if (node->right != NULL)
+    {
+        return tree_minimum(node->right);
+    }
+    LimdyRBNode *parent = node->parent;
+    while (parent != NULL && node == parent->right)
+    {
+        node = parent;
+        parent = parent->parent;
+    }
+    return parent;
+}
+
 static void delete_fixup(LimdyRBTree *tree, LimdyRBNode *x, LimdyRBNode *parent)
 {
     while (x != tree->root && (x == NULL || x->color == LIMDY_RB_BLACK))
@@ -248,48 +251,59 @@ static void delete_fixup(LimdyRBTree *tree, LimdyRBNode *x, LimdyRBNode *parent)
     }
 }
 
-ErrorCode limdy_rbtree_init(LimdyRBTree *tree)
+ErrorCode limdy_rbtree_init(LimdyRBTree *tree, LimdyRBCompare compare)
 {
     CHECK_NULL(tree, ERROR_INVALID_ARGUMENT);
+    CHECK_NULL(compare, ERROR_INVALID_ARGUMENT);
     tree->root = NULL;
     tree->size = 0;
+    tree->compare = compare;
     return ERROR_SUCCESS;
 }
 
-ErrorCode limdy_rbtree_insert(LimdyRBTree *tree, LimdyMemoryPool *pool)
+void limdy_rbtree_node_clear(LimdyRBNode *node)
+{
+    node->parent = node;
+    node->left = node->right = NULL;
+    node->color = LIMDY_RB_RED;
+}
+
+bool limdy_rbtree_node_linked(const LimdyRBNode *node)
+{
+    return node->parent != node;
+}
+
+ErrorCode limdy_rbtree_insert(LimdyRBTree *tree, LimdyRBNode *node)
 {
     CHECK_NULL(tree, ERROR_INVALID_ARGUMENT);
-    CHECK_NULL(pool, ERROR_INVALID_ARGUMENT);
+    CHECK_NULL(node, ERROR_INVALID_ARGUMENT);
 
-    LimdyRBNode *node = create_node(pool);
-    if (node == NULL)
+    if (limdy_rbtree_node_linked(node))
     {
-        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate memory for new RB-tree node");
-        return ERROR_MEMORY_ALLOCATION;
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Attempt to insert a node that is already in an RB-tree");
+        return ERROR_INVALID_ARGUMENT;
     }
 
     LimdyRBNode *y = NULL;
     LimdyRBNode *x = tree->root;
+    bool left = false;
 
+    // Equal nodes go right, after the ones already there
     while (x != NULL)
     {
         y = x;
-        if (pool->total_size < x->pool->total_size)
-        {
-            x = x->left;
-        }
-        else
-        {
-            x = x->right;
-        }
+        left = tree->compare(node, x) < 0;
+        x = left ? x->left : x->right;
     }
 
     node->parent = y;
+    node->left = node->right = NULL;
+    node->color = LIMDY_RB_RED;
     if (y == NULL)
     {
         tree->root = node;
     }
-    else if (pool->total_size < y->pool->total_size)
+    else if (left)
     {
         y->left = node;
     }
@@ -304,46 +318,32 @@ ErrorCode limdy_rbtree_insert(LimdyRBTree *tree, LimdyMemoryPool *pool)
     return ERROR_SUCCESS;
 }
 
-ErrorCode limdy_rbtree_remove(LimdyRBTree *tree, LimdyMemoryPool *pool)
+ErrorCode limdy_rbtree_remove(LimdyRBTree *tree, LimdyRBNode *z)
 {
     CHECK_NULL(tree, ERROR_INVALID_ARGUMENT);
-    CHECK_NULL(pool, ERROR_INVALID_ARGUMENT);
-
-    LimdyRBNode *z = tree->root;
-    while (z != NULL)
-    {
-        if (pool->total_size == z->pool->total_size)
-        {
-            break;
-        }
-        if (pool->total_size < z->pool->total_size)
-        {
-            z = z->left;
-        }
-        else
-        {
-            z = z->right;
-        }
-    }
+    CHECK_NULL(z, ERROR_INVALID_ARGUMENT);
 
-    if (z == NULL)
+    if (!limdy_rbtree_node_linked(z))
     {
-        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INVALID_POOL, "Attempt to remove non-existent pool from RB-tree");
-        return LIMDY_MEMORY_POOL_ERROR_INVALID_POOL;
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Attempt to remove a node that is in no RB-tree");
+        return ERROR_INVALID_ARGUMENT;
     }
 
     LimdyRBNode *y = z;
     LimdyRBNode *x;
+    LimdyRBNode *x_parent; // x may be NULL, so its parent is tracked separately
     LimdyRBColor y_original_color = y->color;
 
     if (z->left == NULL)
     {
         x = z->right;
+        x_parent = z->parent;
         transplant(tree, z, z->right);
     }
     else if (z->right == NULL)
     {
         x = z->left;
+        x_parent = z->parent;
         transplant(tree, z, z->left);
     }
     else
@@ -353,6 +353,7 @@ ErrorCode limdy_rbtree_remove(LimdyRBTree *tree, LimdyMemoryPool *pool)
         x = y->right;
         if (y->parent == z)
         {
+            x_parent = y;
             if (x != NULL)
             {
                 x->parent = y;
@@ -360,6 +361,7 @@ ErrorCode limdy_rbtree_remove(LimdyRBTree *tree, LimdyMemoryPool *pool)
         }
         else
         {
+            x_parent = y->parent;
             transplant(tree, y, y->right);
             y->right = z->right;
             y->right->parent = y;
@@ -372,27 +374,31 @@ ErrorCode limdy_rbtree_remove(LimdyRBTree *tree, LimdyMemoryPool *pool)
 
     if (y_original_color == LIMDY_RB_BLACK)
     {
-        delete_fixup(tree, x, (x == NULL) ? y->parent : x->parent);
+        delete_fixup(tree, x, x_parent);
     }
 
-    limdy_memory_pool_free(z);
+    limdy_rbtree_node_clear(z);
     tree->size--;
 
     return ERROR_SUCCESS;
 }
 
-LimdyMemoryPool *limdy_rbtree_find_best_fit(const LimdyRBTree *tree, size_t size)
+LimdyRBNode *limdy_rbtree_lower_bound(const LimdyRBTree *tree, const void *key, LimdyRBKeyCompare compare)
 {
-    CHECK_NULL(tree, NULL);
+    if (!tree)
+    {
+        LOG_ERROR(ERROR_NULL_POINTER, "Null tree");
+        return NULL;
+    }
 
     LimdyRBNode *current = tree->root;
-    LimdyMemoryPool *best_fit = NULL;
+    LimdyRBNode *bound = NULL;
 
     while (current != NULL)
     {
-        if (current->pool->total_size >= size)
+        if (compare(key, current) <= 0)
         {
-            best_fit = current->pool;
+            bound = current;
             current = current->left;
         }
         else
@@ -401,92 +407,141 @@ LimdyMemoryPool *limdy_rbtree_find_best_fit(const LimdyRBTree *tree, size_t size
         }
     }
 
-    return best_fit;
+    return bound;
 }
 
-static void destroy_node(LimdyRBNode *node)
+LimdyRBNode *limdy_rbtree_floor(const LimdyRBTree *tree, const void *key, LimdyRBKeyCompare compare)
 {
-    if (node != NULL)
+    if (!tree)
+    {
+        LOG_ERROR(ERROR_NULL_POINTER, "Null tree");
+        return NULL;
+    }
+
+    LimdyRBNode *current = tree->root;
+    LimdyRBNode *bound = NULL;
+
+    while (current != NULL)
     {
-        destroy_node(node->left);
-        destroy_node(node->right);
-        limdy_memory_pool_free(node);
+        if (compare(key, current) >= 0)
+        {
+            bound = current;
+            current = current->right;
+        }
+        else
+        {
+            current = current->left;
+        }
     }
+
+    return bound;
 }
 
-void limdy_rbtree_destroy(LimdyRBTree *tree)
+LimdyRBNode *limdy_rbtree_first(const LimdyRBTree *tree)
 {
-    if (tree != NULL)
+    if (!tree)
     {
-        destroy_node(tree->root);
-        tree->root = NULL;
-        tree->size = 0;
+        LOG_ERROR(ERROR_NULL_POINTER, "Null tree");
+        return NULL;
     }
+    return tree->root ? tree_minimum(tree->root) : NULL;
 }
 
-#ifdef LIMDY_MEMORY_DEBUG
-void limdy_rbtree_validate(const LimdyRBTree *tree)
+LimdyRBNode *limdy_rbtree_next(const LimdyRBNode *node)
 {
-    if (tree == NULL || tree->root == NULL)
+    if (!node)
     {
-        return;
+        LOG_ERROR(ERROR_NULL_POINTER, "Null node");
+        return NULL;
     }
+    return tree_successor((LimdyRBNode *)node);
+}
 
-    // Check if root is black
-    assert(tree->root->color == LIMDY_RB_BLACK);
-
-    // Check if every path from root to leaves has the same number of black nodes
-    int black_count = 0;
-    const LimdyRBNode *node = tree->root;
-    while (node != NULL)
+/**
+ * @brief Checks the colors, black heights and parent links of a subtree.
+ *
+ * @return Black height of the subtree, or -1 if it is invalid.
+ */
+static int validate_subtree(const LimdyRBNode *node, const LimdyRBNode *parent, size_t *count)
+{
+    if (node == NULL)
     {
-        if (node->color == LIMDY_RB_BLACK)
-        {
-            black_count++;
-        }
-        node = node->left;
+        return 1;
     }
+    (*count)++;
 
-    int path_black_count = 0;
-    bool valid = true;
+    if (node->parent != parent)
+    {
+        return -1;
+    }
 
-    void validate_node(const LimdyRBNode *node)
+    // Red nodes only have black children
+    if (node->color == LIMDY_RB_RED &&
+        ((node->left != NULL && node->left->color == LIMDY_RB_RED) ||
+         (node->right != NULL && node->right->color == LIMDY_RB_RED)))
     {
-        if (node == NULL)
-        {
-            if (path_black_count != black_count)
-            {
-                valid = false;
-            }
-            return;
-        }
+        return -1;
+    }
 
-        // Check if red node has only black children
-        if (node->color == LIMDY_RB_RED)
-        {
-            if ((node->left != NULL && node->left->color == LIMDY_RB_RED) ||
-                (node->right != NULL && node->right->color == LIMDY_RB_RED))
-            {
-                valid = false;
-            }
-        }
+    int left_height = validate_subtree(node->left, node, count);
+    int right_height = validate_subtree(node->right, node, count);
+    if (left_height < 0 || left_height != right_height)
+    {
+        return -1;
+    }
+    return left_height + (node->color == LIMDY_RB_BLACK);
+}
 
-        if (node->color == LIMDY_RB_BLACK)
-        {
-            path_black_count++;
-        }
+bool limdy_rbtree_validate(const LimdyRBTree *tree)
+{
+    if (tree == NULL)
+    {
+        return false;
+    }
+    if (tree->root == NULL)
+    {
+        return tree->size == 0;
+    }
+    if (tree->root->color != LIMDY_RB_BLACK)
+    {
+        return false;
+    }
 
-        validate_node(node->left);
-        validate_node(node->right);
+    size_t count = 0;
+    if (validate_subtree(tree->root, NULL, &count) < 0 || count != tree->size)
+    {
+        return false;
+    }
 
-        if (node->color == LIMDY_RB_BLACK)
+    // Checking each node against its successor covers the whole order
+    const LimdyRBNode *previous = NULL;
+    for (const LimdyRBNode *node = tree_minimum(tree->root); node != NULL; node = tree_successor((LimdyRBNode *)node))
+    {
+        if (previous != NULL && tree->compare(previous, node) > 0)
         {
-            path_black_count--;
+            return false;
         }
+        previous = node;
     }
+    return true;
+}
 
-    validate_node(tree->root);
+static void clear_subtree(LimdyRBNode *node)
+{
+    if (node != NULL)
+    {
+        clear_subtree(node->left);
+        clear_subtree(node->right);
+        limdy_rbtree_node_clear(node);
+    }
+}
 
-    assert(valid);
+void limdy_rbtree_destroy(LimdyRBTree *tree)
+{
+    if (tree != NULL)
+    {
+        clear_subtree(tree->root);
+        tree->root = NULL;
+        tree->size = 0;
+    }
 }
-#endif // LIMDY_MEMORY_DEBUG
\ No newline at end of file
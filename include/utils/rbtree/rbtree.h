@@ -1,9 +1,13 @@
 /**
  * @file rbtree.h
- * @brief Red-Black Tree implementation for memory pool management.
+ * @brief Intrusive Red-Black Tree implementation.
  *
  * This file contains the declarations for a Red-Black Tree data structure
  * used to efficiently manage and search memory pools in the Limdy project.
+ * Nodes are embedded in the indexed structures and the tree never allocates,
+ * so the memory pool can index its own pools: by size for best-fit searches
+ * and by address to find the pool owning a pointer. LIMDY_RB_ENTRY() gets
+ * the structure back from its node.
  *
  * @author Mirza Bicer
  * @date 2024-08-24
@@ -14,10 +18,14 @@
 
 #include <stddef.h>
 #include <stdbool.h>
-#include "memory_pool.h"
 #include "error_handler.h"
 #include "limdy_alignment.h"
 
+/**
+ * @brief Get the structure of type @p type embedding @p node as its @p member.
+ */
+#define LIMDY_RB_ENTRY(node, type, member) ((type *)((char *)(node) - offsetof(type, member)))
+
 /**
  * @brief Enumeration of node colors in the Red-Black Tree.
  */
@@ -28,17 +36,26 @@ typedef enum
 } LimdyRBColor;
 
 /**
- * @brief Structure representing a node in the Red-Black Tree.
+ * @brief Structure representing a node in the Red-Black Tree, embedded in the indexed structure.
  */
 typedef struct LimdyRBNode
 {
-    LimdyMemoryPool *pool;
-    LimdyRBColor color;
-    struct LimdyRBNode *parent;
+    struct LimdyRBNode *parent; /**< Parent, or the node itself while it is in no tree */
     struct LimdyRBNode *left;
     struct LimdyRBNode *right;
+    LimdyRBColor color;
 } LimdyRBNode;
 
+/**
+ * @brief Orders two nodes; negative, zero or positive like strcmp.
+ */
+typedef int (*LimdyRBCompare)(const LimdyRBNode *a, const LimdyRBNode *b);
+
+/**
+ * @brief Orders a search key against a node; negative, zero or positive like strcmp.
+ */
+typedef int (*LimdyRBKeyCompare)(const void *key, const LimdyRBNode *node);
+
 /**
  * @brief Structure representing the Red-Black Tree.
  */
@@ -46,48 +63,105 @@ typedef struct
 {
     LimdyRBNode *root;
     size_t size;
+    LimdyRBCompare compare; /**< Order of the nodes; equal nodes keep insertion order */
 } LimdyRBTree;
 
 /**
  * @brief Initialize a new Red-Black Tree.
  *
  * @param tree Pointer to the tree to initialize.
+ * @param compare Order of the nodes.
  * @return ErrorCode indicating success or failure.
  */
-ErrorCode limdy_rbtree_init(LimdyRBTree *tree);
+ErrorCode limdy_rbtree_init(LimdyRBTree *tree, LimdyRBCompare compare);
 
 /**
- * @brief Insert a memory pool into the Red-Black Tree.
+ * @brief Mark a node as being in no tree.
+ *
+ * Nodes must be cleared once before their first insertion; removal clears them again.
+ *
+ * @param node Pointer to the node.
+ */
+void limdy_rbtree_node_clear(LimdyRBNode *node);
+
+/**
+ * @brief Check whether a node is in a tree.
+ *
+ * @param node Pointer to a cleared or inserted node.
+ * @return true if the node is in a tree.
+ */
+bool limdy_rbtree_node_linked(const LimdyRBNode *node);
+
+/**
+ * @brief Insert a node into the Red-Black Tree.
  *
  * @param tree Pointer to the tree.
- * @param pool Pointer to the memory pool to insert.
+ * @param node Pointer to a node that is in no tree.
  * @return ErrorCode indicating success or failure.
  */
-ErrorCode limdy_rbtree_insert(LimdyRBTree *tree, LimdyMemoryPool *pool);
+ErrorCode limdy_rbtree_insert(LimdyRBTree *tree, LimdyRBNode *node);
 
 /**
- * @brief Remove a memory pool from the Red-Black Tree.
+ * @brief Remove a node from the Red-Black Tree.
  *
- * @param tree Pointer to the tree.
- * @param pool Pointer to the memory pool to remove.
+ * @param tree Pointer to the tree holding the node.
+ * @param node Pointer to the node to remove.
  * @return ErrorCode indicating success or failure.
  */
-ErrorCode limdy_rbtree_remove(LimdyRBTree *tree, LimdyMemoryPool *pool);
+ErrorCode limdy_rbtree_remove(LimdyRBTree *tree, LimdyRBNode *node);
 
 /**
- * @brief Find the best fit memory pool for a given size.
+ * @brief Find the first node not ordered before a key.
+ *
+ * @param tree Pointer to the tree.
+ * @param key The key to search for.
+ * @param compare Order of the key against the nodes, consistent with the tree's order.
+ * @return The first node at or after the key, or NULL if there is none.
+ */
+LimdyRBNode *limdy_rbtree_lower_bound(const LimdyRBTree *tree, const void *key, LimdyRBKeyCompare compare);
+
+/**
+ * @brief Find the last node not ordered after a key.
+ *
+ * @param tree Pointer to the tree.
+ * @param key The key to search for.
+ * @param compare Order of the key against the nodes, consistent with the tree's order.
+ * @return The last node at or before the key, or NULL if there is none.
+ */
+LimdyRBNode *limdy_rbtree_floor(const LimdyRBTree *tree, const void *key, LimdyRBKeyCompare compare);
+
+/**
+ * @brief Get the first node in order.
+ *
+ * @param tree Pointer to the tree.
+ * @return The first node, or NULL if the tree is empty.
+ */
+LimdyRBNode *limdy_rbtree_first(const LimdyRBTree *tree);
+
+/**
+ * @brief Get the node following another in order.
+ *
+ * @param node Pointer to a node in a tree.
+ * @return The next node, or NULL after the last one.
+ */
+LimdyRBNode *limdy_rbtree_next(const LimdyRBNode *node);
+
+/**
+ * @brief Check every Red-Black Tree invariant.
+ *
+ * Verifies the colors, equal black heights, parent links, the order of the
+ * nodes and the node count. Takes O(n) time.
  *
  * @param tree Pointer to the tree.
- * @param size The size to find a best fit for.
- * @return Pointer to the best fit memory pool, or NULL if not found.
+ * @return true if the tree is valid.
  */
-LimdyMemoryPool *limdy_rbtree_find_best_fit(const LimdyRBTree *tree, size_t size);
+bool limdy_rbtree_validate(const LimdyRBTree *tree);
 
 /**
- * @brief Destroy the Red-Black Tree and free all associated resources.
+ * @brief Empty the Red-Black Tree, clearing every node in it.
  *
  * @param tree Pointer to the tree to destroy.
  */
 void limdy_rbtree_destroy(LimdyRBTree *tree);
 
-#endif // LIMDY_RBTREE_H
\ No newline at end of file
+#endif // LIMDY_RBTREE_H
@@ -0,0 +1,95 @@
+/**
+ * @file thread_pool.h
+ * @brief Fixed-size worker pool for the Limdy project.
+ *
+ * A thread pool runs submitted tasks on a fixed set of worker threads in
+ * FIFO order. limdy_thread_pool_parallel_for() splits an index range across
+ * the workers and the calling thread and returns once every index has run;
+ * because the caller takes part, it is safe to call from inside a task.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#ifndef LIMDY_UTILS_THREAD_POOL_H
+#define LIMDY_UTILS_THREAD_POOL_H
+
+#include <stddef.h>
+#include "error_handler.h"
+
+/**
+ * @brief Upper bound on the number of workers picked automatically.
+ */
+#define LIMDY_THREAD_POOL_MAX_AUTO_THREADS 16
+
+/**
+ * @brief A unit of work run by the pool.
+ */
+typedef void (*LimdyTaskFn)(void *arg);
+
+/**
+ * @brief Body of a parallel loop, called once per index.
+ */
+typedef void (*LimdyParallelFn)(void *arg, size_t index);
+
+/**
+ * @brief Opaque structure representing a thread pool.
+ */
+typedef struct LimdyThreadPool LimdyThreadPool;
+
+/**
+ * @brief Create a thread pool.
+ *
+ * @param thread_count Number of workers, or 0 for one per online CPU (capped at LIMDY_THREAD_POOL_MAX_AUTO_THREADS).
+ * @param pool Pointer to store the created pool.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_thread_pool_create(size_t thread_count, LimdyThreadPool **pool);
+
+/**
+ * @brief Queue a task to run on a worker.
+ *
+ * @param pool The thread pool.
+ * @param fn The task function.
+ * @param arg Argument passed to the task.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_thread_pool_submit(LimdyThreadPool *pool, LimdyTaskFn fn, void *arg);
+
+/**
+ * @brief Run fn(arg, i) for every i in [0, count) and wait for all of them.
+ *
+ * @param pool The thread pool.
+ * @param count Number of indexes.
+ * @param fn The loop body.
+ * @param arg Argument passed to every call.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_thread_pool_parallel_for(LimdyThreadPool *pool, size_t count, LimdyParallelFn fn, void *arg);
+
+/**
+ * @brief Get the number of worker threads.
+ *
+ * @param pool The thread pool.
+ * @return The number of workers.
+ */
+size_t limdy_thread_pool_size(const LimdyThreadPool *pool);
+
+/**
+ * @brief Run all queued tasks, stop the workers and free the pool.
+ *
+ * @param pool The thread pool to destroy.
+ */
+void limdy_thread_pool_destroy(LimdyThreadPool *pool);
+
+/**
+ * @brief Base error code for thread pool errors.
+ */
+#define LIMDY_THREAD_POOL_ERROR_BASE (ERROR_CUSTOM_BASE + 180)
+
+/**
+ * @brief Error code for a pool that is shutting down.
+ */
+#define LIMDY_THREAD_POOL_ERROR_STOPPED (LIMDY_THREAD_POOL_ERROR_BASE + 1)
+
+#endif // LIMDY_UTILS_THREAD_POOL_H
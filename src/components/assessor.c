@@ -0,0 +1,766 @@
+/**
+ * @file assessor.c
+ * @brief Implementation of the batch answer assessor.
+ *
+ * This file implements the interface defined in assessor.h. Expected
+ * tokens are rows and answer tokens are columns of the edit distance
+ * matrix. A column is kept as two bit vectors, Pv and Mv, marking the rows
+ * whose distance is one more or one less than the row above, and Myers'
+ * step turns one column into the next with a handful of word operations,
+ * given the bit vector Eq of rows whose token equals the column's. Each
+ * answer's Eq vectors come from a small hash table of its expected tokens.
+ *
+ * Answers with up to LIMDY_ASSESSOR_WORD_TOKENS expected tokens are written
+ * into a stream of columns of LIMDY_ASSESSOR_LANES answers, each column
+ * holding every lane's Eq and a mask of lanes still inside their answers,
+ * and the vector kernels step all lanes at once. A lane's column after its
+ * last token is frozen by the mask, so the distance is read from the final
+ * column: the answer's length plus the sum of its vertical differences.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include "components/assessor.h"
+#include "utils/memory_pool.h"
+#include "utils/limdy_utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define ASSESSOR_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#define ASSESSOR_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Words in one column of the lane stream: every lane's Eq, then every lane's activity mask
+#define STREAM_COLUMN_WORDS (2 * LIMDY_ASSESSOR_LANES)
+
+typedef struct
+{
+    const char *name;
+    // Steps LIMDY_ASSESSOR_LANES single-word columns through columns stream columns
+    void (*advance_lanes)(const uint64_t *stream, size_t columns, uint64_t *pv, uint64_t *mv);
+} AssessorOps;
+
+struct Assessor
+{
+    const TokenizationService *tokenization_service;
+    const AssessorOps *ops;
+};
+
+/**
+ * @brief A distinct expected token; the Eq words of its symbol are its rows.
+ */
+typedef struct
+{
+    uint64_t hash;
+    uint32_t token;  // First expected token with this text, UINT32_MAX for an empty slot
+    uint32_t symbol; // Index of its Eq words
+} EqSlot;
+
+/**
+ * @brief Scratch memory of one call, sized for its largest submission.
+ */
+typedef struct
+{
+    uint64_t *stream;   // Lane columns, STREAM_COLUMN_WORDS words each
+    Token *spans;       // Tokens of the answer being scored
+    EqSlot *slots;      // Hash table of the expected tokens
+    uint64_t *eq;       // blocks Eq words per symbol
+    uint64_t *state;    // Pv then Mv words of a multi-word column, or every column with history
+    size_t block_count; // Words per column
+} AssessorScratch;
+
+#define ASSESSOR_INLINE static inline __attribute__((always_inline))
+
+ASSESSOR_INLINE unsigned char fold_byte(unsigned char c)
+{
+    return (unsigned)(c - 'A') < 26u ? (unsigned char)(c | 0x20) : c;
+}
+
+static uint64_t hash_folded(const char *text, size_t length)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ fold_byte((unsigned char)text[i])) * 0x100000001b3ull;
+    }
+    return hash ^ (hash >> 29);
+}
+
+static bool equal_folded(const char *a, size_t a_length, const char *b, size_t b_length)
+{
+    if (a_length != b_length)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a_length; i++)
+    {
+        if (fold_byte((unsigned char)a[i]) != fold_byte((unsigned char)b[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static size_t slot_capacity(size_t expected_count)
+{
+    size_t capacity = 2;
+    while (capacity < 2 * expected_count)
+    {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+static size_t block_count(size_t expected_count)
+{
+    return expected_count > LIMDY_ASSESSOR_WORD_TOKENS ? (expected_count + LIMDY_ASSESSOR_WORD_TOKENS - 1) / LIMDY_ASSESSOR_WORD_TOKENS
+                                                      : 1;
+}
+
+/**
+ * @brief Fills the Eq table with the expected tokens of a submission.
+ */
+static void build_eq_table(const AssessorSubmission *submission, size_t blocks, AssessorScratch *scratch)
+{
+    size_t mask = slot_capacity(submission->expected_count) - 1;
+    for (size_t i = 0; i <= mask; i++)
+    {
+        scratch->slots[i].token = UINT32_MAX;
+    }
+
+    uint32_t symbols = 0;
+    for (size_t i = 0; i < submission->expected_count; i++)
+    {
+        const Token *token = &submission->expected[i];
+        uint64_t hash = hash_folded(token->text, token->length);
+        size_t index = hash & mask;
+        EqSlot *slot = &scratch->slots[index];
+        while (slot->token != UINT32_MAX)
+        {
+            const Token *first = &submission->expected[slot->token];
+            if (slot->hash == hash && equal_folded(first->text, first->length, token->text, token->length))
+            {
+                break;
+            }
+            index = (index + 1) & mask;
+            slot = &scratch->slots[index];
+        }
+        if (slot->token == UINT32_MAX)
+        {
+            *slot = (EqSlot){hash, (uint32_t)i, symbols++};
+            memset(scratch->eq + slot->symbol * blocks, 0, blocks * sizeof(uint64_t));
+        }
+        scratch->eq[slot->symbol * blocks + i / LIMDY_ASSESSOR_WORD_TOKENS] |= 1ull << (i % LIMDY_ASSESSOR_WORD_TOKENS);
+    }
+}
+
+/**
+ * @brief Looks up the Eq words of an answer token.
+ *
+ * @return The token's blocks Eq words, or NULL if no expected token equals it.
+ */
+static const uint64_t *find_eq(const AssessorSubmission *submission, size_t blocks, const AssessorScratch *scratch, const char *text,
+                               size_t length)
+{
+    size_t mask = slot_capacity(submission->expected_count) - 1;
+    uint64_t hash = hash_folded(text, length);
+    for (size_t index = hash & mask;; index = (index + 1) & mask)
+    {
+        const EqSlot *slot = &scratch->slots[index];
+        if (slot->token == UINT32_MAX)
+        {
+            return NULL;
+        }
+        const Token *token = &submission->expected[slot->token];
+        if (slot->hash == hash && equal_folded(token->text, token->length, text, length))
+        {
+            return scratch->eq + slot->symbol * blocks;
+        }
+    }
+}
+
+/**
+ * @brief Advances one word of a column by one answer token.
+ *
+ * @param eq Rows of the word whose token equals the answer token.
+ * @param hin Difference entering the word's top row from the word above, -1, 0 or 1.
+ * @param pv Rows one more than the row above; updated.
+ * @param mv Rows one less than the row above; updated.
+ * @return The difference leaving the word's bottom row.
+ */
+ASSESSOR_INLINE int advance_block(uint64_t eq, int hin, uint64_t *pv, uint64_t *mv)
+{
+    uint64_t hin_negative = hin < 0;
+    uint64_t xv = eq | *mv;
+    eq |= hin_negative;
+    uint64_t xh = (((eq & *pv) + *pv) ^ *pv) | eq;
+    uint64_t ph = *mv | ~(xh | *pv);
+    uint64_t mh = *pv & xh;
+    int hout = (int)(ph >> 63) - (int)(mh >> 63);
+    ph = (ph << 1) | (uint64_t)(hin > 0);
+    mh = (mh << 1) | hin_negative;
+    *pv = mh | ~(xv | ph);
+    *mv = ph & xv;
+    return hout;
+}
+
+/**
+ * @brief Gets the distance between the first rows expected tokens and the first column answer tokens.
+ */
+static size_t column_distance(const uint64_t *pv, const uint64_t *mv, size_t rows, size_t column)
+{
+    int64_t distance = (int64_t)column;
+    size_t block = 0;
+    for (; rows >= LIMDY_ASSESSOR_WORD_TOKENS; rows -= LIMDY_ASSESSOR_WORD_TOKENS, block++)
+    {
+        distance += __builtin_popcountll(pv[block]) - __builtin_popcountll(mv[block]);
+    }
+    if (rows)
+    {
+        uint64_t mask = (1ull << rows) - 1;
+        distance += __builtin_popcountll(pv[block] & mask) - __builtin_popcountll(mv[block] & mask);
+    }
+    return (size_t)distance;
+}
+
+static void set_score(AssessorScore *score, size_t distance, size_t expected_count, size_t answer_count)
+{
+    size_t longest = expected_count > answer_count ? expected_count : answer_count;
+    score->distance = (uint32_t)distance;
+    score->expected_count = (uint32_t)expected_count;
+    score->answer_count = (uint32_t)answer_count;
+    score->score = longest ? 1.0f - (float)distance / (float)longest : 1.0f;
+}
+
+static void advance_lanes_scalar(const uint64_t *stream, size_t columns, uint64_t *pv, uint64_t *mv)
+{
+    for (size_t j = 0; j < columns; j++, stream += STREAM_COLUMN_WORDS)
+    {
+        for (size_t lane = 0; lane < LIMDY_ASSESSOR_LANES; lane++)
+        {
+            uint64_t next_pv = pv[lane];
+            uint64_t next_mv = mv[lane];
+            advance_block(stream[lane], 1, &next_pv, &next_mv);
+            uint64_t active = stream[LIMDY_ASSESSOR_LANES + lane];
+            pv[lane] ^= (next_pv ^ pv[lane]) & active;
+            mv[lane] ^= (next_mv ^ mv[lane]) & active;
+        }
+    }
+}
+
+#ifdef ASSESSOR_HAVE_X86
+ASSESSOR_INLINE void advance_sse2(__m128i eq, __m128i active, __m128i *pv, __m128i *mv)
+{
+    const __m128i ones = _mm_set1_epi64x(-1);
+    __m128i xv = _mm_or_si128(eq, *mv);
+    __m128i xh = _mm_or_si128(_mm_xor_si128(_mm_add_epi64(_mm_and_si128(eq, *pv), *pv), *pv), eq);
+    __m128i ph = _mm_or_si128(*mv, _mm_andnot_si128(_mm_or_si128(xh, *pv), ones));
+    __m128i mh = _mm_and_si128(*pv, xh);
+    ph = _mm_or_si128(_mm_slli_epi64(ph, 1), _mm_set1_epi64x(1));
+    mh = _mm_slli_epi64(mh, 1);
+    __m128i next_pv = _mm_or_si128(mh, _mm_andnot_si128(_mm_or_si128(xv, ph), ones));
+    __m128i next_mv = _mm_and_si128(ph, xv);
+    *pv = _mm_xor_si128(*pv, _mm_and_si128(_mm_xor_si128(next_pv, *pv), active));
+    *mv = _mm_xor_si128(*mv, _mm_and_si128(_mm_xor_si128(next_mv, *mv), active));
+}
+
+static void advance_lanes_sse2(const uint64_t *stream, size_t columns, uint64_t *pv, uint64_t *mv)
+{
+    // Two lanes per register; the two halves are independent chains
+    __m128i pv_low = _mm_loadu_si128((const __m128i *)pv);
+    __m128i pv_high = _mm_loadu_si128((const __m128i *)(pv + 2));
+    __m128i mv_low = _mm_loadu_si128((const __m128i *)mv);
+    __m128i mv_high = _mm_loadu_si128((const __m128i *)(mv + 2));
+    for (size_t j = 0; j < columns; j++, stream += STREAM_COLUMN_WORDS)
+    {
+        const __m128i *column = (const __m128i *)stream;
+        advance_sse2(_mm_load_si128(column), _mm_load_si128(column + 2), &pv_low, &mv_low);
+        advance_sse2(_mm_load_si128(column + 1), _mm_load_si128(column + 3), &pv_high, &mv_high);
+    }
+    _mm_storeu_si128((__m128i *)pv, pv_low);
+    _mm_storeu_si128((__m128i *)(pv + 2), pv_high);
+    _mm_storeu_si128((__m128i *)mv, mv_low);
+    _mm_storeu_si128((__m128i *)(mv + 2), mv_high);
+}
+
+__attribute__((target("avx2"))) static void advance_lanes_avx2(const uint64_t *stream, size_t columns, uint64_t *pv, uint64_t *mv)
+{
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    const __m256i one = _mm256_set1_epi64x(1);
+    __m256i p = _mm256_loadu_si256((const __m256i *)pv);
+    __m256i m = _mm256_loadu_si256((const __m256i *)mv);
+    for (size_t j = 0; j < columns; j++, stream += STREAM_COLUMN_WORDS)
+    {
+        // The stream is 64-byte aligned and a column is 64 bytes
+        __m256i eq = _mm256_load_si256((const __m256i *)stream);
+        __m256i active = _mm256_load_si256((const __m256i *)(stream + LIMDY_ASSESSOR_LANES));
+        __m256i xv = _mm256_or_si256(eq, m);
+        __m256i xh = _mm256_or_si256(_mm256_xor_si256(_mm256_add_epi64(_mm256_and_si256(eq, p), p), p), eq);
+        __m256i ph = _mm256_or_si256(m, _mm256_andnot_si256(_mm256_or_si256(xh, p), ones));
+        __m256i mh = _mm256_and_si256(p, xh);
+        ph = _mm256_or_si256(_mm256_slli_epi64(ph, 1), one);
+        mh = _mm256_slli_epi64(mh, 1);
+        __m256i next_pv = _mm256_or_si256(mh, _mm256_andnot_si256(_mm256_or_si256(xv, ph), ones));
+        __m256i next_mv = _mm256_and_si256(ph, xv);
+        p = _mm256_blendv_epi8(p, next_pv, active);
+        m = _mm256_blendv_epi8(m, next_mv, active);
+    }
+    _mm256_storeu_si256((__m256i *)pv, p);
+    _mm256_storeu_si256((__m256i *)mv, m);
+}
+#endif // ASSESSOR_HAVE_X86
+
+#ifdef ASSESSOR_HAVE_NEON
+ASSESSOR_INLINE void advance_neon(uint64x2_t eq, uint64x2_t active, uint64x2_t *pv, uint64x2_t *mv)
+{
+    const uint64x2_t ones = vdupq_n_u64(~0ull);
+    uint64x2_t xv = vorrq_u64(eq, *mv);
+    uint64x2_t xh = vorrq_u64(veorq_u64(vaddq_u64(vandq_u64(eq, *pv), *pv), *pv), eq);
+    uint64x2_t ph = vorrq_u64(*mv, vbicq_u64(ones, vorrq_u64(xh, *pv)));
+    uint64x2_t mh = vandq_u64(*pv, xh);
+    ph = vorrq_u64(vshlq_n_u64(ph, 1), vdupq_n_u64(1));
+    mh = vshlq_n_u64(mh, 1);
+    uint64x2_t next_pv = vorrq_u64(mh, vbicq_u64(ones, vorrq_u64(xv, ph)));
+    uint64x2_t next_mv = vandq_u64(ph, xv);
+    *pv = vbslq_u64(active, next_pv, *pv);
+    *mv = vbslq_u64(active, next_mv, *mv);
+}
+
+static void advance_lanes_neon(const uint64_t *stream, size_t columns, uint64_t *pv, uint64_t *mv)
+{
+    uint64x2_t pv_low = vld1q_u64(pv);
+    uint64x2_t pv_high = vld1q_u64(pv + 2);
+    uint64x2_t mv_low = vld1q_u64(mv);
+    uint64x2_t mv_high = vld1q_u64(mv + 2);
+    for (size_t j = 0; j < columns; j++, stream += STREAM_COLUMN_WORDS)
+    {
+        advance_neon(vld1q_u64(stream), vld1q_u64(stream + 4), &pv_low, &mv_low);
+        advance_neon(vld1q_u64(stream + 2), vld1q_u64(stream + 6), &pv_high, &mv_high);
+    }
+    vst1q_u64(pv, pv_low);
+    vst1q_u64(pv + 2, pv_high);
+    vst1q_u64(mv, mv_low);
+    vst1q_u64(mv + 2, mv_high);
+}
+#endif // ASSESSOR_HAVE_NEON
+
+_Static_assert(LIMDY_ASSESSOR_LANES == 4, "The vector kernels step four 64-bit lanes");
+
+static const AssessorOps scalar_ops = {"scalar", advance_lanes_scalar};
+#ifdef ASSESSOR_HAVE_X86
+static const AssessorOps sse2_ops = {"sse2", advance_lanes_sse2};
+static const AssessorOps avx2_ops = {"avx2", advance_lanes_avx2};
+#endif
+#ifdef ASSESSOR_HAVE_NEON
+static const AssessorOps neon_ops = {"neon", advance_lanes_neon};
+#endif
+
+/**
+ * @brief Looks up the kernel for an instruction set if the CPU supports it.
+ *
+ * @param kernel The requested kernel.
+ * @return The kernel, or NULL if it is unavailable.
+ */
+static const AssessorOps *find_kernel(LimdyAttentionKernel kernel)
+{
+    switch (kernel)
+    {
+    case LIMDY_ATTENTION_KERNEL_SCALAR:
+        return &scalar_ops;
+#ifdef ASSESSOR_HAVE_X86
+    case LIMDY_ATTENTION_KERNEL_SSE2:
+        return __builtin_cpu_supports("sse2") ? &sse2_ops : NULL;
+    case LIMDY_ATTENTION_KERNEL_AVX2:
+        return __builtin_cpu_supports("avx2") ? &avx2_ops : NULL;
+#endif
+#ifdef ASSESSOR_HAVE_NEON
+    case LIMDY_ATTENTION_KERNEL_NEON:
+        return &neon_ops;
+#endif
+    case LIMDY_ATTENTION_KERNEL_AUTO:
+    {
+        static const LimdyAttentionKernel preference[] = {LIMDY_ATTENTION_KERNEL_AVX2, LIMDY_ATTENTION_KERNEL_NEON, LIMDY_ATTENTION_KERNEL_SSE2};
+        for (size_t i = 0; i < sizeof(preference) / sizeof(preference[0]); i++)
+        {
+            const AssessorOps *ops = find_kernel(preference[i]);
+            if (ops)
+            {
+                return ops;
+            }
+        }
+        return &scalar_ops;
+    }
+    default:
+        return NULL;
+    }
+}
+
+/**
+ * @brief Checks the submissions and takes the scratch memory for the largest of them.
+ *
+ * @param with_history Whether to keep every column of the answer instead of only the last.
+ */
+static ErrorCode reserve_scratch(const AssessorSubmission *submissions, size_t submission_count, bool with_history, LimdyArena *arena,
+                                 AssessorScratch *scratch)
+{
+    size_t max_answer = 1;
+    size_t max_expected = 1;
+    for (size_t i = 0; i < submission_count; i++)
+    {
+        const AssessorSubmission *submission = &submissions[i];
+        if ((submission->expected_count && !submission->expected) || (submission->answer_length && !submission->answer))
+        {
+            LOG_ERROR(ERROR_NULL_POINTER, "Submission %zu has no expected tokens or answer text", i);
+            return ERROR_NULL_POINTER;
+        }
+        if (submission->answer_length > LIMDY_TOKEN_MAX_TEXT_LENGTH || submission->expected_count > UINT32_MAX - 1)
+        {
+            LOG_ERROR(ERROR_INVALID_ARGUMENT, "Submission %zu is too long", i);
+            return ERROR_INVALID_ARGUMENT;
+        }
+        max_answer = submission->answer_length > max_answer ? submission->answer_length : max_answer;
+        max_expected = submission->expected_count > max_expected ? submission->expected_count : max_expected;
+    }
+
+    // A token is at least one byte, so an answer has at most as many tokens as bytes
+    scratch->block_count = block_count(max_expected);
+    size_t state_columns = with_history ? max_answer + 1 : 1;
+    size_t stream_bytes = with_history ? 0 : max_answer * STREAM_COLUMN_WORDS * sizeof(uint64_t);
+    size_t spans_bytes = LIMDY_ALIGN_UP(max_answer * sizeof(Token), 64);
+    size_t slots_bytes = slot_capacity(max_expected) * sizeof(EqSlot);
+    size_t eq_bytes = max_expected * scratch->block_count * sizeof(uint64_t);
+    size_t state_bytes = state_columns * 2 * scratch->block_count * sizeof(uint64_t);
+
+    char *base = limdy_arena_alloc_aligned(arena, stream_bytes + spans_bytes + slots_bytes + eq_bytes + state_bytes, 64);
+    CHECK_NULL(base, ERROR_MEMORY_ALLOCATION);
+    scratch->stream = (uint64_t *)base;
+    scratch->spans = (Token *)(base + stream_bytes);
+    scratch->slots = (EqSlot *)(base + stream_bytes + spans_bytes);
+    scratch->eq = (uint64_t *)(base + stream_bytes + spans_bytes + slots_bytes);
+    scratch->state = (uint64_t *)(base + stream_bytes + spans_bytes + slots_bytes + eq_bytes);
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Splits an answer into spans and indexes its expected tokens.
+ */
+static ErrorCode prepare_submission(const Assessor *assessor, const AssessorSubmission *submission, Language lang,
+                                    AssessorScratch *scratch, size_t blocks, size_t *answer_count)
+{
+    *answer_count = 0;
+    if (submission->answer_length)
+    {
+        ErrorCode error = tokenization_service_tokenize_spans(assessor->tokenization_service, submission->answer, submission->answer_length,
+                                                              lang, scratch->spans, submission->answer_length, answer_count);
+        RETURN_IF_ERROR(error);
+        if (*answer_count > submission->answer_length)
+        {
+            LOG_ERROR(LIMDY_ASSESSOR_ERROR_TOKENIZER, "Tokenizer reported %zu tokens in an answer of %zu bytes", *answer_count,
+                      submission->answer_length);
+            return LIMDY_ASSESSOR_ERROR_TOKENIZER;
+        }
+    }
+    build_eq_table(submission, blocks, scratch);
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Steps a column of blocks words through every answer token.
+ *
+ * @param state Pv then Mv words of the starting column; with history, each column follows the one before.
+ */
+static void advance_answer(const AssessorSubmission *submission, const AssessorScratch *scratch, size_t blocks, size_t answer_count,
+                           uint64_t *state, bool with_history)
+{
+    for (size_t j = 0; j < answer_count; j++)
+    {
+        uint64_t *pv = state;
+        if (with_history)
+        {
+            memcpy(state + 2 * blocks, state, 2 * blocks * sizeof(uint64_t));
+            state += 2 * blocks;
+            pv = state;
+        }
+        uint64_t *mv = pv + blocks;
+
+        const Token *span = &scratch->spans[j];
+        const uint64_t *eq = find_eq(submission, blocks, scratch, submission->answer + span->offset, span->length);
+        int hin = 1;
+        for (size_t block = 0; block < blocks; block++)
+        {
+            hin = advance_block(eq ? eq[block] : 0, hin, &pv[block], &mv[block]);
+        }
+    }
+}
+
+static void reset_state(uint64_t *state, size_t blocks)
+{
+    // Column 0: the distance grows by one each row
+    memset(state, 0xff, blocks * sizeof(uint64_t));
+    memset(state + blocks, 0, blocks * sizeof(uint64_t));
+}
+
+/**
+ * @brief Runs the vector kernel over the lanes written so far and scores them.
+ */
+static void flush_lanes(const Assessor *assessor, const AssessorSubmission *submissions, const size_t *lane_submission,
+                        const size_t *lane_columns, size_t lane_count, size_t columns, uint64_t *stream, AssessorScore *scores)
+{
+    // Lanes past their answers, or without one, only read zero masks
+    for (size_t lane = 0; lane < LIMDY_ASSESSOR_LANES; lane++)
+    {
+        for (size_t j = lane < lane_count ? lane_columns[lane] : 0; j < columns; j++)
+        {
+            stream[j * STREAM_COLUMN_WORDS + lane] = 0;
+            stream[j * STREAM_COLUMN_WORDS + LIMDY_ASSESSOR_LANES + lane] = 0;
+        }
+    }
+
+    uint64_t pv[LIMDY_ASSESSOR_LANES];
+    uint64_t mv[LIMDY_ASSESSOR_LANES];
+    memset(pv, 0xff, sizeof(pv));
+    memset(mv, 0, sizeof(mv));
+    assessor->ops->advance_lanes(stream, columns, pv, mv);
+
+    for (size_t lane = 0; lane < lane_count; lane++)
+    {
+        size_t expected_count = submissions[lane_submission[lane]].expected_count;
+        size_t distance = column_distance(&pv[lane], &mv[lane], expected_count, lane_columns[lane]);
+        set_score(&scores[lane_submission[lane]], distance, expected_count, lane_columns[lane]);
+    }
+}
+
+/**
+ * @brief Create an assessor.
+ *
+ * @param tokenization_service Service whose tokenize_spans splits answers; it must outlive the assessor.
+ * @param assessor Pointer to store the created assessor.
+ * @return ErrorCode indicating success or failure; ERROR_INVALID_ARGUMENT if the service has no span tokenizer.
+ */
+ErrorCode assessor_create(const TokenizationService *tokenization_service, Assessor **assessor)
+{
+    CHECK_NULL(tokenization_service, ERROR_NULL_POINTER);
+    CHECK_NULL(assessor, ERROR_NULL_POINTER);
+    if (!tokenization_service->tokenize_spans)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Assessor needs a tokenization service with tokenize_spans");
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    Assessor *new_assessor = limdy_memory_pool_alloc(sizeof(Assessor));
+    CHECK_NULL(new_assessor, ERROR_MEMORY_ALLOCATION);
+    new_assessor->tokenization_service = tokenization_service;
+    new_assessor->ops = find_kernel(LIMDY_ATTENTION_KERNEL_AUTO);
+
+    *assessor = new_assessor;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Destroy an assessor.
+ *
+ * @param assessor The assessor, or NULL.
+ */
+void assessor_destroy(Assessor *assessor)
+{
+    if (assessor)
+    {
+        limdy_memory_pool_free(assessor);
+    }
+}
+
+/**
+ * @brief Select the instruction set the assessor scores with.
+ *
+ * @param assessor The assessor.
+ * @param kernel The kernel to use, or LIMDY_ATTENTION_KERNEL_AUTO for the best one the CPU supports.
+ * @return ErrorCode indicating success, or LIMDY_ATTENTION_ERROR_UNSUPPORTED if the CPU lacks it.
+ */
+ErrorCode assessor_set_kernel(Assessor *assessor, LimdyAttentionKernel kernel)
+{
+    CHECK_NULL(assessor, ERROR_NULL_POINTER);
+
+    const AssessorOps *ops = find_kernel(kernel);
+    if (!ops)
+    {
+        LOG_ERROR(LIMDY_ATTENTION_ERROR_UNSUPPORTED, "Assessor kernel %d is not supported on this CPU", (int)kernel);
+        return LIMDY_ATTENTION_ERROR_UNSUPPORTED;
+    }
+    assessor->ops = ops;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Get the name of the kernel an assessor scores with.
+ *
+ * @param assessor The assessor.
+ * @return A static string such as "avx2" or "scalar".
+ */
+const char *assessor_kernel_name(const Assessor *assessor)
+{
+    return assessor ? assessor->ops->name : scalar_ops.name;
+}
+
+/**
+ * @brief Score a batch of answers.
+ *
+ * @param assessor The assessor.
+ * @param submissions The answers and their expected tokens.
+ * @param submission_count Number of submissions.
+ * @param lang The language the answers are written in.
+ * @param scratch Arena for the batch's scratch memory; the caller resets it.
+ * @param scores Array of submission_count entries to store the scores, in submission order.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode assessor_score_batch(const Assessor *assessor, const AssessorSubmission *submissions, size_t submission_count, Language lang,
+                               LimdyArena *scratch, AssessorScore *scores)
+{
+    CHECK_NULL(assessor, ERROR_NULL_POINTER);
+    CHECK_NULL(scratch, ERROR_NULL_POINTER);
+    if (submission_count == 0)
+    {
+        return ERROR_SUCCESS;
+    }
+    CHECK_NULL(submissions, ERROR_NULL_POINTER);
+    CHECK_NULL(scores, ERROR_NULL_POINTER);
+
+    AssessorScratch memory;
+    ErrorCode error = reserve_scratch(submissions, submission_count, false, scratch, &memory);
+    RETURN_IF_ERROR(error);
+
+    size_t lane_submission[LIMDY_ASSESSOR_LANES];
+    size_t lane_columns[LIMDY_ASSESSOR_LANES];
+    size_t lane_count = 0;
+    size_t columns = 0;
+    for (size_t i = 0; i < submission_count; i++)
+    {
+        const AssessorSubmission *submission = &submissions[i];
+        size_t blocks = block_count(submission->expected_count);
+        size_t answer_count;
+        error = prepare_submission(assessor, submission, lang, &memory, blocks, &answer_count);
+        RETURN_IF_ERROR(error);
+
+        if (blocks > 1)
+        {
+            reset_state(memory.state, blocks);
+            advance_answer(submission, &memory, blocks, answer_count, memory.state, false);
+            size_t distance = column_distance(memory.state, memory.state + blocks, submission->expected_count, answer_count);
+            set_score(&scores[i], distance, submission->expected_count, answer_count);
+            continue;
+        }
+
+        // Write the answer's column of Eq words into its lane
+        uint64_t *column = memory.stream + lane_count;
+        for (size_t j = 0; j < answer_count; j++, column += STREAM_COLUMN_WORDS)
+        {
+            const Token *span = &memory.spans[j];
+            const uint64_t *eq = find_eq(submission, 1, &memory, submission->answer + span->offset, span->length);
+            column[0] = eq ? eq[0] : 0;
+            column[LIMDY_ASSESSOR_LANES] = UINT64_MAX;
+        }
+        lane_submission[lane_count] = i;
+        lane_columns[lane_count] = answer_count;
+        columns = answer_count > columns ? answer_count : columns;
+        if (++lane_count == LIMDY_ASSESSOR_LANES)
+        {
+            flush_lanes(assessor, submissions, lane_submission, lane_columns, lane_count, columns, memory.stream, scores);
+            lane_count = 0;
+            columns = 0;
+        }
+    }
+    if (lane_count)
+    {
+        flush_lanes(assessor, submissions, lane_submission, lane_columns, lane_count, columns, memory.stream, scores);
+    }
+
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Score one answer and find which of its tokens matched expected ones.
+ *
+ * @param assessor The assessor.
+ * @param submission The answer and its expected tokens.
+ * @param lang The language the answer is written in.
+ * @param scratch Arena for scratch memory; the caller resets it.
+ * @param score Pointer to store the score.
+ * @param links Array of at least submission->expected_count entries to store the matches.
+ * @param link_count Pointer to store the number of links written.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode assessor_align(const Assessor *assessor, const AssessorSubmission *submission, Language lang, LimdyArena *scratch,
+                         AssessorScore *score, AlignmentLink *links, size_t *link_count)
+{
+    CHECK_NULL(assessor, ERROR_NULL_POINTER);
+    CHECK_NULL(submission, ERROR_NULL_POINTER);
+    CHECK_NULL(scratch, ERROR_NULL_POINTER);
+    CHECK_NULL(score, ERROR_NULL_POINTER);
+    CHECK_NULL(link_count, ERROR_NULL_POINTER);
+    if (submission->expected_count)
+    {
+        CHECK_NULL(links, ERROR_NULL_POINTER);
+    }
+
+    AssessorScratch memory;
+    ErrorCode error = reserve_scratch(submission, 1, true, scratch, &memory);
+    RETURN_IF_ERROR(error);
+
+    size_t blocks = memory.block_count;
+    size_t answer_count;
+    error = prepare_submission(assessor, submission, lang, &memory, blocks, &answer_count);
+    RETURN_IF_ERROR(error);
+    reset_state(memory.state, blocks);
+    advance_answer(submission, &memory, blocks, answer_count, memory.state, true);
+
+    // Walk back from the last cell along differences of the kept columns
+    size_t i = submission->expected_count;
+    size_t j = answer_count;
+    size_t count = 0;
+#define CELL(row, column) column_distance(memory.state + (column) * 2 * blocks, memory.state + (column) * 2 * blocks + blocks, row, column)
+    set_score(score, CELL(i, j), submission->expected_count, answer_count);
+    while (i > 0 && j > 0)
+    {
+        size_t distance = CELL(i, j);
+        const Token *expected = &submission->expected[i - 1];
+        const Token *span = &memory.spans[j - 1];
+        if (CELL(i - 1, j - 1) == distance &&
+            equal_folded(expected->text, expected->length, submission->answer + span->offset, span->length))
+        {
+            links[count++] = (AlignmentLink){(uint32_t)(i - 1), (uint32_t)(j - 1), 1.0f};
+            i--;
+            j--;
+        }
+        else if (CELL(i - 1, j) + 1 == distance)
+        {
+            i--;
+        }
+        else if (CELL(i, j - 1) + 1 == distance)
+        {
+            j--;
+        }
+        else
+        {
+            i--;
+            j--;
+        }
+    }
+#undef CELL
+
+    for (size_t left = 0, right = count; left + 1 < right; left++, right--)
+    {
+        AlignmentLink link = links[left];
+        links[left] = links[right - 1];
+        links[right - 1] = link;
+    }
+    *link_count = count;
+    return ERROR_SUCCESS;
+}
@@ -0,0 +1,567 @@
+/**
+ * @file banker.c
+ * @brief Implementation of the memory-mapped bank format.
+ *
+ * This file implements the interface defined in banker.h. The writer keeps
+ * every section in growable buffers and interns token texts through a hash
+ * table of string table offsets. The hash index is laid out only when the
+ * bank is written. The reader maps the whole file read-only, checks the
+ * header and section bounds once, and then serves every query by reading
+ * the records in place. Writing, mapping and the common header checks are
+ * shared with the snapshot image through limdy_image.h.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include "components/banker.h"
+#include "utils/limdy_utils.h"
+#include "utils/memory_pool.h"
+#include "utils/limdy_image.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define BANK_MAGIC "LIMDYBK1"
+#define BANK_MIN_INTERN_CAPACITY 64
+
+/**
+ * @brief Fixed header at the start of a bank file.
+ */
+typedef struct
+{
+    LimdyImageHeader image;
+    uint64_t element_count;
+    uint64_t element_offset;
+    uint64_t token_count;
+    uint64_t token_offset;
+    uint64_t string_bytes;
+    uint64_t string_offset;
+    uint64_t index_capacity; // Power of two, more than twice the element count
+    uint64_t index_offset;
+} BankHeader;
+
+typedef struct
+{
+    uint64_t hash;
+    uint32_t type;
+    uint32_t token_count;
+    uint64_t first_token;
+} BankElementRecord;
+
+typedef struct
+{
+    uint32_t string; // Offset of the text in the string table
+    uint32_t length;
+    TokenClassSet classes;
+} BankTokenRecord;
+
+// Slot of the writer's intern table; offset + 1 so that zeroed slots are empty
+typedef struct
+{
+    uint64_t hash;
+    uint32_t offset;
+    uint32_t length;
+} BankInternSlot;
+
+struct BankerWriter
+{
+    BankElementRecord *elements;
+    size_t element_count;
+    size_t element_capacity;
+    BankTokenRecord *tokens;
+    size_t token_count;
+    size_t token_capacity;
+    char *strings;
+    size_t string_bytes;
+    size_t string_capacity;
+    BankInternSlot *intern;
+    size_t intern_capacity; // Power of two, kept at most half full
+    size_t intern_count;
+};
+
+struct Banker
+{
+    LimdyImage image;
+    const BankHeader *header;
+    const BankElementRecord *elements;
+    const BankTokenRecord *tokens;
+    const char *strings;
+    const LimdyImageIndexEntry *index; // Slots name element positions + 1
+};
+
+static bool bank_header_valid(const void *image_header);
+
+static const LimdyImageFormat bank_format = {
+    .name = "bank",
+    .magic = BANK_MAGIC,
+    .version = LIMDY_BANKER_FORMAT_VERSION,
+    .header_size = sizeof(BankHeader),
+    .error_bad_format = LIMDY_BANKER_ERROR_BAD_FORMAT,
+    .error_version = LIMDY_BANKER_ERROR_VERSION,
+    .header_valid = bank_header_valid};
+
+static uint64_t string_hash(const char *text, size_t length)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)text[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static void intern_place(BankInternSlot *slots, size_t capacity, const BankInternSlot *slot)
+{
+    size_t mask = capacity - 1;
+    size_t position = slot->hash & mask;
+    while (slots[position].offset != 0)
+    {
+        position = (position + 1) & mask;
+    }
+    slots[position] = *slot;
+}
+
+static ErrorCode intern_grow(BankerWriter *writer)
+{
+    size_t capacity = writer->intern_capacity ? writer->intern_capacity * 2 : BANK_MIN_INTERN_CAPACITY;
+    BankInternSlot *slots = limdy_memory_pool_alloc(capacity * sizeof(BankInternSlot));
+    CHECK_NULL(slots, ERROR_MEMORY_ALLOCATION);
+    memset(slots, 0, capacity * sizeof(BankInternSlot));
+    for (size_t i = 0; i < writer->intern_capacity; i++)
+    {
+        if (writer->intern[i].offset != 0)
+        {
+            intern_place(slots, capacity, &writer->intern[i]);
+        }
+    }
+    limdy_memory_pool_free(writer->intern);
+    writer->intern = slots;
+    writer->intern_capacity = capacity;
+    return ERROR_SUCCESS;
+}
+
+// Stores the text in the string table unless an equal text is already there
+static ErrorCode intern_string(BankerWriter *writer, const char *text, size_t length, uint32_t *offset)
+{
+    uint64_t hash = string_hash(text, length);
+    size_t mask = writer->intern_capacity - 1;
+    for (size_t position = hash & mask; writer->intern[position].offset != 0; position = (position + 1) & mask)
+    {
+        const BankInternSlot *slot = &writer->intern[position];
+        if (slot->hash == hash && slot->length == length && memcmp(writer->strings + slot->offset - 1, text, length) == 0)
+        {
+            *offset = slot->offset - 1;
+            return ERROR_SUCCESS;
+        }
+    }
+
+    if (length >= UINT32_MAX || writer->string_bytes + length + 1 >= UINT32_MAX)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Bank string table is full");
+        return ERROR_INVALID_ARGUMENT;
+    }
+    if ((writer->intern_count + 1) * 2 > writer->intern_capacity)
+    {
+        RETURN_IF_ERROR(intern_grow(writer));
+    }
+    RETURN_IF_ERROR(limdy_memory_pool_reserve((void **)&writer->strings, &writer->string_capacity, writer->string_bytes + length + 1, 1));
+
+    *offset = (uint32_t)writer->string_bytes;
+    memcpy(writer->strings + writer->string_bytes, text, length);
+    writer->strings[writer->string_bytes + length] = '\0';
+    writer->string_bytes += length + 1;
+
+    BankInternSlot slot = {.hash = hash, .offset = *offset + 1, .length = (uint32_t)length};
+    intern_place(writer->intern, writer->intern_capacity, &slot);
+    writer->intern_count++;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Create an empty bank writer.
+ *
+ * @param writer Pointer to store the created writer.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode banker_writer_create(BankerWriter **writer)
+{
+    CHECK_NULL(writer, ERROR_NULL_POINTER);
+
+    BankerWriter *new_writer = limdy_memory_pool_alloc(sizeof(BankerWriter));
+    CHECK_NULL(new_writer, ERROR_MEMORY_ALLOCATION);
+    memset(new_writer, 0, sizeof(BankerWriter));
+
+    ErrorCode error = intern_grow(new_writer);
+    if (error != ERROR_SUCCESS)
+    {
+        limdy_memory_pool_free(new_writer);
+        return error;
+    }
+
+    *writer = new_writer;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Add a copy of an element to the bank being written.
+ *
+ * @param writer The writer.
+ * @param element The element to add.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode banker_writer_add(BankerWriter *writer, const LinguisticElement *element)
+{
+    CHECK_NULL(writer, ERROR_NULL_POINTER);
+    CHECK_NULL(element, ERROR_NULL_POINTER);
+    if (element->token_count > 0 && !element->tokens)
+    {
+        LOG_ERROR(ERROR_NULL_POINTER, "Element has tokens but no token array");
+        return ERROR_NULL_POINTER;
+    }
+
+    if (element->token_count >= UINT32_MAX)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Element does not fit in a bank");
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    RETURN_IF_ERROR(limdy_memory_pool_reserve((void **)&writer->elements, &writer->element_capacity, writer->element_count + 1,
+                                  sizeof(BankElementRecord)));
+    RETURN_IF_ERROR(limdy_memory_pool_reserve((void **)&writer->tokens, &writer->token_capacity, writer->token_count + element->token_count,
+                                  sizeof(BankTokenRecord)));
+
+    // Strings interned by a failed addition stay in the table, which only costs their bytes
+    size_t token_count = writer->token_count;
+    for (size_t i = 0; i < element->token_count; i++)
+    {
+        const Token *token = &element->tokens[i];
+        BankTokenRecord *record = &writer->tokens[token_count + i];
+        RETURN_IF_ERROR(intern_string(writer, token->text ? token->text : "", token->text ? token->length : 0, &record->string));
+        record->length = token->text ? token->length : 0;
+        record->classes = token->classes;
+    }
+
+    BankElementRecord *record = &writer->elements[writer->element_count++];
+    record->hash = element->hash;
+    record->type = (uint32_t)element->type;
+    record->token_count = (uint32_t)element->token_count;
+    record->first_token = token_count;
+    writer->token_count = token_count + element->token_count;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Add a copy of every element of a map to the bank being written.
+ *
+ * @param writer The writer.
+ * @param map The map whose elements to add.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode banker_writer_add_map(BankerWriter *writer, LinguisticElementMap *map)
+{
+    CHECK_NULL(writer, ERROR_NULL_POINTER);
+    CHECK_NULL(map, ERROR_NULL_POINTER);
+
+    size_t slot_count = linguistic_element_map_slot_count(map);
+    for (size_t i = 0; i < slot_count; i++)
+    {
+        ExtendedLinguisticElement *element = linguistic_element_map_slot(map, i);
+        if (element)
+        {
+            RETURN_IF_ERROR(banker_writer_add(writer, &element->base));
+        }
+    }
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Write the bank to a file.
+ *
+ * @param writer The writer.
+ * @param path Path of the bank file.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode banker_writer_write(BankerWriter *writer, const char *path)
+{
+    CHECK_NULL(writer, ERROR_NULL_POINTER);
+    CHECK_NULL(path, ERROR_NULL_POINTER);
+
+    // Elements are placed in order, so equal hashes are probed in the order they were added
+    size_t index_capacity = 0;
+    LimdyImageIndexEntry *index =
+        limdy_image_build_index(writer->elements, writer->element_count, sizeof(BankElementRecord), &index_capacity);
+    CHECK_NULL(index, ERROR_MEMORY_ALLOCATION);
+
+    BankHeader header = {
+        .element_count = writer->element_count,
+        .token_count = writer->token_count,
+        .string_bytes = writer->string_bytes,
+        .index_capacity = index_capacity};
+    header.element_offset = limdy_image_align(sizeof(BankHeader));
+    header.token_offset = limdy_image_align(header.element_offset + writer->element_count * sizeof(BankElementRecord));
+    header.string_offset = limdy_image_align(header.token_offset + writer->token_count * sizeof(BankTokenRecord));
+    header.index_offset = limdy_image_align(header.string_offset + writer->string_bytes);
+
+    const LimdyImageSection sections[] = {
+        {header.element_offset, writer->elements, writer->element_count * sizeof(BankElementRecord)},
+        {header.token_offset, writer->tokens, writer->token_count * sizeof(BankTokenRecord)},
+        {header.string_offset, writer->strings, writer->string_bytes},
+        {header.index_offset, index, index_capacity * sizeof(LimdyImageIndexEntry)}};
+    ErrorCode error = limdy_image_write(&bank_format, path, &header.image, sections, sizeof(sections) / sizeof(sections[0]));
+    limdy_memory_pool_free(index);
+    return error;
+}
+
+/**
+ * @brief Destroy a bank writer.
+ *
+ * @param writer The writer, or NULL.
+ */
+void banker_writer_destroy(BankerWriter *writer)
+{
+    if (!writer)
+    {
+        return;
+    }
+    limdy_memory_pool_free(writer->elements);
+    limdy_memory_pool_free(writer->tokens);
+    limdy_memory_pool_free(writer->strings);
+    limdy_memory_pool_free(writer->intern);
+    limdy_memory_pool_free(writer);
+}
+
+// Checks the section bounds of a header whose common fields are valid
+static bool bank_header_valid(const void *image_header)
+{
+    const BankHeader *header = image_header;
+    return limdy_image_section_fits(&header->image, header->element_offset, header->element_count, sizeof(BankElementRecord)) &&
+           limdy_image_section_fits(&header->image, header->token_offset, header->token_count, sizeof(BankTokenRecord)) &&
+           limdy_image_section_fits(&header->image, header->string_offset, header->string_bytes, 1) &&
+           limdy_image_index_fits(&header->image, header->index_offset, header->index_capacity, header->element_count);
+}
+
+/**
+ * @brief Map a bank file for reading.
+ *
+ * @param path Path of the bank file.
+ * @param bank Pointer to store the opened bank.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode banker_open(const char *path, Banker **bank)
+{
+    CHECK_NULL(path, ERROR_NULL_POINTER);
+    CHECK_NULL(bank, ERROR_NULL_POINTER);
+
+    LimdyImage image;
+    RETURN_IF_ERROR(limdy_image_map(&bank_format, path, &image));
+
+    Banker *new_bank = limdy_memory_pool_alloc(sizeof(Banker));
+    if (!new_bank)
+    {
+        limdy_image_unmap(&image);
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate bank");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    const char *base = image.mapping;
+    const BankHeader *header = image.mapping;
+    new_bank->image = image;
+    new_bank->header = header;
+    new_bank->elements = (const BankElementRecord *)(base + header->element_offset);
+    new_bank->tokens = (const BankTokenRecord *)(base + header->token_offset);
+    new_bank->strings = base + header->string_offset;
+    new_bank->index = (const LimdyImageIndexEntry *)(base + header->index_offset);
+
+    // Lookups start with a random probe into the index
+    limdy_image_will_need(&new_bank->image, header->index_offset, header->index_capacity * sizeof(LimdyImageIndexEntry));
+
+    *bank = new_bank;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Unmap a bank.
+ *
+ * @param bank The bank, or NULL.
+ */
+void banker_close(Banker *bank)
+{
+    if (!bank)
+    {
+        return;
+    }
+    limdy_image_unmap(&bank->image);
+    limdy_memory_pool_free(bank);
+}
+
+/**
+ * @brief Get the number of elements in a bank.
+ *
+ * @param bank The bank.
+ * @return The number of elements.
+ */
+size_t banker_element_count(const Banker *bank)
+{
+    return bank ? bank->header->element_count : 0;
+}
+
+// Fills in an element, checking that its tokens lie within the token section
+static bool read_element(const Banker *bank, size_t index, BankerElement *element)
+{
+    const BankElementRecord *record = &bank->elements[index];
+    if (record->first_token > bank->header->token_count || record->token_count > bank->header->token_count - record->first_token)
+    {
+        return false;
+    }
+    element->bank = bank;
+    element->type = (LinguisticElementType)record->type;
+    element->hash = record->hash;
+    element->token_count = record->token_count;
+    element->first_token = record->first_token;
+    return true;
+}
+
+/**
+ * @brief Get an element by its position.
+ *
+ * @param bank The bank.
+ * @param index Position of the element.
+ * @param element Pointer to store the element.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode banker_element_at(const Banker *bank, size_t index, BankerElement *element)
+{
+    CHECK_NULL(bank, ERROR_NULL_POINTER);
+    CHECK_NULL(element, ERROR_NULL_POINTER);
+    if (index >= bank->header->element_count)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Bank element %zu out of range", index);
+        return ERROR_INVALID_ARGUMENT;
+    }
+    if (!read_element(bank, index, element))
+    {
+        LOG_ERROR(LIMDY_BANKER_ERROR_BAD_FORMAT, "Bank element %zu is damaged", index);
+        return LIMDY_BANKER_ERROR_BAD_FORMAT;
+    }
+    return ERROR_SUCCESS;
+}
+
+// Reads a token, checking its text against the string table
+static bool read_token(const Banker *bank, size_t index, BankerToken *token)
+{
+    const BankTokenRecord *record = &bank->tokens[index];
+    const BankHeader *header = bank->header;
+    if ((uint64_t)record->string + record->length >= header->string_bytes || bank->strings[record->string + record->length] != '\0')
+    {
+        return false;
+    }
+    token->text = bank->strings + record->string;
+    token->length = record->length;
+    token->classes = record->classes;
+    return true;
+}
+
+static bool tokens_match(const BankerElement *element, const Token *tokens, size_t token_count)
+{
+    if (element->token_count != token_count)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < token_count; i++)
+    {
+        BankerToken stored;
+        if (!read_token(element->bank, element->first_token + i, &stored) || stored.length != tokens[i].length ||
+            stored.classes != tokens[i].classes || memcmp(stored.text, tokens[i].text, stored.length) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Probes the index for hash, stopping at the first element accepted by the token comparison, if any
+static bool bank_lookup(const Banker *bank, uint64_t hash, const Token *tokens, size_t token_count, BankerElement *element)
+{
+    const BankHeader *header = bank->header;
+    size_t mask = header->index_capacity - 1;
+    // The index is never full, but a damaged one might be; at most capacity probes
+    for (size_t probe = 0, position = hash & mask; probe <= mask && bank->index[position].record != 0;
+         probe++, position = (position + 1) & mask)
+    {
+        const LimdyImageIndexEntry *entry = &bank->index[position];
+        if (entry->hash != hash || entry->record > header->element_count)
+        {
+            continue;
+        }
+        BankerElement candidate;
+        if (read_element(bank, entry->record - 1, &candidate) && (!tokens || tokens_match(&candidate, tokens, token_count)))
+        {
+            *element = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Find an element by hash.
+ *
+ * @param bank The bank.
+ * @param hash The hash to look up.
+ * @param element Pointer to store the element.
+ * @return true if an element was found.
+ */
+bool banker_find(const Banker *bank, uint64_t hash, BankerElement *element)
+{
+    if (!bank || !element)
+    {
+        return false;
+    }
+    return bank_lookup(bank, hash, NULL, 0, element);
+}
+
+/**
+ * @brief Find the element made of exactly these tokens.
+ *
+ * @param bank The bank.
+ * @param hash hash_linguistic_element() of the tokens.
+ * @param tokens The tokens to match.
+ * @param token_count Number of tokens.
+ * @param element Pointer to store the element.
+ * @return true if an element was found.
+ */
+bool banker_find_tokens(const Banker *bank, uint64_t hash, const Token *tokens, size_t token_count, BankerElement *element)
+{
+    if (!bank || !element || (!tokens && token_count > 0))
+    {
+        return false;
+    }
+    static const Token no_tokens[1];
+    return bank_lookup(bank, hash, tokens ? tokens : no_tokens, token_count, element);
+}
+
+/**
+ * @brief Read one token of an element.
+ *
+ * @param element The element.
+ * @param index Position of the token.
+ * @param token Pointer to store the token.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode banker_element_token(const BankerElement *element, size_t index, BankerToken *token)
+{
+    CHECK_NULL(element, ERROR_NULL_POINTER);
+    CHECK_NULL(element->bank, ERROR_NULL_POINTER);
+    CHECK_NULL(token, ERROR_NULL_POINTER);
+    if (index >= element->token_count)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Bank token %zu out of range", index);
+        return ERROR_INVALID_ARGUMENT;
+    }
+    if (!read_token(element->bank, element->first_token + index, token))
+    {
+        LOG_ERROR(LIMDY_BANKER_ERROR_BAD_FORMAT, "Bank token %zu is damaged", index);
+        return LIMDY_BANKER_ERROR_BAD_FORMAT;
+    }
+    return ERROR_SUCCESS;
+}
@@ -0,0 +1,331 @@
+/**
+ * @file convor.c
+ * @brief Implementation of the conversation orchestrator.
+ *
+ * This file implements the interface defined in convor.h. A turn is
+ * tokenized into the conversation's arena, translated into it as well and
+ * aligned against its own tokens, and only then appended to the persistent
+ * result, so a failed turn leaves nothing behind but arena bytes. Only a
+ * failure while the maps are being updated cannot be undone; it marks the
+ * conversation incomplete. The result's token array grows by doubling;
+ * when it moves, the occurrences of the vocab and phrase maps are rebased
+ * onto the new array, which costs amortized O(1) per token. Utterances, token text,
+ * translations and elements live in the arena and never move.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-15
+ */
+
+#include "components/convor.h"
+#include "utils/limdy_utils.h"
+#include "utils/memory_pool.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct Conversation
+{
+    TranslatorAligner *ta;
+    Language lang;
+    const char *source_lang;
+    const char *target_lang;
+    LimdyArena arena;              // Utterances, their tokens, translations and elements
+    RendererResult result;         // Tokens of all turns, on the heap so they can grow, and their maps
+    size_t token_capacity;         // Tokens result.tokens has room for
+    size_t next_offset;            // Offset the next utterance's tokens start at
+    PhraseExtractorState *phrases; // Phrase counts of all turns so far
+    ConversationTurn *turns;
+    size_t turn_count;
+    size_t turn_capacity;
+    bool incomplete;               // A failed turn left the maps part-updated
+};
+
+ErrorCode conversation_create(TranslatorAligner *ta, Language lang, const char *source_lang, const char *target_lang,
+                              Conversation **conversation)
+{
+    CHECK_NULL(ta, ERROR_NULL_POINTER);
+    CHECK_NULL(source_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(target_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(conversation, ERROR_NULL_POINTER);
+    if (!ta->translator || !ta->aligner || !ta->aligner->renderer)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Conversations need a translator and an aligner with a renderer");
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    Conversation *created = limdy_memory_pool_alloc(sizeof(Conversation));
+    if (!created)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate conversation");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    memset(created, 0, sizeof(Conversation));
+    created->ta = ta;
+    created->lang = lang;
+    created->result.arena = &created->arena;
+
+    ErrorCode error = limdy_arena_init(&created->arena, 0);
+    if (error == ERROR_SUCCESS)
+    {
+        created->source_lang = limdy_arena_strndup(&created->arena, source_lang, strlen(source_lang));
+        created->target_lang = limdy_arena_strndup(&created->arena, target_lang, strlen(target_lang));
+        created->result.tokens = limdy_memory_pool_alloc(LIMDY_CONVOR_INITIAL_TOKENS * sizeof(Token));
+        created->token_capacity = LIMDY_CONVOR_INITIAL_TOKENS;
+        if (!created->source_lang || !created->target_lang || !created->result.tokens)
+        {
+            LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate conversation state");
+            error = ERROR_MEMORY_ALLOCATION;
+        }
+    }
+    if (error == ERROR_SUCCESS)
+    {
+        error = linguistic_element_map_init_arena(&created->result.vocab_map, LIMDY_CONVOR_INITIAL_TOKENS, &created->arena);
+    }
+    if (error == ERROR_SUCCESS)
+    {
+        error = linguistic_element_map_init_arena(&created->result.phrase_map, LIMDY_CONVOR_INITIAL_TOKENS / 2, &created->arena);
+    }
+    if (error == ERROR_SUCCESS)
+    {
+        error = linguistic_element_map_init_arena(&created->result.syntax_map, LIMDY_CONVOR_INITIAL_TOKENS / 2, &created->arena);
+    }
+    if (error == ERROR_SUCCESS)
+    {
+        error = phrase_extractor_state_create(&ta->aligner->renderer->phrase_config, &created->phrases);
+    }
+    if (error != ERROR_SUCCESS)
+    {
+        conversation_destroy(created);
+        return error;
+    }
+
+    *conversation = created;
+    return ERROR_SUCCESS;
+}
+
+void conversation_destroy(Conversation *conversation)
+{
+    if (!conversation)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < conversation->turn_count; i++)
+    {
+        free_alignment_result(&conversation->turns[i].alignment);
+    }
+    limdy_memory_pool_free(conversation->turns);
+    phrase_extractor_state_destroy(conversation->phrases);
+    linguistic_element_map_free(&conversation->result.vocab_map);
+    linguistic_element_map_free(&conversation->result.phrase_map);
+    linguistic_element_map_free(&conversation->result.syntax_map);
+    limdy_memory_pool_free(conversation->result.tokens);
+    limdy_arena_release(&conversation->arena);
+    limdy_memory_pool_free(conversation);
+}
+
+/**
+ * @brief Points the occurrences of a map at the moved token array.
+ */
+static void map_rebase(LinguisticElementMap *map, Token *tokens, uintptr_t old_tokens)
+{
+    size_t slots = linguistic_element_map_slot_count(map);
+    for (size_t slot = 0; slot < slots; slot++)
+    {
+        ExtendedLinguisticElement *element = linguistic_element_map_slot(map, slot);
+        for (size_t i = 0; element && i < element->occurrence_count; i++)
+        {
+            element->occurrences[i] = tokens + ((uintptr_t)element->occurrences[i] - old_tokens) / sizeof(Token);
+        }
+    }
+}
+
+/**
+ * @brief Points the occurrences of the vocab and phrase maps at the moved token array.
+ */
+static void conversation_rebase(Conversation *conversation, uintptr_t old_tokens)
+{
+    map_rebase(&conversation->result.vocab_map, conversation->result.tokens, old_tokens);
+    map_rebase(&conversation->result.phrase_map, conversation->result.tokens, old_tokens);
+}
+
+/**
+ * @brief Makes room for @p added more tokens in the result, rebasing the occurrences if the tokens move.
+ */
+static ErrorCode conversation_reserve_tokens(Conversation *conversation, size_t added)
+{
+    size_t needed = conversation->result.token_count + added;
+    if (needed <= conversation->token_capacity)
+    {
+        return ERROR_SUCCESS;
+    }
+
+    size_t capacity = conversation->token_capacity;
+    while (capacity < needed)
+    {
+        capacity *= 2;
+    }
+    uintptr_t old_tokens = (uintptr_t)conversation->result.tokens;
+    Token *tokens = limdy_memory_pool_realloc(conversation->result.tokens, capacity * sizeof(Token));
+    if (!tokens)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to grow conversation tokens");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    conversation->result.tokens = tokens;
+    conversation->token_capacity = capacity;
+    if ((uintptr_t)tokens != old_tokens)
+    {
+        conversation_rebase(conversation, old_tokens);
+    }
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Makes room for one more turn.
+ */
+static ErrorCode conversation_reserve_turn(Conversation *conversation)
+{
+    if (conversation->turn_count < conversation->turn_capacity)
+    {
+        return ERROR_SUCCESS;
+    }
+
+    size_t capacity = conversation->turn_capacity ? conversation->turn_capacity * 2 : 16;
+    ConversationTurn *turns = limdy_memory_pool_realloc(conversation->turns, capacity * sizeof(ConversationTurn));
+    if (!turns)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to grow conversation turns");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    conversation->turns = turns;
+    conversation->turn_capacity = capacity;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Appends a turn's tokens to the result, which has room for them, and records their vocab and phrases.
+ *
+ * Vocab is recorded the way renderer_extract_elements() does, so the maps
+ * match rendering the whole conversation at once.
+ */
+static ErrorCode conversation_append(Conversation *conversation, const RendererResult *spoken)
+{
+    RendererResult *result = &conversation->result;
+    size_t first = result->token_count;
+    if (spoken->token_count > 0)
+    {
+        memcpy(&result->tokens[first], spoken->tokens, spoken->token_count * sizeof(Token));
+    }
+    result->token_count += spoken->token_count;
+
+    for (size_t i = first; i < result->token_count; i++)
+    {
+        RETURN_IF_ERROR(linguistic_element_map_record(&result->vocab_map, ELEMENT_VOCAB, hash_linguistic_element(&result->tokens[i], 1),
+                                                      &result->tokens[i], 1));
+    }
+
+    return phrase_extractor_extract_more(conversation->phrases, result->tokens, first, spoken->token_count, &result->phrase_map);
+}
+
+ErrorCode conversation_add_turn(Conversation *conversation, const char *utterance, TranslationPartialFn partial, void *context)
+{
+    CHECK_NULL(conversation, ERROR_NULL_POINTER);
+    CHECK_NULL(utterance, ERROR_NULL_POINTER);
+    if (conversation->incomplete)
+    {
+        LOG_ERROR(LIMDY_CONVOR_ERROR_INCOMPLETE, "A failed turn left the conversation incomplete");
+        return LIMDY_CONVOR_ERROR_INCOMPLETE;
+    }
+
+    size_t length = strlen(utterance);
+    if (length >= LIMDY_TOKEN_MAX_TEXT_LENGTH - conversation->next_offset)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Utterance of %zu bytes makes the conversation too long", length);
+        return ERROR_INVALID_ARGUMENT;
+    }
+    RETURN_IF_ERROR(conversation_reserve_turn(conversation));
+
+    Renderer *renderer = conversation->ta->aligner->renderer;
+    char *text = limdy_arena_strndup(&conversation->arena, utterance, length);
+    if (!text)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to copy utterance");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    // Tokenize only the new utterance, into the arena so its tokens' text stays put
+    RendererResult spoken = {.arena = &conversation->arena};
+    RETURN_IF_ERROR(renderer_tokenize(renderer, text, conversation->lang, &spoken));
+    if (spoken.token_count > 0 && renderer->classification_service && renderer->classification_service->classify)
+    {
+        RETURN_IF_ERROR(renderer_classify(renderer, &spoken));
+    }
+    for (size_t i = 0; i < spoken.token_count; i++)
+    {
+        spoken.tokens[i].offset += conversation->next_offset;
+    }
+    RETURN_IF_ERROR(conversation_reserve_tokens(conversation, spoken.token_count));
+
+    TranslationResult translation;
+    RETURN_IF_ERROR(allocate_translation_result_from_arena(&translation, &conversation->arena));
+    ErrorCode error = partial ? translator_translate_stream(conversation->ta->translator, text, conversation->source_lang,
+                                                            conversation->target_lang, partial, context, &translation)
+                              : translator_translate(conversation->ta->translator, text, conversation->source_lang,
+                                                     conversation->target_lang, &translation);
+    if (error != ERROR_SUCCESS)
+    {
+        return error;
+    }
+
+    ConversationTurn *turn = &conversation->turns[conversation->turn_count];
+    *turn = (ConversationTurn){
+        .text = text,
+        .first_token = conversation->result.token_count,
+        .token_count = spoken.token_count,
+        .translated_text = translation.translated_text};
+    error = aligner_align_tokens_result(conversation->ta->aligner, &spoken, translation.translated_text, &translation.attention,
+                                        &turn->alignment);
+    // The translated text stays in the arena
+    free_translation_result(&translation);
+    if (error != ERROR_SUCCESS)
+    {
+        return error;
+    }
+
+    // Only the turn's own tokens are extracted; earlier counts carry over
+    error = conversation_append(conversation, &spoken);
+    if (error != ERROR_SUCCESS)
+    {
+        // The maps cannot be rolled back, so only the tokens and the turn are
+        conversation->result.token_count = turn->first_token;
+        free_alignment_result(&turn->alignment);
+        conversation->incomplete = true;
+        return error;
+    }
+    conversation->turn_count++;
+    conversation->next_offset += length + 1;
+    return ERROR_SUCCESS;
+}
+
+size_t conversation_turn_count(const Conversation *conversation)
+{
+    return conversation ? conversation->turn_count : 0;
+}
+
+const ConversationTurn *conversation_turn(const Conversation *conversation, size_t index)
+{
+    if (!conversation || index >= conversation->turn_count)
+    {
+        return NULL;
+    }
+    return &conversation->turns[index];
+}
+
+const RendererResult *conversation_result(const Conversation *conversation)
+{
+    return conversation ? &conversation->result : NULL;
+}
@@ -0,0 +1,645 @@
+/**
+ * @file exerciser.c
+ * @brief Implementation of batch exercise generation.
+ *
+ * This file implements the interface defined in exerciser.h. Every
+ * exercise is produced by one routine that writes through a TextWriter.
+ * Without a buffer the writer only counts bytes, so measuring a chunk and
+ * writing it run the same code and cannot disagree about sizes. Chunks
+ * learn where their exercises, hashes and text go from a prefix sum over
+ * the measured sizes. That sum is the only step that runs on the calling
+ * thread alone.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include "components/exerciser.h"
+#include "utils/limdy_utils.h"
+#include "utils/memory_pool.h"
+#include "utils/thread_pool.h"
+#include <stdalign.h>
+#include <string.h>
+
+#define BODY_PLACEHOLDER "{body}"
+#define BLANK "____"
+#define REORDER_SEPARATOR " / "
+#define LIST_SEPARATOR ", "
+#define MATCHING_WORDS "Words: "
+
+typedef enum
+{
+    SEGMENT_LITERAL,
+    SEGMENT_BODY
+} TemplateSegmentKind;
+
+typedef struct
+{
+    TemplateSegmentKind kind;
+    size_t offset; // Literal: position in the template's literal text
+    size_t length;
+} TemplateSegment;
+
+struct ExerciseTemplate
+{
+    ExerciseType type;
+    size_t context_tokens;
+    size_t group_size;
+    TemplateSegment *segments;
+    size_t segment_count;
+    const char *literals;
+};
+
+struct Exerciser
+{
+    LimdyThreadPool *workers; // NULL to generate on the calling thread
+};
+
+/**
+ * @brief A run of map slots of one request; measured first, then written.
+ */
+typedef struct
+{
+    const ExerciserRequest *request;
+    size_t request_index;
+    size_t first_slot;
+    size_t end_slot;
+    size_t exercise_count; // Measured sizes
+    size_t hash_count;
+    size_t text_bytes;
+    size_t first_exercise; // Where the chunk writes, from the prefix sum
+    size_t first_hash;
+    size_t text_offset;
+} ExerciserChunk;
+
+typedef struct
+{
+    ExerciserChunk *chunks;
+    Exercise *exercises; // NULL while measuring
+    uint64_t *hashes;
+    char *text;
+} ExerciserPass;
+
+// Appends to data, or only counts the bytes when data is NULL
+typedef struct
+{
+    char *data;
+    size_t length;
+} TextWriter;
+
+static inline void writer_put(TextWriter *writer, const char *text, size_t length)
+{
+    if (writer->data)
+    {
+        memcpy(writer->data + writer->length, text, length);
+    }
+    writer->length += length;
+}
+
+static void writer_put_number(TextWriter *writer, size_t number)
+{
+    char digits[20];
+    size_t count = 0;
+    do
+    {
+        digits[sizeof(digits) - ++count] = (char)('0' + number % 10);
+        number /= 10;
+    } while (number);
+    writer_put(writer, digits + sizeof(digits) - count, count);
+}
+
+static void writer_put_tokens(TextWriter *writer, const Token *tokens, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i > 0)
+        {
+            writer_put(writer, " ", 1);
+        }
+        writer_put(writer, tokens[i].text, tokens[i].length);
+    }
+}
+
+static inline uint64_t next_random(uint64_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Fills order with a permutation of [0, count) seeded by seed; never the identity when count > 1
+static void shuffle_order(uint64_t seed, uint8_t *order, size_t count)
+{
+    uint64_t state = seed | 1;
+    for (size_t i = 0; i < count; i++)
+    {
+        order[i] = (uint8_t)i;
+    }
+    for (size_t i = count; i > 1; i--)
+    {
+        size_t j = next_random(&state) % i;
+        uint8_t swap = order[i - 1];
+        order[i - 1] = order[j];
+        order[j] = swap;
+    }
+
+    bool identity = true;
+    for (size_t i = 0; i < count && identity; i++)
+    {
+        identity = order[i] == i;
+    }
+    if (identity && count > 1)
+    {
+        uint8_t first = order[0];
+        memmove(order, order + 1, count - 1);
+        order[count - 1] = first;
+    }
+}
+
+// Position of the token the element's own first token was copied from, found by offset; elements loaded
+// from a snapshot carry no occurrences, only such copies
+static bool copied_position(const RendererResult *result, const ExtendedLinguisticElement *element, size_t *position)
+{
+    const Token *first = &element->base.tokens[0];
+    size_t low = 0;
+    size_t high = result->token_count;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (result->tokens[middle].offset < first->offset)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    if (low == result->token_count || element->base.token_count > result->token_count - low)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < element->base.token_count; i++)
+    {
+        if (result->tokens[low + i].text != element->base.tokens[i].text)
+        {
+            return false;
+        }
+    }
+    *position = low;
+    return true;
+}
+
+// Position of the element's first occurrence among the result's tokens; false unless it lies within them
+static bool occurrence_position(const RendererResult *result, const ExtendedLinguisticElement *element, size_t *position)
+{
+    if (!result->tokens || element->base.token_count == 0)
+    {
+        return false;
+    }
+    if (element->occurrence_count == 0 || !element->occurrences || !element->occurrences[0])
+    {
+        return copied_position(result, element, position);
+    }
+
+    uintptr_t first = (uintptr_t)element->occurrences[0];
+    uintptr_t base = (uintptr_t)result->tokens;
+    if (first < base || first >= (uintptr_t)(result->tokens + result->token_count) || (first - base) % sizeof(Token) != 0)
+    {
+        return false;
+    }
+    size_t start = (first - base) / sizeof(Token);
+    if (element->base.token_count > result->token_count - start)
+    {
+        return false;
+    }
+    *position = start;
+    return true;
+}
+
+static void write_cloze_context(TextWriter *writer, const RendererResult *result, size_t position, size_t length, size_t context)
+{
+    size_t start = position > context ? position - context : 0;
+    size_t end = position + length + context < result->token_count ? position + length + context : result->token_count;
+    for (size_t i = start; i < position; i++)
+    {
+        writer_put(writer, result->tokens[i].text, result->tokens[i].length);
+        writer_put(writer, " ", 1);
+    }
+    writer_put(writer, BLANK, sizeof(BLANK) - 1);
+    for (size_t i = position + length; i < end; i++)
+    {
+        writer_put(writer, " ", 1);
+        writer_put(writer, result->tokens[i].text, result->tokens[i].length);
+    }
+}
+
+static void write_body(TextWriter *writer, const ExerciseTemplate *exercise_template, const RendererResult *result,
+                       ExtendedLinguisticElement *const *elements, const size_t *positions, size_t count)
+{
+    const LinguisticElement *element = &elements[0]->base;
+    uint8_t order[LIMDY_EXERCISER_MAX_REORDER_TOKENS > LIMDY_EXERCISER_MAX_GROUP_SIZE ? LIMDY_EXERCISER_MAX_REORDER_TOKENS
+                                                                                        : LIMDY_EXERCISER_MAX_GROUP_SIZE];
+    switch (exercise_template->type)
+    {
+    case EXERCISE_CLOZE:
+        write_cloze_context(writer, result, positions[0], element->token_count, exercise_template->context_tokens);
+        break;
+    case EXERCISE_REORDERING:
+        shuffle_order(element->hash, order, element->token_count);
+        for (size_t i = 0; i < element->token_count; i++)
+        {
+            if (i > 0)
+            {
+                writer_put(writer, REORDER_SEPARATOR, sizeof(REORDER_SEPARATOR) - 1);
+            }
+            writer_put(writer, element->tokens[order[i]].text, element->tokens[order[i]].length);
+        }
+        break;
+    case EXERCISE_MATCHING:
+        for (size_t i = 0; i < count; i++)
+        {
+            writer_put_number(writer, i + 1);
+            writer_put(writer, ". ", 2);
+            write_cloze_context(writer, result, positions[i], elements[i]->base.token_count, exercise_template->context_tokens);
+            writer_put(writer, "\n", 1);
+        }
+        writer_put(writer, MATCHING_WORDS, sizeof(MATCHING_WORDS) - 1);
+        shuffle_order(element->hash ^ count, order, count);
+        for (size_t i = 0; i < count; i++)
+        {
+            if (i > 0)
+            {
+                writer_put(writer, LIST_SEPARATOR, sizeof(LIST_SEPARATOR) - 1);
+            }
+            writer_put_tokens(writer, elements[order[i]]->base.tokens, elements[order[i]]->base.token_count);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void write_answer(TextWriter *writer, ExtendedLinguisticElement *const *elements, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i > 0)
+        {
+            writer_put(writer, LIST_SEPARATOR, sizeof(LIST_SEPARATOR) - 1);
+        }
+        writer_put_tokens(writer, elements[i]->base.tokens, elements[i]->base.token_count);
+    }
+}
+
+// Writes (or measures) one exercise made of count elements at the chunk's current position
+static void emit_exercise(ExerciserChunk *chunk, const ExerciserPass *pass, TextWriter *writer,
+                          ExtendedLinguisticElement *const *elements, const size_t *positions, size_t count)
+{
+    const ExerciseTemplate *exercise_template = chunk->request->exercise_template;
+    const RendererResult *result = chunk->request->result;
+
+    size_t prompt_start = writer->length;
+    for (size_t i = 0; i < exercise_template->segment_count; i++)
+    {
+        const TemplateSegment *segment = &exercise_template->segments[i];
+        if (segment->kind == SEGMENT_LITERAL)
+        {
+            writer_put(writer, exercise_template->literals + segment->offset, segment->length);
+        }
+        else
+        {
+            write_body(writer, exercise_template, result, elements, positions, count);
+        }
+    }
+    size_t prompt_length = writer->length - prompt_start;
+    writer_put(writer, "", 1);
+
+    size_t answer_start = writer->length;
+    write_answer(writer, elements, count);
+    size_t answer_length = writer->length - answer_start;
+    writer_put(writer, "", 1);
+
+    if (pass->exercises)
+    {
+        uint64_t *hashes = pass->hashes + chunk->first_hash + chunk->hash_count;
+        for (size_t i = 0; i < count; i++)
+        {
+            hashes[i] = elements[i]->base.hash;
+        }
+        pass->exercises[chunk->first_exercise + chunk->exercise_count] = (Exercise){
+            .type = exercise_template->type,
+            .request = chunk->request_index,
+            .element_hashes = hashes,
+            .element_count = count,
+            .prompt = writer->data + prompt_start,
+            .prompt_length = prompt_length,
+            .answer = writer->data + answer_start,
+            .answer_length = answer_length};
+    }
+    chunk->exercise_count++;
+    chunk->hash_count += count;
+}
+
+// Measures the chunk when the pass has no output, writes it otherwise; either way one pass over its slots
+static void generate_chunk(void *arg, size_t index)
+{
+    const ExerciserPass *pass = arg;
+    ExerciserChunk *chunk = &pass->chunks[index];
+    const ExerciseTemplate *exercise_template = chunk->request->exercise_template;
+    const RendererResult *result = chunk->request->result;
+    LinguisticElementMap *map = chunk->request->map;
+
+    TextWriter writer = {pass->exercises ? pass->text + chunk->text_offset : NULL, 0};
+    chunk->exercise_count = 0;
+    chunk->hash_count = 0;
+
+    ExtendedLinguisticElement *group[LIMDY_EXERCISER_MAX_GROUP_SIZE];
+    size_t positions[LIMDY_EXERCISER_MAX_GROUP_SIZE];
+    size_t group_count = 0;
+    for (size_t slot = chunk->first_slot; slot < chunk->end_slot; slot++)
+    {
+        ExtendedLinguisticElement *element = linguistic_element_map_slot(map, slot);
+        if (!element)
+        {
+            continue;
+        }
+
+        switch (exercise_template->type)
+        {
+        case EXERCISE_CLOZE:
+            if (occurrence_position(result, element, &positions[0]))
+            {
+                emit_exercise(chunk, pass, &writer, &element, positions, 1);
+            }
+            break;
+        case EXERCISE_REORDERING:
+            if (element->base.token_count > 1 && element->base.token_count <= LIMDY_EXERCISER_MAX_REORDER_TOKENS)
+            {
+                emit_exercise(chunk, pass, &writer, &element, positions, 1);
+            }
+            break;
+        case EXERCISE_MATCHING:
+            if (occurrence_position(result, element, &positions[group_count]))
+            {
+                group[group_count++] = element;
+                if (group_count == exercise_template->group_size)
+                {
+                    emit_exercise(chunk, pass, &writer, group, positions, group_count);
+                    group_count = 0;
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    // A short last group still makes an exercise if there is something to match
+    if (group_count > 1)
+    {
+        emit_exercise(chunk, pass, &writer, group, positions, group_count);
+    }
+    chunk->text_bytes = writer.length;
+}
+
+static ErrorCode run_pass(Exerciser *exerciser, ExerciserPass *pass, size_t chunk_count)
+{
+    if (exerciser->workers)
+    {
+        return limdy_thread_pool_parallel_for(exerciser->workers, chunk_count, generate_chunk, pass);
+    }
+    for (size_t i = 0; i < chunk_count; i++)
+    {
+        generate_chunk(pass, i);
+    }
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Compile a template.
+ *
+ * @param config The template settings.
+ * @param exercise_template Pointer to store the compiled template.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode exercise_template_compile(const ExerciseTemplateConfig *config, ExerciseTemplate **exercise_template)
+{
+    CHECK_NULL(config, ERROR_NULL_POINTER);
+    CHECK_NULL(config->pattern, ERROR_NULL_POINTER);
+    CHECK_NULL(exercise_template, ERROR_NULL_POINTER);
+    if ((unsigned)config->type >= EXERCISE_TYPE_COUNT)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Invalid exercise type %d", (int)config->type);
+        return ERROR_INVALID_ARGUMENT;
+    }
+    size_t group_size = config->group_size ? config->group_size : LIMDY_EXERCISER_GROUP_SIZE;
+    if (group_size < 2 || group_size > LIMDY_EXERCISER_MAX_GROUP_SIZE)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Matching groups of %zu elements are not supported", group_size);
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    // No more segments than bytes, no more literal bytes than the pattern has
+    size_t pattern_length = strlen(config->pattern);
+    size_t size = sizeof(ExerciseTemplate) + (pattern_length + 1) * sizeof(TemplateSegment) + pattern_length + 1;
+    ExerciseTemplate *compiled = limdy_memory_pool_alloc(size);
+    CHECK_NULL(compiled, ERROR_MEMORY_ALLOCATION);
+    compiled->type = config->type;
+    compiled->context_tokens = config->context_tokens ? config->context_tokens : LIMDY_EXERCISER_CONTEXT_TOKENS;
+    compiled->group_size = group_size;
+    compiled->segments = (TemplateSegment *)(compiled + 1);
+    compiled->segment_count = 0;
+    char *literals = (char *)(compiled->segments + pattern_length + 1);
+    compiled->literals = literals;
+
+    size_t literal_bytes = 0;
+    const char *pattern = config->pattern;
+    for (size_t i = 0; i < pattern_length;)
+    {
+        if (pattern[i] == '{' && strncmp(pattern + i, BODY_PLACEHOLDER, sizeof(BODY_PLACEHOLDER) - 1) == 0)
+        {
+            compiled->segments[compiled->segment_count++] = (TemplateSegment){.kind = SEGMENT_BODY};
+            i += sizeof(BODY_PLACEHOLDER) - 1;
+            continue;
+        }
+        if (pattern[i] == '{' && pattern[i + 1] != '{')
+        {
+            limdy_memory_pool_free(compiled);
+            LOG_ERROR(LIMDY_EXERCISER_ERROR_BAD_TEMPLATE, "Unknown placeholder at %zu in template \"%s\"", i, pattern);
+            return LIMDY_EXERCISER_ERROR_BAD_TEMPLATE;
+        }
+
+        // Extend the current literal, or start one
+        TemplateSegment *last = compiled->segment_count ? &compiled->segments[compiled->segment_count - 1] : NULL;
+        if (!last || last->kind != SEGMENT_LITERAL)
+        {
+            last = &compiled->segments[compiled->segment_count++];
+            *last = (TemplateSegment){.kind = SEGMENT_LITERAL, .offset = literal_bytes};
+        }
+        literals[literal_bytes++] = pattern[i];
+        last->length++;
+        i += pattern[i] == '{' ? 2 : 1;
+    }
+    literals[literal_bytes] = '\0';
+
+    *exercise_template = compiled;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Destroy a compiled template.
+ *
+ * @param exercise_template The template, or NULL.
+ */
+void exercise_template_destroy(ExerciseTemplate *exercise_template)
+{
+    if (exercise_template)
+    {
+        limdy_memory_pool_free(exercise_template);
+    }
+}
+
+/**
+ * @brief Create an exercise generator.
+ *
+ * @param thread_count Number of workers, 0 for one per online CPU, or 1 to generate on the calling thread only.
+ * @param exerciser Pointer to store the created generator.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode exerciser_create(size_t thread_count, Exerciser **exerciser)
+{
+    CHECK_NULL(exerciser, ERROR_NULL_POINTER);
+
+    Exerciser *new_exerciser = limdy_memory_pool_alloc(sizeof(Exerciser));
+    CHECK_NULL(new_exerciser, ERROR_MEMORY_ALLOCATION);
+    new_exerciser->workers = NULL;
+
+    if (thread_count != 1)
+    {
+        ErrorCode error = limdy_thread_pool_create(thread_count, &new_exerciser->workers);
+        if (error != ERROR_SUCCESS)
+        {
+            limdy_memory_pool_free(new_exerciser);
+            return error;
+        }
+    }
+
+    *exerciser = new_exerciser;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Destroy an exercise generator.
+ *
+ * @param exerciser The generator, or NULL.
+ */
+void exerciser_destroy(Exerciser *exerciser)
+{
+    if (!exerciser)
+    {
+        return;
+    }
+    if (exerciser->workers)
+    {
+        limdy_thread_pool_destroy(exerciser->workers);
+    }
+    limdy_memory_pool_free(exerciser);
+}
+
+/**
+ * @brief Generate the exercises of a batch of requests.
+ *
+ * @param exerciser The generator.
+ * @param requests The requests.
+ * @param request_count Number of requests.
+ * @param arena Arena to allocate the batch from.
+ * @param batch Pointer to store the batch.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode exerciser_generate(Exerciser *exerciser, const ExerciserRequest *requests, size_t request_count, LimdyArena *arena,
+                             ExerciseBatch *batch)
+{
+    CHECK_NULL(exerciser, ERROR_NULL_POINTER);
+    CHECK_NULL(arena, ERROR_NULL_POINTER);
+    CHECK_NULL(batch, ERROR_NULL_POINTER);
+    if (request_count > 0 && !requests)
+    {
+        LOG_ERROR(ERROR_NULL_POINTER, "Request array is NULL");
+        return ERROR_NULL_POINTER;
+    }
+
+    *batch = (ExerciseBatch){0};
+    size_t chunk_count = 0;
+    for (size_t i = 0; i < request_count; i++)
+    {
+        const ExerciserRequest *request = &requests[i];
+        if (!request->result || !request->map || !request->exercise_template)
+        {
+            LOG_ERROR(ERROR_NULL_POINTER, "Request %zu is incomplete", i);
+            return ERROR_NULL_POINTER;
+        }
+        size_t slot_count = linguistic_element_map_slot_count(request->map);
+        chunk_count += (slot_count + LIMDY_EXERCISER_CHUNK_SLOTS - 1) / LIMDY_EXERCISER_CHUNK_SLOTS;
+    }
+    if (chunk_count == 0)
+    {
+        return ERROR_SUCCESS;
+    }
+
+    ExerciserChunk *chunks = limdy_memory_pool_alloc(chunk_count * sizeof(ExerciserChunk));
+    CHECK_NULL(chunks, ERROR_MEMORY_ALLOCATION);
+    size_t chunk = 0;
+    for (size_t i = 0; i < request_count; i++)
+    {
+        size_t slot_count = linguistic_element_map_slot_count(requests[i].map);
+        for (size_t slot = 0; slot < slot_count; slot += LIMDY_EXERCISER_CHUNK_SLOTS)
+        {
+            size_t end = slot + LIMDY_EXERCISER_CHUNK_SLOTS < slot_count ? slot + LIMDY_EXERCISER_CHUNK_SLOTS : slot_count;
+            chunks[chunk++] = (ExerciserChunk){.request = &requests[i], .request_index = i, .first_slot = slot, .end_slot = end};
+        }
+    }
+
+    // Measure every chunk, then hand each its slices of one allocation
+    ExerciserPass pass = {.chunks = chunks};
+    ErrorCode error = run_pass(exerciser, &pass, chunk_count);
+    size_t exercise_count = 0;
+    size_t hash_count = 0;
+    size_t text_bytes = 0;
+    for (size_t i = 0; i < chunk_count; i++)
+    {
+        chunks[i].first_exercise = exercise_count;
+        chunks[i].first_hash = hash_count;
+        chunks[i].text_offset = text_bytes;
+        exercise_count += chunks[i].exercise_count;
+        hash_count += chunks[i].hash_count;
+        text_bytes += chunks[i].text_bytes;
+    }
+
+    if (error == ERROR_SUCCESS && exercise_count > 0)
+    {
+        size_t exercise_bytes = exercise_count * sizeof(Exercise);
+        char *block = limdy_arena_alloc_aligned(arena, exercise_bytes + hash_count * sizeof(uint64_t) + text_bytes, alignof(Exercise));
+        if (!block)
+        {
+            LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate %zu exercises", exercise_count);
+            error = ERROR_MEMORY_ALLOCATION;
+        }
+        else
+        {
+            pass.exercises = (Exercise *)block;
+            pass.hashes = (uint64_t *)(block + exercise_bytes);
+            pass.text = (char *)(pass.hashes + hash_count);
+            error = run_pass(exerciser, &pass, chunk_count);
+        }
+    }
+
+    limdy_memory_pool_free(chunks);
+    if (error != ERROR_SUCCESS)
+    {
+        return error;
+    }
+    batch->exercises = pass.exercises;
+    batch->exercise_count = exercise_count;
+    return ERROR_SUCCESS;
+}
@@ -1,236 +1,726 @@
 #include "linguistic_element.h"
+#include "limdy_metrics.h"
 #include <string.h>
-#include <pthread.h>
 
-#define FNV_PRIME 1099511628211ULL
-#define FNV_OFFSET 14695981039346656037ULL
-#define LOAD_FACTOR_THRESHOLD 0.75
+#if defined(__SSE2__)
+#define LINGUISTIC_ELEMENT_HAVE_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+#define LINGUISTIC_ELEMENT_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+// wyhash secrets: odd, with balanced bits in every byte
+#define HASH_SECRET0 0xa0761d6478bd642fULL
+#define HASH_SECRET1 0xe7037ed1a0b428dbULL
+#define HASH_SECRET2 0x8ebc6af09c88c6e3ULL
+#define HASH_SECRET3 0x589965cc75374cc3ULL
+
+#define GROUP_SIZE LIMDY_LINGUISTIC_ELEMENT_GROUP_SIZE
+#define CONTROL_EMPTY 0x80 // Full slots hold 7 hash bits, so only empty and moved slots have the top bit set
+#define CONTROL_MOVED 0xfe // Drained by a resize; unlike an empty slot it does not end a probe
+
+// Old slots drained per insertion while resizing, one group. The new table has twice the slots, so the old
+// one is empty long before the new one fills.
+#define MIGRATE_SLOTS GROUP_SIZE
+
+#ifdef LINGUISTIC_ELEMENT_HAVE_NEON
+#define GROUP_SLOT_SHIFT 2 // NEON masks spend four bits per slot
+#else
+#define GROUP_SLOT_SHIFT 0
+#endif
+
+// Plain maps are owned by a single result and are not locked internally; the concurrent map puts a
+// plain, arena-backed map behind each of its shard locks
+
+// Folds the 128-bit product of a and b into 64 bits, the wyhash mixing step
+static inline uint64_t hash_mix(uint64_t a, uint64_t b)
+{
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
 
-static pthread_mutex_t map_mutex = PTHREAD_MUTEX_INITIALIZER;
+static inline uint64_t hash_read64(const char *bytes)
+{
+    uint64_t word;
+    memcpy(&word, bytes, sizeof(word));
+    return word;
+}
 
-// Optimized hash function
-uint64_t hash_linguistic_element(const Token *tokens, size_t token_count)
+static inline uint64_t hash_read32(const char *bytes)
 {
-    uint64_t hash = FNV_OFFSET;
-    for (size_t i = 0; i < token_count; i++)
+    uint32_t word;
+    memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+// Hashes a text with fixed-width, possibly overlapping reads, 16 bytes per step, chained on seed. The
+// length is mixed in, so token boundaries count.
+static uint64_t hash_text(const char *text, size_t length, uint64_t seed)
+{
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (length <= 16)
     {
-        const Token *token = &tokens[i];
-        // Hash the token text
-        for (size_t j = 0; j < token->length; j++)
+        if (length >= 4)
+        {
+            // Two pairs of 4-byte reads cover 4 to 16 bytes between them
+            size_t middle = (length >> 3) << 2;
+            a = (hash_read32(text) << 32) | hash_read32(text + middle);
+            b = (hash_read32(text + length - 4) << 32) | hash_read32(text + length - 4 - middle);
+        }
+        else if (length > 0)
         {
-            hash ^= (uint64_t)(unsigned char)token->text[j];
-            hash *= FNV_PRIME;
+            a = ((uint64_t)(unsigned char)text[0] << 16) | ((uint64_t)(unsigned char)text[length >> 1] << 8) |
+                (unsigned char)text[length - 1];
         }
-        // Hash the token classes (using XOR for all classes)
-        uint64_t class_hash = 0;
-        for (size_t j = 0; j < token->class_count; j++)
+    }
+    else
+    {
+        size_t i = 0;
+        for (; length - i > 16; i += 16)
         {
-            class_hash ^= (uint64_t)token->classes[j];
+            seed = hash_mix(hash_read64(text + i) ^ HASH_SECRET1, hash_read64(text + i + 8) ^ seed);
         }
-        hash ^= class_hash;
-        hash *= FNV_PRIME;
+        // The last 16 bytes, overlapping what the loop already read
+        a = hash_read64(text + length - 16);
+        b = hash_read64(text + length - 8);
+    }
+
+    return hash_mix(HASH_SECRET1 ^ length, hash_mix(a ^ HASH_SECRET1, b ^ seed));
+}
+
+// Word-at-a-time hash of the tokens' texts and class sets. The set seeds its token's text hash, one
+// odd multiply apart per set, so classes cost nothing beyond the text and classless tokens hash as
+// plain text. Words are read in native byte order, so hashes are only meaningful within one machine.
+uint64_t hash_linguistic_element(const Token *tokens, size_t token_count)
+{
+    uint64_t hash = HASH_SECRET0 ^ token_count;
+    for (size_t i = 0; i < token_count; i++)
+    {
+        const Token *token = &tokens[i];
+        hash = hash_text(token->text, token->length, hash ^ ((uint64_t)token->classes * HASH_SECRET2));
     }
     return hash;
 }
-#include "linguistic_element.h"
-#include <string.h>
-#include <pthread.h>
 
-#define FNV_PRIME 1099511628211ULL
-#define FNV_OFFSET 14695981039346656037ULL
-#define LOAD_FACTOR_THRESHOLD 0.75
+// Tokens are equal when their texts and class sets are
+static bool token_equal(const Token *a, const Token *b)
+{
+    return a->length == b->length && a->classes == b->classes && memcmp(a->text, b->text, a->length) == 0;
+}
 
-static pthread_mutex_t map_mutex = PTHREAD_MUTEX_INITIALIZER;
+// Key of a lookup: count consecutive tokens
+typedef struct
+{
+    const Token *tokens;
+    size_t count;
+} ElementKey;
 
-// Hash function remains the same
+static bool element_matches(const ExtendedLinguisticElement *element, const ElementKey *key)
+{
+    if (element->base.token_count != key->count)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < key->count; i++)
+    {
+        if (!token_equal(&element->base.tokens[i], &key->tokens[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
 
-ErrorCode linguistic_element_map_init(LinguisticElementMap *map, size_t initial_capacity, LimdyMemoryPool *pool)
+// Allocation helpers: maps are backed either by a pool or by an arena
+void *linguistic_element_map_alloc(LinguisticElementMap *map, size_t size)
 {
-    CHECK_NULL(map, ERROR_NULL_POINTER);
-    CHECK_NULL(pool, ERROR_NULL_POINTER);
+    return map->arena ? limdy_arena_alloc(map->arena, size) : limdy_memory_pool_alloc_from(map->pool, size);
+}
 
-    map->elements = limdy_memory_pool_alloc_from(pool, initial_capacity * sizeof(ExtendedLinguisticElement));
-    if (!map->elements)
+static void *map_realloc(LinguisticElementMap *map, void *ptr, size_t old_size, size_t new_size)
+{
+    if (!map->arena)
     {
-        return LIMDY_MEMORY_POOL_ERROR_ALLOC_FAILED;
+        return limdy_memory_pool_realloc_from(map->pool, ptr, new_size);
     }
 
-    map->element_count = 0;
-    map->capacity = initial_capacity;
-    map->pool = pool;
-
-    memset(map->elements, 0, initial_capacity * sizeof(ExtendedLinguisticElement));
+    void *new_ptr = limdy_arena_alloc(map->arena, new_size);
+    if (new_ptr && ptr)
+    {
+        memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    }
+    return new_ptr;
+}
 
-    return ERROR_SUCCESS;
+void linguistic_element_map_release(LinguisticElementMap *map, void *ptr)
+{
+    if (!map->arena)
+    {
+        limdy_memory_pool_free_to(map->pool, ptr);
+    }
 }
 
-static ErrorCode linguistic_element_map_resize(LinguisticElementMap *map)
+// Bitmask of the slots in a group whose control byte is byte; slot i is bit i << GROUP_SLOT_SHIFT
+static inline uint64_t group_match(const uint8_t *group, uint8_t byte)
 {
-    size_t new_capacity = map->capacity * 2;
-    ExtendedLinguisticElement *new_elements = limdy_memory_pool_alloc_from(map->pool, new_capacity * sizeof(ExtendedLinguisticElement));
-    if (!new_elements)
+#if defined(LINGUISTIC_ELEMENT_HAVE_SSE2)
+    __m128i control = _mm_loadu_si128((const __m128i *)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8((char)byte)));
+#elif defined(LINGUISTIC_ELEMENT_HAVE_NEON)
+    uint8x16_t equal = vceqq_u8(vld1q_u8(group), vdupq_n_u8(byte));
+    uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(equal), 4)), 0);
+    return nibbles & 0x8888888888888888ULL;
+#else
+    uint64_t mask = 0;
+    for (size_t i = 0; i < GROUP_SIZE; i++)
     {
-        return LIMDY_MEMORY_POOL_ERROR_ALLOC_FAILED;
+        mask |= (uint64_t)(group[i] == byte) << i;
     }
+    return mask;
+#endif
+}
+
+static inline size_t group_first(uint64_t mask)
+{
+    return (size_t)__builtin_ctzll(mask) >> GROUP_SLOT_SHIFT;
+}
+
+// Callers may pass any hash, including ones with weak low bits; the table splits a finalized copy into
+// 7 control bits and the probe start
+static inline uint64_t control_hash(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+static inline uint8_t control_fragment(uint64_t hash)
+{
+    return (uint8_t)(control_hash(hash) & 0x7f);
+}
+
+static inline void table_set_control(LinguisticElementTable *table, size_t index, uint8_t byte)
+{
+    table->control[index] = byte;
+    // Slots of the first group are mirrored past the end, so a group read never wraps
+    table->control[((index - GROUP_SIZE) & (table->capacity - 1)) + GROUP_SIZE] = byte;
+}
 
-    memset(new_elements, 0, new_capacity * sizeof(ExtendedLinguisticElement));
+// Gets the slot holding hash whose element matches key (any element with the hash if key is NULL), or
+// capacity if there is none.
+static size_t table_probe(const LinguisticElementTable *table, uint64_t hash, const ElementKey *key)
+{
+    uint64_t mixed = control_hash(hash);
+    uint8_t fragment = (uint8_t)(mixed & 0x7f);
+    size_t mask = table->capacity - 1;
+    size_t position = (size_t)(mixed >> 7) & mask;
 
-    for (size_t i = 0; i < map->capacity; i++)
+    // Group-sized triangular steps visit every group of a power-of-two table once
+    for (size_t stride = GROUP_SIZE; stride <= table->capacity; stride += GROUP_SIZE)
     {
-        if (map->elements[i].base.token_count > 0)
+        const uint8_t *group = table->control + position;
+        for (uint64_t match = group_match(group, fragment); match; match &= match - 1)
         {
-            size_t index = map->elements[i].base.hash % new_capacity;
-            size_t step = 1;
-            while (new_elements[index].base.token_count > 0)
+            size_t index = (position + group_first(match)) & mask;
+            // Equal hashes of different tokens are told apart by comparing the tokens
+            if (table->hashes[index] == hash && (!key || element_matches(&table->elements[index], key)))
             {
-                index = (index + step * step) % new_capacity; // Quadratic probing
-                step++;
+                LIMDY_METRIC_RECORD(LIMDY_HISTOGRAM_MAP_PROBE_GROUPS, stride / GROUP_SIZE);
+                return index;
             }
-            new_elements[index] = map->elements[i];
         }
+
+        uint64_t empties = group_match(group, CONTROL_EMPTY);
+        if (empties)
+        {
+            LIMDY_METRIC_RECORD(LIMDY_HISTOGRAM_MAP_PROBE_GROUPS, stride / GROUP_SIZE);
+            return table->capacity;
+        }
+        position = (position + stride) & mask;
     }
 
-    limdy_memory_pool_free_to(map->pool, map->elements);
-    map->elements = new_elements;
-    map->capacity = new_capacity;
+    LIMDY_METRIC_RECORD(LIMDY_HISTOGRAM_MAP_PROBE_GROUPS, table->capacity / GROUP_SIZE);
+    return table->capacity;
+}
+
+// Finds an element in whichever table holds it; every element is in exactly one
+static ExtendedLinguisticElement *map_locate(LinguisticElementMap *map, uint64_t hash, const ElementKey *key)
+{
+    size_t index = table_probe(&map->table, hash, key);
+    if (index < map->table.capacity)
+    {
+        return &map->table.elements[index];
+    }
+    index = table_probe(&map->old, hash, key);
+    return index < map->old.capacity ? &map->old.elements[index] : NULL;
+}
+
+// Control bytes, hashes and payloads share one allocation, hashes first for their alignment
+static ErrorCode map_alloc_table(LinguisticElementMap *map, LinguisticElementTable *table, size_t capacity)
+{
+    size_t size = capacity * (sizeof(uint64_t) + sizeof(ExtendedLinguisticElement)) + capacity + GROUP_SIZE;
+    uint64_t *hashes = linguistic_element_map_alloc(map, size);
+    if (!hashes)
+    {
+        return LIMDY_MEMORY_POOL_ERROR_ALLOC_FAILED;
+    }
+
+    table->hashes = hashes;
+    table->elements = (ExtendedLinguisticElement *)(hashes + capacity);
+    table->control = (uint8_t *)(table->elements + capacity);
+    table->capacity = capacity;
+    memset(table->control, CONTROL_EMPTY, capacity + GROUP_SIZE);
 
     return ERROR_SUCCESS;
 }
 
-ErrorCode linguistic_element_map_add(LinguisticElementMap *map, ExtendedLinguisticElement *element)
+static void map_free_table(LinguisticElementMap *map, LinguisticElementTable *table)
 {
-    CHECK_NULL(map, ERROR_NULL_POINTER);
-    CHECK_NULL(element, ERROR_NULL_POINTER);
+    if (table->hashes)
+    {
+        linguistic_element_map_release(map, table->hashes);
+    }
+    *table = (LinguisticElementTable){0};
+}
 
-    MUTEX_LOCK(&map_mutex);
+// Tables stay at most 7/8 full, so a probe always ends at an empty slot
+static bool table_has_room(size_t capacity, size_t element_count)
+{
+    return element_count <= capacity / 8 * 7;
+}
 
-    if ((float)map->element_count / map->capacity > LOAD_FACTOR_THRESHOLD)
+static size_t table_capacity_for(size_t element_count)
+{
+    size_t capacity = GROUP_SIZE;
+    while (!table_has_room(capacity, element_count))
     {
-        ErrorCode err = linguistic_element_map_resize(map);
-        if (err != ERROR_SUCCESS)
-        {
-            MUTEX_UNLOCK(&map_mutex);
-            return err;
-        }
+        capacity *= 2;
     }
+    return capacity;
+}
 
-    size_t index = element->base.hash % map->capacity;
-    size_t step = 1;
-    while (map->elements[index].base.token_count > 0)
+// Gets the first empty slot on hash's probe sequence. Unlike table_probe it does not stop at elements
+// with an equal hash, which distinct tokens may share; the table must have room
+static size_t table_find_empty(const LinguisticElementTable *table, uint64_t hash)
+{
+    size_t mask = table->capacity - 1;
+    size_t position = (size_t)(control_hash(hash) >> 7) & mask;
+    for (size_t stride = GROUP_SIZE;; stride += GROUP_SIZE)
     {
-        if (map->elements[index].base.hash == element->base.hash)
+        uint64_t empties = group_match(table->control + position, CONTROL_EMPTY);
+        if (empties)
         {
-            map->elements[index] = *element;
-            MUTEX_UNLOCK(&map_mutex);
-            return ERROR_SUCCESS;
+            return (position + group_first(empties)) & mask;
         }
-        index = (index + step * step) % map->capacity; // Quadratic probing
-        step++;
-        if (step > map->capacity)
+        position = (position + stride) & mask;
+    }
+}
+
+// Places an element known to be absent; the table must have room
+static void table_insert(LinguisticElementTable *table, uint64_t hash, const ExtendedLinguisticElement *element)
+{
+    size_t empty = table_find_empty(table, hash);
+    table->hashes[empty] = hash;
+    table->elements[empty] = *element;
+    table_set_control(table, empty, control_fragment(hash));
+}
+
+// Moves up to limit slots of the old table into the current one, freeing the old table once drained
+static void map_migrate(LinguisticElementMap *map, size_t limit)
+{
+    LinguisticElementTable *old = &map->old;
+    size_t end = old->capacity - map->migrated < limit ? old->capacity : map->migrated + limit;
+    for (; map->migrated < end; map->migrated++)
+    {
+        size_t i = map->migrated;
+        if (old->control[i] < CONTROL_EMPTY)
         {
-            MUTEX_UNLOCK(&map_mutex);
-            return LIMDY_LINGUISTIC_ELEMENT_ERROR_MAP_FULL;
+            table_insert(&map->table, old->hashes[i], &old->elements[i]);
+            // Later probes of the old table must still get past this slot
+            table_set_control(old, i, CONTROL_MOVED);
         }
     }
 
-    map->elements[index] = *element;
-    map->element_count++;
+    if (old->capacity && map->migrated == old->capacity)
+    {
+        map_free_table(map, old);
+        map->migrated = 0;
+    }
+}
+
+// Switches to a table of the given capacity. With incremental set, the outgrown table is drained by later
+// insertions; otherwise it is drained now.
+static ErrorCode map_grow(LinguisticElementMap *map, size_t capacity, bool incremental)
+{
+    // Only one resize runs at a time
+    map_migrate(map, SIZE_MAX);
 
-    MUTEX_UNLOCK(&map_mutex);
+    LinguisticElementTable table;
+    RETURN_IF_ERROR(map_alloc_table(map, &table, capacity));
+    map->old = map->table;
+    map->table = table;
+    map->migrated = 0;
+
+    map_migrate(map, incremental ? MIGRATE_SLOTS : SIZE_MAX);
     return ERROR_SUCCESS;
 }
 
-ErrorCode linguistic_element_map_add_occurrence(LinguisticElementMap *map, uint64_t hash, Token **tokens, size_t token_count)
+static ErrorCode map_init_storage(LinguisticElementMap *map, size_t initial_capacity)
+{
+    map->element_count = 0;
+    map->migrated = 0;
+    map->old = (LinguisticElementTable){0};
+
+    return map_alloc_table(map, &map->table, table_capacity_for(initial_capacity));
+}
+
+ErrorCode linguistic_element_map_init(LinguisticElementMap *map, size_t initial_capacity, LimdyMemoryPool *pool)
 {
     CHECK_NULL(map, ERROR_NULL_POINTER);
-    CHECK_NULL(tokens, ERROR_NULL_POINTER);
+    CHECK_NULL(pool, ERROR_NULL_POINTER);
 
-    MUTEX_LOCK(&map_mutex);
+    map->pool = pool;
+    map->arena = NULL;
 
-    ExtendedLinguisticElement *element = linguistic_element_map_find(map, hash);
-    if (!element)
+    return map_init_storage(map, initial_capacity);
+}
+
+ErrorCode linguistic_element_map_init_arena(LinguisticElementMap *map, size_t initial_capacity, LimdyArena *arena)
+{
+    CHECK_NULL(map, ERROR_NULL_POINTER);
+    CHECK_NULL(arena, ERROR_NULL_POINTER);
+
+    map->pool = NULL;
+    map->arena = arena;
+
+    return map_init_storage(map, initial_capacity);
+}
+
+ErrorCode linguistic_element_map_reserve(LinguisticElementMap *map, size_t element_count)
+{
+    CHECK_NULL(map, ERROR_NULL_POINTER);
+
+    if (table_has_room(map->table.capacity, element_count))
     {
-        MUTEX_UNLOCK(&map_mutex);
-        return LIMDY_LINGUISTIC_ELEMENT_ERROR_NOT_FOUND;
+        return ERROR_SUCCESS;
+    }
+    return map_grow(map, table_capacity_for(element_count), false);
+}
+
+ErrorCode linguistic_element_map_add(LinguisticElementMap *map, ExtendedLinguisticElement *element)
+{
+    CHECK_NULL(map, ERROR_NULL_POINTER);
+    CHECK_NULL(element, ERROR_NULL_POINTER);
+
+    uint64_t hash = element->base.hash;
+    ElementKey key = {element->base.tokens, element->base.token_count};
+    ExtendedLinguisticElement *existing = map_locate(map, hash, &key);
+    if (existing)
+    {
+        *existing = *element;
+        return ERROR_SUCCESS;
+    }
+
+    if (!table_has_room(map->table.capacity, map->element_count + 1))
+    {
+        RETURN_IF_ERROR(map_grow(map, map->table.capacity * 2, true));
+    }
+    else if (map->old.capacity)
+    {
+        map_migrate(map, MIGRATE_SLOTS);
+    }
+
+    table_insert(&map->table, hash, element);
+    map->element_count++;
+
+    return ERROR_SUCCESS;
+}
+
+// Makes room for one more occurrence. The array's capacity is the smallest power of two holding the
+// count, so it only grows when the count reaches one and appends stay amortized O(1)
+static ErrorCode element_reserve_occurrence(LinguisticElementMap *map, ExtendedLinguisticElement *element)
+{
+    size_t count = element->occurrence_count;
+    if (count & (count - 1))
+    {
+        return ERROR_SUCCESS;
     }
 
-    size_t new_count = element->occurrence_count + 1;
-    Token ***new_occurrences = limdy_memory_pool_realloc_from(map->pool, element->occurrences, new_count * sizeof(Token **));
+    size_t new_capacity = count ? count * 2 : 1;
+    Token **new_occurrences = map_realloc(map, element->occurrences, count * sizeof(Token *), new_capacity * sizeof(Token *));
     if (!new_occurrences)
     {
-        MUTEX_UNLOCK(&map_mutex);
         return LIMDY_MEMORY_POOL_ERROR_ALLOC_FAILED;
     }
 
-    new_occurrences[new_count - 1] = limdy_memory_pool_alloc_from(map->pool, token_count * sizeof(Token *));
-    if (!new_occurrences[new_count - 1])
+    // Stored straight away: the old array may already be gone
+    element->occurrences = new_occurrences;
+    return ERROR_SUCCESS;
+}
+
+ErrorCode linguistic_element_map_add_occurrence(LinguisticElementMap *map, uint64_t hash, Token *tokens, size_t token_count)
+{
+    CHECK_NULL(map, ERROR_NULL_POINTER);
+    CHECK_NULL(tokens, ERROR_NULL_POINTER);
+
+    ElementKey key = {tokens, token_count};
+    ExtendedLinguisticElement *element = map_locate(map, hash, &key);
+    if (!element)
     {
-        MUTEX_UNLOCK(&map_mutex);
-        return LIMDY_MEMORY_POOL_ERROR_ALLOC_FAILED;
+        return LIMDY_LINGUISTIC_ELEMENT_ERROR_NOT_FOUND;
     }
 
-    memcpy(new_occurrences[new_count - 1], tokens, token_count * sizeof(Token *));
+    RETURN_IF_ERROR(element_reserve_occurrence(map, element));
+    element->occurrences[element->occurrence_count++] = tokens;
 
-    element->occurrences = new_occurrences;
-    element->occurrence_count = new_count;
+    return ERROR_SUCCESS;
+}
+
+ErrorCode linguistic_element_map_record(LinguisticElementMap *map, LinguisticElementType type, uint64_t hash, Token *tokens,
+                                        size_t token_count)
+{
+    CHECK_NULL(map, ERROR_NULL_POINTER);
+    CHECK_NULL(tokens, ERROR_NULL_POINTER);
+    if (token_count == 0)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Linguistic element needs at least one token");
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    ElementKey key = {tokens, token_count};
+    ExtendedLinguisticElement *element = map_locate(map, hash, &key);
+    if (!element)
+    {
+        // The map owns its element's tokens, so it keeps a copy
+        Token *element_tokens = linguistic_element_map_alloc(map, token_count * sizeof(Token));
+        if (!element_tokens)
+        {
+            return LIMDY_MEMORY_POOL_ERROR_ALLOC_FAILED;
+        }
+        memcpy(element_tokens, tokens, token_count * sizeof(Token));
+
+        ExtendedLinguisticElement new_element = {
+            .base = {
+                .type = type,
+                .tokens = element_tokens,
+                .token_count = token_count,
+                .hash = hash}};
+        ErrorCode error = linguistic_element_map_add(map, &new_element);
+        if (error != ERROR_SUCCESS)
+        {
+            linguistic_element_map_release(map, element_tokens);
+            return error;
+        }
+        // Adding may have moved elements between tables
+        element = map_locate(map, hash, &key);
+    }
+
+    RETURN_IF_ERROR(element_reserve_occurrence(map, element));
+    element->occurrences[element->occurrence_count++] = tokens;
 
-    MUTEX_UNLOCK(&map_mutex);
     return ERROR_SUCCESS;
 }
 
 ExtendedLinguisticElement *linguistic_element_map_find(LinguisticElementMap *map, uint64_t hash)
 {
-    CHECK_NULL(map, NULL);
+    // CHECK_NULL would return the error code as a pointer here
+    if (!map)
+    {
+        LOG_ERROR(ERROR_NULL_POINTER, "Null map");
+        return NULL;
+    }
+
+    return map_locate(map, hash, NULL);
+}
+
+ExtendedLinguisticElement *linguistic_element_map_find_tokens(LinguisticElementMap *map, uint64_t hash, const Token *tokens,
+                                                              size_t token_count)
+{
+    if (!map || !tokens)
+    {
+        LOG_ERROR(ERROR_NULL_POINTER, "Null map or tokens");
+        return NULL;
+    }
+
+    ElementKey key = {tokens, token_count};
+    return map_locate(map, hash, &key);
+}
+
+size_t linguistic_element_map_slot_count(const LinguisticElementMap *map)
+{
+    return map->table.capacity + map->old.capacity;
+}
+
+ExtendedLinguisticElement *linguistic_element_map_slot(LinguisticElementMap *map, size_t index)
+{
+    LinguisticElementTable *table = &map->table;
+    if (index >= table->capacity)
+    {
+        index -= table->capacity;
+        table = &map->old;
+    }
+    return table->control[index] < CONTROL_EMPTY ? &table->elements[index] : NULL;
+}
+
+void linguistic_element_map_free(LinguisticElementMap *map)
+{
+    if (!map)
+    {
+        return;
+    }
+
+    // Arena-backed maps go away with their arena
+    size_t slot_count = linguistic_element_map_slot_count(map);
+    for (size_t i = 0; !map->arena && i < slot_count; i++)
+    {
+        ExtendedLinguisticElement *element = linguistic_element_map_slot(map, i);
+        if (element)
+        {
+            linguistic_element_map_release(map, element->base.tokens);
+            linguistic_element_map_release(map, element->occurrences);
+        }
+    }
+
+    map_free_table(map, &map->table);
+    map_free_table(map, &map->old);
+    map->migrated = 0;
+    map->element_count = 0;
+}
 
-    MUTEX_LOCK(&map_mutex);
+// Picks a shard from bits the in-shard control bytes and probe start barely depend on
+static LinguisticElementMapShard *concurrent_map_shard(ConcurrentLinguisticElementMap *map, uint64_t hash)
+{
+    return &map->shards[(control_hash(hash) >> 32) % LIMDY_LINGUISTIC_ELEMENT_MAP_SHARDS];
+}
 
-    size_t index = hash % map->capacity;
-    size_t step = 1;
-    while (map->elements[index].base.token_count > 0)
+ErrorCode linguistic_element_concurrent_map_init(ConcurrentLinguisticElementMap *map, size_t initial_capacity)
+{
+    CHECK_NULL(map, ERROR_NULL_POINTER);
+
+    size_t shard_capacity = initial_capacity / LIMDY_LINGUISTIC_ELEMENT_MAP_SHARDS + 1;
+    for (size_t i = 0; i < LIMDY_LINGUISTIC_ELEMENT_MAP_SHARDS; i++)
     {
-        if (map->elements[index].base.hash == hash)
+        LinguisticElementMapShard *shard = &map->shards[i];
+        ErrorCode error = limdy_arena_init(&shard->arena, LIMDY_LINGUISTIC_ELEMENT_SHARD_CHUNK_SIZE);
+        if (error == ERROR_SUCCESS)
         {
-            MUTEX_UNLOCK(&map_mutex);
-            return &map->elements[index];
+            error = linguistic_element_map_init_arena(&shard->map, shard_capacity, &shard->arena);
+            if (error == ERROR_SUCCESS && pthread_mutex_init(&shard->mutex, NULL) != 0)
+            {
+                error = ERROR_THREAD_INIT;
+            }
+            if (error != ERROR_SUCCESS)
+            {
+                limdy_arena_release(&shard->arena);
+            }
         }
-        index = (index + step * step) % map->capacity; // Quadratic probing
-        step++;
-        if (step > map->capacity)
+
+        if (error != ERROR_SUCCESS)
         {
-            break;
+            for (size_t j = 0; j < i; j++)
+            {
+                pthread_mutex_destroy(&map->shards[j].mutex);
+                limdy_arena_release(&map->shards[j].arena);
+            }
+            LOG_ERROR(error, "Failed to initialize concurrent linguistic element map shard");
+            return error;
         }
     }
 
-    MUTEX_UNLOCK(&map_mutex);
-    return NULL;
+    return ERROR_SUCCESS;
 }
 
-void linguistic_element_map_free(LinguisticElementMap *map)
+ErrorCode linguistic_element_concurrent_map_record(ConcurrentLinguisticElementMap *map, LinguisticElementType type,
+                                                   Token *tokens, size_t token_count)
+{
+    CHECK_NULL(map, ERROR_NULL_POINTER);
+    CHECK_NULL(tokens, ERROR_NULL_POINTER);
+    if (token_count == 0)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Linguistic element needs at least one token");
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    // Hashing needs no lock
+    uint64_t hash = hash_linguistic_element(tokens, token_count);
+    LinguisticElementMapShard *shard = concurrent_map_shard(map, hash);
+
+    MUTEX_LOCK(&shard->mutex);
+    ErrorCode error = linguistic_element_map_record(&shard->map, type, hash, tokens, token_count);
+    MUTEX_UNLOCK(&shard->mutex);
+
+    return error;
+}
+
+bool linguistic_element_concurrent_map_occurrences(ConcurrentLinguisticElementMap *map, uint64_t hash, size_t *occurrence_count)
 {
     if (!map)
     {
-        return;
+        return false;
     }
 
-    MUTEX_LOCK(&map_mutex);
+    LinguisticElementMapShard *shard = concurrent_map_shard(map, hash);
+    pthread_mutex_lock(&shard->mutex);
+    ExtendedLinguisticElement *element = linguistic_element_map_find(&shard->map, hash);
+    if (element && occurrence_count)
+    {
+        *occurrence_count = element->occurrence_count;
+    }
+    pthread_mutex_unlock(&shard->mutex);
+
+    return element != NULL;
+}
 
-    for (size_t i = 0; i < map->capacity; i++)
+size_t linguistic_element_concurrent_map_size(ConcurrentLinguisticElementMap *map)
+{
+    size_t size = 0;
+    for (size_t i = 0; map && i < LIMDY_LINGUISTIC_ELEMENT_MAP_SHARDS; i++)
     {
-        if (map->elements[i].base.token_count > 0)
+        pthread_mutex_lock(&map->shards[i].mutex);
+        size += map->shards[i].map.element_count;
+        pthread_mutex_unlock(&map->shards[i].mutex);
+    }
+    return size;
+}
+
+void linguistic_element_concurrent_map_for_each(ConcurrentLinguisticElementMap *map, LinguisticElementVisitFn visit, void *context)
+{
+    if (!map || !visit)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < LIMDY_LINGUISTIC_ELEMENT_MAP_SHARDS; i++)
+    {
+        LinguisticElementMapShard *shard = &map->shards[i];
+        pthread_mutex_lock(&shard->mutex);
+        size_t slot_count = linguistic_element_map_slot_count(&shard->map);
+        for (size_t j = 0; j < slot_count; j++)
         {
-            limdy_memory_pool_free_to(map->pool, map->elements[i].base.tokens);
-            for (size_t j = 0; j < map->elements[i].occurrence_count; j++)
+            ExtendedLinguisticElement *element = linguistic_element_map_slot(&shard->map, j);
+            if (element)
             {
-                limdy_memory_pool_free_to(map->pool, map->elements[i].occurrences[j]);
+                visit(context, element);
             }
-            limdy_memory_pool_free_to(map->pool, map->elements[i].occurrences);
         }
+        pthread_mutex_unlock(&shard->mutex);
     }
+}
 
-    limdy_memory_pool_free_to(map->pool, map->elements);
-    map->elements = NULL;
-    map->element_count = 0;
-    map->capacity = 0;
+void linguistic_element_concurrent_map_free(ConcurrentLinguisticElementMap *map)
+{
+    if (!map)
+    {
+        return;
+    }
 
-    MUTEX_UNLOCK(&map_mutex);
-}
\ No newline at end of file
+    for (size_t i = 0; i < LIMDY_LINGUISTIC_ELEMENT_MAP_SHARDS; i++)
+    {
+        linguistic_element_map_free(&map->shards[i].map);
+        limdy_arena_release(&map->shards[i].arena);
+        pthread_mutex_destroy(&map->shards[i].mutex);
+    }
+}
@@ -0,0 +1,476 @@
+/**
+ * @file linguistic_vocabulary.c
+ * @brief Implementation of the interned vocabulary.
+ *
+ * This file implements the interface defined in linguistic_vocabulary.h.
+ * Tokens and elements are indexed by open-addressing tables of 32-bit IDs
+ * that double when half full; the full hash kept in each record lets a
+ * probe skip most string and ID comparisons. Tables outgrown by a doubling
+ * stay in the arena until the vocabulary is freed, which costs at most as
+ * much again as the final tables.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include "linguistic_vocabulary.h"
+#include "memory_pool.h"
+#include <string.h>
+
+#define VOCABULARY_CHUNK_RECORDS LIMDY_LINGUISTIC_VOCABULARY_CHUNK_RECORDS
+#define VOCABULARY_INITIAL_TABLE 64
+#define VOCABULARY_ARENA_CHUNK (256 * 1024) // Holds the largest record chunk, 4096 elements
+#define VOCABULARY_STACK_IDS 16 // Elements up to this many tokens are looked up without allocating
+
+// Interned token text
+typedef struct
+{
+    uint64_t hash;
+    const char *text;
+    size_t length;
+} VocabularyToken;
+
+static void vector_init(LinguisticChunkedVector *vector, size_t record_size)
+{
+    vector->chunks = NULL;
+    vector->chunk_slots = 0;
+    vector->count = 0;
+    vector->record_size = record_size;
+}
+
+static inline void *vector_at(const LinguisticChunkedVector *vector, size_t index)
+{
+    return vector->chunks[index / VOCABULARY_CHUNK_RECORDS] + (index % VOCABULARY_CHUNK_RECORDS) * vector->record_size;
+}
+
+/**
+ * @brief Appends a zeroed record, adding a chunk when the last one is full.
+ *
+ * @param vocabulary The vocabulary whose arena backs the vector.
+ * @param vector The vector.
+ * @return The new record, or NULL if the arena is exhausted.
+ */
+static void *vector_append(LinguisticVocabulary *vocabulary, LinguisticChunkedVector *vector)
+{
+    size_t chunk = vector->count / VOCABULARY_CHUNK_RECORDS;
+    if (vector->count % VOCABULARY_CHUNK_RECORDS == 0)
+    {
+        if (chunk == vector->chunk_slots)
+        {
+            // Only the small array of chunk pointers is ever copied, never the records
+            size_t slots = vector->chunk_slots ? vector->chunk_slots * 2 : 8;
+            char **chunks = limdy_arena_alloc(&vocabulary->arena, slots * sizeof(char *));
+            if (!chunks)
+            {
+                return NULL;
+            }
+            if (vector->chunks)
+            {
+                memcpy(chunks, vector->chunks, vector->chunk_slots * sizeof(char *));
+            }
+            vector->chunks = chunks;
+            vector->chunk_slots = slots;
+        }
+
+        vector->chunks[chunk] = limdy_arena_alloc(&vocabulary->arena, VOCABULARY_CHUNK_RECORDS * vector->record_size);
+        if (!vector->chunks[chunk])
+        {
+            return NULL;
+        }
+    }
+
+    void *record = vector_at(vector, vector->count++);
+    memset(record, 0, vector->record_size);
+    return record;
+}
+
+static uint32_t *table_alloc(LinguisticVocabulary *vocabulary, size_t capacity)
+{
+    uint32_t *table = limdy_arena_alloc(&vocabulary->arena, capacity * sizeof(uint32_t));
+    if (table)
+    {
+        memset(table, 0, capacity * sizeof(uint32_t));
+    }
+    return table;
+}
+
+static uint64_t token_hash(const char *text, size_t length)
+{
+    Token token = {.text = (char *)text, .length = length};
+    return hash_linguistic_element(&token, 1);
+}
+
+static uint64_t element_hash(const LinguisticTokenId *ids, size_t count)
+{
+    uint64_t hash = 0x9e3779b97f4a7c15ULL ^ count;
+    for (size_t i = 0; i < count; i++)
+    {
+        hash = (hash ^ ids[i]) * 0xbf58476d1ce4e5b9ULL;
+        hash ^= hash >> 31;
+    }
+    return hash;
+}
+
+// Gets the slot of token text in the token table: the slot holding it, or the empty slot it would take
+static size_t token_slot(const LinguisticVocabulary *vocabulary, uint64_t hash, const char *text, size_t length)
+{
+    size_t mask = vocabulary->token_table_capacity - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask)
+    {
+        uint32_t entry = vocabulary->token_table[slot];
+        if (entry == 0)
+        {
+            return slot;
+        }
+        const VocabularyToken *token = vector_at(&vocabulary->tokens, entry - 1);
+        if (token->hash == hash && token->length == length && memcmp(token->text, text, length) == 0)
+        {
+            return slot;
+        }
+    }
+}
+
+// Gets the slot of the element with these token IDs in the element table, like token_slot
+static size_t element_slot(const LinguisticVocabulary *vocabulary, uint64_t hash, const LinguisticTokenId *ids, size_t count)
+{
+    size_t mask = vocabulary->element_table_capacity - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask)
+    {
+        uint32_t entry = vocabulary->element_table[slot];
+        if (entry == 0)
+        {
+            return slot;
+        }
+        const LinguisticVocabularyElement *element = vector_at(&vocabulary->elements, entry - 1);
+        if (element->hash == hash && element->token_count == count && memcmp(element->tokens, ids, count * sizeof(LinguisticTokenId)) == 0)
+        {
+            return slot;
+        }
+    }
+}
+
+/**
+ * @brief Doubles a table before one more record would fill half of it, reinserting every ID by its
+ * record's hash. Slots found before a call are stale after it.
+ *
+ * @param vocabulary The vocabulary.
+ * @param table The table to grow.
+ * @param capacity The table's capacity.
+ * @param records The records the table's IDs refer to.
+ * @return ErrorCode indicating success or failure.
+ */
+static ErrorCode table_reserve(LinguisticVocabulary *vocabulary, uint32_t **table, size_t *capacity, const LinguisticChunkedVector *records)
+{
+    if ((records->count + 1) * 2 <= *capacity)
+    {
+        return ERROR_SUCCESS;
+    }
+
+    size_t new_capacity = *capacity * 2;
+    uint32_t *new_table = table_alloc(vocabulary, new_capacity);
+    if (!new_table)
+    {
+        return LIMDY_ARENA_ERROR_ALLOC_FAILED;
+    }
+
+    // Both record types start with their hash
+    for (size_t id = 0; id < records->count; id++)
+    {
+        uint64_t hash = *(const uint64_t *)vector_at(records, id);
+        size_t slot = hash & (new_capacity - 1);
+        while (new_table[slot] != 0)
+        {
+            slot = (slot + 1) & (new_capacity - 1);
+        }
+        new_table[slot] = (uint32_t)id + 1;
+    }
+
+    *table = new_table;
+    *capacity = new_capacity;
+    return ERROR_SUCCESS;
+}
+
+ErrorCode linguistic_vocabulary_init(LinguisticVocabulary *vocabulary)
+{
+    CHECK_NULL(vocabulary, ERROR_NULL_POINTER);
+
+    RETURN_IF_ERROR(limdy_arena_init(&vocabulary->arena, VOCABULARY_ARENA_CHUNK));
+    vector_init(&vocabulary->tokens, sizeof(VocabularyToken));
+    vector_init(&vocabulary->elements, sizeof(LinguisticVocabularyElement));
+    vector_init(&vocabulary->occurrences, sizeof(LinguisticOccurrence));
+
+    vocabulary->token_table_capacity = VOCABULARY_INITIAL_TABLE;
+    vocabulary->element_table_capacity = VOCABULARY_INITIAL_TABLE;
+    vocabulary->token_table = table_alloc(vocabulary, VOCABULARY_INITIAL_TABLE);
+    vocabulary->element_table = table_alloc(vocabulary, VOCABULARY_INITIAL_TABLE);
+    if (!vocabulary->token_table || !vocabulary->element_table)
+    {
+        limdy_arena_release(&vocabulary->arena);
+        LOG_ERROR(LIMDY_ARENA_ERROR_ALLOC_FAILED, "Failed to allocate vocabulary tables");
+        return LIMDY_ARENA_ERROR_ALLOC_FAILED;
+    }
+
+    return ERROR_SUCCESS;
+}
+
+void linguistic_vocabulary_free(LinguisticVocabulary *vocabulary)
+{
+    if (!vocabulary)
+    {
+        return;
+    }
+
+    limdy_arena_release(&vocabulary->arena);
+    vocabulary->token_table = NULL;
+    vocabulary->element_table = NULL;
+    vocabulary->token_table_capacity = 0;
+    vocabulary->element_table_capacity = 0;
+    vector_init(&vocabulary->tokens, sizeof(VocabularyToken));
+    vector_init(&vocabulary->elements, sizeof(LinguisticVocabularyElement));
+    vector_init(&vocabulary->occurrences, sizeof(LinguisticOccurrence));
+}
+
+ErrorCode linguistic_vocabulary_intern(LinguisticVocabulary *vocabulary, const char *text, size_t length, LinguisticTokenId *id)
+{
+    CHECK_NULL(vocabulary, ERROR_NULL_POINTER);
+    CHECK_NULL(id, ERROR_NULL_POINTER);
+
+    RETURN_IF_ERROR(table_reserve(vocabulary, &vocabulary->token_table, &vocabulary->token_table_capacity, &vocabulary->tokens));
+
+    uint64_t hash = token_hash(text, length);
+    size_t slot = token_slot(vocabulary, hash, text, length);
+    if (vocabulary->token_table[slot] != 0)
+    {
+        *id = vocabulary->token_table[slot] - 1;
+        return ERROR_SUCCESS;
+    }
+
+    if (vocabulary->tokens.count >= UINT32_MAX)
+    {
+        LOG_ERROR(LIMDY_LINGUISTIC_VOCABULARY_ERROR_FULL, "Vocabulary has no token IDs left");
+        return LIMDY_LINGUISTIC_VOCABULARY_ERROR_FULL;
+    }
+
+    char *copy = limdy_arena_alloc_aligned(&vocabulary->arena, length + 1, 1);
+    VocabularyToken *token = copy ? vector_append(vocabulary, &vocabulary->tokens) : NULL;
+    if (!token)
+    {
+        LOG_ERROR(LIMDY_ARENA_ERROR_ALLOC_FAILED, "Failed to intern token");
+        return LIMDY_ARENA_ERROR_ALLOC_FAILED;
+    }
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    token->hash = hash;
+    token->text = copy;
+    token->length = length;
+
+    *id = (LinguisticTokenId)(vocabulary->tokens.count - 1);
+    vocabulary->token_table[slot] = *id + 1;
+    return ERROR_SUCCESS;
+}
+
+const char *linguistic_vocabulary_token_text(const LinguisticVocabulary *vocabulary, LinguisticTokenId id, size_t *length)
+{
+    const VocabularyToken *token = vector_at(&vocabulary->tokens, id);
+    if (length)
+    {
+        *length = token->length;
+    }
+    return token->text;
+}
+
+/**
+ * @brief Computes the byte span an occurrence covers in its source.
+ *
+ * @param tokens The occurrence's tokens.
+ * @param token_count Number of tokens.
+ * @param occurrence The occurrence to fill in.
+ * @return ErrorCode indicating success or failure.
+ */
+static ErrorCode occurrence_span(const Token *tokens, size_t token_count, LinguisticOccurrence *occurrence)
+{
+    size_t start = tokens[0].offset;
+    size_t end = tokens[token_count - 1].offset + tokens[token_count - 1].length;
+    if (end > UINT32_MAX || end < start)
+    {
+        LOG_ERROR(LIMDY_LINGUISTIC_VOCABULARY_ERROR_FULL, "Occurrence does not fit in 32-bit offsets");
+        return LIMDY_LINGUISTIC_VOCABULARY_ERROR_FULL;
+    }
+
+    occurrence->offset = (uint32_t)start;
+    occurrence->length = (uint32_t)(end - start);
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Finds or adds the element with these token IDs.
+ *
+ * @param vocabulary The vocabulary.
+ * @param type The element's type if it is new.
+ * @param ids The token IDs; copied into the arena if the element is new.
+ * @param count Number of token IDs.
+ * @param element Pointer to store the element.
+ * @param id Pointer to store the element's ID.
+ * @return ErrorCode indicating success or failure.
+ */
+static ErrorCode element_intern(LinguisticVocabulary *vocabulary, LinguisticElementType type, const LinguisticTokenId *ids,
+                                size_t count, LinguisticVocabularyElement **element, LinguisticElementId *id)
+{
+    RETURN_IF_ERROR(table_reserve(vocabulary, &vocabulary->element_table, &vocabulary->element_table_capacity, &vocabulary->elements));
+
+    uint64_t hash = element_hash(ids, count);
+    size_t slot = element_slot(vocabulary, hash, ids, count);
+    if (vocabulary->element_table[slot] != 0)
+    {
+        *id = vocabulary->element_table[slot] - 1;
+        *element = vector_at(&vocabulary->elements, *id);
+        return ERROR_SUCCESS;
+    }
+
+    if (vocabulary->elements.count >= UINT32_MAX)
+    {
+        LOG_ERROR(LIMDY_LINGUISTIC_VOCABULARY_ERROR_FULL, "Vocabulary has no element IDs left");
+        return LIMDY_LINGUISTIC_VOCABULARY_ERROR_FULL;
+    }
+
+    LinguisticTokenId *copy = limdy_arena_alloc_aligned(&vocabulary->arena, count * sizeof(LinguisticTokenId), sizeof(LinguisticTokenId));
+    LinguisticVocabularyElement *added = copy ? vector_append(vocabulary, &vocabulary->elements) : NULL;
+    if (!added)
+    {
+        LOG_ERROR(LIMDY_ARENA_ERROR_ALLOC_FAILED, "Failed to allocate vocabulary element");
+        return LIMDY_ARENA_ERROR_ALLOC_FAILED;
+    }
+    memcpy(copy, ids, count * sizeof(LinguisticTokenId));
+    added->hash = hash;
+    added->tokens = copy;
+    added->token_count = (uint32_t)count;
+    added->type = type;
+
+    *id = (LinguisticElementId)(vocabulary->elements.count - 1);
+    *element = added;
+    vocabulary->element_table[slot] = *id + 1;
+    return ERROR_SUCCESS;
+}
+
+ErrorCode linguistic_vocabulary_record(LinguisticVocabulary *vocabulary, LinguisticElementType type, const Token *tokens,
+                                       size_t token_count, LinguisticElementId *element_id)
+{
+    CHECK_NULL(vocabulary, ERROR_NULL_POINTER);
+    CHECK_NULL(tokens, ERROR_NULL_POINTER);
+    if (token_count == 0 || token_count > UINT32_MAX)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Linguistic element needs at least one token");
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    LinguisticOccurrence occurrence;
+    RETURN_IF_ERROR(occurrence_span(tokens, token_count, &occurrence));
+
+    LinguisticTokenId stack_ids[VOCABULARY_STACK_IDS];
+    LinguisticTokenId *ids = token_count <= VOCABULARY_STACK_IDS ? stack_ids : limdy_memory_pool_alloc(token_count * sizeof(LinguisticTokenId));
+    if (!ids)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate element token IDs");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    ErrorCode error = ERROR_SUCCESS;
+    for (size_t i = 0; error == ERROR_SUCCESS && i < token_count; i++)
+    {
+        error = linguistic_vocabulary_intern(vocabulary, tokens[i].text, tokens[i].length, &ids[i]);
+    }
+
+    LinguisticVocabularyElement *element = NULL;
+    if (error == ERROR_SUCCESS)
+    {
+        error = element_intern(vocabulary, type, ids, token_count, &element, &occurrence.element_id);
+    }
+    if (ids != stack_ids)
+    {
+        limdy_memory_pool_free(ids);
+    }
+    RETURN_IF_ERROR(error);
+
+    LinguisticOccurrence *stored = vector_append(vocabulary, &vocabulary->occurrences);
+    if (!stored)
+    {
+        LOG_ERROR(LIMDY_ARENA_ERROR_ALLOC_FAILED, "Failed to allocate occurrence");
+        return LIMDY_ARENA_ERROR_ALLOC_FAILED;
+    }
+    *stored = occurrence;
+    element->occurrence_count++;
+
+    if (element_id)
+    {
+        *element_id = occurrence.element_id;
+    }
+    return ERROR_SUCCESS;
+}
+
+bool linguistic_vocabulary_find(const LinguisticVocabulary *vocabulary, const Token *tokens, size_t token_count,
+                                LinguisticElementId *element_id)
+{
+    if (!vocabulary || !tokens || token_count == 0)
+    {
+        return false;
+    }
+
+    // Looks up without interning, so a miss leaves the vocabulary untouched
+    LinguisticTokenId stack_ids[VOCABULARY_STACK_IDS];
+    LinguisticTokenId *ids = token_count <= VOCABULARY_STACK_IDS ? stack_ids : limdy_memory_pool_alloc(token_count * sizeof(LinguisticTokenId));
+    if (!ids)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate element token IDs");
+        return false;
+    }
+
+    bool found = true;
+    for (size_t i = 0; found && i < token_count; i++)
+    {
+        uint64_t hash = token_hash(tokens[i].text, tokens[i].length);
+        uint32_t entry = vocabulary->token_table[token_slot(vocabulary, hash, tokens[i].text, tokens[i].length)];
+        found = entry != 0;
+        ids[i] = entry - 1;
+    }
+    if (found)
+    {
+        uint64_t hash = element_hash(ids, token_count);
+        uint32_t entry = vocabulary->element_table[element_slot(vocabulary, hash, ids, token_count)];
+        found = entry != 0;
+        if (found && element_id)
+        {
+            *element_id = entry - 1;
+        }
+    }
+
+    if (ids != stack_ids)
+    {
+        limdy_memory_pool_free(ids);
+    }
+    return found;
+}
+
+const LinguisticVocabularyElement *linguistic_vocabulary_element(const LinguisticVocabulary *vocabulary, LinguisticElementId id)
+{
+    return vector_at(&vocabulary->elements, id);
+}
+
+const LinguisticOccurrence *linguistic_vocabulary_occurrence(const LinguisticVocabulary *vocabulary, size_t index)
+{
+    return vector_at(&vocabulary->occurrences, index);
+}
+
+size_t linguistic_vocabulary_token_count(const LinguisticVocabulary *vocabulary)
+{
+    return vocabulary->tokens.count;
+}
+
+size_t linguistic_vocabulary_element_count(const LinguisticVocabulary *vocabulary)
+{
+    return vocabulary->elements.count;
+}
+
+size_t linguistic_vocabulary_occurrence_count(const LinguisticVocabulary *vocabulary)
+{
+    return vocabulary->occurrences.count;
+}
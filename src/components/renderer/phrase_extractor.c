@@ -0,0 +1,329 @@
+/**
+ * @file phrase_extractor.c
+ * @brief Implementation of the n-gram phrase extractor.
+ *
+ * This file implements the interface defined in phrase_extractor.h. The
+ * rolling hash of a window of n tokens is sum(t[s + k] * B^(n - 1 - k)) over
+ * the token hashes t, modulo 2^64, and is finalized with the length before it
+ * keys the map. Counting towards min_occurrences uses a table of finalized
+ * hashes; each window also links to the previous window with the same hash,
+ * so a phrase reaching the threshold records its earlier occurrences without
+ * a second pass. A PhraseExtractorState keeps the table and the links between
+ * calls, and one-shot extraction uses a state of its own.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include "phrase_extractor.h"
+#include "memory_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ROLLING_BASE 0x9e3779b97f4a7c15ULL // Odd, so B^n never collapses to zero
+#define NO_WINDOW SIZE_MAX
+
+// Times a phrase hash has been seen, and the window that saw it last
+typedef struct
+{
+    uint64_t hash;
+    size_t count;
+    size_t last;
+} PhraseCount;
+
+struct PhraseExtractorState
+{
+    PhraseExtractorConfig config;
+    size_t lengths;
+    PhraseCount *counts;
+    size_t mask;
+    size_t used;      // Hashes in the counting table
+    size_t *previous; // For each window, the previous window with the same hash
+    size_t windows;   // Windows previous has room for
+    size_t *replay;   // Windows of a phrase that just reached the threshold
+    size_t scanned;   // Tokens before this one have been extracted
+};
+
+static uint64_t phrase_finalize(uint64_t rolling, size_t length)
+{
+    uint64_t hash = rolling ^ (length * 0xbf58476d1ce4e5b9ULL);
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+uint64_t phrase_extractor_hash(const Token *tokens, size_t token_count)
+{
+    uint64_t rolling = 0;
+    for (size_t i = 0; i < token_count; i++)
+    {
+        rolling = rolling * ROLLING_BASE + hash_linguistic_element(&tokens[i], 1);
+    }
+    return phrase_finalize(rolling, token_count);
+}
+
+static PhraseCount *state_count(PhraseExtractorState *state, uint64_t hash)
+{
+    for (size_t slot = hash & state->mask;; slot = (slot + 1) & state->mask)
+    {
+        PhraseCount *count = &state->counts[slot];
+        if (count->count == 0 || count->hash == hash)
+        {
+            state->used += count->count == 0;
+            count->hash = hash;
+            return count;
+        }
+    }
+}
+
+/**
+ * @brief Makes room for windows ending before token @p end, @p added of them new.
+ *
+ * The counting table is kept at most half full, so it doubles and rehashes
+ * when the new windows, each possibly a new hash, could fill it further.
+ */
+static ErrorCode state_reserve(PhraseExtractorState *state, size_t end, size_t added)
+{
+    size_t windows = end * state->lengths;
+    if (windows > state->windows)
+    {
+        size_t *previous = limdy_memory_pool_realloc(state->previous, windows * sizeof(size_t));
+        if (!previous)
+        {
+            LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to grow phrase window links");
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        state->previous = previous;
+        state->windows = windows;
+    }
+
+    size_t old_capacity = state->counts ? state->mask + 1 : 0;
+    size_t capacity = old_capacity ? old_capacity : 16;
+    while (capacity < (state->used + added) * 2)
+    {
+        capacity *= 2;
+    }
+    if (capacity == old_capacity)
+    {
+        return ERROR_SUCCESS;
+    }
+
+    PhraseCount *old = state->counts;
+    state->counts = limdy_memory_pool_alloc(capacity * sizeof(PhraseCount));
+    if (!state->counts)
+    {
+        state->counts = old;
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate phrase counting table");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    memset(state->counts, 0, capacity * sizeof(PhraseCount));
+    state->mask = capacity - 1;
+    state->used = 0;
+    for (size_t i = 0; i < old_capacity; i++)
+    {
+        if (old[i].count)
+        {
+            *state_count(state, old[i].hash) = old[i];
+        }
+    }
+    limdy_memory_pool_free(old);
+    return ERROR_SUCCESS;
+}
+
+static ErrorCode state_init(PhraseExtractorState *state, const PhraseExtractorConfig *config, size_t token_hint)
+{
+    *state = (PhraseExtractorState){.config = *config, .lengths = config->max_length - config->min_length + 1};
+    if (config->min_occurrences == 1)
+    {
+        return ERROR_SUCCESS;
+    }
+
+    state->replay = limdy_memory_pool_alloc(config->min_occurrences * sizeof(size_t));
+    if (!state->replay)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate phrase counting table");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    return state_reserve(state, token_hint, token_hint * state->lengths);
+}
+
+static void state_free(PhraseExtractorState *state)
+{
+    limdy_memory_pool_free(state->counts);
+    limdy_memory_pool_free(state->previous);
+    limdy_memory_pool_free(state->replay);
+}
+
+ErrorCode phrase_extractor_validate_config(const PhraseExtractorConfig *config)
+{
+    CHECK_NULL(config, ERROR_NULL_POINTER);
+
+    if (config->min_length == 0 || config->max_length < config->min_length ||
+        config->max_length > LIMDY_PHRASE_EXTRACTOR_MAX_LENGTH || config->min_occurrences == 0)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Invalid phrase extractor configuration");
+        return ERROR_INVALID_ARGUMENT;
+    }
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Extracts the phrases within tokens[first, first + count) into a map.
+ *
+ * A window is named by its last token and its length, counting from the
+ * start of @p tokens, so windows of earlier calls keep their names.
+ */
+static ErrorCode state_extract(PhraseExtractorState *state, Token *tokens, size_t first, size_t count, LinguisticElementMap *map)
+{
+    const PhraseExtractorConfig *config = &state->config;
+    size_t lengths = state->lengths;
+    size_t threshold = config->min_occurrences;
+    state->scanned = first + count;
+    if (count < config->min_length)
+    {
+        return ERROR_SUCCESS;
+    }
+    if (threshold > 1)
+    {
+        RETURN_IF_ERROR(state_reserve(state, first + count, count * lengths));
+    }
+
+    uint64_t powers[LIMDY_PHRASE_EXTRACTOR_MAX_LENGTH + 1];
+    powers[0] = 1;
+    for (size_t n = 1; n <= config->max_length; n++)
+    {
+        powers[n] = powers[n - 1] * ROLLING_BASE;
+    }
+
+    // The token hashes still inside the longest window
+    uint64_t recent[LIMDY_PHRASE_EXTRACTOR_MAX_LENGTH + 1];
+    uint64_t rolling[LIMDY_PHRASE_EXTRACTOR_MAX_LENGTH + 1] = {0};
+    const size_t ring = LIMDY_PHRASE_EXTRACTOR_MAX_LENGTH + 1;
+
+    ErrorCode error = ERROR_SUCCESS;
+    for (size_t k = 0; error == ERROR_SUCCESS && k < count; k++)
+    {
+        size_t i = first + k;
+        uint64_t token_hash = hash_linguistic_element(&tokens[i], 1);
+        recent[k % ring] = token_hash;
+
+        for (size_t n = config->min_length; error == ERROR_SUCCESS && n <= config->max_length; n++)
+        {
+            // Shift the new token in and the one n back out
+            rolling[n] = rolling[n] * ROLLING_BASE + token_hash;
+            if (k >= n)
+            {
+                rolling[n] -= recent[(k - n) % ring] * powers[n];
+            }
+            if (k + 1 < n)
+            {
+                continue;
+            }
+
+            uint64_t hash = phrase_finalize(rolling[n], n);
+            if (threshold == 1)
+            {
+                error = linguistic_element_map_record(map, ELEMENT_PHRASE, hash, &tokens[i + 1 - n], n);
+                continue;
+            }
+
+            size_t window = i * lengths + (n - config->min_length);
+            PhraseCount *seen_count = state_count(state, hash);
+            state->previous[window] = seen_count->count ? seen_count->last : NO_WINDOW;
+            seen_count->last = window;
+            seen_count->count++;
+            if (seen_count->count < threshold)
+            {
+                continue;
+            }
+            if (seen_count->count > threshold)
+            {
+                error = linguistic_element_map_record(map, ELEMENT_PHRASE, hash, &tokens[i + 1 - n], n);
+                continue;
+            }
+
+            // Reached the threshold: record every occurrence so far, oldest first
+            for (size_t r = threshold, seen = window; r > 0; r--, seen = state->previous[seen])
+            {
+                state->replay[r - 1] = seen;
+            }
+            for (size_t r = 0; error == ERROR_SUCCESS && r < threshold; r++)
+            {
+                size_t end = state->replay[r] / lengths;
+                error = linguistic_element_map_record(map, ELEMENT_PHRASE, hash, &tokens[end + 1 - n], n);
+            }
+        }
+    }
+    return error;
+}
+
+ErrorCode phrase_extractor_extract(const PhraseExtractorConfig *config, Token *tokens, size_t token_count, LinguisticElementMap *map)
+{
+    CHECK_NULL(map, ERROR_NULL_POINTER);
+    RETURN_IF_ERROR(phrase_extractor_validate_config(config));
+    if (token_count < config->min_length)
+    {
+        return ERROR_SUCCESS;
+    }
+    CHECK_NULL(tokens, ERROR_NULL_POINTER);
+
+    PhraseExtractorState state;
+    ErrorCode error = state_init(&state, config, token_count);
+    if (error == ERROR_SUCCESS)
+    {
+        error = state_extract(&state, tokens, 0, token_count, map);
+    }
+    state_free(&state);
+    return error;
+}
+
+ErrorCode phrase_extractor_state_create(const PhraseExtractorConfig *config, PhraseExtractorState **state)
+{
+    CHECK_NULL(state, ERROR_NULL_POINTER);
+    RETURN_IF_ERROR(phrase_extractor_validate_config(config));
+
+    PhraseExtractorState *created = limdy_memory_pool_alloc(sizeof(PhraseExtractorState));
+    if (!created)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate phrase extractor state");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    ErrorCode error = state_init(created, config, 0);
+    if (error != ERROR_SUCCESS)
+    {
+        state_free(created);
+        limdy_memory_pool_free(created);
+        return error;
+    }
+
+    *state = created;
+    return ERROR_SUCCESS;
+}
+
+void phrase_extractor_state_destroy(PhraseExtractorState *state)
+{
+    if (state)
+    {
+        state_free(state);
+        limdy_memory_pool_free(state);
+    }
+}
+
+ErrorCode phrase_extractor_extract_more(PhraseExtractorState *state, Token *tokens, size_t first, size_t count, LinguisticElementMap *map)
+{
+    CHECK_NULL(state, ERROR_NULL_POINTER);
+    CHECK_NULL(map, ERROR_NULL_POINTER);
+    if (count > 0)
+    {
+        CHECK_NULL(tokens, ERROR_NULL_POINTER);
+    }
+    if (first < state->scanned)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Tokens from %zu were already extracted, not %zu", state->scanned, first);
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    return state_extract(state, tokens, first, count, map);
+}
@@ -0,0 +1,423 @@
+/**
+ * @file render_cache.c
+ * @brief Implementation of the tokenization result cache.
+ *
+ * This file implements the interface defined in render_cache.h. Every entry
+ * owns an arena holding its copy of the text and its RendererResult, so an
+ * entry is freed with one arena release once the cache and all holders
+ * have dropped their references.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include "render_cache.h"
+#include "limdy_utils.h"
+#include "memory_pool.h"
+#include "arena.h"
+#include "limdy_metrics.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#define FNV_PRIME 1099511628211ULL
+#define FNV_OFFSET 14695981039346656037ULL
+
+typedef struct RenderCacheEntry
+{
+    RendererResult result; // First, so holders' result pointers lead back to the entry
+    struct RenderCacheEntry *next;
+    uint64_t hash;
+    Language lang;
+    const char *text;
+    size_t length;
+    atomic_size_t refs;
+    bool referenced; // CLOCK bit, guarded by the shard mutex
+    LimdyArena arena;
+} RenderCacheEntry;
+
+typedef struct
+{
+    pthread_mutex_t mutex;
+    RenderCacheEntry **buckets;
+    size_t bucket_mask;
+    RenderCacheEntry **ring; // CLOCK order; the first count slots are in use
+    size_t capacity;
+    size_t count;
+    size_t hand;
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+} RenderCacheShard;
+
+struct RenderCache
+{
+    RenderCacheShard shards[LIMDY_RENDER_CACHE_SHARDS];
+};
+
+static uint64_t render_cache_hash(const char *text, size_t length, Language lang)
+{
+    uint64_t hash = FNV_OFFSET;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (uint64_t)(unsigned char)text[i];
+        hash *= FNV_PRIME;
+    }
+    hash ^= (uint64_t)lang;
+    hash *= FNV_PRIME;
+    // FNV leaves short keys clustered; finalize so shard and bucket bits are both well mixed
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+static RenderCacheShard *render_cache_shard(RenderCache *cache, uint64_t hash)
+{
+    return &cache->shards[(hash >> 32) % LIMDY_RENDER_CACHE_SHARDS];
+}
+
+static void entry_unref(RenderCacheEntry *entry)
+{
+    if (atomic_fetch_sub_explicit(&entry->refs, 1, memory_order_acq_rel) == 1)
+    {
+        limdy_arena_release(&entry->arena);
+        limdy_memory_pool_free(entry);
+    }
+}
+
+/**
+ * @brief Finds an entry and takes a reference on it. Called with the shard mutex held.
+ */
+static RenderCacheEntry *shard_find(RenderCacheShard *shard, uint64_t hash, const char *text, size_t length, Language lang)
+{
+    for (RenderCacheEntry *entry = shard->buckets[hash & shard->bucket_mask]; entry; entry = entry->next)
+    {
+        if (entry->hash == hash && entry->lang == lang && entry->length == length && memcmp(entry->text, text, length) == 0)
+        {
+            entry->referenced = true;
+            atomic_fetch_add_explicit(&entry->refs, 1, memory_order_relaxed);
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void shard_unlink(RenderCacheShard *shard, RenderCacheEntry *victim)
+{
+    RenderCacheEntry **link = &shard->buckets[victim->hash & shard->bucket_mask];
+    while (*link != victim)
+    {
+        link = &(*link)->next;
+    }
+    *link = victim->next;
+}
+
+/**
+ * @brief Inserts an entry, evicting by CLOCK when the shard is full. Called with the shard mutex held.
+ */
+static void shard_insert(RenderCacheShard *shard, RenderCacheEntry *entry)
+{
+    size_t slot;
+    if (shard->count < shard->capacity)
+    {
+        slot = shard->count++;
+    }
+    else
+    {
+        // Give recently used entries a second chance; terminates within two sweeps
+        while (shard->ring[shard->hand]->referenced)
+        {
+            shard->ring[shard->hand]->referenced = false;
+            shard->hand = (shard->hand + 1) % shard->capacity;
+        }
+        slot = shard->hand;
+        shard->hand = (shard->hand + 1) % shard->capacity;
+
+        RenderCacheEntry *victim = shard->ring[slot];
+        shard_unlink(shard, victim);
+        shard->evictions++;
+        LIMDY_METRIC_COUNT(LIMDY_COUNTER_RENDER_CACHE_EVICTIONS, 1);
+        entry_unref(victim);
+    }
+
+    shard->ring[slot] = entry;
+    size_t bucket = entry->hash & shard->bucket_mask;
+    entry->next = shard->buckets[bucket];
+    shard->buckets[bucket] = entry;
+    atomic_fetch_add_explicit(&entry->refs, 1, memory_order_relaxed); // The cache's own reference
+}
+
+static void shard_destroy(RenderCacheShard *shard)
+{
+    for (size_t i = 0; shard->ring && i < shard->count; i++)
+    {
+        entry_unref(shard->ring[i]);
+    }
+    limdy_memory_pool_free(shard->ring);
+    limdy_memory_pool_free(shard->buckets);
+    pthread_mutex_destroy(&shard->mutex);
+}
+
+/**
+ * @brief Creates a cache.
+ *
+ * @param capacity Maximum number of entries.
+ * @param cache Pointer to store the created cache.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode render_cache_create(size_t capacity, RenderCache **cache)
+{
+    CHECK_NULL(cache, ERROR_NULL_POINTER);
+    if (capacity == 0)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Render cache capacity must be positive");
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    RenderCache *new_cache = limdy_memory_pool_alloc(sizeof(RenderCache));
+    CHECK_NULL(new_cache, ERROR_MEMORY_ALLOCATION);
+    memset(new_cache, 0, sizeof(RenderCache));
+
+    size_t shard_capacity = (capacity + LIMDY_RENDER_CACHE_SHARDS - 1) / LIMDY_RENDER_CACHE_SHARDS;
+    size_t bucket_count = 1;
+    while (bucket_count < shard_capacity)
+    {
+        bucket_count <<= 1;
+    }
+
+    for (size_t i = 0; i < LIMDY_RENDER_CACHE_SHARDS; i++)
+    {
+        RenderCacheShard *shard = &new_cache->shards[i];
+        if (pthread_mutex_init(&shard->mutex, NULL) != 0)
+        {
+            for (size_t j = 0; j < i; j++)
+            {
+                shard_destroy(&new_cache->shards[j]);
+            }
+            limdy_memory_pool_free(new_cache);
+            LOG_ERROR(ERROR_THREAD_INIT, "Failed to initialize render cache shard mutex");
+            return ERROR_THREAD_INIT;
+        }
+
+        shard->capacity = shard_capacity;
+        shard->bucket_mask = bucket_count - 1;
+        shard->buckets = limdy_memory_pool_alloc(bucket_count * sizeof(RenderCacheEntry *));
+        shard->ring = limdy_memory_pool_alloc(shard_capacity * sizeof(RenderCacheEntry *));
+        if (!shard->buckets || !shard->ring)
+        {
+            for (size_t j = 0; j <= i; j++)
+            {
+                shard_destroy(&new_cache->shards[j]);
+            }
+            limdy_memory_pool_free(new_cache);
+            LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate render cache shard");
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        memset(shard->buckets, 0, bucket_count * sizeof(RenderCacheEntry *));
+    }
+
+    *cache = new_cache;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Destroys a cache.
+ *
+ * @param cache The cache to destroy.
+ */
+void render_cache_destroy(RenderCache *cache)
+{
+    if (cache)
+    {
+        for (size_t i = 0; i < LIMDY_RENDER_CACHE_SHARDS; i++)
+        {
+            shard_destroy(&cache->shards[i]);
+        }
+        limdy_memory_pool_free(cache);
+    }
+}
+
+/**
+ * @brief Builds a new entry holding one reference for the caller.
+ */
+static ErrorCode entry_create(const char *text, size_t length, uint64_t hash, Language lang, RenderCacheFillFn fill, void *context,
+                              RenderCacheEntry **entry)
+{
+    RenderCacheEntry *new_entry = limdy_memory_pool_alloc(sizeof(RenderCacheEntry));
+    CHECK_NULL(new_entry, ERROR_MEMORY_ALLOCATION);
+    memset(new_entry, 0, sizeof(RenderCacheEntry));
+
+    ErrorCode error = limdy_arena_init(&new_entry->arena, LIMDY_RENDER_CACHE_ENTRY_CHUNK_SIZE);
+    if (error != ERROR_SUCCESS)
+    {
+        limdy_memory_pool_free(new_entry);
+        return error;
+    }
+
+    new_entry->hash = hash;
+    new_entry->lang = lang;
+    new_entry->length = length;
+    new_entry->result.arena = &new_entry->arena;
+    atomic_init(&new_entry->refs, 1);
+
+    // Span tokenizers point into the text, so the entry keeps its own copy
+    new_entry->text = limdy_arena_strndup(&new_entry->arena, text, length);
+    error = new_entry->text ? fill(context, new_entry->text, lang, &new_entry->result) : ERROR_MEMORY_ALLOCATION;
+    if (error != ERROR_SUCCESS)
+    {
+        entry_unref(new_entry);
+        return error;
+    }
+
+    *entry = new_entry;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Gets the result for a text, filling and inserting it on a miss.
+ *
+ * @param cache The cache, or NULL.
+ * @param text The text to look up.
+ * @param lang The language of the text.
+ * @param fill Function producing the result on a miss.
+ * @param context Argument passed to fill.
+ * @param result Pointer to store the result.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode render_cache_get(RenderCache *cache, const char *text, Language lang, RenderCacheFillFn fill, void *context,
+                           const RendererResult **result)
+{
+    CHECK_NULL(text, ERROR_NULL_POINTER);
+    CHECK_NULL(fill, ERROR_NULL_POINTER);
+    CHECK_NULL(result, ERROR_NULL_POINTER);
+
+    size_t length = strlen(text);
+    uint64_t hash = render_cache_hash(text, length, lang);
+    RenderCacheEntry *entry = NULL;
+
+    if (!cache)
+    {
+        RETURN_IF_ERROR(entry_create(text, length, hash, lang, fill, context, &entry));
+        *result = &entry->result;
+        return ERROR_SUCCESS;
+    }
+
+    RenderCacheShard *shard = render_cache_shard(cache, hash);
+
+    MUTEX_LOCK(&shard->mutex);
+    entry = shard_find(shard, hash, text, length, lang);
+    if (entry)
+    {
+        shard->hits++;
+        LIMDY_METRIC_COUNT(LIMDY_COUNTER_RENDER_CACHE_HITS, 1);
+    }
+    else
+    {
+        shard->misses++;
+        LIMDY_METRIC_COUNT(LIMDY_COUNTER_RENDER_CACHE_MISSES, 1);
+    }
+    MUTEX_UNLOCK(&shard->mutex);
+
+    if (entry)
+    {
+        *result = &entry->result;
+        return ERROR_SUCCESS;
+    }
+
+    // Fill outside the lock; a concurrent miss on the same text may win the insert
+    RETURN_IF_ERROR(entry_create(text, length, hash, lang, fill, context, &entry));
+
+    pthread_mutex_lock(&shard->mutex);
+    RenderCacheEntry *existing = shard_find(shard, hash, text, length, lang);
+    if (!existing)
+    {
+        shard_insert(shard, entry);
+    }
+    pthread_mutex_unlock(&shard->mutex);
+
+    if (existing)
+    {
+        entry_unref(entry);
+        entry = existing;
+    }
+
+    *result = &entry->result;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Drops a reference obtained from render_cache_get().
+ *
+ * @param result The result to release.
+ */
+void render_cache_release(const RendererResult *result)
+{
+    if (result)
+    {
+        entry_unref((RenderCacheEntry *)result);
+    }
+}
+
+/**
+ * @brief Visits every cached entry, a shard at a time under its lock.
+ *
+ * @param cache The cache.
+ * @param visit Function called once per entry.
+ * @param context Argument passed to visit.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode render_cache_for_each(RenderCache *cache, RenderCacheVisitFn visit, void *context)
+{
+    CHECK_NULL(cache, ERROR_NULL_POINTER);
+    CHECK_NULL(visit, ERROR_NULL_POINTER);
+
+    ErrorCode error = ERROR_SUCCESS;
+    for (size_t i = 0; i < LIMDY_RENDER_CACHE_SHARDS && error == ERROR_SUCCESS; i++)
+    {
+        RenderCacheShard *shard = &cache->shards[i];
+        pthread_mutex_lock(&shard->mutex);
+        for (size_t slot = 0; slot < shard->count && error == ERROR_SUCCESS; slot++)
+        {
+            const RenderCacheEntry *entry = shard->ring[slot];
+            error = visit(context, entry->text, entry->lang, &entry->result);
+        }
+        pthread_mutex_unlock(&shard->mutex);
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the cache's counters.
+ *
+ * @param cache The cache.
+ * @param stats Pointer to store the counters.
+ */
+void render_cache_get_stats(RenderCache *cache, RenderCacheStats *stats)
+{
+    if (!stats)
+    {
+        return;
+    }
+    memset(stats, 0, sizeof(RenderCacheStats));
+    if (!cache)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < LIMDY_RENDER_CACHE_SHARDS; i++)
+    {
+        RenderCacheShard *shard = &cache->shards[i];
+        pthread_mutex_lock(&shard->mutex);
+        stats->hits += shard->hits;
+        stats->misses += shard->misses;
+        stats->evictions += shard->evictions;
+        stats->entries += shard->count;
+        stats->capacity += shard->capacity;
+        pthread_mutex_unlock(&shard->mutex);
+    }
+}
@@ -13,13 +13,48 @@
 #include <stdlib.h>
 #include <string.h>
 #include "renderer.h"
+#include "render_cache.h"
 #include "limdy_utils.h"
+#include "limdy_metrics.h"
+
+/**
+ * @brief Allocate result storage from the result's arena, or its pool if none is set.
+ *
+ * @param result The result the storage belongs to.
+ * @param size Number of bytes.
+ * @return The storage, or NULL on failure.
+ */
+void *renderer_result_alloc(RendererResult *result, size_t size)
+{
+    return result->arena ? limdy_arena_alloc(result->arena, size) : limdy_memory_pool_alloc_from(result->pool, size);
+}
+
+/**
+ * @brief Return result storage; a no-op for arena-backed results.
+ */
+static void result_free(RendererResult *result, void *ptr)
+{
+    if (!result->arena)
+    {
+        limdy_memory_pool_free_to(result->pool, ptr);
+    }
+}
+
+/**
+ * @brief Initialize a linguistic element map on the result's backing storage.
+ */
+static ErrorCode result_map_init(RendererResult *result, LinguisticElementMap *map, size_t capacity)
+{
+    return result->arena ? linguistic_element_map_init_arena(map, capacity, result->arena)
+                         : linguistic_element_map_init(map, capacity, result->pool);
+}
 
 /**
  * @brief Create a new Renderer.
  *
  * This function initializes a new Renderer with the given memory pool and services.
- * It also initializes the mutex for thread safety.
+ * The Renderer is immutable afterwards, so it can be shared between threads
+ * without locking.
  *
  * @param pool Memory pool to use for allocations.
  * @param tokenization_service The tokenization service to use.
@@ -28,23 +63,29 @@
  */
 Renderer *renderer_create(LimdyMemoryPool *pool, TokenizationService *tokenization_service, ClassificationService *classification_service)
 {
-    CHECK_NULL(pool, ERROR_NULL_POINTER);
-    CHECK_NULL(tokenization_service, ERROR_NULL_POINTER);
-    CHECK_NULL(classification_service, ERROR_NULL_POINTER);
+    // CHECK_NULL would return the error code as a pointer here
+    if (!pool || !tokenization_service || !classification_service)
+    {
+        LOG_ERROR(ERROR_NULL_POINTER, "Null pool or service");
+        return NULL;
+    }
 
     Renderer *renderer = limdy_memory_pool_alloc_from(pool, sizeof(Renderer));
-    CHECK_NULL(renderer, ERROR_MEMORY_ALLOCATION);
+    if (!renderer)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate Renderer");
+        return NULL;
+    }
 
     renderer->pool = pool;
     renderer->tokenization_service = tokenization_service;
     renderer->classification_service = classification_service;
-
-    if (pthread_mutex_init(&renderer->mutex, NULL) != 0)
-    {
-        LOG_ERROR(ERROR_THREAD_INIT, "Failed to initialize mutex for Renderer");
-        limdy_memory_pool_free_to(pool, renderer);
-        return NULL;
-    }
+    renderer->cache = NULL;
+    renderer->phrase_config = LIMDY_PHRASE_EXTRACTOR_CONFIG_DEFAULT;
+    renderer->workers = NULL;
+    renderer->segment_bytes = LIMDY_RENDERER_SEGMENT_BYTES;
+    renderer->cache_source = NULL;
+    renderer->cache_source_context = NULL;
 
     return renderer;
 }
@@ -53,8 +94,7 @@ Renderer *renderer_create(LimdyMemoryPool *pool, TokenizationService *tokenizati
  * @brief Destroy a Renderer and free its resources.
  *
  * This function destroys the given Renderer, freeing all associated resources,
- * including the tokenization and classification services. It also destroys
- * the mutex used for thread safety.
+ * including the tokenization and classification services.
  *
  * @param renderer The Renderer to destroy.
  */
@@ -62,10 +102,10 @@ void renderer_destroy(Renderer *renderer)
 {
     CHECK_NULL(renderer, ERROR_NULL_POINTER);
 
-    if (pthread_mutex_destroy(&renderer->mutex) != 0)
+    render_cache_destroy(renderer->cache);
+    if (renderer->workers)
     {
-        LOG_ERROR(ERROR_THREAD_UNLOCK, "Failed to destroy mutex for Renderer");
-        // Continue with destruction even if mutex destruction fails
+        limdy_thread_pool_destroy(renderer->workers);
     }
 
     // Destroy the tokenization service
@@ -92,84 +132,142 @@ void renderer_destroy(Renderer *renderer)
 }
 
 /**
- * @brief Tokenize text in the specified language.
- *
- * This function is thread-safe.
- *
- * @param renderer The Renderer to use.
- * @param text The text to tokenize.
- * @param lang The language of the text.
- * @param result Pointer to store the rendering result.
- * @return ErrorCode indicating success or failure.
+ * @brief Tokenize straight into a span array, without copying any text.
  */
-ErrorCode renderer_tokenize(Renderer *renderer, const char *text, Language lang, RendererResult *result)
+static ErrorCode tokenize_spans(TokenizationService *service, const char *text, Language lang, RendererResult *result)
 {
-    CHECK_NULL(renderer, ERROR_NULL_POINTER);
-    CHECK_NULL(text, ERROR_NULL_POINTER);
-    CHECK_NULL(result, ERROR_NULL_POINTER);
-
-    ErrorCode error = ERROR_SUCCESS;
-
-    pthread_mutex_lock(&renderer->mutex);
+    size_t length = strlen(text);
+    size_t capacity = length / LIMDY_RENDERER_BYTES_PER_TOKEN_ESTIMATE + 1;
+    if (length > LIMDY_TOKEN_MAX_TEXT_LENGTH)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Text of %zu bytes is too long to tokenize", length);
+        return ERROR_INVALID_ARGUMENT;
+    }
 
-    do
+    for (;;)
     {
-        if (!renderer->tokenization_service || !renderer->tokenization_service->tokenize)
+        Token *spans = renderer_result_alloc(result, sizeof(Token) * capacity);
+        if (!spans)
         {
-            error = ERROR_RENDERER_SERVICE_UNAVAILABLE;
-            break;
+            return ERROR_MEMORY_ALLOCATION;
         }
+        memset(spans, 0, sizeof(Token) * capacity);
 
-        error = renderer->tokenization_service->tokenize(text, lang, &result->tokens, &result->token_count);
+        size_t count = 0;
+        ErrorCode error = tokenization_service_tokenize_spans(service, text, length, lang, spans, capacity, &count);
         if (error != ERROR_SUCCESS)
         {
-            break;
+            result_free(result, spans);
+            return error;
         }
 
-        // Allocate memory for tokens from the result's pool
-        Token *pooled_tokens = limdy_memory_pool_alloc_from(result->pool, sizeof(Token) * result->token_count);
-        if (!pooled_tokens)
+        if (count <= capacity)
         {
-            error = ERROR_MEMORY_ALLOCATION;
-            break;
-        }
-
-        // Copy tokens to the pooled memory
-        for (size_t i = 0; i < result->token_count; i++)
-        {
-            pooled_tokens[i] = result->tokens[i];
-            pooled_tokens[i].text = limdy_memory_pool_alloc_from(result->pool, result->tokens[i].length + 1);
-            if (!pooled_tokens[i].text)
+            for (size_t i = 0; i < count; i++)
             {
-                error = ERROR_MEMORY_ALLOCATION;
-                break;
+                spans[i].text = (char *)text + spans[i].offset;
             }
-            memcpy(pooled_tokens[i].text, result->tokens[i].text, result->tokens[i].length + 1);
+            result->tokens = spans;
+            result->token_count = count;
+            result->source = text;
+            return ERROR_SUCCESS;
         }
 
-        if (error == ERROR_SUCCESS)
-        {
-            // Free the original tokens and replace with pooled tokens
-            renderer->tokenization_service->free_tokens(result->tokens, result->token_count);
-            result->tokens = pooled_tokens;
-        }
-        else
-        {
-            // Clean up on error
-            for (size_t i = 0; i < result->token_count; i++)
-            {
-                if (pooled_tokens[i].text)
-                {
-                    limdy_memory_pool_free_to(result->pool, pooled_tokens[i].text);
-                }
-            }
-            limdy_memory_pool_free_to(result->pool, pooled_tokens);
-        }
+        // The estimate was short; the tokenizer told us the exact count
+        result_free(result, spans);
+        capacity = count;
+    }
+}
 
-    } while (0);
+/**
+ * @brief Copy a tokenizer's output into one block: the token array followed by the interned text.
+ */
+static ErrorCode tokenize_copy(TokenizationService *service, const char *text, Language lang, RendererResult *result)
+{
+    Token *tokens = NULL;
+    size_t count = 0;
 
-    pthread_mutex_unlock(&renderer->mutex);
+    ErrorCode error = service->tokenize(text, lang, &tokens, &count);
+    if (error != ERROR_SUCCESS)
+    {
+        return error;
+    }
 
+    size_t text_bytes = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        text_bytes += tokens[i].length + 1;
+    }
+    if (text_bytes > LIMDY_TOKEN_MAX_TEXT_LENGTH)
+    {
+        service->free_tokens(tokens, count);
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Token text of %zu bytes is too long to intern", text_bytes);
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    char *block = renderer_result_alloc(result, sizeof(Token) * count + text_bytes);
+    if (!block)
+    {
+        service->free_tokens(tokens, count);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    Token *pooled_tokens = (Token *)block;
+    char *interned = block + sizeof(Token) * count;
+    size_t offset = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        pooled_tokens[i] = tokens[i];
+        pooled_tokens[i].text = interned + offset;
+        pooled_tokens[i].offset = offset;
+        memcpy(pooled_tokens[i].text, tokens[i].text, tokens[i].length);
+        pooled_tokens[i].text[tokens[i].length] = '\0';
+        offset += tokens[i].length + 1;
+    }
+
+    service->free_tokens(tokens, count);
+
+    result->tokens = pooled_tokens;
+    result->token_count = count;
+    result->source = interned;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Tokenize text in the specified language.
+ *
+ * This function is thread-safe. Span tokenizers write straight into the
+ * result; other tokenizers' output is copied with a single allocation.
+ *
+ * @param renderer The Renderer to use.
+ * @param text The text to tokenize.
+ * @param lang The language of the text.
+ * @param result Pointer to store the rendering result.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode renderer_tokenize(Renderer *renderer, const char *text, Language lang, RendererResult *result)
+{
+    CHECK_NULL(renderer, ERROR_NULL_POINTER);
+    CHECK_NULL(text, ERROR_NULL_POINTER);
+    CHECK_NULL(result, ERROR_NULL_POINTER);
+
+    TokenizationService *service = renderer->tokenization_service;
+    if (!service)
+    {
+        return ERROR_RENDERER_SERVICE_UNAVAILABLE;
+    }
+
+    LIMDY_METRIC_TIME_BEGIN(started);
+    ErrorCode error = ERROR_RENDERER_SERVICE_UNAVAILABLE;
+    if (service->tokenize_spans)
+    {
+        error = tokenize_spans(service, text, lang, result);
+    }
+    else if (service->tokenize && service->free_tokens)
+    {
+        error = tokenize_copy(service, text, lang, result);
+    }
+    LIMDY_METRIC_TIME_END(started, LIMDY_HISTOGRAM_TOKENIZE_NS);
     return error;
 }
 
@@ -189,8 +287,7 @@ ErrorCode renderer_classify(Renderer *renderer, RendererResult *result)
     CHECK_NULL(result->tokens, ERROR_NULL_POINTER);
 
     ErrorCode error = ERROR_SUCCESS;
-
-    pthread_mutex_lock(&renderer->mutex);
+    LIMDY_METRIC_TIME_BEGIN(started);
 
     do
     {
@@ -208,8 +305,7 @@ ErrorCode renderer_classify(Renderer *renderer, RendererResult *result)
 
     } while (0);
 
-    pthread_mutex_unlock(&renderer->mutex);
-
+    LIMDY_METRIC_TIME_END(started, LIMDY_HISTOGRAM_CLASSIFY_NS);
     return error;
 }
 
@@ -229,58 +325,209 @@ ErrorCode renderer_extract_elements(Renderer *renderer, RendererResult *result)
     CHECK_NULL(result->tokens, ERROR_NULL_POINTER);
 
     ErrorCode error = ERROR_SUCCESS;
-
-    pthread_mutex_lock(&renderer->mutex);
+    LIMDY_METRIC_TIME_BEGIN(started);
 
     do
     {
         // Initialize linguistic element maps
-        error = linguistic_element_map_init(&result->vocab_map, result->token_count, result->pool);
+        error = result_map_init(result, &result->vocab_map, result->token_count);
         if (error != ERROR_SUCCESS)
             break;
 
-        error = linguistic_element_map_init(&result->phrase_map, result->token_count / 2, result->pool);
+        error = result_map_init(result, &result->phrase_map, result->token_count / 2);
         if (error != ERROR_SUCCESS)
             break;
 
-        error = linguistic_element_map_init(&result->syntax_map, result->token_count / 2, result->pool);
+        error = result_map_init(result, &result->syntax_map, result->token_count / 2);
         if (error != ERROR_SUCCESS)
             break;
 
-        // Extract vocab (single tokens)
+        // Extract vocab (single tokens), one element per distinct token with an occurrence per use
         for (size_t i = 0; i < result->token_count; i++)
         {
-            Token **token_ptr = limdy_memory_pool_alloc_from(result->pool, sizeof(Token *));
-            if (!token_ptr)
-            {
-                error = ERROR_MEMORY_ALLOCATION;
-                break;
-            }
-            *token_ptr = &result->tokens[i];
-
-            TypedLinguisticElement element = {
-                .type = ELEMENT_VOCAB,
-                .element = {
-                    .tokens = token_ptr,
-                    .token_count = 1,
-                    .hash = hash_token(&result->tokens[i]) // Implement this hash function
-                }};
-            error = linguistic_element_map_add(&result->vocab_map, &element);
+            error = linguistic_element_map_record(&result->vocab_map, ELEMENT_VOCAB, hash_linguistic_element(&result->tokens[i], 1),
+                                                  &result->tokens[i], 1);
             if (error != ERROR_SUCCESS)
                 break;
         }
+        if (error != ERROR_SUCCESS)
+            break;
 
-        // TODO: Implement phrase and syntax extraction
-        // This would involve analyzing the tokens to identify phrases and syntactic structures
-        // You'll need to implement the logic for creating and hashing these more complex structures
+        // Extract phrases (recurring n-grams)
+        error = phrase_extractor_extract(&renderer->phrase_config, result->tokens, result->token_count, &result->phrase_map);
+        if (error != ERROR_SUCCESS)
+            break;
+
+        // TODO: Implement syntax extraction
+        // This would involve analyzing the classified tokens to identify syntactic structures
 
     } while (0);
 
-    pthread_mutex_unlock(&renderer->mutex);
+    LIMDY_METRIC_TIME_END(started, LIMDY_HISTOGRAM_EXTRACT_NS);
+    return error;
+}
+
+/**
+ * @brief A piece of the text rendered on its own in parallel mode.
+ */
+typedef struct
+{
+    const char *text;   // Start of the segment in the whole text
+    size_t length;      // Bytes in the segment
+    Token *tokens;      // Tokens relative to the segment, owned by the segment
+    size_t token_count; // Number of tokens
+    ErrorCode error;    // Outcome of tokenizing and classifying the segment
+} RenderSegment;
+
+typedef struct
+{
+    Renderer *renderer;
+    Language lang;
+    RenderSegment *segments;
+} ParallelRender;
+
+/**
+ * @brief Find where the segment starting at @p start should end: after the first sentence end past the target size.
+ */
+static size_t segment_end(const char *text, size_t length, size_t start, size_t target)
+{
+    if (length - start <= target)
+    {
+        return length;
+    }
+
+    for (size_t i = start + target; i + 1 < length; i++)
+    {
+        bool sentence_end = text[i] == '.' || text[i] == '!' || text[i] == '?' || text[i] == '\n';
+        char next = text[i + 1];
+        if (sentence_end && (next == ' ' || next == '\t' || next == '\n' || next == '\r'))
+        {
+            return i + 2;
+        }
+    }
+    return length;
+}
+
+/**
+ * @brief Tokenize one segment and classify its tokens as one batch; runs on a worker.
+ */
+static void render_segment(void *arg, size_t index)
+{
+    ParallelRender *job = arg;
+    RenderSegment *segment = &job->segments[index];
+    TokenizationService *service = job->renderer->tokenization_service;
+    size_t capacity = segment->length / LIMDY_RENDERER_BYTES_PER_TOKEN_ESTIMATE + 1;
+
+    for (;;)
+    {
+        segment->tokens = limdy_memory_pool_alloc(capacity * sizeof(Token));
+        if (!segment->tokens)
+        {
+            segment->error = ERROR_MEMORY_ALLOCATION;
+            return;
+        }
+        memset(segment->tokens, 0, capacity * sizeof(Token));
+
+        segment->error = tokenization_service_tokenize_spans(service, segment->text, segment->length, job->lang, segment->tokens,
+                                                             capacity, &segment->token_count);
+        if (segment->error != ERROR_SUCCESS || segment->token_count <= capacity)
+        {
+            break;
+        }
+
+        // The estimate was short; the tokenizer told us the exact count
+        capacity = segment->token_count;
+        limdy_memory_pool_free(segment->tokens);
+    }
+    if (segment->error != ERROR_SUCCESS || segment->token_count == 0)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < segment->token_count; i++)
+    {
+        segment->tokens[i].text = (char *)segment->text + segment->tokens[i].offset;
+    }
+    segment->error = job->renderer->classification_service->classify(segment->tokens, segment->token_count);
+}
+
+/**
+ * @brief Tokenize and classify a text's segments on the workers, then join their tokens in order.
+ */
+static ErrorCode render_parallel(Renderer *renderer, const char *text, size_t length, Language lang, RendererResult *result)
+{
+    size_t max_segments = length / renderer->segment_bytes + 1;
+    RenderSegment *segments = limdy_memory_pool_alloc(max_segments * sizeof(RenderSegment));
+    if (!segments)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate render segments");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    memset(segments, 0, max_segments * sizeof(RenderSegment));
+
+    size_t segment_count = 0;
+    for (size_t start = 0; start < length; segment_count++)
+    {
+        size_t end = segment_end(text, length, start, renderer->segment_bytes);
+        segments[segment_count].text = text + start;
+        segments[segment_count].length = end - start;
+        start = end;
+    }
+
+    ParallelRender job = {renderer, lang, segments};
+    ErrorCode error = limdy_thread_pool_parallel_for(renderer->workers, segment_count, render_segment, &job);
+
+    size_t token_count = 0;
+    for (size_t i = 0; error == ERROR_SUCCESS && i < segment_count; i++)
+    {
+        error = segments[i].error;
+        token_count += segments[i].token_count;
+    }
+
+    if (error == ERROR_SUCCESS)
+    {
+        Token *tokens = renderer_result_alloc(result, sizeof(Token) * (token_count ? token_count : 1));
+        if (!tokens)
+        {
+            error = ERROR_MEMORY_ALLOCATION;
+        }
+        else
+        {
+            // Segment order is text order, so the join is the serial token array
+            size_t next = 0;
+            for (size_t i = 0; i < segment_count; i++)
+            {
+                size_t base = segments[i].text - text;
+                for (size_t j = 0; j < segments[i].token_count; j++, next++)
+                {
+                    tokens[next] = segments[i].tokens[j];
+                    tokens[next].offset += base;
+                }
+            }
+            result->tokens = tokens;
+            result->token_count = token_count;
+            result->source = text;
+        }
+    }
 
+    for (size_t i = 0; i < segment_count; i++)
+    {
+        limdy_memory_pool_free(segments[i].tokens);
+    }
+    limdy_memory_pool_free(segments);
     return error;
 }
 
+/**
+ * @brief Whether renderer_render() should split a text of @p length bytes over the workers.
+ */
+static bool render_in_parallel(const Renderer *renderer, size_t length)
+{
+    return renderer->workers && length >= 2 * renderer->segment_bytes && renderer->tokenization_service &&
+           renderer->tokenization_service->tokenize_spans && renderer->classification_service &&
+           renderer->classification_service->classify;
+}
+
 /**
  * @brief Perform full rendering (tokenization, classification, and extraction) on text.
  *
@@ -300,23 +547,46 @@ ErrorCode renderer_render(Renderer *renderer, const char *text, Language lang, R
 
     ErrorCode error;
 
-    // Initialize result
+    // Initialize result, keeping the caller's backing storage
+    LimdyMemoryPool *pool = result->pool;
+    LimdyArena *arena = result->arena;
     memset(result, 0, sizeof(RendererResult));
+    result->pool = pool;
+    result->arena = arena;
 
-    // Tokenize
-    error = renderer_tokenize(renderer, text, lang, result);
-    if (error != ERROR_SUCCESS)
+    size_t length = strlen(text);
+    if (length > LIMDY_TOKEN_MAX_TEXT_LENGTH)
     {
-        renderer_free_result(renderer, result);
-        return error;
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Text of %zu bytes is too long to render", length);
+        return ERROR_INVALID_ARGUMENT;
     }
-
-    // Classify
-    error = renderer_classify(renderer, result);
-    if (error != ERROR_SUCCESS)
+    if (render_in_parallel(renderer, length))
     {
-        renderer_free_result(renderer, result);
-        return error;
+        // Tokenize and classify segment by segment
+        error = render_parallel(renderer, text, length, lang, result);
+        if (error != ERROR_SUCCESS)
+        {
+            renderer_free_result(renderer, result);
+            return error;
+        }
+    }
+    else
+    {
+        // Tokenize
+        error = renderer_tokenize(renderer, text, lang, result);
+        if (error != ERROR_SUCCESS)
+        {
+            renderer_free_result(renderer, result);
+            return error;
+        }
+
+        // Classify
+        error = renderer_classify(renderer, result);
+        if (error != ERROR_SUCCESS)
+        {
+            renderer_free_result(renderer, result);
+            return error;
+        }
     }
 
     // Extract elements
@@ -330,6 +600,148 @@ ErrorCode renderer_render(Renderer *renderer, const char *text, Language lang, R
     return ERROR_SUCCESS;
 }
 
+/**
+ * @brief Enable parallel mode for renderer_render().
+ *
+ * @param renderer The Renderer to configure.
+ * @param thread_count Number of workers, or 0 for one per online CPU.
+ * @param segment_bytes Target segment size, or 0 for LIMDY_RENDERER_SEGMENT_BYTES.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode renderer_enable_parallel(Renderer *renderer, size_t thread_count, size_t segment_bytes)
+{
+    CHECK_NULL(renderer, ERROR_NULL_POINTER);
+
+    LimdyThreadPool *workers = NULL;
+    RETURN_IF_ERROR(limdy_thread_pool_create(thread_count, &workers));
+
+    if (renderer->workers)
+    {
+        limdy_thread_pool_destroy(renderer->workers);
+    }
+    renderer->workers = workers;
+    renderer->segment_bytes = segment_bytes ? segment_bytes : LIMDY_RENDERER_SEGMENT_BYTES;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Enable the tokenization cache.
+ *
+ * @param renderer The Renderer to configure.
+ * @param capacity Maximum number of cached texts.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode renderer_enable_cache(Renderer *renderer, size_t capacity)
+{
+    CHECK_NULL(renderer, ERROR_NULL_POINTER);
+
+    RenderCache *cache = NULL;
+    RETURN_IF_ERROR(render_cache_create(capacity, &cache));
+
+    render_cache_destroy(renderer->cache);
+    renderer->cache = cache;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Set which phrases renderer_extract_elements() records.
+ *
+ * @param renderer The Renderer to configure.
+ * @param config The phrase extractor configuration.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode renderer_set_phrase_config(Renderer *renderer, const PhraseExtractorConfig *config)
+{
+    CHECK_NULL(renderer, ERROR_NULL_POINTER);
+    RETURN_IF_ERROR(phrase_extractor_validate_config(config));
+
+    renderer->phrase_config = *config;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Set where cache misses are looked up before tokenizing.
+ *
+ * @param renderer The Renderer to configure.
+ * @param source The source, or NULL.
+ * @param context Argument passed to the source.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode renderer_set_cache_source(Renderer *renderer, RenderCacheFillFn source, void *context)
+{
+    CHECK_NULL(renderer, ERROR_NULL_POINTER);
+
+    renderer->cache_source = source;
+    renderer->cache_source_context = source ? context : NULL;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Fill function for cache entries: ask the cache source, else tokenize, then classify when a classifier is set.
+ */
+static ErrorCode renderer_fill_shared(void *context, const char *text, Language lang, RendererResult *result)
+{
+    Renderer *renderer = context;
+
+    if (renderer->cache_source)
+    {
+        // A source's result was classified when it was first produced
+        ErrorCode error = renderer->cache_source(renderer->cache_source_context, text, lang, result);
+        if (error != LIMDY_RENDER_CACHE_ERROR_MISS)
+        {
+            return error;
+        }
+    }
+
+    RETURN_IF_ERROR(renderer_tokenize(renderer, text, lang, result));
+    if (renderer->classification_service && renderer->classification_service->classify)
+    {
+        RETURN_IF_ERROR(renderer_classify(renderer, result));
+    }
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Tokenize and classify text into a shared, immutable result.
+ *
+ * This function is thread-safe.
+ *
+ * @param renderer The Renderer to use.
+ * @param text The text to tokenize.
+ * @param lang The language of the text.
+ * @param result Pointer to store the result.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode renderer_tokenize_shared(Renderer *renderer, const char *text, Language lang, const RendererResult **result)
+{
+    CHECK_NULL(renderer, ERROR_NULL_POINTER);
+
+    return render_cache_get(renderer->cache, text, lang, renderer_fill_shared, renderer, result);
+}
+
+/**
+ * @brief Release a result obtained from renderer_tokenize_shared().
+ *
+ * @param renderer The Renderer that produced the result.
+ * @param result The result to release.
+ */
+void renderer_release_shared(Renderer *renderer, const RendererResult *result)
+{
+    (void)renderer;
+    render_cache_release(result);
+}
+
+/**
+ * @brief Get the counters of the tokenization cache.
+ *
+ * @param renderer The Renderer to query.
+ * @param stats Pointer to store the counters.
+ */
+void renderer_get_cache_stats(Renderer *renderer, RenderCacheStats *stats)
+{
+    render_cache_get_stats(renderer ? renderer->cache : NULL, stats);
+}
+
 /**
  * @brief Free the resources of a RendererResult.
  *
@@ -343,13 +755,12 @@ void renderer_free_result(Renderer *renderer, RendererResult *result)
     CHECK_NULL(renderer, ERROR_NULL_POINTER);
     CHECK_NULL(result, ERROR_NULL_POINTER);
 
-    pthread_mutex_lock(&renderer->mutex);
-
     linguistic_element_map_free(&result->vocab_map);
     linguistic_element_map_free(&result->phrase_map);
     linguistic_element_map_free(&result->syntax_map);
 
-    if (result->pool)
+    // Arena storage is released by the arena's owner
+    if (result->pool && !result->arena)
     {
         limdy_memory_pool_destroy(result->pool);
         result->pool = NULL;
@@ -357,6 +768,5 @@ void renderer_free_result(Renderer *renderer, RendererResult *result)
 
     result->tokens = NULL;
     result->token_count = 0;
-
-    pthread_mutex_unlock(&renderer->mutex);
+    result->source = NULL;
 }
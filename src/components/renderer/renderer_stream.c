@@ -0,0 +1,392 @@
+/**
+ * @file renderer_stream.c
+ * @brief Implementation of incremental rendering.
+ *
+ * This file implements the interface defined in renderer_stream.h. Pushed
+ * chunks wait in a fixed ring guarded by the stream's mutex. The worker
+ * appends each chunk to the text held back from the previous one, tokenizes
+ * the lot, renders every token but the last as one batch in a reused arena,
+ * and keeps the last token's text for the next round.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include "renderer_stream.h"
+#include "arena.h"
+#include "memory_pool.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+typedef struct
+{
+    char *data;
+    size_t length;
+} StreamChunk;
+
+struct RendererStream
+{
+    Renderer *renderer;
+    Language lang;
+    RendererStreamConfig config;
+    RendererStreamFn callback;
+    void *context;
+
+    // Shared with the worker, under mutex
+    pthread_mutex_t mutex;
+    pthread_cond_t chunk_available;
+    pthread_cond_t slot_available;
+    StreamChunk *queue; // Ring of config.max_pending_chunks chunks
+    size_t head;        // Next chunk to render
+    size_t queued;      // Chunks waiting
+    bool finishing;
+    bool cancelled;
+    ErrorCode error; // First error of the worker, sticky
+    pthread_t worker;
+    bool joined;
+
+    // Owned by the worker
+    char *buffer;           // Held-back text followed by the newest chunk
+    size_t buffer_length;   // Bytes in buffer
+    size_t buffer_capacity; // Bytes allocated for buffer
+    size_t buffer_offset;   // Offset of buffer[0] in the document
+    Token *spans;           // Token array reused by every batch
+    size_t span_capacity;   // Entries allocated for spans
+    LimdyArena arena;       // Storage of the batch being rendered, reset after it
+};
+
+static ErrorCode stream_append(RendererStream *stream, const char *chunk, size_t length)
+{
+    size_t needed = stream->buffer_length + length;
+    if (needed > stream->buffer_capacity)
+    {
+        size_t capacity = stream->buffer_capacity ? stream->buffer_capacity : length;
+        while (capacity < needed)
+        {
+            capacity *= 2;
+        }
+        char *buffer = limdy_memory_pool_realloc(stream->buffer, capacity);
+        if (!buffer)
+        {
+            LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to grow stream buffer to %zu bytes", capacity);
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        stream->buffer = buffer;
+        stream->buffer_capacity = capacity;
+    }
+
+    memcpy(stream->buffer + stream->buffer_length, chunk, length);
+    stream->buffer_length = needed;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Grow the reused token array to hold at least capacity spans.
+ */
+static ErrorCode stream_reserve_spans(RendererStream *stream, size_t capacity)
+{
+    if (capacity <= stream->span_capacity)
+    {
+        return ERROR_SUCCESS;
+    }
+
+    Token *spans = limdy_memory_pool_realloc(stream->spans, sizeof(Token) * capacity);
+    if (!spans)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to grow stream token array to %zu tokens", capacity);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    stream->spans = spans;
+    stream->span_capacity = capacity;
+    return ERROR_SUCCESS;
+}
+
+static ErrorCode stream_tokenize(RendererStream *stream, size_t *token_count)
+{
+    TokenizationService *service = stream->renderer->tokenization_service;
+    RETURN_IF_ERROR(stream_reserve_spans(stream, stream->buffer_length / LIMDY_RENDERER_BYTES_PER_TOKEN_ESTIMATE + 1));
+
+    for (;;)
+    {
+        memset(stream->spans, 0, sizeof(Token) * stream->span_capacity);
+        RETURN_IF_ERROR(tokenization_service_tokenize_spans(service, stream->buffer, stream->buffer_length, stream->lang,
+                                                            stream->spans, stream->span_capacity, token_count));
+        if (*token_count <= stream->span_capacity)
+        {
+            return ERROR_SUCCESS;
+        }
+
+        // The estimate was short; the tokenizer told us the exact count
+        RETURN_IF_ERROR(stream_reserve_spans(stream, *token_count));
+    }
+}
+
+/**
+ * @brief Render the buffered text, holding back the last token unless this is the end of the document.
+ */
+static ErrorCode stream_render(RendererStream *stream, bool final)
+{
+    if (stream->buffer_length == 0)
+    {
+        return ERROR_SUCCESS;
+    }
+
+    size_t count = 0;
+    RETURN_IF_ERROR(stream_tokenize(stream, &count));
+
+    size_t emit = count;
+    size_t cut = stream->buffer_length;
+    if (!final && count > 0)
+    {
+        // The last token may go on in the next chunk
+        emit = count - 1;
+        cut = stream->spans[count - 1].offset;
+        if (emit == 0 && stream->buffer_length - cut > stream->config.max_carry)
+        {
+            emit = count;
+            cut = stream->buffer_length;
+        }
+    }
+
+    ErrorCode error = ERROR_SUCCESS;
+    if (emit > 0)
+    {
+        for (size_t i = 0; i < emit; i++)
+        {
+            stream->spans[i].text = stream->buffer + stream->spans[i].offset;
+        }
+
+        RendererResult batch = {
+            .tokens = stream->spans,
+            .token_count = emit,
+            .source = stream->buffer,
+            .arena = &stream->arena};
+        error = renderer_classify(stream->renderer, &batch);
+        if (error == ERROR_SUCCESS)
+        {
+            error = renderer_extract_elements(stream->renderer, &batch);
+        }
+        if (error == ERROR_SUCCESS)
+        {
+            error = stream->callback(stream->context, &batch, stream->buffer_offset);
+        }
+        renderer_free_result(stream->renderer, &batch);
+        limdy_arena_reset(&stream->arena);
+    }
+
+    memmove(stream->buffer, stream->buffer + cut, stream->buffer_length - cut);
+    stream->buffer_length -= cut;
+    stream->buffer_offset += cut;
+    return error;
+}
+
+static void *stream_main(void *arg)
+{
+    RendererStream *stream = arg;
+
+    pthread_mutex_lock(&stream->mutex);
+    for (;;)
+    {
+        while (!stream->queued && !stream->finishing && !stream->cancelled)
+        {
+            pthread_cond_wait(&stream->chunk_available, &stream->mutex);
+        }
+        if (stream->cancelled || stream->error != ERROR_SUCCESS || !stream->queued)
+        {
+            break; // Cancelled, failed, or finishing and drained
+        }
+
+        StreamChunk chunk = stream->queue[stream->head];
+        stream->head = (stream->head + 1) % stream->config.max_pending_chunks;
+        stream->queued--;
+        pthread_cond_signal(&stream->slot_available);
+        pthread_mutex_unlock(&stream->mutex);
+
+        ErrorCode error = stream_append(stream, chunk.data, chunk.length);
+        limdy_memory_pool_free(chunk.data);
+        if (error == ERROR_SUCCESS)
+        {
+            error = stream_render(stream, false);
+        }
+
+        pthread_mutex_lock(&stream->mutex);
+        if (error != ERROR_SUCCESS)
+        {
+            // Blocked pushers must see the error rather than wait for room
+            stream->error = error;
+            pthread_cond_broadcast(&stream->slot_available);
+        }
+    }
+    bool flush = !stream->cancelled && stream->error == ERROR_SUCCESS;
+    pthread_mutex_unlock(&stream->mutex);
+
+    if (flush)
+    {
+        ErrorCode error = stream_render(stream, true);
+        pthread_mutex_lock(&stream->mutex);
+        stream->error = error;
+        pthread_mutex_unlock(&stream->mutex);
+    }
+    return NULL;
+}
+
+ErrorCode renderer_stream_create(Renderer *renderer, Language lang, const RendererStreamConfig *config,
+                                 RendererStreamFn callback, void *context, RendererStream **stream)
+{
+    CHECK_NULL(renderer, ERROR_NULL_POINTER);
+    CHECK_NULL(callback, ERROR_NULL_POINTER);
+    CHECK_NULL(stream, ERROR_NULL_POINTER);
+
+    if (!renderer->tokenization_service || !renderer->tokenization_service->tokenize_spans)
+    {
+        LOG_ERROR(ERROR_RENDERER_SERVICE_UNAVAILABLE, "Streaming needs a span tokenizer");
+        return ERROR_RENDERER_SERVICE_UNAVAILABLE;
+    }
+
+    RendererStreamConfig limits = config ? *config : LIMDY_RENDERER_STREAM_CONFIG_DEFAULT;
+    if (limits.max_pending_chunks == 0)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "A stream needs room for at least one pending chunk");
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    RendererStream *new_stream = limdy_memory_pool_alloc(sizeof(RendererStream));
+    CHECK_NULL(new_stream, ERROR_MEMORY_ALLOCATION);
+    memset(new_stream, 0, sizeof(RendererStream));
+    new_stream->renderer = renderer;
+    new_stream->lang = lang;
+    new_stream->config = limits;
+    new_stream->callback = callback;
+    new_stream->context = context;
+
+    new_stream->queue = limdy_memory_pool_alloc(limits.max_pending_chunks * sizeof(StreamChunk));
+    if (!new_stream->queue)
+    {
+        limdy_memory_pool_free(new_stream);
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate stream queue");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    ErrorCode error = limdy_arena_init(&new_stream->arena, 0);
+    if (error != ERROR_SUCCESS)
+    {
+        limdy_memory_pool_free(new_stream->queue);
+        limdy_memory_pool_free(new_stream);
+        return error;
+    }
+
+    if (pthread_mutex_init(&new_stream->mutex, NULL) != 0 || pthread_cond_init(&new_stream->chunk_available, NULL) != 0 ||
+        pthread_cond_init(&new_stream->slot_available, NULL) != 0)
+    {
+        limdy_arena_release(&new_stream->arena);
+        limdy_memory_pool_free(new_stream->queue);
+        limdy_memory_pool_free(new_stream);
+        LOG_ERROR(ERROR_THREAD_INIT, "Failed to initialize stream synchronization");
+        return ERROR_THREAD_INIT;
+    }
+
+    if (pthread_create(&new_stream->worker, NULL, stream_main, new_stream) != 0)
+    {
+        new_stream->joined = true;
+        renderer_stream_destroy(new_stream);
+        LOG_ERROR(ERROR_THREAD_INIT, "Failed to start stream worker");
+        return ERROR_THREAD_INIT;
+    }
+
+    *stream = new_stream;
+    return ERROR_SUCCESS;
+}
+
+ErrorCode renderer_stream_push(RendererStream *stream, const char *chunk, size_t length)
+{
+    CHECK_NULL(stream, ERROR_NULL_POINTER);
+    if (length == 0)
+    {
+        return ERROR_SUCCESS;
+    }
+    CHECK_NULL(chunk, ERROR_NULL_POINTER);
+
+    // Copy before taking the lock so the worker is never held up by it
+    char *copy = limdy_memory_pool_alloc(length);
+    CHECK_NULL(copy, ERROR_MEMORY_ALLOCATION);
+    memcpy(copy, chunk, length);
+
+    ErrorCode error = ERROR_SUCCESS;
+    pthread_mutex_lock(&stream->mutex);
+    while (stream->queued == stream->config.max_pending_chunks && stream->error == ERROR_SUCCESS && !stream->finishing)
+    {
+        pthread_cond_wait(&stream->slot_available, &stream->mutex);
+    }
+    if (stream->finishing)
+    {
+        error = LIMDY_RENDERER_STREAM_ERROR_FINISHED;
+    }
+    else if (stream->error != ERROR_SUCCESS)
+    {
+        error = stream->error;
+    }
+    else
+    {
+        size_t tail = (stream->head + stream->queued) % stream->config.max_pending_chunks;
+        stream->queue[tail] = (StreamChunk){copy, length};
+        stream->queued++;
+        pthread_cond_signal(&stream->chunk_available);
+    }
+    pthread_mutex_unlock(&stream->mutex);
+
+    if (error != ERROR_SUCCESS)
+    {
+        limdy_memory_pool_free(copy);
+    }
+    return error;
+}
+
+ErrorCode renderer_stream_finish(RendererStream *stream)
+{
+    CHECK_NULL(stream, ERROR_NULL_POINTER);
+
+    pthread_mutex_lock(&stream->mutex);
+    stream->finishing = true;
+    pthread_cond_signal(&stream->chunk_available);
+    pthread_mutex_unlock(&stream->mutex);
+
+    if (!stream->joined)
+    {
+        pthread_join(stream->worker, NULL);
+        stream->joined = true;
+    }
+    return stream->error;
+}
+
+void renderer_stream_destroy(RendererStream *stream)
+{
+    if (!stream)
+    {
+        return;
+    }
+
+    if (!stream->joined)
+    {
+        pthread_mutex_lock(&stream->mutex);
+        stream->cancelled = true;
+        pthread_cond_signal(&stream->chunk_available);
+        pthread_mutex_unlock(&stream->mutex);
+        pthread_join(stream->worker, NULL);
+    }
+
+    for (size_t i = 0; i < stream->queued; i++)
+    {
+        limdy_memory_pool_free(stream->queue[(stream->head + i) % stream->config.max_pending_chunks].data);
+    }
+
+    pthread_cond_destroy(&stream->slot_available);
+    pthread_cond_destroy(&stream->chunk_available);
+    pthread_mutex_destroy(&stream->mutex);
+    limdy_arena_release(&stream->arena);
+    limdy_memory_pool_free(stream->spans);
+    limdy_memory_pool_free(stream->buffer);
+    limdy_memory_pool_free(stream->queue);
+    limdy_memory_pool_free(stream);
+}
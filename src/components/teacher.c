@@ -0,0 +1,710 @@
+/**
+ * @file teacher.c
+ * @brief Implementation of the spaced-repetition scheduler.
+ *
+ * This file implements the interface defined in teacher.h. Items live in
+ * one array and are found through an open-addressed index keyed by user
+ * and element hash, so a review result goes straight to its item without
+ * looking up the user. Each user owns a 4-ary heap of (due, item) entries.
+ * The heap array starts three entries before a cache line boundary, so the
+ * children of every node fill exactly one line and sifting down touches one
+ * line per level. Items remember their heap position, which lets a review
+ * move an item up or down in place. Everything else comes from the memory
+ * pool; the heaps come from the C library's aligned allocator, since pool
+ * blocks are only aligned to LIMDY_MEMORY_ALIGNMENT and the layout needs a
+ * cache line.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include "components/teacher.h"
+#include "utils/limdy_utils.h"
+#include "utils/memory_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define HEAP_ARITY 4
+#define HEAP_PAD (HEAP_ARITY - 1) // Entries before the root, so sibling groups start on a line
+#define HEAP_ALIGNMENT 64
+#define HEAP_MIN_CAPACITY 4
+#define INDEX_MIN_CAPACITY 64
+#define FRONTIER_STACK_CAPACITY 256
+#define NO_SLOT 0
+
+/**
+ * @brief Heap entry; the due time is copied in so that sifting never reads items.
+ */
+typedef struct
+{
+    uint64_t due;
+    uint32_t item;
+    uint32_t reserved;
+} TeacherHeapEntry;
+
+_Static_assert(sizeof(TeacherHeapEntry) * HEAP_ARITY == HEAP_ALIGNMENT, "Siblings fill one cache line");
+
+typedef struct
+{
+    uint64_t element_hash;
+    uint32_t user_id;
+    uint32_t user;          // Position of the user in the users array
+    uint32_t heap_position; // Position in the user's heap
+    uint32_t interval;
+    uint16_t ease;
+    uint16_t repetitions;
+    uint32_t lapses;
+} TeacherItem;
+
+typedef struct
+{
+    uint32_t id;
+    uint32_t count;
+    uint32_t capacity;
+    void *allocation;          // Start of the aligned allocation
+    TeacherHeapEntry *entries; // Root of the heap, HEAP_PAD entries into the allocation
+} TeacherUser;
+
+// Index slot; value is the position of the item or user + 1, so that zeroed slots are empty
+typedef struct
+{
+    uint32_t tag; // High bits of the key, checked before following value
+    uint32_t value;
+} TeacherSlot;
+
+typedef struct
+{
+    TeacherSlot *slots;
+    size_t capacity; // Power of two, kept at most half full
+} TeacherIndex;
+
+struct Teacher
+{
+    TeacherItem *items;
+    size_t item_count;
+    size_t item_capacity;
+    TeacherIndex item_index;
+    TeacherUser *users;
+    size_t user_count;
+    size_t user_capacity;
+    TeacherIndex user_index;
+};
+
+static inline uint64_t item_key(uint32_t user_id, uint64_t element_hash)
+{
+    uint64_t key = (element_hash ^ ((uint64_t)user_id * 0x9E3779B97F4A7C15ULL)) * 0xD6E8FEB86659FD93ULL;
+    return key ^ (key >> 29);
+}
+
+static inline uint64_t user_key(uint32_t user_id)
+{
+    uint64_t key = ((uint64_t)user_id + 1) * 0x9E3779B97F4A7C15ULL;
+    return key ^ (key >> 29);
+}
+
+static inline bool entry_before(const TeacherHeapEntry *a, const TeacherHeapEntry *b)
+{
+    return a->due < b->due || (a->due == b->due && a->item < b->item);
+}
+
+static void index_place(TeacherIndex *index, uint64_t key, uint32_t value)
+{
+    size_t mask = index->capacity - 1;
+    size_t position = key & mask;
+    while (index->slots[position].value != NO_SLOT)
+    {
+        position = (position + 1) & mask;
+    }
+    index->slots[position] = (TeacherSlot){.tag = (uint32_t)(key >> 32), .value = value + 1};
+}
+
+static ErrorCode index_alloc(TeacherIndex *index, size_t capacity)
+{
+    index->slots = limdy_memory_pool_alloc(capacity * sizeof(TeacherSlot));
+    CHECK_NULL(index->slots, ERROR_MEMORY_ALLOCATION);
+    memset(index->slots, 0, capacity * sizeof(TeacherSlot));
+    index->capacity = capacity;
+    return ERROR_SUCCESS;
+}
+
+static size_t index_capacity_for(size_t count)
+{
+    size_t capacity = INDEX_MIN_CAPACITY;
+    while (capacity < count * 2 + 1)
+    {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+// Rebuilds the item index with room for count items
+static ErrorCode item_index_grow(Teacher *teacher, size_t count)
+{
+    TeacherIndex index;
+    RETURN_IF_ERROR(index_alloc(&index, index_capacity_for(count)));
+    for (size_t i = 0; i < teacher->item_count; i++)
+    {
+        const TeacherItem *item = &teacher->items[i];
+        index_place(&index, item_key(item->user_id, item->element_hash), (uint32_t)i);
+    }
+    limdy_memory_pool_free(teacher->item_index.slots);
+    teacher->item_index = index;
+    return ERROR_SUCCESS;
+}
+
+static ErrorCode user_index_grow(Teacher *teacher, size_t count)
+{
+    TeacherIndex index;
+    RETURN_IF_ERROR(index_alloc(&index, index_capacity_for(count)));
+    for (size_t i = 0; i < teacher->user_count; i++)
+    {
+        index_place(&index, user_key(teacher->users[i].id), (uint32_t)i);
+    }
+    limdy_memory_pool_free(teacher->user_index.slots);
+    teacher->user_index = index;
+    return ERROR_SUCCESS;
+}
+
+static TeacherItem *find_item(const Teacher *teacher, uint32_t user_id, uint64_t element_hash)
+{
+    uint64_t key = item_key(user_id, element_hash);
+    uint32_t tag = (uint32_t)(key >> 32);
+    size_t mask = teacher->item_index.capacity - 1;
+    for (size_t position = key & mask; teacher->item_index.slots[position].value != NO_SLOT; position = (position + 1) & mask)
+    {
+        const TeacherSlot *slot = &teacher->item_index.slots[position];
+        if (slot->tag != tag)
+        {
+            continue;
+        }
+        TeacherItem *item = &teacher->items[slot->value - 1];
+        if (item->element_hash == element_hash && item->user_id == user_id)
+        {
+            return item;
+        }
+    }
+    return NULL;
+}
+
+static TeacherUser *find_user(const Teacher *teacher, uint32_t user_id)
+{
+    uint64_t key = user_key(user_id);
+    uint32_t tag = (uint32_t)(key >> 32);
+    size_t mask = teacher->user_index.capacity - 1;
+    for (size_t position = key & mask; teacher->user_index.slots[position].value != NO_SLOT; position = (position + 1) & mask)
+    {
+        const TeacherSlot *slot = &teacher->user_index.slots[position];
+        TeacherUser *user = &teacher->users[slot->value - 1];
+        if (slot->tag == tag && user->id == user_id)
+        {
+            return user;
+        }
+    }
+    return NULL;
+}
+
+static ErrorCode find_or_add_user(Teacher *teacher, uint32_t user_id, TeacherUser **user)
+{
+    *user = find_user(teacher, user_id);
+    if (*user)
+    {
+        return ERROR_SUCCESS;
+    }
+
+    if (teacher->user_count >= UINT32_MAX - 1)
+    {
+        LOG_ERROR(LIMDY_TEACHER_ERROR_FULL, "Scheduler cannot index more users");
+        return LIMDY_TEACHER_ERROR_FULL;
+    }
+    if ((teacher->user_count + 1) * 2 > teacher->user_index.capacity)
+    {
+        RETURN_IF_ERROR(user_index_grow(teacher, teacher->user_count + 1));
+    }
+    RETURN_IF_ERROR(limdy_memory_pool_reserve((void **)&teacher->users, &teacher->user_capacity, teacher->user_count + 1, sizeof(TeacherUser)));
+
+    size_t position = teacher->user_count++;
+    teacher->users[position] = (TeacherUser){.id = user_id};
+    index_place(&teacher->user_index, user_key(user_id), (uint32_t)position);
+    *user = &teacher->users[position];
+    return ERROR_SUCCESS;
+}
+
+// Reallocates a user's heap at a cache line boundary; the old entries are copied over
+static ErrorCode heap_reserve(TeacherUser *user, size_t needed)
+{
+    if (needed <= user->capacity)
+    {
+        return ERROR_SUCCESS;
+    }
+    size_t capacity = user->capacity ? (size_t)user->capacity * 2 : HEAP_MIN_CAPACITY;
+    while (capacity < needed)
+    {
+        capacity *= 2;
+    }
+    if (capacity > UINT32_MAX)
+    {
+        LOG_ERROR(LIMDY_TEACHER_ERROR_FULL, "User %u has too many items", user->id);
+        return LIMDY_TEACHER_ERROR_FULL;
+    }
+
+    void *allocation;
+    if (posix_memalign(&allocation, HEAP_ALIGNMENT, (capacity + HEAP_PAD) * sizeof(TeacherHeapEntry)) != 0)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate a heap of %zu items", capacity);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    TeacherHeapEntry *entries = (TeacherHeapEntry *)allocation + HEAP_PAD;
+    if (user->count)
+    {
+        memcpy(entries, user->entries, user->count * sizeof(TeacherHeapEntry));
+    }
+    free(user->allocation);
+    user->allocation = allocation;
+    user->entries = entries;
+    user->capacity = (uint32_t)capacity;
+    return ERROR_SUCCESS;
+}
+
+static inline void heap_place(Teacher *teacher, TeacherUser *user, size_t position, const TeacherHeapEntry *entry)
+{
+    user->entries[position] = *entry;
+    teacher->items[entry->item].heap_position = (uint32_t)position;
+}
+
+static void heap_sift_up(Teacher *teacher, TeacherUser *user, size_t position)
+{
+    TeacherHeapEntry entry = user->entries[position];
+    while (position > 0)
+    {
+        size_t parent = (position - 1) / HEAP_ARITY;
+        if (!entry_before(&entry, &user->entries[parent]))
+        {
+            break;
+        }
+        heap_place(teacher, user, position, &user->entries[parent]);
+        position = parent;
+    }
+    heap_place(teacher, user, position, &entry);
+}
+
+static void heap_sift_down(Teacher *teacher, TeacherUser *user, size_t position)
+{
+    TeacherHeapEntry entry = user->entries[position];
+    for (;;)
+    {
+        size_t first = position * HEAP_ARITY + 1;
+        if (first >= user->count)
+        {
+            break;
+        }
+        size_t last = first + HEAP_ARITY < user->count ? first + HEAP_ARITY : user->count;
+        size_t child = first;
+        for (size_t i = first + 1; i < last; i++)
+        {
+            if (entry_before(&user->entries[i], &user->entries[child]))
+            {
+                child = i;
+            }
+        }
+        if (!entry_before(&user->entries[child], &entry))
+        {
+            break;
+        }
+        heap_place(teacher, user, position, &user->entries[child]);
+        position = child;
+    }
+    heap_place(teacher, user, position, &entry);
+}
+
+// Applies an SM-2 step to the item and returns its new interval
+static uint32_t schedule_item(TeacherItem *item, TeacherGrade grade)
+{
+    static const int ease_change[] = {
+        [TEACHER_GRADE_AGAIN] = -200, [TEACHER_GRADE_HARD] = -140, [TEACHER_GRADE_GOOD] = 0, [TEACHER_GRADE_EASY] = 100};
+    int ease = item->ease + ease_change[grade];
+    item->ease = (uint16_t)(ease < LIMDY_TEACHER_MIN_EASE ? LIMDY_TEACHER_MIN_EASE : ease);
+
+    uint64_t interval;
+    if (grade == TEACHER_GRADE_AGAIN)
+    {
+        item->repetitions = 0;
+        item->lapses++;
+        interval = LIMDY_TEACHER_RELEARN_INTERVAL;
+    }
+    else
+    {
+        if (item->repetitions == 0)
+        {
+            interval = LIMDY_TEACHER_FIRST_INTERVAL;
+        }
+        else if (item->repetitions == 1)
+        {
+            interval = LIMDY_TEACHER_SECOND_INTERVAL;
+        }
+        else
+        {
+            interval = (uint64_t)item->interval * item->ease / 1000;
+        }
+        if (item->repetitions < UINT16_MAX)
+        {
+            item->repetitions++;
+        }
+    }
+    item->interval = (uint32_t)(interval > LIMDY_TEACHER_MAX_INTERVAL ? LIMDY_TEACHER_MAX_INTERVAL : interval);
+    return item->interval;
+}
+
+static void review_from_item(const Teacher *teacher, const TeacherItem *item, TeacherReview *review)
+{
+    const TeacherUser *user = &teacher->users[item->user];
+    *review = (TeacherReview){
+        .element_hash = item->element_hash,
+        .due = user->entries[item->heap_position].due,
+        .interval = item->interval,
+        .ease = item->ease,
+        .repetitions = item->repetitions,
+        .lapses = item->lapses};
+}
+
+/**
+ * @brief Create an empty scheduler.
+ *
+ * @param initial_capacity Number of items to make room for up front.
+ * @param teacher Pointer to store the created scheduler.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode teacher_create(size_t initial_capacity, Teacher **teacher)
+{
+    CHECK_NULL(teacher, ERROR_NULL_POINTER);
+
+    Teacher *new_teacher = limdy_memory_pool_alloc(sizeof(Teacher));
+    CHECK_NULL(new_teacher, ERROR_MEMORY_ALLOCATION);
+    memset(new_teacher, 0, sizeof(Teacher));
+
+    ErrorCode error = index_alloc(&new_teacher->item_index, index_capacity_for(initial_capacity));
+    if (error == ERROR_SUCCESS)
+    {
+        error = index_alloc(&new_teacher->user_index, INDEX_MIN_CAPACITY);
+    }
+    if (error == ERROR_SUCCESS && initial_capacity > 0)
+    {
+        error = limdy_memory_pool_reserve((void **)&new_teacher->items, &new_teacher->item_capacity, initial_capacity, sizeof(TeacherItem));
+    }
+    if (error != ERROR_SUCCESS)
+    {
+        teacher_destroy(new_teacher);
+        return error;
+    }
+
+    *teacher = new_teacher;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Destroy a scheduler.
+ *
+ * @param teacher The scheduler, or NULL.
+ */
+void teacher_destroy(Teacher *teacher)
+{
+    if (!teacher)
+    {
+        return;
+    }
+    for (size_t i = 0; i < teacher->user_count; i++)
+    {
+        free(teacher->users[i].allocation);
+    }
+    limdy_memory_pool_free(teacher->users);
+    limdy_memory_pool_free(teacher->items);
+    limdy_memory_pool_free(teacher->item_index.slots);
+    limdy_memory_pool_free(teacher->user_index.slots);
+    limdy_memory_pool_free(teacher);
+}
+
+/**
+ * @brief Start scheduling an element for a user, due right away.
+ *
+ * @param teacher The scheduler.
+ * @param user The user.
+ * @param element_hash Hash of the element in its LinguisticElementMap.
+ * @param now The current time.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode teacher_add(Teacher *teacher, uint32_t user, uint64_t element_hash, uint64_t now)
+{
+    CHECK_NULL(teacher, ERROR_NULL_POINTER);
+
+    if (find_item(teacher, user, element_hash))
+    {
+        return ERROR_SUCCESS;
+    }
+    if (teacher->item_count >= UINT32_MAX - 1)
+    {
+        LOG_ERROR(LIMDY_TEACHER_ERROR_FULL, "Scheduler cannot index more items");
+        return LIMDY_TEACHER_ERROR_FULL;
+    }
+
+    TeacherUser *owner;
+    RETURN_IF_ERROR(find_or_add_user(teacher, user, &owner));
+    RETURN_IF_ERROR(heap_reserve(owner, (size_t)owner->count + 1));
+    RETURN_IF_ERROR(limdy_memory_pool_reserve((void **)&teacher->items, &teacher->item_capacity, teacher->item_count + 1, sizeof(TeacherItem)));
+    if ((teacher->item_count + 1) * 2 > teacher->item_index.capacity)
+    {
+        RETURN_IF_ERROR(item_index_grow(teacher, teacher->item_count + 1));
+    }
+
+    size_t position = teacher->item_count++;
+    teacher->items[position] = (TeacherItem){
+        .element_hash = element_hash,
+        .user_id = user,
+        .user = (uint32_t)(owner - teacher->users),
+        .ease = LIMDY_TEACHER_INITIAL_EASE};
+    index_place(&teacher->item_index, item_key(user, element_hash), (uint32_t)position);
+
+    owner->entries[owner->count] = (TeacherHeapEntry){.due = now, .item = (uint32_t)position};
+    heap_sift_up(teacher, owner, owner->count++);
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Start scheduling every element of a map for a user.
+ *
+ * @param teacher The scheduler.
+ * @param user The user.
+ * @param map The map whose elements to add.
+ * @param now The current time.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode teacher_add_map(Teacher *teacher, uint32_t user, LinguisticElementMap *map, uint64_t now)
+{
+    CHECK_NULL(teacher, ERROR_NULL_POINTER);
+    CHECK_NULL(map, ERROR_NULL_POINTER);
+
+    size_t slot_count = linguistic_element_map_slot_count(map);
+    for (size_t i = 0; i < slot_count; i++)
+    {
+        ExtendedLinguisticElement *element = linguistic_element_map_slot(map, i);
+        if (element)
+        {
+            RETURN_IF_ERROR(teacher_add(teacher, user, element->base.hash, now));
+        }
+    }
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Record the result of a review and reschedule the element.
+ *
+ * @param teacher The scheduler.
+ * @param user The user.
+ * @param element_hash Hash of the reviewed element.
+ * @param grade How well the user recalled it.
+ * @param now The time of the review.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode teacher_record(Teacher *teacher, uint32_t user, uint64_t element_hash, TeacherGrade grade, uint64_t now)
+{
+    CHECK_NULL(teacher, ERROR_NULL_POINTER);
+    if ((unsigned)grade > TEACHER_GRADE_EASY)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Invalid review grade %d", (int)grade);
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    TeacherItem *item = find_item(teacher, user, element_hash);
+    if (!item)
+    {
+        LOG_ERROR(LIMDY_TEACHER_ERROR_NOT_FOUND, "User %u has no item for element %llx", user, (unsigned long long)element_hash);
+        return LIMDY_TEACHER_ERROR_NOT_FOUND;
+    }
+
+    uint32_t interval = schedule_item(item, grade);
+    uint64_t due = now > UINT64_MAX - interval ? UINT64_MAX : now + interval;
+
+    // Only the due time of this entry changes, so one sift puts it back in order
+    TeacherUser *owner = &teacher->users[item->user];
+    size_t position = item->heap_position;
+    TeacherHeapEntry *entry = &owner->entries[position];
+    bool earlier = due < entry->due;
+    entry->due = due;
+    if (earlier)
+    {
+        heap_sift_up(teacher, owner, position);
+    }
+    else
+    {
+        heap_sift_down(teacher, owner, position);
+    }
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Get the schedule of an element for a user.
+ *
+ * @param teacher The scheduler.
+ * @param user The user.
+ * @param element_hash Hash of the element.
+ * @param review Pointer to store the schedule.
+ * @return true if the user has the element.
+ */
+bool teacher_find(const Teacher *teacher, uint32_t user, uint64_t element_hash, TeacherReview *review)
+{
+    if (!teacher || !review)
+    {
+        return false;
+    }
+    const TeacherItem *item = find_item(teacher, user, element_hash);
+    if (!item)
+    {
+        return false;
+    }
+    review_from_item(teacher, item, review);
+    return true;
+}
+
+// The frontier is a binary min-heap of positions in the user's heap, ordered by their entries
+static void frontier_push(const TeacherUser *user, uint32_t *frontier, size_t *count, uint32_t position)
+{
+    size_t i = (*count)++;
+    while (i > 0)
+    {
+        size_t parent = (i - 1) / 2;
+        if (!entry_before(&user->entries[position], &user->entries[frontier[parent]]))
+        {
+            break;
+        }
+        frontier[i] = frontier[parent];
+        i = parent;
+    }
+    frontier[i] = position;
+}
+
+static uint32_t frontier_pop(const TeacherUser *user, uint32_t *frontier, size_t *count)
+{
+    uint32_t top = frontier[0];
+    uint32_t last = frontier[--(*count)];
+    size_t i = 0;
+    for (;;)
+    {
+        size_t child = i * 2 + 1;
+        if (child >= *count)
+        {
+            break;
+        }
+        if (child + 1 < *count && entry_before(&user->entries[frontier[child + 1]], &user->entries[frontier[child]]))
+        {
+            child++;
+        }
+        if (!entry_before(&user->entries[frontier[child]], &user->entries[last]))
+        {
+            break;
+        }
+        frontier[i] = frontier[child];
+        i = child;
+    }
+    frontier[i] = last;
+    return top;
+}
+
+/**
+ * @brief Get a user's earliest due items, earliest first.
+ *
+ * The smallest entries of a heap are the root and then always a child of
+ * an entry already taken, so a small heap of candidates yields them in
+ * order: each step takes the earliest candidate and adds its children.
+ *
+ * @param teacher The scheduler.
+ * @param user The user.
+ * @param until Only items due at or before this time are returned; UINT64_MAX for any.
+ * @param reviews Array to fill.
+ * @param capacity Most items to return.
+ * @param review_count Pointer to store the number of items returned.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode teacher_next_due(const Teacher *teacher, uint32_t user, uint64_t until, TeacherReview *reviews, size_t capacity,
+                           size_t *review_count)
+{
+    CHECK_NULL(teacher, ERROR_NULL_POINTER);
+    CHECK_NULL(review_count, ERROR_NULL_POINTER);
+    if (capacity > 0 && !reviews)
+    {
+        LOG_ERROR(ERROR_NULL_POINTER, "Review array is NULL");
+        return ERROR_NULL_POINTER;
+    }
+
+    *review_count = 0;
+    const TeacherUser *owner = find_user(teacher, user);
+    if (!owner || owner->count == 0 || capacity == 0)
+    {
+        return ERROR_SUCCESS;
+    }
+    if (capacity > owner->count)
+    {
+        capacity = owner->count;
+    }
+
+    // Each step takes one candidate and adds at most HEAP_ARITY
+    size_t frontier_capacity = capacity * (HEAP_ARITY - 1) + 1;
+    uint32_t stack_frontier[FRONTIER_STACK_CAPACITY];
+    uint32_t *frontier = stack_frontier;
+    if (frontier_capacity > FRONTIER_STACK_CAPACITY)
+    {
+        frontier = limdy_memory_pool_alloc(frontier_capacity * sizeof(uint32_t));
+        CHECK_NULL(frontier, ERROR_MEMORY_ALLOCATION);
+    }
+
+    size_t frontier_count = 0;
+    frontier_push(owner, frontier, &frontier_count, 0);
+    size_t found = 0;
+    while (found < capacity && frontier_count > 0)
+    {
+        uint32_t position = frontier_pop(owner, frontier, &frontier_count);
+        if (owner->entries[position].due > until)
+        {
+            break;
+        }
+        review_from_item(teacher, &teacher->items[owner->entries[position].item], &reviews[found++]);
+
+        size_t first = (size_t)position * HEAP_ARITY + 1;
+        for (size_t child = first; child < first + HEAP_ARITY && child < owner->count; child++)
+        {
+            frontier_push(owner, frontier, &frontier_count, (uint32_t)child);
+        }
+    }
+
+    if (frontier != stack_frontier)
+    {
+        limdy_memory_pool_free(frontier);
+    }
+    *review_count = found;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Get the number of elements scheduled for a user.
+ *
+ * @param teacher The scheduler.
+ * @param user The user.
+ * @return The number of items of the user.
+ */
+size_t teacher_user_item_count(const Teacher *teacher, uint32_t user)
+{
+    if (!teacher)
+    {
+        return 0;
+    }
+    const TeacherUser *owner = find_user(teacher, user);
+    return owner ? owner->count : 0;
+}
+
+/**
+ * @brief Get the number of items of all users.
+ *
+ * @param teacher The scheduler.
+ * @return The number of items.
+ */
+size_t teacher_item_count(const Teacher *teacher)
+{
+    return teacher ? teacher->item_count : 0;
+}
@@ -0,0 +1,969 @@
+/**
+ * @file translation_memory.c
+ * @brief Implementation of the translation memory and its file store.
+ *
+ * This file implements the interface defined in translation_memory.h. Each
+ * entry is one block from the memory's own pool laid out as the entry
+ * header, the attention scores, the key strings and the translated text.
+ * Hits are reference counted, so an evicted or expired entry is freed back
+ * to the pool once its last holder releases it.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include "components/translation_memory.h"
+#include "utils/limdy_utils.h"
+#include "utils/memory_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FNV_PRIME 1099511628211ULL
+#define FNV_OFFSET 14695981039346656037ULL
+
+#define FILE_STORE_MAGIC "LIMDYTM1"
+#define FILE_STORE_MAGIC_SIZE 8
+#define FILE_STORE_RECORD_MAGIC 0x31524d54u // "TMR1"
+
+typedef struct TranslationMemoryEntry
+{
+    TranslationMemoryHit hit; // First, so holders' hit pointers lead back to the entry
+    struct TranslationMemoryEntry *next;
+    TranslationMemory *memory;
+    uint64_t hash;
+    uint64_t expires_at;
+    const char *text;
+    size_t text_length;
+    size_t source_length;
+    size_t target_length; // Languages follow the text, each NUL terminated
+    size_t size;          // Bytes charged against the shard budget
+    size_t slot;          // Position in the shard's CLOCK ring
+    atomic_size_t refs;
+    bool referenced; // CLOCK bit, guarded by the shard mutex
+} TranslationMemoryEntry;
+
+typedef struct
+{
+    pthread_mutex_t mutex;
+    TranslationMemoryEntry **buckets;
+    size_t bucket_mask;
+    TranslationMemoryEntry **ring; // CLOCK order; the first count slots are in use
+    size_t capacity;
+    size_t count;
+    size_t hand;
+    size_t bytes;
+    size_t byte_budget;
+    size_t hits;
+    size_t misses;
+    size_t expirations;
+    size_t evictions;
+    size_t paged_in;
+} TranslationMemoryShard;
+
+struct TranslationMemory
+{
+    TranslationMemoryShard shards[LIMDY_TRANSLATION_MEMORY_SHARDS];
+    LimdyMemoryPool *pool; // Backs every entry
+    uint64_t ttl_ms;
+    TranslationMemoryStore *store;
+    size_t loaded;
+};
+
+/**
+ * @brief Key of a lookup or insertion, with its lengths computed once.
+ */
+typedef struct
+{
+    const char *text;
+    const char *source_lang;
+    const char *target_lang;
+    size_t text_length;
+    size_t source_length;
+    size_t target_length;
+    uint64_t hash;
+} TranslationMemoryKey;
+
+static uint64_t hash_bytes(uint64_t hash, const char *bytes, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (uint64_t)(unsigned char)bytes[i];
+        hash *= FNV_PRIME;
+    }
+    // Separates the fields, so ("ab", "c") and ("a", "bc") differ
+    hash ^= 0xff;
+    hash *= FNV_PRIME;
+    return hash;
+}
+
+static void key_init(TranslationMemoryKey *key, const char *text, const char *source_lang, const char *target_lang)
+{
+    key->text = text;
+    key->source_lang = source_lang;
+    key->target_lang = target_lang;
+    key->text_length = strlen(text);
+    key->source_length = strlen(source_lang);
+    key->target_length = strlen(target_lang);
+
+    uint64_t hash = hash_bytes(FNV_OFFSET, text, key->text_length);
+    hash = hash_bytes(hash, source_lang, key->source_length);
+    hash = hash_bytes(hash, target_lang, key->target_length);
+    // FNV leaves short keys clustered; finalize so shard and bucket bits are both well mixed
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    key->hash = hash ^ (hash >> 31);
+}
+
+static bool entry_matches(const TranslationMemoryEntry *entry, const TranslationMemoryKey *key)
+{
+    const char *source_lang = entry->text + entry->text_length + 1;
+    const char *target_lang = source_lang + entry->source_length + 1;
+    return entry->hash == key->hash && entry->text_length == key->text_length &&
+           entry->source_length == key->source_length && entry->target_length == key->target_length &&
+           memcmp(entry->text, key->text, key->text_length) == 0 &&
+           memcmp(source_lang, key->source_lang, key->source_length) == 0 &&
+           memcmp(target_lang, key->target_lang, key->target_length) == 0;
+}
+
+/**
+ * @brief Gets the wall-clock time in milliseconds; wall clock so expiry survives restarts.
+ */
+static uint64_t now_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+}
+
+static TranslationMemoryShard *memory_shard(TranslationMemory *memory, uint64_t hash)
+{
+    return &memory->shards[(hash >> 32) % LIMDY_TRANSLATION_MEMORY_SHARDS];
+}
+
+static void entry_unref(TranslationMemoryEntry *entry)
+{
+    if (atomic_fetch_sub_explicit(&entry->refs, 1, memory_order_acq_rel) == 1)
+    {
+        limdy_memory_pool_free_to(entry->memory->pool, entry);
+    }
+}
+
+static TranslationMemoryEntry *shard_find(TranslationMemoryShard *shard, const TranslationMemoryKey *key)
+{
+    for (TranslationMemoryEntry *entry = shard->buckets[key->hash & shard->bucket_mask]; entry; entry = entry->next)
+    {
+        if (entry_matches(entry, key))
+        {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Unlinks an entry and drops the shard's reference. Called with the shard mutex held.
+ */
+static void shard_remove(TranslationMemoryShard *shard, TranslationMemoryEntry *victim)
+{
+    TranslationMemoryEntry **link = &shard->buckets[victim->hash & shard->bucket_mask];
+    while (*link != victim)
+    {
+        link = &(*link)->next;
+    }
+    *link = victim->next;
+
+    // Fill the hole with the last ring slot
+    shard->ring[victim->slot] = shard->ring[--shard->count];
+    shard->ring[victim->slot]->slot = victim->slot;
+    if (shard->hand >= shard->count)
+    {
+        shard->hand = 0;
+    }
+
+    shard->bytes -= victim->size;
+    entry_unref(victim);
+}
+
+/**
+ * @brief Evicts one entry by CLOCK. Called with the shard mutex held on a non-empty shard.
+ */
+static void shard_evict(TranslationMemoryShard *shard)
+{
+    // Give recently used entries a second chance; terminates within two sweeps
+    while (shard->ring[shard->hand]->referenced)
+    {
+        shard->ring[shard->hand]->referenced = false;
+        shard->hand = (shard->hand + 1) % shard->count;
+    }
+    shard->evictions++;
+    shard_remove(shard, shard->ring[shard->hand]);
+}
+
+/**
+ * @brief Inserts an entry, evicting until it fits. Called with the shard mutex held.
+ */
+static void shard_insert(TranslationMemoryShard *shard, TranslationMemoryEntry *entry)
+{
+    while (shard->count > 0 && (shard->count == shard->capacity || shard->bytes + entry->size > shard->byte_budget))
+    {
+        shard_evict(shard);
+    }
+
+    entry->slot = shard->count++;
+    shard->ring[entry->slot] = entry;
+    size_t bucket = entry->hash & shard->bucket_mask;
+    entry->next = shard->buckets[bucket];
+    shard->buckets[bucket] = entry;
+    shard->bytes += entry->size;
+    atomic_fetch_add_explicit(&entry->refs, 1, memory_order_relaxed); // The shard's own reference
+}
+
+static void shard_destroy(TranslationMemoryShard *shard)
+{
+    while (shard->ring && shard->count > 0)
+    {
+        shard_remove(shard, shard->ring[shard->count - 1]);
+    }
+    limdy_memory_pool_free(shard->ring);
+    limdy_memory_pool_free(shard->buckets);
+    pthread_mutex_destroy(&shard->mutex);
+}
+
+/**
+ * @brief Builds an entry holding one reference for the caller.
+ *
+ * @return The entry, or NULL if it exceeds @p byte_budget or does not fit in the pool.
+ */
+static TranslationMemoryEntry *entry_create(TranslationMemory *memory, const TranslationMemoryKey *key,
+                                            const char *translated_text, const float *attention, size_t rows, size_t cols,
+                                            size_t stride, uint64_t expires_at, size_t byte_budget)
+{
+    size_t score_bytes = rows * cols * sizeof(float);
+    size_t key_bytes = key->text_length + key->source_length + key->target_length + 3;
+    size_t translated_length = strlen(translated_text);
+    size_t size = sizeof(TranslationMemoryEntry) + score_bytes + key_bytes + translated_length + 1;
+    size_t charged = ALIGN_SIZE(size, LIMDY_MEMORY_ALIGNMENT) + MIN_BLOCK_SIZE;
+    if (charged > byte_budget)
+    {
+        return NULL;
+    }
+
+    TranslationMemoryEntry *entry = limdy_memory_pool_alloc_from(memory->pool, size);
+    if (!entry)
+    {
+        LOG_DEBUG(ERROR_MEMORY_ALLOCATION, "Translation memory pool has no room for entry");
+        return NULL;
+    }
+
+    float *scores = (float *)(entry + 1);
+    for (size_t i = 0; i < rows; i++)
+    {
+        memcpy(scores + i * cols, attention + i * stride, cols * sizeof(float));
+    }
+
+    char *text = (char *)(scores + rows * cols);
+    memcpy(text, key->text, key->text_length + 1);
+    char *source_lang = text + key->text_length + 1;
+    memcpy(source_lang, key->source_lang, key->source_length + 1);
+    char *target_lang = source_lang + key->source_length + 1;
+    memcpy(target_lang, key->target_lang, key->target_length + 1);
+    char *translated = target_lang + key->target_length + 1;
+    memcpy(translated, translated_text, translated_length + 1);
+
+    entry->hit = (TranslationMemoryHit){translated, scores, rows, cols};
+    entry->next = NULL;
+    entry->memory = memory;
+    entry->hash = key->hash;
+    entry->expires_at = expires_at;
+    entry->text = text;
+    entry->text_length = key->text_length;
+    entry->source_length = key->source_length;
+    entry->target_length = key->target_length;
+    entry->size = charged;
+    entry->slot = 0;
+    entry->referenced = false;
+    atomic_init(&entry->refs, 1);
+
+    return entry;
+}
+
+/**
+ * @brief Adds an entry to its shard.
+ *
+ * @param replace Whether a held entry for the same key gives way to the new one.
+ * @return The new entry with a reference for the caller, or NULL if it is not held.
+ */
+static TranslationMemoryEntry *memory_put(TranslationMemory *memory, const TranslationMemoryKey *key, const char *translated_text,
+                                          const float *attention, size_t rows, size_t cols, size_t stride, uint64_t expires_at,
+                                          bool replace)
+{
+    TranslationMemoryShard *shard = memory_shard(memory, key->hash);
+
+    // Copy outside the lock; entries over the shard's budget are never held
+    TranslationMemoryEntry *entry = entry_create(memory, key, translated_text, attention, rows, cols, stride, expires_at,
+                                                 shard->byte_budget);
+    if (!entry)
+    {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&shard->mutex);
+    TranslationMemoryEntry *existing = shard_find(shard, key);
+    if (existing && replace)
+    {
+        shard_remove(shard, existing);
+        existing = NULL;
+    }
+    if (!existing)
+    {
+        shard_insert(shard, entry);
+    }
+    pthread_mutex_unlock(&shard->mutex);
+
+    if (existing)
+    {
+        entry_unref(entry);
+        return NULL;
+    }
+    return entry;
+}
+
+/**
+ * @brief Adds a record replayed from the store.
+ */
+static ErrorCode memory_load_record(void *context, const TranslationMemoryRecord *record)
+{
+    TranslationMemory *memory = context;
+
+    if (record->expires_at != 0 && record->expires_at <= now_ms())
+    {
+        return ERROR_SUCCESS;
+    }
+
+    TranslationMemoryKey key;
+    key_init(&key, record->text, record->source_lang, record->target_lang);
+    // Later records are newer, so they replace what an earlier one left
+    TranslationMemoryEntry *entry = memory_put(memory, &key, record->translated_text, record->attention, record->rows,
+                                               record->cols, record->cols, record->expires_at, true);
+    if (entry)
+    {
+        memory->loaded++;
+        entry_unref(entry);
+    }
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief State of paging one record in from the store.
+ */
+typedef struct
+{
+    TranslationMemory *memory;
+    const TranslationMemoryKey *key;
+    TranslationMemoryEntry *entry;
+} TranslationMemoryPageIn;
+
+/**
+ * @brief Adds the record the store found for a missed key.
+ */
+static ErrorCode memory_page_record(void *context, const TranslationMemoryRecord *record)
+{
+    TranslationMemoryPageIn *page = context;
+
+    if (record->expires_at != 0 && record->expires_at <= now_ms())
+    {
+        return ERROR_SUCCESS;
+    }
+
+    // A racing lookup that paged the key in first keeps its entry, and this one misses
+    page->entry = memory_put(page->memory, page->key, record->translated_text, record->attention, record->rows, record->cols,
+                             record->cols, record->expires_at, false);
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Asks the store for a key the memory missed.
+ *
+ * @return The paged-in entry with a reference for the caller, or NULL.
+ */
+static TranslationMemoryEntry *memory_page_in(TranslationMemory *memory, const TranslationMemoryKey *key)
+{
+    TranslationMemoryPageIn page = {memory, key, NULL};
+    ErrorCode error = memory->store->find(memory->store, key->text, key->source_lang, key->target_lang, memory_page_record, &page);
+    if (error != ERROR_SUCCESS && error != LIMDY_TRANSLATION_MEMORY_ERROR_MISS)
+    {
+        LOG_WARNING(error, "Translation memory store failed to find entry");
+    }
+    return page.entry;
+}
+
+/**
+ * @brief Creates a translation memory.
+ *
+ * @param config The limits and backing to use.
+ * @param memory Pointer to store the created memory.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translation_memory_create(const TranslationMemoryConfig *config, TranslationMemory **memory)
+{
+    TranslationMemoryStore *store = config ? config->store : NULL;
+    ErrorCode error = ERROR_SUCCESS;
+
+    if (!config || !memory)
+    {
+        error = ERROR_NULL_POINTER;
+        LOG_ERROR(error, "Null pointer");
+    }
+    else if (config->max_entries == 0 || config->max_bytes == 0)
+    {
+        error = ERROR_INVALID_ARGUMENT;
+        LOG_ERROR(error, "Translation memory limits must be positive");
+    }
+    if (error != ERROR_SUCCESS)
+    {
+        if (store)
+        {
+            store->destroy(store);
+        }
+        return error;
+    }
+
+    TranslationMemory *new_memory = limdy_memory_pool_alloc(sizeof(TranslationMemory));
+    if (!new_memory)
+    {
+        if (store)
+        {
+            store->destroy(store);
+        }
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate translation memory");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    memset(new_memory, 0, sizeof(TranslationMemory));
+    new_memory->ttl_ms = config->ttl_ms;
+    new_memory->store = store;
+
+    error = limdy_memory_pool_create(config->max_bytes, &new_memory->pool);
+    if (error != ERROR_SUCCESS)
+    {
+        translation_memory_destroy(new_memory);
+        return error;
+    }
+
+    size_t shard_capacity = (config->max_entries + LIMDY_TRANSLATION_MEMORY_SHARDS - 1) / LIMDY_TRANSLATION_MEMORY_SHARDS;
+    size_t bucket_count = 1;
+    while (bucket_count < shard_capacity)
+    {
+        bucket_count <<= 1;
+    }
+
+    for (size_t i = 0; i < LIMDY_TRANSLATION_MEMORY_SHARDS; i++)
+    {
+        TranslationMemoryShard *shard = &new_memory->shards[i];
+        if (pthread_mutex_init(&shard->mutex, NULL) != 0)
+        {
+            LOG_ERROR(ERROR_THREAD_INIT, "Failed to initialize translation memory shard mutex");
+            translation_memory_destroy(new_memory);
+            return ERROR_THREAD_INIT;
+        }
+        shard->capacity = shard_capacity;
+        shard->byte_budget = config->max_bytes / LIMDY_TRANSLATION_MEMORY_SHARDS;
+        shard->bucket_mask = bucket_count - 1;
+        shard->buckets = limdy_memory_pool_alloc(bucket_count * sizeof(TranslationMemoryEntry *));
+        shard->ring = limdy_memory_pool_alloc(shard_capacity * sizeof(TranslationMemoryEntry *));
+        if (!shard->buckets || !shard->ring)
+        {
+            LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate translation memory shard");
+            translation_memory_destroy(new_memory);
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        memset(shard->buckets, 0, bucket_count * sizeof(TranslationMemoryEntry *));
+    }
+
+    if (store)
+    {
+        error = store->load(store, memory_load_record, new_memory);
+        if (error != ERROR_SUCCESS)
+        {
+            LOG_ERROR(error, "Failed to load translation memory store");
+            translation_memory_destroy(new_memory);
+            return error;
+        }
+    }
+
+    *memory = new_memory;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Destroys a translation memory and its store.
+ *
+ * @param memory The memory to destroy.
+ */
+void translation_memory_destroy(TranslationMemory *memory)
+{
+    if (!memory)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < LIMDY_TRANSLATION_MEMORY_SHARDS; i++)
+    {
+        // Shards past a failed creation were left zeroed
+        if (memory->shards[i].capacity)
+        {
+            shard_destroy(&memory->shards[i]);
+        }
+    }
+    if (memory->store)
+    {
+        memory->store->destroy(memory->store);
+    }
+    limdy_memory_pool_destroy(memory->pool);
+    limdy_memory_pool_free(memory);
+}
+
+/**
+ * @brief Looks up a translation.
+ *
+ * @param memory The memory.
+ * @param text The source text.
+ * @param source_lang The source language.
+ * @param target_lang The target language.
+ * @param hit Pointer to store the hit.
+ * @return ERROR_SUCCESS on a hit, LIMDY_TRANSLATION_MEMORY_ERROR_MISS otherwise.
+ */
+ErrorCode translation_memory_lookup(TranslationMemory *memory, const char *text, const char *source_lang, const char *target_lang,
+                                    const TranslationMemoryHit **hit)
+{
+    CHECK_NULL(memory, ERROR_NULL_POINTER);
+    CHECK_NULL(text, ERROR_NULL_POINTER);
+    CHECK_NULL(source_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(target_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(hit, ERROR_NULL_POINTER);
+
+    TranslationMemoryKey key;
+    key_init(&key, text, source_lang, target_lang);
+    TranslationMemoryShard *shard = memory_shard(memory, key.hash);
+
+    bool pages = memory->store && memory->store->find;
+    MUTEX_LOCK(&shard->mutex);
+    TranslationMemoryEntry *entry = shard_find(shard, &key);
+    if (entry && entry->expires_at != 0 && entry->expires_at <= now_ms())
+    {
+        shard->expirations++;
+        shard_remove(shard, entry);
+        entry = NULL;
+    }
+    if (entry)
+    {
+        entry->referenced = true;
+        atomic_fetch_add_explicit(&entry->refs, 1, memory_order_relaxed);
+        shard->hits++;
+    }
+    else if (!pages)
+    {
+        shard->misses++;
+    }
+    MUTEX_UNLOCK(&shard->mutex);
+
+    if (!entry && pages)
+    {
+        // The store is asked outside the lock; what it finds counts as a hit
+        entry = memory_page_in(memory, &key);
+        MUTEX_LOCK(&shard->mutex);
+        if (entry)
+        {
+            shard->hits++;
+            shard->paged_in++;
+        }
+        else
+        {
+            shard->misses++;
+        }
+        MUTEX_UNLOCK(&shard->mutex);
+    }
+
+    if (!entry)
+    {
+        return LIMDY_TRANSLATION_MEMORY_ERROR_MISS;
+    }
+
+    *hit = &entry->hit;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Drops a reference obtained from translation_memory_lookup().
+ *
+ * @param hit The hit to release.
+ */
+void translation_memory_release(const TranslationMemoryHit *hit)
+{
+    if (hit)
+    {
+        entry_unref((TranslationMemoryEntry *)hit);
+    }
+}
+
+/**
+ * @brief Adds a translation and persists it to the store.
+ *
+ * @param memory The memory.
+ * @param text The source text.
+ * @param source_lang The source language.
+ * @param target_lang The target language.
+ * @param translated_text The translated text.
+ * @param attention The attention matrix, or NULL.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translation_memory_insert(TranslationMemory *memory, const char *text, const char *source_lang, const char *target_lang,
+                                    const char *translated_text, const LimdyMatrix *attention)
+{
+    CHECK_NULL(memory, ERROR_NULL_POINTER);
+    CHECK_NULL(text, ERROR_NULL_POINTER);
+    CHECK_NULL(source_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(target_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(translated_text, ERROR_NULL_POINTER);
+
+    TranslationMemoryKey key;
+    key_init(&key, text, source_lang, target_lang);
+    uint64_t expires_at = memory->ttl_ms ? now_ms() + memory->ttl_ms : 0;
+
+    const float *scores = attention && attention->rows && attention->cols ? attention->data : NULL;
+    size_t rows = scores ? attention->rows : 0;
+    size_t cols = scores ? attention->cols : 0;
+    size_t stride = scores ? attention->stride : 0;
+
+    TranslationMemoryEntry *entry = memory_put(memory, &key, translated_text, scores, rows, cols, stride, expires_at, false);
+    if (!entry)
+    {
+        return ERROR_SUCCESS;
+    }
+
+    // Persist from the entry, whose scores are already packed; only the first insert of a text gets here
+    ErrorCode error = ERROR_SUCCESS;
+    if (memory->store)
+    {
+        TranslationMemoryRecord record = {text, source_lang, target_lang, entry->hit.translated_text, entry->hit.attention,
+                                          rows, cols, expires_at};
+        error = memory->store->save(memory->store, &record);
+        if (error != ERROR_SUCCESS)
+        {
+            LOG_ERROR(error, "Failed to persist translation memory entry");
+        }
+    }
+    entry_unref(entry);
+    return error;
+}
+
+/**
+ * @brief Visits every unexpired entry, a shard at a time under its lock.
+ *
+ * @param memory The memory.
+ * @param visit Function called once per entry.
+ * @param context Argument passed to @p visit.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translation_memory_for_each(TranslationMemory *memory, TranslationMemoryVisitFn visit, void *context)
+{
+    CHECK_NULL(memory, ERROR_NULL_POINTER);
+    CHECK_NULL(visit, ERROR_NULL_POINTER);
+
+    uint64_t now = now_ms();
+    ErrorCode error = ERROR_SUCCESS;
+    for (size_t i = 0; i < LIMDY_TRANSLATION_MEMORY_SHARDS && error == ERROR_SUCCESS; i++)
+    {
+        TranslationMemoryShard *shard = &memory->shards[i];
+        pthread_mutex_lock(&shard->mutex);
+        for (size_t slot = 0; slot < shard->count && error == ERROR_SUCCESS; slot++)
+        {
+            const TranslationMemoryEntry *entry = shard->ring[slot];
+            if (entry->expires_at != 0 && entry->expires_at <= now)
+            {
+                continue;
+            }
+            const char *source_lang = entry->text + entry->text_length + 1;
+            const char *target_lang = source_lang + entry->source_length + 1;
+            TranslationMemoryRecord record = {entry->text, source_lang, target_lang, entry->hit.translated_text,
+                                              entry->hit.attention, entry->hit.rows, entry->hit.cols, entry->expires_at};
+            error = visit(context, &record);
+        }
+        pthread_mutex_unlock(&shard->mutex);
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the memory's counters.
+ *
+ * @param memory The memory.
+ * @param stats Pointer to store the counters.
+ */
+void translation_memory_get_stats(TranslationMemory *memory, TranslationMemoryStats *stats)
+{
+    if (!stats)
+    {
+        return;
+    }
+    memset(stats, 0, sizeof(TranslationMemoryStats));
+    if (!memory)
+    {
+        return;
+    }
+
+    stats->loaded = memory->loaded;
+    for (size_t i = 0; i < LIMDY_TRANSLATION_MEMORY_SHARDS; i++)
+    {
+        TranslationMemoryShard *shard = &memory->shards[i];
+        pthread_mutex_lock(&shard->mutex);
+        stats->hits += shard->hits;
+        stats->misses += shard->misses;
+        stats->expirations += shard->expirations;
+        stats->evictions += shard->evictions;
+        stats->paged_in += shard->paged_in;
+        stats->entries += shard->count;
+        stats->bytes += shard->bytes;
+        pthread_mutex_unlock(&shard->mutex);
+    }
+}
+
+/**
+ * @brief Fixed part of a record in a store file; strings and scores follow.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t checksum; // FNV-1a of everything after this field
+    uint32_t text_length;
+    uint32_t source_length;
+    uint32_t target_length;
+    uint32_t translated_length;
+    uint32_t rows;
+    uint32_t cols;
+    uint64_t expires_at;
+} FileStoreRecordHeader;
+
+typedef struct
+{
+    TranslationMemoryStore base;
+    FILE *file;
+    pthread_mutex_t mutex; // Serializes appends
+} FileStore;
+
+static uint32_t file_store_checksum(uint32_t hash, const void *bytes, size_t length)
+{
+    const unsigned char *data = bytes;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static ErrorCode file_store_load(TranslationMemoryStore *base, TranslationMemoryVisitFn visit, void *context)
+{
+    FileStore *store = (FileStore *)base;
+    ErrorCode error = ERROR_SUCCESS;
+    char *payload = NULL;
+    size_t payload_capacity = 0;
+
+    pthread_mutex_lock(&store->mutex);
+    rewind(store->file);
+
+    char magic[FILE_STORE_MAGIC_SIZE];
+    size_t magic_read = fread(magic, 1, FILE_STORE_MAGIC_SIZE, store->file);
+    if (magic_read == 0)
+    {
+        // A new file; give it its header
+        clearerr(store->file);
+        if (fwrite(FILE_STORE_MAGIC, 1, FILE_STORE_MAGIC_SIZE, store->file) != FILE_STORE_MAGIC_SIZE || fflush(store->file) != 0)
+        {
+            error = ERROR_FILE_IO;
+            LOG_ERROR(error, "Failed to write translation memory store header");
+        }
+        pthread_mutex_unlock(&store->mutex);
+        return error;
+    }
+    if (magic_read != FILE_STORE_MAGIC_SIZE || memcmp(magic, FILE_STORE_MAGIC, FILE_STORE_MAGIC_SIZE) != 0)
+    {
+        pthread_mutex_unlock(&store->mutex);
+        LOG_ERROR(LIMDY_TRANSLATION_MEMORY_ERROR_BAD_STORE, "File is not a translation memory store");
+        return LIMDY_TRANSLATION_MEMORY_ERROR_BAD_STORE;
+    }
+
+    long good_end = ftell(store->file);
+    for (;;)
+    {
+        FileStoreRecordHeader header;
+        if (fread(&header, sizeof(header), 1, store->file) != 1 || header.magic != FILE_STORE_RECORD_MAGIC)
+        {
+            break;
+        }
+
+        size_t score_bytes = (size_t)header.rows * header.cols * sizeof(float);
+        size_t string_bytes = (size_t)header.text_length + header.source_length + header.target_length + header.translated_length + 4;
+        size_t payload_size = score_bytes + string_bytes;
+        if (payload_size > payload_capacity)
+        {
+            char *grown = realloc(payload, payload_size);
+            if (!grown)
+            {
+                error = ERROR_MEMORY_ALLOCATION;
+                LOG_ERROR(error, "Failed to allocate translation memory record buffer");
+                break;
+            }
+            payload = grown;
+            payload_capacity = payload_size;
+        }
+
+        // Scores first so they stay aligned in the buffer; strings are stored without terminators
+        size_t stored_strings = string_bytes - 4;
+        char *strings = payload + score_bytes;
+        if (fread(payload, 1, score_bytes, store->file) != score_bytes ||
+            fread(strings, 1, stored_strings, store->file) != stored_strings)
+        {
+            break;
+        }
+
+        uint32_t checksum = file_store_checksum(2166136261u, &header.text_length, sizeof(header) - offsetof(FileStoreRecordHeader, text_length));
+        checksum = file_store_checksum(checksum, payload, score_bytes + stored_strings);
+        if (checksum != header.checksum)
+        {
+            break;
+        }
+
+        // Spread the strings out to add their terminators, back to front
+        char *translated = strings + header.text_length + header.source_length + header.target_length + 3;
+        memmove(translated, strings + header.text_length + header.source_length + header.target_length, header.translated_length);
+        translated[header.translated_length] = '\0';
+        char *target_lang = strings + header.text_length + header.source_length + 2;
+        memmove(target_lang, strings + header.text_length + header.source_length, header.target_length);
+        target_lang[header.target_length] = '\0';
+        char *source_lang = strings + header.text_length + 1;
+        memmove(source_lang, strings + header.text_length, header.source_length);
+        source_lang[header.source_length] = '\0';
+        strings[header.text_length] = '\0';
+
+        TranslationMemoryRecord record = {strings, source_lang, target_lang, translated,
+                                          (const float *)payload, header.rows, header.cols, header.expires_at};
+        error = visit(context, &record);
+        if (error != ERROR_SUCCESS)
+        {
+            break;
+        }
+        good_end = ftell(store->file);
+    }
+
+    // Drop a record torn by a crash so that appends after it can be read back
+    clearerr(store->file);
+    if (error == ERROR_SUCCESS && fseek(store->file, 0, SEEK_END) == 0 && ftell(store->file) > good_end)
+    {
+        fflush(store->file);
+        if (ftruncate(fileno(store->file), good_end) != 0)
+        {
+            error = ERROR_FILE_IO;
+            LOG_ERROR(error, "Failed to truncate damaged translation memory store");
+        }
+    }
+    pthread_mutex_unlock(&store->mutex);
+
+    free(payload);
+    return error;
+}
+
+static ErrorCode file_store_save(TranslationMemoryStore *base, const TranslationMemoryRecord *record)
+{
+    FileStore *store = (FileStore *)base;
+
+    FileStoreRecordHeader header = {
+        .magic = FILE_STORE_RECORD_MAGIC,
+        .text_length = (uint32_t)strlen(record->text),
+        .source_length = (uint32_t)strlen(record->source_lang),
+        .target_length = (uint32_t)strlen(record->target_lang),
+        .translated_length = (uint32_t)strlen(record->translated_text),
+        .rows = (uint32_t)record->rows,
+        .cols = (uint32_t)record->cols,
+        .expires_at = record->expires_at};
+    size_t score_bytes = record->rows * record->cols * sizeof(float);
+
+    uint32_t checksum = file_store_checksum(2166136261u, &header.text_length, sizeof(header) - offsetof(FileStoreRecordHeader, text_length));
+    checksum = file_store_checksum(checksum, record->attention, score_bytes);
+    checksum = file_store_checksum(checksum, record->text, header.text_length);
+    checksum = file_store_checksum(checksum, record->source_lang, header.source_length);
+    checksum = file_store_checksum(checksum, record->target_lang, header.target_length);
+    header.checksum = file_store_checksum(checksum, record->translated_text, header.translated_length);
+
+    MUTEX_LOCK(&store->mutex);
+    bool written = fwrite(&header, sizeof(header), 1, store->file) == 1 &&
+                   fwrite(record->attention, 1, score_bytes, store->file) == score_bytes &&
+                   fwrite(record->text, 1, header.text_length, store->file) == header.text_length &&
+                   fwrite(record->source_lang, 1, header.source_length, store->file) == header.source_length &&
+                   fwrite(record->target_lang, 1, header.target_length, store->file) == header.target_length &&
+                   fwrite(record->translated_text, 1, header.translated_length, store->file) == header.translated_length &&
+                   fflush(store->file) == 0;
+    MUTEX_UNLOCK(&store->mutex);
+
+    if (!written)
+    {
+        LOG_ERROR(ERROR_FILE_IO, "Failed to append translation memory record");
+        return ERROR_FILE_IO;
+    }
+    return ERROR_SUCCESS;
+}
+
+static void file_store_destroy(TranslationMemoryStore *base)
+{
+    FileStore *store = (FileStore *)base;
+    fclose(store->file);
+    pthread_mutex_destroy(&store->mutex);
+    limdy_memory_pool_free(store);
+}
+
+/**
+ * @brief Opens an append-only file store.
+ *
+ * @param path Path of the file.
+ * @param store Pointer to store the created store.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translation_memory_file_store_create(const char *path, TranslationMemoryStore **store)
+{
+    CHECK_NULL(path, ERROR_NULL_POINTER);
+    CHECK_NULL(store, ERROR_NULL_POINTER);
+
+    FileStore *new_store = limdy_memory_pool_alloc(sizeof(FileStore));
+    CHECK_NULL(new_store, ERROR_MEMORY_ALLOCATION);
+
+    // Append mode keeps every write at the end while still allowing the replay to read
+    new_store->file = fopen(path, "a+b");
+    if (!new_store->file)
+    {
+        limdy_memory_pool_free(new_store);
+        LOG_ERROR(ERROR_FILE_IO, "Failed to open translation memory store %s", path);
+        return ERROR_FILE_IO;
+    }
+    if (pthread_mutex_init(&new_store->mutex, NULL) != 0)
+    {
+        fclose(new_store->file);
+        limdy_memory_pool_free(new_store);
+        LOG_ERROR(ERROR_THREAD_INIT, "Failed to initialize translation memory store mutex");
+        return ERROR_THREAD_INIT;
+    }
+
+    new_store->base.load = file_store_load;
+    new_store->base.save = file_store_save;
+    new_store->base.destroy = file_store_destroy;
+    new_store->base.find = NULL;
+
+    *store = &new_store->base;
+    return ERROR_SUCCESS;
+}
@@ -11,10 +11,337 @@
  */
 
 #include "components/translator_aligner.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "utils/limdy_utils.h"
 #include "utils/memory_pool.h"
+#include "utils/arena.h"
+#include "utils/limdy_matrix.h"
+#include "utils/thread_pool.h"
+#include "utils/limdy_metrics.h"
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Per-thread scratch arena for the aligner's intermediate renderer results
+static __thread LimdyArena *aligner_scratch = NULL;
+static pthread_key_t aligner_scratch_key;
+static pthread_once_t aligner_scratch_once = PTHREAD_ONCE_INIT;
+
+static void aligner_scratch_release(void *arena)
+{
+    limdy_arena_destroy(arena);
+}
+
+static void aligner_scratch_key_init(void)
+{
+    pthread_key_create(&aligner_scratch_key, aligner_scratch_release);
+}
+
+/**
+ * @brief Get the calling thread's scratch arena, creating it on first use.
+ *
+ * The arena is destroyed when the thread exits.
+ *
+ * @return The scratch arena, or NULL on allocation failure.
+ */
+static LimdyArena *aligner_get_scratch(void)
+{
+    if (aligner_scratch)
+    {
+        return aligner_scratch;
+    }
+
+    pthread_once(&aligner_scratch_once, aligner_scratch_key_init);
+
+    if (limdy_arena_create(LIMDY_ARENA_DEFAULT_CHUNK_SIZE, &aligner_scratch) != ERROR_SUCCESS)
+    {
+        return NULL;
+    }
+    pthread_setspecific(aligner_scratch_key, aligner_scratch);
+
+    return aligner_scratch;
+}
+
+/**
+ * @brief Initializes an empty result pool recycler.
+ *
+ * @param recycler The recycler to initialize.
+ * @return ErrorCode indicating success or failure.
+ */
+static ErrorCode recycler_init(TranslationPoolRecycler *recycler)
+{
+    recycler->count = 0;
+    recycler->estimate = 0;
+
+    if (pthread_mutex_init(&recycler->mutex, NULL) != 0)
+    {
+        LOG_ERROR(ERROR_THREAD_INIT, "Failed to initialize result pool recycler mutex");
+        return ERROR_THREAD_INIT;
+    }
+
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Destroys all idle pools held by a recycler.
+ *
+ * @param recycler The recycler to destroy.
+ */
+static void recycler_destroy(TranslationPoolRecycler *recycler)
+{
+    for (size_t i = 0; i < recycler->count; i++)
+    {
+        limdy_memory_pool_destroy(recycler->pools[i]);
+    }
+    recycler->count = 0;
+    pthread_mutex_destroy(&recycler->mutex);
+}
+
+/**
+ * @brief Takes a pool with room for at least @p needed bytes from a recycler.
+ *
+ * An idle pool is reused when one is large enough; otherwise a new pool is
+ * sized from the larger of the request and the running estimate.
+ *
+ * @param recycler The recycler to take from.
+ * @param needed Number of bytes the result will allocate, including block headers.
+ * @param pool Pointer to store the pool.
+ * @return ErrorCode indicating success or failure.
+ */
+static ErrorCode recycler_acquire(TranslationPoolRecycler *recycler, size_t needed, LimdyMemoryPool **pool)
+{
+    MUTEX_LOCK(&recycler->mutex);
+
+    size_t estimate = recycler->estimate;
+    for (size_t i = 0; i < recycler->count; i++)
+    {
+        size_t total_size = 0;
+        limdy_memory_pool_get_pool_stats(recycler->pools[i], &total_size, NULL);
+        if (total_size >= needed)
+        {
+            *pool = recycler->pools[i];
+            recycler->pools[i] = recycler->pools[--recycler->count];
+            MUTEX_UNLOCK(&recycler->mutex);
+            return ERROR_SUCCESS;
+        }
+    }
+
+    MUTEX_UNLOCK(&recycler->mutex);
+
+    // Leave a quarter of headroom over the average so typical requests fit
+    size_t pool_size = estimate + estimate / 4;
+    if (pool_size < needed)
+    {
+        pool_size = needed;
+    }
+    pool_size = ALIGN_SIZE(pool_size, LIMDY_TRANSLATOR_POOL_GRANULE);
+
+    ErrorCode error = limdy_memory_pool_create(pool_size, pool);
+    if (error != ERROR_SUCCESS)
+    {
+        LOG_ERROR(error, "Failed to create memory pool for translation result");
+    }
+    return error;
+}
+
+/**
+ * @brief Hands a result pool back to a recycler.
+ *
+ * The bytes the result used feed the running estimate. The pool is reset
+ * and kept for reuse unless the free list is full or the pool is far larger
+ * than typical requests need, in which case it is destroyed.
+ *
+ * @param recycler The recycler to return to.
+ * @param pool The pool to return.
+ */
+static void recycler_release(TranslationPoolRecycler *recycler, LimdyMemoryPool *pool)
+{
+    size_t total_size = 0;
+    size_t used_size = 0;
+    limdy_memory_pool_get_pool_stats(pool, &total_size, &used_size);
+
+    pthread_mutex_lock(&recycler->mutex);
+
+    // Exponential moving average with weight 1/8 for the newest sample
+    if (recycler->estimate == 0)
+    {
+        recycler->estimate = used_size;
+    }
+    else
+    {
+        recycler->estimate = recycler->estimate - recycler->estimate / 8 + used_size / 8;
+    }
+
+    size_t keep_limit = ALIGN_SIZE(recycler->estimate * 4, LIMDY_TRANSLATOR_POOL_GRANULE);
+    bool keep = recycler->count < LIMDY_TRANSLATOR_POOL_CACHE_SIZE && total_size <= keep_limit;
+    if (keep)
+    {
+        recycler->pools[recycler->count++] = pool;
+    }
+
+    pthread_mutex_unlock(&recycler->mutex);
+
+    if (keep)
+    {
+        limdy_memory_pool_reset(pool);
+    }
+    else
+    {
+        limdy_memory_pool_destroy(pool);
+    }
+}
+
+/**
+ * @brief Computes the pool bytes needed to hold a translation result.
+ *
+ * @param text_length Length of the translated text.
+ * @param rows Number of rows in the attention matrix.
+ * @param cols Number of columns in the attention matrix.
+ * @param copy_matrix Whether the matrix data is copied into the result.
+ * @return Number of bytes, including block headers.
+ */
+static size_t translation_result_size(size_t text_length, size_t rows, size_t cols, bool copy_matrix)
+{
+    // Text, row pointers and matrix data are one block each
+    size_t size = ALIGN_SIZE(text_length + 1, LIMDY_MEMORY_ALIGNMENT) +
+                  ALIGN_SIZE(rows * sizeof(float *), LIMDY_MEMORY_ALIGNMENT) +
+                  3 * MIN_BLOCK_SIZE;
+    if (copy_matrix)
+    {
+        size += limdy_matrix_bytes(rows, cols) + LIMDY_MATRIX_ALIGNMENT;
+    }
+    return size;
+}
+
+/**
+ * @brief Allocates storage for a translation result from its arena or pool.
+ */
+static void *result_alloc(TranslationResult *result, size_t size)
+{
+    return result->arena ? limdy_arena_alloc(result->arena, size) : limdy_memory_pool_alloc_from(result->pool, size);
+}
+
+/**
+ * @brief Allocates LIMDY_MATRIX_ALIGNMENT aligned storage for a translation result.
+ */
+static void *result_alloc_matrix(TranslationResult *result, size_t size)
+{
+    if (result->arena)
+    {
+        return limdy_arena_alloc_aligned(result->arena, size, LIMDY_MATRIX_ALIGNMENT);
+    }
+
+    // Pool blocks are only LIMDY_MEMORY_ALIGNMENT aligned; over-allocate and round up
+    char *block = limdy_memory_pool_alloc_from(result->pool, size + LIMDY_MATRIX_ALIGNMENT - LIMDY_MEMORY_ALIGNMENT);
+    if (!block)
+    {
+        return NULL;
+    }
+    return (void *)ALIGN_SIZE((uintptr_t)block, LIMDY_MATRIX_ALIGNMENT);
+}
+
+/**
+ * @brief Copies service output into the result's own storage.
+ *
+ * A dense matrix from the service is moved into the result as-is and
+ * @p dense is cleared. A float ** matrix is copied into dense storage.
+ * Either way attention_matrix is a row-pointer view over result->attention.
+ *
+ * @param result The initialized result to fill.
+ * @param text The translated text from the service.
+ * @param matrix The float ** attention matrix from the service, or NULL.
+ * @param dense The dense attention matrix from the service, used when matrix is NULL.
+ * @param rows Number of rows in the attention matrix.
+ * @param cols Number of columns in the attention matrix.
+ * @return ErrorCode indicating success or failure.
+ */
+static ErrorCode copy_translation_output(TranslationResult *result, const char *text, float **matrix, LimdyMatrix *dense, size_t rows, size_t cols)
+{
+    size_t text_length = strlen(text);
+
+    result->translated_text = result_alloc(result, text_length + 1);
+    if (!result->translated_text)
+    {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    memcpy(result->translated_text, text, text_length + 1);
+
+    if (!matrix)
+    {
+        result->attention = *dense;
+        memset(dense, 0, sizeof(LimdyMatrix));
+    }
+
+    result->rows = rows;
+    result->cols = cols;
+    if (rows == 0 || cols == 0)
+    {
+        return ERROR_SUCCESS;
+    }
+
+    if (matrix)
+    {
+        void *storage = result_alloc_matrix(result, limdy_matrix_bytes(rows, cols));
+        if (!storage)
+        {
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        RETURN_IF_ERROR(limdy_matrix_wrap(&result->attention, rows, cols, storage));
+        RETURN_IF_ERROR(limdy_matrix_copy_from_rows(&result->attention, matrix));
+    }
+
+    result->attention_matrix = result_alloc(result, rows * sizeof(float *));
+    if (!result->attention_matrix)
+    {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    return limdy_matrix_row_pointers(&result->attention, result->attention_matrix);
+}
+
+/**
+ * @brief Gives a result its own storage and copies service output into it.
+ *
+ * @param translator The Translator whose recycler provides the pool.
+ * @param result The result to fill; an arena set on it is kept.
+ * @param translated_text The text returned by the service.
+ * @param attention_matrix The float ** matrix from the service, or NULL.
+ * @param dense The dense matrix from the service, used when attention_matrix is NULL.
+ * @param rows Number of rows in the attention matrix.
+ * @param cols Number of columns in the attention matrix.
+ * @return ErrorCode indicating success or failure.
+ */
+static ErrorCode translator_store_result(Translator *translator, TranslationResult *result, const char *translated_text,
+                                         float **attention_matrix, LimdyMatrix *dense, size_t rows, size_t cols)
+{
+    ErrorCode error;
+
+    // Size the result from the actual output instead of a fixed large pool
+    if (result->arena)
+    {
+        error = allocate_translation_result_from_arena(result, result->arena);
+    }
+    else
+    {
+        memset(result, 0, sizeof(TranslationResult));
+        size_t needed = translation_result_size(strlen(translated_text), rows, cols, attention_matrix != NULL);
+        error = recycler_acquire(&translator->recycler, needed, &result->pool);
+        result->recycler = result->pool ? &translator->recycler : NULL;
+    }
+    if (error != ERROR_SUCCESS)
+    {
+        return error;
+    }
+
+    error = copy_translation_output(result, translated_text, attention_matrix, dense, rows, cols);
+    if (error != ERROR_SUCCESS)
+    {
+        LOG_ERROR(error, "Failed to copy translation into result");
+        free_translation_result(result);
+    }
+    return error;
+}
 
 /**
  * @brief Creates a new Translator instance.
@@ -24,27 +351,26 @@
  */
 Translator *translator_create(TranslationService *service)
 {
-    CHECK_NULL(service, ERROR_NULL_POINTER);
+    // CHECK_NULL would return the error code as a pointer here
+    if (!service)
+    {
+        LOG_ERROR(ERROR_NULL_POINTER, "Null translation service");
+        return NULL;
+    }
 
     Translator *translator = limdy_memory_pool_alloc(sizeof(Translator));
-    CHECK_NULL(translator, ERROR_MEMORY_ALLOCATION);
-
-    translator->service = service;
-
-    if (pthread_mutex_init(&translator->mutex, NULL) != 0)
+    if (!translator)
     {
-        LOG_ERROR(ERROR_THREAD_INIT, "Failed to initialize translator mutex");
-        limdy_memory_pool_free(translator);
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate translator");
         return NULL;
     }
 
-    translator->pool = NULL;
-    ErrorCode error = limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &translator->pool);
-    if (error != ERROR_SUCCESS)
+    translator->service = service;
+    translator->memory = NULL;
+
+    if (recycler_init(&translator->recycler) != ERROR_SUCCESS)
     {
-        pthread_mutex_destroy(&translator->mutex);
         limdy_memory_pool_free(translator);
-        LOG_ERROR(error, "Failed to create memory pool for translator");
         return NULL;
     }
 
@@ -60,343 +386,1664 @@ void translator_destroy(Translator *translator)
 {
     if (translator)
     {
-        pthread_mutex_destroy(&translator->mutex);
-        if (translator->pool)
+        translation_memory_destroy(translator->memory);
+        recycler_destroy(&translator->recycler);
+        limdy_memory_pool_free(translator);
+    }
+}
+
+/**
+ * @brief Enables the translation memory.
+ *
+ * @param translator The Translator to configure.
+ * @param config The limits and backing of the memory.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translator_enable_memory(Translator *translator, const TranslationMemoryConfig *config)
+{
+    if (!translator)
+    {
+        // The store would otherwise leak; the memory owns it even on failure
+        if (config && config->store)
         {
-            limdy_memory_pool_destroy(translator->pool);
+            config->store->destroy(config->store);
         }
-        limdy_memory_pool_free(translator);
+        LOG_ERROR(ERROR_NULL_POINTER, "Null translator");
+        return ERROR_NULL_POINTER;
     }
+
+    TranslationMemory *memory = NULL;
+    RETURN_IF_ERROR(translation_memory_create(config, &memory));
+
+    translation_memory_destroy(translator->memory);
+    translator->memory = memory;
+    return ERROR_SUCCESS;
 }
 
 /**
- * @brief Performs a translation operation.
+ * @brief Gets the counters of the translation memory.
+ *
+ * @param translator The Translator to query.
+ * @param stats Pointer to store the counters.
+ */
+void translator_get_memory_stats(Translator *translator, TranslationMemoryStats *stats)
+{
+    translation_memory_get_stats(translator ? translator->memory : NULL, stats);
+}
+
+/**
+ * @brief Fills a result from the translation memory.
+ *
+ * @return ERROR_SUCCESS on a hit, LIMDY_TRANSLATION_MEMORY_ERROR_MISS when the
+ *         memory is disabled or does not hold the text, or another error if
+ *         the result could not be stored.
+ */
+static ErrorCode translator_recall(Translator *translator, const char *text, const char *source_lang, const char *target_lang,
+                                   TranslationResult *result)
+{
+    const TranslationMemoryHit *hit = NULL;
+    if (!translator->memory || translation_memory_lookup(translator->memory, text, source_lang, target_lang, &hit) != ERROR_SUCCESS)
+    {
+        return LIMDY_TRANSLATION_MEMORY_ERROR_MISS;
+    }
+
+    // The memory packs rows without padding; copy through row pointers into the result's own matrix
+    ErrorCode error = ERROR_SUCCESS;
+    float **rows = NULL;
+    LimdyMatrix none = {0};
+    if (hit->rows > 0 && hit->cols > 0)
+    {
+        rows = limdy_memory_pool_alloc(hit->rows * sizeof(float *));
+        if (!rows)
+        {
+            error = ERROR_MEMORY_ALLOCATION;
+            LOG_ERROR(error, "Failed to allocate rows of remembered attention matrix");
+        }
+        for (size_t i = 0; rows && i < hit->rows; i++)
+        {
+            rows[i] = (float *)hit->attention + i * hit->cols;
+        }
+    }
+
+    if (error == ERROR_SUCCESS)
+    {
+        error = translator_store_result(translator, result, hit->translated_text, rows, &none,
+                                        rows ? hit->rows : 0, rows ? hit->cols : 0);
+    }
+
+    limdy_memory_pool_free(rows);
+    translation_memory_release(hit);
+    return error;
+}
+
+/**
+ * @brief Adds a fresh translation to the translation memory, if enabled.
+ *
+ * Failures are logged but do not fail the translation that produced it.
+ */
+static void translator_remember(Translator *translator, const char *text, const char *source_lang, const char *target_lang,
+                                const TranslationResult *result)
+{
+    if (translator->memory)
+    {
+        translation_memory_insert(translator->memory, text, source_lang, target_lang, result->translated_text, &result->attention);
+    }
+}
+
+/**
+ * @brief Translates through the service, bypassing the translation memory lookup.
  *
  * This function translates the given text from the source language to the target language
- * and generates an attention matrix for alignment.
+ * and generates an attention matrix for alignment. No lock is held across the
+ * service calls, so concurrent translations overlap.
  *
  * @param translator The Translator to use.
  * @param text The text to translate.
  * @param source_lang The source language.
  * @param target_lang The target language.
+ * @param partial Function receiving partial translations, or NULL.
+ * @param context Argument passed to @p partial.
  * @param result Pointer to store the translation result.
  * @return ErrorCode indicating success or failure.
  */
-ErrorCode translator_translate(Translator *translator, const char *text, const char *source_lang, const char *target_lang, TranslationResult *result)
+static ErrorCode translator_translate_uncached(Translator *translator, const char *text, const char *source_lang, const char *target_lang,
+                                              TranslationPartialFn partial, void *context, TranslationResult *result)
 {
-    CHECK_NULL(translator, ERROR_NULL_POINTER);
-    CHECK_NULL(text, ERROR_NULL_POINTER);
-    CHECK_NULL(source_lang, ERROR_NULL_POINTER);
-    CHECK_NULL(target_lang, ERROR_NULL_POINTER);
-    CHECK_NULL(result, ERROR_NULL_POINTER);
+    char *translated_text = NULL;
+    float **attention_matrix = NULL;
+    LimdyMatrix dense = {0};
+    size_t rows = 0;
+    size_t cols = 0;
 
-    MUTEX_LOCK(&translator->mutex);
+    LIMDY_METRIC_TIME_BEGIN(started);
+    bool streamed = partial && translator->service->translate_stream;
+    ErrorCode error = streamed ? translator->service->translate_stream(text, source_lang, target_lang, partial, context, &translated_text)
+                               : translator->service->translate(text, source_lang, target_lang, &translated_text);
+    LIMDY_METRIC_TIME_END(started, LIMDY_HISTOGRAM_TRANSLATE_NS);
+    if (error != ERROR_SUCCESS)
+    {
+        LOG_ERROR(error, "Translation failed");
+        return error;
+    }
+    if (partial && !streamed)
+    {
+        partial(context, translated_text, strlen(translated_text));
+    }
 
-    ErrorCode error = allocate_translation_result(result, LIMDY_LARGE_POOL_SIZE); // TODO Implement flexible pool size
+    // Prefer services that write the dense layout directly
+    if (translator->service->get_attention_dense)
+    {
+        error = translator->service->get_attention_dense(text, translated_text, &dense);
+        rows = dense.rows;
+        cols = dense.cols;
+    }
+    else
+    {
+        error = translator->service->get_attention_matrix(text, translated_text, &attention_matrix, &rows, &cols);
+    }
     if (error != ERROR_SUCCESS)
     {
-        MUTEX_UNLOCK(&translator->mutex);
-        return error;
+        LOG_ERROR(error, "Failed to get attention matrix");
+        attention_matrix = NULL;
+        rows = 0;
+        goto cleanup;
+    }
+
+    error = translator_store_result(translator, result, translated_text, attention_matrix, &dense, rows, cols);
+    if (error == ERROR_SUCCESS)
+    {
+        translator_remember(translator, text, source_lang, target_lang, result);
+    }
+
+cleanup:
+    limdy_matrix_free(&dense);
+    if (translator->service->free_translation)
+    {
+        translator->service->free_translation(translated_text, attention_matrix, attention_matrix ? rows : 0);
+    }
+
+    return error;
+}
+
+/**
+ * @brief Performs a translation operation.
+ *
+ * The translation memory is consulted first; on a miss the service is
+ * called and its output is remembered.
+ *
+ * @param translator The Translator to use.
+ * @param text The text to translate.
+ * @param source_lang The source language.
+ * @param target_lang The target language.
+ * @param result Pointer to store the translation result.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translator_translate(Translator *translator, const char *text, const char *source_lang, const char *target_lang, TranslationResult *result)
+{
+    CHECK_NULL(translator, ERROR_NULL_POINTER);
+    CHECK_NULL(text, ERROR_NULL_POINTER);
+    CHECK_NULL(source_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(target_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(result, ERROR_NULL_POINTER);
+
+    ErrorCode error = translator_recall(translator, text, source_lang, target_lang, result);
+    if (error != LIMDY_TRANSLATION_MEMORY_ERROR_MISS)
+    {
+        return error;
+    }
+
+    return translator_translate_uncached(translator, text, source_lang, target_lang, NULL, NULL, result);
+}
+
+/**
+ * @brief Performs a translation operation, passing on partial translations.
+ *
+ * @param translator The Translator to use.
+ * @param text The text to translate.
+ * @param source_lang The source language.
+ * @param target_lang The target language.
+ * @param partial Function to call with each partial translation.
+ * @param context Argument to pass to @p partial.
+ * @param result Pointer to store the translation result.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translator_translate_stream(Translator *translator, const char *text, const char *source_lang, const char *target_lang,
+                                      TranslationPartialFn partial, void *context, TranslationResult *result)
+{
+    CHECK_NULL(translator, ERROR_NULL_POINTER);
+    CHECK_NULL(text, ERROR_NULL_POINTER);
+    CHECK_NULL(source_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(target_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(partial, ERROR_NULL_POINTER);
+    CHECK_NULL(result, ERROR_NULL_POINTER);
+
+    ErrorCode error = translator_recall(translator, text, source_lang, target_lang, result);
+    if (error == ERROR_SUCCESS)
+    {
+        partial(context, result->translated_text, strlen(result->translated_text));
+    }
+    if (error != LIMDY_TRANSLATION_MEMORY_ERROR_MISS)
+    {
+        return error;
+    }
+
+    return translator_translate_uncached(translator, text, source_lang, target_lang, partial, context, result);
+}
+
+/**
+ * @brief Translates a batch of texts.
+ *
+ * Services with a translate_batch hook get the whole batch in one call;
+ * otherwise each text goes through translator_translate.
+ *
+ * @param translator The Translator to use.
+ * @param texts The texts to translate.
+ * @param count Number of texts.
+ * @param source_lang The source language.
+ * @param target_lang The target language.
+ * @param results Array of count results to fill.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translator_translate_batch(Translator *translator, const char **texts, size_t count, const char *source_lang, const char *target_lang, TranslationResult *results)
+{
+    CHECK_NULL(translator, ERROR_NULL_POINTER);
+    CHECK_NULL(texts, ERROR_NULL_POINTER);
+    CHECK_NULL(source_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(target_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(results, ERROR_NULL_POINTER);
+
+    ErrorCode error = ERROR_SUCCESS;
+
+    if (!translator->service->translate_batch)
+    {
+        size_t stored = 0;
+        for (; stored < count && error == ERROR_SUCCESS; stored++)
+        {
+            error = translator_translate(translator, texts[stored], source_lang, target_lang, &results[stored]);
+        }
+        if (error != ERROR_SUCCESS)
+        {
+            // The failed result was already released
+            for (size_t i = 0; i + 1 < stored; i++)
+            {
+                free_translation_result(&results[i]);
+            }
+        }
+        return error;
+    }
+
+    char **translated_texts = limdy_memory_pool_alloc(count * sizeof(char *));
+    LimdyMatrix *attention = limdy_memory_pool_alloc(count * sizeof(LimdyMatrix));
+    const char **missing_texts = limdy_memory_pool_alloc(count * sizeof(char *));
+    size_t *missing = limdy_memory_pool_alloc(count * sizeof(size_t));
+    bool *filled = limdy_memory_pool_alloc(count * sizeof(bool));
+    if (!translated_texts || !attention || !missing_texts || !missing || !filled)
+    {
+        error = ERROR_MEMORY_ALLOCATION;
+        LOG_ERROR(error, "Failed to allocate batch translation buffers");
+        goto cleanup;
+    }
+    memset(translated_texts, 0, count * sizeof(char *));
+    memset(attention, 0, count * sizeof(LimdyMatrix));
+    memset(filled, 0, count * sizeof(bool));
+
+    // Only texts the translation memory does not hold go to the service
+    size_t missing_count = 0;
+    for (size_t i = 0; i < count && error == ERROR_SUCCESS; i++)
+    {
+        error = translator_recall(translator, texts[i], source_lang, target_lang, &results[i]);
+        if (error == LIMDY_TRANSLATION_MEMORY_ERROR_MISS)
+        {
+            missing[missing_count] = i;
+            missing_texts[missing_count++] = texts[i];
+            error = ERROR_SUCCESS;
+        }
+        else
+        {
+            filled[i] = error == ERROR_SUCCESS;
+        }
+    }
+    if (error != ERROR_SUCCESS || missing_count == 0)
+    {
+        goto cleanup;
+    }
+
+    LIMDY_METRIC_TIME_BEGIN(started);
+    error = translator->service->translate_batch(missing_texts, missing_count, source_lang, target_lang, translated_texts, attention);
+    LIMDY_METRIC_TIME_END(started, LIMDY_HISTOGRAM_TRANSLATE_NS);
+    if (error != ERROR_SUCCESS)
+    {
+        LOG_ERROR(error, "Batch translation failed");
+        goto cleanup;
+    }
+
+    for (size_t i = 0; i < missing_count && error == ERROR_SUCCESS; i++)
+    {
+        TranslationResult *result = &results[missing[i]];
+        error = translator_store_result(translator, result, translated_texts[i], NULL, &attention[i],
+                                        attention[i].rows, attention[i].cols);
+        if (error == ERROR_SUCCESS)
+        {
+            filled[missing[i]] = true;
+            translator_remember(translator, missing_texts[i], source_lang, target_lang, result);
+        }
+    }
+
+    for (size_t i = 0; i < missing_count; i++)
+    {
+        limdy_matrix_free(&attention[i]);
+        if (translator->service->free_translation)
+        {
+            translator->service->free_translation(translated_texts[i], NULL, 0);
+        }
+    }
+
+cleanup:
+    // A result that failed to store was already released
+    for (size_t i = 0; error != ERROR_SUCCESS && filled && i < count; i++)
+    {
+        if (filled[i])
+        {
+            free_translation_result(&results[i]);
+        }
+    }
+
+    limdy_memory_pool_free(translated_texts);
+    limdy_memory_pool_free(attention);
+    limdy_memory_pool_free(missing_texts);
+    limdy_memory_pool_free(missing);
+    limdy_memory_pool_free(filled);
+    return error;
+}
+
+/**
+ * @brief Creates a new Aligner instance.
+ *
+ * @param service The alignment service to use, or NULL for the built-in attention aligner.
+ * @param renderer The renderer to use for tokenization.
+ * @return A pointer to the new Aligner, or NULL if creation fails.
+ */
+Aligner *aligner_create(AlignmentService *service, Renderer *renderer)
+{
+    // CHECK_NULL would return the error code as a pointer here
+    if (!renderer)
+    {
+        LOG_ERROR(ERROR_NULL_POINTER, "Null renderer");
+        return NULL;
+    }
+
+    Aligner *aligner = limdy_memory_pool_alloc(sizeof(Aligner));
+    if (!aligner)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate Aligner");
+        return NULL;
+    }
+
+    aligner->service = service;
+    aligner->renderer = renderer;
+    aligner->options = LIMDY_ALIGN_OPTIONS_DEFAULT;
+
+    return aligner;
+}
+
+/**
+ * @brief Sets the options used by the built-in attention aligner.
+ *
+ * Options are read without locking, so set them before the aligner is
+ * shared between threads.
+ *
+ * @param aligner The Aligner to configure.
+ * @param options The options to use.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode aligner_set_options(Aligner *aligner, const LimdyAlignOptions *options)
+{
+    CHECK_NULL(aligner, ERROR_NULL_POINTER);
+    CHECK_NULL(options, ERROR_NULL_POINTER);
+
+    aligner->options = *options;
+
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Destroys an Aligner instance and frees its resources.
+ *
+ * @param aligner The Aligner to destroy.
+ */
+void aligner_destroy(Aligner *aligner)
+{
+    if (aligner)
+    {
+        limdy_memory_pool_free(aligner);
+    }
+}
+
+/**
+ * @brief Gets a dense view of the attention matrix, copying into the scratch arena if needed.
+ */
+static ErrorCode aligner_dense_matrix(LimdyArena *scratch, float **attention_matrix, const LimdyMatrix *dense,
+                                      size_t rows, size_t cols, LimdyMatrix *converted, const LimdyMatrix **out)
+{
+    if (dense)
+    {
+        *out = dense;
+        return ERROR_SUCCESS;
+    }
+
+    void *storage = limdy_arena_alloc_aligned(scratch, limdy_matrix_bytes(rows, cols), LIMDY_MATRIX_ALIGNMENT);
+    if (!storage)
+    {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    RETURN_IF_ERROR(limdy_matrix_wrap(converted, rows, cols, storage));
+    RETURN_IF_ERROR(limdy_matrix_copy_from_rows(converted, attention_matrix));
+
+    *out = converted;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Copies the token texts into null-terminated strings in the scratch arena.
+ *
+ * Services take tokens as C strings, while renderer tokens are spans that
+ * are not null-terminated.
+ */
+static const char **aligner_token_strings(LimdyArena *scratch, const RendererResult *tokens)
+{
+    size_t text_bytes = 0;
+    for (size_t i = 0; i < tokens->token_count; i++)
+    {
+        text_bytes += tokens->tokens[i].length + 1;
+    }
+
+    const char **strings = limdy_arena_alloc(scratch, (tokens->token_count ? tokens->token_count : 1) * sizeof(char *));
+    char *text = limdy_arena_alloc(scratch, text_bytes ? text_bytes : 1);
+    if (!strings || !text)
+    {
+        return NULL;
+    }
+    for (size_t i = 0; i < tokens->token_count; i++)
+    {
+        const Token *token = &tokens->tokens[i];
+        memcpy(text, token->text, token->length);
+        text[token->length] = '\0';
+        strings[i] = text;
+        text += token->length + 1;
+    }
+    return strings;
+}
+
+/**
+ * @brief Produces alignment links in the scratch arena.
+ *
+ * The built-in attention aligner writes links directly. Service results
+ * (one target index per source token) are converted to links and the
+ * service's buffer is released. Nothing here writes shared aligner state,
+ * so calls for different texts may run in parallel.
+ *
+ * @return ErrorCode indicating success or failure.
+ */
+static ErrorCode aligner_compute_links(Aligner *aligner, LimdyArena *scratch,
+                                       const RendererResult *source_result, const RendererResult *target_result,
+                                       float **attention_matrix, const LimdyMatrix *dense, size_t rows, size_t cols,
+                                       AlignmentLink **links, size_t *link_count)
+{
+    AlignmentService *service = aligner->service;
+    LimdyMatrix converted;
+    ErrorCode error;
+
+    *links = NULL;
+    *link_count = 0;
+
+    if (!service || (!service->align_tokens_dense && !service->align_tokens))
+    {
+        RETURN_IF_ERROR(aligner_dense_matrix(scratch, attention_matrix, dense, rows, cols, &converted, &dense));
+        *links = limdy_arena_alloc(scratch, limdy_attention_align_capacity(rows, cols) * sizeof(AlignmentLink));
+        if (!*links)
+        {
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        return limdy_attention_align(dense, &aligner->options, scratch, *links, link_count);
+    }
+
+    int *alignment = NULL;
+    size_t alignment_size = 0;
+    const char **source_strings = aligner_token_strings(scratch, source_result);
+    const char **target_strings = aligner_token_strings(scratch, target_result);
+    if (!source_strings || !target_strings)
+    {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    // Hand the service the layout it takes
+    if (service->align_tokens_dense)
+    {
+        RETURN_IF_ERROR(aligner_dense_matrix(scratch, attention_matrix, dense, rows, cols, &converted, &dense));
+        error = service->align_tokens_dense(source_strings, source_result->token_count,
+                                            target_strings, target_result->token_count,
+                                            dense, &alignment, &alignment_size);
+    }
+    else
+    {
+        if (!attention_matrix)
+        {
+            attention_matrix = limdy_arena_alloc(scratch, rows * sizeof(float *));
+            if (!attention_matrix)
+            {
+                return ERROR_MEMORY_ALLOCATION;
+            }
+            limdy_matrix_row_pointers(dense, attention_matrix);
+        }
+        error = service->align_tokens(source_strings, source_result->token_count,
+                                      target_strings, target_result->token_count,
+                                      attention_matrix, rows, cols,
+                                      &alignment, &alignment_size);
+    }
+
+    if (error == ERROR_SUCCESS)
+    {
+        *links = limdy_arena_alloc(scratch, alignment_size * sizeof(AlignmentLink));
+        error = *links ? ERROR_SUCCESS : ERROR_MEMORY_ALLOCATION;
+    }
+    if (error == ERROR_SUCCESS)
+    {
+        for (size_t i = 0; i < alignment_size; i++)
+        {
+            uint32_t target = (uint32_t)alignment[i];
+            float score = 0.0f;
+            if (i < rows && target < cols)
+            {
+                score = attention_matrix ? attention_matrix[i][target] : limdy_matrix_row(dense, i)[target];
+            }
+            (*links)[i] = (AlignmentLink){(uint32_t)i, target, score};
+        }
+        *link_count = alignment_size;
+    }
+
+    limdy_memory_pool_free(alignment);
+    return error;
+}
+
+/**
+ * @brief Tokenizes text through the renderer's cache when it has one, else into @p local.
+ *
+ * @param shared Set to the cached result to release afterwards, or NULL.
+ * @param tokens Set to the tokens to use.
+ */
+static ErrorCode aligner_tokenize(Aligner *aligner, const char *text, RendererResult *local,
+                                  const RendererResult **shared, const RendererResult **tokens)
+{
+    ErrorCode error;
+
+    *shared = NULL;
+    if (aligner->renderer->cache)
+    {
+        error = renderer_tokenize_shared(aligner->renderer, text, LANG_ENGLISH, shared); // Assume English for now
+        *tokens = *shared;
+    }
+    else
+    {
+        error = renderer_tokenize(aligner->renderer, text, LANG_ENGLISH, local); // Assume English for now
+        *tokens = local;
+    }
+    return error;
+}
+
+/**
+ * @brief Copies the links and tokens of an alignment into one allocation.
+ *
+ * Links the matrix has but the renderer produced no token for are dropped.
+ *
+ * @return ErrorCode indicating success or failure.
+ */
+static ErrorCode build_alignment_result(const RendererResult *source_tokens, const RendererResult *target_tokens,
+                                        const AlignmentLink *links, size_t link_count, AlignmentResult *result)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < link_count; i++)
+    {
+        kept += links[i].source_index < source_tokens->token_count && links[i].target_index < target_tokens->token_count;
+    }
+    size_t text_bytes = 0;
+    for (size_t i = 0; i < source_tokens->token_count; i++)
+    {
+        text_bytes += source_tokens->tokens[i].length + 1;
+    }
+    for (size_t i = 0; i < target_tokens->token_count; i++)
+    {
+        text_bytes += target_tokens->tokens[i].length + 1;
+    }
+
+    // Pointer-aligned token arrays first, then the links and the text
+    size_t token_count = source_tokens->token_count + target_tokens->token_count;
+    size_t bytes = token_count * sizeof(AlignedToken) + kept * sizeof(AlignmentLink) + text_bytes;
+    char *buffer = limdy_memory_pool_alloc(bytes ? bytes : 1);
+    if (!buffer)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate alignment result");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    result->buffer = buffer;
+    result->source_tokens = (AlignedToken *)buffer;
+    result->source_count = source_tokens->token_count;
+    result->target_tokens = result->source_tokens + result->source_count;
+    result->target_count = target_tokens->token_count;
+    result->links = (AlignmentLink *)(result->target_tokens + result->target_count);
+    result->link_count = kept;
+
+    char *text = (char *)(result->links + kept);
+    const RendererResult *sides[2] = {source_tokens, target_tokens};
+    AlignedToken *views[2] = {result->source_tokens, result->target_tokens};
+    for (size_t side = 0; side < 2; side++)
+    {
+        for (size_t i = 0; i < sides[side]->token_count; i++)
+        {
+            const Token *token = &sides[side]->tokens[i];
+            memcpy(text, token->text, token->length);
+            text[token->length] = '\0';
+            views[side][i] = (AlignedToken){text, token->length, token->offset};
+            text += token->length + 1;
+        }
+    }
+
+    size_t next = 0;
+    for (size_t i = 0; i < link_count; i++)
+    {
+        if (links[i].source_index < source_tokens->token_count && links[i].target_index < target_tokens->token_count)
+        {
+            result->links[next++] = links[i];
+        }
+    }
+
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Aligns source and target text with either attention layout.
+ *
+ * Exactly one of @p attention_matrix and @p dense is used. The matrix is
+ * converted in the scratch arena only when the service expects the other
+ * layout.
+ *
+ * @param aligner The Aligner to use.
+ * @param source_tokens The already tokenized source text, or NULL to tokenize @p source_text.
+ * @param source_text The source text.
+ * @param target_text The target (translated) text.
+ * @param attention_matrix The attention matrix as row pointers, or NULL.
+ * @param dense The dense attention matrix, used when attention_matrix is NULL.
+ * @param rows Number of rows in the attention matrix.
+ * @param cols Number of columns in the attention matrix.
+ * @param result Pointer to store the alignment result.
+ * @return ErrorCode indicating success or failure.
+ */
+static ErrorCode aligner_align_links(Aligner *aligner, const RendererResult *source_tokens, const char *source_text, const char *target_text,
+                                     float **attention_matrix, const LimdyMatrix *dense, size_t rows, size_t cols,
+                                     AlignmentResult *result)
+{
+    memset(result, 0, sizeof(AlignmentResult));
+
+    LimdyArena *scratch = aligner_get_scratch();
+    if (!scratch)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to create aligner scratch arena");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    LIMDY_METRIC_TIME_BEGIN(started);
+
+    // Intermediate results live in the scratch arena and are dropped in one reset
+    RendererResult source_result = {.arena = scratch};
+    RendererResult target_result = {.arena = scratch};
+    const RendererResult *shared_source = NULL;
+    const RendererResult *shared_target = NULL;
+    const RendererResult *target_tokens = NULL;
+    AlignmentLink *links = NULL;
+    size_t link_count = 0;
+    ErrorCode error = ERROR_SUCCESS;
+
+    // Tokenize source and target text
+    if (!source_tokens)
+    {
+        error = aligner_tokenize(aligner, source_text, &source_result, &shared_source, &source_tokens);
+        if (error != ERROR_SUCCESS)
+        {
+            LOG_ERROR(error, "Failed to tokenize source text");
+            goto cleanup;
+        }
+    }
+
+    error = aligner_tokenize(aligner, target_text, &target_result, &shared_target, &target_tokens);
+    if (error != ERROR_SUCCESS)
+    {
+        LOG_ERROR(error, "Failed to tokenize target text");
+        goto cleanup;
+    }
+
+    // Align tokens
+    error = aligner_compute_links(aligner, scratch, source_tokens, target_tokens, attention_matrix, dense, rows, cols, &links, &link_count);
+    if (error != ERROR_SUCCESS)
+    {
+        LOG_ERROR(error, "Token alignment failed");
+        goto cleanup;
+    }
+
+    error = build_alignment_result(source_tokens, target_tokens, links, link_count, result);
+
+cleanup:
+    renderer_free_result(aligner->renderer, &source_result);
+    renderer_free_result(aligner->renderer, &target_result);
+    renderer_release_shared(aligner->renderer, shared_source);
+    renderer_release_shared(aligner->renderer, shared_target);
+    limdy_arena_reset(scratch);
+
+    LIMDY_METRIC_TIME_END(started, LIMDY_HISTOGRAM_ALIGN_NS);
+    return error;
+}
+
+/**
+ * @brief Formats every link of a result as its own "[source] [target]" string.
+ *
+ * The strings follow the pointer array in a single allocation, back to back
+ * in entry order.
+ *
+ * @param text_size Pointer to store the bytes of all strings with their terminators, or NULL.
+ * @return ErrorCode indicating success or failure.
+ */
+static ErrorCode format_aligned_entries(const AlignmentResult *result, char ***aligned_text, size_t *aligned_size, size_t *text_size)
+{
+    size_t text_bytes = 0;
+    for (size_t i = 0; i < result->link_count; i++)
+    {
+        const AlignmentLink *link = &result->links[i];
+        text_bytes += result->source_tokens[link->source_index].length + result->target_tokens[link->target_index].length + 6; // "[", "] [", "]" and null terminator
+    }
+
+    char **entries = limdy_memory_pool_alloc(result->link_count * sizeof(char *) + (text_bytes ? text_bytes : 1));
+    if (!entries)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate memory for aligned text");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    char *text = (char *)(entries + result->link_count);
+    for (size_t i = 0; i < result->link_count; i++)
+    {
+        const AlignedToken *source = &result->source_tokens[result->links[i].source_index];
+        const AlignedToken *target = &result->target_tokens[result->links[i].target_index];
+        entries[i] = text;
+        *text++ = '[';
+        memcpy(text, source->text, source->length);
+        text += source->length;
+        memcpy(text, "] [", 3);
+        text += 3;
+        memcpy(text, target->text, target->length);
+        text += target->length;
+        *text++ = ']';
+        *text++ = '\0';
+    }
+
+    *aligned_text = entries;
+    *aligned_size = result->link_count;
+    if (text_size)
+    {
+        *text_size = text_bytes;
+    }
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Aligns source and target text into "[source] [target]" strings.
+ *
+ * @param aligned_text Pointer to store the aligned text.
+ * @param aligned_size Pointer to store the size of the aligned text.
+ * @return ErrorCode indicating success or failure.
+ */
+static ErrorCode aligner_align_impl(Aligner *aligner, const RendererResult *source_tokens, const char *source_text, const char *target_text,
+                                    float **attention_matrix, const LimdyMatrix *dense, size_t rows, size_t cols,
+                                    char ***aligned_text, size_t *aligned_size)
+{
+    *aligned_text = NULL;
+    *aligned_size = 0;
+
+    AlignmentResult result;
+    ErrorCode error = aligner_align_links(aligner, source_tokens, source_text, target_text, attention_matrix, dense, rows, cols, &result);
+    if (error == ERROR_SUCCESS)
+    {
+        error = format_aligned_entries(&result, aligned_text, aligned_size, NULL);
+    }
+    free_alignment_result(&result);
+    return error;
+}
+
+/**
+ * @brief Performs an alignment operation.
+ *
+ * This function aligns the source text with the target (translated) text using
+ * the provided attention matrix.
+ *
+ * @param aligner The Aligner to use.
+ * @param source_text The source text.
+ * @param target_text The target (translated) text.
+ * @param attention_matrix The attention matrix.
+ * @param rows Number of rows in the attention matrix.
+ * @param cols Number of columns in the attention matrix.
+ * @param aligned_text Pointer to store the aligned text.
+ * @param aligned_size Pointer to store the size of the aligned text.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode aligner_align(Aligner *aligner, const char *source_text, const char *target_text, float **attention_matrix, size_t rows, size_t cols, char ***aligned_text, size_t *aligned_size)
+{
+    CHECK_NULL(aligner, ERROR_NULL_POINTER);
+    CHECK_NULL(source_text, ERROR_NULL_POINTER);
+    CHECK_NULL(target_text, ERROR_NULL_POINTER);
+    CHECK_NULL(attention_matrix, ERROR_NULL_POINTER);
+    CHECK_NULL(aligned_text, ERROR_NULL_POINTER);
+    CHECK_NULL(aligned_size, ERROR_NULL_POINTER);
+
+    return aligner_align_impl(aligner, NULL, source_text, target_text, attention_matrix, NULL, rows, cols, aligned_text, aligned_size);
+}
+
+/**
+ * @brief Performs an alignment operation with a dense attention matrix.
+ *
+ * @param aligner The Aligner to use.
+ * @param source_text The source text.
+ * @param target_text The target (translated) text.
+ * @param attention The dense attention matrix.
+ * @param aligned_text Pointer to store the aligned text.
+ * @param aligned_size Pointer to store the size of the aligned text.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode aligner_align_matrix(Aligner *aligner, const char *source_text, const char *target_text, const LimdyMatrix *attention, char ***aligned_text, size_t *aligned_size)
+{
+    CHECK_NULL(aligner, ERROR_NULL_POINTER);
+    CHECK_NULL(source_text, ERROR_NULL_POINTER);
+    CHECK_NULL(target_text, ERROR_NULL_POINTER);
+    CHECK_NULL(attention, ERROR_NULL_POINTER);
+    CHECK_NULL(aligned_text, ERROR_NULL_POINTER);
+    CHECK_NULL(aligned_size, ERROR_NULL_POINTER);
+
+    return aligner_align_impl(aligner, NULL, source_text, target_text, NULL, attention, attention->rows, attention->cols, aligned_text, aligned_size);
+}
+
+/**
+ * @brief Performs an alignment operation, returning the links and tokens.
+ *
+ * @param aligner The Aligner to use.
+ * @param source_text The source text.
+ * @param target_text The target (translated) text.
+ * @param attention_matrix The attention matrix.
+ * @param rows Number of rows in the attention matrix.
+ * @param cols Number of columns in the attention matrix.
+ * @param result Pointer to store the result.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode aligner_align_result(Aligner *aligner, const char *source_text, const char *target_text, float **attention_matrix, size_t rows, size_t cols, AlignmentResult *result)
+{
+    CHECK_NULL(aligner, ERROR_NULL_POINTER);
+    CHECK_NULL(source_text, ERROR_NULL_POINTER);
+    CHECK_NULL(target_text, ERROR_NULL_POINTER);
+    CHECK_NULL(attention_matrix, ERROR_NULL_POINTER);
+    CHECK_NULL(result, ERROR_NULL_POINTER);
+
+    return aligner_align_links(aligner, NULL, source_text, target_text, attention_matrix, NULL, rows, cols, result);
+}
+
+/**
+ * @brief Performs an alignment operation with a dense attention matrix, returning the links and tokens.
+ *
+ * @param aligner The Aligner to use.
+ * @param source_text The source text.
+ * @param target_text The target (translated) text.
+ * @param attention The dense attention matrix.
+ * @param result Pointer to store the result.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode aligner_align_matrix_result(Aligner *aligner, const char *source_text, const char *target_text, const LimdyMatrix *attention, AlignmentResult *result)
+{
+    CHECK_NULL(aligner, ERROR_NULL_POINTER);
+    CHECK_NULL(source_text, ERROR_NULL_POINTER);
+    CHECK_NULL(target_text, ERROR_NULL_POINTER);
+    CHECK_NULL(attention, ERROR_NULL_POINTER);
+    CHECK_NULL(result, ERROR_NULL_POINTER);
+
+    return aligner_align_links(aligner, NULL, source_text, target_text, NULL, attention, attention->rows, attention->cols, result);
+}
+
+/**
+ * @brief Aligns already tokenized source text with a dense attention matrix, returning the links and tokens.
+ *
+ * @param aligner The Aligner to use.
+ * @param source_tokens The tokens of the source text.
+ * @param target_text The target (translated) text.
+ * @param attention The dense attention matrix.
+ * @param result Pointer to store the result.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode aligner_align_tokens_result(Aligner *aligner, const RendererResult *source_tokens, const char *target_text,
+                                      const LimdyMatrix *attention, AlignmentResult *result)
+{
+    CHECK_NULL(aligner, ERROR_NULL_POINTER);
+    CHECK_NULL(source_tokens, ERROR_NULL_POINTER);
+    CHECK_NULL(target_text, ERROR_NULL_POINTER);
+    CHECK_NULL(attention, ERROR_NULL_POINTER);
+    CHECK_NULL(result, ERROR_NULL_POINTER);
+
+    return aligner_align_links(aligner, source_tokens, source_tokens->source, target_text, NULL, attention, attention->rows, attention->cols,
+                               result);
+}
+
+/**
+ * @brief Appends the aligned pairs of a result to a buffer.
+ *
+ * @param result The alignment result to format.
+ * @param buffer The buffer to append to.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode alignment_result_format(const AlignmentResult *result, AlignedTextBuffer *buffer)
+{
+    CHECK_NULL(result, ERROR_NULL_POINTER);
+    CHECK_NULL(buffer, ERROR_NULL_POINTER);
+
+    size_t needed = buffer->length + 1;
+    for (size_t i = 0; i < result->link_count; i++)
+    {
+        const AlignmentLink *link = &result->links[i];
+        needed += result->source_tokens[link->source_index].length + result->target_tokens[link->target_index].length + 6; // "[", "] [", "]" and newline
+    }
+
+    if (needed > buffer->capacity)
+    {
+        size_t capacity = buffer->capacity ? buffer->capacity : 256;
+        while (capacity < needed)
+        {
+            capacity *= 2;
+        }
+        char *data = limdy_memory_pool_realloc(buffer->data, capacity);
+        if (!data)
+        {
+            LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to grow aligned text buffer");
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+
+    char *text = buffer->data + buffer->length;
+    for (size_t i = 0; i < result->link_count; i++)
+    {
+        const AlignedToken *source = &result->source_tokens[result->links[i].source_index];
+        const AlignedToken *target = &result->target_tokens[result->links[i].target_index];
+        *text++ = '[';
+        memcpy(text, source->text, source->length);
+        text += source->length;
+        memcpy(text, "] [", 3);
+        text += 3;
+        memcpy(text, target->text, target->length);
+        text += target->length;
+        *text++ = ']';
+        *text++ = '\n';
+    }
+    *text = '\0';
+    buffer->length = (size_t)(text - buffer->data);
+
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Frees the storage of an alignment result.
+ *
+ * @param result The result to free.
+ */
+void free_alignment_result(AlignmentResult *result)
+{
+    if (result)
+    {
+        limdy_memory_pool_free(result->buffer);
+        memset(result, 0, sizeof(AlignmentResult));
+    }
+}
+
+/**
+ * @brief Frees the storage of a formatting buffer.
+ *
+ * @param buffer The buffer to free.
+ */
+void aligned_text_buffer_free(AlignedTextBuffer *buffer)
+{
+    if (buffer)
+    {
+        limdy_memory_pool_free(buffer->data);
+        memset(buffer, 0, sizeof(AlignedTextBuffer));
+    }
+}
+
+/**
+ * @brief Creates a new TranslatorAligner instance.
+ *
+ * @param trans_service The translation service to use.
+ * @param align_service The alignment service to use, or NULL for the built-in attention aligner.
+ * @param renderer The renderer to use for tokenization.
+ * @return A pointer to the new TranslatorAligner, or NULL if creation fails.
+ */
+TranslatorAligner *translator_aligner_create(TranslationService *trans_service, AlignmentService *align_service, Renderer *renderer)
+{
+    // CHECK_NULL would return the error code as a pointer here
+    if (!trans_service || !renderer)
+    {
+        LOG_ERROR(ERROR_NULL_POINTER, "Null translation service or renderer");
+        return NULL;
+    }
+    TranslatorAligner *ta = limdy_memory_pool_alloc(sizeof(TranslatorAligner));
+    if (!ta)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate TranslatorAligner");
+        return NULL;
+    }
+
+    ta->translator = translator_create(trans_service);
+    if (!ta->translator)
+    {
+        LOG_ERROR(ERROR_UNKNOWN, "Failed to create Translator");
+        limdy_memory_pool_free(ta);
+        return NULL;
+    }
+
+    ta->aligner = aligner_create(align_service, renderer);
+    if (!ta->aligner)
+    {
+        LOG_ERROR(ERROR_UNKNOWN, "Failed to create Aligner");
+        translator_destroy(ta->translator);
+        limdy_memory_pool_free(ta);
+        return NULL;
+    }
+
+    if (pthread_mutex_init(&ta->mutex, NULL) != 0)
+    {
+        LOG_ERROR(ERROR_THREAD_INIT, "Failed to initialize translator_aligner mutex");
+        translator_destroy(ta->translator);
+        aligner_destroy(ta->aligner);
+        limdy_memory_pool_free(ta);
+        return NULL;
+    }
+
+    // Workers are started by the first batch
+    ta->workers = NULL;
+
+    return ta;
+}
+
+/**
+ * @brief Destroys a TranslatorAligner instance and frees its resources.
+ *
+ * @param ta The TranslatorAligner to destroy.
+ */
+void translator_aligner_destroy(TranslatorAligner *ta)
+{
+    if (ta)
+    {
+        limdy_thread_pool_destroy(ta->workers);
+        translator_destroy(ta->translator);
+        aligner_destroy(ta->aligner);
+        pthread_mutex_destroy(&ta->mutex);
+        limdy_memory_pool_free(ta);
+    }
+}
+
+/**
+ * @brief Performs a combined translation and alignment operation.
+ *
+ * This function translates the given text and then aligns it with the original text.
+ * All per-call state lives on the stack and in the calling thread's scratch
+ * arena, so concurrent calls on one instance run in parallel.
+ *
+ * @param ta The TranslatorAligner to use.
+ * @param text The text to translate and align.
+ * @param source_lang The source language.
+ * @param target_lang The target language.
+ * @param aligned_text Pointer to store the aligned text.
+ * @param aligned_size Pointer to store the size of the aligned text.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode translator_aligner_process(TranslatorAligner *ta, const char *text, const char *source_lang, const char *target_lang, char ***aligned_text, size_t *aligned_size)
+{
+    CHECK_NULL(ta, ERROR_NULL_POINTER);
+    CHECK_NULL(text, ERROR_NULL_POINTER);
+    CHECK_NULL(source_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(target_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(aligned_text, ERROR_NULL_POINTER);
+    CHECK_NULL(aligned_size, ERROR_NULL_POINTER);
+
+    TranslationResult result = {0};
+    ErrorCode error = translator_translate(ta->translator, text, source_lang, target_lang, &result);
+    if (error != ERROR_SUCCESS)
+    {
+        LOG_ERROR(error, "Translation failed in translator_aligner_process");
+        return error;
+    }
+
+    error = aligner_align_matrix(ta->aligner, text, result.translated_text, &result.attention, aligned_text, aligned_size);
+    if (error != ERROR_SUCCESS)
+    {
+        LOG_ERROR(error, "Alignment failed in translator_aligner_process");
+    }
+
+    free_translation_result(&result);
+
+    return error;
+}
+
+/**
+ * @brief Gets the translator-aligner's workers, starting them on first use.
+ *
+ * Batches and asynchronous requests share the workers; only their creation
+ * is serialized.
+ */
+static ErrorCode translator_aligner_workers(TranslatorAligner *ta, LimdyThreadPool **workers)
+{
+    ErrorCode error = ERROR_SUCCESS;
+
+    MUTEX_LOCK(&ta->mutex);
+    if (!ta->workers)
+    {
+        error = limdy_thread_pool_create(0, &ta->workers);
+    }
+    *workers = ta->workers;
+    MUTEX_UNLOCK(&ta->mutex);
+
+    return error;
+}
+
+typedef struct
+{
+    Aligner *aligner;
+    const char **texts;
+    TranslationResult *results;
+    char ***entries;
+    size_t *sizes;
+    size_t *text_sizes;
+    ErrorCode *status;
+} BatchAlignJob;
+
+// Formats like aligner_align_impl, keeping the text size so packing needs no strlen
+static void batch_align_item(void *arg, size_t index)
+{
+    BatchAlignJob *job = arg;
+    const LimdyMatrix *attention = &job->results[index].attention;
+
+    AlignmentResult result;
+    ErrorCode error = aligner_align_links(job->aligner, NULL, job->texts[index], job->results[index].translated_text,
+                                          NULL, attention, attention->rows, attention->cols, &result);
+    if (error == ERROR_SUCCESS)
+    {
+        error = format_aligned_entries(&result, &job->entries[index], &job->sizes[index], &job->text_sizes[index]);
+    }
+    free_alignment_result(&result);
+    job->status[index] = error;
+}
+
+/**
+ * @brief Copies per-text aligned entries into one contiguous batch allocation.
+ *
+ * The strings of each text are back to back, as format_aligned_entries()
+ * leaves them, so each text's are copied in one go and re-pointed by offset.
+ *
+ * @return ErrorCode indicating success or failure.
+ */
+static ErrorCode pack_aligned_batch(size_t count, char ***entries, const size_t *sizes, const size_t *text_sizes, const ErrorCode *status, AlignedTextBatch *batch)
+{
+    size_t entry_count = 0;
+    size_t text_bytes = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        text_bytes += sizes[i] ? text_sizes[i] : 0;
+        entry_count += sizes[i];
     }
 
-    error = translator->service->translate(text, source_lang, target_lang, &result->translated_text);
-    if (error != ERROR_SUCCESS)
+    // Pointer-aligned arrays first, then the status codes and the text
+    size_t bytes = entry_count * sizeof(char *) + (count + 1) * sizeof(size_t) + count * sizeof(ErrorCode) + text_bytes;
+    char *buffer = limdy_memory_pool_alloc(bytes ? bytes : 1);
+    if (!buffer)
     {
-        LOG_ERROR(error, "Translation failed");
-        free_translation_result(result);
-        MUTEX_UNLOCK(&translator->mutex);
-        return error;
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate aligned batch");
+        return ERROR_MEMORY_ALLOCATION;
     }
 
-    error = translator->service->get_attention_matrix(text, result->translated_text, &result->attention_matrix, &result->rows, &result->cols);
-    if (error != ERROR_SUCCESS)
+    batch->buffer = buffer;
+    batch->count = count;
+    batch->entry_count = entry_count;
+    batch->entries = (char **)buffer;
+    batch->offsets = (size_t *)(batch->entries + entry_count);
+    batch->status = (ErrorCode *)(batch->offsets + count + 1);
+
+    char *text = (char *)(batch->status + count);
+    size_t next_entry = 0;
+    for (size_t i = 0; i < count; i++)
     {
-        LOG_ERROR(error, "Failed to get attention matrix");
-        free_translation_result(result);
-        MUTEX_UNLOCK(&translator->mutex);
-        return error;
+        batch->offsets[i] = next_entry;
+        batch->status[i] = status[i];
+        if (!sizes[i])
+        {
+            continue;
+        }
+        const char *first = entries[i][0];
+        memcpy(text, first, text_sizes[i]);
+        for (size_t j = 0; j < sizes[i]; j++)
+        {
+            batch->entries[next_entry++] = text + (entries[i][j] - first);
+        }
+        text += text_sizes[i];
     }
+    batch->offsets[count] = next_entry;
 
-    MUTEX_UNLOCK(&translator->mutex);
     return ERROR_SUCCESS;
 }
 
 /**
- * @brief Creates a new Aligner instance.
+ * @brief Translates and aligns a batch of texts.
  *
- * @param service The alignment service to use.
- * @param renderer The renderer to use for tokenization.
- * @return A pointer to the new Aligner, or NULL if creation fails.
+ * @param ta The TranslatorAligner to use.
+ * @param texts The texts to translate and align.
+ * @param count Number of texts.
+ * @param source_lang The source language.
+ * @param target_lang The target language.
+ * @param batch Pointer to store the aligned entries of every text.
+ * @return ErrorCode indicating success or failure.
  */
-Aligner *aligner_create(AlignmentService *service, Renderer *renderer)
+ErrorCode translator_aligner_process_batch(TranslatorAligner *ta, const char **texts, size_t count, const char *source_lang, const char *target_lang, AlignedTextBatch *batch)
 {
-    CHECK_NULL(service, NULL);
-    CHECK_NULL(renderer, NULL);
+    CHECK_NULL(ta, ERROR_NULL_POINTER);
+    CHECK_NULL(texts, ERROR_NULL_POINTER);
+    CHECK_NULL(source_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(target_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(batch, ERROR_NULL_POINTER);
 
-    Aligner *aligner = limdy_memory_pool_alloc(sizeof(Aligner));
-    CHECK_NULL(aligner, NULL);
+    memset(batch, 0, sizeof(AlignedTextBatch));
 
-    aligner->service = service;
-    aligner->renderer = renderer;
+    TranslationResult *results = limdy_memory_pool_alloc((count ? count : 1) * sizeof(TranslationResult));
+    char ***entries = limdy_memory_pool_alloc((count ? count : 1) * sizeof(char **));
+    size_t *sizes = limdy_memory_pool_alloc((count ? count : 1) * 2 * sizeof(size_t));
+    ErrorCode *status = limdy_memory_pool_alloc((count ? count : 1) * sizeof(ErrorCode));
+    if (!results || !entries || !sizes || !status)
+    {
+        limdy_memory_pool_free(results);
+        limdy_memory_pool_free(entries);
+        limdy_memory_pool_free(sizes);
+        limdy_memory_pool_free(status);
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate batch state");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    memset(results, 0, count * sizeof(TranslationResult));
+    memset(entries, 0, count * sizeof(char **));
+    memset(sizes, 0, count * 2 * sizeof(size_t));
+    size_t *text_sizes = sizes + count; // Bytes of each text's strings, past its entry count
+
+    ErrorCode error = ERROR_SUCCESS;
 
-    if (pthread_mutex_init(&aligner->mutex, NULL) != 0)
+    LimdyThreadPool *workers = NULL;
+    error = translator_aligner_workers(ta, &workers);
+    if (error == ERROR_SUCCESS)
     {
-        LOG_ERROR(ERROR_THREAD_INIT, "Failed to initialize aligner mutex");
-        limdy_memory_pool_free(aligner);
-        return NULL;
+        error = translator_translate_batch(ta->translator, texts, count, source_lang, target_lang, results);
+        if (error != ERROR_SUCCESS)
+        {
+            LOG_ERROR(error, "Translation failed in translator_aligner_process_batch");
+        }
     }
 
-    aligner->pool = NULL;
-    ErrorCode error = limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &aligner->pool);
-    if (error != ERROR_SUCCESS)
+    if (error == ERROR_SUCCESS)
     {
-        pthread_mutex_destroy(&aligner->mutex);
-        limdy_memory_pool_free(aligner);
-        LOG_ERROR(error, "Failed to create memory pool for aligner");
-        return NULL;
+        // Texts are independent; each worker aligns in its own scratch arena
+        BatchAlignJob job = {ta->aligner, texts, results, entries, sizes, text_sizes, status};
+        error = limdy_thread_pool_parallel_for(workers, count, batch_align_item, &job);
+
+        if (error == ERROR_SUCCESS)
+        {
+            error = pack_aligned_batch(count, entries, sizes, text_sizes, status, batch);
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            free_aligned_text(entries[i], sizes[i]);
+            free_translation_result(&results[i]);
+        }
     }
 
-    return aligner;
+    limdy_memory_pool_free(results);
+    limdy_memory_pool_free(entries);
+    limdy_memory_pool_free(sizes);
+    limdy_memory_pool_free(status);
+    return error;
 }
 
 /**
- * @brief Destroys an Aligner instance and frees its resources.
+ * @brief Frees the storage of an aligned batch.
  *
- * @param aligner The Aligner to destroy.
+ * @param batch The batch to free.
  */
-void aligner_destroy(Aligner *aligner)
+void free_aligned_text_batch(AlignedTextBatch *batch)
 {
-    if (aligner)
+    if (batch)
     {
-        pthread_mutex_destroy(&aligner->mutex);
-        if (aligner->pool)
-        {
-            limdy_memory_pool_destroy(aligner->pool);
-        }
-        limdy_memory_pool_free(aligner);
+        limdy_memory_pool_free(batch->buffer);
+        memset(batch, 0, sizeof(AlignedTextBatch));
     }
 }
 
 /**
- * @brief Performs an alignment operation.
- *
- * This function aligns the source text with the target (translated) text using
- * the provided attention matrix.
+ * @brief State of one asynchronous translate-and-align request.
  *
- * @param aligner The Aligner to use.
- * @param source_text The source text.
- * @param target_text The target (translated) text.
- * @param attention_matrix The attention matrix.
- * @param rows Number of rows in the attention matrix.
- * @param cols Number of columns in the attention matrix.
- * @param aligned_text Pointer to store the aligned text.
- * @param aligned_size Pointer to store the size of the aligned text.
- * @return ErrorCode indicating success or failure.
+ * Source tokenization and translation run concurrently; whichever finishes
+ * last schedules alignment. One reference belongs to the caller's handle
+ * and one to the pipeline.
  */
-ErrorCode aligner_align(Aligner *aligner, const char *source_text, const char *target_text, float **attention_matrix, size_t rows, size_t cols, char ***aligned_text, size_t *aligned_size)
+struct TranslationRequest
 {
-    CHECK_NULL(aligner, ERROR_NULL_POINTER);
-    CHECK_NULL(source_text, ERROR_NULL_POINTER);
-    CHECK_NULL(target_text, ERROR_NULL_POINTER);
-    CHECK_NULL(attention_matrix, ERROR_NULL_POINTER);
-    CHECK_NULL(aligned_text, ERROR_NULL_POINTER);
-    CHECK_NULL(aligned_size, ERROR_NULL_POINTER);
+    TranslatorAligner *ta;
+    LimdyThreadPool *workers;
+    LimdyArena arena;           // Copies of the inputs and the source tokens
+    const char *text;
+    const char *source_lang;
+    const char *target_lang;
+    RendererResult source;
+    const RendererResult *shared_source; // Cached source tokens used instead of source, or NULL
+    TranslationResult translation;
+    char **aligned_text;
+    size_t aligned_size;
+    TranslationCallback callback;
+    void *user_data;
+    atomic_int pending;         // Stages left before alignment can start
+    atomic_int refs;
+    ErrorCode error;            // First failure of any stage
+    bool done;
+    pthread_mutex_t mutex;
+    pthread_cond_t finished;
+};
 
-    MUTEX_LOCK(&aligner->mutex);
+static void translation_request_unref(TranslationRequest *request)
+{
+    if (atomic_fetch_sub_explicit(&request->refs, 1, memory_order_acq_rel) == 1)
+    {
+        free_aligned_text(request->aligned_text, request->aligned_size);
+        free_translation_result(&request->translation);
+        renderer_release_shared(request->ta->aligner->renderer, request->shared_source);
+        limdy_arena_release(&request->arena);
+        pthread_cond_destroy(&request->finished);
+        pthread_mutex_destroy(&request->mutex);
+        limdy_memory_pool_free(request);
+    }
+}
 
-    RendererResult source_result = {0};
-    RendererResult target_result = {0};
-    int *alignment = NULL;
-    size_t alignment_size = 0;
-    ErrorCode error = ERROR_SUCCESS;
+static void translation_request_finish(TranslationRequest *request)
+{
+    // The translation is only needed for alignment; let its pool be recycled early
+    free_translation_result(&request->translation);
 
-    // Tokenize source and target text
-    error = renderer_tokenize(aligner->renderer, source_text, LANG_ENGLISH, &source_result); // Assume English for now
-    if (error != ERROR_SUCCESS)
+    if (request->callback)
     {
-        LOG_ERROR(error, "Failed to tokenize source text");
-        goto cleanup;
+        request->callback(request, request->error, request->aligned_text, request->aligned_size, request->user_data);
     }
 
-    error = renderer_tokenize(aligner->renderer, target_text, LANG_ENGLISH, &target_result); // Assume English for now
-    if (error != ERROR_SUCCESS)
+    pthread_mutex_lock(&request->mutex);
+    request->done = true;
+    pthread_cond_broadcast(&request->finished);
+    pthread_mutex_unlock(&request->mutex);
+
+    translation_request_unref(request);
+}
+
+static void translation_request_align(void *arg)
+{
+    TranslationRequest *request = arg;
+    const LimdyMatrix *attention = &request->translation.attention;
+
+    const RendererResult *source = request->shared_source ? request->shared_source : &request->source;
+
+    request->error = aligner_align_impl(request->ta->aligner, source, request->text,
+                                        request->translation.translated_text, NULL, attention,
+                                        attention->rows, attention->cols,
+                                        &request->aligned_text, &request->aligned_size);
+    if (request->error != ERROR_SUCCESS)
     {
-        LOG_ERROR(error, "Failed to tokenize target text");
-        goto cleanup;
+        LOG_ERROR(request->error, "Alignment failed for asynchronous request");
     }
 
-    // Align tokens
-    error = aligner->service->align_tokens((const char **)source_result.tokens, source_result.token_count,
-                                           (const char **)target_result.tokens, target_result.token_count,
-                                           attention_matrix, rows, cols,
-                                           &alignment, &alignment_size);
+    translation_request_finish(request);
+}
+
+/**
+ * @brief Records the outcome of a stage and schedules alignment after the last one.
+ */
+static void translation_request_stage_done(TranslationRequest *request, ErrorCode error)
+{
     if (error != ERROR_SUCCESS)
     {
-        LOG_ERROR(error, "Token alignment failed");
-        goto cleanup;
+        pthread_mutex_lock(&request->mutex);
+        if (request->error == ERROR_SUCCESS)
+        {
+            request->error = error;
+        }
+        pthread_mutex_unlock(&request->mutex);
     }
 
-    // Create aligned text
-    *aligned_text = limdy_memory_pool_alloc_from(aligner->pool, alignment_size * sizeof(char *));
-    if (!*aligned_text)
+    if (atomic_fetch_sub_explicit(&request->pending, 1, memory_order_acq_rel) != 1)
     {
-        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate memory for aligned text");
-        error = ERROR_MEMORY_ALLOCATION;
-        goto cleanup;
+        return;
     }
 
-    for (size_t i = 0; i < alignment_size; i++)
+    if (request->error != ERROR_SUCCESS)
     {
-        size_t len = source_result.tokens[i].length + target_result.tokens[alignment[i]].length + 4; // 4 for "[", "]", " ", and null terminator
-        (*aligned_text)[i] = limdy_memory_pool_alloc_from(aligner->pool, len * sizeof(char));
-        if (!(*aligned_text)[i])
-        {
-            LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate memory for aligned text entry");
-            error = ERROR_MEMORY_ALLOCATION;
-            goto cleanup;
-        }
-        snprintf((*aligned_text)[i], len, "[%.*s] [%.*s]",
-                 (int)source_result.tokens[i].length, source_result.tokens[i].text,
-                 (int)target_result.tokens[alignment[i]].length, target_result.tokens[alignment[i]].text);
+        translation_request_finish(request);
+    }
+    else if (limdy_thread_pool_submit(request->workers, translation_request_align, request) != ERROR_SUCCESS)
+    {
+        // The workers are shutting down; finish on this thread
+        translation_request_align(request);
     }
+}
 
-    *aligned_size = alignment_size;
+static void translation_request_tokenize_source(void *arg)
+{
+    TranslationRequest *request = arg;
 
-cleanup:
-    renderer_free_result(aligner->renderer, &source_result);
-    renderer_free_result(aligner->renderer, &target_result);
-    limdy_memory_pool_free_to(aligner->pool, alignment);
+    const RendererResult *tokens = NULL;
+    ErrorCode error = aligner_tokenize(request->ta->aligner, request->text, &request->source, &request->shared_source, &tokens);
+    if (error != ERROR_SUCCESS)
+    {
+        LOG_ERROR(error, "Failed to tokenize source text of asynchronous request");
+    }
+    translation_request_stage_done(request, error);
+}
+
+static void translation_request_translated(void *context, ErrorCode error, const char *translated_text, LimdyMatrix *attention)
+{
+    TranslationRequest *request = context;
 
-    if (error != ERROR_SUCCESS && *aligned_text)
+    if (error == ERROR_SUCCESS)
     {
-        for (size_t i = 0; i < alignment_size; i++)
-        {
-            limdy_memory_pool_free_to(aligner->pool, (*aligned_text)[i]);
-        }
-        limdy_memory_pool_free_to(aligner->pool, *aligned_text);
-        *aligned_text = NULL;
-        *aligned_size = 0;
+        error = translator_store_result(request->ta->translator, &request->translation, translated_text,
+                                        NULL, attention, attention->rows, attention->cols);
+    }
+    if (error == ERROR_SUCCESS)
+    {
+        translator_remember(request->ta->translator, request->text, request->source_lang, request->target_lang,
+                            &request->translation);
+    }
+    else
+    {
+        LOG_ERROR(error, "Asynchronous translation failed");
     }
+    translation_request_stage_done(request, error);
+}
 
-    MUTEX_UNLOCK(&aligner->mutex);
-    return error;
+static void translation_request_translate_sync(void *arg)
+{
+    TranslationRequest *request = arg;
+
+    // The translation memory was already consulted when the request was submitted
+    ErrorCode error = translator_translate_uncached(request->ta->translator, request->text, request->source_lang,
+                                                    request->target_lang, NULL, NULL, &request->translation);
+    translation_request_stage_done(request, error);
 }
 
 /**
- * @brief Creates a new TranslatorAligner instance.
+ * @brief Starts an asynchronous translate-and-align request.
  *
- * @param trans_service The translation service to use.
- * @param align_service The alignment service to use.
- * @param renderer The renderer to use for tokenization.
- * @return A pointer to the new TranslatorAligner, or NULL if creation fails.
+ * @param ta The TranslatorAligner to use.
+ * @param text The text to translate and align.
+ * @param source_lang The source language.
+ * @param target_lang The target language.
+ * @param callback Function called on completion, or NULL.
+ * @param user_data Argument passed to the callback.
+ * @param request Pointer to store the request handle.
+ * @return ErrorCode indicating success or failure.
  */
-TranslatorAligner *translator_aligner_create(TranslationService *trans_service, AlignmentService *align_service, Renderer *renderer)
+ErrorCode translator_aligner_submit(TranslatorAligner *ta, const char *text, const char *source_lang, const char *target_lang,
+                                    TranslationCallback callback, void *user_data, TranslationRequest **request)
 {
-    CHECK_NULL(trans_service, NULL);
-    CHECK_NULL(align_service, NULL);
-    CHECK_NULL(renderer, NULL);
-    TranslatorAligner *ta = limdy_memory_pool_alloc(sizeof(TranslatorAligner));
-    CHECK_NULL(ta, NULL);
+    CHECK_NULL(ta, ERROR_NULL_POINTER);
+    CHECK_NULL(text, ERROR_NULL_POINTER);
+    CHECK_NULL(source_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(target_lang, ERROR_NULL_POINTER);
+    CHECK_NULL(request, ERROR_NULL_POINTER);
 
-    ta->translator = translator_create(trans_service);
-    if (!ta->translator)
+    LimdyThreadPool *workers = NULL;
+    RETURN_IF_ERROR(translator_aligner_workers(ta, &workers));
+
+    TranslationRequest *req = limdy_memory_pool_alloc(sizeof(TranslationRequest));
+    CHECK_NULL(req, ERROR_MEMORY_ALLOCATION);
+    memset(req, 0, sizeof(TranslationRequest));
+
+    ErrorCode error = limdy_arena_init(&req->arena, LIMDY_TRANSLATION_REQUEST_ARENA_CHUNK_SIZE);
+    if (error != ERROR_SUCCESS)
     {
-        LOG_ERROR(ERROR_UNKNOWN, "Failed to create Translator");
-        limdy_memory_pool_free(ta);
-        return NULL;
+        limdy_memory_pool_free(req);
+        return error;
+    }
+    if (pthread_mutex_init(&req->mutex, NULL) != 0 || pthread_cond_init(&req->finished, NULL) != 0)
+    {
+        limdy_arena_release(&req->arena);
+        limdy_memory_pool_free(req);
+        LOG_ERROR(ERROR_THREAD_INIT, "Failed to initialize request synchronization");
+        return ERROR_THREAD_INIT;
     }
 
-    ta->aligner = aligner_create(align_service, renderer);
-    if (!ta->aligner)
+    req->ta = ta;
+    req->workers = workers;
+    req->text = limdy_arena_strndup(&req->arena, text, strlen(text));
+    req->source_lang = limdy_arena_strndup(&req->arena, source_lang, strlen(source_lang));
+    req->target_lang = limdy_arena_strndup(&req->arena, target_lang, strlen(target_lang));
+    req->source.arena = &req->arena;
+    req->callback = callback;
+    req->user_data = user_data;
+    atomic_init(&req->pending, 2);
+    atomic_init(&req->refs, 2);
+    req->error = ERROR_SUCCESS;
+    if (!req->text || !req->source_lang || !req->target_lang)
     {
-        LOG_ERROR(ERROR_UNKNOWN, "Failed to create Aligner");
-        translator_destroy(ta->translator);
-        limdy_memory_pool_free(ta);
-        return NULL;
+        pthread_cond_destroy(&req->finished);
+        pthread_mutex_destroy(&req->mutex);
+        limdy_arena_release(&req->arena);
+        limdy_memory_pool_free(req);
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to copy request input");
+        return ERROR_MEMORY_ALLOCATION;
     }
 
-    if (pthread_mutex_init(&ta->mutex, NULL) != 0)
+    // Hand out the handle first: the request may complete before the stages below return
+    *request = req;
+
+    // Tokenize the source on a worker while the translation is in flight
+    if (limdy_thread_pool_submit(workers, translation_request_tokenize_source, req) != ERROR_SUCCESS)
     {
-        LOG_ERROR(ERROR_THREAD_INIT, "Failed to initialize translator_aligner mutex");
-        translator_destroy(ta->translator);
-        aligner_destroy(ta->aligner);
-        limdy_memory_pool_free(ta);
-        return NULL;
+        translation_request_tokenize_source(req);
     }
 
-    ErrorCode error = limdy_memory_pool_create(LIMDY_LARGE_POOL_SIZE, &ta->pool); // TODO Implement flexible pool size
-    if (error != ERROR_SUCCESS)
+    // A remembered translation completes its stage right away
+    TranslationService *service = ta->translator->service;
+    error = translator_recall(ta->translator, req->text, req->source_lang, req->target_lang, &req->translation);
+    if (error != LIMDY_TRANSLATION_MEMORY_ERROR_MISS)
     {
-        pthread_mutex_destroy(&ta->mutex);
-        translator_destroy(ta->translator);
-        aligner_destroy(ta->aligner);
-        limdy_memory_pool_free(ta);
-        LOG_ERROR(error, "Failed to create memory pool for translator_aligner");
-        return NULL;
+        translation_request_stage_done(req, error);
+    }
+    else if (service->translate_async)
+    {
+        error = service->translate_async(req->text, req->source_lang, req->target_lang, translation_request_translated, req);
+        if (error != ERROR_SUCCESS)
+        {
+            // Rejected up front, so the service never calls back
+            LOG_ERROR(error, "Failed to start asynchronous translation");
+            translation_request_stage_done(req, error);
+        }
+    }
+    else if (limdy_thread_pool_submit(workers, translation_request_translate_sync, req) != ERROR_SUCCESS)
+    {
+        translation_request_translate_sync(req);
     }
 
-    return ta;
+    return ERROR_SUCCESS;
 }
 
 /**
- * @brief Destroys a TranslatorAligner instance and frees its resources.
+ * @brief Checks whether a request has completed.
  *
- * @param ta The TranslatorAligner to destroy.
+ * @param request The request to check.
+ * @return true once the request has completed, false otherwise.
  */
-void translator_aligner_destroy(TranslatorAligner *ta)
+bool translation_request_is_done(TranslationRequest *request)
 {
-    if (ta)
+    if (!request)
     {
-        translator_destroy(ta->translator);
-        aligner_destroy(ta->aligner);
-        pthread_mutex_destroy(&ta->mutex);
-        limdy_memory_pool_destroy(ta->pool);
-        limdy_memory_pool_free(ta);
+        return false;
     }
+
+    pthread_mutex_lock(&request->mutex);
+    bool done = request->done;
+    pthread_mutex_unlock(&request->mutex);
+    return done;
 }
 
 /**
- * @brief Performs a combined translation and alignment operation.
- *
- * This function translates the given text and then aligns it with the original text.
+ * @brief Waits for a request to complete.
  *
- * @param ta The TranslatorAligner to use.
- * @param text The text to translate and align.
- * @param source_lang The source language.
- * @param target_lang The target language.
- * @param aligned_text Pointer to store the aligned text.
- * @param aligned_size Pointer to store the size of the aligned text.
- * @return ErrorCode indicating success or failure.
+ * @param request The request to wait for.
+ * @param aligned_text Pointer to store the aligned text, owned by the request; may be NULL.
+ * @param aligned_size Pointer to store the size of the aligned text; may be NULL.
+ * @return The request's ErrorCode.
  */
-ErrorCode translator_aligner_process(TranslatorAligner *ta, const char *text, const char *source_lang, const char *target_lang, char ***aligned_text, size_t *aligned_size)
+ErrorCode translation_request_wait(TranslationRequest *request, char ***aligned_text, size_t *aligned_size)
 {
-    CHECK_NULL(ta, ERROR_NULL_POINTER);
-    CHECK_NULL(text, ERROR_NULL_POINTER);
-    CHECK_NULL(source_lang, ERROR_NULL_POINTER);
-    CHECK_NULL(target_lang, ERROR_NULL_POINTER);
-    CHECK_NULL(aligned_text, ERROR_NULL_POINTER);
-    CHECK_NULL(aligned_size, ERROR_NULL_POINTER);
-    MUTEX_LOCK(&ta->mutex);
+    CHECK_NULL(request, ERROR_NULL_POINTER);
 
-    TranslationResult result = {0};
-    ErrorCode error = translator_translate(ta->translator, text, source_lang, target_lang, &result);
-    if (error != ERROR_SUCCESS)
+    MUTEX_LOCK(&request->mutex);
+    while (!request->done)
     {
-        LOG_ERROR(error, "Translation failed in translator_aligner_process");
-        MUTEX_UNLOCK(&ta->mutex);
-        return error;
+        pthread_cond_wait(&request->finished, &request->mutex);
     }
+    MUTEX_UNLOCK(&request->mutex);
 
-    error = aligner_align(ta->aligner, text, result.translated_text, result.attention_matrix, result.rows, result.cols, aligned_text, aligned_size);
-    if (error != ERROR_SUCCESS)
+    if (aligned_text)
     {
-        LOG_ERROR(error, "Alignment failed in translator_aligner_process");
+        *aligned_text = request->aligned_text;
     }
+    if (aligned_size)
+    {
+        *aligned_size = request->aligned_size;
+    }
+    return request->error;
+}
 
-    free_translation_result(&result);
-
-    MUTEX_UNLOCK(&ta->mutex);
-    return error;
+/**
+ * @brief Releases the caller's handle to a request.
+ *
+ * @param request The request to release.
+ */
+void translation_request_release(TranslationRequest *request)
+{
+    if (request)
+    {
+        translation_request_unref(request);
+    }
 }
 
 ErrorCode allocate_translation_result(TranslationResult *result, size_t pool_size)
@@ -418,6 +2065,26 @@ ErrorCode allocate_translation_result(TranslationResult *result, size_t pool_siz
     return ERROR_SUCCESS;
 }
 
+/**
+ * @brief Initializes a translation result backed by a caller-owned arena.
+ *
+ * @param result Pointer to the TranslationResult structure to initialize.
+ * @param arena The arena to allocate from.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode allocate_translation_result_from_arena(TranslationResult *result, LimdyArena *arena)
+{
+    if (!result || !arena)
+    {
+        return ERROR_NULL_POINTER;
+    }
+
+    memset(result, 0, sizeof(TranslationResult));
+    result->arena = arena;
+
+    return ERROR_SUCCESS;
+}
+
 /**
  * @brief Frees the resources of a translation result.
  *
@@ -427,9 +2094,19 @@ void free_translation_result(TranslationResult *result)
 {
     if (result)
     {
-        if (result->pool)
+        limdy_matrix_free(&result->attention);
+
+        // Arena-backed results are released by resetting the arena
+        if (result->pool && !result->arena)
         {
-            limdy_memory_pool_destroy(result->pool);
+            if (result->recycler)
+            {
+                recycler_release(result->recycler, result->pool);
+            }
+            else
+            {
+                limdy_memory_pool_destroy(result->pool);
+            }
         }
         memset(result, 0, sizeof(TranslationResult));
     }
@@ -443,12 +2120,7 @@ void free_translation_result(TranslationResult *result)
  */
 void free_aligned_text(char **aligned_text, size_t size)
 {
-    if (aligned_text)
-    {
-        for (size_t i = 0; i < size; i++)
-        {
-            limdy_memory_pool_free(aligned_text[i]);
-        }
-        limdy_memory_pool_free(aligned_text);
-    }
+    // The entries live in the same allocation as the array
+    (void)size;
+    limdy_memory_pool_free(aligned_text);
 }
\ No newline at end of file
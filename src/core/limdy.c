@@ -0,0 +1,1076 @@
+/**
+ * @file limdy.c
+ * @brief Implementation of warm-start snapshots.
+ *
+ * This file implements the interface defined in limdy.h. The writer copies
+ * entries into growable record buffers and one blob as they are added, so
+ * the caches it reads from are locked only while they are walked, and maps
+ * go straight into a BankerWriter each. The indexes are laid out only when
+ * the snapshot is written. The reader maps the image read-only, checks the
+ * header and section bounds once, and serves every miss by probing an
+ * index and copying the one record it finds; a record that fails its
+ * bounds checks is treated as missing. The image and the map banks are
+ * written and mapped through limdy_image.h.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-15
+ */
+
+#include "core/limdy.h"
+#include "components/banker.h"
+#include "utils/limdy_utils.h"
+#include "utils/memory_pool.h"
+#include "utils/limdy_metrics.h"
+#include "utils/limdy_image.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+
+#define SNAPSHOT_MAGIC "LIMDYSN1"
+#define SNAPSHOT_SOURCE_TEXT UINT64_MAX // Render source that is the text itself
+#define SNAPSHOT_MAP_NAME_FORMAT "map-%zu.bank"
+
+/**
+ * @brief Fixed header at the start of a snapshot image.
+ */
+typedef struct
+{
+    LimdyImageHeader image;
+    uint64_t translation_count;
+    uint64_t translation_offset;
+    uint64_t render_count;
+    uint64_t render_offset;
+    uint64_t token_count;
+    uint64_t token_offset;
+    uint64_t map_count;
+    uint64_t map_offset;
+    uint64_t blob_bytes;
+    uint64_t blob_offset;
+    uint64_t translation_index_capacity; // Power of two, more than twice the translation count
+    uint64_t translation_index_offset;
+    uint64_t render_index_capacity; // Power of two, more than twice the render count
+    uint64_t render_index_offset;
+} SnapshotHeader;
+
+// Records start with their hash, which the indexes are built from
+typedef struct
+{
+    uint64_t hash;
+    uint64_t expires_at;
+    uint64_t strings; // Blob offset of text, source, target and translation, each NUL terminated
+    uint64_t attention; // Blob offset of rows x cols floats, 4-byte aligned
+    uint32_t text_length;
+    uint32_t source_length;
+    uint32_t target_length;
+    uint32_t translated_length;
+    uint32_t rows;
+    uint32_t cols;
+} SnapshotTranslationRecord;
+
+typedef struct
+{
+    uint64_t hash;
+    uint64_t text;   // Blob offset of the NUL terminated text
+    uint64_t source; // Blob offset of the interned token text, or SNAPSHOT_SOURCE_TEXT
+    uint64_t first_token;
+    uint32_t text_length;
+    uint32_t source_bytes;
+    uint32_t token_count;
+    uint32_t lang;
+} SnapshotRenderRecord;
+
+typedef struct
+{
+    uint32_t offset; // Into the render's source
+    uint32_t length;
+    TokenClassSet classes;
+} SnapshotTokenRecord;
+
+typedef struct
+{
+    uint64_t name; // Blob offset of the NUL terminated name
+    uint64_t name_length;
+} SnapshotMapRecord;
+
+struct LimdySnapshotWriter
+{
+    SnapshotTranslationRecord *translations;
+    size_t translation_count;
+    size_t translation_capacity;
+    SnapshotRenderRecord *renders;
+    size_t render_count;
+    size_t render_capacity;
+    SnapshotTokenRecord *tokens;
+    size_t token_count;
+    size_t token_capacity;
+    SnapshotMapRecord *maps;
+    BankerWriter **banks; // One per map, in the same order
+    size_t map_count;
+    size_t map_capacity;
+    size_t bank_capacity;
+    char *blob;
+    size_t blob_bytes;
+    size_t blob_capacity;
+};
+
+struct LimdySnapshot
+{
+    char *directory;
+    LimdyImage image;
+    const SnapshotHeader *header;
+    const SnapshotTranslationRecord *translations;
+    const SnapshotRenderRecord *renders;
+    const SnapshotTokenRecord *tokens;
+    const SnapshotMapRecord *maps;
+    const char *blob;
+    const LimdyImageIndexEntry *translation_index;
+    const LimdyImageIndexEntry *render_index;
+    atomic_size_t translations_paged_in;
+    atomic_size_t renders_paged_in;
+    atomic_size_t maps_loaded;
+};
+
+/**
+ * @brief Translation memory store reading from a snapshot.
+ */
+typedef struct
+{
+    TranslationMemoryStore base;
+    LimdySnapshot *snapshot;
+} SnapshotStore;
+
+static bool snapshot_header_valid(const void *image_header);
+
+static const LimdyImageFormat snapshot_format = {
+    .name = "snapshot image",
+    .magic = SNAPSHOT_MAGIC,
+    .version = LIMDY_SNAPSHOT_FORMAT_VERSION,
+    .header_size = sizeof(SnapshotHeader),
+    .error_bad_format = LIMDY_SNAPSHOT_ERROR_BAD_FORMAT,
+    .error_version = LIMDY_SNAPSHOT_ERROR_VERSION,
+    .header_valid = snapshot_header_valid};
+
+static uint64_t hash_bytes(uint64_t hash, const char *bytes, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// FNV leaves short keys clustered; finalize so the index bits are well mixed
+static uint64_t hash_finalize(uint64_t hash)
+{
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+// Hashes the strings with their terminators, so ("ab", "c") and ("a", "bc") differ
+static uint64_t translation_hash(const char *text, size_t text_length, const char *source_lang, size_t source_length,
+                                 const char *target_lang, size_t target_length)
+{
+    uint64_t hash = hash_bytes(14695981039346656037ULL, text, text_length + 1);
+    hash = hash_bytes(hash, source_lang, source_length + 1);
+    return hash_finalize(hash_bytes(hash, target_lang, target_length + 1));
+}
+
+static uint64_t render_hash(const char *text, size_t length, Language lang)
+{
+    uint32_t lang_value = (uint32_t)lang;
+    uint64_t hash = hash_bytes(14695981039346656037ULL, text, length);
+    return hash_finalize(hash_bytes(hash, (const char *)&lang_value, sizeof(lang_value)));
+}
+
+static uint64_t monotonic_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+// Appends bytes to the blob at the given alignment and gives their offset
+static ErrorCode blob_append(LimdySnapshotWriter *writer, const void *data, size_t length, size_t alignment, uint64_t *offset)
+{
+    size_t start = (writer->blob_bytes + alignment - 1) & ~(alignment - 1);
+    RETURN_IF_ERROR(limdy_memory_pool_reserve((void **)&writer->blob, &writer->blob_capacity, start + length, 1));
+    memset(writer->blob + writer->blob_bytes, 0, start - writer->blob_bytes);
+    if (length > 0)
+    {
+        memcpy(writer->blob + start, data, length);
+    }
+    writer->blob_bytes = start + length;
+    *offset = start;
+    return ERROR_SUCCESS;
+}
+
+// Appends a string and its terminator
+static ErrorCode blob_append_string(LimdySnapshotWriter *writer, const char *text, size_t length, uint64_t *offset)
+{
+    RETURN_IF_ERROR(blob_append(writer, text, length, 1, offset));
+    uint64_t terminator;
+    return blob_append(writer, "", 1, 1, &terminator);
+}
+
+/**
+ * @brief Create an empty snapshot writer.
+ *
+ * @param writer Pointer to store the created writer.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_writer_create(LimdySnapshotWriter **writer)
+{
+    CHECK_NULL(writer, ERROR_NULL_POINTER);
+
+    LimdySnapshotWriter *new_writer = limdy_memory_pool_alloc(sizeof(LimdySnapshotWriter));
+    CHECK_NULL(new_writer, ERROR_MEMORY_ALLOCATION);
+    memset(new_writer, 0, sizeof(LimdySnapshotWriter));
+
+    *writer = new_writer;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Copies one translation memory entry. Called with the entry's shard locked.
+ */
+static ErrorCode writer_add_translation(void *context, const TranslationMemoryRecord *record)
+{
+    LimdySnapshotWriter *writer = context;
+
+    size_t text_length = strlen(record->text);
+    size_t source_length = strlen(record->source_lang);
+    size_t target_length = strlen(record->target_lang);
+    size_t translated_length = strlen(record->translated_text);
+    if (text_length >= UINT32_MAX || source_length >= UINT32_MAX || target_length >= UINT32_MAX ||
+        translated_length >= UINT32_MAX || record->rows > UINT32_MAX || record->cols > UINT32_MAX)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Translation memory entry does not fit in a snapshot");
+        return ERROR_INVALID_ARGUMENT;
+    }
+    RETURN_IF_ERROR(limdy_memory_pool_reserve((void **)&writer->translations, &writer->translation_capacity, writer->translation_count + 1,
+                                  sizeof(SnapshotTranslationRecord)));
+
+    // Bytes appended by a failed addition stay in the blob, which only costs their size
+    SnapshotTranslationRecord *stored = &writer->translations[writer->translation_count];
+    uint64_t offset;
+    RETURN_IF_ERROR(blob_append_string(writer, record->text, text_length, &stored->strings));
+    RETURN_IF_ERROR(blob_append_string(writer, record->source_lang, source_length, &offset));
+    RETURN_IF_ERROR(blob_append_string(writer, record->target_lang, target_length, &offset));
+    RETURN_IF_ERROR(blob_append_string(writer, record->translated_text, translated_length, &offset));
+    stored->attention = 0;
+    if (record->rows && record->cols)
+    {
+        RETURN_IF_ERROR(blob_append(writer, record->attention, record->rows * record->cols * sizeof(float), sizeof(float),
+                                    &stored->attention));
+    }
+
+    stored->hash = translation_hash(record->text, text_length, record->source_lang, source_length, record->target_lang,
+                                    target_length);
+    stored->expires_at = record->expires_at;
+    stored->text_length = (uint32_t)text_length;
+    stored->source_length = (uint32_t)source_length;
+    stored->target_length = (uint32_t)target_length;
+    stored->translated_length = (uint32_t)translated_length;
+    stored->rows = record->rows && record->cols ? (uint32_t)record->rows : 0;
+    stored->cols = record->rows && record->cols ? (uint32_t)record->cols : 0;
+    writer->translation_count++;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Add a copy of every unexpired entry of a translation memory.
+ *
+ * @param writer The writer.
+ * @param memory The memory to copy.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_writer_add_translations(LimdySnapshotWriter *writer, TranslationMemory *memory)
+{
+    CHECK_NULL(writer, ERROR_NULL_POINTER);
+    CHECK_NULL(memory, ERROR_NULL_POINTER);
+
+    return translation_memory_for_each(memory, writer_add_translation, writer);
+}
+
+/**
+ * @brief Copies one tokenization cache entry. Called with the entry's shard locked.
+ */
+static ErrorCode writer_add_render(void *context, const char *text, Language lang, const RendererResult *result)
+{
+    LimdySnapshotWriter *writer = context;
+
+    size_t text_length = strlen(text);
+    if (text_length >= UINT32_MAX || result->token_count >= UINT32_MAX)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Tokenization cache entry does not fit in a snapshot");
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    // Tokens are saved as spans of their source, which is the text or, for copying tokenizers, one interned block
+    bool in_text = result->token_count == 0 || result->source == text;
+    size_t source_bytes = in_text ? text_length : 0;
+    for (size_t i = 0; i < result->token_count; i++)
+    {
+        const Token *token = &result->tokens[i];
+        if (!result->source || token->text != result->source + token->offset ||
+            (in_text && (uint64_t)token->offset + token->length > text_length))
+        {
+            LOG_DEBUG(ERROR_INVALID_ARGUMENT, "Skipping tokenization cache entry whose tokens are not spans of one source");
+            return ERROR_SUCCESS;
+        }
+        if (!in_text && (uint64_t)token->offset + token->length + 1 > source_bytes)
+        {
+            // Interned texts are NUL terminated, so the block runs one byte past the last token
+            source_bytes = (size_t)token->offset + token->length + 1;
+        }
+    }
+    if (source_bytes >= UINT32_MAX)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Tokenization cache entry does not fit in a snapshot");
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    RETURN_IF_ERROR(limdy_memory_pool_reserve((void **)&writer->renders, &writer->render_capacity, writer->render_count + 1,
+                                  sizeof(SnapshotRenderRecord)));
+    RETURN_IF_ERROR(limdy_memory_pool_reserve((void **)&writer->tokens, &writer->token_capacity, writer->token_count + result->token_count,
+                                  sizeof(SnapshotTokenRecord)));
+
+    SnapshotRenderRecord *stored = &writer->renders[writer->render_count];
+    RETURN_IF_ERROR(blob_append_string(writer, text, text_length, &stored->text));
+    stored->source = SNAPSHOT_SOURCE_TEXT;
+    if (!in_text)
+    {
+        RETURN_IF_ERROR(blob_append(writer, result->source, source_bytes, 1, &stored->source));
+    }
+
+    for (size_t i = 0; i < result->token_count; i++)
+    {
+        const Token *token = &result->tokens[i];
+        writer->tokens[writer->token_count + i] = (SnapshotTokenRecord){token->offset, token->length, token->classes};
+    }
+    stored->hash = render_hash(text, text_length, lang);
+    stored->first_token = writer->token_count;
+    stored->text_length = (uint32_t)text_length;
+    stored->source_bytes = (uint32_t)source_bytes;
+    stored->token_count = (uint32_t)result->token_count;
+    stored->lang = (uint32_t)lang;
+    writer->token_count += result->token_count;
+    writer->render_count++;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Add a copy of every entry of a tokenization cache.
+ *
+ * @param writer The writer.
+ * @param cache The cache to copy.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_writer_add_renders(LimdySnapshotWriter *writer, RenderCache *cache)
+{
+    CHECK_NULL(writer, ERROR_NULL_POINTER);
+    CHECK_NULL(cache, ERROR_NULL_POINTER);
+
+    return render_cache_for_each(cache, writer_add_render, writer);
+}
+
+/**
+ * @brief Add a copy of the elements of a map under a name.
+ *
+ * @param writer The writer.
+ * @param name Name to load the map by.
+ * @param map The map to copy.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_writer_add_map(LimdySnapshotWriter *writer, const char *name, LinguisticElementMap *map)
+{
+    CHECK_NULL(writer, ERROR_NULL_POINTER);
+    CHECK_NULL(name, ERROR_NULL_POINTER);
+    CHECK_NULL(map, ERROR_NULL_POINTER);
+
+    size_t name_length = strlen(name);
+    for (size_t i = 0; i < writer->map_count; i++)
+    {
+        if (writer->maps[i].name_length == name_length && memcmp(writer->blob + writer->maps[i].name, name, name_length) == 0)
+        {
+            LOG_ERROR(ERROR_INVALID_ARGUMENT, "Snapshot already holds a map named %s", name);
+            return ERROR_INVALID_ARGUMENT;
+        }
+    }
+    RETURN_IF_ERROR(limdy_memory_pool_reserve((void **)&writer->maps, &writer->map_capacity, writer->map_count + 1, sizeof(SnapshotMapRecord)));
+    RETURN_IF_ERROR(limdy_memory_pool_reserve((void **)&writer->banks, &writer->bank_capacity, writer->map_count + 1, sizeof(BankerWriter *)));
+
+    BankerWriter *bank = NULL;
+    RETURN_IF_ERROR(banker_writer_create(&bank));
+    uint64_t offset = 0;
+    ErrorCode error = banker_writer_add_map(bank, map);
+    if (error == ERROR_SUCCESS)
+    {
+        error = blob_append_string(writer, name, name_length, &offset);
+    }
+    if (error != ERROR_SUCCESS)
+    {
+        banker_writer_destroy(bank);
+        return error;
+    }
+
+    writer->maps[writer->map_count] = (SnapshotMapRecord){offset, name_length};
+    writer->banks[writer->map_count] = bank;
+    writer->map_count++;
+    return ERROR_SUCCESS;
+}
+
+// Joins a directory and a file name into a new string
+static char *snapshot_path(const char *directory, const char *name)
+{
+    size_t length = strlen(directory) + strlen(name) + 2;
+    char *path = limdy_memory_pool_alloc(length);
+    if (!path)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate snapshot path");
+        return NULL;
+    }
+    snprintf(path, length, "%s/%s", directory, name);
+    return path;
+}
+
+// Writes every map's bank into the directory
+static ErrorCode write_banks(LimdySnapshotWriter *writer, const char *directory)
+{
+    for (size_t i = 0; i < writer->map_count; i++)
+    {
+        char name[sizeof(SNAPSHOT_MAP_NAME_FORMAT) + 24];
+        snprintf(name, sizeof(name), SNAPSHOT_MAP_NAME_FORMAT, i);
+        char *path = snapshot_path(directory, name);
+        CHECK_NULL(path, ERROR_MEMORY_ALLOCATION);
+        ErrorCode error = banker_writer_write(writer->banks[i], path);
+        limdy_memory_pool_free(path);
+        RETURN_IF_ERROR(error);
+    }
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Write the snapshot to a directory.
+ *
+ * @param writer The writer.
+ * @param directory Path of the snapshot directory.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_writer_write(LimdySnapshotWriter *writer, const char *directory)
+{
+    CHECK_NULL(writer, ERROR_NULL_POINTER);
+    CHECK_NULL(directory, ERROR_NULL_POINTER);
+
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST)
+    {
+        LOG_ERROR(ERROR_FILE_IO, "Failed to create snapshot directory %s", directory);
+        return ERROR_FILE_IO;
+    }
+    // The image names the banks, so they are in place before it is
+    RETURN_IF_ERROR(write_banks(writer, directory));
+
+    size_t translation_capacity = 0;
+    size_t render_capacity = 0;
+    LimdyImageIndexEntry *translation_index = limdy_image_build_index(
+        writer->translations, writer->translation_count, sizeof(SnapshotTranslationRecord), &translation_capacity);
+    LimdyImageIndexEntry *render_index =
+        limdy_image_build_index(writer->renders, writer->render_count, sizeof(SnapshotRenderRecord), &render_capacity);
+    char *path = snapshot_path(directory, LIMDY_SNAPSHOT_IMAGE_NAME);
+    if (!translation_index || !render_index || !path)
+    {
+        limdy_memory_pool_free(translation_index);
+        limdy_memory_pool_free(render_index);
+        limdy_memory_pool_free(path);
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate snapshot image");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    SnapshotHeader header = {
+        .translation_count = writer->translation_count,
+        .render_count = writer->render_count,
+        .token_count = writer->token_count,
+        .map_count = writer->map_count,
+        .blob_bytes = writer->blob_bytes,
+        .translation_index_capacity = translation_capacity,
+        .render_index_capacity = render_capacity};
+    header.translation_offset = limdy_image_align(sizeof(SnapshotHeader));
+    header.render_offset =
+        limdy_image_align(header.translation_offset + writer->translation_count * sizeof(SnapshotTranslationRecord));
+    header.token_offset = limdy_image_align(header.render_offset + writer->render_count * sizeof(SnapshotRenderRecord));
+    header.map_offset = limdy_image_align(header.token_offset + writer->token_count * sizeof(SnapshotTokenRecord));
+    header.blob_offset = limdy_image_align(header.map_offset + writer->map_count * sizeof(SnapshotMapRecord));
+    header.translation_index_offset = limdy_image_align(header.blob_offset + writer->blob_bytes);
+    header.render_index_offset = header.translation_index_offset + translation_capacity * sizeof(LimdyImageIndexEntry);
+
+    const LimdyImageSection sections[] = {
+        {header.translation_offset, writer->translations, writer->translation_count * sizeof(SnapshotTranslationRecord)},
+        {header.render_offset, writer->renders, writer->render_count * sizeof(SnapshotRenderRecord)},
+        {header.token_offset, writer->tokens, writer->token_count * sizeof(SnapshotTokenRecord)},
+        {header.map_offset, writer->maps, writer->map_count * sizeof(SnapshotMapRecord)},
+        {header.blob_offset, writer->blob, writer->blob_bytes},
+        {header.translation_index_offset, translation_index, translation_capacity * sizeof(LimdyImageIndexEntry)},
+        {header.render_index_offset, render_index, render_capacity * sizeof(LimdyImageIndexEntry)}};
+    ErrorCode error = limdy_image_write(&snapshot_format, path, &header.image, sections, sizeof(sections) / sizeof(sections[0]));
+    limdy_memory_pool_free(translation_index);
+    limdy_memory_pool_free(render_index);
+    limdy_memory_pool_free(path);
+    return error;
+}
+
+/**
+ * @brief Destroy a snapshot writer.
+ *
+ * @param writer The writer, or NULL.
+ */
+void limdy_snapshot_writer_destroy(LimdySnapshotWriter *writer)
+{
+    if (!writer)
+    {
+        return;
+    }
+    for (size_t i = 0; i < writer->map_count; i++)
+    {
+        banker_writer_destroy(writer->banks[i]);
+    }
+    limdy_memory_pool_free(writer->translations);
+    limdy_memory_pool_free(writer->renders);
+    limdy_memory_pool_free(writer->tokens);
+    limdy_memory_pool_free(writer->maps);
+    limdy_memory_pool_free(writer->banks);
+    limdy_memory_pool_free(writer->blob);
+    limdy_memory_pool_free(writer);
+}
+
+// Checks the section bounds of a header whose common fields are valid
+static bool snapshot_header_valid(const void *image_header)
+{
+    const SnapshotHeader *header = image_header;
+    const LimdyImageHeader *image = &header->image;
+    return limdy_image_section_fits(image, header->translation_offset, header->translation_count,
+                                    sizeof(SnapshotTranslationRecord)) &&
+           limdy_image_section_fits(image, header->render_offset, header->render_count, sizeof(SnapshotRenderRecord)) &&
+           limdy_image_section_fits(image, header->token_offset, header->token_count, sizeof(SnapshotTokenRecord)) &&
+           limdy_image_section_fits(image, header->map_offset, header->map_count, sizeof(SnapshotMapRecord)) &&
+           limdy_image_section_fits(image, header->blob_offset, header->blob_bytes, 1) &&
+           limdy_image_index_fits(image, header->translation_index_offset, header->translation_index_capacity,
+                                  header->translation_count) &&
+           limdy_image_index_fits(image, header->render_index_offset, header->render_index_capacity, header->render_count);
+}
+
+/**
+ * @brief Map a snapshot for reading.
+ *
+ * @param directory Path of the snapshot directory.
+ * @param snapshot Pointer to store the opened snapshot.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_open(const char *directory, LimdySnapshot **snapshot)
+{
+    CHECK_NULL(directory, ERROR_NULL_POINTER);
+    CHECK_NULL(snapshot, ERROR_NULL_POINTER);
+
+    char *path = snapshot_path(directory, LIMDY_SNAPSHOT_IMAGE_NAME);
+    CHECK_NULL(path, ERROR_MEMORY_ALLOCATION);
+    LimdyImage image;
+    ErrorCode error = limdy_image_map(&snapshot_format, path, &image);
+    limdy_memory_pool_free(path);
+    RETURN_IF_ERROR(error);
+
+    size_t directory_length = strlen(directory);
+    LimdySnapshot *new_snapshot = limdy_memory_pool_alloc(sizeof(LimdySnapshot));
+    char *copy = new_snapshot ? limdy_memory_pool_alloc(directory_length + 1) : NULL;
+    if (!copy)
+    {
+        limdy_memory_pool_free(new_snapshot);
+        limdy_image_unmap(&image);
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate snapshot");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    memcpy(copy, directory, directory_length + 1);
+    new_snapshot->directory = copy;
+
+    const char *base = image.mapping;
+    const SnapshotHeader *header = image.mapping;
+    new_snapshot->image = image;
+    new_snapshot->header = header;
+    new_snapshot->translations = (const SnapshotTranslationRecord *)(base + header->translation_offset);
+    new_snapshot->renders = (const SnapshotRenderRecord *)(base + header->render_offset);
+    new_snapshot->tokens = (const SnapshotTokenRecord *)(base + header->token_offset);
+    new_snapshot->maps = (const SnapshotMapRecord *)(base + header->map_offset);
+    new_snapshot->blob = base + header->blob_offset;
+    new_snapshot->translation_index = (const LimdyImageIndexEntry *)(base + header->translation_index_offset);
+    new_snapshot->render_index = (const LimdyImageIndexEntry *)(base + header->render_index_offset);
+    atomic_init(&new_snapshot->translations_paged_in, 0);
+    atomic_init(&new_snapshot->renders_paged_in, 0);
+    atomic_init(&new_snapshot->maps_loaded, 0);
+
+    // Every miss starts with a random probe into an index; the records are paged in as they are hit
+    limdy_image_will_need(&new_snapshot->image, header->translation_index_offset,
+                          header->translation_index_capacity * sizeof(LimdyImageIndexEntry));
+    limdy_image_will_need(&new_snapshot->image, header->render_index_offset,
+                          header->render_index_capacity * sizeof(LimdyImageIndexEntry));
+
+    *snapshot = new_snapshot;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Unmap a snapshot.
+ *
+ * @param snapshot The snapshot, or NULL.
+ */
+void limdy_snapshot_close(LimdySnapshot *snapshot)
+{
+    if (!snapshot)
+    {
+        return;
+    }
+    limdy_image_unmap(&snapshot->image);
+    limdy_memory_pool_free(snapshot->directory);
+    limdy_memory_pool_free(snapshot);
+}
+
+// Checks that length bytes and a terminator at offset lie within the blob
+static bool blob_string_fits(const LimdySnapshot *snapshot, uint64_t offset, uint64_t length)
+{
+    uint64_t bytes = snapshot->header->blob_bytes;
+    return offset < bytes && length < bytes - offset && snapshot->blob[offset + length] == '\0';
+}
+
+/**
+ * @brief Probes an index for a hash, from slot *position on.
+ *
+ * @return The next record with the hash + 1, or 0 once the probe reaches an empty slot.
+ */
+static uint64_t index_next(const LimdyImageIndexEntry *index, uint64_t capacity, uint64_t hash, size_t *position, size_t *probes)
+{
+    size_t mask = capacity - 1;
+    // A damaged index may have no empty slot, so the probe stops after a full sweep
+    for (; *probes < capacity; (*probes)++, *position = (*position + 1) & mask)
+    {
+        const LimdyImageIndexEntry *entry = &index[*position];
+        if (entry->record == 0)
+        {
+            return 0;
+        }
+        if (entry->hash == hash)
+        {
+            (*probes)++;
+            *position = (*position + 1) & mask;
+            return entry->record;
+        }
+    }
+    return 0;
+}
+
+// Reads a translation record into record, checking its strings and scores against the blob
+static bool read_translation(const LimdySnapshot *snapshot, const SnapshotTranslationRecord *stored, TranslationMemoryRecord *record)
+{
+    uint64_t text = stored->strings;
+    uint64_t source = text + stored->text_length + 1;
+    uint64_t target = source + stored->source_length + 1;
+    uint64_t translated = target + stored->target_length + 1;
+    if (!blob_string_fits(snapshot, text, stored->text_length) || !blob_string_fits(snapshot, source, stored->source_length) ||
+        !blob_string_fits(snapshot, target, stored->target_length) ||
+        !blob_string_fits(snapshot, translated, stored->translated_length))
+    {
+        return false;
+    }
+
+    uint64_t scores = (uint64_t)stored->rows * stored->cols;
+    uint64_t bytes = snapshot->header->blob_bytes;
+    if (scores != 0 && (stored->attention % sizeof(float) != 0 || stored->attention > bytes ||
+                        scores > (bytes - stored->attention) / sizeof(float)))
+    {
+        return false;
+    }
+
+    record->text = snapshot->blob + text;
+    record->source_lang = snapshot->blob + source;
+    record->target_lang = snapshot->blob + target;
+    record->translated_text = snapshot->blob + translated;
+    record->attention = scores ? (const float *)(snapshot->blob + stored->attention) : NULL;
+    record->rows = scores ? stored->rows : 0;
+    record->cols = scores ? stored->cols : 0;
+    record->expires_at = stored->expires_at;
+    return true;
+}
+
+static ErrorCode snapshot_store_load(TranslationMemoryStore *base, TranslationMemoryVisitFn visit, void *context)
+{
+    // Nothing is replayed; entries are found one miss at a time
+    (void)base;
+    (void)visit;
+    (void)context;
+    return ERROR_SUCCESS;
+}
+
+static ErrorCode snapshot_store_save(TranslationMemoryStore *base, const TranslationMemoryRecord *record)
+{
+    // New entries are saved by the next snapshot
+    (void)base;
+    (void)record;
+    return ERROR_SUCCESS;
+}
+
+static ErrorCode snapshot_store_find(TranslationMemoryStore *base, const char *text, const char *source_lang,
+                                     const char *target_lang, TranslationMemoryVisitFn visit, void *context)
+{
+    LimdySnapshot *snapshot = ((SnapshotStore *)base)->snapshot;
+    const SnapshotHeader *header = snapshot->header;
+
+    size_t text_length = strlen(text);
+    size_t source_length = strlen(source_lang);
+    size_t target_length = strlen(target_lang);
+    uint64_t hash = translation_hash(text, text_length, source_lang, source_length, target_lang, target_length);
+
+    size_t position = hash & (header->translation_index_capacity - 1);
+    size_t probes = 0;
+    uint64_t found;
+    while ((found = index_next(snapshot->translation_index, header->translation_index_capacity, hash, &position, &probes)) != 0)
+    {
+        if (found > header->translation_count)
+        {
+            continue;
+        }
+        const SnapshotTranslationRecord *stored = &snapshot->translations[found - 1];
+        TranslationMemoryRecord record;
+        if (stored->text_length != text_length || stored->source_length != source_length ||
+            stored->target_length != target_length || !read_translation(snapshot, stored, &record))
+        {
+            continue;
+        }
+        if (strcmp(record.text, text) == 0 && strcmp(record.source_lang, source_lang) == 0 &&
+            strcmp(record.target_lang, target_lang) == 0)
+        {
+            atomic_fetch_add_explicit(&snapshot->translations_paged_in, 1, memory_order_relaxed);
+            return visit(context, &record);
+        }
+    }
+    return LIMDY_TRANSLATION_MEMORY_ERROR_MISS;
+}
+
+static void snapshot_store_destroy(TranslationMemoryStore *base)
+{
+    limdy_memory_pool_free(base);
+}
+
+/**
+ * @brief Create a translation memory store that pages entries in from the snapshot.
+ *
+ * @param snapshot The snapshot.
+ * @param store Pointer to store the created store.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_translation_store(LimdySnapshot *snapshot, TranslationMemoryStore **store)
+{
+    CHECK_NULL(snapshot, ERROR_NULL_POINTER);
+    CHECK_NULL(store, ERROR_NULL_POINTER);
+
+    SnapshotStore *new_store = limdy_memory_pool_alloc(sizeof(SnapshotStore));
+    CHECK_NULL(new_store, ERROR_MEMORY_ALLOCATION);
+
+    new_store->base.load = snapshot_store_load;
+    new_store->base.save = snapshot_store_save;
+    new_store->base.destroy = snapshot_store_destroy;
+    new_store->base.find = snapshot_store_find;
+    new_store->snapshot = snapshot;
+
+    *store = &new_store->base;
+    return ERROR_SUCCESS;
+}
+
+// Checks a render record's text, source and tokens against their sections
+static bool render_fits(const LimdySnapshot *snapshot, const SnapshotRenderRecord *stored)
+{
+    const SnapshotHeader *header = snapshot->header;
+    if (!blob_string_fits(snapshot, stored->text, stored->text_length) || stored->first_token > header->token_count ||
+        stored->token_count > header->token_count - stored->first_token)
+    {
+        return false;
+    }
+    if (stored->source != SNAPSHOT_SOURCE_TEXT &&
+        (stored->source > header->blob_bytes || stored->source_bytes > header->blob_bytes - stored->source))
+    {
+        return false;
+    }
+
+    uint64_t source_bytes = stored->source == SNAPSHOT_SOURCE_TEXT ? stored->text_length : stored->source_bytes;
+    for (size_t i = 0; i < stored->token_count; i++)
+    {
+        const SnapshotTokenRecord *token = &snapshot->tokens[stored->first_token + i];
+        if ((uint64_t)token->offset + token->length > source_bytes)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Cache source of a Renderer: fills a cache entry from the snapshot's copy of it.
+ */
+static ErrorCode snapshot_fill_render(void *context, const char *text, Language lang, RendererResult *result)
+{
+    LimdySnapshot *snapshot = context;
+    const SnapshotHeader *header = snapshot->header;
+
+    size_t text_length = strlen(text);
+    uint64_t hash = render_hash(text, text_length, lang);
+    size_t position = hash & (header->render_index_capacity - 1);
+    size_t probes = 0;
+    uint64_t found;
+    const SnapshotRenderRecord *stored = NULL;
+    while ((found = index_next(snapshot->render_index, header->render_index_capacity, hash, &position, &probes)) != 0)
+    {
+        const SnapshotRenderRecord *candidate = found <= header->render_count ? &snapshot->renders[found - 1] : NULL;
+        if (candidate && candidate->lang == (uint32_t)lang && candidate->text_length == text_length &&
+            render_fits(snapshot, candidate) && memcmp(snapshot->blob + candidate->text, text, text_length) == 0)
+        {
+            stored = candidate;
+            break;
+        }
+    }
+    if (!stored)
+    {
+        return LIMDY_RENDER_CACHE_ERROR_MISS;
+    }
+
+    // Laid out as the renderer does: the token array, then the interned text when the tokens do not span the text
+    size_t source_bytes = stored->source == SNAPSHOT_SOURCE_TEXT ? 0 : stored->source_bytes;
+    size_t token_bytes = stored->token_count * sizeof(Token);
+    if (token_bytes + source_bytes > 0)
+    {
+        char *block = renderer_result_alloc(result, token_bytes + source_bytes);
+        CHECK_NULL(block, ERROR_MEMORY_ALLOCATION);
+        const char *source = text;
+        if (source_bytes > 0)
+        {
+            memcpy(block + token_bytes, snapshot->blob + stored->source, source_bytes);
+            source = block + token_bytes;
+        }
+
+        Token *tokens = (Token *)block;
+        for (size_t i = 0; i < stored->token_count; i++)
+        {
+            const SnapshotTokenRecord *token = &snapshot->tokens[stored->first_token + i];
+            tokens[i] = (Token){.text = (char *)source + token->offset,
+                                .length = token->length,
+                                .offset = token->offset,
+                                .classes = token->classes};
+        }
+        result->tokens = stored->token_count ? tokens : NULL;
+        result->source = source;
+    }
+    else
+    {
+        result->tokens = NULL;
+        result->source = text;
+    }
+    result->token_count = stored->token_count;
+
+    atomic_fetch_add_explicit(&snapshot->renders_paged_in, 1, memory_order_relaxed);
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Make a Renderer page tokenization results in from the snapshot.
+ *
+ * @param snapshot The snapshot.
+ * @param renderer The Renderer to warm.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_attach_renderer(LimdySnapshot *snapshot, Renderer *renderer)
+{
+    CHECK_NULL(snapshot, ERROR_NULL_POINTER);
+    CHECK_NULL(renderer, ERROR_NULL_POINTER);
+
+    return renderer_set_cache_source(renderer, snapshot_fill_render, snapshot);
+}
+
+/**
+ * @brief Copies a bank element into the map, unless the map holds it already.
+ *
+ * The element's tokens and their texts take one allocation, which the map owns.
+ */
+static ErrorCode load_element(LinguisticElementMap *map, const BankerElement *stored)
+{
+    size_t bytes = stored->token_count * sizeof(Token);
+    for (size_t i = 0; i < stored->token_count; i++)
+    {
+        BankerToken token;
+        RETURN_IF_ERROR(banker_element_token(stored, i, &token));
+        bytes += token.length + 1;
+    }
+
+    Token *tokens = NULL;
+    if (bytes > 0)
+    {
+        tokens = linguistic_element_map_alloc(map, bytes);
+        CHECK_NULL(tokens, ERROR_MEMORY_ALLOCATION);
+        char *text = (char *)(tokens + stored->token_count);
+        for (size_t i = 0; i < stored->token_count; i++)
+        {
+            BankerToken token;
+            banker_element_token(stored, i, &token);
+            memcpy(text, token.text, token.length + 1);
+            tokens[i] = (Token){.text = text, .length = (uint32_t)token.length, .offset = 0, .classes = token.classes};
+            text += token.length + 1;
+        }
+    }
+
+    if (linguistic_element_map_find_tokens(map, stored->hash, tokens, stored->token_count))
+    {
+        linguistic_element_map_release(map, tokens);
+        return ERROR_SUCCESS;
+    }
+
+    ExtendedLinguisticElement element = {
+        .base = {.type = stored->type, .tokens = tokens, .token_count = stored->token_count, .hash = stored->hash}};
+    ErrorCode error = linguistic_element_map_add(map, &element);
+    if (error != ERROR_SUCCESS)
+    {
+        linguistic_element_map_release(map, tokens);
+    }
+    return error;
+}
+
+/**
+ * @brief Read a saved map's elements into a map.
+ *
+ * @param snapshot The snapshot.
+ * @param name Name the map was added with.
+ * @param map Initialized map to fill.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_snapshot_load_map(LimdySnapshot *snapshot, const char *name, LinguisticElementMap *map)
+{
+    CHECK_NULL(snapshot, ERROR_NULL_POINTER);
+    CHECK_NULL(name, ERROR_NULL_POINTER);
+    CHECK_NULL(map, ERROR_NULL_POINTER);
+
+    size_t name_length = strlen(name);
+    size_t position = snapshot->header->map_count;
+    for (size_t i = 0; i < snapshot->header->map_count; i++)
+    {
+        const SnapshotMapRecord *stored = &snapshot->maps[i];
+        if (stored->name_length == name_length && blob_string_fits(snapshot, stored->name, name_length) &&
+            memcmp(snapshot->blob + stored->name, name, name_length) == 0)
+        {
+            position = i;
+            break;
+        }
+    }
+    if (position == snapshot->header->map_count)
+    {
+        LOG_ERROR(LIMDY_SNAPSHOT_ERROR_NO_MAP, "Snapshot holds no map named %s", name);
+        return LIMDY_SNAPSHOT_ERROR_NO_MAP;
+    }
+
+    char bank_name[sizeof(SNAPSHOT_MAP_NAME_FORMAT) + 24];
+    snprintf(bank_name, sizeof(bank_name), SNAPSHOT_MAP_NAME_FORMAT, position);
+    char *path = snapshot_path(snapshot->directory, bank_name);
+    CHECK_NULL(path, ERROR_MEMORY_ALLOCATION);
+    Banker *bank = NULL;
+    ErrorCode error = banker_open(path, &bank);
+    limdy_memory_pool_free(path);
+    RETURN_IF_ERROR(error);
+
+    size_t count = banker_element_count(bank);
+    error = linguistic_element_map_reserve(map, map->element_count + count);
+    for (size_t i = 0; i < count && error == ERROR_SUCCESS; i++)
+    {
+        BankerElement stored;
+        error = banker_element_at(bank, i, &stored);
+        if (error == ERROR_SUCCESS)
+        {
+            error = load_element(map, &stored);
+        }
+    }
+    banker_close(bank);
+
+    if (error == ERROR_SUCCESS)
+    {
+        atomic_fetch_add_explicit(&snapshot->maps_loaded, 1, memory_order_relaxed);
+    }
+    return error;
+}
+
+/**
+ * @brief Get what a snapshot holds and how much of it was paged in.
+ *
+ * @param snapshot The snapshot.
+ * @param stats Pointer to store the counters.
+ */
+void limdy_snapshot_get_stats(const LimdySnapshot *snapshot, LimdySnapshotStats *stats)
+{
+    if (!stats)
+    {
+        return;
+    }
+    memset(stats, 0, sizeof(LimdySnapshotStats));
+    if (!snapshot)
+    {
+        return;
+    }
+
+    LimdySnapshot *counted = (LimdySnapshot *)snapshot;
+    stats->translations = snapshot->header->translation_count;
+    stats->renders = snapshot->header->render_count;
+    stats->maps = snapshot->header->map_count;
+    stats->translations_paged_in = atomic_load_explicit(&counted->translations_paged_in, memory_order_relaxed);
+    stats->renders_paged_in = atomic_load_explicit(&counted->renders_paged_in, memory_order_relaxed);
+    stats->maps_loaded = atomic_load_explicit(&counted->maps_loaded, memory_order_relaxed);
+}
+
+/**
+ * @brief Start timing a worker's startup.
+ *
+ * @param report The report to start.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_startup_begin(LimdyStartupReport *report)
+{
+    CHECK_NULL(report, ERROR_NULL_POINTER);
+
+    memset(report, 0, sizeof(LimdyStartupReport));
+    report->started_ns = monotonic_ns();
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Finish timing a worker's startup.
+ *
+ * @param report The report started with limdy_startup_begin().
+ * @param snapshot The snapshot the worker started from, or NULL.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_startup_end(LimdyStartupReport *report, const LimdySnapshot *snapshot)
+{
+    CHECK_NULL(report, ERROR_NULL_POINTER);
+
+    uint64_t now = monotonic_ns();
+    report->startup_ns = now > report->started_ns ? now - report->started_ns : 0;
+    report->warm = snapshot != NULL;
+    LIMDY_METRIC_RECORD(report->warm ? LIMDY_HISTOGRAM_STARTUP_WARM_NS : LIMDY_HISTOGRAM_STARTUP_COLD_NS, report->startup_ns);
+
+    if (snapshot)
+    {
+        LOG_INFO(ERROR_SUCCESS, "Warm start took %.3f ms from a snapshot of %zu translations, %zu renders and %zu maps",
+                 report->startup_ns / 1e6, (size_t)snapshot->header->translation_count,
+                 (size_t)snapshot->header->render_count, (size_t)snapshot->header->map_count);
+    }
+    else
+    {
+        LOG_INFO(ERROR_SUCCESS, "Cold start took %.3f ms", report->startup_ns / 1e6);
+    }
+    return ERROR_SUCCESS;
+}
@@ -0,0 +1,196 @@
+/**
+ * @file arena.c
+ * @brief Implementation of the bump-pointer arena.
+ *
+ * This file implements the interface defined in arena.h. Chunks come
+ * straight from malloc so that creating an arena never touches the pool
+ * system, and a reset only rewinds the cursor to the first chunk.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include "arena.h"
+#include "limdy_utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define ALIGN_CHUNK_HEADER ((sizeof(LimdyArenaChunk) + LIMDY_ARENA_ALIGNMENT - 1) & ~(size_t)(LIMDY_ARENA_ALIGNMENT - 1))
+#define CHUNK_DATA(chunk) ((char *)(chunk) + ALIGN_CHUNK_HEADER)
+
+ErrorCode limdy_arena_init(LimdyArena *arena, size_t chunk_size)
+{
+    CHECK_NULL(arena, ERROR_NULL_POINTER);
+
+    arena->head = NULL;
+    arena->current = NULL;
+    arena->cursor = NULL;
+    arena->limit = NULL;
+    arena->chunk_size = chunk_size ? chunk_size : LIMDY_ARENA_DEFAULT_CHUNK_SIZE;
+    arena->used = 0;
+
+    return ERROR_SUCCESS;
+}
+
+ErrorCode limdy_arena_create(size_t chunk_size, LimdyArena **arena)
+{
+    CHECK_NULL(arena, ERROR_NULL_POINTER);
+
+    *arena = malloc(sizeof(LimdyArena));
+    if (!*arena)
+    {
+        LOG_ERROR(LIMDY_ARENA_ERROR_ALLOC_FAILED, "Failed to allocate arena");
+        return LIMDY_ARENA_ERROR_ALLOC_FAILED;
+    }
+
+    return limdy_arena_init(*arena, chunk_size);
+}
+
+/**
+ * @brief Makes a chunk the current one.
+ *
+ * @param arena The arena.
+ * @param chunk The chunk to bump through next.
+ */
+static void use_chunk(LimdyArena *arena, LimdyArenaChunk *chunk)
+{
+    arena->current = chunk;
+    arena->cursor = CHUNK_DATA(chunk);
+    arena->limit = arena->cursor + chunk->size;
+}
+
+/**
+ * @brief Moves to a chunk that can hold size bytes at the given alignment.
+ *
+ * Chunks kept from before the last reset are reused in order; a new chunk
+ * is linked in after the current one only when none of them fits.
+ *
+ * @param arena The arena.
+ * @param size The number of bytes needed.
+ * @param alignment Required alignment.
+ * @return ErrorCode indicating success or failure.
+ */
+static ErrorCode advance_chunk(LimdyArena *arena, size_t size, size_t alignment)
+{
+    size_t needed = size + alignment - 1;
+
+    LimdyArenaChunk *next = arena->current ? arena->current->next : arena->head;
+    while (next && next->size < needed)
+    {
+        next = next->next;
+    }
+    if (next)
+    {
+        use_chunk(arena, next);
+        return ERROR_SUCCESS;
+    }
+
+    size_t chunk_size = needed > arena->chunk_size ? needed : arena->chunk_size;
+    LimdyArenaChunk *chunk = malloc(ALIGN_CHUNK_HEADER + chunk_size);
+    if (!chunk)
+    {
+        LOG_ERROR(LIMDY_ARENA_ERROR_ALLOC_FAILED, "Failed to allocate arena chunk");
+        return LIMDY_ARENA_ERROR_ALLOC_FAILED;
+    }
+    chunk->size = chunk_size;
+
+    if (arena->current)
+    {
+        chunk->next = arena->current->next;
+        arena->current->next = chunk;
+    }
+    else
+    {
+        chunk->next = arena->head;
+        arena->head = chunk;
+    }
+
+    use_chunk(arena, chunk);
+    return ERROR_SUCCESS;
+}
+
+void *limdy_arena_alloc_aligned(LimdyArena *arena, size_t size, size_t alignment)
+{
+    if (!arena)
+    {
+        LOG_ERROR(ERROR_NULL_POINTER, "Attempt to allocate from NULL arena");
+        return NULL;
+    }
+
+    uintptr_t aligned = ((uintptr_t)arena->cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    if (!arena->cursor || aligned + size > (uintptr_t)arena->limit)
+    {
+        if (advance_chunk(arena, size, alignment) != ERROR_SUCCESS)
+        {
+            return NULL;
+        }
+        aligned = ((uintptr_t)arena->cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    }
+
+    arena->used += (aligned - (uintptr_t)arena->cursor) + size;
+    arena->cursor = (char *)(aligned + size);
+    return (void *)aligned;
+}
+
+void *limdy_arena_alloc(LimdyArena *arena, size_t size)
+{
+    return limdy_arena_alloc_aligned(arena, size, LIMDY_ARENA_ALIGNMENT);
+}
+
+char *limdy_arena_strndup(LimdyArena *arena, const char *text, size_t length)
+{
+    char *copy = limdy_arena_alloc_aligned(arena, length + 1, 1);
+    if (copy)
+    {
+        memcpy(copy, text, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+void limdy_arena_reset(LimdyArena *arena)
+{
+    if (!arena)
+    {
+        return;
+    }
+
+    if (arena->head)
+    {
+        use_chunk(arena, arena->head);
+    }
+    arena->used = 0;
+}
+
+void limdy_arena_release(LimdyArena *arena)
+{
+    if (!arena)
+    {
+        return;
+    }
+
+    LimdyArenaChunk *chunk = arena->head;
+    while (chunk)
+    {
+        LimdyArenaChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    limdy_arena_init(arena, arena->chunk_size);
+}
+
+void limdy_arena_destroy(LimdyArena *arena)
+{
+    if (arena)
+    {
+        limdy_arena_release(arena);
+        free(arena);
+    }
+}
+
+size_t limdy_arena_used(const LimdyArena *arena)
+{
+    return arena ? arena->used : 0;
+}
@@ -0,0 +1,604 @@
+/**
+ * @file attention_kernel.c
+ * @brief Implementation of the attention alignment kernels.
+ *
+ * This file implements the interface defined in attention_kernel.h. The
+ * argmax passes are the only part that touches every matrix element, so
+ * they alone are vectorized; symmetrization works on the O(rows + cols)
+ * argmax results. Matrix rows are 64-byte aligned (see limdy_matrix.h),
+ * which lets every vector loop use aligned loads.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include "attention_kernel.h"
+#include "limdy_utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define ATTENTION_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#define ATTENTION_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+typedef struct
+{
+    const char *name;
+    void (*row_argmax)(const LimdyMatrix *matrix, uint32_t *index, float *score);
+    void (*col_argmax)(const LimdyMatrix *matrix, uint32_t *index, float *score);
+} KernelOps;
+
+/**
+ * @brief Finds the first column holding the row maximum.
+ */
+static uint32_t first_index_of(const float *row, size_t cols, float value)
+{
+    for (size_t j = 0; j < cols; j++)
+    {
+        if (row[j] == value)
+        {
+            return (uint32_t)j;
+        }
+    }
+    return 0;
+}
+
+static void row_argmax_scalar(const LimdyMatrix *matrix, uint32_t *index, float *score)
+{
+    for (size_t i = 0; i < matrix->rows; i++)
+    {
+        const float *row = limdy_matrix_row(matrix, i);
+        uint32_t best_index = 0;
+        float best = row[0];
+        for (size_t j = 1; j < matrix->cols; j++)
+        {
+            if (row[j] > best)
+            {
+                best = row[j];
+                best_index = (uint32_t)j;
+            }
+        }
+        index[i] = best_index;
+        score[i] = best;
+    }
+}
+
+static void col_argmax_scalar(const LimdyMatrix *matrix, uint32_t *index, float *score)
+{
+    const float *first = limdy_matrix_row(matrix, 0);
+    for (size_t j = 0; j < matrix->stride; j++)
+    {
+        index[j] = 0;
+        score[j] = first[j];
+    }
+
+    for (size_t i = 1; i < matrix->rows; i++)
+    {
+        const float *row = limdy_matrix_row(matrix, i);
+        for (size_t j = 0; j < matrix->cols; j++)
+        {
+            if (row[j] > score[j])
+            {
+                score[j] = row[j];
+                index[j] = (uint32_t)i;
+            }
+        }
+    }
+}
+
+#ifdef ATTENTION_HAVE_X86
+static void row_argmax_sse2(const LimdyMatrix *matrix, uint32_t *index, float *score)
+{
+    for (size_t i = 0; i < matrix->rows; i++)
+    {
+        const float *row = limdy_matrix_row(matrix, i);
+        float best = row[0];
+        size_t j = 0;
+
+        if (matrix->cols >= 4)
+        {
+            __m128 vmax = _mm_load_ps(row);
+            for (j = 4; j + 4 <= matrix->cols; j += 4)
+            {
+                vmax = _mm_max_ps(vmax, _mm_load_ps(row + j));
+            }
+            vmax = _mm_max_ps(vmax, _mm_shuffle_ps(vmax, vmax, _MM_SHUFFLE(1, 0, 3, 2)));
+            vmax = _mm_max_ps(vmax, _mm_shuffle_ps(vmax, vmax, _MM_SHUFFLE(2, 3, 0, 1)));
+            best = _mm_cvtss_f32(vmax);
+        }
+        for (; j < matrix->cols; j++)
+        {
+            best = row[j] > best ? row[j] : best;
+        }
+
+        index[i] = first_index_of(row, matrix->cols, best);
+        score[i] = best;
+    }
+}
+
+static void col_argmax_sse2(const LimdyMatrix *matrix, uint32_t *index, float *score)
+{
+    // The stride is a multiple of 16 floats, so whole vectors cover every column
+    for (size_t j = 0; j < matrix->stride; j += 4)
+    {
+        __m128 best = _mm_load_ps(limdy_matrix_row(matrix, 0) + j);
+        __m128 best_index = _mm_setzero_ps();
+        for (size_t i = 1; i < matrix->rows; i++)
+        {
+            __m128 value = _mm_load_ps(limdy_matrix_row(matrix, i) + j);
+            __m128 greater = _mm_cmpgt_ps(value, best);
+            __m128 row_index = _mm_castsi128_ps(_mm_set1_epi32((int)i));
+            best = _mm_or_ps(_mm_and_ps(greater, value), _mm_andnot_ps(greater, best));
+            best_index = _mm_or_ps(_mm_and_ps(greater, row_index), _mm_andnot_ps(greater, best_index));
+        }
+        _mm_storeu_ps(score + j, best);
+        _mm_storeu_si128((__m128i *)(index + j), _mm_castps_si128(best_index));
+    }
+}
+
+__attribute__((target("avx2"))) static void row_argmax_avx2(const LimdyMatrix *matrix, uint32_t *index, float *score)
+{
+    for (size_t i = 0; i < matrix->rows; i++)
+    {
+        const float *row = limdy_matrix_row(matrix, i);
+        float best = row[0];
+        size_t j = 0;
+
+        if (matrix->cols >= 8)
+        {
+            __m256 vmax = _mm256_load_ps(row);
+            for (j = 8; j + 8 <= matrix->cols; j += 8)
+            {
+                vmax = _mm256_max_ps(vmax, _mm256_load_ps(row + j));
+            }
+            __m128 half = _mm_max_ps(_mm256_castps256_ps128(vmax), _mm256_extractf128_ps(vmax, 1));
+            half = _mm_max_ps(half, _mm_shuffle_ps(half, half, _MM_SHUFFLE(1, 0, 3, 2)));
+            half = _mm_max_ps(half, _mm_shuffle_ps(half, half, _MM_SHUFFLE(2, 3, 0, 1)));
+            best = _mm_cvtss_f32(half);
+        }
+        for (; j < matrix->cols; j++)
+        {
+            best = row[j] > best ? row[j] : best;
+        }
+
+        index[i] = first_index_of(row, matrix->cols, best);
+        score[i] = best;
+    }
+}
+
+__attribute__((target("avx2"))) static void col_argmax_avx2(const LimdyMatrix *matrix, uint32_t *index, float *score)
+{
+    for (size_t j = 0; j < matrix->stride; j += 8)
+    {
+        __m256 best = _mm256_load_ps(limdy_matrix_row(matrix, 0) + j);
+        __m256 best_index = _mm256_setzero_ps();
+        for (size_t i = 1; i < matrix->rows; i++)
+        {
+            __m256 value = _mm256_load_ps(limdy_matrix_row(matrix, i) + j);
+            __m256 greater = _mm256_cmp_ps(value, best, _CMP_GT_OQ);
+            best = _mm256_blendv_ps(best, value, greater);
+            best_index = _mm256_blendv_ps(best_index, _mm256_castsi256_ps(_mm256_set1_epi32((int)i)), greater);
+        }
+        _mm256_storeu_ps(score + j, best);
+        _mm256_storeu_si256((__m256i *)(index + j), _mm256_castps_si256(best_index));
+    }
+}
+#endif // ATTENTION_HAVE_X86
+
+#ifdef ATTENTION_HAVE_NEON
+static void row_argmax_neon(const LimdyMatrix *matrix, uint32_t *index, float *score)
+{
+    for (size_t i = 0; i < matrix->rows; i++)
+    {
+        const float *row = limdy_matrix_row(matrix, i);
+        float best = row[0];
+        size_t j = 0;
+
+        if (matrix->cols >= 4)
+        {
+            float32x4_t vmax = vld1q_f32(row);
+            for (j = 4; j + 4 <= matrix->cols; j += 4)
+            {
+                vmax = vmaxq_f32(vmax, vld1q_f32(row + j));
+            }
+            float32x2_t half = vpmax_f32(vget_low_f32(vmax), vget_high_f32(vmax));
+            best = vget_lane_f32(vpmax_f32(half, half), 0);
+        }
+        for (; j < matrix->cols; j++)
+        {
+            best = row[j] > best ? row[j] : best;
+        }
+
+        index[i] = first_index_of(row, matrix->cols, best);
+        score[i] = best;
+    }
+}
+
+static void col_argmax_neon(const LimdyMatrix *matrix, uint32_t *index, float *score)
+{
+    for (size_t j = 0; j < matrix->stride; j += 4)
+    {
+        float32x4_t best = vld1q_f32(limdy_matrix_row(matrix, 0) + j);
+        uint32x4_t best_index = vdupq_n_u32(0);
+        for (size_t i = 1; i < matrix->rows; i++)
+        {
+            float32x4_t value = vld1q_f32(limdy_matrix_row(matrix, i) + j);
+            uint32x4_t greater = vcgtq_f32(value, best);
+            best = vbslq_f32(greater, value, best);
+            best_index = vbslq_u32(greater, vdupq_n_u32((uint32_t)i), best_index);
+        }
+        vst1q_f32(score + j, best);
+        vst1q_u32(index + j, best_index);
+    }
+}
+#endif // ATTENTION_HAVE_NEON
+
+static const KernelOps scalar_ops = {"scalar", row_argmax_scalar, col_argmax_scalar};
+#ifdef ATTENTION_HAVE_X86
+static const KernelOps sse2_ops = {"sse2", row_argmax_sse2, col_argmax_sse2};
+static const KernelOps avx2_ops = {"avx2", row_argmax_avx2, col_argmax_avx2};
+#endif
+#ifdef ATTENTION_HAVE_NEON
+static const KernelOps neon_ops = {"neon", row_argmax_neon, col_argmax_neon};
+#endif
+
+static _Atomic(const KernelOps *) active_ops = NULL;
+
+/**
+ * @brief Looks up the kernel for an instruction set if the CPU supports it.
+ *
+ * @param kernel The requested kernel.
+ * @return The kernel, or NULL if it is unavailable.
+ */
+static const KernelOps *find_kernel(LimdyAttentionKernel kernel)
+{
+    switch (kernel)
+    {
+    case LIMDY_ATTENTION_KERNEL_SCALAR:
+        return &scalar_ops;
+#ifdef ATTENTION_HAVE_X86
+    case LIMDY_ATTENTION_KERNEL_SSE2:
+        return __builtin_cpu_supports("sse2") ? &sse2_ops : NULL;
+    case LIMDY_ATTENTION_KERNEL_AVX2:
+        return __builtin_cpu_supports("avx2") ? &avx2_ops : NULL;
+#endif
+#ifdef ATTENTION_HAVE_NEON
+    case LIMDY_ATTENTION_KERNEL_NEON:
+        return &neon_ops;
+#endif
+    case LIMDY_ATTENTION_KERNEL_AUTO:
+    {
+        static const LimdyAttentionKernel preference[] = {LIMDY_ATTENTION_KERNEL_AVX2, LIMDY_ATTENTION_KERNEL_NEON, LIMDY_ATTENTION_KERNEL_SSE2};
+        for (size_t i = 0; i < sizeof(preference) / sizeof(preference[0]); i++)
+        {
+            const KernelOps *ops = find_kernel(preference[i]);
+            if (ops)
+            {
+                return ops;
+            }
+        }
+        return &scalar_ops;
+    }
+    default:
+        return NULL;
+    }
+}
+
+/**
+ * @brief Gets the active kernel, detecting the best one on first use.
+ */
+static const KernelOps *get_kernel(void)
+{
+    const KernelOps *ops = atomic_load_explicit(&active_ops, memory_order_acquire);
+    if (!ops)
+    {
+        // Racing threads all detect the same kernel, so a plain store is enough
+        ops = find_kernel(LIMDY_ATTENTION_KERNEL_AUTO);
+        atomic_store_explicit(&active_ops, ops, memory_order_release);
+    }
+    return ops;
+}
+
+ErrorCode limdy_attention_set_kernel(LimdyAttentionKernel kernel)
+{
+    const KernelOps *ops = find_kernel(kernel);
+    if (!ops)
+    {
+        LOG_ERROR(LIMDY_ATTENTION_ERROR_UNSUPPORTED, "Attention kernel %d is not supported on this CPU", (int)kernel);
+        return LIMDY_ATTENTION_ERROR_UNSUPPORTED;
+    }
+
+    atomic_store_explicit(&active_ops, ops, memory_order_release);
+    return ERROR_SUCCESS;
+}
+
+const char *limdy_attention_kernel_name(void)
+{
+    return get_kernel()->name;
+}
+
+void limdy_attention_row_argmax(const LimdyMatrix *matrix, uint32_t *index, float *score)
+{
+    if (!matrix || matrix->rows == 0 || matrix->cols == 0)
+    {
+        return;
+    }
+    get_kernel()->row_argmax(matrix, index, score);
+}
+
+void limdy_attention_col_argmax(const LimdyMatrix *matrix, uint32_t *index, float *score)
+{
+    if (!matrix || matrix->rows == 0 || matrix->cols == 0)
+    {
+        return;
+    }
+    get_kernel()->col_argmax(matrix, index, score);
+}
+
+size_t limdy_attention_align_capacity(size_t rows, size_t cols)
+{
+    // Every link is the argmax of its row or its column
+    return rows + cols;
+}
+
+/**
+ * @brief Working state for symmetrization.
+ *
+ * The union of both directions has at most one point per row (the row
+ * argmax) and one per column (the column argmax), so membership in the
+ * union and in the growing alignment can be tracked per row and column.
+ */
+typedef struct
+{
+    const LimdyMatrix *matrix;
+    uint32_t *row_index;   // Column of each row's argmax
+    uint32_t *col_index;   // Row of each column's argmax
+    bool *row_in_union;    // Row argmax passes the threshold
+    bool *col_in_union;    // Column argmax passes the threshold
+    bool *row_linked;      // Row argmax point is in the alignment
+    bool *col_linked;      // Column argmax point is in the alignment
+    uint32_t *source_links; // Links per source token
+    uint32_t *target_links; // Links per target token
+} AlignState;
+
+// (i, j) is row i's argmax and passes the threshold
+static bool is_row_point(const AlignState *state, size_t i, size_t j)
+{
+    return state->row_in_union[i] && state->row_index[i] == j;
+}
+
+// (i, j) is column j's argmax and passes the threshold
+static bool is_col_point(const AlignState *state, size_t i, size_t j)
+{
+    return state->col_in_union[j] && state->col_index[j] == i;
+}
+
+static bool is_linked(const AlignState *state, size_t i, size_t j)
+{
+    return (state->row_linked[i] && state->row_index[i] == j) || (state->col_linked[j] && state->col_index[j] == i);
+}
+
+static void link_point(AlignState *state, size_t i, size_t j)
+{
+    if (is_linked(state, i, j))
+    {
+        return;
+    }
+    if (is_row_point(state, i, j))
+    {
+        state->row_linked[i] = true;
+    }
+    if (is_col_point(state, i, j))
+    {
+        state->col_linked[j] = true;
+    }
+    state->source_links[i]++;
+    state->target_links[j]++;
+}
+
+static bool has_linked_neighbor(const AlignState *state, size_t i, size_t j)
+{
+    for (int di = -1; di <= 1; di++)
+    {
+        for (int dj = -1; dj <= 1; dj++)
+        {
+            if ((di == 0 && dj == 0) || (di < 0 && i == 0) || (dj < 0 && j == 0))
+            {
+                continue;
+            }
+            size_t ni = i + di;
+            size_t nj = j + dj;
+            if (ni < state->matrix->rows && nj < state->matrix->cols && is_linked(state, ni, nj))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Links a union point if one of its tokens is still unaligned.
+ *
+ * @return true if the point was added.
+ */
+static bool try_link(AlignState *state, size_t i, size_t j, bool need_neighbor)
+{
+    if (is_linked(state, i, j) || (state->source_links[i] && state->target_links[j]))
+    {
+        return false;
+    }
+    if (need_neighbor && !has_linked_neighbor(state, i, j))
+    {
+        return false;
+    }
+    link_point(state, i, j);
+    return true;
+}
+
+static void grow_diag_final(AlignState *state)
+{
+    size_t rows = state->matrix->rows;
+    size_t cols = state->matrix->cols;
+
+    // Grow: repeatedly add union points adjacent to the alignment
+    bool grew = true;
+    while (grew)
+    {
+        grew = false;
+        for (size_t i = 0; i < rows; i++)
+        {
+            if (state->row_in_union[i])
+            {
+                grew |= try_link(state, i, state->row_index[i], true);
+            }
+        }
+        for (size_t j = 0; j < cols; j++)
+        {
+            if (state->col_in_union[j])
+            {
+                grew |= try_link(state, state->col_index[j], j, true);
+            }
+        }
+    }
+
+    // Final: add remaining union points for tokens left unaligned
+    for (size_t i = 0; i < rows; i++)
+    {
+        if (state->row_in_union[i])
+        {
+            try_link(state, i, state->row_index[i], false);
+        }
+    }
+    for (size_t j = 0; j < cols; j++)
+    {
+        if (state->col_in_union[j])
+        {
+            try_link(state, state->col_index[j], j, false);
+        }
+    }
+}
+
+static int compare_links(const void *a, const void *b)
+{
+    const AlignmentLink *left = a;
+    const AlignmentLink *right = b;
+    if (left->source_index != right->source_index)
+    {
+        return left->source_index < right->source_index ? -1 : 1;
+    }
+    if (left->target_index != right->target_index)
+    {
+        return left->target_index < right->target_index ? -1 : 1;
+    }
+    return 0;
+}
+
+ErrorCode limdy_attention_align(const LimdyMatrix *matrix, const LimdyAlignOptions *options, LimdyArena *scratch,
+                                AlignmentLink *links, size_t *link_count)
+{
+    CHECK_NULL(matrix, ERROR_NULL_POINTER);
+    CHECK_NULL(scratch, ERROR_NULL_POINTER);
+    CHECK_NULL(link_count, ERROR_NULL_POINTER);
+
+    *link_count = 0;
+    if (matrix->rows == 0 || matrix->cols == 0)
+    {
+        return ERROR_SUCCESS;
+    }
+    CHECK_NULL(links, ERROR_NULL_POINTER);
+
+    LimdyAlignOptions opts = options ? *options : LIMDY_ALIGN_OPTIONS_DEFAULT;
+    size_t rows = matrix->rows;
+    size_t cols = matrix->cols;
+
+    AlignState state = {.matrix = matrix};
+    float *row_score = limdy_arena_alloc(scratch, rows * sizeof(float));
+    float *col_score = limdy_arena_alloc(scratch, matrix->stride * sizeof(float));
+    state.row_index = limdy_arena_alloc(scratch, rows * sizeof(uint32_t));
+    state.col_index = limdy_arena_alloc(scratch, matrix->stride * sizeof(uint32_t));
+    state.source_links = limdy_arena_alloc(scratch, rows * sizeof(uint32_t));
+    state.target_links = limdy_arena_alloc(scratch, cols * sizeof(uint32_t));
+    state.row_in_union = limdy_arena_alloc(scratch, 2 * rows * sizeof(bool));
+    state.col_in_union = limdy_arena_alloc(scratch, 2 * cols * sizeof(bool));
+    if (!row_score || !col_score || !state.row_index || !state.col_index || !state.source_links ||
+        !state.target_links || !state.row_in_union || !state.col_in_union)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate alignment scratch buffers");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    state.row_linked = state.row_in_union + rows;
+    state.col_linked = state.col_in_union + cols;
+    memset(state.source_links, 0, rows * sizeof(uint32_t));
+    memset(state.target_links, 0, cols * sizeof(uint32_t));
+    memset(state.row_linked, 0, rows * sizeof(bool));
+    memset(state.col_linked, 0, cols * sizeof(bool));
+
+    const KernelOps *ops = get_kernel();
+    ops->row_argmax(matrix, state.row_index, row_score);
+    ops->col_argmax(matrix, state.col_index, col_score);
+
+    for (size_t i = 0; i < rows; i++)
+    {
+        state.row_in_union[i] = row_score[i] >= opts.threshold;
+    }
+    for (size_t j = 0; j < cols; j++)
+    {
+        state.col_in_union[j] = col_score[j] >= opts.threshold;
+    }
+
+    // Start from the intersection: row points that are also their column's argmax
+    for (size_t i = 0; i < rows; i++)
+    {
+        uint32_t j = state.row_index[i];
+        if (is_row_point(&state, i, j) && (opts.mode == LIMDY_ALIGN_UNION || is_col_point(&state, i, j)))
+        {
+            link_point(&state, i, j);
+        }
+    }
+    if (opts.mode == LIMDY_ALIGN_UNION)
+    {
+        for (size_t j = 0; j < cols; j++)
+        {
+            if (state.col_in_union[j])
+            {
+                link_point(&state, state.col_index[j], j);
+            }
+        }
+    }
+    else if (opts.mode == LIMDY_ALIGN_GROW_DIAG_FINAL)
+    {
+        grow_diag_final(&state);
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < rows; i++)
+    {
+        if (state.row_linked[i])
+        {
+            links[count++] = (AlignmentLink){(uint32_t)i, state.row_index[i], row_score[i]};
+        }
+    }
+    for (size_t j = 0; j < cols; j++)
+    {
+        // Points that are both row and column argmax were emitted above
+        uint32_t i = state.col_index[j];
+        if (state.col_linked[j] && !(state.row_linked[i] && state.row_index[i] == j))
+        {
+            links[count++] = (AlignmentLink){i, (uint32_t)j, col_score[j]};
+        }
+    }
+
+    qsort(links, count, sizeof(AlignmentLink), compare_links);
+    *link_count = count;
+
+    return ERROR_SUCCESS;
+}
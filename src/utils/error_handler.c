@@ -14,124 +14,578 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
 #include <time.h>
-#include <pthread.h>
 
-#define MAX_ERROR_QUEUE_SIZE 100
+#define ERROR_RECORD_MAX_ARGS 8
+#define ERROR_RECORD_TEXT_SIZE 128
+#define ERROR_HISTORY_MASK (LIMDY_ERROR_HISTORY_SIZE - 1)
+#define RATE_LIMIT_SITES 256
+#define RATE_LIMIT_COUNT_BITS 20
+#define RATE_LIMIT_COUNT_MASK ((1ULL << RATE_LIMIT_COUNT_BITS) - 1)
+#define RATE_LIMIT_TAG_BITS 12
+#define RATE_LIMIT_TAG_MASK ((1ULL << RATE_LIMIT_TAG_BITS) - 1)
+#define FORMAT_CONVERSIONS "diouxXcsfFeEgGaAp"
+
+#ifdef CLOCK_MONOTONIC_COARSE
+#define RATE_LIMIT_CLOCK CLOCK_MONOTONIC_COARSE
+#else
+#define RATE_LIMIT_CLOCK CLOCK_MONOTONIC
+#endif
 
 /**
- * @brief Thread-local storage for error context.
+ * @brief How a packed argument was read and must be passed back to snprintf.
  */
+typedef enum
+{
+    ARG_INT,
+    ARG_LONG,
+    ARG_LONG_LONG,
+    ARG_INTMAX,
+    ARG_SIZE,
+    ARG_PTRDIFF,
+    ARG_DOUBLE,
+    ARG_LONG_DOUBLE,
+    ARG_POINTER,
+    ARG_STRING
+} ErrorArgKind;
+
+/**
+ * @brief An error as logged: its format and packed arguments, not yet formatted.
+ */
+typedef struct
+{
+    ErrorCode code;
+    ErrorLevel level;
+    const char *file;
+    int line;
+    const char *function;
+    const char *format;  // NULL when text already holds the formatted message
+    uint32_t suppressed; // Errors of the same call site suppressed just before this one
+    uint8_t arg_count;
+    uint8_t kinds[ERROR_RECORD_MAX_ARGS];
+    uint64_t args[ERROR_RECORD_MAX_ARGS]; // Integer or pointer values, double bits, or offsets of strings in text
+    char text[ERROR_RECORD_TEXT_SIZE];    // Copies of string arguments
+} ErrorRecord;
+
+_Static_assert(sizeof(ErrorRecord) % sizeof(uint64_t) == 0, "ErrorRecord must be copied in whole words");
+#define ERROR_RECORD_WORDS (sizeof(ErrorRecord) / sizeof(uint64_t))
+
+/**
+ * @brief Slot of the history ring, written under a per-slot sequence lock.
+ *
+ * The sequence is 0 before the first write, 2t + 1 while the error with
+ * ticket t is written and 2t + 2 once it is complete.
+ */
+typedef struct
+{
+    _Atomic uint64_t sequence;
+    _Atomic uint64_t words[ERROR_RECORD_WORDS];
+} ErrorHistorySlot;
+
+/**
+ * @brief The calling thread's last error, formatted into tls_error_context on demand.
+ */
+static __thread ErrorRecord tls_error_record;
 static __thread ErrorContext tls_error_context;
+static __thread bool tls_error_pending;
 
 /**
  * @brief Global error handler function pointer.
  */
-static ErrorHandler global_error_handler = NULL;
+static _Atomic(ErrorHandler) global_error_handler = NULL;
 
 /**
  * @brief Minimum error level for logging.
  */
-static ErrorLevel min_error_level = ERROR_LEVEL_DEBUG;
+static atomic_int min_error_level = ERROR_LEVEL_DEBUG;
 
 /**
- * @brief Mutex for thread-safe operations.
+ * @brief Ring of the most recent errors of all threads; any thread may write, readers copy.
  */
-static pthread_mutex_t error_mutex = PTHREAD_MUTEX_INITIALIZER;
+static ErrorHistorySlot error_history[LIMDY_ERROR_HISTORY_SIZE];
 
 /**
- * @brief Circular buffer for error history.
+ * @brief Ticket of the next error entering the history.
  */
-static ErrorContext error_history[MAX_ERROR_QUEUE_SIZE];
+static _Atomic uint64_t error_history_head = 0;
 
 /**
- * @brief Start index of the error history circular buffer.
+ * @brief Errors per call site per second passed to the handler, or 0 for no limit.
  */
-static int error_history_start = 0;
+static atomic_uint rate_limit = LIMDY_ERROR_RATE_LIMIT_DEFAULT;
 
 /**
- * @brief Number of errors in the error history.
+ * @brief Per slot: the low 32 bits of the current second, a tag of the call site using it, and its errors in that second.
  */
-static int error_history_count = 0;
+static _Atomic uint64_t rate_limit_sites[RATE_LIMIT_SITES];
+
+static atomic_size_t errors_logged;
+static atomic_size_t errors_suppressed;
+static atomic_size_t errors_dropped;
 
 void error_init(void)
 {
-    pthread_mutex_init(&error_mutex, NULL);
+    atomic_store(&errors_logged, 0);
+    atomic_store(&errors_suppressed, 0);
+    atomic_store(&errors_dropped, 0);
 }
 
 void error_cleanup(void)
 {
-    pthread_mutex_destroy(&error_mutex);
+    // Nothing is allocated; the history stays readable until exit
 }
 
 void error_set_handler(ErrorHandler handler)
 {
-    pthread_mutex_lock(&error_mutex);
-    global_error_handler = handler;
-    pthread_mutex_unlock(&error_mutex);
+    atomic_store(&global_error_handler, handler);
 }
 
 void error_set_min_level(ErrorLevel level)
 {
-    pthread_mutex_lock(&error_mutex);
-    min_error_level = level;
-    pthread_mutex_unlock(&error_mutex);
+    atomic_store(&min_error_level, level);
+}
+
+void error_set_rate_limit(unsigned per_second)
+{
+    atomic_store(&rate_limit, per_second);
+}
+
+static bool record_push_arg(ErrorRecord *record, ErrorArgKind kind, uint64_t value)
+{
+    if (record->arg_count == ERROR_RECORD_MAX_ARGS)
+    {
+        return false;
+    }
+    record->kinds[record->arg_count] = kind;
+    record->args[record->arg_count] = value;
+    record->arg_count++;
+    return true;
 }
 
 /**
- * @brief Add an error context to the error history.
+ * @brief Pack the arguments of every conversion in format; false if one cannot be packed.
+ */
+static bool record_pack(ErrorRecord *record, const char *format, va_list args)
+{
+    size_t text_used = 0;
+
+    for (const char *p = format; *p; p++)
+    {
+        if (*p != '%')
+        {
+            continue;
+        }
+        if (*++p == '%')
+        {
+            continue;
+        }
+
+        while (*p && strchr("-+ #0'", *p))
+        {
+            p++;
+        }
+
+        // Width, then precision; either may come from an argument
+        long precision = -1;
+        for (int part = 0; part < 2; part++)
+        {
+            if (part == 1)
+            {
+                if (*p != '.')
+                {
+                    break;
+                }
+                p++;
+                precision = 0;
+            }
+            if (*p == '*')
+            {
+                int value = va_arg(args, int);
+                if (!record_push_arg(record, ARG_INT, (uint64_t)(int64_t)value))
+                {
+                    return false;
+                }
+                if (part == 1)
+                {
+                    precision = value < 0 ? -1 : value;
+                }
+                p++;
+            }
+            while (*p >= '0' && *p <= '9')
+            {
+                if (part == 1)
+                {
+                    precision = precision * 10 + (*p - '0');
+                }
+                p++;
+            }
+        }
+
+        char length = 0; // 'H' for hh, 'q' for ll
+        if (*p == 'h' || *p == 'l')
+        {
+            length = *p++;
+            if (*p == length)
+            {
+                length = length == 'h' ? 'H' : 'q';
+                p++;
+            }
+        }
+        else if (*p == 'j' || *p == 'z' || *p == 't' || *p == 'L')
+        {
+            length = *p++;
+        }
+
+        if (!*p || !strchr(FORMAT_CONVERSIONS, *p))
+        {
+            return false;
+        }
+
+        bool packed;
+        switch (*p)
+        {
+        case 's':
+        {
+            const char *text = va_arg(args, const char *);
+            if (length)
+            {
+                return false;
+            }
+            if (!text)
+            {
+                text = "(null)";
+            }
+            // Only what fits or what the precision lets through is kept
+            size_t room = ERROR_RECORD_TEXT_SIZE - text_used - 1;
+            size_t limit = precision >= 0 && (size_t)precision < room ? (size_t)precision : room;
+            size_t copied = strnlen(text, limit);
+            memcpy(record->text + text_used, text, copied);
+            record->text[text_used + copied] = '\0';
+            packed = record_push_arg(record, ARG_STRING, text_used);
+            text_used += copied + (text_used + copied + 1 < ERROR_RECORD_TEXT_SIZE);
+            break;
+        }
+        case 'p':
+            packed = !length && record_push_arg(record, ARG_POINTER, (uintptr_t)va_arg(args, void *));
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+        {
+            uint64_t bits;
+            double value = length == 'L' ? (double)va_arg(args, long double) : va_arg(args, double);
+            memcpy(&bits, &value, sizeof(bits));
+            packed = record_push_arg(record, length == 'L' ? ARG_LONG_DOUBLE : ARG_DOUBLE, bits);
+            break;
+        }
+        default:
+            switch (length)
+            {
+            case 0:
+            case 'h':
+            case 'H':
+                packed = record_push_arg(record, ARG_INT, (uint64_t)(int64_t)va_arg(args, int));
+                break;
+            case 'l':
+                packed = *p != 'c' && record_push_arg(record, ARG_LONG, (uint64_t)va_arg(args, long));
+                break;
+            case 'q':
+                packed = record_push_arg(record, ARG_LONG_LONG, (uint64_t)va_arg(args, long long));
+                break;
+            case 'j':
+                packed = record_push_arg(record, ARG_INTMAX, (uint64_t)va_arg(args, intmax_t));
+                break;
+            case 'z':
+                packed = record_push_arg(record, ARG_SIZE, (uint64_t)va_arg(args, size_t));
+                break;
+            case 't':
+                packed = record_push_arg(record, ARG_PTRDIFF, (uint64_t)va_arg(args, ptrdiff_t));
+                break;
+            default:
+                packed = false;
+                break;
+            }
+            break;
+        }
+        if (!packed)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Render one packed argument with its conversion specification.
+ */
+static int format_arg(char *out, size_t size, const char *spec, ErrorArgKind kind, uint64_t value, const char *text)
+{
+    double real;
+    switch (kind)
+    {
+    case ARG_INT:
+        return snprintf(out, size, spec, (int)(int64_t)value);
+    case ARG_LONG:
+        return snprintf(out, size, spec, (long)value);
+    case ARG_LONG_LONG:
+        return snprintf(out, size, spec, (long long)value);
+    case ARG_INTMAX:
+        return snprintf(out, size, spec, (intmax_t)value);
+    case ARG_SIZE:
+        return snprintf(out, size, spec, (size_t)value);
+    case ARG_PTRDIFF:
+        return snprintf(out, size, spec, (ptrdiff_t)value);
+    case ARG_DOUBLE:
+        memcpy(&real, &value, sizeof(real));
+        return snprintf(out, size, spec, real);
+    case ARG_LONG_DOUBLE:
+        memcpy(&real, &value, sizeof(real));
+        return snprintf(out, size, spec, (long double)real);
+    case ARG_POINTER:
+        return snprintf(out, size, spec, (void *)(uintptr_t)value);
+    case ARG_STRING:
+        return snprintf(out, size, spec, text + value);
+    }
+    return 0;
+}
+
+/**
+ * @brief Format a record's message, as vsnprintf would have at the time it was logged.
+ */
+static void record_format(const ErrorRecord *record, char *out, size_t size)
+{
+    if (!record->format)
+    {
+        snprintf(out, size, "%s", record->text);
+        return;
+    }
+
+    size_t used = 0;
+    size_t arg = 0;
+    const char *p = record->format;
+    while (*p && used + 1 < size)
+    {
+        if (*p != '%')
+        {
+            out[used++] = *p++;
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            out[used++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // Copy the specification, with any '*' replaced by its packed value
+        char spec[48];
+        size_t length = 0;
+        spec[length++] = *p++;
+        while (*p && !strchr(FORMAT_CONVERSIONS, *p) && length < sizeof(spec) - 16)
+        {
+            if (*p == '*')
+            {
+                length += snprintf(spec + length, sizeof(spec) - length, "%d", (int)(int64_t)record->args[arg++]);
+            }
+            else
+            {
+                spec[length++] = *p;
+            }
+            p++;
+        }
+        spec[length++] = *p++;
+        spec[length] = '\0';
+
+        int written = format_arg(out + used, size - used, spec, record->kinds[arg], record->args[arg], record->text);
+        arg++;
+        if (written > 0)
+        {
+            used += (size_t)written < size - used ? (size_t)written : size - used - 1;
+        }
+    }
+    out[used] = '\0';
+}
+
+static void record_to_context(const ErrorRecord *record, ErrorContext *context)
+{
+    context->code = record->code;
+    context->level = record->level;
+    context->file = record->file;
+    context->line = record->line;
+    context->function = record->function;
+    record_format(record, context->message, sizeof(context->message));
+
+    if (record->suppressed)
+    {
+        size_t used = strlen(context->message);
+        snprintf(context->message + used, sizeof(context->message) - used, " (%u more suppressed)", record->suppressed);
+    }
+}
+
+/**
+ * @brief Add a record to the error history without taking a lock.
+ *
+ * A writer that finds its slot still being written by a thread a whole ring
+ * behind, or already taken by a newer error, drops its record instead of
+ * waiting.
  *
- * @param context Pointer to the error context to be added.
+ * @param record Pointer to the record to be added.
  */
-static void add_to_error_history(const ErrorContext *context)
+static void add_to_error_history(const ErrorRecord *record)
 {
-    pthread_mutex_lock(&error_mutex);
+    uint64_t ticket = atomic_fetch_add_explicit(&error_history_head, 1, memory_order_relaxed);
+    ErrorHistorySlot *slot = &error_history[ticket & ERROR_HISTORY_MASK];
 
-    if (error_history_count < MAX_ERROR_QUEUE_SIZE)
+    uint64_t sequence = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+    do
+    {
+        if ((sequence & 1) || sequence > 2 * ticket)
+        {
+            atomic_fetch_add_explicit(&errors_dropped, 1, memory_order_relaxed);
+            return;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&slot->sequence, &sequence, 2 * ticket + 1, memory_order_acquire,
+                                                    memory_order_relaxed));
+
+    uint64_t words[ERROR_RECORD_WORDS];
+    memcpy(words, record, sizeof(words));
+    for (size_t i = 0; i < ERROR_RECORD_WORDS; i++)
     {
-        error_history_count++;
+        atomic_store_explicit(&slot->words[i], words[i], memory_order_relaxed);
     }
-    else
+    atomic_store_explicit(&slot->sequence, 2 * ticket + 2, memory_order_release);
+}
+
+/**
+ * @brief Read the error with the given ticket from the history; false if it is gone or incomplete.
+ */
+static bool read_from_error_history(uint64_t ticket, ErrorRecord *record)
+{
+    ErrorHistorySlot *slot = &error_history[ticket & ERROR_HISTORY_MASK];
+    uint64_t expected = 2 * ticket + 2;
+    if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != expected)
     {
-        error_history_start = (error_history_start + 1) % MAX_ERROR_QUEUE_SIZE;
+        return false;
     }
 
-    int index = (error_history_start + error_history_count - 1) % MAX_ERROR_QUEUE_SIZE;
-    memcpy(&error_history[index], context, sizeof(ErrorContext));
+    uint64_t words[ERROR_RECORD_WORDS];
+    for (size_t i = 0; i < ERROR_RECORD_WORDS; i++)
+    {
+        words[i] = atomic_load_explicit(&slot->words[i], memory_order_relaxed);
+    }
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&slot->sequence, memory_order_relaxed) != expected)
+    {
+        return false;
+    }
 
-    pthread_mutex_unlock(&error_mutex);
+    memcpy(record, words, sizeof(words));
+    return true;
+}
+
+/**
+ * @brief Count an error against its call site; false once the site is over its limit this second.
+ *
+ * A site whose slot was taken by another site starts its count afresh, so a
+ * collision can only let errors through, never hold them back.
+ *
+ * @param suppressed Set to the number of errors the site suppressed in the last second it was over its limit.
+ */
+static bool rate_limit_allow(const char *file, int line, uint32_t *suppressed)
+{
+    *suppressed = 0;
+    unsigned limit = atomic_load_explicit(&rate_limit, memory_order_relaxed);
+    if (limit == 0)
+    {
+        return true;
+    }
+
+    struct timespec now;
+    clock_gettime(RATE_LIMIT_CLOCK, &now);
+
+    // Call sites are told apart by the address of their file name and their line
+    uint64_t hash = ((uintptr_t)file ^ (uint64_t)line * 0x9e3779b97f4a7c15ULL) * 0xff51afd7ed558ccdULL;
+    _Atomic uint64_t *state = &rate_limit_sites[hash >> 56 & (RATE_LIMIT_SITES - 1)];
+    uint64_t window = ((uint64_t)(uint32_t)now.tv_sec << RATE_LIMIT_TAG_BITS | (hash & RATE_LIMIT_TAG_MASK))
+                      << RATE_LIMIT_COUNT_BITS;
+
+    uint64_t old = atomic_load_explicit(state, memory_order_relaxed);
+    uint64_t next;
+    do
+    {
+        uint64_t count = (old & ~RATE_LIMIT_COUNT_MASK) == window ? old & RATE_LIMIT_COUNT_MASK : 0;
+        next = window | (count < RATE_LIMIT_COUNT_MASK ? count + 1 : count);
+    } while (!atomic_compare_exchange_weak_explicit(state, &old, next, memory_order_relaxed, memory_order_relaxed));
+
+    // The first error of a new second reports what the site's previous second held back
+    bool same_site = (old >> RATE_LIMIT_COUNT_BITS & RATE_LIMIT_TAG_MASK) == (hash & RATE_LIMIT_TAG_MASK);
+    if ((next & RATE_LIMIT_COUNT_MASK) == 1 && same_site && (old & RATE_LIMIT_COUNT_MASK) > limit)
+    {
+        *suppressed = (uint32_t)((old & RATE_LIMIT_COUNT_MASK) - limit);
+    }
+    return (next & RATE_LIMIT_COUNT_MASK) <= limit;
 }
 
 void error_log(ErrorCode code, ErrorLevel level, const char *file, int line, const char *function, const char *format, ...)
 {
-    if (level < min_error_level)
+    if ((int)level < atomic_load_explicit(&min_error_level, memory_order_relaxed))
     {
         return;
     }
+    atomic_fetch_add_explicit(&errors_logged, 1, memory_order_relaxed);
+
+    // The record is built in place as the thread's last error
+    ErrorRecord *record = &tls_error_record;
+    record->code = code;
+    record->level = level;
+    record->file = file;
+    record->line = line;
+    record->function = function;
+    record->format = format;
+    record->arg_count = 0;
 
     va_list args;
     va_start(args, format);
-
-    ErrorContext context;
-    context.code = code;
-    context.level = level;
-    context.file = file;
-    context.line = line;
-    context.function = function;
-    vsnprintf(context.message, sizeof(context.message), format, args);
-
+    va_list packing;
+    va_copy(packing, args);
+    if (!record_pack(record, format, packing))
+    {
+        // Too many or unusual arguments: format now instead
+        record->format = NULL;
+        vsnprintf(record->text, sizeof(record->text), format, args);
+    }
+    va_end(packing);
     va_end(args);
 
-    // Store in thread-local storage
-    memcpy(&tls_error_context, &context, sizeof(ErrorContext));
+    bool allowed = rate_limit_allow(file, line, &record->suppressed);
+    tls_error_pending = true;
 
     // Add to error history
-    add_to_error_history(&context);
+    add_to_error_history(record);
+
+    if (!allowed)
+    {
+        atomic_fetch_add_explicit(&errors_suppressed, 1, memory_order_relaxed);
+        return;
+    }
+
+    // Someone will read this one, so format it now
+    ErrorContext context;
+    record_to_context(record, &context);
 
     // Call global error handler if set
-    if (global_error_handler)
+    ErrorHandler handler = atomic_load(&global_error_handler);
+    if (handler)
     {
-        global_error_handler(&context);
+        handler(&context);
     }
     else
     {
@@ -142,14 +596,54 @@ void error_log(ErrorCode code, ErrorLevel level, const char *file, int line, con
 
 const ErrorContext *error_get_last(void)
 {
+    if (tls_error_pending)
+    {
+        record_to_context(&tls_error_record, &tls_error_context);
+        tls_error_pending = false;
+    }
     return &tls_error_context;
 }
 
 void error_clear(void)
 {
+    tls_error_pending = false;
     memset(&tls_error_context, 0, sizeof(ErrorContext));
 }
 
+size_t error_get_history(ErrorContext *contexts, size_t capacity)
+{
+    if (!contexts)
+    {
+        return 0;
+    }
+
+    uint64_t head = atomic_load_explicit(&error_history_head, memory_order_acquire);
+    uint64_t available = head < LIMDY_ERROR_HISTORY_SIZE ? head : LIMDY_ERROR_HISTORY_SIZE;
+    uint64_t first = head - (capacity < available ? capacity : available);
+
+    size_t count = 0;
+    ErrorRecord record;
+    for (uint64_t ticket = first; ticket < head; ticket++)
+    {
+        if (read_from_error_history(ticket, &record))
+        {
+            record_to_context(&record, &contexts[count++]);
+        }
+    }
+    return count;
+}
+
+void error_get_stats(ErrorStats *stats)
+{
+    if (!stats)
+    {
+        return;
+    }
+    stats->logged = atomic_load(&errors_logged);
+    stats->suppressed = atomic_load(&errors_suppressed);
+    stats->dropped = atomic_load(&errors_dropped);
+}
+
 /**
  * @brief Get the string representation of an error level.
  *
@@ -0,0 +1,311 @@
+/**
+ * @file limdy_image.c
+ * @brief Implementation of read-only binary images.
+ *
+ * This file implements the interface defined in limdy_image.h. Writing goes
+ * through stdio into "<path>.tmp", padding between sections with zeros, and
+ * renames the result into place. Reading maps the file, checks the common
+ * header fields and then hands the header to the format's own check; every
+ * failure after the mapping unmaps it again.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-15
+ */
+
+#include "limdy_image.h"
+#include "limdy_utils.h"
+#include "memory_pool.h"
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define IMAGE_TEMPORARY_SUFFIX ".tmp"
+
+static uint32_t header_checksum(const LimdyImageHeader *header, size_t header_size)
+{
+    const unsigned char *data = (const unsigned char *)&header->file_size;
+    size_t length = header_size - offsetof(LimdyImageHeader, file_size);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Round an offset up to the next section boundary.
+ *
+ * @param offset The offset.
+ * @return The aligned offset.
+ */
+size_t limdy_image_align(size_t offset)
+{
+    return (offset + LIMDY_IMAGE_SECTION_ALIGNMENT - 1) & ~(size_t)(LIMDY_IMAGE_SECTION_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Check that a section of a validated header lies within the file.
+ *
+ * @param header The header.
+ * @param offset Offset of the section.
+ * @param count Number of records in the section.
+ * @param size Size of one record.
+ * @return True if the section is aligned, after the header and within the file.
+ */
+bool limdy_image_section_fits(const LimdyImageHeader *header, uint64_t offset, uint64_t count, size_t size)
+{
+    return offset % LIMDY_IMAGE_SECTION_ALIGNMENT == 0 && offset >= header->header_size && offset <= header->file_size &&
+           count <= (header->file_size - offset) / size;
+}
+
+/**
+ * @brief Check that a hash index section of a validated header is well formed.
+ *
+ * @param header The header.
+ * @param offset Offset of the index.
+ * @param capacity Number of slots; a power of two.
+ * @param count Number of records indexed, less than the capacity.
+ * @return True if the index fits in the file and leaves a free slot.
+ */
+bool limdy_image_index_fits(const LimdyImageHeader *header, uint64_t offset, uint64_t capacity, uint64_t count)
+{
+    return limdy_image_section_fits(header, offset, capacity, sizeof(LimdyImageIndexEntry)) && capacity != 0 &&
+           (capacity & (capacity - 1)) == 0 && count < capacity;
+}
+
+/**
+ * @brief Lay out the hash index of records that each start with their 64-bit hash.
+ *
+ * @param records The records.
+ * @param count Number of records.
+ * @param record_size Size of one record.
+ * @param capacity Pointer to store the capacity.
+ * @return The index, to be freed with limdy_memory_pool_free(), or NULL on failure.
+ */
+LimdyImageIndexEntry *limdy_image_build_index(const void *records, size_t count, size_t record_size, size_t *capacity)
+{
+    if (!capacity || (count > 0 && !records))
+    {
+        LOG_ERROR(ERROR_NULL_POINTER, "Null pointer passed to limdy_image_build_index");
+        return NULL;
+    }
+
+    size_t index_capacity = LIMDY_IMAGE_MIN_INDEX_CAPACITY;
+    while (index_capacity < count * 2 + 1)
+    {
+        index_capacity *= 2;
+    }
+    LimdyImageIndexEntry *index = limdy_memory_pool_alloc(index_capacity * sizeof(LimdyImageIndexEntry));
+    if (!index)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate image index");
+        return NULL;
+    }
+    memset(index, 0, index_capacity * sizeof(LimdyImageIndexEntry));
+
+    size_t mask = index_capacity - 1;
+    for (size_t i = 0; i < count; i++)
+    {
+        uint64_t hash;
+        memcpy(&hash, (const char *)records + i * record_size, sizeof(hash));
+        size_t position = hash & mask;
+        while (index[position].record != 0)
+        {
+            position = (position + 1) & mask;
+        }
+        index[position].hash = hash;
+        index[position].record = i + 1;
+    }
+
+    *capacity = index_capacity;
+    return index;
+}
+
+// Writes a section at its offset, padding from the current position
+static bool write_section(FILE *file, size_t *position, size_t offset, const void *data, size_t size)
+{
+    static const char padding[LIMDY_IMAGE_SECTION_ALIGNMENT] = {0};
+    if (offset < *position || offset - *position > sizeof(padding) ||
+        fwrite(padding, 1, offset - *position, file) != offset - *position)
+    {
+        return false;
+    }
+    *position = offset + size;
+    return size == 0 || fwrite(data, 1, size, file) == size;
+}
+
+/**
+ * @brief Write an image, replacing any file at the path.
+ *
+ * @param format The image format.
+ * @param path Path of the image file.
+ * @param header The full header, with the format's own fields set.
+ * @param sections Sections in increasing offset order.
+ * @param section_count Number of sections.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_image_write(const LimdyImageFormat *format, const char *path, LimdyImageHeader *header,
+                            const LimdyImageSection *sections, size_t section_count)
+{
+    CHECK_NULL(format, ERROR_NULL_POINTER);
+    CHECK_NULL(path, ERROR_NULL_POINTER);
+    CHECK_NULL(header, ERROR_NULL_POINTER);
+    if (section_count > 0)
+    {
+        CHECK_NULL(sections, ERROR_NULL_POINTER);
+    }
+
+    memcpy(header->magic, format->magic, LIMDY_IMAGE_MAGIC_SIZE);
+    header->version = format->version;
+    header->header_size = (uint32_t)format->header_size;
+    header->reserved = 0;
+    header->file_size = section_count > 0 ? sections[section_count - 1].offset + sections[section_count - 1].size
+                                          : format->header_size;
+    header->checksum = header_checksum(header, format->header_size);
+
+    size_t path_length = strlen(path);
+    char *temporary_path = limdy_memory_pool_alloc(path_length + sizeof(IMAGE_TEMPORARY_SUFFIX));
+    if (!temporary_path)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate %s file path", format->name);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    memcpy(temporary_path, path, path_length);
+    memcpy(temporary_path + path_length, IMAGE_TEMPORARY_SUFFIX, sizeof(IMAGE_TEMPORARY_SUFFIX));
+
+    FILE *file = fopen(temporary_path, "wb");
+    bool written = file != NULL;
+    size_t position = 0;
+    written = written && write_section(file, &position, 0, header, format->header_size);
+    for (size_t i = 0; i < section_count && written; i++)
+    {
+        written = write_section(file, &position, sections[i].offset, sections[i].data, sections[i].size);
+    }
+    if (file && fclose(file) != 0)
+    {
+        written = false;
+    }
+
+    ErrorCode error = ERROR_SUCCESS;
+    if (!written || rename(temporary_path, path) != 0)
+    {
+        remove(temporary_path);
+        error = ERROR_FILE_IO;
+        LOG_ERROR(error, "Failed to write %s %s", format->name, path);
+    }
+    limdy_memory_pool_free(temporary_path);
+    return error;
+}
+
+static ErrorCode validate_header(const LimdyImageFormat *format, const LimdyImageHeader *header, size_t file_size)
+{
+    if (memcmp(header->magic, format->magic, LIMDY_IMAGE_MAGIC_SIZE) != 0)
+    {
+        return format->error_bad_format;
+    }
+    if (header->version != format->version)
+    {
+        return format->error_version;
+    }
+    if (header->header_size != format->header_size || header->checksum != header_checksum(header, format->header_size) ||
+        header->file_size != file_size)
+    {
+        return format->error_bad_format;
+    }
+    return format->header_valid(header) ? ERROR_SUCCESS : format->error_bad_format;
+}
+
+/**
+ * @brief Map an image for reading and validate its header.
+ *
+ * @param format The image format.
+ * @param path Path of the image file.
+ * @param image The image to fill.
+ * @return ErrorCode indicating success or failure; the format's error codes for a bad file.
+ */
+ErrorCode limdy_image_map(const LimdyImageFormat *format, const char *path, LimdyImage *image)
+{
+    CHECK_NULL(format, ERROR_NULL_POINTER);
+    CHECK_NULL(path, ERROR_NULL_POINTER);
+    CHECK_NULL(image, ERROR_NULL_POINTER);
+
+    int fd = open(path, O_RDONLY);
+    struct stat status;
+    if (fd < 0 || fstat(fd, &status) != 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        LOG_ERROR(ERROR_FILE_IO, "Failed to open %s %s", format->name, path);
+        return ERROR_FILE_IO;
+    }
+    if ((size_t)status.st_size < format->header_size)
+    {
+        close(fd);
+        LOG_ERROR(format->error_bad_format, "The %s %s is truncated", format->name, path);
+        return format->error_bad_format;
+    }
+
+    size_t size = (size_t)status.st_size;
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        LOG_ERROR(ERROR_FILE_IO, "Failed to map %s %s", format->name, path);
+        return ERROR_FILE_IO;
+    }
+
+    ErrorCode error = validate_header(format, mapping, size);
+    if (error != ERROR_SUCCESS)
+    {
+        munmap(mapping, size);
+        LOG_ERROR(error, error == format->error_version ? "The %s %s has an unsupported version" : "The %s %s is damaged",
+                  format->name, path);
+        return error;
+    }
+
+    image->mapping = mapping;
+    image->size = size;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Unmap an image.
+ *
+ * @param image The image, or NULL.
+ */
+void limdy_image_unmap(LimdyImage *image)
+{
+    if (!image || !image->mapping)
+    {
+        return;
+    }
+    munmap(image->mapping, image->size);
+    image->mapping = NULL;
+    image->size = 0;
+}
+
+/**
+ * @brief Advise the kernel that part of a mapped image is about to be read.
+ *
+ * @param image The image.
+ * @param offset Offset of the range.
+ * @param size Size of the range in bytes.
+ */
+void limdy_image_will_need(const LimdyImage *image, uint64_t offset, size_t size)
+{
+    if (!image || !image->mapping || size == 0)
+    {
+        return;
+    }
+    // madvise wants a page-aligned start; the mapping itself is page aligned
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t start = (size_t)offset & ~(page - 1);
+    madvise((char *)image->mapping + start, (size_t)offset + size - start, MADV_WILLNEED);
+}
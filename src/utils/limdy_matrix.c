@@ -0,0 +1,140 @@
+/**
+ * @file limdy_matrix.c
+ * @brief Implementation of the dense row-major matrix.
+ *
+ * This file implements the interface defined in limdy_matrix.h. Owned
+ * storage comes from the C library's aligned allocator so matrices can be
+ * handed between services without going through a particular pool.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include "limdy_matrix.h"
+#include "limdy_utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <malloc.h>
+#define MATRIX_ALIGNED_FREE(ptr) _aligned_free(ptr)
+#else
+#define MATRIX_ALIGNED_FREE(ptr) free(ptr)
+#endif
+
+/**
+ * @brief Allocates aligned storage, or returns NULL on failure.
+ */
+static void *matrix_aligned_alloc(size_t size)
+{
+#ifdef _WIN32
+    return _aligned_malloc(size, LIMDY_MATRIX_ALIGNMENT);
+#else
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, LIMDY_MATRIX_ALIGNMENT, size) != 0)
+    {
+        return NULL;
+    }
+    return ptr;
+#endif
+}
+
+size_t limdy_matrix_stride(size_t cols)
+{
+    return LIMDY_ALIGN_UP(cols, LIMDY_MATRIX_ALIGNMENT / sizeof(float));
+}
+
+size_t limdy_matrix_bytes(size_t rows, size_t cols)
+{
+    return rows * limdy_matrix_stride(cols) * sizeof(float);
+}
+
+ErrorCode limdy_matrix_init(LimdyMatrix *matrix, size_t rows, size_t cols)
+{
+    CHECK_NULL(matrix, ERROR_NULL_POINTER);
+
+    memset(matrix, 0, sizeof(LimdyMatrix));
+
+    size_t bytes = limdy_matrix_bytes(rows, cols);
+    if (bytes > 0)
+    {
+        matrix->data = matrix_aligned_alloc(bytes);
+        if (!matrix->data)
+        {
+            LOG_ERROR(LIMDY_MATRIX_ERROR_ALLOC_FAILED, "Failed to allocate %zu x %zu matrix", rows, cols);
+            return LIMDY_MATRIX_ERROR_ALLOC_FAILED;
+        }
+        memset(matrix->data, 0, bytes);
+    }
+
+    matrix->rows = rows;
+    matrix->cols = cols;
+    matrix->stride = limdy_matrix_stride(cols);
+    matrix->owned = matrix->data != NULL;
+
+    return ERROR_SUCCESS;
+}
+
+ErrorCode limdy_matrix_wrap(LimdyMatrix *matrix, size_t rows, size_t cols, void *storage)
+{
+    CHECK_NULL(matrix, ERROR_NULL_POINTER);
+    CHECK_NULL(storage, ERROR_NULL_POINTER);
+
+    if ((uintptr_t)storage % LIMDY_MATRIX_ALIGNMENT != 0)
+    {
+        LOG_ERROR(LIMDY_MATRIX_ERROR_MISALIGNED, "Matrix storage is not %d-byte aligned", LIMDY_MATRIX_ALIGNMENT);
+        return LIMDY_MATRIX_ERROR_MISALIGNED;
+    }
+
+    matrix->data = storage;
+    matrix->rows = rows;
+    matrix->cols = cols;
+    matrix->stride = limdy_matrix_stride(cols);
+    matrix->owned = false;
+
+    return ERROR_SUCCESS;
+}
+
+void limdy_matrix_free(LimdyMatrix *matrix)
+{
+    if (!matrix)
+    {
+        return;
+    }
+
+    if (matrix->owned)
+    {
+        MATRIX_ALIGNED_FREE(matrix->data);
+    }
+    memset(matrix, 0, sizeof(LimdyMatrix));
+}
+
+ErrorCode limdy_matrix_copy_from_rows(LimdyMatrix *matrix, float *const *rows_in)
+{
+    CHECK_NULL(matrix, ERROR_NULL_POINTER);
+    CHECK_NULL(rows_in, ERROR_NULL_POINTER);
+
+    for (size_t i = 0; i < matrix->rows; i++)
+    {
+        float *row = limdy_matrix_row(matrix, i);
+        memcpy(row, rows_in[i], matrix->cols * sizeof(float));
+        // Keep the padding deterministic so kernels may read whole strides
+        memset(row + matrix->cols, 0, (matrix->stride - matrix->cols) * sizeof(float));
+    }
+
+    return ERROR_SUCCESS;
+}
+
+ErrorCode limdy_matrix_row_pointers(const LimdyMatrix *matrix, float **row_pointers)
+{
+    CHECK_NULL(matrix, ERROR_NULL_POINTER);
+    CHECK_NULL(row_pointers, ERROR_NULL_POINTER);
+
+    for (size_t i = 0; i < matrix->rows; i++)
+    {
+        row_pointers[i] = limdy_matrix_row(matrix, i);
+    }
+
+    return ERROR_SUCCESS;
+}
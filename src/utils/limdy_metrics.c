@@ -0,0 +1,403 @@
+/**
+ * @file limdy_metrics.c
+ * @brief Implementation of the metrics and tracing surface for the Limdy project.
+ *
+ * Each thread owns a block of counters, histograms and a span ring. Only
+ * the owner writes a block, with relaxed loads and stores, so recording
+ * never contends; readers merge every block on the global list. A block is
+ * released, not freed, when its thread exits and is taken over by the next
+ * new thread, so totals and spans outlive the threads that made them.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include "limdy_metrics.h"
+#include "limdy_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SIZE_CLASS_SUFFIXES(prefix)                                               \
+    prefix "16", prefix "32", prefix "64", prefix "128", prefix "256", prefix "512", \
+        prefix "1k", prefix "2k", prefix "4k", prefix "8k", prefix "16k", prefix "32k", \
+        prefix "64k", prefix "128k", prefix "256k", prefix "large"
+
+static const char *const counter_names[LIMDY_COUNTER_COUNT] = {
+    SIZE_CLASS_SUFFIXES("allocations."),
+    SIZE_CLASS_SUFFIXES("allocation_failures."),
+    "frees",
+    "pool.fragmented_failures",
+    "render_cache.hits",
+    "render_cache.misses",
+    "render_cache.evictions"};
+
+static const char *const histogram_names[LIMDY_HISTOGRAM_COUNT] = {
+    SIZE_CLASS_SUFFIXES("allocation_ns."),
+    "map.probe_groups",
+    "stage.tokenize_ns",
+    "stage.classify_ns",
+    "stage.extract_ns",
+    "stage.translate_ns",
+    "stage.align_ns",
+    "startup.cold_ns",
+    "startup.warm_ns"};
+
+const char *limdy_counter_name(LimdyCounter counter)
+{
+    return (unsigned)counter < LIMDY_COUNTER_COUNT ? counter_names[counter] : "unknown";
+}
+
+const char *limdy_histogram_name(LimdyHistogram histogram)
+{
+    return (unsigned)histogram < LIMDY_HISTOGRAM_COUNT ? histogram_names[histogram] : "unknown";
+}
+
+uint64_t limdy_histogram_percentile(const LimdyHistogramSnapshot *histogram, double percentile)
+{
+    if (!histogram || histogram->count == 0)
+    {
+        return 0;
+    }
+    if (percentile < 0.0)
+    {
+        percentile = 0.0;
+    }
+    if (percentile > 100.0)
+    {
+        percentile = 100.0;
+    }
+
+    // Rank of the value, counted from 1
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)histogram->count + 0.999999);
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < LIMDY_METRICS_HISTOGRAM_BUCKETS; bucket++)
+    {
+        seen += histogram->buckets[bucket];
+        if (seen >= rank)
+        {
+            uint64_t upper = bucket == 0 ? 0 : bucket == 64 ? UINT64_MAX : (1ULL << bucket) - 1;
+            return upper < histogram->max ? upper : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+#ifdef LIMDY_METRICS
+
+typedef struct
+{
+    _Atomic uint64_t count;
+    _Atomic uint64_t sum;
+    _Atomic uint64_t max;
+    _Atomic uint64_t buckets[LIMDY_METRICS_HISTOGRAM_BUCKETS];
+} ThreadHistogram;
+
+typedef struct
+{
+    _Atomic(const char *) name;
+    _Atomic uint64_t start_ns;
+    _Atomic uint64_t duration_ns;
+} TraceEvent;
+
+typedef struct ThreadMetrics
+{
+    struct ThreadMetrics *next;
+    atomic_bool in_use;
+    unsigned thread_id; // Trace tid; kept by a block's later owners
+    _Atomic uint64_t counters[LIMDY_COUNTER_COUNT];
+    ThreadHistogram histograms[LIMDY_HISTOGRAM_COUNT];
+    _Atomic uint64_t trace_head; // Spans ever recorded
+    _Atomic(TraceEvent *) events; // Allocated when the thread first records a span
+} ThreadMetrics;
+
+static pthread_mutex_t metrics_mutex = PTHREAD_MUTEX_INITIALIZER;
+static _Atomic(ThreadMetrics *) metrics_head = NULL;
+static unsigned metrics_threads = 0;
+static atomic_bool trace_enabled = false;
+
+static __thread ThreadMetrics *thread_metrics = NULL;
+static __thread bool thread_metrics_torn_down = false;
+static pthread_key_t thread_metrics_key;
+static pthread_once_t thread_metrics_once = PTHREAD_ONCE_INIT;
+
+static void thread_metrics_release(void *block)
+{
+    // TLS destructors that run later, such as one freeing scratch to the pool, may still record; once the
+    // block is released they must neither write to it nor take one over
+    thread_metrics = NULL;
+    thread_metrics_torn_down = true;
+    atomic_store_explicit(&((ThreadMetrics *)block)->in_use, false, memory_order_release);
+}
+
+static void thread_metrics_key_init(void)
+{
+    pthread_key_create(&thread_metrics_key, thread_metrics_release);
+}
+
+/**
+ * @brief Get the calling thread's block, taking over a released one or creating it.
+ *
+ * @return The block, or NULL on allocation failure or once the thread has released its block, in which
+ *         case nothing is recorded.
+ */
+static ThreadMetrics *thread_metrics_get(void)
+{
+    if (thread_metrics)
+    {
+        return thread_metrics;
+    }
+    if (thread_metrics_torn_down)
+    {
+        return NULL;
+    }
+
+    pthread_once(&thread_metrics_once, thread_metrics_key_init);
+
+    pthread_mutex_lock(&metrics_mutex);
+    ThreadMetrics *block = atomic_load_explicit(&metrics_head, memory_order_relaxed);
+    while (block && atomic_load_explicit(&block->in_use, memory_order_acquire))
+    {
+        block = block->next;
+    }
+    if (block)
+    {
+        atomic_store_explicit(&block->in_use, true, memory_order_relaxed);
+    }
+    else if ((block = calloc(1, sizeof(ThreadMetrics))) != NULL)
+    {
+        atomic_init(&block->in_use, true);
+        block->thread_id = ++metrics_threads;
+        block->next = atomic_load_explicit(&metrics_head, memory_order_relaxed);
+        atomic_store_explicit(&metrics_head, block, memory_order_release);
+    }
+    pthread_mutex_unlock(&metrics_mutex);
+
+    if (block)
+    {
+        thread_metrics = block;
+        pthread_setspecific(thread_metrics_key, block);
+    }
+    return block;
+}
+
+// Single-writer add: only the owning thread updates its block
+static inline void owner_add(_Atomic uint64_t *value, uint64_t delta)
+{
+    atomic_store_explicit(value, atomic_load_explicit(value, memory_order_relaxed) + delta, memory_order_relaxed);
+}
+
+static inline size_t histogram_bucket(uint64_t value)
+{
+    return value == 0 ? 0 : 64 - (size_t)__builtin_clzll(value);
+}
+
+uint64_t limdy_metrics_now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+void limdy_metrics_count(LimdyCounter counter, uint64_t delta)
+{
+    ThreadMetrics *block = thread_metrics_get();
+    if (block && (unsigned)counter < LIMDY_COUNTER_COUNT)
+    {
+        owner_add(&block->counters[counter], delta);
+    }
+}
+
+void limdy_metrics_record(LimdyHistogram histogram, uint64_t value)
+{
+    ThreadMetrics *block = thread_metrics_get();
+    if (!block || (unsigned)histogram >= LIMDY_HISTOGRAM_COUNT)
+    {
+        return;
+    }
+
+    ThreadHistogram *target = &block->histograms[histogram];
+    owner_add(&target->count, 1);
+    owner_add(&target->sum, value);
+    owner_add(&target->buckets[histogram_bucket(value)], 1);
+    if (value > atomic_load_explicit(&target->max, memory_order_relaxed))
+    {
+        atomic_store_explicit(&target->max, value, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Append a span to the calling thread's ring.
+ */
+static void trace_record(const char *name, uint64_t start_ns, uint64_t duration_ns)
+{
+    ThreadMetrics *block = thread_metrics_get();
+    if (!block)
+    {
+        return;
+    }
+
+    TraceEvent *events = atomic_load_explicit(&block->events, memory_order_relaxed);
+    if (!events)
+    {
+        events = calloc(LIMDY_TRACE_EVENTS_PER_THREAD, sizeof(TraceEvent));
+        if (!events)
+        {
+            return;
+        }
+        atomic_store_explicit(&block->events, events, memory_order_release);
+    }
+
+    uint64_t head = atomic_load_explicit(&block->trace_head, memory_order_relaxed);
+    TraceEvent *event = &events[head % LIMDY_TRACE_EVENTS_PER_THREAD];
+    atomic_store_explicit(&event->name, name, memory_order_relaxed);
+    atomic_store_explicit(&event->start_ns, start_ns, memory_order_relaxed);
+    atomic_store_explicit(&event->duration_ns, duration_ns, memory_order_relaxed);
+    atomic_store_explicit(&block->trace_head, head + 1, memory_order_release);
+}
+
+void limdy_metrics_record_since(LimdyHistogram histogram, uint64_t start_ns)
+{
+    uint64_t now = limdy_metrics_now_ns();
+    uint64_t elapsed = now > start_ns ? now - start_ns : 0;
+    limdy_metrics_record(histogram, elapsed);
+
+    // Stages become spans; allocations are too many to trace
+    if (histogram >= LIMDY_HISTOGRAM_TOKENIZE_NS && atomic_load_explicit(&trace_enabled, memory_order_relaxed))
+    {
+        trace_record(limdy_histogram_name(histogram), start_ns, elapsed);
+    }
+}
+
+void limdy_metrics_snapshot(LimdyMetricsSnapshot *snapshot)
+{
+    if (!snapshot)
+    {
+        return;
+    }
+    memset(snapshot, 0, sizeof(*snapshot));
+
+    for (ThreadMetrics *block = atomic_load_explicit(&metrics_head, memory_order_acquire); block; block = block->next)
+    {
+        for (size_t i = 0; i < LIMDY_COUNTER_COUNT; i++)
+        {
+            snapshot->counters[i] += atomic_load_explicit(&block->counters[i], memory_order_relaxed);
+        }
+        for (size_t i = 0; i < LIMDY_HISTOGRAM_COUNT; i++)
+        {
+            ThreadHistogram *source = &block->histograms[i];
+            LimdyHistogramSnapshot *target = &snapshot->histograms[i];
+            target->count += atomic_load_explicit(&source->count, memory_order_relaxed);
+            target->sum += atomic_load_explicit(&source->sum, memory_order_relaxed);
+            uint64_t max = atomic_load_explicit(&source->max, memory_order_relaxed);
+            if (max > target->max)
+            {
+                target->max = max;
+            }
+            for (size_t b = 0; b < LIMDY_METRICS_HISTOGRAM_BUCKETS; b++)
+            {
+                target->buckets[b] += atomic_load_explicit(&source->buckets[b], memory_order_relaxed);
+            }
+        }
+    }
+}
+
+void limdy_metrics_reset(void)
+{
+    for (ThreadMetrics *block = atomic_load_explicit(&metrics_head, memory_order_acquire); block; block = block->next)
+    {
+        for (size_t i = 0; i < LIMDY_COUNTER_COUNT; i++)
+        {
+            atomic_store_explicit(&block->counters[i], 0, memory_order_relaxed);
+        }
+        for (size_t i = 0; i < LIMDY_HISTOGRAM_COUNT; i++)
+        {
+            ThreadHistogram *histogram = &block->histograms[i];
+            atomic_store_explicit(&histogram->count, 0, memory_order_relaxed);
+            atomic_store_explicit(&histogram->sum, 0, memory_order_relaxed);
+            atomic_store_explicit(&histogram->max, 0, memory_order_relaxed);
+            for (size_t b = 0; b < LIMDY_METRICS_HISTOGRAM_BUCKETS; b++)
+            {
+                atomic_store_explicit(&histogram->buckets[b], 0, memory_order_relaxed);
+            }
+        }
+    }
+}
+
+void limdy_trace_enable(bool enabled)
+{
+    atomic_store_explicit(&trace_enabled, enabled, memory_order_relaxed);
+}
+
+uint64_t limdy_trace_begin(void)
+{
+    return atomic_load_explicit(&trace_enabled, memory_order_relaxed) ? limdy_metrics_now_ns() : 0;
+}
+
+void limdy_trace_end(const char *name, uint64_t start_ns)
+{
+    // Spans begun while tracing was off have no start
+    if (start_ns == 0 || !atomic_load_explicit(&trace_enabled, memory_order_relaxed))
+    {
+        return;
+    }
+    uint64_t now = limdy_metrics_now_ns();
+    trace_record(name, start_ns, now > start_ns ? now - start_ns : 0);
+}
+
+ErrorCode limdy_trace_write_chrome_json(const char *path)
+{
+    CHECK_NULL(path, ERROR_NULL_POINTER);
+
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+        LOG_ERROR(ERROR_FILE_IO, "Failed to open trace file %s", path);
+        return ERROR_FILE_IO;
+    }
+
+    int pid = (int)getpid();
+    bool first = true;
+    fputs("{\"traceEvents\":[", file);
+    for (ThreadMetrics *block = atomic_load_explicit(&metrics_head, memory_order_acquire); block; block = block->next)
+    {
+        TraceEvent *events = atomic_load_explicit(&block->events, memory_order_acquire);
+        if (!events)
+        {
+            continue;
+        }
+
+        uint64_t head = atomic_load_explicit(&block->trace_head, memory_order_acquire);
+        uint64_t begin = head > LIMDY_TRACE_EVENTS_PER_THREAD ? head - LIMDY_TRACE_EVENTS_PER_THREAD : 0;
+        for (uint64_t i = begin; i < head; i++)
+        {
+            TraceEvent *event = &events[i % LIMDY_TRACE_EVENTS_PER_THREAD];
+            const char *name = atomic_load_explicit(&event->name, memory_order_relaxed);
+            uint64_t start_ns = atomic_load_explicit(&event->start_ns, memory_order_relaxed);
+            uint64_t duration_ns = atomic_load_explicit(&event->duration_ns, memory_order_relaxed);
+
+            // Names are expected to need no JSON escaping
+            fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%u}",
+                    first ? "" : ",", name ? name : "unknown", start_ns / 1000.0, duration_ns / 1000.0, pid, block->thread_id);
+            first = false;
+        }
+    }
+    fputs("\n],\"displayTimeUnit\":\"ns\"}\n", file);
+
+    if (fclose(file) != 0)
+    {
+        LOG_ERROR(ERROR_FILE_IO, "Failed to write trace file %s", path);
+        return ERROR_FILE_IO;
+    }
+    return ERROR_SUCCESS;
+}
+
+#endif // LIMDY_METRICS
@@ -14,18 +14,170 @@
 #include "memory_pool.h"
 #include "limdy_utils.h"
 #include "rbtree.h"
+#include "limdy_metrics.h"
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <stdatomic.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 
 #ifdef _WIN32
 #define ALIGNED_ALLOC(alignment, size) _aligned_malloc(size, alignment)
 #define ALIGNED_FREE(ptr) _aligned_free(ptr)
 #else
-#define ALIGNED_ALLOC(alignment, size) ({ void *ptr; posix_memalign(&ptr, alignment, size); ptr; })
+#define ALIGNED_ALLOC(alignment, size) ({ void *ptr; if (posix_memalign(&ptr, alignment, size) != 0) ptr = NULL; ptr; })
 #define ALIGNED_FREE(ptr) free(ptr)
 #endif
 
+#ifdef __linux__
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#define MAP_HUGE_2MB_FLAG (21 << MAP_HUGE_SHIFT) // log2(LIMDY_HUGE_PAGE_SIZE)
+#define NUMA_MPOL_PREFERRED 1                  // MPOL_PREFERRED from <numaif.h>, which is not always installed
+#endif
+
+/**
+ * @brief Address bits covered by the owner map and how they are split.
+ *
+ * The map has one entry per LIMDY_SLAB_SPAN_SIZE granule of address space.
+ */
+#define OWNER_MAP_ADDRESS_BITS 48
+#define OWNER_MAP_SHIFT 16 // log2(LIMDY_SLAB_SPAN_SIZE)
+#define OWNER_MAP_LEAF_BITS 16
+#define OWNER_MAP_ROOT_BITS (OWNER_MAP_ADDRESS_BITS - OWNER_MAP_SHIFT - OWNER_MAP_LEAF_BITS)
+
+/**
+ * @brief Owner map entry encoding.
+ *
+ * Zero means the granule is not ours, odd values encode a slab size class and
+ * even values are the owning LimdyMemoryPool pointer.
+ */
+#define OWNER_NONE ((uintptr_t)0)
+#define OWNER_SLAB(index) (((uintptr_t)(index) << 1) | 1)
+#define OWNER_IS_SLAB(entry) (((entry) & 1) != 0)
+#define OWNER_SLAB_INDEX(entry) ((int)((entry) >> 1))
+#define OWNER_POOL(pool) ((uintptr_t)(pool))
+
+/**
+ * @brief The shared pools serving limdy_memory_pool_alloc on one NUMA node.
+ */
+typedef struct
+{
+    LimdyMemoryPool *small_pools[LIMDY_MAX_POOLS];
+    LimdyMemoryPool *large_pool;
+    size_t num_small_pools;
+    LimdyRBTree size_index;      // Small pools by size, for best-fit searches
+    pthread_rwlock_t index_lock; // Read to allocate from the set, written to remove a pool from it
+    int node;                    // Index in node_pools the set was created for
+} LimdyNodePools;
+
+/**
+ * @brief Pool set per node, published once complete and read without locking.
+ *
+ * Nodes whose set could not be created point at home_pools.
+ */
+static _Atomic(LimdyNodePools *) node_pools[LIMDY_MAX_NUMA_NODES];
+static LimdyNodePools *home_pools;     // The set created by limdy_memory_pool_init
+static LimdyMemoryPool *created_pools; // Pools handed out by limdy_memory_pool_create
+static pthread_mutex_t global_mutex = PTHREAD_MUTEX_INITIALIZER;
+static LimdyMemoryPoolConfig global_config;
+static LimdySlabAllocator slab_allocator;
+
+// Size index order: by capacity, then by address so equal-sized pools stay distinct
+static int compare_pool_size(const LimdyRBNode *a, const LimdyRBNode *b)
+{
+    const LimdyMemoryPool *pool_a = LIMDY_RB_ENTRY(a, LimdyMemoryPool, size_node);
+    const LimdyMemoryPool *pool_b = LIMDY_RB_ENTRY(b, LimdyMemoryPool, size_node);
+    if (pool_a->total_size != pool_b->total_size)
+    {
+        return pool_a->total_size < pool_b->total_size ? -1 : 1;
+    }
+    return (pool_a > pool_b) - (pool_a < pool_b);
+}
+
+// Key is a const size_t *; the first pool ordered at or after it is the best fit
+static int compare_size_key(const void *key, const LimdyRBNode *node)
+{
+    size_t size = *(const size_t *)key;
+    size_t total_size = LIMDY_RB_ENTRY(node, LimdyMemoryPool, size_node)->total_size;
+    return (size > total_size) - (size < total_size);
+}
+
+static int compare_pool_address(const LimdyRBNode *a, const LimdyRBNode *b)
+{
+    uintptr_t memory_a = (uintptr_t)LIMDY_RB_ENTRY(a, LimdyMemoryPool, address_node)->memory;
+    uintptr_t memory_b = (uintptr_t)LIMDY_RB_ENTRY(b, LimdyMemoryPool, address_node)->memory;
+    return (memory_a > memory_b) - (memory_a < memory_b);
+}
+
+// Key is the address itself; the last pool starting at or before it is the only candidate owner
+static int compare_address_key(const void *key, const LimdyRBNode *node)
+{
+    uintptr_t address = (uintptr_t)key;
+    uintptr_t memory = (uintptr_t)LIMDY_RB_ENTRY(node, LimdyMemoryPool, address_node)->memory;
+    return (address > memory) - (address < memory);
+}
+
+/**
+ * @brief Every live pool by address range, guarded by address_index_mutex.
+ */
+static LimdyRBTree address_index = {NULL, 0, compare_pool_address};
+static pthread_mutex_t address_index_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Two-level radix map from address granule to the pool or slab class owning it.
+ *
+ * Leaves are only ever added (under owner_map_mutex) and are read without
+ * locking, which makes free and realloc a constant-time lookup.
+ */
+static _Atomic(_Atomic uintptr_t *) owner_map[1 << OWNER_MAP_ROOT_BITS];
+static pthread_mutex_t owner_map_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Per-thread stack of free objects for one slab size class.
+ */
+typedef struct
+{
+    void *objects[LIMDY_THREAD_CACHE_CAPACITY];
+    size_t count;
+} LimdySlabMagazine;
+
+/**
+ * @brief Per-thread cache sitting in front of the shared slab allocator.
+ */
+typedef struct
+{
+    LimdySlabMagazine magazines[LIMDY_SLAB_SIZES];
+    unsigned generation; /**< Slab generation the cached objects belong to */
+    bool registered;     /**< Whether the thread-exit hook has been armed */
+    int numa_node;       /**< NUMA node of the thread plus one, or 0 until looked up */
+} LimdyThreadCache;
+
+static __thread LimdyThreadCache thread_cache;
+static pthread_key_t thread_cache_key;
+static pthread_once_t thread_cache_key_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Bumped whenever the slab allocator is torn down, invalidating every thread cache.
+ */
+static atomic_uint slab_generation = 1;
+
+static void init_slab_allocator(void);
+static void cleanup_slab_allocator(void);
+static void *slab_alloc(size_t size);
+static void slab_free(void *ptr, int slab_index);
+static uintptr_t owner_map_lookup(const void *ptr);
+static ErrorCode owner_map_set(void *start, size_t size, uintptr_t entry);
+static void owner_map_clear(void);
+static size_t page_size(void);
+
 static void error_fatal(ErrorCode code, const char *file, int line, const char *function, const char *format, ...)
 {
     va_list args;
@@ -44,570 +196,1697 @@ static void verify_block_magic(struct MemoryBlock *block)
 }
 
 /**
- * @brief Creates a new memory pool.
- *
- * @param pool_size The size of the new pool to create.
- * @param new_pool Pointer to store the newly created pool.
- * @return ErrorCode indicating success or failure.
+ * @brief Blocks below this size map linearly onto the second-level bins of bin zero.
  */
-static ErrorCode create_pool(size_t pool_size, LimdyMemoryPool **new_pool)
-{
-    *new_pool = (LimdyMemoryPool *)malloc(sizeof(LimdyMemoryPool));
-    if (!*new_pool)
-    {
-        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INIT_FAILED, "Failed to allocate memory for pool structure");
-        return LIMDY_MEMORY_POOL_ERROR_INIT_FAILED;
-    }
+#define POOL_SMALL_BLOCK (LIMDY_POOL_SL_COUNT * LIMDY_MEMORY_ALIGNMENT)
+#define POOL_SMALL_BLOCK_LOG2 (LIMDY_POOL_SL_BITS + 4) // log2(POOL_SMALL_BLOCK)
 
-    (*new_pool)->memory = ALIGNED_ALLOC(LIMDY_MEMORY_ALIGNMENT, pool_size);
-    if (!(*new_pool)->memory)
-    {
-        free(*new_pool);
-        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INIT_FAILED, "Failed to allocate memory for pool");
-        return LIMDY_MEMORY_POOL_ERROR_INIT_FAILED;
-    }
+#define POOL_EXACT_BIN_PROBES 8 // Bounded fallback scan when only the request's own bin is left
 
-    (*new_pool)->total_size = pool_size;
-    (*new_pool)->used_size = 0;
-    (*new_pool)->free_list = (struct MemoryBlock *)(*new_pool)->memory;
-    (*new_pool)->free_list->magic = MEMORY_BLOCK_MAGIC;
-    (*new_pool)->free_list->size = pool_size - sizeof(struct MemoryBlock);
-    (*new_pool)->free_list->in_use = 0;
-    (*new_pool)->free_list->next = NULL;
-    (*new_pool)->free_list->prev = NULL;
+// A free block keeps its bin links in the first two words of its data. The data is uintptr_t storage,
+// so the links are copied in and out rather than read through a cast pointer, which strict aliasing forbids.
+static inline struct MemoryBlock *block_next_free(const struct MemoryBlock *block)
+{
+    struct MemoryBlock *next;
+    memcpy(&next, &block->data[0], sizeof(next));
+    return next;
+}
 
-    if (pthread_mutex_init(&(*new_pool)->mutex, NULL) != 0)
-    {
-        ALIGNED_FREE((*new_pool)->memory);
-        free(*new_pool);
-        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INIT_FAILED, "Failed to initialize mutex for pool");
-        return LIMDY_MEMORY_POOL_ERROR_INIT_FAILED;
-    }
+static inline struct MemoryBlock *block_prev_free(const struct MemoryBlock *block)
+{
+    struct MemoryBlock *prev;
+    memcpy(&prev, &block->data[1], sizeof(prev));
+    return prev;
+}
 
-    // Initialize the reader-writer lock
-    if (pthread_rwlock_init(&(*new_pool)->rwlock, NULL) != 0)
-    {
-        ALIGNED_FREE((*new_pool)->memory);
-        free(*new_pool);
-        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INIT_FAILED, "Failed to initialize rwlock for pool");
-        return LIMDY_MEMORY_POOL_ERROR_INIT_FAILED;
-    }
+static inline void block_set_next_free(struct MemoryBlock *block, struct MemoryBlock *next)
+{
+    memcpy(&block->data[0], &next, sizeof(next));
+}
 
-    return ERROR_SUCCESS;
+static inline void block_set_prev_free(struct MemoryBlock *block, struct MemoryBlock *prev)
+{
+    memcpy(&block->data[1], &prev, sizeof(prev));
 }
 
 /**
- * @brief Initializes the memory pool system.
+ * @brief Maps a free block size onto its two-level bin.
  *
- * @param config Pointer to the configuration structure.
- * @return ErrorCode indicating success or failure.
+ * @param size Data size of the block.
+ * @param fl Pointer to store the first-level index.
+ * @param sl Pointer to store the second-level index.
  */
-ErrorCode limdy_memory_pool_init(const LimdyMemoryPoolConfig *config)
+static void bin_index(size_t size, int *fl, int *sl)
 {
-    if (!config)
+    if (size < POOL_SMALL_BLOCK)
     {
-        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Invalid configuration");
-        return ERROR_INVALID_ARGUMENT;
+        *fl = 0;
+        *sl = (int)(size / LIMDY_MEMORY_ALIGNMENT);
+        return;
     }
 
-    global_config = *config;
-
-    ErrorCode error = create_pool(config->large_pool_size, &large_pool);
-    if (error != ERROR_SUCCESS)
+    int msb = 63 - __builtin_clzll((unsigned long long)size);
+    *fl = msb - POOL_SMALL_BLOCK_LOG2 + 1;
+    *sl = (int)((size >> (msb - LIMDY_POOL_SL_BITS)) ^ LIMDY_POOL_SL_COUNT);
+    if (*fl >= LIMDY_POOL_FL_COUNT)
     {
-        return error;
+        *fl = LIMDY_POOL_FL_COUNT - 1;
+        *sl = LIMDY_POOL_SL_COUNT - 1;
     }
+}
 
-    error = limdy_rbtree_init(&pool_rbtree);
-    if (error != ERROR_SUCCESS)
-    {
-        limdy_memory_pool_cleanup();
-        return error;
-    }
+/**
+ * @brief Adds a free block to the head of its bin.
+ *
+ * @param pool Pointer to the owning pool.
+ * @param block The free block.
+ */
+static void bin_insert(LimdyMemoryPool *pool, struct MemoryBlock *block)
+{
+    int fl, sl;
+    bin_index(block->size, &fl, &sl);
 
-    for (size_t i = 0; i < config->max_pools && i < LIMDY_MAX_POOLS; i++)
+    block_set_prev_free(block, NULL);
+    block_set_next_free(block, pool->bins[fl][sl]);
+    if (pool->bins[fl][sl])
     {
-        error = create_pool(config->small_pool_size, &small_pools[i]);
-        if (error != ERROR_SUCCESS)
-        {
-            limdy_memory_pool_cleanup();
-            return error;
-        }
-        error = limdy_rbtree_insert(&pool_rbtree, small_pools[i]);
-        if (error != ERROR_SUCCESS)
-        {
-            limdy_memory_pool_cleanup();
-            return error;
-        }
-        num_small_pools++;
+        block_set_prev_free(pool->bins[fl][sl], block);
     }
-
-    // Initialize the slab allocator
-    init_slab_allocator();
-
-    return ERROR_SUCCESS;
+    pool->bins[fl][sl] = block;
+    pool->fl_bitmap |= 1u << fl;
+    pool->sl_bitmap[fl] |= 1u << sl;
 }
 
 /**
- * @brief Cleans up the memory pool system.
+ * @brief Unlinks a free block from its bin.
+ *
+ * @param pool Pointer to the owning pool.
+ * @param block The free block.
  */
-void limdy_memory_pool_cleanup(void)
+static void bin_remove(LimdyMemoryPool *pool, struct MemoryBlock *block)
 {
-    for (size_t i = 0; i < num_small_pools; i++)
+    int fl, sl;
+    bin_index(block->size, &fl, &sl);
+
+    struct MemoryBlock *next = block_next_free(block);
+    struct MemoryBlock *prev = block_prev_free(block);
+    if (next)
     {
-        if (small_pools[i])
-        {
-            ALIGNED_FREE(small_pools[i]->memory);
-            pthread_mutex_destroy(&small_pools[i]->mutex);
-            pthread_rwlock_destroy(&small_pools[i]->rwlock); // Destroy the reader-writer lock
-            free(small_pools[i]);
-            small_pools[i] = NULL;
-        }
+        block_set_prev_free(next, prev);
     }
-    num_small_pools = 0;
-
-    if (large_pool)
+    if (prev)
     {
-        ALIGNED_FREE(large_pool->memory);
-        pthread_mutex_destroy(&large_pool->mutex);
-        pthread_rwlock_destroy(&large_pool->rwlock); // Destroy the reader-writer lock
-        free(large_pool);
-        large_pool = NULL;
+        block_set_next_free(prev, next);
     }
-
-    limdy_rbtree_destroy(&pool_rbtree);
-
-    // Cleanup the slab allocator
-    for (int i = 0; i < LIMDY_SLAB_SIZES; i++)
+    else
     {
-        if (slab_allocator.slabs[i])
+        pool->bins[fl][sl] = next;
+        if (!next)
         {
-            ALIGNED_FREE(slab_allocator.slabs[i]);
-            slab_allocator.slabs[i] = NULL;
+            pool->sl_bitmap[fl] &= ~(1u << sl);
+            if (!pool->sl_bitmap[fl])
+            {
+                pool->fl_bitmap &= ~(1u << fl);
+            }
         }
     }
-    pthread_mutex_destroy(&slab_allocator.mutex);
 }
 
 /**
- * @brief Allocates memory from a specific pool.
+ * @brief Finds a free block of at least size bytes in constant time.
  *
- * @param pool Pointer to the pool to allocate from.
- * @param size The number of bytes to allocate.
- * @return A pointer to the allocated memory, or NULL if allocation fails.
+ * The request is rounded up to the next bin boundary so that the head of
+ * any non-empty bin found by the bitmaps is guaranteed to fit.
+ *
+ * @param pool Pointer to the pool.
+ * @param size Aligned number of bytes needed.
+ * @return A free block still linked into its bin, or NULL if none fits.
  */
-static void *allocate_from_pool(LimdyMemoryPool *pool, size_t size)
+static struct MemoryBlock *bin_find(LimdyMemoryPool *pool, size_t size)
 {
-    MUTEX_LOCK(&pool->mutex);
+    size_t rounded = size;
+    if (rounded >= POOL_SMALL_BLOCK)
+    {
+        int msb = 63 - __builtin_clzll((unsigned long long)rounded);
+        rounded += ((size_t)1 << (msb - LIMDY_POOL_SL_BITS)) - 1;
+    }
 
-    struct MemoryBlock *block = pool->free_list;
-    struct MemoryBlock *prev = NULL;
+    int fl, sl;
+    bin_index(rounded, &fl, &sl);
 
-    while (block)
+    uint32_t sl_map = pool->sl_bitmap[fl] & (~0u << sl);
+    if (!sl_map)
     {
-        verify_block_magic(block);
-        if (!block->in_use && block->size >= size)
+        uint32_t fl_map = fl + 1 < LIMDY_POOL_FL_COUNT ? pool->fl_bitmap & (~0u << (fl + 1)) : 0;
+        if (!fl_map)
         {
-            if (block->size >= size + MIN_BLOCK_SIZE)
+            // Nothing bigger is free; a few blocks in the request's own bin may still fit
+            bin_index(size, &fl, &sl);
+            struct MemoryBlock *block = pool->bins[fl][sl];
+            for (int i = 0; block && i < POOL_EXACT_BIN_PROBES; i++, block = block_next_free(block))
             {
-                struct MemoryBlock *new_block = (struct MemoryBlock *)((char *)block + sizeof(struct MemoryBlock) + size);
-                new_block->magic = MEMORY_BLOCK_MAGIC;
-                new_block->size = block->size - size - sizeof(struct MemoryBlock);
-                new_block->in_use = 0;
-                new_block->next = block->next;
-                new_block->prev = block;
-                if (block->next)
+                if (block->size >= size)
                 {
-                    block->next->prev = new_block;
+                    return block;
                 }
-                block->next = new_block;
-                block->size = size;
             }
-
-            block->in_use = 1;
-            pool->used_size += block->size + sizeof(struct MemoryBlock);
-
-            MUTEX_UNLOCK(&pool->mutex);
-            return block->data;
+            return NULL;
         }
-
-        prev = block;
-        block = block->next;
+        fl = __builtin_ctz(fl_map);
+        sl_map = pool->sl_bitmap[fl];
     }
+    sl = __builtin_ctz(sl_map);
 
-    MUTEX_UNLOCK(&pool->mutex);
-    LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_ALLOC_FAILED, "Failed to allocate memory from pool");
-    return NULL;
+    struct MemoryBlock *block = pool->bins[fl][sl];
+    // Only the last, open-ended bin can hold blocks smaller than its range start
+    while (block && block->size < size)
+    {
+        block = block_next_free(block);
+    }
+    return block;
 }
 
 /**
- * @brief Allocates memory from the pool.
+ * @brief NUMA node the calling thread runs on.
  *
- * @param size The number of bytes to allocate.
- * @return A pointer to the allocated memory, or NULL if allocation fails.
+ * Looked up once per thread; the scheduler rarely moves a thread off its node.
+ *
+ * @return The node, or -1 if unknown.
  */
-void *limdy_memory_pool_alloc(size_t size)
+static int thread_numa_node(void)
 {
-    size = ALIGN_SIZE(size, LIMDY_MEMORY_ALIGNMENT);
+    if (thread_cache.numa_node == 0)
+    {
+        int node = -1;
+#if defined(__linux__) && defined(SYS_getcpu)
+        unsigned cpu = 0;
+        unsigned found = 0;
+        if (syscall(SYS_getcpu, &cpu, &found, NULL) == 0)
+        {
+            node = (int)found;
+        }
+#endif
+        thread_cache.numa_node = node + 1;
+    }
+    return thread_cache.numa_node - 1;
+}
 
-    // Try allocating from the slab allocator first
-    if (size <= LIMDY_SLAB_MAX_SIZE)
+/**
+ * @brief Maps pool memory with the configured pages, preferring a NUMA node.
+ *
+ * Explicit huge pages fall back to transparent ones when none are reserved.
+ * The node is a preference, not a binding, so a full node spills over to
+ * others instead of failing; a kernel without NUMA support ignores it.
+ *
+ * @param size Bytes to map, a multiple of LIMDY_HUGE_PAGE_SIZE for huge pages.
+ * @param huge Whether to back the memory with huge pages.
+ * @param node Node to place the memory on, or -1.
+ * @return The memory, aligned to at least LIMDY_SLAB_SPAN_SIZE, or NULL.
+ */
+static void *map_pool_memory(size_t size, bool huge, int node)
+{
+#ifdef __linux__
+    void *memory = MAP_FAILED;
+    if (global_config.page_mode == LIMDY_POOL_PAGES_EXPLICIT_HUGE)
     {
-        void *ptr = slab_alloc(size);
-        if (ptr)
+        // Huge-page mappings come aligned to the huge page size
+        memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB_FLAG, -1, 0);
+        if (memory == MAP_FAILED)
         {
-            return ptr;
+            LOG_WARNING(LIMDY_MEMORY_POOL_ERROR_INIT_FAILED, "No explicit huge pages free, using transparent huge pages");
         }
     }
 
-    LimdyMemoryPool *suitable_pool = limdy_rbtree_find_best_fit(&pool_rbtree, size);
-    if (suitable_pool)
+    if (memory == MAP_FAILED)
     {
-        void *ptr = allocate_from_pool(suitable_pool, size);
-        if (ptr)
+        // Over-map so the pool can start on an aligned address
+        size_t alignment = huge ? LIMDY_HUGE_PAGE_SIZE : LIMDY_SLAB_SPAN_SIZE;
+        char *raw = mmap(NULL, size + alignment, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
         {
-            return ptr;
+            return NULL;
+        }
+        char *aligned = (char *)ALIGN_SIZE((uintptr_t)raw, alignment);
+        if (aligned > raw)
+        {
+            munmap(raw, (size_t)(aligned - raw));
         }
+        munmap(aligned + size, (size_t)(raw + alignment - aligned));
+        memory = aligned;
+#ifdef MADV_HUGEPAGE
+        if (huge)
+        {
+            madvise(memory, size, MADV_HUGEPAGE);
+        }
+#endif
     }
 
-    return allocate_from_pool(large_pool, size);
+#ifdef SYS_mbind
+    if (node >= 0 && node < (int)(sizeof(unsigned long) * 8))
+    {
+        // Nothing is touched yet, so every page faults in on the preferred node
+        unsigned long mask = 1UL << node;
+        syscall(SYS_mbind, memory, size, NUMA_MPOL_PREFERRED, &mask, sizeof(mask) * 8 + 1, 0);
+    }
+#endif
+    return memory;
+#else
+    (void)size;
+    (void)huge;
+    (void)node;
+    return NULL;
+#endif
 }
 
 /**
- * @brief Finds the pool that contains the given pointer.
+ * @brief Frees pool memory from map_pool_memory or the aligned allocator.
  *
- * @param ptr Pointer to search for.
- * @return Pointer to the pool containing the pointer, or NULL if not found.
+ * @param memory The pool memory.
+ * @param mapped_size Bytes mapped, or 0 if the memory came from the aligned allocator.
  */
-static LimdyMemoryPool *find_pool(void *ptr)
+static void free_pool_memory(void *memory, size_t mapped_size)
 {
-    LimdyMemoryPool *pool = limdy_rbtree_find_best_fit(&pool_rbtree, (size_t)ptr);
-    if (pool && limdy_memory_pool_contains(pool, ptr))
-    {
-        return pool;
-    }
-
-    if (limdy_memory_pool_contains(large_pool, ptr))
+#ifndef _WIN32
+    if (mapped_size)
     {
-        return large_pool;
+        munmap(memory, mapped_size);
+        return;
     }
-
-    return NULL;
+#endif
+    ALIGNED_FREE(memory);
 }
 
 /**
- * @brief Frees memory back to the pool.
+ * @brief Creates a new memory pool.
  *
- * @param ptr Pointer to the memory to be freed.
+ * Pool memory is aligned to the owner map granule so every granule it covers
+ * can be attributed to this pool alone. Huge-page pools are rounded up to a
+ * whole number of huge pages and release free memory in huge pages, so
+ * trimming never splits one.
+ *
+ * @param pool_size The size of the new pool to create.
+ * @param new_pool Pointer to store the newly created pool.
+ * @return ErrorCode indicating success or failure.
  */
-void limdy_memory_pool_free(void *ptr)
+static ErrorCode create_pool(size_t pool_size, LimdyMemoryPool **new_pool)
 {
-    if (!ptr)
+    *new_pool = (LimdyMemoryPool *)malloc(sizeof(LimdyMemoryPool));
+    if (!*new_pool)
     {
-        return;
+        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INIT_FAILED, "Failed to allocate memory for pool structure");
+        return LIMDY_MEMORY_POOL_ERROR_INIT_FAILED;
     }
 
-    // Check if the pointer belongs to the slab allocator (inside the mutex lock)
-    MUTEX_LOCK(&slab_allocator.mutex);
-    for (int i = 0; i < LIMDY_SLAB_SIZES; i++)
+    bool huge = global_config.page_mode != LIMDY_POOL_PAGES_DEFAULT;
+    int node = global_config.numa_local ? thread_numa_node() : -1;
+    if (huge)
     {
-        if (slab_allocator.slabs[i] && ptr >= slab_allocator.slabs[i] &&
-            ptr < (char *)slab_allocator.slabs[i] + slab_allocator.slab_sizes[i] * global_config.slab_objects_per_slab)
-        {
-            slab_free(ptr, slab_allocator.slab_sizes[i]);
-            MUTEX_UNLOCK(&slab_allocator.mutex);
-            return;
-        }
+        pool_size = ALIGN_SIZE(pool_size, LIMDY_HUGE_PAGE_SIZE);
     }
-    MUTEX_UNLOCK(&slab_allocator.mutex);
 
-    LimdyMemoryPool *pool = find_pool(ptr);
-    if (!pool)
+    (*new_pool)->memory = NULL;
+    (*new_pool)->mapped_size = 0;
+    if (huge || node >= 0)
     {
-        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INVALID_FREE, "Attempt to free memory not allocated by pool");
-        return;
+        (*new_pool)->memory = map_pool_memory(ALIGN_SIZE(pool_size, LIMDY_SLAB_SPAN_SIZE), huge, node);
+        (*new_pool)->mapped_size = (*new_pool)->memory ? ALIGN_SIZE(pool_size, LIMDY_SLAB_SPAN_SIZE) : 0;
+    }
+    if (!(*new_pool)->memory)
+    {
+        (*new_pool)->memory = ALIGNED_ALLOC(LIMDY_SLAB_SPAN_SIZE, ALIGN_SIZE(pool_size, LIMDY_SLAB_SPAN_SIZE));
+    }
+    if (!(*new_pool)->memory)
+    {
+        free(*new_pool);
+        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INIT_FAILED, "Failed to allocate memory for pool");
+        return LIMDY_MEMORY_POOL_ERROR_INIT_FAILED;
     }
+    (*new_pool)->numa_node = (*new_pool)->mapped_size ? node : -1;
+    (*new_pool)->page_size = huge && (*new_pool)->mapped_size ? LIMDY_HUGE_PAGE_SIZE : page_size();
 
-    MUTEX_LOCK(&pool->mutex);
+    (*new_pool)->total_size = pool_size;
+    (*new_pool)->used_size = 0;
+    (*new_pool)->free_list = (struct MemoryBlock *)(*new_pool)->memory;
+    (*new_pool)->free_list->magic = MEMORY_BLOCK_MAGIC;
+    (*new_pool)->free_list->size = pool_size - sizeof(struct MemoryBlock);
+    (*new_pool)->free_list->in_use = 0;
+    (*new_pool)->free_list->next = NULL;
+    (*new_pool)->free_list->prev = NULL;
 
-    struct MemoryBlock *block = (struct MemoryBlock *)((char *)ptr - sizeof(struct MemoryBlock));
-    verify_block_magic(block);
-    assert(block->in_use);
-    block->in_use = 0;
-    pool->used_size -= block->size + sizeof(struct MemoryBlock);
+    (*new_pool)->fl_bitmap = 0;
+    memset((*new_pool)->sl_bitmap, 0, sizeof((*new_pool)->sl_bitmap));
+    memset((*new_pool)->bins, 0, sizeof((*new_pool)->bins));
+    bin_insert(*new_pool, (*new_pool)->free_list);
+    (*new_pool)->trim_ratio = LIMDY_POOL_TRIM_RATIO_DEFAULT;
+    (*new_pool)->frees_until_trim = LIMDY_POOL_TRIM_INTERVAL;
 
-    // Coalesce with previous block if it's free
-    if (block->prev && !block->prev->in_use)
+    if (pthread_mutex_init(&(*new_pool)->mutex, NULL) != 0)
     {
-        block->prev->size += block->size + sizeof(struct MemoryBlock);
-        block->prev->next = block->next;
-        if (block->next)
+        free_pool_memory((*new_pool)->memory, (*new_pool)->mapped_size);
+        free(*new_pool);
+        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INIT_FAILED, "Failed to initialize mutex for pool");
+        return LIMDY_MEMORY_POOL_ERROR_INIT_FAILED;
+    }
+
+    // Initialize the reader-writer lock
+    if (pthread_rwlock_init(&(*new_pool)->rwlock, NULL) != 0)
+    {
+        pthread_mutex_destroy(&(*new_pool)->mutex);
+        free_pool_memory((*new_pool)->memory, (*new_pool)->mapped_size);
+        free(*new_pool);
+        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INIT_FAILED, "Failed to initialize rwlock for pool");
+        return LIMDY_MEMORY_POOL_ERROR_INIT_FAILED;
+    }
+
+    if (owner_map_set((*new_pool)->memory, ALIGN_SIZE(pool_size, LIMDY_SLAB_SPAN_SIZE), OWNER_POOL(*new_pool)) != ERROR_SUCCESS)
+    {
+        owner_map_set((*new_pool)->memory, ALIGN_SIZE(pool_size, LIMDY_SLAB_SPAN_SIZE), OWNER_NONE);
+        pthread_rwlock_destroy(&(*new_pool)->rwlock);
+        pthread_mutex_destroy(&(*new_pool)->mutex);
+        free_pool_memory((*new_pool)->memory, (*new_pool)->mapped_size);
+        free(*new_pool);
+        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INIT_FAILED, "Failed to register pool in owner map");
+        return LIMDY_MEMORY_POOL_ERROR_INIT_FAILED;
+    }
+
+    limdy_rbtree_node_clear(&(*new_pool)->size_node);
+    limdy_rbtree_node_clear(&(*new_pool)->address_node);
+    pthread_mutex_lock(&address_index_mutex);
+    limdy_rbtree_insert(&address_index, &(*new_pool)->address_node);
+    pthread_mutex_unlock(&address_index_mutex);
+
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Releases a pool's memory, locks and owner map entries.
+ *
+ * @param pool Pointer to the pool to release.
+ */
+static void release_pool(LimdyMemoryPool *pool)
+{
+    pthread_mutex_lock(&address_index_mutex);
+    limdy_rbtree_remove(&address_index, &pool->address_node);
+    pthread_mutex_unlock(&address_index_mutex);
+    owner_map_set(pool->memory, ALIGN_SIZE(pool->total_size, LIMDY_SLAB_SPAN_SIZE), OWNER_NONE);
+    free_pool_memory(pool->memory, pool->mapped_size);
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_rwlock_destroy(&pool->rwlock); // Destroy the reader-writer lock
+    free(pool);
+}
+
+/**
+ * @brief Removes a pool from the list of pools made by limdy_memory_pool_create.
+ *
+ * Must be called with the global mutex held.
+ *
+ * @param pool Pointer to the pool to unlink.
+ */
+static void unlink_created_pool(LimdyMemoryPool *pool)
+{
+    if (pool->prev_created)
+    {
+        pool->prev_created->next_created = pool->next_created;
+    }
+    else
+    {
+        created_pools = pool->next_created;
+    }
+    if (pool->next_created)
+    {
+        pool->next_created->prev_created = pool->prev_created;
+    }
+}
+
+/**
+ * @brief Releases a pool set and every pool in it.
+ *
+ * @param pools Pointer to the set to release.
+ */
+static void release_node_pools(LimdyNodePools *pools)
+{
+    limdy_rbtree_destroy(&pools->size_index);
+    for (size_t i = 0; i < pools->num_small_pools; i++)
+    {
+        if (pools->small_pools[i])
         {
-            block->next->prev = block->prev;
+            release_pool(pools->small_pools[i]);
         }
-        block = block->prev;
     }
+    if (pools->large_pool)
+    {
+        release_pool(pools->large_pool);
+    }
+    pthread_rwlock_destroy(&pools->index_lock);
+    free(pools);
+}
 
-    // Coalesce with next block if it's free
-    if (block->next && !block->next->in_use)
+/**
+ * @brief Creates the shared pools for one node from the global configuration.
+ *
+ * The pools are placed on the node of the calling thread.
+ *
+ * @param node Index of the set in node_pools.
+ * @param new_pools Pointer to store the new set.
+ * @return ErrorCode indicating success or failure.
+ */
+static ErrorCode create_node_pools(int node, LimdyNodePools **new_pools)
+{
+    LimdyNodePools *pools = calloc(1, sizeof(LimdyNodePools));
+    if (!pools)
     {
-        block->size += block->next->size + sizeof(struct MemoryBlock);
-        block->next = block->next->next;
+        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INIT_FAILED, "Failed to allocate memory for pool set");
+        return LIMDY_MEMORY_POOL_ERROR_INIT_FAILED;
+    }
+    if (pthread_rwlock_init(&pools->index_lock, NULL) != 0)
+    {
+        free(pools);
+        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INIT_FAILED, "Failed to initialize rwlock for pool set");
+        return LIMDY_MEMORY_POOL_ERROR_INIT_FAILED;
+    }
+    pools->node = node;
+
+    ErrorCode error = create_pool(global_config.large_pool_size, &pools->large_pool);
+    if (error == ERROR_SUCCESS)
+    {
+        error = limdy_rbtree_init(&pools->size_index, compare_pool_size);
+    }
+
+    for (size_t i = 0; error == ERROR_SUCCESS && i < global_config.max_pools && i < LIMDY_MAX_POOLS; i++)
+    {
+        error = create_pool(global_config.small_pool_size, &pools->small_pools[i]);
+        if (error == ERROR_SUCCESS)
+        {
+            pools->num_small_pools++;
+            error = limdy_rbtree_insert(&pools->size_index, &pools->small_pools[i]->size_node);
+        }
+    }
+
+    if (error != ERROR_SUCCESS)
+    {
+        release_node_pools(pools);
+        return error;
+    }
+
+    *new_pools = pools;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Pool set serving the calling thread, created on the first allocation from a new node.
+ *
+ * @return The set, or NULL while the pool system is not initialized.
+ */
+static LimdyNodePools *local_node_pools(void)
+{
+    int node = global_config.numa_local ? thread_numa_node() : -1;
+    if (node < 0 || node >= LIMDY_MAX_NUMA_NODES)
+    {
+        return home_pools;
+    }
+
+    LimdyNodePools *pools = atomic_load_explicit(&node_pools[node], memory_order_acquire);
+    if (pools)
+    {
+        return pools;
+    }
+
+    pthread_mutex_lock(&global_mutex);
+    pools = atomic_load_explicit(&node_pools[node], memory_order_relaxed);
+    if (!pools && home_pools)
+    {
+        if (create_node_pools(node, &pools) != ERROR_SUCCESS)
+        {
+            // Share the home set rather than retrying on every allocation
+            pools = home_pools;
+        }
+        atomic_store_explicit(&node_pools[node], pools, memory_order_release);
+    }
+    pthread_mutex_unlock(&global_mutex);
+
+    return pools;
+}
+
+/**
+ * @brief Initializes the memory pool system.
+ *
+ * @param config Pointer to the configuration structure.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_memory_pool_init(const LimdyMemoryPoolConfig *config)
+{
+    if (!config)
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Invalid configuration");
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    global_config = *config;
+
+    init_slab_allocator();
+
+    int node = config->numa_local ? thread_numa_node() : 0;
+    if (node < 0 || node >= LIMDY_MAX_NUMA_NODES)
+    {
+        node = 0;
+    }
+
+    ErrorCode error = create_node_pools(node, &home_pools);
+    if (error != ERROR_SUCCESS)
+    {
+        limdy_memory_pool_cleanup();
+        return error;
+    }
+    atomic_store_explicit(&node_pools[node], home_pools, memory_order_release);
+
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Cleans up the memory pool system.
+ */
+void limdy_memory_pool_cleanup(void)
+{
+    for (int i = 0; i < LIMDY_MAX_NUMA_NODES; i++)
+    {
+        LimdyNodePools *pools = atomic_exchange_explicit(&node_pools[i], NULL, memory_order_relaxed);
+        if (pools && pools->node == i)
+        {
+            release_node_pools(pools);
+        }
+    }
+    home_pools = NULL;
+
+    while (created_pools)
+    {
+        LimdyMemoryPool *pool = created_pools;
+        created_pools = pool->next_created;
+        release_pool(pool);
+    }
+
+    cleanup_slab_allocator();
+    owner_map_clear();
+}
+
+/**
+ * @brief Allocates memory from a specific pool.
+ *
+ * @param pool Pointer to the pool to allocate from.
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the allocated memory, or NULL if allocation fails.
+ */
+static void *allocate_from_pool(LimdyMemoryPool *pool, size_t size)
+{
+    // Free blocks keep their bin links in the data area
+    if (size < LIMDY_MEMORY_ALIGNMENT)
+    {
+        size = LIMDY_MEMORY_ALIGNMENT;
+    }
+
+    MUTEX_LOCK(&pool->mutex);
+
+    struct MemoryBlock *block = bin_find(pool, size);
+    if (!block)
+    {
+        // Enough bytes are free, just not in one block
+        if (pool->total_size - pool->used_size >= size + sizeof(struct MemoryBlock))
+        {
+            LIMDY_METRIC_COUNT(LIMDY_COUNTER_POOL_FRAGMENTED_FAILURES, 1);
+        }
+        MUTEX_UNLOCK(&pool->mutex);
+        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_ALLOC_FAILED, "Failed to allocate memory from pool");
+        return NULL;
+    }
+
+    verify_block_magic(block);
+    bin_remove(pool, block);
+
+    if (block->size >= size + MIN_BLOCK_SIZE)
+    {
+        struct MemoryBlock *new_block = (struct MemoryBlock *)((char *)block + sizeof(struct MemoryBlock) + size);
+        new_block->magic = MEMORY_BLOCK_MAGIC;
+        new_block->size = block->size - size - sizeof(struct MemoryBlock);
+        new_block->in_use = 0;
+        new_block->next = block->next;
+        new_block->prev = block;
         if (block->next)
         {
-            block->next->prev = block;
+            block->next->prev = new_block;
+        }
+        block->next = new_block;
+        block->size = size;
+        bin_insert(pool, new_block);
+    }
+
+    block->in_use = 1;
+    pool->used_size += block->size + sizeof(struct MemoryBlock);
+
+    MUTEX_UNLOCK(&pool->mutex);
+    return block->data;
+}
+
+/**
+ * @brief Allocates an aligned size from the slabs, a best-fit pool or the large pool.
+ *
+ * The pools are those of the calling thread's node, with the large pool of
+ * the home set as the last resort.
+ *
+ * @param size The number of bytes to allocate, already aligned.
+ * @return A pointer to the allocated memory, or NULL if allocation fails.
+ */
+static void *allocate_aligned(size_t size)
+{
+    // Try allocating from the slab allocator first
+    if (size <= LIMDY_SLAB_MAX_SIZE)
+    {
+        void *ptr = slab_alloc(size);
+        if (ptr)
+        {
+            return ptr;
+        }
+    }
+
+    LimdyNodePools *pools = local_node_pools();
+    if (!pools)
+    {
+        return NULL;
+    }
+
+    // The read lock keeps limdy_memory_pool_destroy from taking a pool out of the set mid-search
+    void *ptr = NULL;
+    pthread_rwlock_rdlock(&pools->index_lock);
+    LimdyRBNode *best_fit = limdy_rbtree_lower_bound(&pools->size_index, &size, compare_size_key);
+    if (best_fit)
+    {
+        ptr = allocate_from_pool(LIMDY_RB_ENTRY(best_fit, LimdyMemoryPool, size_node), size);
+    }
+    if (!ptr && pools->large_pool)
+    {
+        ptr = allocate_from_pool(pools->large_pool, size);
+    }
+    pthread_rwlock_unlock(&pools->index_lock);
+
+    if (!ptr && pools != home_pools && home_pools)
+    {
+        // A node's own pools are full; memory from another node beats none
+        pthread_rwlock_rdlock(&home_pools->index_lock);
+        if (home_pools->large_pool)
+        {
+            ptr = allocate_from_pool(home_pools->large_pool, size);
         }
+        pthread_rwlock_unlock(&home_pools->index_lock);
+    }
+    return ptr;
+}
+
+/**
+ * @brief Allocates memory from the pool.
+ *
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the allocated memory, or NULL if allocation fails.
+ */
+void *limdy_memory_pool_alloc(size_t size)
+{
+    size = ALIGN_SIZE(size, LIMDY_MEMORY_ALIGNMENT);
+
+    LIMDY_METRIC_TIME_BEGIN(started);
+    void *ptr = allocate_aligned(size);
+    LIMDY_METRIC_TIME_END(started, LIMDY_HISTOGRAM_ALLOCATION_NS + limdy_metrics_size_class(size));
+    LIMDY_METRIC_COUNT((ptr ? LIMDY_COUNTER_ALLOCATIONS : LIMDY_COUNTER_ALLOCATION_FAILURES) + limdy_metrics_size_class(size), 1);
+
+    return ptr;
+}
+
+/**
+ * @brief Gets the system page size.
+ */
+static size_t page_size(void)
+{
+#ifdef _WIN32
+    return 4096;
+#else
+    static atomic_size_t cached = 0;
+    size_t size = atomic_load_explicit(&cached, memory_order_relaxed);
+    if (size == 0)
+    {
+        long queried = sysconf(_SC_PAGESIZE);
+        size = queried > 0 ? (size_t)queried : 4096;
+        atomic_store_explicit(&cached, size, memory_order_relaxed);
+    }
+    return size;
+#endif
+}
+
+/**
+ * @brief Returns the whole pages inside a free block to the operating system.
+ *
+ * The header and the bin links at the start of the data stay in place; must
+ * be called with the pool mutex held.
+ *
+ * @param block The free block.
+ * @param page Granule to release in, the page size of the pool.
+ * @return Number of bytes released.
+ */
+static size_t release_block_pages(struct MemoryBlock *block, size_t page)
+{
+#ifdef _WIN32
+    (void)block;
+    (void)page;
+    return 0;
+#else
+    uintptr_t start = ALIGN_SIZE((uintptr_t)(block->data + 2), page);
+    uintptr_t end = ((uintptr_t)block->data + block->size) & ~(uintptr_t)(page - 1);
+    if (end <= start || madvise((void *)start, end - start, MADV_DONTNEED) != 0)
+    {
+        return 0;
+    }
+    return end - start;
+#endif
+}
+
+/**
+ * @brief Counts the bytes of a pool backed by physical memory.
+ *
+ * @param pool Pointer to the pool.
+ * @return Resident bytes, or the pool's whole size if residency is unknown.
+ */
+static size_t pool_resident_size(const LimdyMemoryPool *pool)
+{
+    size_t page = page_size();
+    size_t pages = ALIGN_SIZE(pool->total_size, page) / page;
+#ifdef _WIN32
+    return pages * page;
+#else
+    unsigned char *vector = malloc(pages);
+    if (!vector || mincore(pool->memory, pages * page, vector) != 0)
+    {
+        free(vector);
+        return pages * page;
+    }
+    size_t resident = 0;
+    for (size_t i = 0; i < pages; i++)
+    {
+        resident += vector[i] & 1;
+    }
+    free(vector);
+    return resident * page;
+#endif
+}
+
+/**
+ * @brief Defragments a pool if its resident size has outgrown its live data by the trim ratio.
+ *
+ * @param pool Pointer to the pool.
+ */
+static void trim_if_needed(LimdyMemoryPool *pool)
+{
+    pthread_mutex_lock(&pool->mutex);
+    double ratio = pool->trim_ratio;
+    size_t used = pool->used_size;
+    pthread_mutex_unlock(&pool->mutex);
+
+    size_t page = page_size();
+    if (ratio > 0 && (double)pool_resident_size(pool) > ratio * (double)(used > page ? used : page))
+    {
+        limdy_memory_pool_defragment(pool);
+    }
+}
+
+/**
+ * @brief Frees a block back to the pool that owns it.
+ *
+ * @param pool Pointer to the owning pool.
+ * @param ptr Pointer to the memory to be freed.
+ */
+static void free_to_pool(LimdyMemoryPool *pool, void *ptr)
+{
+    MUTEX_LOCK(&pool->mutex);
+
+    struct MemoryBlock *block = (struct MemoryBlock *)((char *)ptr - sizeof(struct MemoryBlock));
+    verify_block_magic(block);
+    assert(block->in_use);
+    block->in_use = 0;
+    pool->used_size -= block->size + sizeof(struct MemoryBlock);
+
+    // Coalesce with previous block if it's free
+    if (block->prev && !block->prev->in_use)
+    {
+        bin_remove(pool, block->prev);
+        block->prev->size += block->size + sizeof(struct MemoryBlock);
+        block->prev->next = block->next;
+        if (block->next)
+        {
+            block->next->prev = block->prev;
+        }
+        block = block->prev;
+    }
+
+    // Coalesce with next block if it's free
+    if (block->next && !block->next->in_use)
+    {
+        bin_remove(pool, block->next);
+        block->size += block->next->size + sizeof(struct MemoryBlock);
+        block->next = block->next->next;
+        if (block->next)
+        {
+            block->next->prev = block;
+        }
+    }
+
+    bin_insert(pool, block);
+
+    bool check_trim = pool->trim_ratio > 0 && --pool->frees_until_trim == 0;
+    if (check_trim)
+    {
+        pool->frees_until_trim = LIMDY_POOL_TRIM_INTERVAL;
+    }
+
+    MUTEX_UNLOCK(&pool->mutex);
+
+    if (check_trim)
+    {
+        trim_if_needed(pool);
+    }
+}
+
+/**
+ * @brief Frees memory back to the pool.
+ *
+ * @param ptr Pointer to the memory to be freed.
+ */
+void limdy_memory_pool_free(void *ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+    LIMDY_METRIC_COUNT(LIMDY_COUNTER_FREES, 1);
+
+    // One owner map lookup tells slab objects and pool blocks apart
+    uintptr_t owner = owner_map_lookup(ptr);
+    if (owner == OWNER_NONE)
+    {
+        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INVALID_FREE, "Attempt to free memory not allocated by pool");
+        return;
+    }
+
+    if (OWNER_IS_SLAB(owner))
+    {
+        slab_free(ptr, OWNER_SLAB_INDEX(owner));
+        return;
+    }
+
+    free_to_pool((LimdyMemoryPool *)owner, ptr);
+}
+
+/**
+ * @brief Tries to grow a block in place by absorbing the free block after it.
+ *
+ * Must be called with the pool mutex held.
+ *
+ * @param pool Pointer to the owning pool.
+ * @param block The block to grow.
+ * @param new_size The aligned new size for the block.
+ * @return true if the block now holds at least new_size bytes, false otherwise.
+ */
+static bool extend_block_in_place(LimdyMemoryPool *pool, struct MemoryBlock *block, size_t new_size)
+{
+    if (!block->next || block->next->in_use ||
+        (block->size + sizeof(struct MemoryBlock) + block->next->size) < new_size)
+    {
+        return false;
+    }
+
+    size_t old_size = block->size;
+    size_t total_size = block->size + sizeof(struct MemoryBlock) + block->next->size;
+    bin_remove(pool, block->next);
+    if (total_size - new_size >= MIN_BLOCK_SIZE)
+    {
+        // The new header may land on top of the absorbed one
+        struct MemoryBlock *following = block->next->next;
+        struct MemoryBlock *new_block = (struct MemoryBlock *)((char *)block + sizeof(struct MemoryBlock) + new_size);
+        new_block->magic = MEMORY_BLOCK_MAGIC;
+        new_block->size = total_size - new_size - sizeof(struct MemoryBlock);
+        new_block->in_use = 0;
+        new_block->next = following;
+        new_block->prev = block;
+        if (new_block->next)
+        {
+            new_block->next->prev = new_block;
+        }
+        block->next = new_block;
+        block->size = new_size;
+        bin_insert(pool, new_block);
+    }
+    else
+    {
+        block->size = total_size;
+        block->next = block->next->next;
+        if (block->next)
+        {
+            block->next->prev = block;
+        }
+    }
+    pool->used_size += block->size - old_size;
+    return true;
+}
+
+/**
+ * @brief Size to give a block of old_size bytes growing to new_size.
+ *
+ * Growth by less than half the block is what piecemeal appends look like;
+ * those get half again as much, so the next appends fit without moving and
+ * a run of them costs amortized O(1). Larger jumps get what they ask for.
+ *
+ * @param old_size Current size of the block.
+ * @param new_size Requested size, already aligned.
+ * @return The size to extend or allocate to, at least new_size.
+ */
+static size_t realloc_growth_size(size_t old_size, size_t new_size)
+{
+    size_t geometric = ALIGN_SIZE(old_size + old_size / 2, LIMDY_MEMORY_ALIGNMENT);
+    return new_size < geometric ? geometric : new_size;
+}
+
+/**
+ * @brief Helper function to reallocate memory from a specific pool.
+ *
+ * Growth first absorbs the adjacent free block. The pool mutex is dropped
+ * before falling back to allocate-and-copy, so the new block may come from
+ * the same pool. Either way the block is over-allocated geometrically when
+ * it grows in small steps, settling for the exact size if that fails.
+ *
+ * @param pool Pointer to the pool owning ptr.
+ * @param ptr Pointer to the original memory block.
+ * @param new_size The new size for the memory block.
+ * @param stay_in_pool Whether a moved block must be allocated from the same pool.
+ * @return A pointer to the resized memory block, or NULL if reallocation fails.
+ */
+static void *realloc_from_pool(LimdyMemoryPool *pool, void *ptr, size_t new_size, bool stay_in_pool)
+{
+    MUTEX_LOCK(&pool->mutex);
+
+    struct MemoryBlock *block = (struct MemoryBlock *)((char *)ptr - sizeof(struct MemoryBlock));
+    verify_block_magic(block);
+    if (!block->in_use)
+    {
+        MUTEX_UNLOCK(&pool->mutex);
+        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INVALID_FREE, "Attempt to reallocate freed memory");
+        return NULL;
+    }
+
+    new_size = ALIGN_SIZE(new_size, LIMDY_MEMORY_ALIGNMENT);
+
+    size_t old_size = block->size;
+    size_t reserve_size = realloc_growth_size(old_size, new_size);
+    if (new_size <= old_size || extend_block_in_place(pool, block, reserve_size) ||
+        (reserve_size > new_size && extend_block_in_place(pool, block, new_size)))
+    {
+        MUTEX_UNLOCK(&pool->mutex);
+        return ptr;
+    }
+
+    MUTEX_UNLOCK(&pool->mutex);
+
+    // If extending isn't possible, allocate a new block and copy data
+    void *new_ptr = stay_in_pool ? allocate_from_pool(pool, reserve_size) : limdy_memory_pool_alloc(reserve_size);
+    if (!new_ptr && reserve_size > new_size)
+    {
+        new_ptr = stay_in_pool ? allocate_from_pool(pool, new_size) : limdy_memory_pool_alloc(new_size);
+    }
+    if (!new_ptr)
+    {
+        return NULL;
+    }
+
+    memcpy(new_ptr, ptr, old_size);
+    free_to_pool(pool, ptr);
+
+    return new_ptr;
+}
+
+/**
+ * @brief Resizes a slab object, moving it once it outgrows its size class.
+ *
+ * @param ptr Pointer to the slab object.
+ * @param slab_index The size class the object belongs to.
+ * @param new_size The new size for the memory block.
+ * @return A pointer to the resized memory block, or NULL if reallocation fails.
+ */
+static void *realloc_slab(void *ptr, int slab_index, size_t new_size)
+{
+    size_t old_size = slab_allocator.slab_sizes[slab_index];
+    if (new_size <= old_size)
+    {
+        return ptr;
+    }
+
+    void *new_ptr = limdy_memory_pool_alloc(new_size);
+    if (!new_ptr)
+    {
+        return NULL;
+    }
+
+    memcpy(new_ptr, ptr, old_size);
+    slab_free(ptr, slab_index);
+
+    return new_ptr;
+}
+
+/**
+ * @brief Resizes an existing allocation.
+ *
+ * @param ptr Pointer to the memory block to be resized.
+ * @param new_size The new size for the memory block.
+ * @return A pointer to the resized memory block, or NULL if reallocation fails.
+ */
+void *limdy_memory_pool_realloc(void *ptr, size_t new_size)
+{
+    if (!ptr)
+    {
+        return limdy_memory_pool_alloc(new_size);
+    }
+
+    if (new_size == 0)
+    {
+        limdy_memory_pool_free(ptr);
+        return NULL;
+    }
+
+    uintptr_t owner = owner_map_lookup(ptr);
+    if (owner == OWNER_NONE)
+    {
+        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INVALID_FREE, "Attempt to realloc memory not allocated by pool");
+        return NULL;
+    }
+
+    if (OWNER_IS_SLAB(owner))
+    {
+        return realloc_slab(ptr, OWNER_SLAB_INDEX(owner), new_size);
+    }
+
+    return realloc_from_pool((LimdyMemoryPool *)owner, ptr, new_size, false);
+}
+
+/**
+ * @brief Grows an array allocated from the pool to hold at least needed items.
+ *
+ * @param array Pointer to the array, which may hold NULL for an empty one.
+ * @param capacity Pointer to the number of items the array has room for.
+ * @param needed The number of items the array must have room for.
+ * @param item_size The size of one item.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_memory_pool_reserve(void **array, size_t *capacity, size_t needed, size_t item_size)
+{
+    CHECK_NULL(array, ERROR_NULL_POINTER);
+    CHECK_NULL(capacity, ERROR_NULL_POINTER);
+    if (needed <= *capacity)
+    {
+        return ERROR_SUCCESS;
+    }
+
+    size_t new_capacity = *capacity ? *capacity : LIMDY_POOL_RESERVE_MIN_CAPACITY;
+    while (new_capacity < needed)
+    {
+        new_capacity *= 2;
+    }
+    if (item_size && new_capacity > SIZE_MAX / item_size)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Array of %zu items is too large", new_capacity);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    void *grown = limdy_memory_pool_realloc(*array, new_capacity * item_size);
+    if (!grown)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to grow array to %zu items", new_capacity);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    *array = grown;
+    *capacity = new_capacity;
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Defragments a memory pool.
+ *
+ * @param pool Pointer to the pool to defragment.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_memory_pool_defragment(LimdyMemoryPool *pool)
+{
+    if (!pool)
+    {
+        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INVALID_POOL, "Attempt to defragment invalid pool");
+        return LIMDY_MEMORY_POOL_ERROR_INVALID_POOL;
+    }
+
+    MUTEX_LOCK(&pool->mutex);
+
+    // Frees coalesce at once, so this only catches what other paths left behind
+    struct MemoryBlock *current = pool->free_list;
+    while (current && current->next)
+    {
+        if (!current->in_use && !current->next->in_use)
+        {
+            // Merge blocks
+            bin_remove(pool, current);
+            bin_remove(pool, current->next);
+            current->size += current->next->size + sizeof(struct MemoryBlock);
+            current->next = current->next->next;
+            if (current->next)
+            {
+                current->next->prev = current;
+            }
+            bin_insert(pool, current);
+        }
+        else
+        {
+            current = current->next;
+        }
+    }
+
+    for (struct MemoryBlock *block = pool->free_list; block; block = block->next)
+    {
+        if (!block->in_use)
+        {
+            release_block_pages(block, pool->page_size);
+        }
+    }
+    pool->frees_until_trim = LIMDY_POOL_TRIM_INTERVAL;
+
+    MUTEX_UNLOCK(&pool->mutex);
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Sets the resident-to-used ratio at which frees defragment a pool.
+ *
+ * @param pool Pointer to the pool to configure.
+ * @param ratio The trigger ratio, or 0 to disable automatic defragmentation.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_memory_pool_set_trim_ratio(LimdyMemoryPool *pool, double ratio)
+{
+    if (!pool)
+    {
+        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INVALID_POOL, "Attempt to configure invalid pool");
+        return LIMDY_MEMORY_POOL_ERROR_INVALID_POOL;
+    }
+    if (!(ratio >= 0))
+    {
+        LOG_ERROR(ERROR_INVALID_ARGUMENT, "Trim ratio must not be negative");
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    MUTEX_LOCK(&pool->mutex);
+    pool->trim_ratio = ratio;
+    pool->frees_until_trim = LIMDY_POOL_TRIM_INTERVAL;
+    MUTEX_UNLOCK(&pool->mutex);
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Gets the fragmentation and resident size of a single memory pool.
+ *
+ * @param pool Pointer to the pool to query.
+ * @param stats Pointer to store the statistics.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_memory_pool_get_fragmentation(LimdyMemoryPool *pool, LimdyMemoryPoolFragmentation *stats)
+{
+    if (!pool)
+    {
+        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INVALID_POOL, "Attempt to query invalid pool");
+        return LIMDY_MEMORY_POOL_ERROR_INVALID_POOL;
+    }
+    CHECK_NULL(stats, ERROR_NULL_POINTER);
+
+    memset(stats, 0, sizeof(*stats));
+
+    MUTEX_LOCK(&pool->mutex);
+    stats->total_size = pool->total_size;
+    stats->used_size = pool->used_size;
+    for (struct MemoryBlock *block = pool->free_list; block; block = block->next)
+    {
+        if (block->in_use)
+        {
+            continue;
+        }
+        stats->free_size += block->size;
+        stats->free_blocks++;
+        if (block->size > stats->largest_free_block)
+        {
+            stats->largest_free_block = block->size;
+        }
+    }
+    MUTEX_UNLOCK(&pool->mutex);
+
+    size_t page = page_size();
+    stats->resident_size = pool_resident_size(pool);
+    stats->fragmentation = stats->free_size ? 1.0 - (double)stats->largest_free_block / (double)stats->free_size : 0.0;
+    stats->resident_ratio = (double)stats->resident_size / (double)(stats->used_size > page ? stats->used_size : page);
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Resets a memory pool to a single free block.
+ *
+ * @param pool Pointer to the pool to reset.
+ * @return ErrorCode indicating success or failure.
+ */
+ErrorCode limdy_memory_pool_reset(LimdyMemoryPool *pool)
+{
+    if (!pool)
+    {
+        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INVALID_POOL, "Attempt to reset invalid pool");
+        return LIMDY_MEMORY_POOL_ERROR_INVALID_POOL;
+    }
+
+    MUTEX_LOCK(&pool->mutex);
+
+    pool->used_size = 0;
+    pool->free_list = (struct MemoryBlock *)pool->memory;
+    pool->free_list->magic = MEMORY_BLOCK_MAGIC;
+    pool->free_list->size = pool->total_size - sizeof(struct MemoryBlock);
+    pool->free_list->in_use = 0;
+    pool->free_list->next = NULL;
+    pool->free_list->prev = NULL;
+
+    pool->fl_bitmap = 0;
+    memset(pool->sl_bitmap, 0, sizeof(pool->sl_bitmap));
+    memset(pool->bins, 0, sizeof(pool->bins));
+    bin_insert(pool, pool->free_list);
+
+    MUTEX_UNLOCK(&pool->mutex);
+    return ERROR_SUCCESS;
+}
+
+/**
+ * @brief Gets the size and usage of a single memory pool.
+ *
+ * @param pool Pointer to the pool to query.
+ * @param total_size Pointer to store the pool's capacity in bytes.
+ * @param used_size Pointer to store the number of bytes currently allocated.
+ */
+void limdy_memory_pool_get_pool_stats(LimdyMemoryPool *pool, size_t *total_size, size_t *used_size)
+{
+    if (!pool)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    if (total_size)
+    {
+        *total_size = pool->total_size;
+    }
+    if (used_size)
+    {
+        *used_size = pool->used_size;
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+/**
+ * @brief Maps a request size to its slab size class.
+ *
+ * @param size The number of bytes requested.
+ * @return The size class index, or -1 if the size is not served by slabs.
+ */
+static int slab_size_class(size_t size)
+{
+    if (size > LIMDY_SLAB_MAX_SIZE)
+    {
+        return -1;
+    }
+    if (size <= LIMDY_SLAB_MIN_SIZE)
+    {
+        return 0;
+    }
+
+    // LIMDY_SLAB_MIN_SIZE << i is the first class that fits
+    int index = (int)(sizeof(unsigned long long) * 8) - __builtin_clzll((unsigned long long)size - 1) - __builtin_ctz(LIMDY_SLAB_MIN_SIZE);
+    return index < LIMDY_SLAB_SIZES ? index : -1;
+}
+
+/**
+ * @brief Finds the owner of a pointer.
+ *
+ * This is lock-free; owners are registered before any of their memory is handed out.
+ *
+ * @param ptr Pointer to look up.
+ * @return The owner map entry for the pointer, OWNER_NONE if it is not ours.
+ */
+static uintptr_t owner_map_lookup(const void *ptr)
+{
+    uintptr_t granule = (uintptr_t)ptr >> OWNER_MAP_SHIFT;
+    if (granule >> (OWNER_MAP_ROOT_BITS + OWNER_MAP_LEAF_BITS))
+    {
+        return OWNER_NONE;
+    }
+
+    _Atomic uintptr_t *leaf = atomic_load_explicit(&owner_map[granule >> OWNER_MAP_LEAF_BITS], memory_order_acquire);
+    if (!leaf)
+    {
+        return OWNER_NONE;
+    }
+
+    return atomic_load_explicit(&leaf[granule & ((1 << OWNER_MAP_LEAF_BITS) - 1)], memory_order_relaxed);
+}
+
+/**
+ * @brief Records the owner of every granule in [start, start + size).
+ *
+ * @param start Granule-aligned start address.
+ * @param size Size of the region in bytes, a multiple of LIMDY_SLAB_SPAN_SIZE.
+ * @param entry Owner entry to store, or OWNER_NONE to clear.
+ * @return ErrorCode indicating success or failure.
+ */
+static ErrorCode owner_map_set(void *start, size_t size, uintptr_t entry)
+{
+    ErrorCode error = ERROR_SUCCESS;
+
+    pthread_mutex_lock(&owner_map_mutex);
+
+    for (uintptr_t granule = (uintptr_t)start >> OWNER_MAP_SHIFT; granule < ((uintptr_t)start + size) >> OWNER_MAP_SHIFT; granule++)
+    {
+        if (granule >> (OWNER_MAP_ROOT_BITS + OWNER_MAP_LEAF_BITS))
+        {
+            error = LIMDY_MEMORY_POOL_ERROR_ALLOC_FAILED;
+            break;
+        }
+
+        _Atomic(_Atomic uintptr_t *) *root = &owner_map[granule >> OWNER_MAP_LEAF_BITS];
+        _Atomic uintptr_t *leaf = atomic_load_explicit(root, memory_order_relaxed);
+        if (!leaf)
+        {
+            if (entry == OWNER_NONE)
+            {
+                continue;
+            }
+            leaf = calloc((size_t)1 << OWNER_MAP_LEAF_BITS, sizeof(*leaf));
+            if (!leaf)
+            {
+                error = LIMDY_MEMORY_POOL_ERROR_ALLOC_FAILED;
+                break;
+            }
+            atomic_store_explicit(root, leaf, memory_order_release);
+        }
+        atomic_store_explicit(&leaf[granule & ((1 << OWNER_MAP_LEAF_BITS) - 1)], entry, memory_order_relaxed);
+    }
+
+    pthread_mutex_unlock(&owner_map_mutex);
+    return error;
+}
+
+/**
+ * @brief Drops every owner map leaf. Only safe once nothing is allocated any more.
+ */
+static void owner_map_clear(void)
+{
+    pthread_mutex_lock(&owner_map_mutex);
+    for (size_t i = 0; i < (size_t)1 << OWNER_MAP_ROOT_BITS; i++)
+    {
+        free(atomic_exchange_explicit(&owner_map[i], NULL, memory_order_relaxed));
+    }
+    pthread_mutex_unlock(&owner_map_mutex);
+}
+
+/**
+ * @brief Size of every slab span, derived from the configured objects per slab.
+ *
+ * All spans share one size so cleanup does not need to remember it per span.
+ *
+ * @return The span size in bytes, a multiple of LIMDY_SLAB_SPAN_SIZE.
+ */
+static size_t slab_span_size(void)
+{
+    size_t objects = global_config.slab_objects_per_slab ? global_config.slab_objects_per_slab : 1;
+    return ALIGN_SIZE(LIMDY_SLAB_MAX_SIZE * objects, LIMDY_SLAB_SPAN_SIZE);
+}
+
+/**
+ * @brief Initializes the slab allocator.
+ */
+static void init_slab_allocator(void)
+{
+    pthread_mutex_init(&slab_allocator.mutex, NULL);
+    for (int i = 0; i < LIMDY_SLAB_SIZES; i++)
+    {
+        slab_allocator.slab_sizes[i] = LIMDY_SLAB_MIN_SIZE << i;
+        slab_allocator.slabs[i] = NULL;
+        slab_allocator.free_objects[i] = 0;
     }
-
-    MUTEX_UNLOCK(&pool->mutex);
+    slab_allocator.spans = NULL;
+    slab_allocator.span_count = 0;
+    slab_allocator.span_capacity = 0;
 }
 
 /**
- * @brief Helper function to allocate a new block and copy data for reallocation.
+ * @brief Releases every span owned by the slab allocator.
  *
- * @param pool Pointer to the pool.
- * @param ptr Pointer to the original memory block.
- * @param new_size The new size for the memory block.
- * @return A pointer to the resized memory block, or NULL if reallocation fails.
+ * Objects still sitting in other threads' caches are discarded lazily: bumping
+ * the generation makes those caches drop their contents on next use.
  */
-static void *realloc_allocate_and_copy(LimdyMemoryPool *pool, void *ptr, size_t new_size)
+static void cleanup_slab_allocator(void)
 {
-    void *new_ptr = limdy_memory_pool_alloc(new_size);
-    if (!new_ptr)
+    pthread_mutex_lock(&slab_allocator.mutex);
+
+    size_t span_size = slab_span_size();
+    for (size_t i = 0; i < slab_allocator.span_count; i++)
     {
-        return NULL;
+        owner_map_set(slab_allocator.spans[i], span_size, OWNER_NONE);
+        ALIGNED_FREE(slab_allocator.spans[i]);
     }
+    free(slab_allocator.spans);
+    slab_allocator.spans = NULL;
+    slab_allocator.span_count = 0;
+    slab_allocator.span_capacity = 0;
 
-    struct MemoryBlock *block = (struct MemoryBlock *)((char *)ptr - sizeof(struct MemoryBlock));
-    memcpy(new_ptr, ptr, block->size);
-    limdy_memory_pool_free(ptr);
+    for (int i = 0; i < LIMDY_SLAB_SIZES; i++)
+    {
+        slab_allocator.slabs[i] = NULL;
+        slab_allocator.free_objects[i] = 0;
+    }
 
-    return new_ptr;
+    atomic_fetch_add_explicit(&slab_generation, 1, memory_order_relaxed);
+    memset(&thread_cache.magazines, 0, sizeof(thread_cache.magazines));
+
+    pthread_mutex_unlock(&slab_allocator.mutex);
+    pthread_mutex_destroy(&slab_allocator.mutex);
 }
 
 /**
- * @brief Resizes an existing allocation.
+ * @brief Carves a new span into objects of one size class.
  *
- * @param ptr Pointer to the memory block to be resized.
- * @param new_size The new size for the memory block.
- * @return A pointer to the resized memory block, or NULL if reallocation fails.
+ * Must be called with the slab mutex held.
+ *
+ * @param slab_index The size class to grow.
+ * @return ErrorCode indicating success or failure.
  */
-void *limdy_memory_pool_realloc(void *ptr, size_t new_size)
+static ErrorCode slab_grow(int slab_index)
 {
-    if (!ptr)
+    size_t object_size = slab_allocator.slab_sizes[slab_index];
+    size_t span_size = slab_span_size();
+
+    if (slab_allocator.span_count == slab_allocator.span_capacity)
     {
-        return limdy_memory_pool_alloc(new_size);
+        size_t new_capacity = slab_allocator.span_capacity ? slab_allocator.span_capacity * 2 : 16;
+        void **new_spans = realloc(slab_allocator.spans, new_capacity * sizeof(void *));
+        if (!new_spans)
+        {
+            return LIMDY_MEMORY_POOL_ERROR_ALLOC_FAILED;
+        }
+        slab_allocator.spans = new_spans;
+        slab_allocator.span_capacity = new_capacity;
     }
 
-    if (new_size == 0)
+    void *span = ALIGNED_ALLOC(LIMDY_SLAB_SPAN_SIZE, span_size);
+    if (!span)
     {
-        limdy_memory_pool_free(ptr);
-        return NULL;
+        return LIMDY_MEMORY_POOL_ERROR_ALLOC_FAILED;
     }
 
-    LimdyMemoryPool *pool = find_pool(ptr);
-    if (!pool)
+    if (owner_map_set(span, span_size, OWNER_SLAB(slab_index)) != ERROR_SUCCESS)
     {
-        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INVALID_FREE, "Attempt to realloc memory not allocated by pool");
-        return NULL;
+        owner_map_set(span, span_size, OWNER_NONE);
+        ALIGNED_FREE(span);
+        return LIMDY_MEMORY_POOL_ERROR_ALLOC_FAILED;
     }
+    slab_allocator.spans[slab_allocator.span_count++] = span;
 
-    MUTEX_LOCK(&pool->mutex);
-
-    struct MemoryBlock *block = (struct MemoryBlock *)((char *)ptr - sizeof(struct MemoryBlock));
-    verify_block_magic(block);
-    if (!block->in_use)
+    // Thread the objects onto the shared free list
+    size_t object_count = span_size / object_size;
+    for (size_t i = 0; i < object_count - 1; i++)
     {
-        MUTEX_UNLOCK(&pool->mutex);
-        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INVALID_FREE, "Attempt to reallocate freed memory");
-        return NULL;
+        *(void **)((char *)span + i * object_size) = (char *)span + (i + 1) * object_size;
     }
+    *(void **)((char *)span + (object_count - 1) * object_size) = slab_allocator.slabs[slab_index];
+    slab_allocator.slabs[slab_index] = span;
+    slab_allocator.free_objects[slab_index] += object_count;
 
-    new_size = ALIGN_SIZE(new_size, LIMDY_MEMORY_ALIGNMENT);
+    return ERROR_SUCCESS;
+}
 
-    // Optimized reallocation: try extending the block if possible
-    if (new_size > block->size && block->next && !block->next->in_use &&
-        (block->size + sizeof(struct MemoryBlock) + block->next->size) >= new_size)
+/**
+ * @brief Returns every object cached by the calling thread to the shared free lists.
+ *
+ * Must be called with the slab mutex held.
+ */
+static void thread_cache_flush_locked(void)
+{
+    for (int i = 0; i < LIMDY_SLAB_SIZES; i++)
     {
-        size_t total_size = block->size + sizeof(struct MemoryBlock) + block->next->size;
-        block->size = new_size;
-        if (total_size - new_size >= MIN_BLOCK_SIZE)
-        {
-            struct MemoryBlock *new_block = (struct MemoryBlock *)((char *)block + sizeof(struct MemoryBlock) + new_size);
-            new_block->magic = MEMORY_BLOCK_MAGIC;
-            new_block->size = total_size - new_size - sizeof(struct MemoryBlock);
-            new_block->in_use = 0;
-            new_block->next = block->next->next;
-            new_block->prev = block;
-            if (new_block->next)
-            {
-                new_block->next->prev = new_block;
-            }
-            block->next = new_block;
-        }
-        else
+        LimdySlabMagazine *magazine = &thread_cache.magazines[i];
+        while (magazine->count > 0)
         {
-            block->size = total_size;
-            block->next = block->next->next;
-            if (block->next)
-            {
-                block->next->prev = block;
-            }
+            void *object = magazine->objects[--magazine->count];
+            *(void **)object = slab_allocator.slabs[i];
+            slab_allocator.slabs[i] = object;
+            slab_allocator.free_objects[i]++;
         }
-        pool->used_size += new_size - block->size;
-        MUTEX_UNLOCK(&pool->mutex);
-        return ptr;
     }
-
-    // If extending isn't possible, allocate a new block and copy data
-    void *new_ptr = realloc_allocate_and_copy(pool, ptr, new_size);
-    MUTEX_UNLOCK(&pool->mutex);
-
-    return new_ptr;
 }
 
 /**
- * @brief Defragments a memory pool.
+ * @brief Thread-exit hook handing a dying thread's cached objects back.
  *
- * @param pool Pointer to the pool to defragment.
- * @return ErrorCode indicating success or failure.
+ * @param arg Unused; only non-NULL so the destructor fires.
  */
-ErrorCode limdy_memory_pool_defragment(LimdyMemoryPool *pool)
+static void thread_cache_destructor(void *arg)
 {
-    if (!pool)
+    (void)arg;
+    if (thread_cache.generation != atomic_load_explicit(&slab_generation, memory_order_relaxed))
     {
-        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INVALID_POOL, "Attempt to defragment invalid pool");
-        return LIMDY_MEMORY_POOL_ERROR_INVALID_POOL;
+        return;
     }
+    pthread_mutex_lock(&slab_allocator.mutex);
+    thread_cache_flush_locked();
+    pthread_mutex_unlock(&slab_allocator.mutex);
+}
 
-    MUTEX_LOCK(&pool->mutex);
+static void thread_cache_create_key(void)
+{
+    pthread_key_create(&thread_cache_key, thread_cache_destructor);
+}
 
-    struct MemoryBlock *current = pool->free_list;
-    while (current && current->next)
+/**
+ * @brief Makes sure the calling thread's cache is valid and its exit hook is armed.
+ */
+static void thread_cache_prepare(void)
+{
+    unsigned generation = atomic_load_explicit(&slab_generation, memory_order_relaxed);
+    if (thread_cache.generation != generation)
     {
-        if (!current->in_use && !current->next->in_use)
-        {
-            // Merge blocks
-            current->size += current->next->size + sizeof(struct MemoryBlock);
-            current->next = current->next->next;
-            if (current->next)
-            {
-                current->next->prev = current;
-            }
-        }
-        else
-        {
-            current = current->next;
-        }
+        // Anything cached from before the last cleanup points into freed spans
+        memset(&thread_cache.magazines, 0, sizeof(thread_cache.magazines));
+        thread_cache.generation = generation;
     }
 
-    MUTEX_UNLOCK(&pool->mutex);
-    return ERROR_SUCCESS;
+    if (!thread_cache.registered)
+    {
+        pthread_once(&thread_cache_key_once, thread_cache_create_key);
+        pthread_setspecific(thread_cache_key, &thread_cache);
+        thread_cache.registered = true;
+    }
 }
 
-static LimdySlabAllocator slab_allocator;
-
 /**
- * @brief Initializes the slab allocator.
+ * @brief Refills the calling thread's magazine for a size class from the shared allocator.
+ *
+ * @param slab_index The size class to refill.
+ * @return The number of objects now in the magazine.
  */
-static void init_slab_allocator(void)
+static size_t thread_cache_refill(int slab_index)
 {
-    pthread_mutex_init(&slab_allocator.mutex, NULL);
-    for (int i = 0; i < LIMDY_SLAB_SIZES; i++)
+    thread_cache_prepare();
+
+    LimdySlabMagazine *magazine = &thread_cache.magazines[slab_index];
+
+    pthread_mutex_lock(&slab_allocator.mutex);
+
+    if (slab_allocator.free_objects[slab_index] < LIMDY_THREAD_CACHE_BATCH)
     {
-        slab_allocator.slab_sizes[i] = LIMDY_SLAB_MIN_SIZE << i;
-        slab_allocator.slabs[i] = NULL;
-        slab_allocator.free_objects[i] = 0;
+        // A failed grow is fine as long as some objects are left
+        slab_grow(slab_index);
+    }
+
+    while (magazine->count < LIMDY_THREAD_CACHE_BATCH && slab_allocator.slabs[slab_index])
+    {
+        void *object = slab_allocator.slabs[slab_index];
+        slab_allocator.slabs[slab_index] = *(void **)object;
+        slab_allocator.free_objects[slab_index]--;
+        magazine->objects[magazine->count++] = object;
     }
+
+    pthread_mutex_unlock(&slab_allocator.mutex);
+
+    return magazine->count;
 }
 
 /**
  * @brief Allocates memory from the slab allocator.
  *
+ * Served from the calling thread's cache; the shared allocator is only
+ * touched when the cache for this size class is empty.
+ *
  * @param size The number of bytes to allocate.
  * @return A pointer to the allocated memory, or NULL if allocation fails.
  */
 static void *slab_alloc(size_t size)
 {
-    if (size > LIMDY_SLAB_MAX_SIZE)
-    {
-        return NULL;
-    }
-
-    int slab_index = 0;
-    while (slab_allocator.slab_sizes[slab_index] < size && slab_index < LIMDY_SLAB_SIZES)
-    {
-        slab_index++;
-    }
-
-    if (slab_index == LIMDY_SLAB_SIZES)
+    int slab_index = slab_size_class(size);
+    if (slab_index < 0)
     {
         return NULL;
     }
 
-    MUTEX_LOCK(&slab_allocator.mutex);
-
-    if (!slab_allocator.free_objects[slab_index])
+    LimdySlabMagazine *magazine = &thread_cache.magazines[slab_index];
+    if (magazine->count == 0 || thread_cache.generation != atomic_load_explicit(&slab_generation, memory_order_relaxed))
     {
-        // Allocate new slab
-        size_t slab_size = slab_allocator.slab_sizes[slab_index] * global_config.slab_objects_per_slab;
-        void *new_slab = ALIGNED_ALLOC(LIMDY_MAX_ALIGN, slab_size);
-        if (!new_slab)
+        if (thread_cache_refill(slab_index) == 0)
         {
-            MUTEX_UNLOCK(&slab_allocator.mutex);
             return NULL;
         }
-
-        // Initialize free list
-        for (size_t i = 0; i < global_config.slab_objects_per_slab - 1; i++)
-        {
-            *(void **)((char *)new_slab + i * slab_allocator.slab_sizes[slab_index]) =
-                (char *)new_slab + (i + 1) * slab_allocator.slab_sizes[slab_index];
-        }
-        *(void **)((char *)new_slab + (global_config.slab_objects_per_slab - 1) * slab_allocator.slab_sizes[slab_index]) = slab_allocator.slabs[slab_index];
-        slab_allocator.slabs[slab_index] = new_slab;
-        slab_allocator.free_objects[slab_index] = global_config.slab_objects_per_slab;
     }
 
-    void *result = slab_allocator.slabs[slab_index];
-    slab_allocator.slabs[slab_index] = *(void **)result;
-    slab_allocator.free_objects[slab_index]--;
-
-    MUTEX_UNLOCK(&slab_allocator.mutex);
-    return result;
+    return magazine->objects[--magazine->count];
 }
 
 /**
  * @brief Frees memory back to the slab allocator.
  *
+ * The object goes to the calling thread's cache; when that overflows, a batch
+ * is spilled back to the shared free list.
+ *
  * @param ptr Pointer to the memory to be freed.
- * @param size The size of the memory block.
+ * @param slab_index The size class the pointer belongs to.
  */
-static void slab_free(void *ptr, size_t size)
+static void slab_free(void *ptr, int slab_index)
 {
-    if (size > LIMDY_SLAB_MAX_SIZE)
-    {
-        return;
-    }
+    LimdySlabMagazine *magazine = &thread_cache.magazines[slab_index];
 
-    int slab_index = 0;
-    while (slab_allocator.slab_sizes[slab_index] < size && slab_index < LIMDY_SLAB_SIZES)
+    if (thread_cache.generation != atomic_load_explicit(&slab_generation, memory_order_relaxed) || !thread_cache.registered)
     {
-        slab_index++;
+        thread_cache_prepare();
     }
 
-    if (slab_index == LIMDY_SLAB_SIZES)
+    if (magazine->count == LIMDY_THREAD_CACHE_CAPACITY)
     {
-        return;
+        pthread_mutex_lock(&slab_allocator.mutex);
+        for (size_t i = 0; i < LIMDY_THREAD_CACHE_BATCH; i++)
+        {
+            void *object = magazine->objects[--magazine->count];
+            *(void **)object = slab_allocator.slabs[slab_index];
+            slab_allocator.slabs[slab_index] = object;
+            slab_allocator.free_objects[slab_index]++;
+        }
+        pthread_mutex_unlock(&slab_allocator.mutex);
     }
 
-    MUTEX_LOCK(&slab_allocator.mutex);
-
-    *(void **)ptr = slab_allocator.slabs[slab_index];
-    slab_allocator.slabs[slab_index] = ptr;
-    slab_allocator.free_objects[slab_index]++;
-
-    MUTEX_UNLOCK(&slab_allocator.mutex);
+    magazine->objects[magazine->count++] = ptr;
 }
 
 /**
@@ -618,21 +1897,20 @@ static void slab_free(void *ptr, size_t size)
  */
 void limdy_memory_pool_get_stats(size_t *total_allocated, size_t *total_used)
 {
-    MUTEX_LOCK(&global_mutex); // Ensure thread safety
+    MUTEX_LOCK(&address_index_mutex); // Ensure thread safety
 
     *total_allocated = 0;
     *total_used = 0;
 
-    for (size_t i = 0; i < num_small_pools; i++)
+    // Every pool is in the address index, whichever node set or caller it belongs to
+    for (LimdyRBNode *node = limdy_rbtree_first(&address_index); node; node = limdy_rbtree_next(node))
     {
-        *total_allocated += small_pools[i]->total_size;
-        *total_used += small_pools[i]->used_size;
+        LimdyMemoryPool *pool = LIMDY_RB_ENTRY(node, LimdyMemoryPool, address_node);
+        *total_allocated += pool->total_size;
+        *total_used += pool->used_size;
     }
 
-    *total_allocated += large_pool->total_size;
-    *total_used += large_pool->used_size;
-
-    MUTEX_UNLOCK(&global_mutex);
+    MUTEX_UNLOCK(&address_index_mutex);
 }
 
 /**
@@ -644,35 +1922,26 @@ void limdy_memory_pool_get_stats(size_t *total_allocated, size_t *total_used)
  */
 ErrorCode limdy_memory_pool_create(size_t pool_size, LimdyMemoryPool **new_pool)
 {
-    MUTEX_LOCK(&global_mutex);
-    if (num_small_pools >= global_config.max_pools)
-    {
-        MUTEX_UNLOCK(&global_mutex);
-        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_POOL_FULL, "Maximum number of pools reached");
-        return LIMDY_MEMORY_POOL_ERROR_POOL_FULL;
-    }
+    CHECK_NULL(new_pool, ERROR_NULL_POINTER);
 
     ErrorCode error = create_pool(pool_size, new_pool);
-    if (error == ERROR_SUCCESS)
+    if (error != ERROR_SUCCESS)
     {
-        small_pools[num_small_pools] = *new_pool;
-        error = limdy_rbtree_insert(&pool_rbtree, *new_pool);
-        if (error == ERROR_SUCCESS)
-        {
-            num_small_pools++;
-        }
-        else
-        {
-            ALIGNED_FREE((*new_pool)->memory);
-            pthread_mutex_destroy(&(*new_pool)->mutex);
-            pthread_rwlock_destroy(&(*new_pool)->rwlock); // Destroy the reader-writer lock
-            free(*new_pool);
-            *new_pool = NULL;
-        }
+        *new_pool = NULL;
+        return error;
     }
 
+    MUTEX_LOCK(&global_mutex);
+    (*new_pool)->prev_created = NULL;
+    (*new_pool)->next_created = created_pools;
+    if (created_pools)
+    {
+        created_pools->prev_created = *new_pool;
+    }
+    created_pools = *new_pool;
     MUTEX_UNLOCK(&global_mutex);
-    return error;
+
+    return ERROR_SUCCESS;
 }
 
 /**
@@ -688,29 +1957,45 @@ void limdy_memory_pool_destroy(LimdyMemoryPool *pool)
     }
     MUTEX_LOCK(&global_mutex);
 
-    for (size_t i = 0; i < num_small_pools; i++)
+    for (int node = 0; node < LIMDY_MAX_NUMA_NODES; node++)
     {
-        if (small_pools[i] == pool)
+        LimdyNodePools *pools = atomic_load_explicit(&node_pools[node], memory_order_relaxed);
+        if (!pools || pools->node != node)
+        {
+            continue;
+        }
+
+        for (size_t i = 0; i < pools->num_small_pools; i++)
+        {
+            if (pools->small_pools[i] == pool)
+            {
+                pthread_rwlock_wrlock(&pools->index_lock);
+                limdy_rbtree_remove(&pools->size_index, &pool->size_node);
+                release_pool(pool);
+                pools->small_pools[i] = pools->small_pools[--pools->num_small_pools];
+                pthread_rwlock_unlock(&pools->index_lock);
+                MUTEX_UNLOCK(&global_mutex);
+                return;
+            }
+        }
+
+        // If pool not found in small_pools, check if it's the large_pool
+        if (pool == pools->large_pool)
         {
-            ALIGNED_FREE(pool->memory);
-            pthread_mutex_destroy(&pool->mutex);
-            pthread_rwlock_destroy(&pool->rwlock); // Destroy the reader-writer lock
-            limdy_rbtree_remove(&pool_rbtree, pool);
-            free(pool);
-            small_pools[i] = small_pools[--num_small_pools];
+            pthread_rwlock_wrlock(&pools->index_lock);
+            release_pool(pool);
+            pools->large_pool = NULL;
+            pthread_rwlock_unlock(&pools->index_lock);
             MUTEX_UNLOCK(&global_mutex);
             return;
         }
     }
 
-    // If pool not found in small_pools, check if it's the large_pool
-    if (pool == large_pool)
+    // Otherwise it has to be a live pool from limdy_memory_pool_create
+    if (limdy_memory_pool_owner(pool->memory) == pool)
     {
-        ALIGNED_FREE(pool->memory);
-        pthread_mutex_destroy(&pool->mutex);
-        pthread_rwlock_destroy(&pool->rwlock); // Destroy the reader-writer lock
-        free(pool);
-        large_pool = NULL;
+        unlink_created_pool(pool);
+        release_pool(pool);
         MUTEX_UNLOCK(&global_mutex);
         return;
     }
@@ -733,71 +2018,14 @@ void *limdy_memory_pool_alloc_from(LimdyMemoryPool *pool, size_t size)
         LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INVALID_POOL, "Attempt to allocate from invalid pool");
         return NULL;
     }
-    return allocate_from_pool(pool, ALIGN_SIZE(size, LIMDY_MEMORY_ALIGNMENT));
-}
-
-/**
- * @brief Helper function to reallocate memory from a specific pool.
- *
- * @param pool Pointer to the pool.
- * @param ptr Pointer to the original memory block.
- * @param new_size The new size for the memory block.
- * @return A pointer to the resized memory block, or NULL if reallocation fails.
- */
-static void *realloc_from_pool(LimdyMemoryPool *pool, void *ptr, size_t new_size)
-{
-    MUTEX_LOCK(&pool->mutex);
-
-    struct MemoryBlock *block = (struct MemoryBlock *)((char *)ptr - sizeof(struct MemoryBlock));
-    verify_block_magic(block);
-    if (!block->in_use)
-    {
-        MUTEX_UNLOCK(&pool->mutex);
-        LOG_ERROR(LIMDY_MEMORY_POOL_ERROR_INVALID_FREE, "Attempt to reallocate freed memory");
-        return NULL;
-    }
-
-    new_size = ALIGN_SIZE(new_size, LIMDY_MEMORY_ALIGNMENT);
-
-    // Optimized reallocation: try extending the block if possible
-    if (new_size > block->size && block->next && !block->next->in_use &&
-        (block->size + sizeof(struct MemoryBlock) + block->next->size) >= new_size)
-    {
-        size_t total_size = block->size + sizeof(struct MemoryBlock) + block->next->size;
-        block->size = new_size;
-        if (total_size - new_size >= MIN_BLOCK_SIZE)
-        {
-            struct MemoryBlock *new_block = (struct MemoryBlock *)((char *)block + sizeof(struct MemoryBlock) + new_size);
-            new_block->magic = MEMORY_BLOCK_MAGIC;
-            new_block->size = total_size - new_size - sizeof(struct MemoryBlock);
-            new_block->in_use = 0;
-            new_block->next = block->next->next;
-            new_block->prev = block;
-            if (new_block->next)
-            {
-                new_block->next->prev = new_block;
-            }
-            block->next = new_block;
-        }
-        else
-        {
-            block->size = total_size;
-            block->next = block->next->next;
-            if (block->next)
-            {
-                block->next->prev = block;
-            }
-        }
-        pool->used_size += new_size - block->size;
-        MUTEX_UNLOCK(&pool->mutex);
-        return ptr;
-    }
+    size = ALIGN_SIZE(size, LIMDY_MEMORY_ALIGNMENT);
 
-    // If extending isn't possible, allocate a new block and copy data
-    void *new_ptr = realloc_allocate_and_copy(pool, ptr, new_size);
-    MUTEX_UNLOCK(&pool->mutex);
+    LIMDY_METRIC_TIME_BEGIN(started);
+    void *ptr = allocate_from_pool(pool, size);
+    LIMDY_METRIC_TIME_END(started, LIMDY_HISTOGRAM_ALLOCATION_NS + limdy_metrics_size_class(size));
+    LIMDY_METRIC_COUNT((ptr ? LIMDY_COUNTER_ALLOCATIONS : LIMDY_COUNTER_ALLOCATION_FAILURES) + limdy_metrics_size_class(size), 1);
 
-    return new_ptr;
+    return ptr;
 }
 
 /**
@@ -833,7 +2061,7 @@ void *limdy_memory_pool_realloc_from(LimdyMemoryPool *pool, void *ptr, size_t ne
         return NULL;
     }
 
-    return realloc_from_pool(pool, ptr, new_size);
+    return realloc_from_pool(pool, ptr, new_size, true);
 }
 
 /**
@@ -855,38 +2083,7 @@ void limdy_memory_pool_free_to(LimdyMemoryPool *pool, void *ptr)
         return;
     }
 
-    MUTEX_LOCK(&pool->mutex);
-
-    struct MemoryBlock *block = (struct MemoryBlock *)((char *)ptr - sizeof(struct MemoryBlock));
-    verify_block_magic(block);
-    assert(block->in_use);
-    block->in_use = 0;
-    pool->used_size -= block->size + sizeof(struct MemoryBlock);
-
-    // Coalesce with previous block if it's free
-    if (block->prev && !block->prev->in_use)
-    {
-        block->prev->size += block->size + sizeof(struct MemoryBlock);
-        block->prev->next = block->next;
-        if (block->next)
-        {
-            block->next->prev = block->prev;
-        }
-        block = block->prev;
-    }
-
-    // Coalesce with next block if it's free
-    if (block->next && !block->next->in_use)
-    {
-        block->size += block->next->size + sizeof(struct MemoryBlock);
-        block->next = block->next->next;
-        if (block->next)
-        {
-            block->next->prev = block;
-        }
-    }
-
-    MUTEX_UNLOCK(&pool->mutex);
+    free_to_pool(pool, ptr);
 }
 
 /**
@@ -903,12 +2100,28 @@ bool limdy_memory_pool_contains(const LimdyMemoryPool *pool, const void *ptr)
         return false;
     }
 
-    // Use reader-writer lock for read-only operation
-    pthread_rwlock_rdlock(&pool->rwlock);
-    bool result = (ptr >= pool->memory && ptr < (char *)pool->memory + pool->total_size);
-    pthread_rwlock_unlock(&pool->rwlock);
+    // The owner map is read lock-free; the range check trims the last granule's padding
+    return owner_map_lookup(ptr) == OWNER_POOL(pool) &&
+           (const char *)ptr < (const char *)pool->memory + pool->total_size;
+}
 
-    return result;
+/**
+ * @brief Finds the pool whose memory holds a pointer.
+ *
+ * @param ptr The pointer to look up.
+ * @return The owning pool, or NULL if no pool holds ptr.
+ */
+LimdyMemoryPool *limdy_memory_pool_owner(const void *ptr)
+{
+    pthread_mutex_lock(&address_index_mutex);
+    LimdyRBNode *node = limdy_rbtree_floor(&address_index, ptr, compare_address_key);
+    LimdyMemoryPool *pool = node ? LIMDY_RB_ENTRY(node, LimdyMemoryPool, address_node) : NULL;
+    if (pool && (const char *)ptr >= (const char *)pool->memory + pool->total_size)
+    {
+        pool = NULL;
+    }
+    pthread_mutex_unlock(&address_index_mutex);
+    return pool;
 }
 
 #ifdef LIMDY_MEMORY_DEBUG
@@ -0,0 +1,292 @@
+/**
+ * @file thread_pool.c
+ * @brief Implementation of the fixed-size worker pool.
+ *
+ * This file implements the interface defined in thread_pool.h. Tasks sit
+ * in a mutex-protected FIFO list. A parallel loop hands out indexes from an
+ * atomic counter; its shared state is reference counted so that helper
+ * tasks which only start after the loop has finished can still exit safely.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-14
+ */
+
+#include "thread_pool.h"
+#include "limdy_utils.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+typedef struct LimdyTask
+{
+    LimdyTaskFn fn;
+    void *arg;
+    struct LimdyTask *next;
+} LimdyTask;
+
+struct LimdyThreadPool
+{
+    pthread_t *threads;
+    size_t thread_count;
+    LimdyTask *head; // Next task to run
+    LimdyTask *tail; // Last queued task
+    bool stopping;
+    pthread_mutex_t mutex;
+    pthread_cond_t work_available;
+};
+
+typedef struct
+{
+    LimdyParallelFn fn;
+    void *arg;
+    size_t count;
+    atomic_size_t next;
+    atomic_size_t done;
+    atomic_size_t refs;
+    pthread_mutex_t mutex;
+    pthread_cond_t finished;
+} ParallelLoop;
+
+static void *worker_main(void *arg)
+{
+    LimdyThreadPool *pool = arg;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;)
+    {
+        while (!pool->head && !pool->stopping)
+        {
+            pthread_cond_wait(&pool->work_available, &pool->mutex);
+        }
+        if (!pool->head)
+        {
+            break; // Stopping and drained
+        }
+
+        LimdyTask *task = pool->head;
+        pool->head = task->next;
+        if (!pool->head)
+        {
+            pool->tail = NULL;
+        }
+        pthread_mutex_unlock(&pool->mutex);
+
+        task->fn(task->arg);
+        free(task);
+
+        pthread_mutex_lock(&pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+ErrorCode limdy_thread_pool_create(size_t thread_count, LimdyThreadPool **pool)
+{
+    CHECK_NULL(pool, ERROR_NULL_POINTER);
+
+    if (thread_count == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = online > 0 ? (size_t)online : 1;
+        if (thread_count > LIMDY_THREAD_POOL_MAX_AUTO_THREADS)
+        {
+            thread_count = LIMDY_THREAD_POOL_MAX_AUTO_THREADS;
+        }
+    }
+
+    LimdyThreadPool *new_pool = calloc(1, sizeof(LimdyThreadPool));
+    CHECK_NULL(new_pool, ERROR_MEMORY_ALLOCATION);
+
+    new_pool->threads = calloc(thread_count, sizeof(pthread_t));
+    if (!new_pool->threads)
+    {
+        free(new_pool);
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "Failed to allocate thread pool workers");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    if (pthread_mutex_init(&new_pool->mutex, NULL) != 0 || pthread_cond_init(&new_pool->work_available, NULL) != 0)
+    {
+        free(new_pool->threads);
+        free(new_pool);
+        LOG_ERROR(ERROR_THREAD_INIT, "Failed to initialize thread pool synchronization");
+        return ERROR_THREAD_INIT;
+    }
+
+    for (size_t i = 0; i < thread_count; i++)
+    {
+        if (pthread_create(&new_pool->threads[i], NULL, worker_main, new_pool) != 0)
+        {
+            LOG_ERROR(ERROR_THREAD_INIT, "Failed to start thread pool worker %zu", i);
+            new_pool->thread_count = i;
+            limdy_thread_pool_destroy(new_pool);
+            return ERROR_THREAD_INIT;
+        }
+        new_pool->thread_count = i + 1;
+    }
+
+    *pool = new_pool;
+    return ERROR_SUCCESS;
+}
+
+ErrorCode limdy_thread_pool_submit(LimdyThreadPool *pool, LimdyTaskFn fn, void *arg)
+{
+    CHECK_NULL(pool, ERROR_NULL_POINTER);
+    CHECK_NULL(fn, ERROR_NULL_POINTER);
+
+    LimdyTask *task = malloc(sizeof(LimdyTask));
+    CHECK_NULL(task, ERROR_MEMORY_ALLOCATION);
+    task->fn = fn;
+    task->arg = arg;
+    task->next = NULL;
+
+    pthread_mutex_lock(&pool->mutex);
+    if (pool->stopping)
+    {
+        pthread_mutex_unlock(&pool->mutex);
+        free(task);
+        return LIMDY_THREAD_POOL_ERROR_STOPPED;
+    }
+    if (pool->tail)
+    {
+        pool->tail->next = task;
+    }
+    else
+    {
+        pool->head = task;
+    }
+    pool->tail = task;
+    pthread_cond_signal(&pool->work_available);
+    pthread_mutex_unlock(&pool->mutex);
+
+    return ERROR_SUCCESS;
+}
+
+static void parallel_loop_release(ParallelLoop *loop)
+{
+    if (atomic_fetch_sub_explicit(&loop->refs, 1, memory_order_acq_rel) == 1)
+    {
+        pthread_cond_destroy(&loop->finished);
+        pthread_mutex_destroy(&loop->mutex);
+        free(loop);
+    }
+}
+
+static void parallel_loop_run(ParallelLoop *loop)
+{
+    for (;;)
+    {
+        size_t index = atomic_fetch_add_explicit(&loop->next, 1, memory_order_relaxed);
+        if (index >= loop->count)
+        {
+            break;
+        }
+
+        loop->fn(loop->arg, index);
+
+        if (atomic_fetch_add_explicit(&loop->done, 1, memory_order_acq_rel) + 1 == loop->count)
+        {
+            pthread_mutex_lock(&loop->mutex);
+            pthread_cond_broadcast(&loop->finished);
+            pthread_mutex_unlock(&loop->mutex);
+        }
+    }
+}
+
+static void parallel_loop_helper(void *arg)
+{
+    ParallelLoop *loop = arg;
+    parallel_loop_run(loop);
+    parallel_loop_release(loop);
+}
+
+ErrorCode limdy_thread_pool_parallel_for(LimdyThreadPool *pool, size_t count, LimdyParallelFn fn, void *arg)
+{
+    CHECK_NULL(pool, ERROR_NULL_POINTER);
+    CHECK_NULL(fn, ERROR_NULL_POINTER);
+
+    if (count == 0)
+    {
+        return ERROR_SUCCESS;
+    }
+
+    ParallelLoop *loop = malloc(sizeof(ParallelLoop));
+    CHECK_NULL(loop, ERROR_MEMORY_ALLOCATION);
+    loop->fn = fn;
+    loop->arg = arg;
+    loop->count = count;
+    atomic_init(&loop->next, 0);
+    atomic_init(&loop->done, 0);
+    atomic_init(&loop->refs, 1);
+    if (pthread_mutex_init(&loop->mutex, NULL) != 0 || pthread_cond_init(&loop->finished, NULL) != 0)
+    {
+        free(loop);
+        LOG_ERROR(ERROR_THREAD_INIT, "Failed to initialize parallel loop synchronization");
+        return ERROR_THREAD_INIT;
+    }
+
+    // The caller runs indexes too, so one helper fewer than the work suffices
+    size_t helpers = count - 1 < pool->thread_count ? count - 1 : pool->thread_count;
+    for (size_t i = 0; i < helpers; i++)
+    {
+        atomic_fetch_add_explicit(&loop->refs, 1, memory_order_relaxed);
+        if (limdy_thread_pool_submit(pool, parallel_loop_helper, loop) != ERROR_SUCCESS)
+        {
+            atomic_fetch_sub_explicit(&loop->refs, 1, memory_order_relaxed);
+            break;
+        }
+    }
+
+    // Completion never depends on queued helpers starting; the caller finishes what is left
+    parallel_loop_run(loop);
+
+    pthread_mutex_lock(&loop->mutex);
+    while (atomic_load_explicit(&loop->done, memory_order_acquire) < count)
+    {
+        pthread_cond_wait(&loop->finished, &loop->mutex);
+    }
+    pthread_mutex_unlock(&loop->mutex);
+
+    parallel_loop_release(loop);
+    return ERROR_SUCCESS;
+}
+
+size_t limdy_thread_pool_size(const LimdyThreadPool *pool)
+{
+    return pool ? pool->thread_count : 0;
+}
+
+void limdy_thread_pool_destroy(LimdyThreadPool *pool)
+{
+    if (!pool)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->work_available);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (size_t i = 0; i < pool->thread_count; i++)
+    {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    // Tasks left when no worker ever started
+    while (pool->head)
+    {
+        LimdyTask *task = pool->head;
+        pool->head = task->next;
+        task->fn(task->arg);
+        free(task);
+    }
+
+    pthread_cond_destroy(&pool->work_available);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool->threads);
+    free(pool);
+}
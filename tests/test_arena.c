@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "arena.h"
+#include "memory_pool.h"
+#include "error_handler.h"
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+static size_t chunk_count(const LimdyArena *arena)
+{
+    size_t count = 0;
+    for (const LimdyArenaChunk *chunk = arena->head; chunk; chunk = chunk->next)
+    {
+        count++;
+    }
+    return count;
+}
+
+void test_arena_alloc()
+{
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 1024) == ERROR_SUCCESS);
+    // Nothing is reserved until the first allocation
+    assert(arena.head == NULL && limdy_arena_used(&arena) == 0);
+
+    char *a = limdy_arena_alloc(&arena, 10);
+    char *b = limdy_arena_alloc(&arena, 10);
+    assert(a && b);
+    assert((uintptr_t)a % LIMDY_ARENA_ALIGNMENT == 0 && (uintptr_t)b % LIMDY_ARENA_ALIGNMENT == 0);
+    // The second allocation is bumped past the first and its padding
+    assert(b == a + LIMDY_ARENA_ALIGNMENT);
+    assert(limdy_arena_used(&arena) == LIMDY_ARENA_ALIGNMENT + 10);
+    memset(a, 'a', 10);
+    memset(b, 'b', 10);
+    assert(a[9] == 'a' && b[0] == 'b');
+
+    // Filling the chunk moves on to a new one
+    for (size_t i = 0; i < 1024 / LIMDY_ARENA_ALIGNMENT; i++)
+    {
+        assert(limdy_arena_alloc(&arena, LIMDY_ARENA_ALIGNMENT) != NULL);
+    }
+    assert(chunk_count(&arena) == 2);
+
+    limdy_arena_release(&arena);
+    printf("test_arena_alloc() passed.\n");
+}
+
+void test_arena_reset()
+{
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 1024) == ERROR_SUCCESS);
+
+    void *first = limdy_arena_alloc(&arena, 100);
+    for (size_t i = 0; i < 50; i++)
+    {
+        assert(limdy_arena_alloc(&arena, 100) != NULL);
+    }
+    size_t chunks = chunk_count(&arena);
+    assert(chunks > 1);
+    LimdyArenaChunk *head = arena.head;
+
+    // A reset keeps every chunk and starts over from the first
+    limdy_arena_reset(&arena);
+    assert(limdy_arena_used(&arena) == 0);
+    assert(arena.head == head && chunk_count(&arena) == chunks);
+    assert(limdy_arena_alloc(&arena, 100) == first);
+    for (size_t i = 0; i < 50; i++)
+    {
+        assert(limdy_arena_alloc(&arena, 100) != NULL);
+    }
+    assert(chunk_count(&arena) == chunks);
+
+    // Resetting an arena that never allocated is harmless
+    LimdyArena empty;
+    assert(limdy_arena_init(&empty, 0) == ERROR_SUCCESS);
+    limdy_arena_reset(&empty);
+    assert(empty.chunk_size == LIMDY_ARENA_DEFAULT_CHUNK_SIZE && limdy_arena_alloc(&empty, 1) != NULL);
+    limdy_arena_release(&empty);
+    limdy_arena_reset(NULL);
+
+    limdy_arena_release(&arena);
+    printf("test_arena_reset() passed.\n");
+}
+
+void test_arena_alignment()
+{
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 256) == ERROR_SUCCESS);
+
+    assert(limdy_arena_alloc(&arena, 1) != NULL);
+    const size_t alignments[] = {32, 64, 128, 256, 4096};
+    for (size_t i = 0; i < sizeof(alignments) / sizeof(alignments[0]); i++)
+    {
+        // An odd-sized allocation first, so the cursor is never already aligned
+        assert(limdy_arena_alloc_aligned(&arena, 3, 1) != NULL);
+        char *aligned = limdy_arena_alloc_aligned(&arena, 48, alignments[i]);
+        assert(aligned != NULL && (uintptr_t)aligned % alignments[i] == 0);
+        memset(aligned, 0xab, 48);
+    }
+    // Padding counts as used
+    assert(limdy_arena_used(&arena) > 1 + 5 * (3 + 48));
+
+    // Byte alignment packs allocations back to back
+    char *c = limdy_arena_alloc_aligned(&arena, 3, 1);
+    char *d = limdy_arena_alloc_aligned(&arena, 3, 1);
+    assert(d == c + 3);
+
+    limdy_arena_release(&arena);
+    printf("test_arena_alignment() passed.\n");
+}
+
+void test_arena_large_alloc()
+{
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 1024) == ERROR_SUCCESS);
+
+    char *small = limdy_arena_alloc(&arena, 16);
+    assert(small != NULL);
+    // Bigger than a chunk: it gets a chunk of its own size
+    char *large = limdy_arena_alloc(&arena, 10000);
+    assert(large != NULL && (uintptr_t)large % LIMDY_ARENA_ALIGNMENT == 0);
+    memset(large, 'x', 10000);
+    assert(large[9999] == 'x');
+    assert(chunk_count(&arena) == 2 && arena.current->size >= 10000);
+    assert(limdy_arena_used(&arena) >= 16 + 10000);
+
+    // After a reset, the large chunk is found again for another large request
+    limdy_arena_reset(&arena);
+    assert(limdy_arena_alloc(&arena, 10000) == large);
+    assert(chunk_count(&arena) == 2);
+
+    limdy_arena_release(&arena);
+    printf("test_arena_large_alloc() passed.\n");
+}
+
+void test_arena_strndup()
+{
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 0) == ERROR_SUCCESS);
+
+    // Only length bytes are copied; the source need not be terminated there
+    const char text[] = "hello world";
+    char *copy = limdy_arena_strndup(&arena, text, 5);
+    assert(copy != NULL && copy != text && strcmp(copy, "hello") == 0);
+
+    char *whole = limdy_arena_strndup(&arena, text, strlen(text));
+    assert(strcmp(whole, text) == 0);
+    // Strings are byte aligned, so they pack back to back
+    assert(whole == copy + 6);
+
+    char *empty = limdy_arena_strndup(&arena, text, 0);
+    assert(empty != NULL && empty[0] == '\0');
+
+    limdy_arena_release(&arena);
+    printf("test_arena_strndup() passed.\n");
+}
+
+void test_arena_release()
+{
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 512) == ERROR_SUCCESS);
+    for (size_t i = 0; i < 20; i++)
+    {
+        assert(limdy_arena_alloc(&arena, 100) != NULL);
+    }
+    assert(chunk_count(&arena) > 1);
+
+    // Every chunk goes; the chunk size is kept and the arena stays usable
+    limdy_arena_release(&arena);
+    assert(arena.head == NULL && arena.current == NULL && arena.cursor == NULL);
+    assert(limdy_arena_used(&arena) == 0 && arena.chunk_size == 512);
+    assert(limdy_arena_alloc(&arena, 100) != NULL && chunk_count(&arena) == 1);
+    limdy_arena_release(&arena);
+    // Releasing twice is harmless
+    limdy_arena_release(&arena);
+    limdy_arena_release(NULL);
+
+    // Heap arenas are released by destroy
+    LimdyArena *heap;
+    assert(limdy_arena_create(0, &heap) == ERROR_SUCCESS);
+    assert(limdy_arena_alloc(heap, 100) != NULL);
+    limdy_arena_destroy(heap);
+    limdy_arena_destroy(NULL);
+
+    assert(limdy_arena_init(NULL, 0) == ERROR_NULL_POINTER);
+    assert(limdy_arena_create(0, NULL) == ERROR_NULL_POINTER);
+    assert(limdy_arena_alloc(NULL, 8) == NULL);
+    assert(limdy_arena_used(NULL) == 0);
+    printf("test_arena_release() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_arena_alloc();
+    test_arena_reset();
+    test_arena_alignment();
+    test_arena_large_alloc();
+    test_arena_strndup();
+    test_arena_release();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
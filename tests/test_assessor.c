@@ -0,0 +1,302 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <assert.h>
+#include "assessor.h"
+#include "token.h"
+#include "memory_pool.h"
+#include "error_handler.h"
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+static const LimdyAttentionKernel all_kernels[] = {
+    LIMDY_ATTENTION_KERNEL_SCALAR,
+    LIMDY_ATTENTION_KERNEL_SSE2,
+    LIMDY_ATTENTION_KERNEL_AVX2,
+    LIMDY_ATTENTION_KERNEL_NEON};
+
+static TokenizationService span_service = {.tokenize_spans = token_tokenize_spans};
+
+#define RANDOM_SUBMISSIONS 203
+#define MAX_RANDOM_TOKENS 150
+#define MAX_TEXT 4096
+
+static const char *const vocabulary[] = {"el", "gato", "negro", "come", "pescado", "la", "casa", "Grande", "y", "muy"};
+
+static uint64_t next_random(uint64_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Expected tokens of a text, pointing into it
+static size_t expected_tokens(const char *text, Token *tokens, size_t capacity)
+{
+    size_t count;
+    assert(token_tokenize_spans(text, strlen(text), LANG_SPANISH, tokens, capacity, &count) == ERROR_SUCCESS);
+    assert(count <= capacity);
+    for (size_t i = 0; i < count; i++)
+    {
+        tokens[i].text = (char *)text + tokens[i].offset;
+    }
+    return count;
+}
+
+static bool same_word(const Token *a, const Token *b)
+{
+    if (a->length != b->length)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a->length; i++)
+    {
+        if (tolower((unsigned char)a->text[i]) != tolower((unsigned char)b->text[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Textbook dynamic programming edit distance over tokens
+static size_t reference_distance(const Token *expected, size_t m, const Token *answer, size_t n)
+{
+    static size_t row[MAX_TEXT + 1];
+    for (size_t j = 0; j <= n; j++)
+    {
+        row[j] = j;
+    }
+    for (size_t i = 1; i <= m; i++)
+    {
+        size_t diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= n; j++)
+        {
+            size_t above = row[j];
+            size_t best = diagonal + !same_word(&expected[i - 1], &answer[j - 1]);
+            best = above + 1 < best ? above + 1 : best;
+            best = row[j - 1] + 1 < best ? row[j - 1] + 1 : best;
+            row[j] = best;
+            diagonal = above;
+        }
+    }
+    return row[n];
+}
+
+static AssessorSubmission submit(const Token *expected, size_t expected_count, const char *answer)
+{
+    return (AssessorSubmission){expected, expected_count, answer, strlen(answer)};
+}
+
+// Test functions
+void test_exact_and_case_folded()
+{
+    Assessor *assessor;
+    assert(assessor_create(&span_service, &assessor) == ERROR_SUCCESS);
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 0) == ERROR_SUCCESS);
+
+    Token expected[8];
+    size_t count = expected_tokens("el gato negro", expected, 8);
+    AssessorSubmission submissions[] = {
+        submit(expected, count, "El gato NEGRO."),
+        submit(expected, count, "el perro negro"),
+        submit(expected, count, "el gato"),
+        submit(expected, count, "gato el negro"),
+        submit(expected, count, ""),
+        submit(NULL, 0, ""),
+        submit(NULL, 0, "hola"),
+    };
+    size_t submission_count = sizeof(submissions) / sizeof(submissions[0]);
+    AssessorScore scores[7];
+    assert(assessor_score_batch(assessor, submissions, submission_count, LANG_SPANISH, &arena, scores) == ERROR_SUCCESS);
+
+    assert(scores[0].distance == 0 && scores[0].score == 1.0f && scores[0].answer_count == 3);
+    assert(scores[1].distance == 1);
+    assert(scores[2].distance == 1 && scores[2].answer_count == 2 && scores[2].expected_count == 3);
+    assert(scores[3].distance == 2);
+    assert(scores[4].distance == 3 && scores[4].score == 0.0f);
+    assert(scores[5].distance == 0 && scores[5].score == 1.0f);
+    assert(scores[6].distance == 1 && scores[6].score == 0.0f);
+
+    limdy_arena_release(&arena);
+    assessor_destroy(assessor);
+    printf("test_exact_and_case_folded() passed.\n");
+}
+
+void test_kernels_agree()
+{
+    static char expected_texts[RANDOM_SUBMISSIONS][MAX_TEXT];
+    static char answers[RANDOM_SUBMISSIONS][MAX_TEXT];
+    static Token expected[RANDOM_SUBMISSIONS][MAX_RANDOM_TOKENS];
+    static Token answer_tokens[MAX_RANDOM_TOKENS * 2];
+    static AssessorSubmission submissions[RANDOM_SUBMISSIONS];
+    static AssessorScore scores[RANDOM_SUBMISSIONS];
+    static size_t reference[RANDOM_SUBMISSIONS];
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+
+    // Lengths around one and two words of rows, answers that are edits of the expected tokens
+    for (size_t s = 0; s < RANDOM_SUBMISSIONS; s++)
+    {
+        size_t words = s % 7 == 0 ? 60 + next_random(&state) % (MAX_RANDOM_TOKENS - 60) : next_random(&state) % 70;
+        size_t length = 0;
+        size_t answer_length = 0;
+        for (size_t w = 0; w < words; w++)
+        {
+            const char *word = vocabulary[next_random(&state) % 10];
+            length += (size_t)sprintf(expected_texts[s] + length, "%s ", word);
+            switch (next_random(&state) % 6)
+            {
+            case 0:
+                break;
+            case 1:
+                answer_length += (size_t)sprintf(answers[s] + answer_length, "%s ", vocabulary[next_random(&state) % 10]);
+                break;
+            case 2:
+                answer_length += (size_t)sprintf(answers[s] + answer_length, "%s, %s ", word, vocabulary[next_random(&state) % 10]);
+                break;
+            default:
+                answer_length += (size_t)sprintf(answers[s] + answer_length, "%s ", word);
+                break;
+            }
+        }
+        size_t count = expected_tokens(expected_texts[s], expected[s], MAX_RANDOM_TOKENS);
+        assert(count == words);
+        submissions[s] = submit(expected[s], count, answers[s]);
+
+        size_t answer_count = expected_tokens(answers[s], answer_tokens, MAX_RANDOM_TOKENS * 2);
+        reference[s] = reference_distance(expected[s], count, answer_tokens, answer_count);
+    }
+
+    Assessor *assessor;
+    assert(assessor_create(&span_service, &assessor) == ERROR_SUCCESS);
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 0) == ERROR_SUCCESS);
+    for (size_t k = 0; k < sizeof(all_kernels) / sizeof(all_kernels[0]); k++)
+    {
+        if (assessor_set_kernel(assessor, all_kernels[k]) != ERROR_SUCCESS)
+        {
+            continue;
+        }
+        memset(scores, 0xff, sizeof(scores));
+        assert(assessor_score_batch(assessor, submissions, RANDOM_SUBMISSIONS, LANG_SPANISH, &arena, scores) == ERROR_SUCCESS);
+        for (size_t s = 0; s < RANDOM_SUBMISSIONS; s++)
+        {
+            assert(scores[s].distance == reference[s]);
+        }
+        limdy_arena_reset(&arena);
+
+        // Scores do not depend on which answers share lanes
+        for (size_t s = 0; s < RANDOM_SUBMISSIONS; s += 3)
+        {
+            AssessorScore single;
+            assert(assessor_score_batch(assessor, &submissions[s], 1, LANG_SPANISH, &arena, &single) == ERROR_SUCCESS);
+            assert(single.distance == reference[s] && single.score == scores[s].score);
+        }
+        limdy_arena_reset(&arena);
+    }
+    assert(assessor_set_kernel(assessor, LIMDY_ATTENTION_KERNEL_AUTO) == ERROR_SUCCESS);
+
+    limdy_arena_release(&arena);
+    assessor_destroy(assessor);
+    printf("test_kernels_agree() passed.\n");
+}
+
+void test_align()
+{
+    Assessor *assessor;
+    assert(assessor_create(&span_service, &assessor) == ERROR_SUCCESS);
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 0) == ERROR_SUCCESS);
+
+    Token expected[8];
+    size_t count = expected_tokens("el gato negro come", expected, 8);
+    AssessorSubmission submission = submit(expected, count, "el perro gato come pescado");
+    AssessorScore score;
+    AlignmentLink links[8];
+    size_t link_count;
+    assert(assessor_align(assessor, &submission, LANG_SPANISH, &arena, &score, links, &link_count) == ERROR_SUCCESS);
+    assert(score.distance == 3 && score.answer_count == 5);
+    assert(link_count == 3);
+    assert(links[0].source_index == 0 && links[0].target_index == 0);
+    assert(links[1].source_index == 1 && links[1].target_index == 2);
+    assert(links[2].source_index == 3 && links[2].target_index == 3);
+
+    // Long expected answers run over several words of rows
+    static char long_text[4096];
+    static char long_answer[4096];
+    static Token long_expected[300];
+    size_t length = 0;
+    size_t answer_length = 0;
+    for (size_t i = 0; i < 300; i++)
+    {
+        length += (size_t)sprintf(long_text + length, "w%zu ", i);
+        if (i != 100)
+        {
+            answer_length += (size_t)sprintf(long_answer + answer_length, "W%zu ", i);
+        }
+    }
+    count = expected_tokens(long_text, long_expected, 300);
+    static AlignmentLink long_links[300];
+    submission = submit(long_expected, count, long_answer);
+    assert(assessor_align(assessor, &submission, LANG_SPANISH, &arena, &score, long_links, &link_count) == ERROR_SUCCESS);
+    assert(score.distance == 1 && link_count == 299);
+    assert(long_links[99].source_index == 99 && long_links[100].source_index == 101 && long_links[100].target_index == 100);
+    AssessorScore batch_score;
+    assert(assessor_score_batch(assessor, &submission, 1, LANG_SPANISH, &arena, &batch_score) == ERROR_SUCCESS);
+    assert(batch_score.distance == 1);
+
+    limdy_arena_release(&arena);
+    assessor_destroy(assessor);
+    printf("test_align() passed.\n");
+}
+
+void test_invalid_arguments()
+{
+    TokenizationService no_spans = {0};
+    Assessor *assessor;
+    assert(assessor_create(&no_spans, &assessor) == ERROR_INVALID_ARGUMENT);
+    assert(assessor_create(NULL, &assessor) == ERROR_NULL_POINTER);
+    assert(assessor_create(&span_service, NULL) == ERROR_NULL_POINTER);
+    assert(assessor_create(&span_service, &assessor) == ERROR_SUCCESS);
+    assert(assessor_set_kernel(assessor, (LimdyAttentionKernel)42) == LIMDY_ATTENTION_ERROR_UNSUPPORTED);
+    assert(strlen(assessor_kernel_name(assessor)) > 0);
+
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 0) == ERROR_SUCCESS);
+    AssessorScore score;
+    AssessorSubmission missing = {NULL, 2, "a b", 3};
+    assert(assessor_score_batch(assessor, &missing, 1, LANG_ENGLISH, &arena, &score) == ERROR_NULL_POINTER);
+    assert(assessor_score_batch(assessor, NULL, 0, LANG_ENGLISH, &arena, NULL) == ERROR_SUCCESS);
+    assert(assessor_score_batch(assessor, &missing, 1, LANG_ENGLISH, NULL, &score) == ERROR_NULL_POINTER);
+
+    limdy_arena_release(&arena);
+    assessor_destroy(assessor);
+    assessor_destroy(NULL);
+    printf("test_invalid_arguments() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_exact_and_case_folded();
+    test_kernels_agree();
+    test_align();
+    test_invalid_arguments();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
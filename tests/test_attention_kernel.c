@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "attention_kernel.h"
+#include "error_handler.h"
+
+static const LimdyAttentionKernel all_kernels[] = {
+    LIMDY_ATTENTION_KERNEL_SCALAR,
+    LIMDY_ATTENTION_KERNEL_SSE2,
+    LIMDY_ATTENTION_KERNEL_AVX2,
+    LIMDY_ATTENTION_KERNEL_NEON};
+
+static void fill_random(LimdyMatrix *matrix, unsigned int seed)
+{
+    srand(seed);
+    for (size_t i = 0; i < matrix->rows; i++)
+    {
+        for (size_t j = 0; j < matrix->cols; j++)
+        {
+            // Coarse values so that ties actually occur
+            limdy_matrix_row(matrix, i)[j] = (float)(rand() % 16) / 16.0f;
+        }
+    }
+}
+
+// Test functions
+void test_argmax_kernels_agree()
+{
+    static const size_t shapes[][2] = {{1, 1}, {3, 5}, {17, 9}, {40, 33}, {64, 128}};
+
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++)
+    {
+        LimdyMatrix matrix;
+        assert(limdy_matrix_init(&matrix, shapes[s][0], shapes[s][1]) == ERROR_SUCCESS);
+        fill_random(&matrix, (unsigned int)s + 1);
+
+        uint32_t expected_rows[128], expected_cols[128], rows[128], cols[128];
+        float expected_row_scores[128], expected_col_scores[128], row_scores[128], col_scores[128];
+
+        assert(limdy_attention_set_kernel(LIMDY_ATTENTION_KERNEL_SCALAR) == ERROR_SUCCESS);
+        limdy_attention_row_argmax(&matrix, expected_rows, expected_row_scores);
+        limdy_attention_col_argmax(&matrix, expected_cols, expected_col_scores);
+
+        for (size_t k = 0; k < sizeof(all_kernels) / sizeof(all_kernels[0]); k++)
+        {
+            if (limdy_attention_set_kernel(all_kernels[k]) != ERROR_SUCCESS)
+            {
+                continue;
+            }
+            limdy_attention_row_argmax(&matrix, rows, row_scores);
+            limdy_attention_col_argmax(&matrix, cols, col_scores);
+            assert(memcmp(rows, expected_rows, matrix.rows * sizeof(uint32_t)) == 0);
+            assert(memcmp(row_scores, expected_row_scores, matrix.rows * sizeof(float)) == 0);
+            assert(memcmp(cols, expected_cols, matrix.cols * sizeof(uint32_t)) == 0);
+            assert(memcmp(col_scores, expected_col_scores, matrix.cols * sizeof(float)) == 0);
+        }
+
+        limdy_matrix_free(&matrix);
+    }
+
+    assert(limdy_attention_set_kernel(LIMDY_ATTENTION_KERNEL_AUTO) == ERROR_SUCCESS);
+    printf("test_argmax_kernels_agree() passed.\n");
+}
+
+void test_align_intersection()
+{
+    // Source 2 attends most to target 1 but target 1 prefers source 1
+    static const float values[3][3] = {
+        {0.9f, 0.1f, 0.0f},
+        {0.1f, 0.8f, 0.1f},
+        {0.0f, 0.6f, 0.4f}};
+
+    LimdyMatrix matrix;
+    LimdyArena scratch;
+    AlignmentLink links[6];
+    size_t count = 0;
+
+    assert(limdy_matrix_init(&matrix, 3, 3) == ERROR_SUCCESS);
+    for (size_t i = 0; i < 3; i++)
+    {
+        memcpy(limdy_matrix_row(&matrix, i), values[i], sizeof(values[i]));
+    }
+    assert(limdy_arena_init(&scratch, 0) == ERROR_SUCCESS);
+
+    LimdyAlignOptions options = {LIMDY_ALIGN_INTERSECTION, 0.0f};
+    assert(limdy_attention_align(&matrix, &options, &scratch, links, &count) == ERROR_SUCCESS);
+    assert(count == 2);
+    assert(links[0].source_index == 0 && links[0].target_index == 0);
+    assert(links[1].source_index == 1 && links[1].target_index == 1);
+
+    // Grow-diag-final also takes the union points next to (1, 1) for the unaligned source 2 and target 2
+    options.mode = LIMDY_ALIGN_GROW_DIAG_FINAL;
+    assert(limdy_attention_align(&matrix, &options, &scratch, links, &count) == ERROR_SUCCESS);
+    assert(count == 4);
+    assert(links[2].source_index == 2 && links[2].target_index == 1);
+    assert(links[3].source_index == 2 && links[3].target_index == 2);
+    assert(links[3].score == 0.4f);
+
+    // A threshold drops weak links before symmetrization
+    options.threshold = 0.85f;
+    assert(limdy_attention_align(&matrix, &options, &scratch, links, &count) == ERROR_SUCCESS);
+    assert(count == 1);
+    assert(links[0].source_index == 0 && links[0].target_index == 0);
+
+    limdy_arena_release(&scratch);
+    limdy_matrix_free(&matrix);
+    printf("test_align_intersection() passed.\n");
+}
+
+void test_align_union_bounds()
+{
+    LimdyMatrix matrix;
+    LimdyArena scratch;
+    assert(limdy_matrix_init(&matrix, 23, 41) == ERROR_SUCCESS);
+    assert(limdy_arena_init(&scratch, 0) == ERROR_SUCCESS);
+    fill_random(&matrix, 7);
+
+    size_t capacity = limdy_attention_align_capacity(matrix.rows, matrix.cols);
+    AlignmentLink *links = malloc(capacity * sizeof(AlignmentLink));
+    size_t count = 0;
+
+    LimdyAlignOptions options = {LIMDY_ALIGN_UNION, 0.0f};
+    assert(limdy_attention_align(&matrix, &options, &scratch, links, &count) == ERROR_SUCCESS);
+    assert(count >= matrix.cols && count <= capacity);
+    for (size_t i = 1; i < count; i++)
+    {
+        // Sorted and free of duplicates
+        assert(links[i - 1].source_index < links[i].source_index ||
+               (links[i - 1].source_index == links[i].source_index && links[i - 1].target_index < links[i].target_index));
+    }
+
+    free(links);
+    limdy_arena_release(&scratch);
+    limdy_matrix_free(&matrix);
+    printf("test_align_union_bounds() passed.\n");
+}
+
+int main()
+{
+    error_init();
+
+    test_argmax_kernels_agree();
+    test_align_intersection();
+    test_align_union_bounds();
+
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
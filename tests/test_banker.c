@@ -0,0 +1,232 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "banker.h"
+#include "linguistic_element.h"
+#include "error_handler.h"
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+#define BANK_PATH "test_banker.bank"
+#define MAP_WORDS 500
+
+static void make_token(Token *token, char *text, TokenClassSet classes)
+{
+    memset(token, 0, sizeof(Token));
+    token->text = text;
+    token->length = strlen(text);
+    token->classes = classes;
+}
+
+static void corrupt_byte(const char *path, long offset)
+{
+    FILE *file = fopen(path, "r+b");
+    assert(file);
+    assert(fseek(file, offset, SEEK_SET) == 0);
+    int byte = fgetc(file);
+    assert(fseek(file, offset, SEEK_SET) == 0);
+    fputc(byte ^ 0xff, file);
+    fclose(file);
+}
+
+// Test functions
+void test_write_and_find()
+{
+    Token tokens[3];
+    make_token(&tokens[0], "the", 0);
+    make_token(&tokens[1], "walk", TOKEN_CLASS_BIT(CLS_VERB) | TOKEN_CLASS_BIT(CLS_NOUN));
+    make_token(&tokens[2], "dog", TOKEN_CLASS_BIT(CLS_NOUN));
+
+    LinguisticElement elements[] = {
+        {.type = ELEMENT_VOCAB, .tokens = &tokens[1], .token_count = 1},
+        {.type = ELEMENT_PHRASE, .tokens = &tokens[0], .token_count = 3},
+        {.type = ELEMENT_VOCAB, .tokens = &tokens[2], .token_count = 1}};
+    BankerWriter *writer;
+    assert(banker_writer_create(&writer) == ERROR_SUCCESS);
+    for (size_t i = 0; i < 3; i++)
+    {
+        elements[i].hash = hash_linguistic_element(elements[i].tokens, elements[i].token_count);
+        assert(banker_writer_add(writer, &elements[i]) == ERROR_SUCCESS);
+    }
+    assert(banker_writer_write(writer, BANK_PATH) == ERROR_SUCCESS);
+    banker_writer_destroy(writer);
+
+    Banker *bank;
+    assert(banker_open(BANK_PATH, &bank) == ERROR_SUCCESS);
+    assert(banker_element_count(bank) == 3);
+
+    BankerElement found;
+    assert(banker_find_tokens(bank, elements[1].hash, tokens, 3, &found));
+    assert(found.type == ELEMENT_PHRASE && found.token_count == 3 && found.hash == elements[1].hash);
+
+    BankerToken token;
+    assert(banker_element_token(&found, 1, &token) == ERROR_SUCCESS);
+    assert(token.length == 4 && strcmp(token.text, "walk") == 0);
+    assert(token.classes == (TOKEN_CLASS_BIT(CLS_VERB) | TOKEN_CLASS_BIT(CLS_NOUN)));
+    assert(banker_element_token(&found, 0, &token) == ERROR_SUCCESS);
+    assert(strcmp(token.text, "the") == 0 && token.classes == 0);
+    assert(banker_element_token(&found, 3, &token) == ERROR_INVALID_ARGUMENT);
+
+    // Texts are stored once however many tokens use them
+    BankerElement walk;
+    BankerToken walk_token;
+    assert(banker_find(bank, elements[0].hash, &walk) && walk.type == ELEMENT_VOCAB);
+    assert(banker_element_token(&walk, 0, &walk_token) == ERROR_SUCCESS);
+    assert(banker_element_token(&found, 1, &token) == ERROR_SUCCESS);
+    assert(walk_token.text == token.text);
+
+    // Same texts with other classes are another element
+    Token retagged = tokens[1];
+    retagged.classes = TOKEN_CLASS_BIT(CLS_NOUN);
+    assert(!banker_find_tokens(bank, elements[0].hash, &retagged, 1, &found));
+    assert(!banker_find(bank, elements[0].hash ^ 1, &found));
+
+    // Iteration visits elements in the order they were added
+    for (size_t i = 0; i < 3; i++)
+    {
+        assert(banker_element_at(bank, i, &found) == ERROR_SUCCESS);
+        assert(found.hash == elements[i].hash && found.token_count == elements[i].token_count);
+    }
+    assert(banker_element_at(bank, 3, &found) == ERROR_INVALID_ARGUMENT);
+
+    banker_close(bank);
+    remove(BANK_PATH);
+
+    printf("test_write_and_find() passed.\n");
+}
+
+void test_write_map()
+{
+    static char words[MAP_WORDS][16];
+    static Token tokens[MAP_WORDS];
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_LARGE_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    LinguisticElementMap map;
+    assert(linguistic_element_map_init(&map, 16, pool) == ERROR_SUCCESS);
+    for (size_t i = 0; i < MAP_WORDS; i++)
+    {
+        snprintf(words[i], sizeof(words[i]), "word%zu", i);
+        make_token(&tokens[i], words[i], 0);
+        assert(linguistic_element_map_record(&map, ELEMENT_VOCAB, hash_linguistic_element(&tokens[i], 1), &tokens[i], 1) ==
+               ERROR_SUCCESS);
+    }
+
+    BankerWriter *writer;
+    assert(banker_writer_create(&writer) == ERROR_SUCCESS);
+    assert(banker_writer_add_map(writer, &map) == ERROR_SUCCESS);
+    assert(banker_writer_write(writer, BANK_PATH) == ERROR_SUCCESS);
+    banker_writer_destroy(writer);
+    linguistic_element_map_free(&map);
+    limdy_memory_pool_destroy(pool);
+
+    // The bank answers after the map and its pool are gone
+    Banker *bank;
+    assert(banker_open(BANK_PATH, &bank) == ERROR_SUCCESS);
+    assert(banker_element_count(bank) == MAP_WORDS);
+    for (size_t i = 0; i < MAP_WORDS; i++)
+    {
+        BankerElement found;
+        BankerToken token;
+        assert(banker_find_tokens(bank, hash_linguistic_element(&tokens[i], 1), &tokens[i], 1, &found));
+        assert(banker_element_token(&found, 0, &token) == ERROR_SUCCESS);
+        assert(strcmp(token.text, words[i]) == 0);
+    }
+    banker_close(bank);
+    remove(BANK_PATH);
+
+    printf("test_write_map() passed.\n");
+}
+
+void test_reject_bad_files()
+{
+    Token token;
+    make_token(&token, "word", 0);
+    LinguisticElement element = {.type = ELEMENT_VOCAB, .tokens = &token, .token_count = 1, .hash = hash_linguistic_element(&token, 1)};
+    BankerWriter *writer;
+    assert(banker_writer_create(&writer) == ERROR_SUCCESS);
+    assert(banker_writer_add(writer, &element) == ERROR_SUCCESS);
+    assert(banker_writer_write(writer, BANK_PATH) == ERROR_SUCCESS);
+
+    Banker *bank;
+    assert(banker_open("test_banker_missing.bank", &bank) == ERROR_FILE_IO);
+
+    // Magic, version and the checksummed header
+    corrupt_byte(BANK_PATH, 0);
+    assert(banker_open(BANK_PATH, &bank) == LIMDY_BANKER_ERROR_BAD_FORMAT);
+    assert(banker_writer_write(writer, BANK_PATH) == ERROR_SUCCESS);
+    corrupt_byte(BANK_PATH, 8);
+    assert(banker_open(BANK_PATH, &bank) == LIMDY_BANKER_ERROR_VERSION);
+    assert(banker_writer_write(writer, BANK_PATH) == ERROR_SUCCESS);
+    corrupt_byte(BANK_PATH, 40);
+    assert(banker_open(BANK_PATH, &bank) == LIMDY_BANKER_ERROR_BAD_FORMAT);
+
+    // A truncated bank no longer matches its recorded size
+    assert(banker_writer_write(writer, BANK_PATH) == ERROR_SUCCESS);
+    FILE *file = fopen(BANK_PATH, "ab");
+    assert(file);
+    fputc(0, file);
+    fclose(file);
+    assert(banker_open(BANK_PATH, &bank) == LIMDY_BANKER_ERROR_BAD_FORMAT);
+    file = fopen(BANK_PATH, "wb");
+    assert(file);
+    fputs("LIMDYBK1", file);
+    fclose(file);
+    assert(banker_open(BANK_PATH, &bank) == LIMDY_BANKER_ERROR_BAD_FORMAT);
+
+    // Rewriting replaces the damaged file
+    assert(banker_writer_write(writer, BANK_PATH) == ERROR_SUCCESS);
+    assert(banker_open(BANK_PATH, &bank) == ERROR_SUCCESS);
+    BankerElement found;
+    assert(banker_find_tokens(bank, element.hash, &token, 1, &found));
+    banker_close(bank);
+
+    banker_writer_destroy(writer);
+    remove(BANK_PATH);
+
+    printf("test_reject_bad_files() passed.\n");
+}
+
+void test_empty_bank()
+{
+    BankerWriter *writer;
+    assert(banker_writer_create(&writer) == ERROR_SUCCESS);
+    assert(banker_writer_write(writer, BANK_PATH) == ERROR_SUCCESS);
+    banker_writer_destroy(writer);
+
+    Banker *bank;
+    assert(banker_open(BANK_PATH, &bank) == ERROR_SUCCESS);
+    assert(banker_element_count(bank) == 0);
+    BankerElement found;
+    assert(!banker_find(bank, 0, &found));
+    assert(!banker_find_tokens(bank, 0, NULL, 0, &found));
+    banker_close(bank);
+    remove(BANK_PATH);
+
+    assert(banker_writer_create(NULL) == ERROR_NULL_POINTER);
+    assert(banker_open(NULL, &bank) == ERROR_NULL_POINTER);
+
+    printf("test_empty_bank() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_write_and_find();
+    test_write_map();
+    test_reject_bad_files();
+    test_empty_bank();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
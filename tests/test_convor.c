@@ -0,0 +1,220 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "convor.h"
+#include "error_handler.h"
+#include "test_fixtures.h"
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+ErrorCode mock_translate(const char *text, const char *source_lang, const char *target_lang, char **translated_text)
+{
+    (void)text;
+    (void)source_lang;
+    (void)target_lang;
+    *translated_text = strdup("Mocked translation");
+    return ERROR_SUCCESS;
+}
+
+// Produces the translation a word at a time
+ErrorCode mock_translate_stream(const char *text, const char *source_lang, const char *target_lang,
+                                TranslationPartialFn partial, void *context, char **translated_text)
+{
+    partial(context, "Mocked", 6);
+    partial(context, "Mocked translation", 18);
+    return mock_translate(text, source_lang, target_lang, translated_text);
+}
+
+ErrorCode mock_get_attention_dense(const char *source_text, const char *translated_text, LimdyMatrix *attention)
+{
+    (void)source_text;
+    (void)translated_text;
+    RETURN_IF_ERROR(limdy_matrix_init(attention, 2, 2));
+    limdy_matrix_row(attention, 0)[1] = 0.9f;
+    limdy_matrix_row(attention, 1)[0] = 0.8f;
+    return ERROR_SUCCESS;
+}
+
+void mock_free_translation(char *translated_text, float **attention_matrix, size_t rows)
+{
+    (void)attention_matrix;
+    (void)rows;
+    free(translated_text);
+}
+
+TranslationService mock_translation_service = {
+    .translate = mock_translate,
+    .get_attention_dense = mock_get_attention_dense,
+    .free_translation = mock_free_translation,
+    .translate_stream = mock_translate_stream};
+
+static Renderer *create_renderer(LimdyMemoryPool *pool)
+{
+    TestRendererConfig config = {.tokenizer = TEST_TOKENIZER_BUILTIN};
+    Renderer *renderer = test_create_renderer(pool, &config);
+    PhraseExtractorConfig phrases = {2, 3, 2};
+    assert(renderer_set_phrase_config(renderer, &phrases) == ERROR_SUCCESS);
+    return renderer;
+}
+
+static ExtendedLinguisticElement *find_phrase(const RendererResult *result, size_t first, size_t length)
+{
+    LinguisticElementMap *map = (LinguisticElementMap *)&result->phrase_map;
+    return linguistic_element_map_find_tokens(map, phrase_extractor_hash(&result->tokens[first], length), &result->tokens[first], length);
+}
+
+typedef struct
+{
+    size_t calls;
+    size_t length;
+} PartialLog;
+
+static void record_partial(void *context, const char *partial_text, size_t length)
+{
+    PartialLog *log = context;
+    assert(length > log->length && strncmp(partial_text, "Mocked translation", length) == 0);
+    log->length = length;
+    log->calls++;
+}
+
+// Test functions
+void test_turns()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool);
+    TranslatorAligner *ta = translator_aligner_create(&mock_translation_service, NULL, renderer);
+    assert(ta != NULL);
+
+    Conversation *conversation;
+    assert(conversation_create(ta, LANG_ENGLISH, "en", "fr", &conversation) == ERROR_SUCCESS);
+    const char *utterances[] = {"the cat sat on the mat", "and the cat ran", "but the cat sat"};
+    for (size_t i = 0; i < 3; i++)
+    {
+        PartialLog log = {0};
+        assert(conversation_add_turn(conversation, utterances[i], record_partial, &log) == ERROR_SUCCESS);
+        assert(log.calls == 2 && log.length == 18);
+    }
+    assert(conversation_turn_count(conversation) == 3);
+
+    const ConversationTurn *turn = conversation_turn(conversation, 1);
+    assert(strcmp(turn->text, "and the cat ran") == 0 && strcmp(turn->translated_text, "Mocked translation") == 0);
+    assert(turn->first_token == 6 && turn->token_count == 4);
+    assert(turn->alignment.source_count == 4 && strcmp(turn->alignment.source_tokens[0].text, "and") == 0);
+    assert(turn->alignment.link_count >= 1 && turn->alignment.links[0].source_index == 0 && turn->alignment.links[0].target_index == 1);
+    assert(conversation_turn(conversation, 3) == NULL);
+
+    // The tokens of all turns, with offsets counting from the start of the conversation
+    const RendererResult *result = conversation_result(conversation);
+    assert(result->token_count == 14);
+    assert(result->tokens[6].offset == 23 && strncmp(result->tokens[6].text, "and", 3) == 0);
+    assert(result->tokens[13].offset == 51 && strncmp(result->tokens[13].text, "sat", 3) == 0);
+
+    // Phrases are counted across turns
+    ExtendedLinguisticElement *the_cat = find_phrase(result, 0, 2);
+    assert(the_cat != NULL && the_cat->occurrence_count == 3);
+    assert(the_cat->occurrences[0] == &result->tokens[0]);
+    assert(the_cat->occurrences[2] == &result->tokens[11]);
+    assert(find_phrase(result, 0, 3)->occurrence_count == 2);
+    assert(result->phrase_map.element_count == 3);
+
+    // The vocab is that of rendering the conversation at once
+    RendererResult whole = {0};
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &whole.pool) == ERROR_SUCCESS);
+    assert(renderer_render(renderer, "the cat sat on the mat\nand the cat ran\nbut the cat sat", LANG_ENGLISH, &whole) == ERROR_SUCCESS);
+    assert(whole.token_count == result->token_count && whole.vocab_map.element_count == result->vocab_map.element_count);
+    for (size_t i = 0; i < whole.token_count; i++)
+    {
+        assert(whole.tokens[i].offset == result->tokens[i].offset);
+    }
+    renderer_free_result(renderer, &whole);
+
+    conversation_destroy(conversation);
+    translator_aligner_destroy(ta);
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_turns() passed.\n");
+}
+
+void test_long_conversation()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool);
+    TranslatorAligner *ta = translator_aligner_create(&mock_translation_service, NULL, renderer);
+    Conversation *conversation;
+    assert(conversation_create(ta, LANG_ENGLISH, "en", "fr", &conversation) == ERROR_SUCCESS);
+
+    // Enough turns to move the tokens several times; occurrences follow them
+    enum { TURNS = 300 };
+    char utterance[32];
+    for (size_t i = 0; i < TURNS; i++)
+    {
+        snprintf(utterance, sizeof(utterance), "w%zu all parts", i);
+        assert(conversation_add_turn(conversation, utterance, NULL, NULL) == ERROR_SUCCESS);
+    }
+
+    const RendererResult *result = conversation_result(conversation);
+    assert(result->token_count == TURNS * 3);
+    ExtendedLinguisticElement *all_parts = find_phrase(result, 1, 2);
+    assert(all_parts != NULL && all_parts->occurrence_count == TURNS);
+    for (size_t i = 0; i < TURNS; i++)
+    {
+        assert(all_parts->occurrences[i] == &result->tokens[i * 3 + 1]);
+        assert(&all_parts->occurrences[i][1] == &result->tokens[i * 3 + 2]);
+    }
+    assert(result->phrase_map.element_count == 1);
+    assert(strcmp(conversation_turn(conversation, TURNS - 1)->text, "w299 all parts") == 0);
+
+    conversation_destroy(conversation);
+    translator_aligner_destroy(ta);
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_long_conversation() passed.\n");
+}
+
+void test_error_handling()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool);
+    TranslatorAligner *ta = translator_aligner_create(&mock_translation_service, NULL, renderer);
+
+    Conversation *conversation;
+    assert(conversation_create(NULL, LANG_ENGLISH, "en", "fr", &conversation) == ERROR_NULL_POINTER);
+    assert(conversation_create(ta, LANG_ENGLISH, NULL, "fr", &conversation) == ERROR_NULL_POINTER);
+    assert(conversation_create(ta, LANG_ENGLISH, "en", "fr", &conversation) == ERROR_SUCCESS);
+    assert(conversation_add_turn(conversation, NULL, NULL, NULL) == ERROR_NULL_POINTER);
+    assert(conversation_add_turn(NULL, "Hello", NULL, NULL) == ERROR_NULL_POINTER);
+    assert(conversation_turn_count(conversation) == 0 && conversation_result(conversation)->token_count == 0);
+    assert(conversation_turn_count(NULL) == 0 && conversation_turn(NULL, 0) == NULL && conversation_result(NULL) == NULL);
+    conversation_destroy(conversation);
+    conversation_destroy(NULL);
+
+    translator_aligner_destroy(ta);
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_error_handling() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_turns();
+    test_long_conversation();
+    test_error_handling();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
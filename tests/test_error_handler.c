@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "error_handler.h"
+
+#define LOG_THREADS 8
+#define LOG_ROUNDS 5000
+
+static ErrorContext last_handled;
+static atomic_int handled;
+
+void capture_handler(const ErrorContext *context)
+{
+    memcpy(&last_handled, context, sizeof(ErrorContext));
+    atomic_fetch_add(&handled, 1);
+}
+
+void count_handler(const ErrorContext *context)
+{
+    atomic_fetch_add(&handled, 1);
+}
+
+// Test functions
+void test_deferred_format()
+{
+    error_set_handler(capture_handler);
+    char expected[256];
+
+    LOG_ERROR(ERROR_UNKNOWN, "int %d unsigned %u hex %#x char %c short %hd", -42, 42u, 255, 'z', (short)-7);
+    snprintf(expected, sizeof(expected), "int %d unsigned %u hex %#x char %c short %hd", -42, 42u, 255, 'z', (short)-7);
+    assert(strcmp(last_handled.message, expected) == 0);
+    assert(last_handled.code == ERROR_UNKNOWN && last_handled.level == ERROR_LEVEL_ERROR);
+
+    LOG_ERROR(ERROR_UNKNOWN, "%zu %ld %lld %jd %td %p", (size_t)123456789012, -5L, -6LL, (intmax_t)7, (ptrdiff_t)-8, (void *)0x1234);
+    snprintf(expected, sizeof(expected), "%zu %ld %lld %jd %td %p", (size_t)123456789012, -5L, -6LL, (intmax_t)7, (ptrdiff_t)-8, (void *)0x1234);
+    assert(strcmp(last_handled.message, expected) == 0);
+
+    LOG_ERROR(ERROR_UNKNOWN, "%.3f %e %-8g| %Lf 100%%", 3.14159, 2.5e-9, 1.0 / 3, (long double)0.5);
+    snprintf(expected, sizeof(expected), "%.3f %e %-8g| %Lf 100%%", 3.14159, 2.5e-9, 1.0 / 3, (long double)0.5);
+    assert(strcmp(last_handled.message, expected) == 0);
+
+    // Widths and precisions taken from arguments
+    LOG_ERROR(ERROR_UNKNOWN, "[%*d] [%-*.*s] [%.2s]", 6, 42, 7, 3, "abcdef", "xyz");
+    snprintf(expected, sizeof(expected), "[%*d] [%-*.*s] [%.2s]", 6, 42, 7, 3, "abcdef", "xyz");
+    assert(strcmp(last_handled.message, expected) == 0);
+
+    // Strings are copied, so they may be freed right after logging
+    char *name = strdup("temporary.txt");
+    LOG_ERROR(ERROR_FILE_IO, "Failed to open %s", name);
+    memset(name, 'X', strlen(name));
+    free(name);
+    assert(strcmp(error_get_last()->message, "Failed to open temporary.txt") == 0);
+    assert(error_get_last()->code == ERROR_FILE_IO);
+
+    // More arguments than can be packed are formatted at once
+    LOG_ERROR(ERROR_UNKNOWN, "%d %d %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8, 9, 10);
+    assert(strcmp(last_handled.message, "1 2 3 4 5 6 7 8 9 10") == 0);
+    assert(strcmp(error_get_last()->message, "1 2 3 4 5 6 7 8 9 10") == 0);
+
+    error_clear();
+    assert(error_get_last()->code == ERROR_SUCCESS);
+
+    error_set_handler(NULL);
+    printf("test_deferred_format() passed.\n");
+}
+
+void test_history()
+{
+    error_set_handler(count_handler);
+    for (int i = 0; i < 5; i++)
+    {
+        LOG_WARNING(ERROR_INVALID_ARGUMENT, "history entry %d", i);
+    }
+
+    ErrorContext history[LIMDY_ERROR_HISTORY_SIZE];
+    assert(error_get_history(history, 5) == 5);
+    for (int i = 0; i < 5; i++)
+    {
+        char expected[32];
+        snprintf(expected, sizeof(expected), "history entry %d", i);
+        assert(strcmp(history[i].message, expected) == 0);
+        assert(history[i].level == ERROR_LEVEL_WARNING);
+    }
+
+    // The ring keeps only the most recent errors
+    for (int i = 0; i < 2 * LIMDY_ERROR_HISTORY_SIZE; i++)
+    {
+        LOG_DEBUG(ERROR_UNKNOWN, "filler %d", i);
+    }
+    assert(error_get_history(history, LIMDY_ERROR_HISTORY_SIZE) == LIMDY_ERROR_HISTORY_SIZE);
+    assert(strcmp(history[0].message, "filler 128") == 0);
+    assert(strcmp(history[LIMDY_ERROR_HISTORY_SIZE - 1].message, "filler 255") == 0);
+
+    error_set_handler(NULL);
+    printf("test_history() passed.\n");
+}
+
+void test_rate_limit()
+{
+    error_set_handler(count_handler);
+    error_set_rate_limit(3);
+
+    ErrorStats before, after;
+    error_get_stats(&before);
+    atomic_store(&handled, 0);
+    for (int i = 0; i < 10; i++)
+    {
+        LOG_ERROR(ERROR_UNKNOWN, "burst %d", i);
+    }
+    error_get_stats(&after);
+
+    // One call site reaches the handler three times in a second, unless the second turned over
+    assert(atomic_load(&handled) == 3 || atomic_load(&handled) == 6);
+    assert(after.logged - before.logged == 10);
+    assert(after.suppressed - before.suppressed == 10 - (size_t)atomic_load(&handled));
+
+    // Suppressed errors still reach the last error and the history
+    assert(strcmp(error_get_last()->message, "burst 9") == 0);
+    ErrorContext history[1];
+    assert(error_get_history(history, 1) == 1 && strcmp(history[0].message, "burst 9") == 0);
+
+    // Another call site has its own budget
+    LOG_ERROR(ERROR_UNKNOWN, "elsewhere");
+    assert(strcmp(error_get_last()->message, "elsewhere") == 0);
+
+    error_set_rate_limit(0);
+    atomic_store(&handled, 0);
+    for (int i = 0; i < 10; i++)
+    {
+        LOG_ERROR(ERROR_UNKNOWN, "unlimited %d", i);
+    }
+    assert(atomic_load(&handled) == 10);
+
+    error_set_rate_limit(LIMDY_ERROR_RATE_LIMIT_DEFAULT);
+    error_set_handler(NULL);
+    printf("test_rate_limit() passed.\n");
+}
+
+static void *log_worker(void *arg)
+{
+    int thread = (int)(intptr_t)arg;
+    for (int i = 0; i < LOG_ROUNDS; i++)
+    {
+        LOG_ERROR(ERROR_MEMORY_ALLOCATION, "thread %d item %d of %s", thread, i, "worker");
+    }
+    // Each thread's last error is its own
+    char expected[64];
+    snprintf(expected, sizeof(expected), "thread %d item %d of worker", thread, LOG_ROUNDS - 1);
+    assert(strcmp(error_get_last()->message, expected) == 0);
+    return NULL;
+}
+
+void test_concurrent_logging()
+{
+    error_set_handler(count_handler);
+    ErrorStats before, after;
+    error_get_stats(&before);
+
+    pthread_t threads[LOG_THREADS];
+    for (int i = 0; i < LOG_THREADS; i++)
+    {
+        assert(pthread_create(&threads[i], NULL, log_worker, (void *)(intptr_t)i) == 0);
+    }
+    for (int i = 0; i < LOG_THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    error_get_stats(&after);
+    assert(after.logged - before.logged == LOG_THREADS * LOG_ROUNDS);
+
+    // Every entry that survived is whole
+    ErrorContext history[LIMDY_ERROR_HISTORY_SIZE];
+    size_t count = error_get_history(history, LIMDY_ERROR_HISTORY_SIZE);
+    assert(count > 0);
+    for (size_t i = 0; i < count; i++)
+    {
+        int thread, item;
+        assert(sscanf(history[i].message, "thread %d item %d of worker", &thread, &item) == 2);
+        assert(thread >= 0 && thread < LOG_THREADS && item >= 0 && item < LOG_ROUNDS);
+        assert(history[i].code == ERROR_MEMORY_ALLOCATION);
+    }
+
+    error_set_handler(NULL);
+    printf("test_concurrent_logging() passed.\n");
+}
+
+int main()
+{
+    error_init();
+
+    test_deferred_format();
+    test_history();
+    test_rate_limit();
+    test_concurrent_logging();
+
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
@@ -0,0 +1,280 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "exerciser.h"
+#include "renderer.h"
+#include "error_handler.h"
+#include "test_fixtures.h"
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+#define CLASS_TEXTS 12
+#define CLASS_SENTENCES 150
+
+static Renderer *create_renderer(LimdyMemoryPool *pool)
+{
+    TestRendererConfig config = {.tokenizer = TEST_TOKENIZER_BUILTIN};
+    return test_create_renderer(pool, &config);
+}
+
+static ExerciseTemplate *compile(ExerciseType type, const char *pattern, size_t context_tokens, size_t group_size)
+{
+    ExerciseTemplateConfig config = {.type = type, .pattern = pattern, .context_tokens = context_tokens, .group_size = group_size};
+    ExerciseTemplate *exercise_template;
+    assert(exercise_template_compile(&config, &exercise_template) == ERROR_SUCCESS);
+    return exercise_template;
+}
+
+static const Exercise *find_exercise(const ExerciseBatch *batch, uint64_t hash)
+{
+    for (size_t i = 0; i < batch->exercise_count; i++)
+    {
+        if (batch->exercises[i].element_hashes[0] == hash)
+        {
+            return &batch->exercises[i];
+        }
+    }
+    return NULL;
+}
+
+// Test functions
+void test_template_compile()
+{
+    ExerciseTemplate *exercise_template;
+    ExerciseTemplateConfig config = {.type = EXERCISE_CLOZE, .pattern = "Fill {blank}"};
+    assert(exercise_template_compile(&config, &exercise_template) == LIMDY_EXERCISER_ERROR_BAD_TEMPLATE);
+    config.pattern = "Trailing {";
+    assert(exercise_template_compile(&config, &exercise_template) == LIMDY_EXERCISER_ERROR_BAD_TEMPLATE);
+    config.pattern = "{body}";
+    config.group_size = 1;
+    assert(exercise_template_compile(&config, &exercise_template) == ERROR_INVALID_ARGUMENT);
+    config.group_size = 0;
+    config.type = EXERCISE_TYPE_COUNT;
+    assert(exercise_template_compile(&config, &exercise_template) == ERROR_INVALID_ARGUMENT);
+    assert(exercise_template_compile(NULL, &exercise_template) == ERROR_NULL_POINTER);
+    exercise_template_destroy(NULL);
+
+    printf("test_template_compile() passed.\n");
+}
+
+void test_cloze_and_reordering()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool);
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 0) == ERROR_SUCCESS);
+
+    const char *text = "the cat sat on the mat, the cat ran";
+    RendererResult result = {.arena = &arena};
+    assert(renderer_render(renderer, text, LANG_ENGLISH, &result) == ERROR_SUCCESS);
+
+    Exerciser *exerciser;
+    assert(exerciser_create(1, &exerciser) == ERROR_SUCCESS);
+    ExerciseTemplate *cloze = compile(EXERCISE_CLOZE, "{{{body}} ({body})", 2, 0);
+    ExerciseTemplate *reorder = compile(EXERCISE_REORDERING, "Order: {body}", 0, 0);
+    ExerciserRequest requests[] = {
+        {.result = &result, .map = &result.vocab_map, .exercise_template = cloze},
+        {.result = &result, .map = &result.phrase_map, .exercise_template = cloze},
+        {.result = &result, .map = &result.phrase_map, .exercise_template = reorder},
+        {.result = &result, .map = &result.vocab_map, .exercise_template = reorder}};
+
+    ExerciseBatch batch;
+    assert(exerciser_generate(exerciser, requests, 4, &arena, &batch) == ERROR_SUCCESS);
+
+    // Vocab blanks the token the element was copied from, phrases their first occurrence
+    Token sat = {.text = "sat", .length = 3};
+    const Exercise *exercise = find_exercise(&batch, hash_linguistic_element(&sat, 1));
+    assert(exercise && exercise->request == 0 && exercise->type == EXERCISE_CLOZE);
+    assert(strcmp(exercise->prompt, "{the cat ____ on the} (the cat ____ on the)") == 0);
+    assert(exercise->prompt_length == strlen(exercise->prompt));
+    assert(strcmp(exercise->answer, "sat") == 0 && exercise->element_count == 1);
+
+    Token the_cat[] = {{.text = "the", .length = 3}, {.text = "cat", .length = 3}};
+    uint64_t phrase_hash = phrase_extractor_hash(the_cat, 2);
+    size_t phrase_exercises = 0;
+    for (size_t i = 0; i < batch.exercise_count; i++)
+    {
+        exercise = &batch.exercises[i];
+        if (exercise->element_hashes[0] != phrase_hash)
+        {
+            continue;
+        }
+        phrase_exercises++;
+        assert(strcmp(exercise->answer, "the cat") == 0);
+        if (exercise->type == EXERCISE_CLOZE)
+        {
+            assert(exercise->request == 1 && strcmp(exercise->prompt, "{____ sat on} (____ sat on)") == 0);
+        }
+        else
+        {
+            // Two tokens only ever shuffle one way
+            assert(exercise->request == 2 && strcmp(exercise->prompt, "Order: cat / the") == 0);
+        }
+    }
+    assert(phrase_exercises == 2);
+
+    // Single tokens cannot be reordered; exercises come in request order
+    for (size_t i = 1; i < batch.exercise_count; i++)
+    {
+        assert(batch.exercises[i].request != 3 && batch.exercises[i].request >= batch.exercises[i - 1].request);
+    }
+
+    exercise_template_destroy(cloze);
+    exercise_template_destroy(reorder);
+    exerciser_destroy(exerciser);
+    renderer_free_result(renderer, &result);
+    limdy_arena_release(&arena);
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_cloze_and_reordering() passed.\n");
+}
+
+void test_matching()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool);
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 0) == ERROR_SUCCESS);
+
+    RendererResult result = {.arena = &arena};
+    assert(renderer_render(renderer, "one two three four five", LANG_ENGLISH, &result) == ERROR_SUCCESS);
+
+    Exerciser *exerciser;
+    assert(exerciser_create(1, &exerciser) == ERROR_SUCCESS);
+    ExerciseTemplate *matching = compile(EXERCISE_MATCHING, "{body}", 1, 2);
+    ExerciserRequest request = {.result = &result, .map = &result.vocab_map, .exercise_template = matching};
+    ExerciseBatch batch;
+    assert(exerciser_generate(exerciser, &request, 1, &arena, &batch) == ERROR_SUCCESS);
+
+    // Five words make two pairs; the odd one out has nothing to be matched with
+    assert(batch.exercise_count == 2);
+    for (size_t i = 0; i < batch.exercise_count; i++)
+    {
+        const Exercise *exercise = &batch.exercises[i];
+        assert(exercise->type == EXERCISE_MATCHING && exercise->element_count == 2);
+        assert(strncmp(exercise->prompt, "1. ", 3) == 0 && strstr(exercise->prompt, "\n2. ") != NULL);
+
+        // The answer lists the words in the order of the contexts, the prompt shuffled
+        const char *comma = strchr(exercise->answer, ',');
+        assert(comma && comma[1] == ' ');
+        char first[16];
+        snprintf(first, sizeof(first), "%.*s", (int)(comma - exercise->answer), exercise->answer);
+        const char *words = strstr(exercise->prompt, "\nWords: ");
+        assert(words);
+        char expected[40];
+        snprintf(expected, sizeof(expected), "\nWords: %s, %s", comma + 2, first);
+        assert(strcmp(words, expected) == 0);
+    }
+
+    exercise_template_destroy(matching);
+    exerciser_destroy(exerciser);
+    renderer_free_result(renderer, &result);
+    limdy_arena_release(&arena);
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_matching() passed.\n");
+}
+
+void test_parallel_batch()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_LARGE_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool);
+    LimdyArena result_arena, serial_arena, parallel_arena;
+    assert(limdy_arena_init(&result_arena, 0) == ERROR_SUCCESS);
+    assert(limdy_arena_init(&serial_arena, 0) == ERROR_SUCCESS);
+    assert(limdy_arena_init(&parallel_arena, 0) == ERROR_SUCCESS);
+
+    // A class of texts, each large enough to span several chunks
+    static char texts[CLASS_TEXTS][CLASS_SENTENCES * 40];
+    RendererResult results[CLASS_TEXTS];
+    ExerciserRequest requests[CLASS_TEXTS * 3];
+    ExerciseTemplate *templates[] = {compile(EXERCISE_CLOZE, "Fill in: {body}", 0, 0),
+                                     compile(EXERCISE_MATCHING, "Match:\n{body}", 0, 0),
+                                     compile(EXERCISE_REORDERING, "{body}", 0, 0)};
+    for (size_t t = 0; t < CLASS_TEXTS; t++)
+    {
+        size_t length = 0;
+        for (size_t s = 0; s < CLASS_SENTENCES; s++)
+        {
+            length += snprintf(texts[t] + length, sizeof(texts[t]) - length, "w%zu x%zu y%zu z. ", (t * 31 + s * 7) % 97,
+                               (s * 13) % 41, s % 5);
+        }
+        results[t] = (RendererResult){.arena = &result_arena};
+        assert(renderer_render(renderer, texts[t], LANG_ENGLISH, &results[t]) == ERROR_SUCCESS);
+        requests[t * 3] = (ExerciserRequest){&results[t], &results[t].vocab_map, templates[0]};
+        requests[t * 3 + 1] = (ExerciserRequest){&results[t], &results[t].vocab_map, templates[1]};
+        requests[t * 3 + 2] = (ExerciserRequest){&results[t], &results[t].phrase_map, templates[2]};
+    }
+
+    Exerciser *serial, *parallel;
+    assert(exerciser_create(1, &serial) == ERROR_SUCCESS);
+    assert(exerciser_create(4, &parallel) == ERROR_SUCCESS);
+    ExerciseBatch expected, batch;
+    assert(exerciser_generate(serial, requests, CLASS_TEXTS * 3, &serial_arena, &expected) == ERROR_SUCCESS);
+    size_t used = limdy_arena_used(&parallel_arena);
+    assert(exerciser_generate(parallel, requests, CLASS_TEXTS * 3, &parallel_arena, &batch) == ERROR_SUCCESS);
+    assert(expected.exercise_count > CLASS_TEXTS * 3);
+    const char *block_end = (const char *)batch.exercises + (limdy_arena_used(&parallel_arena) - used);
+
+    // Workers change nothing about the output
+    assert(batch.exercise_count == expected.exercise_count);
+    for (size_t i = 0; i < batch.exercise_count; i++)
+    {
+        const Exercise *a = &batch.exercises[i];
+        const Exercise *b = &expected.exercises[i];
+        assert(a->type == b->type && a->request == b->request && a->element_count == b->element_count);
+        assert(memcmp(a->element_hashes, b->element_hashes, a->element_count * sizeof(uint64_t)) == 0);
+        assert(a->prompt_length == b->prompt_length && strcmp(a->prompt, b->prompt) == 0);
+        assert(a->answer_length == b->answer_length && strcmp(a->answer, b->answer) == 0);
+        // Everything sits in one block of the arena
+        assert(a->prompt > (const char *)batch.exercises && a->answer < block_end);
+    }
+
+    // Nothing to do is not an error
+    assert(exerciser_generate(parallel, requests, 0, &parallel_arena, &batch) == ERROR_SUCCESS && batch.exercise_count == 0);
+    ExerciserRequest incomplete = {.result = &results[0]};
+    assert(exerciser_generate(parallel, &incomplete, 1, &parallel_arena, &batch) == ERROR_NULL_POINTER);
+
+    for (size_t i = 0; i < 3; i++)
+    {
+        exercise_template_destroy(templates[i]);
+    }
+    exerciser_destroy(serial);
+    exerciser_destroy(parallel);
+    for (size_t t = 0; t < CLASS_TEXTS; t++)
+    {
+        renderer_free_result(renderer, &results[t]);
+    }
+    limdy_arena_release(&result_arena);
+    limdy_arena_release(&serial_arena);
+    limdy_arena_release(&parallel_arena);
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_parallel_batch() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_template_compile();
+    test_cloze_and_reordering();
+    test_matching();
+    test_parallel_batch();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file test_fixtures.h
+ * @brief Mock services and a renderer factory shared by the renderer tests.
+ *
+ * The mock tokenizer splits on a configurable set of separator characters
+ * and the mock classifier gives every token the same classes. Both count
+ * their calls, so tests can tell whether a render reached the services.
+ * The services take no context, so the configuration of the most recently
+ * created renderer applies to all of them.
+ *
+ * @author Mirza Bicer
+ * @date 2026-10-15
+ */
+
+#ifndef LIMDY_TESTS_FIXTURES_H
+#define LIMDY_TESTS_FIXTURES_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdatomic.h>
+#include "renderer.h"
+
+/**
+ * @brief Tokenizers a test renderer can be given.
+ */
+typedef enum
+{
+    TEST_TOKENIZER_CLASSIC, /**< The mock tokenizer's copying interface only */
+    TEST_TOKENIZER_SPANS,   /**< The mock tokenizer's span and copying interfaces */
+    TEST_TOKENIZER_BUILTIN  /**< The library's token_tokenize_spans */
+} TestTokenizer;
+
+/**
+ * @brief Configuration of a test renderer.
+ */
+typedef struct
+{
+    TestTokenizer tokenizer; /**< Tokenizer to install */
+    const char *separators;  /**< Characters the mock tokenizer splits on; " " if NULL */
+    TokenClassSet classes;   /**< Classes the mock classifier sets on every token; 0 leaves them */
+    size_t cache_capacity;   /**< Render cache entries, or 0 to leave the cache off */
+} TestRendererConfig;
+
+static const char *test_separators = " ";
+static TokenClassSet test_classes;
+static atomic_int test_tokenize_calls;
+static atomic_int test_classify_calls;
+
+static inline bool mock_is_separator(char c)
+{
+    return c != '\0' && strchr(test_separators, c) != NULL;
+}
+
+// Whitespace tokenizer writing spans into the renderer's array
+static inline ErrorCode mock_tokenize_spans(const char *text, size_t length, Language lang, Token *spans, size_t capacity,
+                                            size_t *token_count)
+{
+    (void)lang;
+    size_t count = 0;
+    size_t i = 0;
+    atomic_fetch_add(&test_tokenize_calls, 1);
+    while (i < length)
+    {
+        while (i < length && mock_is_separator(text[i]))
+        {
+            i++;
+        }
+        size_t start = i;
+        while (i < length && !mock_is_separator(text[i]))
+        {
+            i++;
+        }
+        if (i > start)
+        {
+            if (count < capacity)
+            {
+                spans[count].offset = start;
+                spans[count].length = i - start;
+            }
+            count++;
+        }
+    }
+    *token_count = count;
+    return ERROR_SUCCESS;
+}
+
+// Classic tokenizer handing back its own allocations
+static inline ErrorCode mock_tokenize(const char *text, Language lang, Token **tokens, size_t *token_count)
+{
+    size_t capacity = strlen(text) + 1;
+    Token *spans = calloc(capacity, sizeof(Token));
+    mock_tokenize_spans(text, strlen(text), lang, spans, capacity, token_count);
+    for (size_t i = 0; i < *token_count; i++)
+    {
+        spans[i].text = strndup(text + spans[i].offset, spans[i].length);
+        spans[i].offset = 0;
+    }
+    *tokens = spans;
+    return ERROR_SUCCESS;
+}
+
+static inline void mock_free_tokens(Token *tokens, size_t token_count)
+{
+    for (size_t i = 0; i < token_count; i++)
+    {
+        free(tokens[i].text);
+    }
+    free(tokens);
+}
+
+static inline ErrorCode mock_classify(Token *tokens, size_t token_count)
+{
+    atomic_fetch_add(&test_classify_calls, 1);
+    for (size_t i = 0; i < token_count && test_classes != 0; i++)
+    {
+        tokens[i].classes = test_classes;
+    }
+    return ERROR_SUCCESS;
+}
+
+static inline Renderer *test_create_renderer(LimdyMemoryPool *pool, const TestRendererConfig *config)
+{
+    test_separators = config->separators ? config->separators : " ";
+    test_classes = config->classes;
+
+    // The renderer frees its services to its pool
+    TokenizationService *tokenization = limdy_memory_pool_alloc_from(pool, sizeof(TokenizationService));
+    ClassificationService *classification = limdy_memory_pool_alloc_from(pool, sizeof(ClassificationService));
+    *tokenization = (TokenizationService){0};
+    if (config->tokenizer == TEST_TOKENIZER_BUILTIN)
+    {
+        tokenization->tokenize_spans = token_tokenize_spans;
+    }
+    else
+    {
+        tokenization->tokenize = mock_tokenize;
+        tokenization->free_tokens = mock_free_tokens;
+        if (config->tokenizer == TEST_TOKENIZER_SPANS)
+        {
+            tokenization->tokenize_spans = mock_tokenize_spans;
+        }
+    }
+    *classification = (ClassificationService){.classify = mock_classify};
+
+    Renderer *renderer = renderer_create(pool, tokenization, classification);
+    assert(renderer != NULL);
+    if (config->cache_capacity > 0)
+    {
+        assert(renderer_enable_cache(renderer, config->cache_capacity) == ERROR_SUCCESS);
+    }
+    return renderer;
+}
+
+#endif // LIMDY_TESTS_FIXTURES_H
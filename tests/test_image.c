@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "limdy_image.h"
+#include "memory_pool.h"
+#include "error_handler.h"
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+#define IMAGE_PATH "test_image.img"
+#define TEST_ERROR_BAD_FORMAT (ERROR_CUSTOM_BASE + 900)
+#define TEST_ERROR_VERSION (ERROR_CUSTOM_BASE + 901)
+
+typedef struct
+{
+    LimdyImageHeader image;
+    uint64_t text_bytes;
+    uint64_t text_offset;
+    uint64_t value_count;
+    uint64_t value_offset;
+} TestHeader;
+
+static bool test_header_valid(const void *image_header)
+{
+    const TestHeader *header = image_header;
+    return limdy_image_section_fits(&header->image, header->text_offset, header->text_bytes, 1) &&
+           limdy_image_section_fits(&header->image, header->value_offset, header->value_count, sizeof(uint64_t));
+}
+
+static const LimdyImageFormat test_format = {
+    .name = "test image",
+    .magic = "LIMDYTS1",
+    .version = 3,
+    .header_size = sizeof(TestHeader),
+    .error_bad_format = TEST_ERROR_BAD_FORMAT,
+    .error_version = TEST_ERROR_VERSION,
+    .header_valid = test_header_valid};
+
+static ErrorCode write_image(void)
+{
+    static const char text[] = "hello";
+    static const uint64_t values[] = {1, 2, 3};
+    TestHeader header = {.text_bytes = sizeof(text), .value_count = 3};
+    header.text_offset = limdy_image_align(sizeof(TestHeader));
+    header.value_offset = limdy_image_align(header.text_offset + sizeof(text));
+    const LimdyImageSection sections[] = {{header.text_offset, text, sizeof(text)},
+                                          {header.value_offset, values, sizeof(values)}};
+    return limdy_image_write(&test_format, IMAGE_PATH, &header.image, sections, 2);
+}
+
+static void corrupt_byte(const char *path, long offset)
+{
+    FILE *file = fopen(path, "r+b");
+    assert(file);
+    assert(fseek(file, offset, SEEK_SET) == 0);
+    int byte = fgetc(file);
+    assert(fseek(file, offset, SEEK_SET) == 0);
+    fputc(byte ^ 0xff, file);
+    fclose(file);
+}
+
+void test_align()
+{
+    assert(limdy_image_align(0) == 0);
+    assert(limdy_image_align(1) == LIMDY_IMAGE_SECTION_ALIGNMENT);
+    assert(limdy_image_align(LIMDY_IMAGE_SECTION_ALIGNMENT) == LIMDY_IMAGE_SECTION_ALIGNMENT);
+    assert(limdy_image_align(LIMDY_IMAGE_SECTION_ALIGNMENT + 1) == 2 * LIMDY_IMAGE_SECTION_ALIGNMENT);
+    printf("test_align() passed.\n");
+}
+
+void test_write_and_map()
+{
+    assert(write_image() == ERROR_SUCCESS);
+
+    LimdyImage image;
+    assert(limdy_image_map(&test_format, IMAGE_PATH, &image) == ERROR_SUCCESS);
+    const TestHeader *header = image.mapping;
+    assert(memcmp(header->image.magic, "LIMDYTS1", LIMDY_IMAGE_MAGIC_SIZE) == 0);
+    assert(header->image.version == 3 && header->image.header_size == sizeof(TestHeader));
+    // The file ends where the last section does
+    assert(header->image.file_size == header->value_offset + 3 * sizeof(uint64_t) && image.size == header->image.file_size);
+    assert(strcmp((const char *)image.mapping + header->text_offset, "hello") == 0);
+    const uint64_t *values = (const uint64_t *)((const char *)image.mapping + header->value_offset);
+    assert(values[0] == 1 && values[2] == 3);
+    limdy_image_will_need(&image, header->value_offset, 3 * sizeof(uint64_t));
+
+    limdy_image_unmap(&image);
+    assert(image.mapping == NULL);
+    limdy_image_unmap(&image);
+    limdy_image_unmap(NULL);
+
+    // No temporary file is left behind
+    FILE *file = fopen(IMAGE_PATH ".tmp", "rb");
+    assert(file == NULL);
+    remove(IMAGE_PATH);
+    printf("test_write_and_map() passed.\n");
+}
+
+void test_reject_bad_images()
+{
+    LimdyImage image;
+    assert(limdy_image_map(&test_format, "test_image_missing.img", &image) == ERROR_FILE_IO);
+
+    assert(write_image() == ERROR_SUCCESS);
+    corrupt_byte(IMAGE_PATH, 0);
+    assert(limdy_image_map(&test_format, IMAGE_PATH, &image) == TEST_ERROR_BAD_FORMAT);
+
+    assert(write_image() == ERROR_SUCCESS);
+    corrupt_byte(IMAGE_PATH, offsetof(LimdyImageHeader, version));
+    assert(limdy_image_map(&test_format, IMAGE_PATH, &image) == TEST_ERROR_VERSION);
+
+    // Format fields are covered by the checksum
+    assert(write_image() == ERROR_SUCCESS);
+    corrupt_byte(IMAGE_PATH, offsetof(TestHeader, value_offset));
+    assert(limdy_image_map(&test_format, IMAGE_PATH, &image) == TEST_ERROR_BAD_FORMAT);
+
+    // A file of another size no longer matches its header
+    assert(write_image() == ERROR_SUCCESS);
+    FILE *file = fopen(IMAGE_PATH, "ab");
+    assert(file);
+    fputc(0, file);
+    fclose(file);
+    assert(limdy_image_map(&test_format, IMAGE_PATH, &image) == TEST_ERROR_BAD_FORMAT);
+    file = fopen(IMAGE_PATH, "wb");
+    assert(file);
+    fputs("LIMDYTS1", file);
+    fclose(file);
+    assert(limdy_image_map(&test_format, IMAGE_PATH, &image) == TEST_ERROR_BAD_FORMAT);
+
+    assert(limdy_image_map(NULL, IMAGE_PATH, &image) == ERROR_NULL_POINTER);
+    assert(limdy_image_map(&test_format, IMAGE_PATH, NULL) == ERROR_NULL_POINTER);
+    remove(IMAGE_PATH);
+    printf("test_reject_bad_images() passed.\n");
+}
+
+void test_build_index()
+{
+    uint64_t records[] = {5, 21, 5, 7};
+    size_t capacity = 0;
+    LimdyImageIndexEntry *index = limdy_image_build_index(records, 4, sizeof(uint64_t), &capacity);
+    assert(index != NULL && capacity == LIMDY_IMAGE_MIN_INDEX_CAPACITY);
+
+    // Equal hashes collide into neighbouring slots in the order they were added
+    size_t mask = capacity - 1;
+    assert(index[5].hash == 5 && index[5].record == 1);
+    assert(index[6].hash == 21 && index[6].record == 2);
+    assert(index[7].hash == 5 && index[7].record == 3);
+    assert(index[8].hash == 7 && index[8].record == 4);
+    assert(index[9 & mask].record == 0);
+    limdy_memory_pool_free(index);
+
+    // More than twice the count, rounded up to a power of two
+    uint64_t many[40] = {0};
+    index = limdy_image_build_index(many, 40, sizeof(uint64_t), &capacity);
+    assert(index != NULL && capacity == 128);
+    limdy_memory_pool_free(index);
+
+    assert(limdy_image_build_index(NULL, 4, sizeof(uint64_t), &capacity) == NULL);
+    assert(limdy_image_build_index(records, 4, sizeof(uint64_t), NULL) == NULL);
+    printf("test_build_index() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_align();
+    test_write_and_map();
+    test_reject_bad_images();
+    test_build_index();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
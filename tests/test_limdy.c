@@ -0,0 +1,337 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "limdy.h"
+#include "render_cache.h"
+#include "error_handler.h"
+#include "test_fixtures.h"
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+#define SNAPSHOT_DIR "test_limdy.snapshot.d"
+
+static Renderer *create_renderer(LimdyMemoryPool *pool, bool spans)
+{
+    // Every token a noun, so the snapshot has classes to keep
+    TestRendererConfig config = {.tokenizer = spans ? TEST_TOKENIZER_SPANS : TEST_TOKENIZER_CLASSIC,
+                                 .classes = TOKEN_CLASS_BIT(CLS_NOUN),
+                                 .cache_capacity = 64};
+    return test_create_renderer(pool, &config);
+}
+
+static void remove_snapshot(void)
+{
+    remove(SNAPSHOT_DIR "/" LIMDY_SNAPSHOT_IMAGE_NAME);
+    remove(SNAPSHOT_DIR "/map-0.bank");
+    remove(SNAPSHOT_DIR "/map-1.bank");
+    rmdir(SNAPSHOT_DIR);
+}
+
+static void corrupt_byte(const char *path, long offset)
+{
+    FILE *file = fopen(path, "r+b");
+    assert(file);
+    assert(fseek(file, offset, SEEK_SET) == 0);
+    int byte = fgetc(file);
+    assert(fseek(file, offset, SEEK_SET) == 0);
+    fputc(byte ^ 0xff, file);
+    fclose(file);
+}
+
+static void make_token(Token *token, const char *text)
+{
+    memset(token, 0, sizeof(Token));
+    token->text = (char *)text;
+    token->length = strlen(text);
+    token->classes = TOKEN_CLASS_BIT(CLS_VERB);
+}
+
+// Test functions
+void test_translations()
+{
+    TranslationMemoryConfig config = LIMDY_TRANSLATION_MEMORY_CONFIG_DEFAULT;
+    TranslationMemory *cold;
+    assert(translation_memory_create(&config, &cold) == ERROR_SUCCESS);
+
+    LimdyMatrix attention;
+    assert(limdy_matrix_init(&attention, 2, 3) == ERROR_SUCCESS);
+    limdy_matrix_row(&attention, 1)[2] = 0.5f;
+    assert(translation_memory_insert(cold, "good morning", "en", "fr", "bonjour", &attention) == ERROR_SUCCESS);
+    assert(translation_memory_insert(cold, "good night", "en", "fr", "bonne nuit", NULL) == ERROR_SUCCESS);
+    assert(translation_memory_insert(cold, "good morning", "en", "de", "guten Morgen", NULL) == ERROR_SUCCESS);
+    limdy_matrix_free(&attention);
+
+    LimdySnapshotWriter *writer;
+    assert(limdy_snapshot_writer_create(&writer) == ERROR_SUCCESS);
+    assert(limdy_snapshot_writer_add_translations(writer, cold) == ERROR_SUCCESS);
+    assert(limdy_snapshot_writer_write(writer, SNAPSHOT_DIR) == ERROR_SUCCESS);
+    limdy_snapshot_writer_destroy(writer);
+    translation_memory_destroy(cold);
+
+    // A new worker starts with an empty memory backed by the snapshot
+    LimdySnapshot *snapshot;
+    assert(limdy_snapshot_open(SNAPSHOT_DIR, &snapshot) == ERROR_SUCCESS);
+    assert(limdy_snapshot_translation_store(snapshot, &config.store) == ERROR_SUCCESS);
+    TranslationMemory *warm;
+    assert(translation_memory_create(&config, &warm) == ERROR_SUCCESS);
+
+    TranslationMemoryStats stats;
+    translation_memory_get_stats(warm, &stats);
+    assert(stats.entries == 0 && stats.loaded == 0);
+
+    const TranslationMemoryHit *hit;
+    assert(translation_memory_lookup(warm, "good morning", "en", "fr", &hit) == ERROR_SUCCESS);
+    assert(strcmp(hit->translated_text, "bonjour") == 0 && hit->rows == 2 && hit->cols == 3);
+    assert(hit->attention[5] == 0.5f && hit->attention[0] == 0.0f);
+    translation_memory_release(hit);
+
+    // Once paged in, the entry is answered by the memory
+    assert(translation_memory_lookup(warm, "good morning", "en", "fr", &hit) == ERROR_SUCCESS);
+    translation_memory_release(hit);
+    assert(translation_memory_lookup(warm, "good morning", "en", "de", &hit) == ERROR_SUCCESS);
+    assert(strcmp(hit->translated_text, "guten Morgen") == 0 && hit->rows == 0);
+    translation_memory_release(hit);
+    assert(translation_memory_lookup(warm, "good morning", "e", "nfr", &hit) == LIMDY_TRANSLATION_MEMORY_ERROR_MISS);
+    assert(translation_memory_lookup(warm, "good evening", "en", "fr", &hit) == LIMDY_TRANSLATION_MEMORY_ERROR_MISS);
+
+    translation_memory_get_stats(warm, &stats);
+    assert(stats.hits == 3 && stats.misses == 2 && stats.paged_in == 2 && stats.entries == 2);
+
+    LimdySnapshotStats snapshot_stats;
+    limdy_snapshot_get_stats(snapshot, &snapshot_stats);
+    assert(snapshot_stats.translations == 3 && snapshot_stats.translations_paged_in == 2);
+    assert(snapshot_stats.renders == 0 && snapshot_stats.maps == 0);
+
+    translation_memory_destroy(warm);
+    limdy_snapshot_close(snapshot);
+    remove_snapshot();
+    printf("test_translations() passed.\n");
+}
+
+static void check_renders(bool spans)
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *cold = create_renderer(pool, spans);
+    const RendererResult *result;
+    assert(renderer_tokenize_shared(cold, "the cat sat", LANG_ENGLISH, &result) == ERROR_SUCCESS);
+    renderer_release_shared(cold, result);
+    assert(renderer_tokenize_shared(cold, "the cat sat", LANG_SPANISH, &result) == ERROR_SUCCESS);
+    renderer_release_shared(cold, result);
+    assert(renderer_tokenize_shared(cold, "", LANG_ENGLISH, &result) == ERROR_SUCCESS);
+    renderer_release_shared(cold, result);
+
+    LimdySnapshotWriter *writer;
+    assert(limdy_snapshot_writer_create(&writer) == ERROR_SUCCESS);
+    assert(limdy_snapshot_writer_add_renders(writer, cold->cache) == ERROR_SUCCESS);
+    assert(limdy_snapshot_writer_write(writer, SNAPSHOT_DIR) == ERROR_SUCCESS);
+    limdy_snapshot_writer_destroy(writer);
+    renderer_destroy(cold);
+
+    LimdySnapshot *snapshot;
+    assert(limdy_snapshot_open(SNAPSHOT_DIR, &snapshot) == ERROR_SUCCESS);
+    Renderer *warm = create_renderer(pool, spans);
+    assert(limdy_snapshot_attach_renderer(snapshot, warm) == ERROR_SUCCESS);
+
+    // Saved texts are neither tokenized nor classified again
+    test_tokenize_calls = 0;
+    test_classify_calls = 0;
+    assert(renderer_tokenize_shared(warm, "the cat sat", LANG_ENGLISH, &result) == ERROR_SUCCESS);
+    assert(test_tokenize_calls == 0 && test_classify_calls == 0);
+    assert(result->token_count == 3);
+    assert(result->tokens[1].length == 3 && strncmp(result->tokens[1].text, "cat", 3) == 0);
+    assert(result->tokens[2].text == result->source + result->tokens[2].offset);
+    assert(result->tokens[2].classes == TOKEN_CLASS_BIT(CLS_NOUN));
+    assert(spans ? result->tokens[2].offset == 8 : strcmp(result->tokens[2].text, "sat") == 0);
+    renderer_release_shared(warm, result);
+
+    assert(renderer_tokenize_shared(warm, "", LANG_ENGLISH, &result) == ERROR_SUCCESS);
+    assert(result->token_count == 0 && test_tokenize_calls == 0);
+    renderer_release_shared(warm, result);
+
+    // Other texts and languages are tokenized as usual
+    assert(renderer_tokenize_shared(warm, "the cat", LANG_ENGLISH, &result) == ERROR_SUCCESS);
+    assert(result->token_count == 2 && test_tokenize_calls == 1 && test_classify_calls == 1);
+    renderer_release_shared(warm, result);
+
+    LimdySnapshotStats stats;
+    limdy_snapshot_get_stats(snapshot, &stats);
+    assert(stats.renders == 3 && stats.renders_paged_in == 2);
+
+    RenderCacheStats cache_stats;
+    renderer_get_cache_stats(warm, &cache_stats);
+    assert(cache_stats.misses == 3 && cache_stats.entries == 3);
+
+    renderer_destroy(warm);
+    limdy_snapshot_close(snapshot);
+    limdy_memory_pool_destroy(pool);
+    remove_snapshot();
+}
+
+void test_renders()
+{
+    check_renders(true);
+    check_renders(false);
+    printf("test_renders() passed.\n");
+}
+
+void test_maps()
+{
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 0) == ERROR_SUCCESS);
+    LinguisticElementMap vocab;
+    assert(linguistic_element_map_init_arena(&vocab, 16, &arena) == ERROR_SUCCESS);
+
+    const char *words[] = {"walk", "run", "jump"};
+    for (size_t i = 0; i < 3; i++)
+    {
+        Token *token = limdy_arena_alloc(&arena, sizeof(Token));
+        make_token(token, words[i]);
+        ExtendedLinguisticElement element = {
+            .base = {.type = ELEMENT_VOCAB, .tokens = token, .token_count = 1, .hash = hash_linguistic_element(token, 1)}};
+        assert(linguistic_element_map_add(&vocab, &element) == ERROR_SUCCESS);
+    }
+    LinguisticElementMap empty;
+    assert(linguistic_element_map_init_arena(&empty, 16, &arena) == ERROR_SUCCESS);
+
+    LimdySnapshotWriter *writer;
+    assert(limdy_snapshot_writer_create(&writer) == ERROR_SUCCESS);
+    assert(limdy_snapshot_writer_add_map(writer, "vocab", &vocab) == ERROR_SUCCESS);
+    assert(limdy_snapshot_writer_add_map(writer, "phrases", &empty) == ERROR_SUCCESS);
+    assert(limdy_snapshot_writer_add_map(writer, "vocab", &empty) == ERROR_INVALID_ARGUMENT);
+    assert(limdy_snapshot_writer_write(writer, SNAPSHOT_DIR) == ERROR_SUCCESS);
+    limdy_snapshot_writer_destroy(writer);
+    linguistic_element_map_free(&vocab);
+    linguistic_element_map_free(&empty);
+    limdy_arena_release(&arena);
+
+    LimdySnapshot *snapshot;
+    assert(limdy_snapshot_open(SNAPSHOT_DIR, &snapshot) == ERROR_SUCCESS);
+    LimdySnapshotStats stats;
+    limdy_snapshot_get_stats(snapshot, &stats);
+    assert(stats.maps == 2 && stats.maps_loaded == 0);
+
+    // Pool-backed maps own the copies, which outlive the snapshot
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    LinguisticElementMap loaded;
+    assert(linguistic_element_map_init(&loaded, 4, pool) == ERROR_SUCCESS);
+    assert(limdy_snapshot_load_map(snapshot, "vocab", &loaded) == ERROR_SUCCESS);
+    assert(limdy_snapshot_load_map(snapshot, "vocab", &loaded) == ERROR_SUCCESS);
+    assert(loaded.element_count == 3);
+    assert(limdy_snapshot_load_map(snapshot, "verbs", &loaded) == LIMDY_SNAPSHOT_ERROR_NO_MAP);
+
+    LinguisticElementMap phrases;
+    assert(linguistic_element_map_init(&phrases, 4, pool) == ERROR_SUCCESS);
+    assert(limdy_snapshot_load_map(snapshot, "phrases", &phrases) == ERROR_SUCCESS);
+    assert(phrases.element_count == 0);
+
+    limdy_snapshot_get_stats(snapshot, &stats);
+    assert(stats.maps_loaded == 3);
+    limdy_snapshot_close(snapshot);
+
+    Token run;
+    make_token(&run, "run");
+    ExtendedLinguisticElement *found = linguistic_element_map_find_tokens(&loaded, hash_linguistic_element(&run, 1), &run, 1);
+    assert(found != NULL && found->base.type == ELEMENT_VOCAB && found->occurrence_count == 0);
+    assert(strcmp(found->base.tokens[0].text, "run") == 0 && found->base.tokens[0].classes == TOKEN_CLASS_BIT(CLS_VERB));
+
+    linguistic_element_map_free(&loaded);
+    linguistic_element_map_free(&phrases);
+    limdy_memory_pool_destroy(pool);
+    remove_snapshot();
+    printf("test_maps() passed.\n");
+}
+
+void test_reject_bad_snapshots()
+{
+    LimdySnapshot *snapshot;
+    assert(limdy_snapshot_open(SNAPSHOT_DIR, &snapshot) == ERROR_FILE_IO);
+
+    LimdySnapshotWriter *writer;
+    assert(limdy_snapshot_writer_create(&writer) == ERROR_SUCCESS);
+    assert(limdy_snapshot_writer_write(writer, SNAPSHOT_DIR) == ERROR_SUCCESS);
+    assert(limdy_snapshot_open(SNAPSHOT_DIR, &snapshot) == ERROR_SUCCESS);
+    limdy_snapshot_close(snapshot);
+
+    const char *path = SNAPSHOT_DIR "/" LIMDY_SNAPSHOT_IMAGE_NAME;
+    corrupt_byte(path, 0);
+    assert(limdy_snapshot_open(SNAPSHOT_DIR, &snapshot) == LIMDY_SNAPSHOT_ERROR_BAD_FORMAT);
+
+    assert(limdy_snapshot_writer_write(writer, SNAPSHOT_DIR) == ERROR_SUCCESS);
+    corrupt_byte(path, 8);
+    assert(limdy_snapshot_open(SNAPSHOT_DIR, &snapshot) == LIMDY_SNAPSHOT_ERROR_VERSION);
+
+    // Section bounds are covered by the checksum
+    assert(limdy_snapshot_writer_write(writer, SNAPSHOT_DIR) == ERROR_SUCCESS);
+    corrupt_byte(path, 40);
+    assert(limdy_snapshot_open(SNAPSHOT_DIR, &snapshot) == LIMDY_SNAPSHOT_ERROR_BAD_FORMAT);
+
+    assert(limdy_snapshot_writer_write(writer, SNAPSHOT_DIR) == ERROR_SUCCESS);
+    assert(truncate(path, 16) == 0);
+    assert(limdy_snapshot_open(SNAPSHOT_DIR, &snapshot) == LIMDY_SNAPSHOT_ERROR_BAD_FORMAT);
+
+    assert(limdy_snapshot_writer_create(NULL) == ERROR_NULL_POINTER);
+    assert(limdy_snapshot_writer_add_translations(writer, NULL) == ERROR_NULL_POINTER);
+    assert(limdy_snapshot_writer_add_map(writer, NULL, NULL) == ERROR_NULL_POINTER);
+    assert(limdy_snapshot_open(NULL, &snapshot) == ERROR_NULL_POINTER);
+    assert(limdy_snapshot_load_map(NULL, "vocab", NULL) == ERROR_NULL_POINTER);
+    limdy_snapshot_writer_destroy(writer);
+    limdy_snapshot_writer_destroy(NULL);
+    limdy_snapshot_close(NULL);
+
+    remove_snapshot();
+    printf("test_reject_bad_snapshots() passed.\n");
+}
+
+void test_startup_report()
+{
+    LimdyStartupReport report;
+    assert(limdy_startup_begin(&report) == ERROR_SUCCESS);
+    assert(limdy_startup_end(&report, NULL) == ERROR_SUCCESS);
+    assert(!report.warm);
+
+    LimdySnapshotWriter *writer;
+    assert(limdy_snapshot_writer_create(&writer) == ERROR_SUCCESS);
+    assert(limdy_snapshot_writer_write(writer, SNAPSHOT_DIR) == ERROR_SUCCESS);
+    limdy_snapshot_writer_destroy(writer);
+
+    LimdySnapshot *snapshot;
+    assert(limdy_startup_begin(&report) == ERROR_SUCCESS);
+    assert(limdy_snapshot_open(SNAPSHOT_DIR, &snapshot) == ERROR_SUCCESS);
+    assert(limdy_startup_end(&report, snapshot) == ERROR_SUCCESS);
+    assert(report.warm && report.startup_ns > 0);
+    limdy_snapshot_close(snapshot);
+
+    assert(limdy_startup_begin(NULL) == ERROR_NULL_POINTER);
+    assert(limdy_startup_end(NULL, NULL) == ERROR_NULL_POINTER);
+
+    remove_snapshot();
+    printf("test_startup_report() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_translations();
+    test_renders();
+    test_maps();
+    test_reject_bad_snapshots();
+    test_startup_report();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
@@ -0,0 +1,350 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include "linguistic_element.h"
+#include "error_handler.h"
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+#define CORPUS_THREADS 8
+#define CORPUS_TOKENS 4096
+#define CORPUS_WORDS 64
+
+static char words[CORPUS_WORDS][16];
+static Token corpus[CORPUS_THREADS][CORPUS_TOKENS];
+
+static void make_token(Token *token, char *text)
+{
+    memset(token, 0, sizeof(Token));
+    token->text = text;
+    token->length = strlen(text);
+}
+
+// Test functions
+void test_map_add_occurrence()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    LinguisticElementMap map;
+    assert(linguistic_element_map_init(&map, 4, pool) == ERROR_SUCCESS);
+
+    Token *element_tokens = limdy_memory_pool_alloc_from(pool, sizeof(Token));
+    make_token(element_tokens, "word");
+    ExtendedLinguisticElement element = {
+        .base = {.type = ELEMENT_VOCAB, .tokens = element_tokens, .token_count = 1, .hash = hash_linguistic_element(element_tokens, 1)}};
+    assert(linguistic_element_map_add(&map, &element) == ERROR_SUCCESS);
+
+    Token seen[1000];
+    for (size_t i = 0; i < 1000; i++)
+    {
+        make_token(&seen[i], "word");
+        assert(linguistic_element_map_add_occurrence(&map, element.base.hash, &seen[i], 1) == ERROR_SUCCESS);
+    }
+
+    ExtendedLinguisticElement *found = linguistic_element_map_find(&map, element.base.hash);
+    assert(found != NULL && found->occurrence_count == 1000);
+    assert(found->occurrences[0] == &seen[0] && found->occurrences[999] == &seen[999]);
+
+    assert(linguistic_element_map_add_occurrence(&map, element.base.hash + 1, &seen[0], 1) == LIMDY_LINGUISTIC_ELEMENT_ERROR_NOT_FOUND);
+
+    linguistic_element_map_free(&map);
+    limdy_memory_pool_destroy(pool);
+    printf("test_map_add_occurrence() passed.\n");
+}
+
+void test_map_probing()
+{
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 0) == ERROR_SUCCESS);
+    LinguisticElementMap map;
+    assert(linguistic_element_map_init_arena(&map, 4, &arena) == ERROR_SUCCESS);
+    assert(map.table.capacity == LIMDY_LINGUISTIC_ELEMENT_GROUP_SIZE);
+
+    // Hashes are never equal here, so the tokens are never compared
+    Token word[2];
+    make_token(&word[0], "word");
+    make_token(&word[1], "word");
+
+    // Consecutive hashes and hashes differing only in their top bits, through many resizes
+    for (uint64_t i = 0; i < 5000; i++)
+    {
+        ExtendedLinguisticElement sequential = {.base = {.type = ELEMENT_VOCAB, .tokens = word, .token_count = 1, .hash = i}};
+        ExtendedLinguisticElement high = {.base = {.type = ELEMENT_PHRASE, .tokens = word, .token_count = 2, .hash = i << 48}};
+        assert(linguistic_element_map_add(&map, &sequential) == ERROR_SUCCESS);
+        if (i > 0)
+        {
+            assert(linguistic_element_map_add(&map, &high) == ERROR_SUCCESS);
+        }
+    }
+    assert(map.element_count == 9999);
+    assert(map.element_count <= map.table.capacity / 8 * 7);
+
+    for (uint64_t i = 0; i < 5000; i++)
+    {
+        ExtendedLinguisticElement *found = linguistic_element_map_find(&map, i);
+        assert(found != NULL && found->base.hash == i && found->base.type == ELEMENT_VOCAB);
+        if (i > 0)
+        {
+            found = linguistic_element_map_find(&map, i << 48);
+            assert(found != NULL && found->base.type == ELEMENT_PHRASE);
+            assert(linguistic_element_map_find(&map, (i << 48) | 1) == NULL);
+        }
+        assert(linguistic_element_map_find(&map, i + 5000) == NULL);
+    }
+
+    // Adding a known hash replaces its element in place
+    ExtendedLinguisticElement replacement = {.base = {.type = ELEMENT_SYNTAX, .tokens = word, .token_count = 1, .hash = 42}};
+    assert(linguistic_element_map_add(&map, &replacement) == ERROR_SUCCESS);
+    assert(map.element_count == 9999);
+    assert(linguistic_element_map_find(&map, 42)->base.type == ELEMENT_SYNTAX);
+
+    size_t full = 0;
+    for (size_t i = 0; i < linguistic_element_map_slot_count(&map); i++)
+    {
+        full += linguistic_element_map_slot(&map, i) != NULL;
+    }
+    assert(full == map.element_count);
+
+    linguistic_element_map_free(&map);
+    limdy_arena_release(&arena);
+    printf("test_map_probing() passed.\n");
+}
+
+void test_map_incremental_resize()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_LARGE_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    LinguisticElementMap map;
+    assert(linguistic_element_map_init(&map, 0, pool) == ERROR_SUCCESS);
+
+    Token word;
+    make_token(&word, "word");
+    size_t resizes = 0;
+    size_t draining = 0;
+    for (uint64_t i = 0; i < 20000; i++)
+    {
+        size_t capacity = map.table.capacity;
+        Token *tokens = limdy_memory_pool_alloc_from(pool, sizeof(Token));
+        *tokens = word;
+        ExtendedLinguisticElement element = {.base = {.type = ELEMENT_VOCAB, .tokens = tokens, .token_count = 1, .hash = i * 0x9e3779b97f4a7c15ULL}};
+        assert(linguistic_element_map_add(&map, &element) == ERROR_SUCCESS);
+        resizes += map.table.capacity != capacity;
+
+        // While both tables are live, elements are found in either and iterated exactly once
+        if (map.old.capacity && i % 64 == 0)
+        {
+            draining++;
+            for (uint64_t j = 0; j <= i; j++)
+            {
+                assert(linguistic_element_map_find(&map, j * 0x9e3779b97f4a7c15ULL) != NULL);
+            }
+            size_t full = 0;
+            for (size_t j = 0; j < linguistic_element_map_slot_count(&map); j++)
+            {
+                full += linguistic_element_map_slot(&map, j) != NULL;
+            }
+            assert(full == map.element_count);
+        }
+    }
+    assert(map.element_count == 20000);
+    assert(resizes > 5 && draining > 0);
+
+    // A reserved map takes its elements without growing; the old table is drained in one go
+    assert(linguistic_element_map_reserve(&map, 50000) == ERROR_SUCCESS);
+    assert(map.old.capacity == 0);
+    size_t capacity = map.table.capacity;
+    for (uint64_t i = 20000; i < 50000; i++)
+    {
+        Token *tokens = limdy_memory_pool_alloc_from(pool, sizeof(Token));
+        *tokens = word;
+        ExtendedLinguisticElement element = {.base = {.type = ELEMENT_VOCAB, .tokens = tokens, .token_count = 1, .hash = i * 0x9e3779b97f4a7c15ULL}};
+        assert(linguistic_element_map_add(&map, &element) == ERROR_SUCCESS);
+    }
+    assert(map.table.capacity == capacity && map.element_count == 50000);
+    assert(linguistic_element_map_find(&map, 12345 * 0x9e3779b97f4a7c15ULL) != NULL);
+
+    linguistic_element_map_free(&map);
+    limdy_memory_pool_destroy(pool);
+    printf("test_map_incremental_resize() passed.\n");
+}
+
+void test_hash()
+{
+    Token tokens[4];
+    make_token(&tokens[0], "ab");
+    make_token(&tokens[1], "c");
+    make_token(&tokens[2], "a");
+    make_token(&tokens[3], "bc");
+    // Where one token ends is part of the element
+    assert(hash_linguistic_element(&tokens[0], 2) != hash_linguistic_element(&tokens[2], 2));
+
+    // Classes are a set: each set hashes apart, and no classes hash as the bare text
+    Token classed = tokens[0];
+    uint64_t bare = hash_linguistic_element(&classed, 1);
+    token_add_class(&classed, CLS_VERB);
+    token_add_class(&classed, CLS_NOUN);
+    uint64_t noun_verb = hash_linguistic_element(&classed, 1);
+    assert(token_class_count(&classed) == 2 && token_has_class(&classed, CLS_NOUN) && !token_has_class(&classed, CLS_ADJECTIVE));
+    token_add_class(&classed, CLS_NOUN);
+    assert(hash_linguistic_element(&classed, 1) == noun_verb);
+    classed.classes = TOKEN_CLASS_BIT(CLS_VERB);
+    assert(hash_linguistic_element(&classed, 1) != noun_verb && hash_linguistic_element(&classed, 1) != bare);
+    classed.classes = TOKEN_CLASS_BIT(CLS_NOUN);
+    assert(hash_linguistic_element(&classed, 1) != noun_verb && hash_linguistic_element(&classed, 1) != bare);
+    assert(bare == hash_linguistic_element(&tokens[0], 1));
+
+    // Every byte of a long text counts, including those read a word at a time
+    char long_text[] = "internationalization and localization";
+    Token long_token;
+    make_token(&long_token, long_text);
+    uint64_t seen[sizeof(long_text) - 1];
+    for (size_t i = 0; i < sizeof(long_text) - 1; i++)
+    {
+        long_text[i] ^= 1;
+        seen[i] = hash_linguistic_element(&long_token, 1);
+        long_text[i] ^= 1;
+        assert(seen[i] != hash_linguistic_element(&long_token, 1));
+        for (size_t j = 0; j < i; j++)
+        {
+            assert(seen[j] != seen[i]);
+        }
+    }
+    printf("test_hash() passed.\n");
+}
+
+void test_map_collisions()
+{
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 0) == ERROR_SUCCESS);
+    LinguisticElementMap map;
+    assert(linguistic_element_map_init_arena(&map, 4, &arena) == ERROR_SUCCESS);
+
+    // Two different words forced onto one hash stay two elements
+    Token words_seen[2];
+    make_token(&words_seen[0], "cat");
+    make_token(&words_seen[1], "dog");
+    for (size_t i = 0; i < 2; i++)
+    {
+        ExtendedLinguisticElement element = {.base = {.type = ELEMENT_VOCAB, .tokens = &words_seen[i], .token_count = 1, .hash = 7}};
+        assert(linguistic_element_map_add(&map, &element) == ERROR_SUCCESS);
+    }
+    assert(map.element_count == 2);
+
+    Token dog;
+    make_token(&dog, "dog");
+    assert(linguistic_element_map_add_occurrence(&map, 7, &dog, 1) == ERROR_SUCCESS);
+    ExtendedLinguisticElement *found = linguistic_element_map_find_tokens(&map, 7, &dog, 1);
+    assert(found != NULL && found->base.tokens == &words_seen[1] && found->occurrence_count == 1);
+    found = linguistic_element_map_find_tokens(&map, 7, &words_seen[0], 1);
+    assert(found != NULL && found->occurrence_count == 0);
+
+    Token bird;
+    make_token(&bird, "bird");
+    assert(linguistic_element_map_find_tokens(&map, 7, &bird, 1) == NULL);
+    assert(linguistic_element_map_add_occurrence(&map, 7, &bird, 1) == LIMDY_LINGUISTIC_ELEMENT_ERROR_NOT_FOUND);
+
+    linguistic_element_map_free(&map);
+    limdy_arena_release(&arena);
+    printf("test_map_collisions() passed.\n");
+}
+
+typedef struct
+{
+    ConcurrentLinguisticElementMap *map;
+    Token *tokens;
+} CorpusWork;
+
+static void *corpus_worker(void *arg)
+{
+    CorpusWork *work = arg;
+    for (size_t i = 0; i < CORPUS_TOKENS; i++)
+    {
+        assert(linguistic_element_concurrent_map_record(work->map, ELEMENT_VOCAB, &work->tokens[i], 1) == ERROR_SUCCESS);
+    }
+    // Bigrams go into the same map
+    for (size_t i = 0; i + 1 < CORPUS_TOKENS; i += 2)
+    {
+        assert(linguistic_element_concurrent_map_record(work->map, ELEMENT_PHRASE, &work->tokens[i], 2) == ERROR_SUCCESS);
+    }
+    return NULL;
+}
+
+static void count_occurrences(void *context, const ExtendedLinguisticElement *element)
+{
+    size_t *total = context;
+    *total += element->occurrence_count;
+    assert(element->occurrences[0]->length == element->base.tokens[0].length);
+}
+
+void test_concurrent_map()
+{
+    for (size_t w = 0; w < CORPUS_WORDS; w++)
+    {
+        snprintf(words[w], sizeof(words[w]), "word%zu", w);
+    }
+    for (size_t t = 0; t < CORPUS_THREADS; t++)
+    {
+        for (size_t i = 0; i < CORPUS_TOKENS; i++)
+        {
+            make_token(&corpus[t][i], words[(i * 7 + t) % CORPUS_WORDS]);
+        }
+    }
+
+    ConcurrentLinguisticElementMap map;
+    assert(linguistic_element_concurrent_map_init(&map, 16) == ERROR_SUCCESS);
+
+    pthread_t threads[CORPUS_THREADS];
+    CorpusWork work[CORPUS_THREADS];
+    for (size_t t = 0; t < CORPUS_THREADS; t++)
+    {
+        work[t] = (CorpusWork){&map, corpus[t]};
+        assert(pthread_create(&threads[t], NULL, corpus_worker, &work[t]) == 0);
+    }
+    for (size_t t = 0; t < CORPUS_THREADS; t++)
+    {
+        pthread_join(threads[t], NULL);
+    }
+
+    // Every word once, however many threads saw it first at the same time
+    size_t count = 0;
+    Token probe;
+    make_token(&probe, words[5]);
+    assert(linguistic_element_concurrent_map_occurrences(&map, hash_linguistic_element(&probe, 1), &count));
+    assert(count == CORPUS_THREADS * CORPUS_TOKENS / CORPUS_WORDS);
+    make_token(&probe, "never seen");
+    assert(!linguistic_element_concurrent_map_occurrences(&map, hash_linguistic_element(&probe, 1), &count));
+
+    size_t total = 0;
+    linguistic_element_concurrent_map_for_each(&map, count_occurrences, &total);
+    assert(total == CORPUS_THREADS * (CORPUS_TOKENS + CORPUS_TOKENS / 2));
+    assert(linguistic_element_concurrent_map_size(&map) > CORPUS_WORDS);
+
+    linguistic_element_concurrent_map_free(&map);
+    printf("test_concurrent_map() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_map_add_occurrence();
+    test_map_probing();
+    test_map_incremental_resize();
+    test_hash();
+    test_map_collisions();
+    test_concurrent_map();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "linguistic_vocabulary.h"
+#include "error_handler.h"
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+// Whitespace tokenizer producing spans into source
+static size_t split(const char *source, Token *tokens, size_t capacity)
+{
+    size_t count = 0;
+    size_t i = 0;
+    size_t length = strlen(source);
+    while (i < length && count < capacity)
+    {
+        while (i < length && source[i] == ' ')
+        {
+            i++;
+        }
+        size_t start = i;
+        while (i < length && source[i] != ' ')
+        {
+            i++;
+        }
+        if (i > start)
+        {
+            memset(&tokens[count], 0, sizeof(Token));
+            tokens[count].text = (char *)source + start;
+            tokens[count].offset = start;
+            tokens[count].length = i - start;
+            count++;
+        }
+    }
+    return count;
+}
+
+// Test functions
+void test_intern()
+{
+    LinguisticVocabulary vocabulary;
+    assert(linguistic_vocabulary_init(&vocabulary) == ERROR_SUCCESS);
+
+    LinguisticTokenId cat, dog, again;
+    // Interned texts need not be null-terminated
+    assert(linguistic_vocabulary_intern(&vocabulary, "catalog", 3, &cat) == ERROR_SUCCESS);
+    assert(linguistic_vocabulary_intern(&vocabulary, "dog", 3, &dog) == ERROR_SUCCESS);
+    assert(linguistic_vocabulary_intern(&vocabulary, "cat", 3, &again) == ERROR_SUCCESS);
+    assert(cat == again && cat != dog);
+    assert(linguistic_vocabulary_token_count(&vocabulary) == 2);
+
+    size_t length;
+    assert(strcmp(linguistic_vocabulary_token_text(&vocabulary, cat, &length), "cat") == 0 && length == 3);
+
+    // IDs are dense and stay valid through table growth and new chunks
+    char text[32];
+    for (int i = 0; i < 10000; i++)
+    {
+        LinguisticTokenId id;
+        snprintf(text, sizeof(text), "word%d", i);
+        assert(linguistic_vocabulary_intern(&vocabulary, text, strlen(text), &id) == ERROR_SUCCESS);
+        assert(id == (LinguisticTokenId)i + 2);
+    }
+    assert(strcmp(linguistic_vocabulary_token_text(&vocabulary, 1234 + 2, NULL), "word1234") == 0);
+    assert(strcmp(linguistic_vocabulary_token_text(&vocabulary, dog, NULL), "dog") == 0);
+
+    linguistic_vocabulary_free(&vocabulary);
+    printf("test_intern() passed.\n");
+}
+
+void test_record()
+{
+    LinguisticVocabulary vocabulary;
+    assert(linguistic_vocabulary_init(&vocabulary) == ERROR_SUCCESS);
+
+    const char *source = "the cat saw the cat";
+    Token tokens[8];
+    size_t count = split(source, tokens, 8);
+    assert(count == 5);
+
+    LinguisticElementId ids[5];
+    for (size_t i = 0; i < count; i++)
+    {
+        assert(linguistic_vocabulary_record(&vocabulary, ELEMENT_VOCAB, &tokens[i], 1, &ids[i]) == ERROR_SUCCESS);
+    }
+    assert(ids[0] == ids[3] && ids[1] == ids[4] && ids[0] != ids[1]);
+    assert(linguistic_vocabulary_element_count(&vocabulary) == 3);
+
+    LinguisticElementId bigram;
+    assert(linguistic_vocabulary_record(&vocabulary, ELEMENT_PHRASE, &tokens[0], 2, &bigram) == ERROR_SUCCESS);
+    assert(linguistic_vocabulary_record(&vocabulary, ELEMENT_PHRASE, &tokens[3], 2, NULL) == ERROR_SUCCESS);
+
+    const LinguisticVocabularyElement *element = linguistic_vocabulary_element(&vocabulary, bigram);
+    assert(element->type == ELEMENT_PHRASE && element->token_count == 2 && element->occurrence_count == 2);
+    assert(strcmp(linguistic_vocabulary_token_text(&vocabulary, element->tokens[1], NULL), "cat") == 0);
+    assert(linguistic_vocabulary_element(&vocabulary, ids[1])->occurrence_count == 2);
+
+    // Occurrences are packed triples locating each element in the source
+    assert(sizeof(LinguisticOccurrence) == 12);
+    assert(linguistic_vocabulary_occurrence_count(&vocabulary) == 7);
+    const LinguisticOccurrence *occurrence = linguistic_vocabulary_occurrence(&vocabulary, 2);
+    assert(occurrence->element_id == ids[2] && occurrence->offset == 8 && occurrence->length == 3);
+    occurrence = linguistic_vocabulary_occurrence(&vocabulary, 6);
+    assert(occurrence->element_id == bigram && memcmp(source + occurrence->offset, "the cat", occurrence->length) == 0);
+
+    LinguisticElementId found;
+    assert(linguistic_vocabulary_find(&vocabulary, &tokens[3], 2, &found) && found == bigram);
+    assert(!linguistic_vocabulary_find(&vocabulary, &tokens[1], 2, &found));
+    Token unseen[1];
+    split("bird", unseen, 1);
+    assert(!linguistic_vocabulary_find(&vocabulary, unseen, 1, &found));
+    assert(linguistic_vocabulary_token_count(&vocabulary) == 3);
+
+    assert(linguistic_vocabulary_record(&vocabulary, ELEMENT_VOCAB, tokens, 0, NULL) == ERROR_INVALID_ARGUMENT);
+
+    linguistic_vocabulary_free(&vocabulary);
+    printf("test_record() passed.\n");
+}
+
+void test_occurrence_footprint()
+{
+    LinguisticVocabulary vocabulary;
+    assert(linguistic_vocabulary_init(&vocabulary) == ERROR_SUCCESS);
+
+    char source[64 * 8];
+    size_t length = 0;
+    for (int i = 0; i < 64; i++)
+    {
+        length += snprintf(source + length, sizeof(source) - length, "w%d ", i);
+    }
+    Token tokens[64];
+    assert(split(source, tokens, 64) == 64);
+    for (size_t i = 0; i < 64; i++)
+    {
+        assert(linguistic_vocabulary_record(&vocabulary, ELEMENT_VOCAB, &tokens[i], 1, NULL) == ERROR_SUCCESS);
+    }
+
+    // Once the vocabulary is known, an occurrence costs its 12-byte triple and nothing else
+    size_t before = limdy_arena_used(&vocabulary.arena);
+    for (size_t i = 0; i < 200000; i++)
+    {
+        assert(linguistic_vocabulary_record(&vocabulary, ELEMENT_VOCAB, &tokens[(i * 7) % 64], 1, NULL) == ERROR_SUCCESS);
+    }
+    size_t used = limdy_arena_used(&vocabulary.arena) - before;
+    assert(used < 200000 * 13);
+    assert(linguistic_vocabulary_element(&vocabulary, 0)->occurrence_count == 1 + 200000 / 64);
+    assert(linguistic_vocabulary_occurrence(&vocabulary, 64 + 199999)->element_id == (199999 * 7) % 64);
+
+    linguistic_vocabulary_free(&vocabulary);
+    printf("test_occurrence_footprint() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_intern();
+    test_record();
+    test_occurrence_footprint();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
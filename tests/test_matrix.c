@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "limdy_matrix.h"
+#include "memory_pool.h"
+#include "error_handler.h"
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+#define FLOATS_PER_LINE (LIMDY_MATRIX_ALIGNMENT / sizeof(float))
+
+void test_matrix_stride()
+{
+    // Rows are padded to whole cache lines
+    assert(limdy_matrix_stride(0) == 0);
+    assert(limdy_matrix_stride(1) == FLOATS_PER_LINE);
+    assert(limdy_matrix_stride(FLOATS_PER_LINE) == FLOATS_PER_LINE);
+    assert(limdy_matrix_stride(FLOATS_PER_LINE + 1) == 2 * FLOATS_PER_LINE);
+    assert(limdy_matrix_stride(3 * FLOATS_PER_LINE - 1) == 3 * FLOATS_PER_LINE);
+
+    assert(limdy_matrix_bytes(3, FLOATS_PER_LINE + 1) == 3 * 2 * LIMDY_MATRIX_ALIGNMENT);
+    assert(limdy_matrix_bytes(0, 5) == 0 && limdy_matrix_bytes(5, 0) == 0);
+    printf("test_matrix_stride() passed.\n");
+}
+
+void test_matrix_init()
+{
+    LimdyMatrix matrix;
+    assert(limdy_matrix_init(&matrix, 5, 7) == ERROR_SUCCESS);
+    assert(matrix.rows == 5 && matrix.cols == 7 && matrix.stride == FLOATS_PER_LINE && matrix.owned);
+
+    // Every row starts on a cache line, and all of it, padding included, starts zeroed
+    for (size_t i = 0; i < matrix.rows; i++)
+    {
+        float *row = limdy_matrix_row(&matrix, i);
+        assert((uintptr_t)row % LIMDY_MATRIX_ALIGNMENT == 0);
+        for (size_t j = 0; j < matrix.stride; j++)
+        {
+            assert(row[j] == 0.0f);
+        }
+    }
+    limdy_matrix_row(&matrix, 4)[6] = 1.5f;
+    assert(matrix.data[4 * matrix.stride + 6] == 1.5f);
+
+    limdy_matrix_free(&matrix);
+    assert(matrix.data == NULL && matrix.rows == 0 && !matrix.owned);
+    // Freeing twice is harmless
+    limdy_matrix_free(&matrix);
+    limdy_matrix_free(NULL);
+
+    // An empty matrix owns nothing
+    assert(limdy_matrix_init(&matrix, 0, 4) == ERROR_SUCCESS);
+    assert(matrix.data == NULL && !matrix.owned && matrix.stride == FLOATS_PER_LINE);
+    limdy_matrix_free(&matrix);
+
+    assert(limdy_matrix_init(NULL, 1, 1) == ERROR_NULL_POINTER);
+    printf("test_matrix_init() passed.\n");
+}
+
+void test_matrix_wrap()
+{
+    size_t bytes = limdy_matrix_bytes(3, 20);
+    char *storage = aligned_alloc(LIMDY_MATRIX_ALIGNMENT, bytes + LIMDY_MATRIX_ALIGNMENT);
+    assert(storage != NULL);
+
+    LimdyMatrix matrix;
+    assert(limdy_matrix_wrap(&matrix, 3, 20, storage) == ERROR_SUCCESS);
+    assert((char *)matrix.data == storage && !matrix.owned);
+    assert(matrix.stride == 2 * FLOATS_PER_LINE);
+    assert((char *)limdy_matrix_row(&matrix, 2) == storage + 2 * 2 * LIMDY_MATRIX_ALIGNMENT);
+    limdy_matrix_row(&matrix, 2)[19] = 2.5f;
+
+    // The storage stays the caller's: freeing only clears the matrix
+    limdy_matrix_free(&matrix);
+    assert(matrix.data == NULL);
+    float last;
+    memcpy(&last, storage + 2 * 2 * LIMDY_MATRIX_ALIGNMENT + 19 * sizeof(float), sizeof(last));
+    assert(last == 2.5f);
+
+    // Storage off a cache line is refused
+    assert(limdy_matrix_wrap(&matrix, 3, 20, storage + sizeof(float)) == LIMDY_MATRIX_ERROR_MISALIGNED);
+    assert(limdy_matrix_wrap(&matrix, 3, 20, NULL) == ERROR_NULL_POINTER);
+    assert(limdy_matrix_wrap(NULL, 3, 20, storage) == ERROR_NULL_POINTER);
+
+    free(storage);
+    printf("test_matrix_wrap() passed.\n");
+}
+
+void test_matrix_rows()
+{
+    float row0[] = {1, 2, 3};
+    float row1[] = {4, 5, 6};
+    float *rows_in[] = {row0, row1};
+
+    // Dirty storage, so the copy has to clear the padding itself
+    size_t bytes = limdy_matrix_bytes(2, 3);
+    float *storage = aligned_alloc(LIMDY_MATRIX_ALIGNMENT, bytes);
+    memset(storage, 0xff, bytes);
+    LimdyMatrix matrix;
+    assert(limdy_matrix_wrap(&matrix, 2, 3, storage) == ERROR_SUCCESS);
+    assert(limdy_matrix_copy_from_rows(&matrix, rows_in) == ERROR_SUCCESS);
+    for (size_t i = 0; i < 2; i++)
+    {
+        float *row = limdy_matrix_row(&matrix, i);
+        for (size_t j = 0; j < 3; j++)
+        {
+            assert(row[j] == rows_in[i][j]);
+        }
+        for (size_t j = 3; j < matrix.stride; j++)
+        {
+            assert(row[j] == 0.0f);
+        }
+    }
+
+    // The float ** view points into the matrix, one stride apart
+    float *pointers[2];
+    assert(limdy_matrix_row_pointers(&matrix, pointers) == ERROR_SUCCESS);
+    assert(pointers[0] == matrix.data && pointers[1] == pointers[0] + matrix.stride);
+    pointers[1][2] = 7.0f;
+    assert(limdy_matrix_row(&matrix, 1)[2] == 7.0f);
+
+    assert(limdy_matrix_copy_from_rows(&matrix, NULL) == ERROR_NULL_POINTER);
+    assert(limdy_matrix_row_pointers(&matrix, NULL) == ERROR_NULL_POINTER);
+    limdy_matrix_free(&matrix);
+    free(storage);
+    printf("test_matrix_rows() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_matrix_stride();
+    test_matrix_init();
+    test_matrix_wrap();
+    test_matrix_rows();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
@@ -0,0 +1,614 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "memory_pool.h"
+#include "rbtree.h"
+#include "error_handler.h"
+
+#define TEST_THREADS 8
+#define TEST_ALLOCATIONS 1000
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+static void *slab_worker(void *arg)
+{
+    unsigned char tag = (unsigned char)(size_t)arg;
+    void *ptrs[TEST_ALLOCATIONS];
+
+    for (int round = 0; round < 50; round++)
+    {
+        for (size_t i = 0; i < TEST_ALLOCATIONS; i++)
+        {
+            size_t size = 1 + (i * 37) % LIMDY_SLAB_MAX_SIZE;
+            ptrs[i] = limdy_memory_pool_alloc(size);
+            assert(ptrs[i] != NULL);
+            memset(ptrs[i], tag, size);
+        }
+        for (size_t i = 0; i < TEST_ALLOCATIONS; i++)
+        {
+            // Another thread writing into our objects would show up here
+            assert(((unsigned char *)ptrs[i])[0] == tag);
+            limdy_memory_pool_free(ptrs[i]);
+        }
+    }
+    return NULL;
+}
+
+// Test functions
+void test_slab_alloc_free()
+{
+    void *small = limdy_memory_pool_alloc(24);
+    void *other = limdy_memory_pool_alloc(24);
+    assert(small != NULL && other != NULL && small != other);
+    limdy_memory_pool_free(small);
+    // The thread cache hands the most recently freed object back first
+    assert(limdy_memory_pool_alloc(24) == small);
+    limdy_memory_pool_free(small);
+    limdy_memory_pool_free(other);
+    printf("test_slab_alloc_free() passed.\n");
+}
+
+void test_thread_caches()
+{
+    pthread_t threads[TEST_THREADS];
+    for (size_t i = 0; i < TEST_THREADS; i++)
+    {
+        assert(pthread_create(&threads[i], NULL, slab_worker, (void *)(i + 1)) == 0);
+    }
+    for (size_t i = 0; i < TEST_THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    printf("test_thread_caches() passed.\n");
+}
+
+void test_owner_lookup()
+{
+    LimdyMemoryPool *pools[3];
+    void *blocks[3];
+    for (size_t i = 0; i < 3; i++)
+    {
+        assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pools[i]) == ERROR_SUCCESS);
+        blocks[i] = limdy_memory_pool_alloc_from(pools[i], 256);
+        assert(blocks[i] != NULL);
+        assert(limdy_memory_pool_contains(pools[i], blocks[i]));
+    }
+    assert(!limdy_memory_pool_contains(pools[0], blocks[1]));
+
+    // Global free finds the owning pool without being told which one it is
+    for (size_t i = 0; i < 3; i++)
+    {
+        limdy_memory_pool_free(blocks[i]);
+        limdy_memory_pool_destroy(pools[i]);
+    }
+
+    int on_stack;
+    assert(!limdy_memory_pool_contains(pools[0], &on_stack));
+    limdy_memory_pool_free(&on_stack); // Logged and ignored
+    printf("test_owner_lookup() passed.\n");
+}
+
+void test_realloc_across_owners()
+{
+    char *data = limdy_memory_pool_alloc(16);
+    assert(data != NULL);
+    memcpy(data, "slab", 5);
+
+    // Outgrows every slab size class and lands in a pool
+    data = limdy_memory_pool_realloc(data, 4096);
+    assert(data != NULL);
+    assert(strcmp(data, "slab") == 0);
+
+    data = limdy_memory_pool_realloc(data, 8192);
+    assert(data != NULL);
+    assert(strcmp(data, "slab") == 0);
+
+    limdy_memory_pool_free(data);
+    printf("test_realloc_across_owners() passed.\n");
+}
+
+void test_realloc_grows_geometrically()
+{
+    enum { STEP = 16, FINAL_SIZE = 64 * 1024 };
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(1024 * 1024, &pool) == ERROR_SUCCESS);
+
+    // Two arrays appended to in turn keep getting in each other's way
+    unsigned char *arrays[2] = {NULL, NULL};
+    size_t moves[2] = {0, 0};
+    for (size_t size = STEP; size <= FINAL_SIZE; size += STEP)
+    {
+        for (size_t a = 0; a < 2; a++)
+        {
+            unsigned char *grown = limdy_memory_pool_realloc_from(pool, arrays[a], size);
+            assert(grown != NULL);
+            moves[a] += grown != arrays[a];
+            arrays[a] = grown;
+            memset(arrays[a] + size - STEP, (int)(size / STEP), STEP);
+        }
+    }
+    for (size_t a = 0; a < 2; a++)
+    {
+        // Growing by half again each time moves O(log n) times, not once per append
+        assert(moves[a] < 32);
+        for (size_t size = STEP; size <= FINAL_SIZE; size += STEP)
+        {
+            assert(arrays[a][size - 1] == (unsigned char)(size / STEP));
+        }
+    }
+
+    // A free neighbour is absorbed without moving
+    limdy_memory_pool_free_to(pool, arrays[1]);
+    unsigned char *grown = limdy_memory_pool_realloc_from(pool, arrays[0], 3 * FINAL_SIZE);
+    assert(grown == arrays[0]);
+    assert(grown[FINAL_SIZE - 1] == (unsigned char)(FINAL_SIZE / STEP));
+
+    limdy_memory_pool_free_to(pool, grown);
+    limdy_memory_pool_destroy(pool);
+    printf("test_realloc_grows_geometrically() passed.\n");
+}
+
+void test_reserve()
+{
+    uint32_t *array = NULL;
+    size_t capacity = 0;
+
+    // An empty array gets the minimum capacity, then doubles as it fills
+    assert(limdy_memory_pool_reserve((void **)&array, &capacity, 1, sizeof(uint32_t)) == ERROR_SUCCESS);
+    assert(array != NULL && capacity == LIMDY_POOL_RESERVE_MIN_CAPACITY);
+    for (size_t i = 0; i < 1000; i++)
+    {
+        assert(limdy_memory_pool_reserve((void **)&array, &capacity, i + 1, sizeof(uint32_t)) == ERROR_SUCCESS);
+        array[i] = (uint32_t)i;
+    }
+    assert(capacity == 1024);
+    for (size_t i = 0; i < 1000; i++)
+    {
+        assert(array[i] == i);
+    }
+
+    // Enough room already leaves the array alone
+    uint32_t *kept = array;
+    assert(limdy_memory_pool_reserve((void **)&array, &capacity, 10, sizeof(uint32_t)) == ERROR_SUCCESS);
+    assert(array == kept && capacity == 1024);
+
+    // A failed growth keeps the array and its capacity
+    assert(limdy_memory_pool_reserve((void **)&array, &capacity, SIZE_MAX / 2, sizeof(uint32_t)) == ERROR_MEMORY_ALLOCATION);
+    assert(array == kept && capacity == 1024 && array[999] == 999);
+
+    assert(limdy_memory_pool_reserve(NULL, &capacity, 1, 1) == ERROR_NULL_POINTER);
+    limdy_memory_pool_free(array);
+    printf("test_reserve() passed.\n");
+}
+
+void test_pool_bins_coalesce()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+
+    void *blocks[TEST_ALLOCATIONS];
+    for (size_t i = 0; i < TEST_ALLOCATIONS; i++)
+    {
+        blocks[i] = limdy_memory_pool_alloc_from(pool, 16 + (i * 53) % 700);
+        assert(blocks[i] != NULL);
+    }
+
+    // Free every other block first so neighbours are merged from both sides later
+    for (size_t i = 0; i < TEST_ALLOCATIONS; i += 2)
+    {
+        limdy_memory_pool_free_to(pool, blocks[i]);
+    }
+    for (size_t i = 1; i < TEST_ALLOCATIONS; i += 2)
+    {
+        limdy_memory_pool_free_to(pool, blocks[i]);
+    }
+
+    // Only possible if the whole pool coalesced back into one block
+    void *whole = limdy_memory_pool_alloc_from(pool, LIMDY_SMALL_POOL_SIZE - 2 * sizeof(struct MemoryBlock));
+    assert(whole != NULL);
+    assert(((uintptr_t)whole % LIMDY_MEMORY_ALIGNMENT) == 0);
+    limdy_memory_pool_free_to(pool, whole);
+
+    limdy_memory_pool_destroy(pool);
+    printf("test_pool_bins_coalesce() passed.\n");
+}
+
+void test_defragment_releases_pages()
+{
+    enum { BLOCKS = 48, BLOCK_SIZE = 60 * 1024 };
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(4 * 1024 * 1024, &pool) == ERROR_SUCCESS);
+    // Pools only trim on their own once given a ratio
+    assert(pool->trim_ratio == 0);
+    assert(limdy_memory_pool_set_trim_ratio(pool, 0) == ERROR_SUCCESS);
+    assert(limdy_memory_pool_set_trim_ratio(pool, -1) == ERROR_INVALID_ARGUMENT);
+
+    unsigned char *blocks[BLOCKS];
+    for (size_t i = 0; i < BLOCKS; i++)
+    {
+        blocks[i] = limdy_memory_pool_alloc_from(pool, BLOCK_SIZE);
+        assert(blocks[i] != NULL);
+        memset(blocks[i], (int)i + 1, BLOCK_SIZE);
+    }
+    for (size_t i = 0; i < BLOCKS; i += 2)
+    {
+        limdy_memory_pool_free_to(pool, blocks[i]);
+    }
+
+    LimdyMemoryPoolFragmentation before, after;
+    assert(limdy_memory_pool_get_fragmentation(pool, &before) == ERROR_SUCCESS);
+    assert(before.free_blocks == BLOCKS / 2 + 1);
+    assert(before.fragmentation > 0.5);
+    assert(before.resident_size >= (size_t)BLOCKS * BLOCK_SIZE);
+
+    // Free pages go back to the system; live blocks keep their contents
+    assert(limdy_memory_pool_defragment(pool) == ERROR_SUCCESS);
+    assert(limdy_memory_pool_get_fragmentation(pool, &after) == ERROR_SUCCESS);
+    assert(after.used_size == before.used_size && after.free_size == before.free_size);
+    assert(after.resident_size < before.resident_size);
+    assert(after.resident_size <= after.used_size + 2 * (size_t)sysconf(_SC_PAGESIZE) * after.free_blocks);
+    assert(after.resident_ratio < before.resident_ratio);
+    for (size_t i = 1; i < BLOCKS; i += 2)
+    {
+        assert(blocks[i][0] == i + 1 && blocks[i][BLOCK_SIZE - 1] == i + 1);
+    }
+
+    // Released blocks are usable again
+    unsigned char *reused = limdy_memory_pool_alloc_from(pool, BLOCK_SIZE);
+    assert(reused != NULL);
+    memset(reused, 0xab, BLOCK_SIZE);
+    limdy_memory_pool_free_to(pool, reused);
+
+    for (size_t i = 1; i < BLOCKS; i += 2)
+    {
+        limdy_memory_pool_free_to(pool, blocks[i]);
+    }
+    assert(limdy_memory_pool_get_fragmentation(pool, &after) == ERROR_SUCCESS);
+    assert(after.free_blocks == 1 && after.fragmentation == 0.0);
+
+    // With a trim ratio, enough frees defragment on their own
+    assert(limdy_memory_pool_set_trim_ratio(pool, 1.5) == ERROR_SUCCESS);
+    for (size_t i = 0; i < BLOCKS; i++)
+    {
+        blocks[i] = limdy_memory_pool_alloc_from(pool, BLOCK_SIZE);
+        memset(blocks[i], 1, BLOCK_SIZE);
+    }
+    for (size_t i = 0; i < BLOCKS; i++)
+    {
+        limdy_memory_pool_free_to(pool, blocks[i]);
+    }
+    assert(limdy_memory_pool_get_fragmentation(pool, &before) == ERROR_SUCCESS);
+    for (size_t i = 0; i < LIMDY_POOL_TRIM_INTERVAL; i++)
+    {
+        limdy_memory_pool_free_to(pool, limdy_memory_pool_alloc_from(pool, 64));
+    }
+    assert(limdy_memory_pool_get_fragmentation(pool, &after) == ERROR_SUCCESS);
+    assert(after.resident_size < before.resident_size / 4);
+
+    LimdyMemoryPoolFragmentation unused;
+    assert(limdy_memory_pool_get_fragmentation(NULL, &unused) == LIMDY_MEMORY_POOL_ERROR_INVALID_POOL);
+
+    limdy_memory_pool_destroy(pool);
+    printf("test_defragment_releases_pages() passed.\n");
+}
+
+typedef struct
+{
+    size_t key;
+    LimdyRBNode node;
+} TestRBItem;
+
+static int compare_test_items(const LimdyRBNode *a, const LimdyRBNode *b)
+{
+    size_t key_a = LIMDY_RB_ENTRY(a, TestRBItem, node)->key;
+    size_t key_b = LIMDY_RB_ENTRY(b, TestRBItem, node)->key;
+    return (key_a > key_b) - (key_a < key_b);
+}
+
+static int compare_test_key(const void *key, const LimdyRBNode *node)
+{
+    size_t wanted = *(const size_t *)key;
+    size_t item_key = LIMDY_RB_ENTRY(node, TestRBItem, node)->key;
+    return (wanted > item_key) - (wanted < item_key);
+}
+
+void test_rbtree_remove()
+{
+    // Many items share a key
+    enum { ITEMS = 200 };
+    TestRBItem *items = calloc(ITEMS, sizeof(TestRBItem));
+    assert(items != NULL);
+    LimdyRBTree tree;
+    assert(limdy_rbtree_init(&tree, compare_test_items) == ERROR_SUCCESS);
+    for (size_t i = 0; i < ITEMS; i++)
+    {
+        items[i].key = 1024 * (1 + (i * 7) % 10);
+        limdy_rbtree_node_clear(&items[i].node);
+        assert(limdy_rbtree_insert(&tree, &items[i].node) == ERROR_SUCCESS);
+    }
+    assert(limdy_rbtree_insert(&tree, &items[0].node) == ERROR_INVALID_ARGUMENT);
+    assert(limdy_rbtree_validate(&tree));
+
+    // Removal takes out the given item, not just any item of its key
+    for (size_t step = 0; step < ITEMS; step++)
+    {
+        size_t i = (step * 37) % ITEMS;
+        assert(limdy_rbtree_remove(&tree, &items[i].node) == ERROR_SUCCESS);
+        assert(!limdy_rbtree_node_linked(&items[i].node));
+        assert(limdy_rbtree_remove(&tree, &items[i].node) == ERROR_INVALID_ARGUMENT);
+        assert(tree.size == ITEMS - 1 - step);
+        assert(limdy_rbtree_validate(&tree));
+    }
+    assert(tree.root == NULL);
+
+    limdy_rbtree_destroy(&tree);
+    free(items);
+    printf("test_rbtree_remove() passed.\n");
+}
+
+void test_rbtree_validate_random()
+{
+    enum { ITEMS = 1000, ROUNDS = 20000 };
+    TestRBItem *items = calloc(ITEMS, sizeof(TestRBItem));
+    assert(items != NULL);
+    LimdyRBTree tree;
+    assert(limdy_rbtree_init(&tree, compare_test_items) == ERROR_SUCCESS);
+    for (size_t i = 0; i < ITEMS; i++)
+    {
+        limdy_rbtree_node_clear(&items[i].node);
+    }
+
+    uint64_t state = 88172645463325252ull;
+    size_t linked = 0;
+    for (size_t round = 0; round < ROUNDS; round++)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        TestRBItem *item = &items[state % ITEMS];
+        if (limdy_rbtree_node_linked(&item->node))
+        {
+            assert(limdy_rbtree_remove(&tree, &item->node) == ERROR_SUCCESS);
+            linked--;
+        }
+        else
+        {
+            item->key = (state >> 32) % 500;
+            assert(limdy_rbtree_insert(&tree, &item->node) == ERROR_SUCCESS);
+            linked++;
+        }
+        assert(tree.size == linked);
+        if (round % 64 == 0)
+        {
+            assert(limdy_rbtree_validate(&tree));
+        }
+
+        // Bounds agree with a linear scan
+        size_t key = (state >> 16) % 520;
+        const TestRBItem *lower = NULL;
+        const TestRBItem *floor = NULL;
+        for (size_t i = 0; i < ITEMS; i++)
+        {
+            if (!limdy_rbtree_node_linked(&items[i].node))
+            {
+                continue;
+            }
+            if (items[i].key >= key && (!lower || items[i].key < lower->key))
+            {
+                lower = &items[i];
+            }
+            if (items[i].key <= key && (!floor || items[i].key > floor->key))
+            {
+                floor = &items[i];
+            }
+        }
+        LimdyRBNode *found = limdy_rbtree_lower_bound(&tree, &key, compare_test_key);
+        assert(lower ? found && LIMDY_RB_ENTRY(found, TestRBItem, node)->key == lower->key : !found);
+        found = limdy_rbtree_floor(&tree, &key, compare_test_key);
+        assert(floor ? found && LIMDY_RB_ENTRY(found, TestRBItem, node)->key == floor->key : !found);
+    }
+    assert(limdy_rbtree_validate(&tree));
+
+    // In-order iteration visits every item in key order
+    size_t visited = 0;
+    size_t previous = 0;
+    for (LimdyRBNode *node = limdy_rbtree_first(&tree); node; node = limdy_rbtree_next(node))
+    {
+        size_t key = LIMDY_RB_ENTRY(node, TestRBItem, node)->key;
+        assert(key >= previous);
+        previous = key;
+        visited++;
+    }
+    assert(visited == linked);
+
+    // A broken tree is caught
+    if (tree.root && tree.root->left)
+    {
+        tree.root->left->parent = NULL;
+        assert(!limdy_rbtree_validate(&tree));
+        tree.root->left->parent = tree.root;
+        tree.root->color = LIMDY_RB_RED;
+        assert(!limdy_rbtree_validate(&tree));
+        tree.root->color = LIMDY_RB_BLACK;
+    }
+
+    limdy_rbtree_destroy(&tree);
+    for (size_t i = 0; i < ITEMS; i++)
+    {
+        assert(!limdy_rbtree_node_linked(&items[i].node));
+    }
+    free(items);
+    printf("test_rbtree_validate_random() passed.\n");
+}
+
+void test_pool_owner_lookup()
+{
+    LimdyMemoryPool *pools[4];
+    for (size_t i = 0; i < 4; i++)
+    {
+        assert(limdy_memory_pool_create(64 * 1024 * (i + 1), &pools[i]) == ERROR_SUCCESS);
+    }
+    for (size_t i = 0; i < 4; i++)
+    {
+        char *ptr = limdy_memory_pool_alloc_from(pools[i], 1000);
+        assert(limdy_memory_pool_owner(ptr) == pools[i]);
+        assert(limdy_memory_pool_owner(pools[i]->memory) == pools[i]);
+        assert(limdy_memory_pool_owner((char *)pools[i]->memory + pools[i]->total_size - 1) == pools[i]);
+        assert(limdy_memory_pool_owner((char *)pools[i]->memory + pools[i]->total_size) != pools[i]);
+        limdy_memory_pool_free(ptr);
+    }
+
+    // Slab objects and foreign memory belong to no pool
+    void *small = limdy_memory_pool_alloc(32);
+    assert(limdy_memory_pool_owner(small) == NULL);
+    limdy_memory_pool_free(small);
+    int local;
+    assert(limdy_memory_pool_owner(&local) == NULL);
+
+    // Shared pools are indexed as well; a large block lands in one of them
+    void *shared = limdy_memory_pool_alloc(8192);
+    assert(limdy_memory_pool_owner(shared) != NULL);
+    limdy_memory_pool_free(shared);
+
+    void *memory = pools[1]->memory;
+    limdy_memory_pool_destroy(pools[1]);
+    assert(limdy_memory_pool_owner(memory) == NULL);
+    limdy_memory_pool_destroy(pools[0]);
+    limdy_memory_pool_destroy(pools[2]);
+    limdy_memory_pool_destroy(pools[3]);
+    printf("test_pool_owner_lookup() passed.\n");
+}
+
+void test_destroy_shared_pools()
+{
+    // A shared small pool taken out of the size index is no longer picked
+    void *small = limdy_memory_pool_alloc(4096);
+    LimdyMemoryPool *small_pool = limdy_memory_pool_owner(small);
+    assert(small_pool != NULL);
+    limdy_memory_pool_free(small);
+    limdy_memory_pool_destroy(small_pool);
+    small = limdy_memory_pool_alloc(4096);
+    assert(small != NULL && limdy_memory_pool_owner(small) != small_pool);
+    limdy_memory_pool_free(small);
+
+    // Without the large pool, requests only it could serve fail instead of crashing
+    void *large = limdy_memory_pool_alloc(2 * LIMDY_SMALL_POOL_SIZE);
+    LimdyMemoryPool *large_pool = limdy_memory_pool_owner(large);
+    assert(large_pool != NULL);
+    limdy_memory_pool_free(large);
+    limdy_memory_pool_destroy(large_pool);
+    assert(limdy_memory_pool_alloc(2 * LIMDY_SMALL_POOL_SIZE) == NULL);
+
+    limdy_memory_pool_cleanup();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+    printf("test_destroy_shared_pools() passed.\n");
+}
+
+static void *pool_worker(void *arg)
+{
+    unsigned char tag = (unsigned char)(size_t)arg;
+    void *ptrs[64];
+
+    for (size_t i = 0; i < 64; i++)
+    {
+        size_t size = 256 + i * 512;
+        ptrs[i] = limdy_memory_pool_alloc(size);
+        assert(ptrs[i] != NULL);
+        memset(ptrs[i], tag, size);
+    }
+    for (size_t i = 0; i < 64; i++)
+    {
+        assert(((unsigned char *)ptrs[i])[0] == tag);
+        limdy_memory_pool_free(ptrs[i]);
+    }
+    return NULL;
+}
+
+void test_huge_page_and_numa_pools()
+{
+    const LimdyPoolPageMode modes[] = {LIMDY_POOL_PAGES_TRANSPARENT_HUGE, LIMDY_POOL_PAGES_EXPLICIT_HUGE};
+
+    limdy_memory_pool_cleanup();
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+        LimdyMemoryPoolConfig config = test_config;
+        config.page_mode = modes[m];
+        config.numa_local = true;
+        assert(limdy_memory_pool_init(&config) == ERROR_SUCCESS);
+
+        // Every thread is served by the pool set of its node
+        pthread_t threads[TEST_THREADS];
+        for (size_t i = 0; i < TEST_THREADS; i++)
+        {
+            assert(pthread_create(&threads[i], NULL, pool_worker, (void *)(i + 1)) == 0);
+        }
+        for (size_t i = 0; i < TEST_THREADS; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+
+        size_t total_allocated, total_used;
+        limdy_memory_pool_get_stats(&total_allocated, &total_used);
+        assert(total_allocated % LIMDY_HUGE_PAGE_SIZE == 0);
+        assert(total_used == 0);
+
+        // Pools are rounded up to whole huge pages
+        LimdyMemoryPool *pool;
+        assert(limdy_memory_pool_create(100 * 1024, &pool) == ERROR_SUCCESS);
+        size_t total_size, used_size;
+        limdy_memory_pool_get_pool_stats(pool, &total_size, &used_size);
+        assert(total_size == LIMDY_HUGE_PAGE_SIZE);
+#ifdef __linux__
+        // Explicit huge pages fall back to transparent ones when none are reserved
+        assert(pool->mapped_size == LIMDY_HUGE_PAGE_SIZE);
+        assert((uintptr_t)pool->memory % LIMDY_HUGE_PAGE_SIZE == 0);
+        assert(pool->numa_node >= 0);
+#endif
+        void *ptr = limdy_memory_pool_alloc_from(pool, LIMDY_HUGE_PAGE_SIZE / 2);
+        assert(ptr != NULL && limdy_memory_pool_contains(pool, ptr));
+        memset(ptr, 0x5a, LIMDY_HUGE_PAGE_SIZE / 2);
+        limdy_memory_pool_free(ptr);
+        assert(limdy_memory_pool_defragment(pool) == ERROR_SUCCESS);
+        limdy_memory_pool_destroy(pool);
+
+        limdy_memory_pool_cleanup();
+    }
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    printf("test_huge_page_and_numa_pools() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_slab_alloc_free();
+    test_thread_caches();
+    test_owner_lookup();
+    test_realloc_across_owners();
+    test_realloc_grows_geometrically();
+    test_reserve();
+    test_pool_bins_coalesce();
+    test_defragment_releases_pages();
+    test_rbtree_remove();
+    test_rbtree_validate_random();
+    test_pool_owner_lookup();
+    test_destroy_shared_pools();
+    test_huge_page_and_numa_pools();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
@@ -0,0 +1,276 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "limdy_metrics.h"
+#include "memory_pool.h"
+#include "error_handler.h"
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+#define METRIC_THREADS 4
+#define METRIC_ROUNDS 10000
+
+// Test functions
+void test_names_and_percentiles()
+{
+    assert(limdy_metrics_size_class(1) == 0);
+    assert(limdy_metrics_size_class(16) == 0);
+    assert(limdy_metrics_size_class(17) == 1);
+    assert(limdy_metrics_size_class(1024) == 6);
+    assert(limdy_metrics_size_class(SIZE_MAX) == LIMDY_METRICS_SIZE_CLASSES - 1);
+
+    assert(strcmp(limdy_counter_name(LIMDY_COUNTER_ALLOCATIONS + 2), "allocations.64") == 0);
+    assert(strcmp(limdy_counter_name(LIMDY_COUNTER_RENDER_CACHE_HITS), "render_cache.hits") == 0);
+    assert(strcmp(limdy_histogram_name(LIMDY_HISTOGRAM_TOKENIZE_NS), "stage.tokenize_ns") == 0);
+    assert(strcmp(limdy_histogram_name(LIMDY_HISTOGRAM_COUNT), "unknown") == 0);
+
+    // 90 values of 10 and 10 of 1000
+    LimdyHistogramSnapshot histogram = {.count = 100, .sum = 90 * 10 + 10 * 1000, .max = 1000};
+    histogram.buckets[4] = 90;
+    histogram.buckets[10] = 10;
+    assert(limdy_histogram_percentile(&histogram, 50) == 15);
+    assert(limdy_histogram_percentile(&histogram, 90) == 15);
+    assert(limdy_histogram_percentile(&histogram, 91) == 1000);
+    assert(limdy_histogram_percentile(&histogram, 100) == 1000);
+
+    LimdyHistogramSnapshot empty = {0};
+    assert(limdy_histogram_percentile(&empty, 50) == 0);
+
+    printf("test_names_and_percentiles() passed.\n");
+}
+
+#ifdef LIMDY_METRICS
+
+static void *count_worker(void *arg)
+{
+    for (int i = 0; i < METRIC_ROUNDS; i++)
+    {
+        LIMDY_METRIC_COUNT(LIMDY_COUNTER_RENDER_CACHE_MISSES, 1);
+        LIMDY_METRIC_RECORD(LIMDY_HISTOGRAM_MAP_PROBE_GROUPS, (uint64_t)(i % 4));
+    }
+    return NULL;
+}
+
+void test_merged_counters()
+{
+    limdy_metrics_reset();
+
+    // Threads that have exited still count
+    pthread_t threads[METRIC_THREADS];
+    for (int i = 0; i < METRIC_THREADS; i++)
+    {
+        assert(pthread_create(&threads[i], NULL, count_worker, NULL) == 0);
+    }
+    for (int i = 0; i < METRIC_THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    count_worker(NULL);
+
+    LimdyMetricsSnapshot snapshot;
+    limdy_metrics_snapshot(&snapshot);
+    assert(snapshot.counters[LIMDY_COUNTER_RENDER_CACHE_MISSES] == (METRIC_THREADS + 1) * METRIC_ROUNDS);
+
+    LimdyHistogramSnapshot *probes = &snapshot.histograms[LIMDY_HISTOGRAM_MAP_PROBE_GROUPS];
+    assert(probes->count == (METRIC_THREADS + 1) * METRIC_ROUNDS);
+    assert(probes->max == 3);
+    assert(probes->buckets[0] == probes->count / 4);
+    assert(probes->buckets[2] == probes->count / 4 * 2);
+    assert(probes->sum == (METRIC_THREADS + 1) * (METRIC_ROUNDS / 4) * 6);
+
+    limdy_metrics_reset();
+    limdy_metrics_snapshot(&snapshot);
+    assert(snapshot.counters[LIMDY_COUNTER_RENDER_CACHE_MISSES] == 0);
+    assert(snapshot.histograms[LIMDY_HISTOGRAM_MAP_PROBE_GROUPS].count == 0);
+
+    printf("test_merged_counters() passed.\n");
+}
+
+static pthread_key_t late_key;
+
+// A TLS destructor that records; the second round always runs after the metrics block is released
+static void late_record(void *value)
+{
+    if (value == (void *)1)
+    {
+        pthread_setspecific(late_key, (void *)2);
+        return;
+    }
+    LIMDY_METRIC_COUNT(LIMDY_COUNTER_FREES, 1000);
+}
+
+static void *late_worker(void *arg)
+{
+    LIMDY_METRIC_COUNT(LIMDY_COUNTER_RENDER_CACHE_HITS, 1);
+    pthread_setspecific(late_key, (void *)1);
+    return NULL;
+}
+
+void test_teardown_recording()
+{
+    limdy_metrics_reset();
+    assert(pthread_key_create(&late_key, late_record) == 0);
+
+    // Recording after the block is released is dropped, and the block stays free for the next thread
+    for (int i = 0; i < 2; i++)
+    {
+        pthread_t thread;
+        assert(pthread_create(&thread, NULL, late_worker, NULL) == 0);
+        pthread_join(thread, NULL);
+    }
+
+    LimdyMetricsSnapshot snapshot;
+    limdy_metrics_snapshot(&snapshot);
+    assert(snapshot.counters[LIMDY_COUNTER_RENDER_CACHE_HITS] == 2);
+    assert(snapshot.counters[LIMDY_COUNTER_FREES] == 0);
+
+    pthread_key_delete(late_key);
+    limdy_metrics_reset();
+    printf("test_teardown_recording() passed.\n");
+}
+
+void test_allocation_metrics()
+{
+    limdy_metrics_reset();
+
+    void *small = limdy_memory_pool_alloc(24);
+    void *large = limdy_memory_pool_alloc(3000);
+    assert(small && large);
+    limdy_memory_pool_free(small);
+    limdy_memory_pool_free(large);
+
+    LimdyMetricsSnapshot snapshot;
+    limdy_metrics_snapshot(&snapshot);
+    assert(snapshot.counters[LIMDY_COUNTER_ALLOCATIONS + limdy_metrics_size_class(32)] == 1);
+    assert(snapshot.counters[LIMDY_COUNTER_ALLOCATIONS + limdy_metrics_size_class(3008)] == 1);
+    assert(snapshot.counters[LIMDY_COUNTER_FREES] == 2);
+    assert(snapshot.histograms[LIMDY_HISTOGRAM_ALLOCATION_NS + limdy_metrics_size_class(32)].count == 1);
+
+    // A fragmented pool fails allocations it has the bytes for
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(64 * 1024, &pool) == ERROR_SUCCESS);
+    void *blocks[64];
+    size_t count = 0;
+    while (count < 64 && (blocks[count] = limdy_memory_pool_alloc_from(pool, 1024)) != NULL)
+    {
+        count++;
+    }
+    for (size_t i = 0; i < count; i += 2)
+    {
+        limdy_memory_pool_free(blocks[i]);
+    }
+    assert(limdy_memory_pool_alloc_from(pool, 4096) == NULL);
+    limdy_metrics_snapshot(&snapshot);
+    assert(snapshot.counters[LIMDY_COUNTER_POOL_FRAGMENTED_FAILURES] == 1);
+
+    for (size_t i = 1; i < count; i += 2)
+    {
+        limdy_memory_pool_free(blocks[i]);
+    }
+    limdy_memory_pool_destroy(pool);
+
+    printf("test_allocation_metrics() passed.\n");
+}
+
+static void *trace_worker(void *arg)
+{
+    LIMDY_TRACE_BEGIN(span);
+    LIMDY_METRIC_TIME_BEGIN(stage);
+    LIMDY_METRIC_TIME_END(stage, LIMDY_HISTOGRAM_CLASSIFY_NS);
+    LIMDY_TRACE_END(span, "worker");
+    return NULL;
+}
+
+void test_chrome_trace()
+{
+    const char *path = "test_metrics_trace.json";
+
+    // Nothing is traced until tracing is enabled
+    trace_worker(NULL);
+    limdy_trace_enable(true);
+    for (int i = 0; i < 3; i++)
+    {
+        pthread_t thread;
+        assert(pthread_create(&thread, NULL, trace_worker, NULL) == 0);
+        pthread_join(thread, NULL);
+    }
+    limdy_trace_enable(false);
+    trace_worker(NULL);
+
+    assert(limdy_trace_write_chrome_json(path) == ERROR_SUCCESS);
+
+    FILE *file = fopen(path, "r");
+    assert(file);
+    static char json[1 << 16];
+    size_t length = fread(json, 1, sizeof(json) - 1, file);
+    json[length] = '\0';
+    fclose(file);
+    remove(path);
+
+    assert(strncmp(json, "{\"traceEvents\":[", 16) == 0);
+    size_t workers = 0;
+    size_t stages = 0;
+    for (const char *at = json; (at = strstr(at, "\"name\":\"")) != NULL; at++)
+    {
+        workers += strncmp(at + 8, "worker\"", 7) == 0;
+        stages += strncmp(at + 8, "stage.classify_ns\"", 18) == 0;
+    }
+    assert(workers == 3 && stages == 3);
+    assert(strstr(json, "\"ph\":\"X\"") != NULL);
+
+    assert(limdy_trace_write_chrome_json(NULL) == ERROR_NULL_POINTER);
+
+    printf("test_chrome_trace() passed.\n");
+}
+
+#else
+
+void test_compiled_out()
+{
+    // Without LIMDY_METRICS the macros are no-ops and snapshots stay empty
+    LIMDY_METRIC_COUNT(LIMDY_COUNTER_FREES, 1);
+    LIMDY_METRIC_TIME_BEGIN(started);
+    LIMDY_METRIC_TIME_END(started, LIMDY_HISTOGRAM_ALIGN_NS);
+    limdy_memory_pool_free(limdy_memory_pool_alloc(64));
+
+    LimdyMetricsSnapshot snapshot;
+    memset(&snapshot, 0xff, sizeof(snapshot));
+    limdy_metrics_snapshot(&snapshot);
+    assert(snapshot.counters[LIMDY_COUNTER_FREES] == 0);
+    assert(snapshot.histograms[LIMDY_HISTOGRAM_ALIGN_NS].count == 0);
+    assert(limdy_trace_write_chrome_json("unused.json") == ERROR_SUCCESS);
+
+    printf("test_compiled_out() passed.\n");
+}
+
+#endif // LIMDY_METRICS
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_names_and_percentiles();
+#ifdef LIMDY_METRICS
+    test_merged_counters();
+    test_teardown_recording();
+    test_allocation_metrics();
+    test_chrome_trace();
+#else
+    test_compiled_out();
+#endif
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "phrase_extractor.h"
+#include "error_handler.h"
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+// Whitespace tokenizer producing spans into source
+static size_t split(const char *source, Token *tokens, size_t capacity)
+{
+    size_t count = 0;
+    size_t i = 0;
+    size_t length = strlen(source);
+    while (i < length && count < capacity)
+    {
+        while (i < length && source[i] == ' ')
+        {
+            i++;
+        }
+        size_t start = i;
+        while (i < length && source[i] != ' ')
+        {
+            i++;
+        }
+        if (i > start)
+        {
+            memset(&tokens[count], 0, sizeof(Token));
+            tokens[count].text = (char *)source + start;
+            tokens[count].offset = start;
+            tokens[count].length = i - start;
+            count++;
+        }
+    }
+    return count;
+}
+
+static ExtendedLinguisticElement *find_phrase(LinguisticElementMap *map, const Token *tokens, size_t token_count)
+{
+    return linguistic_element_map_find_tokens(map, phrase_extractor_hash(tokens, token_count), tokens, token_count);
+}
+
+// Test functions
+void test_every_window()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    LinguisticElementMap map;
+    assert(linguistic_element_map_init(&map, 16, pool) == ERROR_SUCCESS);
+
+    Token tokens[16];
+    size_t count = split("one two three four five six seven", tokens, 16);
+
+    // With no threshold every window is kept, each under the hash of its tokens alone
+    PhraseExtractorConfig config = {1, 5, 1};
+    assert(phrase_extractor_extract(&config, tokens, count, &map) == ERROR_SUCCESS);
+    size_t expected = 0;
+    for (size_t n = 1; n <= 5; n++)
+    {
+        for (size_t start = 0; start + n <= count; start++)
+        {
+            ExtendedLinguisticElement *phrase = find_phrase(&map, &tokens[start], n);
+            assert(phrase != NULL);
+            assert(phrase->base.type == ELEMENT_PHRASE && phrase->base.token_count == n);
+            assert(phrase->occurrence_count == 1 && phrase->occurrences[0] == &tokens[start]);
+            expected++;
+        }
+    }
+    assert(map.element_count == expected);
+
+    // Longer than the range is not extracted
+    assert(find_phrase(&map, tokens, 6) == NULL);
+
+    linguistic_element_map_free(&map);
+    limdy_memory_pool_destroy(pool);
+    printf("test_every_window() passed.\n");
+}
+
+void test_min_occurrences()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    LinguisticElementMap map;
+    assert(linguistic_element_map_init(&map, 16, pool) == ERROR_SUCCESS);
+
+    Token tokens[32];
+    size_t count = split("the cat sat on the mat and the cat ran but the cat sat", tokens, 32);
+
+    PhraseExtractorConfig config = {2, 3, 2};
+    assert(phrase_extractor_extract(&config, tokens, count, &map) == ERROR_SUCCESS);
+
+    // Occurrences from before the threshold was reached are kept, in order
+    ExtendedLinguisticElement *the_cat = find_phrase(&map, &tokens[0], 2);
+    assert(the_cat != NULL && the_cat->occurrence_count == 3);
+    assert(the_cat->occurrences[0] == &tokens[0]);
+    assert(the_cat->occurrences[1] == &tokens[7]);
+    assert(the_cat->occurrences[2] == &tokens[11]);
+    assert(&the_cat->occurrences[2][1] == &tokens[12]);
+
+    ExtendedLinguisticElement *cat_sat = find_phrase(&map, &tokens[1], 2);
+    assert(cat_sat != NULL && cat_sat->occurrence_count == 2);
+    ExtendedLinguisticElement *the_cat_sat = find_phrase(&map, &tokens[0], 3);
+    assert(the_cat_sat != NULL && the_cat_sat->occurrence_count == 2);
+
+    // Seen once
+    assert(find_phrase(&map, &tokens[2], 2) == NULL);
+    assert(find_phrase(&map, &tokens[7], 3) == NULL);
+    assert(map.element_count == 3);
+
+    linguistic_element_map_free(&map);
+    limdy_memory_pool_destroy(pool);
+    printf("test_min_occurrences() passed.\n");
+}
+
+void test_repeated_tokens()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    LinguisticElementMap map;
+    assert(linguistic_element_map_init(&map, 16, pool) == ERROR_SUCCESS);
+
+    // Overlapping windows of one token repeated, which the rolling hash must tell apart by length
+    Token tokens[16];
+    size_t count = split("ha ha ha ha ha", tokens, 16);
+    PhraseExtractorConfig config = {2, 4, 2};
+    assert(phrase_extractor_extract(&config, tokens, count, &map) == ERROR_SUCCESS);
+
+    assert(find_phrase(&map, tokens, 2)->occurrence_count == 4);
+    assert(find_phrase(&map, tokens, 3)->occurrence_count == 3);
+    assert(find_phrase(&map, tokens, 4)->occurrence_count == 2);
+    assert(map.element_count == 3);
+
+    linguistic_element_map_free(&map);
+    limdy_memory_pool_destroy(pool);
+    printf("test_repeated_tokens() passed.\n");
+}
+
+void test_extract_more()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    LinguisticElementMap map;
+    assert(linguistic_element_map_init(&map, 16, pool) == ERROR_SUCCESS);
+
+    // The stream of test_min_occurrences in parts no phrase crosses gives the same phrases
+    const char *parts[] = {"the cat sat on the mat", "and the cat ran", "but the cat sat"};
+    PhraseExtractorConfig config = {2, 3, 2};
+    PhraseExtractorState *state;
+    assert(phrase_extractor_state_create(&config, &state) == ERROR_SUCCESS);
+    Token tokens[32];
+    size_t count = 0;
+    for (size_t i = 0; i < 3; i++)
+    {
+        size_t added = split(parts[i], &tokens[count], 32 - count);
+        assert(phrase_extractor_extract_more(state, tokens, count, added, &map) == ERROR_SUCCESS);
+        count += added;
+    }
+    ExtendedLinguisticElement *the_cat = find_phrase(&map, &tokens[0], 2);
+    assert(the_cat != NULL && the_cat->occurrence_count == 3);
+    assert(the_cat->occurrences[0] == &tokens[0]);
+    assert(the_cat->occurrences[1] == &tokens[7]);
+    assert(the_cat->occurrences[2] == &tokens[11]);
+    assert(find_phrase(&map, &tokens[1], 2)->occurrence_count == 2);
+    assert(find_phrase(&map, &tokens[0], 3)->occurrence_count == 2);
+    assert(map.element_count == 3);
+
+    // A part cannot go back over tokens already extracted
+    assert(phrase_extractor_extract_more(state, tokens, count - 1, 1, &map) == ERROR_INVALID_ARGUMENT);
+    phrase_extractor_state_destroy(state);
+    linguistic_element_map_free(&map);
+
+    // Many short parts grow the counting table as they come
+    assert(linguistic_element_map_init(&map, 16, pool) == ERROR_SUCCESS);
+    assert(phrase_extractor_state_create(&config, &state) == ERROR_SUCCESS);
+    enum { PARTS = 200 };
+    Token *stream = malloc(PARTS * 3 * sizeof(Token));
+    char words[PARTS][32];
+    for (size_t i = 0; i < PARTS; i++)
+    {
+        snprintf(words[i], sizeof(words[i]), "w%zu all parts", i);
+        split(words[i], &stream[i * 3], 3);
+        assert(phrase_extractor_extract_more(state, stream, i * 3, 3, &map) == ERROR_SUCCESS);
+    }
+    ExtendedLinguisticElement *all_parts = find_phrase(&map, &stream[1], 2);
+    assert(all_parts != NULL && all_parts->occurrence_count == PARTS);
+    assert(all_parts->occurrences[0] == &stream[1] && all_parts->occurrences[PARTS - 1] == &stream[PARTS * 3 - 2]);
+    assert(map.element_count == 1);
+    phrase_extractor_state_destroy(state);
+    free(stream);
+
+    linguistic_element_map_free(&map);
+    limdy_memory_pool_destroy(pool);
+    printf("test_extract_more() passed.\n");
+}
+
+void test_invalid_config()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    LinguisticElementMap map;
+    assert(linguistic_element_map_init(&map, 4, pool) == ERROR_SUCCESS);
+
+    Token tokens[4];
+    size_t count = split("a b c", tokens, 4);
+    PhraseExtractorConfig invalid[] = {
+        {0, 2, 1},
+        {3, 2, 1},
+        {1, LIMDY_PHRASE_EXTRACTOR_MAX_LENGTH + 1, 1},
+        {1, 2, 0}};
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+    {
+        assert(phrase_extractor_extract(&invalid[i], tokens, count, &map) == ERROR_INVALID_ARGUMENT);
+    }
+    assert(map.element_count == 0);
+
+    // Fewer tokens than the shortest phrase is not an error
+    PhraseExtractorConfig config = LIMDY_PHRASE_EXTRACTOR_CONFIG_DEFAULT;
+    assert(phrase_extractor_extract(&config, tokens, 1, &map) == ERROR_SUCCESS);
+    assert(map.element_count == 0);
+
+    linguistic_element_map_free(&map);
+    limdy_memory_pool_destroy(pool);
+    printf("test_invalid_config() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_every_window();
+    test_min_occurrences();
+    test_repeated_tokens();
+    test_extract_more();
+    test_invalid_config();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
@@ -0,0 +1,417 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "renderer.h"
+#include "render_cache.h"
+#include "error_handler.h"
+#include "test_fixtures.h"
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+#define CACHE_THREADS 8
+#define CACHE_ROUNDS 2000
+
+static Renderer *create_renderer(LimdyMemoryPool *pool, bool spans)
+{
+    TestRendererConfig config = {.tokenizer = spans ? TEST_TOKENIZER_SPANS : TEST_TOKENIZER_CLASSIC, .separators = " \n"};
+    return test_create_renderer(pool, &config);
+}
+
+// Test functions
+void test_tokenize_spans()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool, true);
+
+    const char *text = "the quick  brown fox";
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 0) == ERROR_SUCCESS);
+    RendererResult result = {.arena = &arena};
+
+    test_tokenize_calls = 0;
+    assert(renderer_tokenize(renderer, text, LANG_ENGLISH, &result) == ERROR_SUCCESS);
+    assert(test_tokenize_calls == 1);
+    assert(result.token_count == 4);
+    assert(result.source == text);
+    // Tokens point into the caller's buffer instead of copies
+    assert(result.tokens[2].text == text + 11);
+    assert(result.tokens[2].offset == 11 && result.tokens[2].length == 5);
+    assert(memcmp(result.tokens[3].text, "fox", 3) == 0);
+    renderer_free_result(renderer, &result);
+
+    // Single-character tokens overflow the estimate and take one retry
+    const char *dense = "a b c d e f g h i j k l m n o p";
+    test_tokenize_calls = 0;
+    assert(renderer_tokenize(renderer, dense, LANG_ENGLISH, &result) == ERROR_SUCCESS);
+    assert(test_tokenize_calls == 2);
+    assert(result.token_count == 16);
+    assert(result.tokens[15].text[0] == 'p');
+    renderer_free_result(renderer, &result);
+
+    limdy_arena_release(&arena);
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_tokenize_spans() passed.\n");
+}
+
+void test_tokenize_copy()
+{
+    LimdyMemoryPool *pool;
+    LimdyMemoryPool *result_pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &result_pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool, false);
+
+    RendererResult result = {.pool = result_pool};
+    assert(renderer_tokenize(renderer, "hello big world", LANG_ENGLISH, &result) == ERROR_SUCCESS);
+    assert(result.token_count == 3);
+    // All text is interned right behind the token array
+    assert(result.source == (const char *)(result.tokens + result.token_count));
+    assert(strcmp(result.tokens[0].text, "hello") == 0);
+    assert(strcmp(result.tokens[2].text, "world") == 0);
+    assert(result.tokens[2].text == result.source + result.tokens[2].offset);
+    renderer_free_result(renderer, &result);
+    assert(result.pool == NULL);
+
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_tokenize_copy() passed.\n");
+}
+
+static void assert_spans(const char *text, Language lang, const char **expected, size_t expected_count)
+{
+    Token spans[8];
+    size_t count;
+    assert(token_tokenize_spans(text, strlen(text), lang, spans, 8, &count) == ERROR_SUCCESS);
+    assert(count == expected_count);
+    for (size_t i = 0; i < count; i++)
+    {
+        assert(spans[i].length == strlen(expected[i]));
+        assert(memcmp(text + spans[i].offset, expected[i], spans[i].length) == 0);
+    }
+}
+
+void test_builtin_tokenizer()
+{
+    // Apostrophes join English words, punctuation and digits do not split words
+    assert_spans("don't stop, it's 5pm!", LANG_ENGLISH, (const char *[]){"don't", "stop", "it's", "5pm"}, 4);
+    assert_spans("  'quoted' ", LANG_ENGLISH, (const char *[]){"quoted"}, 1);
+
+    // Inverted marks separate Spanish words, accented letters belong to them
+    assert_spans("\xc2\xbfQu\xc3\xa9 tal? \xc2\xa1" "Bien!", LANG_SPANISH,
+                 (const char *[]){"Qu\xc3\xa9", "tal", "Bien"}, 3);
+    assert_spans("l'agua", LANG_SPANISH, (const char *[]){"l", "agua"}, 2);
+    assert_spans("", LANG_SPANISH, NULL, 0);
+
+    // Counts tokens past the capacity, writing none of them
+    Token spans[2];
+    size_t count;
+    assert(token_tokenize_spans("one two three", 13, LANG_ENGLISH, spans, 2, &count) == ERROR_SUCCESS);
+    assert(count == 3 && spans[1].offset == 4);
+    assert(token_tokenize_spans("one", 3, LANG_ENGLISH, NULL, 0, &count) == ERROR_SUCCESS && count == 1);
+    assert(token_tokenize_spans("one", 3, LANG_COUNT, spans, 2, &count) == ERROR_INVALID_ARGUMENT);
+    assert(token_tokenize_spans("one", 3, LANG_ENGLISH, NULL, 2, &count) == ERROR_NULL_POINTER);
+
+    // The renderer runs it as a span tokenizer
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool, true);
+    renderer->tokenization_service->tokenize_spans = token_tokenize_spans;
+    const char *text = "Hello, world. Hello again!";
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 0) == ERROR_SUCCESS);
+    RendererResult result = {.arena = &arena};
+    assert(renderer_render(renderer, text, LANG_ENGLISH, &result) == ERROR_SUCCESS);
+    assert(result.token_count == 4);
+    assert(result.tokens[3].text == text + 20 && result.tokens[3].length == 5);
+    assert(result.tokens[0].classes == 0);
+    renderer_free_result(renderer, &result);
+
+    limdy_arena_release(&arena);
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_builtin_tokenizer() passed.\n");
+}
+
+void test_extract_phrases()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool, true);
+
+    const char *text = "good morning to you and good morning to all";
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 0) == ERROR_SUCCESS);
+    RendererResult result = {.arena = &arena};
+
+    assert(renderer_render(renderer, text, LANG_ENGLISH, &result) == ERROR_SUCCESS);
+    ExtendedLinguisticElement *phrase = linguistic_element_map_find_tokens(
+        &result.phrase_map, phrase_extractor_hash(result.tokens, 3), result.tokens, 3);
+    assert(phrase != NULL && phrase->occurrence_count == 2);
+    assert(phrase->occurrences[1] == &result.tokens[5]);
+    // "good morning", "morning to" and "good morning to"
+    assert(result.phrase_map.element_count == 3);
+    // Repeated words are one vocab element, with an occurrence per use
+    ExtendedLinguisticElement *good = linguistic_element_map_find_tokens(
+        &result.vocab_map, hash_linguistic_element(result.tokens, 1), result.tokens, 1);
+    assert(result.vocab_map.element_count == 6);
+    assert(good != NULL && good->occurrence_count == 2 && good->occurrences[1] == &result.tokens[5]);
+    renderer_free_result(renderer, &result);
+
+    // Only pairs, kept from their first occurrence
+    PhraseExtractorConfig pairs = {2, 2, 1};
+    assert(renderer_set_phrase_config(renderer, &pairs) == ERROR_SUCCESS);
+    assert(renderer_render(renderer, text, LANG_ENGLISH, &result) == ERROR_SUCCESS);
+    assert(result.phrase_map.element_count == 6);
+    renderer_free_result(renderer, &result);
+
+    PhraseExtractorConfig invalid = {3, 2, 1};
+    assert(renderer_set_phrase_config(renderer, &invalid) == ERROR_INVALID_ARGUMENT);
+
+    limdy_arena_release(&arena);
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_extract_phrases() passed.\n");
+}
+
+void test_extract_allocation_failure()
+{
+    enum { WORDS = 200 };
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool, true);
+
+    // Distinct words, so every token is a vocab element and none is part of a phrase
+    char text[WORDS * 6];
+    size_t length = 0;
+    for (size_t i = 0; i < WORDS; i++)
+    {
+        length += snprintf(text + length, sizeof(text) - length, "w%zu ", i);
+    }
+    LimdyArena arena;
+    assert(limdy_arena_init(&arena, 0) == ERROR_SUCCESS);
+    RendererResult tokenized = {.arena = &arena};
+    assert(renderer_tokenize(renderer, text, LANG_ENGLISH, &tokenized) == ERROR_SUCCESS);
+    assert(tokenized.token_count == WORDS);
+
+    // Pools too small to hold all the vocab must fail the extraction, not return part of it
+    size_t failures = 0, successes = 0;
+    for (size_t pool_size = 4096; pool_size <= 128 * 1024; pool_size += 1024)
+    {
+        LimdyMemoryPool *small;
+        assert(limdy_memory_pool_create(pool_size, &small) == ERROR_SUCCESS);
+        RendererResult result = {.pool = small, .tokens = tokenized.tokens, .token_count = tokenized.token_count};
+        if (renderer_extract_elements(renderer, &result) == ERROR_SUCCESS)
+        {
+            assert(result.vocab_map.element_count == WORDS);
+            successes++;
+        }
+        else
+        {
+            failures++;
+        }
+        // Whatever the maps hold goes with the pool
+        limdy_memory_pool_destroy(small);
+    }
+    assert(failures > 0 && successes > 0);
+
+    limdy_arena_release(&arena);
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_extract_allocation_failure() passed.\n");
+}
+
+void test_cache_hits_and_eviction()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool, true);
+    assert(renderer_enable_cache(renderer, 4 * LIMDY_RENDER_CACHE_SHARDS) == ERROR_SUCCESS);
+
+    char text[] = "the same sentence";
+    const RendererResult *first;
+    const RendererResult *second;
+    atomic_store(&test_classify_calls, 0);
+    assert(renderer_tokenize_shared(renderer, text, LANG_ENGLISH, &first) == ERROR_SUCCESS);
+    assert(first->token_count == 3);
+    // Cached spans refer to the entry's own copy, not the caller's buffer
+    assert(first->source != text);
+
+    // A different buffer with the same text hits without running the services
+    char copy[] = "the same sentence";
+    assert(renderer_tokenize_shared(renderer, copy, LANG_ENGLISH, &second) == ERROR_SUCCESS);
+    assert(second == first);
+    assert(atomic_load(&test_classify_calls) == 1);
+
+    // The language is part of the key
+    const RendererResult *other;
+    assert(renderer_tokenize_shared(renderer, text, LANG_SPANISH, &other) == ERROR_SUCCESS);
+    assert(other != first);
+    renderer_release_shared(renderer, other);
+
+    RenderCacheStats stats;
+    renderer_get_cache_stats(renderer, &stats);
+    assert(stats.hits == 1 && stats.misses == 2 && stats.entries == 2);
+
+    // Far more texts than capacity; a held result must survive its eviction
+    char buffer[32];
+    for (int i = 0; i < 200; i++)
+    {
+        const RendererResult *result;
+        snprintf(buffer, sizeof(buffer), "word%d other%d", i, i);
+        assert(renderer_tokenize_shared(renderer, buffer, LANG_ENGLISH, &result) == ERROR_SUCCESS);
+        renderer_release_shared(renderer, result);
+    }
+    renderer_get_cache_stats(renderer, &stats);
+    assert(stats.evictions > 0);
+    assert(stats.entries <= stats.capacity);
+    assert(first->token_count == 3 && memcmp(first->tokens[1].text, "same", 4) == 0);
+
+    renderer_release_shared(renderer, first);
+    renderer_release_shared(renderer, second);
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_cache_hits_and_eviction() passed.\n");
+}
+
+static void *cache_worker(void *arg)
+{
+    Renderer *renderer = arg;
+    char buffer[32];
+    for (int i = 0; i < CACHE_ROUNDS; i++)
+    {
+        const RendererResult *result;
+        snprintf(buffer, sizeof(buffer), "lesson line %d", i % 64);
+        assert(renderer_tokenize_shared(renderer, buffer, LANG_ENGLISH, &result) == ERROR_SUCCESS);
+        assert(result->token_count == 3);
+        assert(result->tokens[0].length == 6 && memcmp(result->tokens[0].text, "lesson", 6) == 0);
+        renderer_release_shared(renderer, result);
+    }
+    return NULL;
+}
+
+void test_cache_concurrent()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool, true);
+    // Twice the working set, so every shard keeps its keys despite uneven spread
+    assert(renderer_enable_cache(renderer, 128) == ERROR_SUCCESS);
+
+    pthread_t threads[CACHE_THREADS];
+    for (int i = 0; i < CACHE_THREADS; i++)
+    {
+        assert(pthread_create(&threads[i], NULL, cache_worker, renderer) == 0);
+    }
+    for (int i = 0; i < CACHE_THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    RenderCacheStats stats;
+    renderer_get_cache_stats(renderer, &stats);
+    assert(stats.hits + stats.misses == CACHE_THREADS * CACHE_ROUNDS);
+    assert(stats.hits > 0);
+
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_cache_concurrent() passed.\n");
+}
+
+void test_render_parallel()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *serial = create_renderer(pool, true);
+    Renderer *parallel = create_renderer(pool, true);
+    assert(renderer_enable_parallel(parallel, 4, 256) == ERROR_SUCCESS);
+
+    // Sentences of varying length, some ending in a newline
+    size_t capacity = 64 * 1024;
+    char *text = malloc(capacity);
+    size_t length = 0;
+    for (int sentence = 0; sentence < 400; sentence++)
+    {
+        for (int word = 0; word < 3 + sentence % 9; word++)
+        {
+            length += snprintf(text + length, capacity - length, "w%d ", (sentence * 7 + word * 3) % 50);
+        }
+        length += snprintf(text + length, capacity - length, sentence % 5 ? "end. " : "end!\n");
+    }
+
+    LimdyArena serial_arena, parallel_arena;
+    assert(limdy_arena_init(&serial_arena, 0) == ERROR_SUCCESS);
+    assert(limdy_arena_init(&parallel_arena, 0) == ERROR_SUCCESS);
+    RendererResult expected = {.arena = &serial_arena};
+    RendererResult result = {.arena = &parallel_arena};
+
+    assert(renderer_render(serial, text, LANG_ENGLISH, &expected) == ERROR_SUCCESS);
+    atomic_store(&test_classify_calls, 0);
+    assert(renderer_render(parallel, text, LANG_ENGLISH, &result) == ERROR_SUCCESS);
+    // Classified in one batch per segment
+    assert(atomic_load(&test_classify_calls) > 1);
+
+    assert(result.token_count == expected.token_count);
+    assert(result.source == expected.source);
+    for (size_t i = 0; i < expected.token_count; i++)
+    {
+        assert(result.tokens[i].offset == expected.tokens[i].offset);
+        assert(result.tokens[i].length == expected.tokens[i].length);
+        assert(result.tokens[i].text == expected.tokens[i].text);
+    }
+    assert(result.vocab_map.element_count == expected.vocab_map.element_count);
+    assert(result.phrase_map.element_count == expected.phrase_map.element_count);
+    ExtendedLinguisticElement *phrase = linguistic_element_map_find_tokens(
+        &result.phrase_map, phrase_extractor_hash(result.tokens, 2), result.tokens, 2);
+    assert(phrase != NULL);
+    assert(phrase->occurrence_count ==
+           linguistic_element_map_find_tokens(&expected.phrase_map, phrase_extractor_hash(expected.tokens, 2), expected.tokens, 2)
+               ->occurrence_count);
+
+    renderer_free_result(serial, &expected);
+    renderer_free_result(parallel, &result);
+
+    // Short texts stay on the calling thread
+    atomic_store(&test_classify_calls, 0);
+    assert(renderer_render(parallel, "a short text.", LANG_ENGLISH, &result) == ERROR_SUCCESS);
+    assert(atomic_load(&test_classify_calls) == 1);
+    renderer_free_result(parallel, &result);
+
+    limdy_arena_release(&serial_arena);
+    limdy_arena_release(&parallel_arena);
+    free(text);
+    renderer_destroy(serial);
+    renderer_destroy(parallel);
+    limdy_memory_pool_destroy(pool);
+    printf("test_render_parallel() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_tokenize_spans();
+    test_tokenize_copy();
+    test_builtin_tokenizer();
+    test_extract_phrases();
+    test_extract_allocation_failure();
+    test_cache_hits_and_eviction();
+    test_cache_concurrent();
+    test_render_parallel();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
@@ -0,0 +1,231 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "renderer_stream.h"
+#include "error_handler.h"
+#include "test_fixtures.h"
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+#define MAX_COLLECTED 4096
+
+static Renderer *create_renderer(LimdyMemoryPool *pool, bool spans)
+{
+    TestRendererConfig config = {.tokenizer = spans ? TEST_TOKENIZER_SPANS : TEST_TOKENIZER_CLASSIC};
+    return test_create_renderer(pool, &config);
+}
+
+// Tokens seen by the callback, by document offset
+typedef struct
+{
+    const char *document;
+    size_t offsets[MAX_COLLECTED];
+    size_t lengths[MAX_COLLECTED];
+    size_t count;
+    size_t batches;
+    size_t phrases;
+    ErrorCode fail_with;
+} Collected;
+
+static ErrorCode collect(void *context, const RendererResult *batch, size_t document_offset)
+{
+    Collected *collected = context;
+    collected->batches++;
+    collected->phrases += batch->phrase_map.element_count;
+    assert(batch->vocab_map.element_count > 0);
+
+    for (size_t i = 0; i < batch->token_count; i++)
+    {
+        const Token *token = &batch->tokens[i];
+        assert(token->text == batch->source + token->offset);
+        // Each token's text matches the document at its offset
+        assert(memcmp(token->text, collected->document + document_offset + token->offset, token->length) == 0);
+        assert(collected->count < MAX_COLLECTED);
+        collected->offsets[collected->count] = document_offset + token->offset;
+        collected->lengths[collected->count] = token->length;
+        collected->count++;
+    }
+    return collected->fail_with;
+}
+
+static void push_in_chunks(RendererStream *stream, const char *document, size_t chunk_size)
+{
+    size_t length = strlen(document);
+    for (size_t offset = 0; offset < length; offset += chunk_size)
+    {
+        size_t size = length - offset < chunk_size ? length - offset : chunk_size;
+        assert(renderer_stream_push(stream, document + offset, size) == ERROR_SUCCESS);
+    }
+}
+
+// Test functions
+void test_tokens_across_chunks()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool, true);
+
+    const char *document = "the quick brown fox jumps over the lazy dog while the quick brown cat sleeps";
+    Token expected[64];
+    size_t expected_count = 0;
+    assert(mock_tokenize_spans(document, strlen(document), LANG_ENGLISH, expected, 64, &expected_count) == ERROR_SUCCESS);
+
+    // Every chunk size, down to one byte, yields exactly the tokens of the whole document
+    for (size_t chunk_size = 1; chunk_size <= 17; chunk_size++)
+    {
+        Collected *collected = calloc(1, sizeof(Collected));
+        collected->document = document;
+        RendererStream *stream;
+        assert(renderer_stream_create(renderer, LANG_ENGLISH, NULL, collect, collected, &stream) == ERROR_SUCCESS);
+        push_in_chunks(stream, document, chunk_size);
+        assert(renderer_stream_finish(stream) == ERROR_SUCCESS);
+        renderer_stream_destroy(stream);
+
+        assert(collected->count == expected_count);
+        for (size_t i = 0; i < expected_count; i++)
+        {
+            assert(collected->offsets[i] == expected[i].offset);
+            assert(collected->lengths[i] == expected[i].length);
+        }
+        // Small chunks come out as many batches, before the end of the document
+        if (chunk_size == 1)
+        {
+            assert(collected->batches > 1);
+        }
+        free(collected);
+    }
+
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_tokens_across_chunks() passed.\n");
+}
+
+void test_bounded_carry()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool, true);
+
+    // A 100-byte token is split once it outgrows the carry limit
+    char document[128];
+    memset(document, 'x', 100);
+    strcpy(document + 100, " end");
+
+    Collected *collected = calloc(1, sizeof(Collected));
+    collected->document = document;
+    RendererStreamConfig config = {1, 16};
+    RendererStream *stream;
+    assert(renderer_stream_create(renderer, LANG_ENGLISH, &config, collect, collected, &stream) == ERROR_SUCCESS);
+    push_in_chunks(stream, document, 8);
+    assert(renderer_stream_finish(stream) == ERROR_SUCCESS);
+    renderer_stream_destroy(stream);
+
+    assert(collected->count > 2);
+    size_t covered = 0;
+    for (size_t i = 0; i + 1 < collected->count; i++)
+    {
+        assert(collected->offsets[i] == covered);
+        assert(collected->lengths[i] <= config.max_carry + 8);
+        covered += collected->lengths[i];
+    }
+    assert(covered == 100);
+    assert(collected->offsets[collected->count - 1] == 101 && collected->lengths[collected->count - 1] == 3);
+    free(collected);
+
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_bounded_carry() passed.\n");
+}
+
+void test_phrases_per_batch()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool, true);
+
+    Collected *collected = calloc(1, sizeof(Collected));
+    collected->document = "good morning good morning .";
+    RendererStream *stream;
+    assert(renderer_stream_create(renderer, LANG_ENGLISH, NULL, collect, collected, &stream) == ERROR_SUCCESS);
+    assert(renderer_stream_push(stream, collected->document, strlen(collected->document)) == ERROR_SUCCESS);
+    assert(renderer_stream_finish(stream) == ERROR_SUCCESS);
+
+    // The chunk's last token is held back until the end, in a batch of its own
+    assert(collected->batches == 2 && collected->count == 5);
+    assert(collected->phrases == 1);
+
+    assert(renderer_stream_push(stream, "more", 4) == LIMDY_RENDERER_STREAM_ERROR_FINISHED);
+    renderer_stream_destroy(stream);
+    free(collected);
+
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_phrases_per_batch() passed.\n");
+}
+
+void test_callback_error()
+{
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    Renderer *renderer = create_renderer(pool, true);
+
+    Collected *collected = calloc(1, sizeof(Collected));
+    collected->document = "a b c d e f g h i j k l m n o p q r s t u v w x y z";
+    collected->fail_with = ERROR_UNKNOWN;
+    RendererStreamConfig config = {1, 16};
+    RendererStream *stream;
+    assert(renderer_stream_create(renderer, LANG_ENGLISH, &config, collect, collected, &stream) == ERROR_SUCCESS);
+
+    // The failing batch stops the stream and later pushes report its error
+    ErrorCode error = ERROR_SUCCESS;
+    size_t length = strlen(collected->document);
+    for (size_t offset = 0; offset < length && error == ERROR_SUCCESS; offset += 2)
+    {
+        error = renderer_stream_push(stream, collected->document + offset, 2);
+    }
+    assert(renderer_stream_finish(stream) == ERROR_UNKNOWN);
+    assert(error == ERROR_SUCCESS || error == ERROR_UNKNOWN);
+    assert(collected->batches == 1);
+    renderer_stream_destroy(stream);
+    free(collected);
+
+    // Without finishing, destroying drops what is still queued
+    collected = calloc(1, sizeof(Collected));
+    collected->document = "a b c d";
+    assert(renderer_stream_create(renderer, LANG_ENGLISH, NULL, collect, collected, &stream) == ERROR_SUCCESS);
+    assert(renderer_stream_push(stream, collected->document, strlen(collected->document)) == ERROR_SUCCESS);
+    renderer_stream_destroy(stream);
+    free(collected);
+
+    // Streaming needs a span tokenizer
+    Renderer *copying = create_renderer(pool, false);
+    assert(renderer_stream_create(copying, LANG_ENGLISH, NULL, collect, NULL, &stream) == ERROR_RENDERER_SERVICE_UNAVAILABLE);
+    renderer_destroy(copying);
+
+    renderer_destroy(renderer);
+    limdy_memory_pool_destroy(pool);
+    printf("test_callback_error() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_tokens_across_chunks();
+    test_bounded_carry();
+    test_phrases_per_batch();
+    test_callback_error();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "teacher.h"
+#include "linguistic_element.h"
+#include "error_handler.h"
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+#define DAY (24 * 60 * 60)
+#define RANDOM_ITEMS 5000
+#define RANDOM_REVIEWS 20000
+#define MAP_WORDS 300
+
+static uint64_t next_random(uint64_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static int compare_due(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+// Test functions
+void test_schedule_intervals()
+{
+    Teacher *teacher;
+    assert(teacher_create(0, &teacher) == ERROR_SUCCESS);
+    assert(teacher_add(teacher, 7, 0xabc, 1000) == ERROR_SUCCESS);
+
+    TeacherReview review;
+    assert(teacher_find(teacher, 7, 0xabc, &review));
+    assert(review.due == 1000 && review.ease == LIMDY_TEACHER_INITIAL_EASE && review.repetitions == 0);
+
+    // One day, six days, then the interval times the ease
+    assert(teacher_record(teacher, 7, 0xabc, TEACHER_GRADE_GOOD, 1000) == ERROR_SUCCESS);
+    assert(teacher_find(teacher, 7, 0xabc, &review));
+    assert(review.interval == DAY && review.due == 1000 + DAY && review.repetitions == 1);
+    assert(teacher_record(teacher, 7, 0xabc, TEACHER_GRADE_GOOD, 2000) == ERROR_SUCCESS);
+    assert(teacher_find(teacher, 7, 0xabc, &review) && review.interval == 6 * DAY);
+    assert(teacher_record(teacher, 7, 0xabc, TEACHER_GRADE_EASY, 3000) == ERROR_SUCCESS);
+    assert(teacher_find(teacher, 7, 0xabc, &review));
+    assert(review.ease == LIMDY_TEACHER_INITIAL_EASE + 100);
+    assert(review.interval == (uint64_t)6 * DAY * review.ease / 1000 && review.due == 3000 + review.interval);
+
+    // Forgetting starts over and makes the element harder
+    assert(teacher_record(teacher, 7, 0xabc, TEACHER_GRADE_AGAIN, 5000) == ERROR_SUCCESS);
+    assert(teacher_find(teacher, 7, 0xabc, &review));
+    assert(review.repetitions == 0 && review.lapses == 1 && review.ease == LIMDY_TEACHER_INITIAL_EASE - 100);
+    assert(review.interval == LIMDY_TEACHER_RELEARN_INTERVAL);
+    for (int i = 0; i < 20; i++)
+    {
+        assert(teacher_record(teacher, 7, 0xabc, TEACHER_GRADE_AGAIN, 5000) == ERROR_SUCCESS);
+    }
+    assert(teacher_find(teacher, 7, 0xabc, &review) && review.ease == LIMDY_TEACHER_MIN_EASE);
+
+    // Intervals stop growing at the maximum
+    for (int i = 0; i < 60; i++)
+    {
+        assert(teacher_record(teacher, 7, 0xabc, TEACHER_GRADE_EASY, 5000) == ERROR_SUCCESS);
+    }
+    assert(teacher_find(teacher, 7, 0xabc, &review) && review.interval == LIMDY_TEACHER_MAX_INTERVAL);
+
+    // Adding again keeps the schedule
+    assert(teacher_add(teacher, 7, 0xabc, 0) == ERROR_SUCCESS);
+    assert(teacher_find(teacher, 7, 0xabc, &review) && review.due == 5000 + LIMDY_TEACHER_MAX_INTERVAL);
+    assert(teacher_item_count(teacher) == 1);
+
+    assert(teacher_record(teacher, 7, 0xdef, TEACHER_GRADE_GOOD, 0) == LIMDY_TEACHER_ERROR_NOT_FOUND);
+    assert(teacher_record(teacher, 8, 0xabc, TEACHER_GRADE_GOOD, 0) == LIMDY_TEACHER_ERROR_NOT_FOUND);
+    assert(teacher_record(teacher, 7, 0xabc, (TeacherGrade)9, 0) == ERROR_INVALID_ARGUMENT);
+    assert(!teacher_find(teacher, 8, 0xabc, &review));
+
+    teacher_destroy(teacher);
+    printf("test_schedule_intervals() passed.\n");
+}
+
+void test_next_due()
+{
+    Teacher *teacher;
+    assert(teacher_create(16, &teacher) == ERROR_SUCCESS);
+
+    // Users share element hashes but not schedules
+    for (uint64_t hash = 1; hash <= 10; hash++)
+    {
+        assert(teacher_add(teacher, 1, hash, 100 - hash) == ERROR_SUCCESS);
+        assert(teacher_add(teacher, 2, hash, 100 + hash) == ERROR_SUCCESS);
+    }
+    assert(teacher_user_item_count(teacher, 1) == 10);
+    assert(teacher_user_item_count(teacher, 2) == 10);
+    assert(teacher_user_item_count(teacher, 3) == 0);
+
+    TeacherReview reviews[10];
+    size_t count;
+    assert(teacher_next_due(teacher, 1, UINT64_MAX, reviews, 3, &count) == ERROR_SUCCESS);
+    assert(count == 3);
+    assert(reviews[0].element_hash == 10 && reviews[1].element_hash == 9 && reviews[2].element_hash == 8);
+    assert(teacher_next_due(teacher, 2, UINT64_MAX, reviews, 3, &count) == ERROR_SUCCESS);
+    assert(count == 3 && reviews[0].element_hash == 1 && reviews[2].element_hash == 3);
+
+    // Only items due by the given time
+    assert(teacher_next_due(teacher, 2, 104, reviews, 10, &count) == ERROR_SUCCESS);
+    assert(count == 4 && reviews[3].due == 104);
+
+    // A review moves the item back in the queue
+    assert(teacher_record(teacher, 2, 1, TEACHER_GRADE_GOOD, 101) == ERROR_SUCCESS);
+    assert(teacher_next_due(teacher, 2, UINT64_MAX, reviews, 10, &count) == ERROR_SUCCESS);
+    assert(count == 10 && reviews[0].element_hash == 2 && reviews[9].element_hash == 1);
+
+    assert(teacher_next_due(teacher, 3, UINT64_MAX, reviews, 10, &count) == ERROR_SUCCESS && count == 0);
+    assert(teacher_next_due(teacher, 1, UINT64_MAX, NULL, 0, &count) == ERROR_SUCCESS && count == 0);
+    assert(teacher_next_due(teacher, 1, UINT64_MAX, NULL, 1, &count) == ERROR_NULL_POINTER);
+
+    teacher_destroy(teacher);
+    printf("test_next_due() passed.\n");
+}
+
+void test_random_reviews()
+{
+    Teacher *teacher;
+    assert(teacher_create(0, &teacher) == ERROR_SUCCESS);
+    static uint64_t due[RANDOM_ITEMS];
+    static TeacherReview reviews[RANDOM_ITEMS];
+    uint64_t state = 0x2545F4914F6CDD1Dull;
+
+    for (size_t i = 0; i < RANDOM_ITEMS; i++)
+    {
+        assert(teacher_add(teacher, 42, i * 0x9E3779B97F4A7C15ull, next_random(&state) % 100000) == ERROR_SUCCESS);
+        // Other users interleave their items with this one's
+        assert(teacher_add(teacher, (uint32_t)(i % 13), i, 0) == ERROR_SUCCESS);
+    }
+    for (size_t i = 0; i < RANDOM_REVIEWS; i++)
+    {
+        size_t item = next_random(&state) % RANDOM_ITEMS;
+        TeacherGrade grade = (TeacherGrade)(next_random(&state) % 4);
+        assert(teacher_record(teacher, 42, item * 0x9E3779B97F4A7C15ull, grade, next_random(&state) % 100000) == ERROR_SUCCESS);
+    }
+
+    // The queue agrees with the items' own schedules
+    for (size_t i = 0; i < RANDOM_ITEMS; i++)
+    {
+        TeacherReview review;
+        assert(teacher_find(teacher, 42, i * 0x9E3779B97F4A7C15ull, &review));
+        due[i] = review.due;
+    }
+    qsort(due, RANDOM_ITEMS, sizeof(uint64_t), compare_due);
+
+    size_t count;
+    assert(teacher_next_due(teacher, 42, UINT64_MAX, reviews, RANDOM_ITEMS, &count) == ERROR_SUCCESS);
+    assert(count == RANDOM_ITEMS);
+    for (size_t i = 0; i < count; i++)
+    {
+        assert(reviews[i].due == due[i]);
+    }
+    assert(teacher_next_due(teacher, 42, due[99], reviews, 50, &count) == ERROR_SUCCESS && count == 50);
+    assert(reviews[49].due == due[49]);
+    assert(teacher_item_count(teacher) == 2 * RANDOM_ITEMS);
+
+    teacher_destroy(teacher);
+    printf("test_random_reviews() passed.\n");
+}
+
+void test_add_map()
+{
+    static char words[MAP_WORDS][16];
+    static Token tokens[MAP_WORDS];
+    LimdyMemoryPool *pool;
+    assert(limdy_memory_pool_create(LIMDY_LARGE_POOL_SIZE, &pool) == ERROR_SUCCESS);
+    LinguisticElementMap map;
+    assert(linguistic_element_map_init(&map, 16, pool) == ERROR_SUCCESS);
+    for (size_t i = 0; i < MAP_WORDS; i++)
+    {
+        snprintf(words[i], sizeof(words[i]), "word%zu", i);
+        tokens[i] = (Token){.text = words[i], .length = strlen(words[i])};
+        assert(linguistic_element_map_record(&map, ELEMENT_VOCAB, hash_linguistic_element(&tokens[i], 1), &tokens[i], 1) ==
+               ERROR_SUCCESS);
+    }
+
+    Teacher *teacher;
+    assert(teacher_create(MAP_WORDS, &teacher) == ERROR_SUCCESS);
+    assert(teacher_add_map(teacher, 5, &map, 50) == ERROR_SUCCESS);
+    assert(teacher_user_item_count(teacher, 5) == MAP_WORDS);
+
+    // Items are named by the elements' hashes
+    TeacherReview review;
+    uint64_t hash = hash_linguistic_element(&tokens[17], 1);
+    assert(teacher_find(teacher, 5, hash, &review) && review.due == 50);
+    assert(linguistic_element_map_find(&map, review.element_hash) != NULL);
+
+    teacher_destroy(teacher);
+    linguistic_element_map_free(&map);
+    limdy_memory_pool_destroy(pool);
+
+    assert(teacher_create(0, NULL) == ERROR_NULL_POINTER);
+    assert(teacher_add(NULL, 0, 0, 0) == ERROR_NULL_POINTER);
+    teacher_destroy(NULL);
+
+    printf("test_add_map() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_schedule_intervals();
+    test_next_due();
+    test_random_reviews();
+    test_add_map();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
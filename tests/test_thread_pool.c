@@ -0,0 +1,232 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "thread_pool.h"
+#include "memory_pool.h"
+#include "error_handler.h"
+
+#define SUBMIT_TASKS 1000
+#define PARALLEL_COUNT 10000
+#define NESTED_COUNT 100
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+static atomic_int tasks_run;
+
+static void count_task(void *arg)
+{
+    (void)arg;
+    atomic_fetch_add(&tasks_run, 1);
+}
+
+typedef struct
+{
+    size_t order[SUBMIT_TASKS];
+    size_t next;
+} RunOrder;
+
+static RunOrder run_order;
+
+static void record_order(void *arg)
+{
+    run_order.order[run_order.next++] = (size_t)(uintptr_t)arg;
+}
+
+void test_thread_pool_create()
+{
+    LimdyThreadPool *pool;
+    assert(limdy_thread_pool_create(3, &pool) == ERROR_SUCCESS);
+    assert(limdy_thread_pool_size(pool) == 3);
+    limdy_thread_pool_destroy(pool);
+
+    // One worker per CPU, within the cap
+    assert(limdy_thread_pool_create(0, &pool) == ERROR_SUCCESS);
+    assert(limdy_thread_pool_size(pool) >= 1 && limdy_thread_pool_size(pool) <= LIMDY_THREAD_POOL_MAX_AUTO_THREADS);
+    limdy_thread_pool_destroy(pool);
+
+    assert(limdy_thread_pool_size(NULL) == 0);
+    assert(limdy_thread_pool_create(1, NULL) == ERROR_NULL_POINTER);
+    limdy_thread_pool_destroy(NULL);
+    printf("test_thread_pool_create() passed.\n");
+}
+
+void test_thread_pool_submit()
+{
+    LimdyThreadPool *pool;
+    assert(limdy_thread_pool_create(4, &pool) == ERROR_SUCCESS);
+    atomic_store(&tasks_run, 0);
+    for (size_t i = 0; i < SUBMIT_TASKS; i++)
+    {
+        assert(limdy_thread_pool_submit(pool, count_task, NULL) == ERROR_SUCCESS);
+    }
+    // Destroying runs every queued task before the workers stop
+    limdy_thread_pool_destroy(pool);
+    assert(atomic_load(&tasks_run) == SUBMIT_TASKS);
+
+    // A single worker runs tasks in the order they were submitted
+    assert(limdy_thread_pool_create(1, &pool) == ERROR_SUCCESS);
+    run_order.next = 0;
+    for (size_t i = 0; i < SUBMIT_TASKS; i++)
+    {
+        assert(limdy_thread_pool_submit(pool, record_order, (void *)(uintptr_t)i) == ERROR_SUCCESS);
+    }
+    limdy_thread_pool_destroy(pool);
+    assert(run_order.next == SUBMIT_TASKS);
+    for (size_t i = 0; i < SUBMIT_TASKS; i++)
+    {
+        assert(run_order.order[i] == i);
+    }
+
+    assert(limdy_thread_pool_create(1, &pool) == ERROR_SUCCESS);
+    assert(limdy_thread_pool_submit(NULL, count_task, NULL) == ERROR_NULL_POINTER);
+    assert(limdy_thread_pool_submit(pool, NULL, NULL) == ERROR_NULL_POINTER);
+    limdy_thread_pool_destroy(pool);
+    printf("test_thread_pool_submit() passed.\n");
+}
+
+typedef struct
+{
+    LimdyThreadPool *pool;
+    atomic_int accepted;
+    atomic_bool refused;
+} ShutdownProbe;
+
+// Keeps submitting from inside the pool until destroy refuses new work
+static void submit_until_stopped(void *arg)
+{
+    ShutdownProbe *probe = arg;
+    struct timespec pause = {0, 100000};
+    for (;;)
+    {
+        ErrorCode error = limdy_thread_pool_submit(probe->pool, count_task, NULL);
+        if (error == LIMDY_THREAD_POOL_ERROR_STOPPED)
+        {
+            atomic_store(&probe->refused, true);
+            return;
+        }
+        assert(error == ERROR_SUCCESS);
+        atomic_fetch_add(&probe->accepted, 1);
+        nanosleep(&pause, NULL);
+    }
+}
+
+void test_thread_pool_shutdown()
+{
+    ShutdownProbe probe;
+    assert(limdy_thread_pool_create(2, &probe.pool) == ERROR_SUCCESS);
+    atomic_init(&probe.accepted, 0);
+    atomic_init(&probe.refused, false);
+    atomic_store(&tasks_run, 0);
+
+    assert(limdy_thread_pool_submit(probe.pool, submit_until_stopped, &probe) == ERROR_SUCCESS);
+    // Let the probe get going so some of its tasks are queued when shutdown starts
+    while (atomic_load(&probe.accepted) < 10)
+    {
+        struct timespec pause = {0, 100000};
+        nanosleep(&pause, NULL);
+    }
+    limdy_thread_pool_destroy(probe.pool);
+
+    // Submissions after shutdown began are refused; every one accepted before it still ran
+    assert(atomic_load(&probe.refused));
+    assert(atomic_load(&tasks_run) == atomic_load(&probe.accepted));
+    printf("test_thread_pool_shutdown() passed.\n");
+}
+
+typedef struct
+{
+    atomic_int *hits;
+    atomic_int calls;
+} ParallelCount;
+
+static void count_index(void *arg, size_t index)
+{
+    ParallelCount *count = arg;
+    atomic_fetch_add(&count->hits[index], 1);
+    atomic_fetch_add(&count->calls, 1);
+}
+
+typedef struct
+{
+    LimdyThreadPool *pool;
+    ParallelCount count;
+    ErrorCode error;
+} NestedLoop;
+
+// A task that runs a loop on the pool it is running on
+static void run_nested_loop(void *arg)
+{
+    NestedLoop *nested = arg;
+    nested->error = limdy_thread_pool_parallel_for(nested->pool, NESTED_COUNT, count_index, &nested->count);
+}
+
+void test_thread_pool_parallel_for()
+{
+    LimdyThreadPool *pool;
+    assert(limdy_thread_pool_create(4, &pool) == ERROR_SUCCESS);
+
+    // Every index runs exactly once, and all have run when the call returns
+    ParallelCount count = {.hits = calloc(PARALLEL_COUNT, sizeof(atomic_int))};
+    atomic_init(&count.calls, 0);
+    assert(limdy_thread_pool_parallel_for(pool, PARALLEL_COUNT, count_index, &count) == ERROR_SUCCESS);
+    assert(atomic_load(&count.calls) == PARALLEL_COUNT);
+    for (size_t i = 0; i < PARALLEL_COUNT; i++)
+    {
+        assert(atomic_load(&count.hits[i]) == 1);
+    }
+
+    // Fewer indexes than workers, one index, and none
+    memset(count.hits, 0, PARALLEL_COUNT * sizeof(atomic_int));
+    atomic_store(&count.calls, 0);
+    assert(limdy_thread_pool_parallel_for(pool, 2, count_index, &count) == ERROR_SUCCESS);
+    assert(limdy_thread_pool_parallel_for(pool, 1, count_index, &count) == ERROR_SUCCESS);
+    assert(limdy_thread_pool_parallel_for(pool, 0, count_index, &count) == ERROR_SUCCESS);
+    assert(atomic_load(&count.calls) == 3);
+    assert(atomic_load(&count.hits[0]) == 2 && atomic_load(&count.hits[1]) == 1);
+    limdy_thread_pool_destroy(pool);
+
+    // From inside a task on a single worker, the caller finishes the loop itself
+    assert(limdy_thread_pool_create(1, &pool) == ERROR_SUCCESS);
+    memset(count.hits, 0, PARALLEL_COUNT * sizeof(atomic_int));
+    NestedLoop nested = {.pool = pool, .count = {.hits = count.hits}, .error = ERROR_UNKNOWN};
+    atomic_init(&nested.count.calls, 0);
+    assert(limdy_thread_pool_submit(pool, run_nested_loop, &nested) == ERROR_SUCCESS);
+    limdy_thread_pool_destroy(pool);
+    assert(nested.error == ERROR_SUCCESS);
+    assert(atomic_load(&nested.count.calls) == NESTED_COUNT);
+    for (size_t i = 0; i < NESTED_COUNT; i++)
+    {
+        assert(atomic_load(&count.hits[i]) == 1);
+    }
+
+    assert(limdy_thread_pool_parallel_for(NULL, 1, count_index, &count) == ERROR_NULL_POINTER);
+    free(count.hits);
+    printf("test_thread_pool_parallel_for() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_thread_pool_create();
+    test_thread_pool_submit();
+    test_thread_pool_shutdown();
+    test_thread_pool_parallel_for();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
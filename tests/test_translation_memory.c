@@ -0,0 +1,269 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "translation_memory.h"
+#include "memory_pool.h"
+#include "error_handler.h"
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
+#define MEMORY_THREADS 8
+#define MEMORY_ROUNDS 2000
+
+static void make_attention(LimdyMatrix *attention, size_t rows, size_t cols)
+{
+    assert(limdy_matrix_init(attention, rows, cols) == ERROR_SUCCESS);
+    for (size_t i = 0; i < rows; i++)
+    {
+        for (size_t j = 0; j < cols; j++)
+        {
+            limdy_matrix_row(attention, i)[j] = (float)(i * 10 + j);
+        }
+    }
+}
+
+static void sleep_ms(long ms)
+{
+    struct timespec delay = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+}
+
+// Test functions
+void test_lookup_and_insert()
+{
+    TranslationMemoryConfig config = LIMDY_TRANSLATION_MEMORY_CONFIG_DEFAULT;
+    TranslationMemory *memory;
+    assert(translation_memory_create(&config, &memory) == ERROR_SUCCESS);
+
+    const TranslationMemoryHit *hit;
+    assert(translation_memory_lookup(memory, "good morning", "en", "fr", &hit) == LIMDY_TRANSLATION_MEMORY_ERROR_MISS);
+
+    LimdyMatrix attention;
+    make_attention(&attention, 2, 3);
+    assert(translation_memory_insert(memory, "good morning", "en", "fr", "bonjour", &attention) == ERROR_SUCCESS);
+    limdy_matrix_free(&attention);
+
+    assert(translation_memory_lookup(memory, "good morning", "en", "fr", &hit) == ERROR_SUCCESS);
+    assert(strcmp(hit->translated_text, "bonjour") == 0);
+    // Rows are packed without the matrix's stride padding
+    assert(hit->rows == 2 && hit->cols == 3);
+    assert(hit->attention[3] == 10.0f && hit->attention[5] == 12.0f);
+    translation_memory_release(hit);
+
+    // Every part of the key counts, including where one field ends
+    assert(translation_memory_lookup(memory, "good morning", "en", "de", &hit) == LIMDY_TRANSLATION_MEMORY_ERROR_MISS);
+    assert(translation_memory_insert(memory, "good morning", "e", "nfr", "wrong", NULL) == ERROR_SUCCESS);
+    assert(translation_memory_lookup(memory, "good morning", "en", "fr", &hit) == ERROR_SUCCESS);
+    assert(strcmp(hit->translated_text, "bonjour") == 0);
+    translation_memory_release(hit);
+
+    TranslationMemoryStats stats;
+    translation_memory_get_stats(memory, &stats);
+    assert(stats.hits == 2 && stats.misses == 2 && stats.entries == 2 && stats.bytes > 0);
+
+    translation_memory_destroy(memory);
+    printf("test_lookup_and_insert() passed.\n");
+}
+
+void test_ttl_and_limits()
+{
+    TranslationMemoryConfig config = LIMDY_TRANSLATION_MEMORY_CONFIG_DEFAULT;
+    config.ttl_ms = 20;
+    TranslationMemory *memory;
+    assert(translation_memory_create(&config, &memory) == ERROR_SUCCESS);
+
+    const TranslationMemoryHit *hit;
+    assert(translation_memory_insert(memory, "short lived", "en", "fr", "éphémère", NULL) == ERROR_SUCCESS);
+    assert(translation_memory_lookup(memory, "short lived", "en", "fr", &hit) == ERROR_SUCCESS);
+    sleep_ms(50);
+    // A holder keeps its hit valid past expiry
+    assert(strcmp(hit->translated_text, "éphémère") == 0);
+    translation_memory_release(hit);
+    assert(translation_memory_lookup(memory, "short lived", "en", "fr", &hit) == LIMDY_TRANSLATION_MEMORY_ERROR_MISS);
+
+    TranslationMemoryStats stats;
+    translation_memory_get_stats(memory, &stats);
+    assert(stats.expirations == 1 && stats.entries == 0 && stats.bytes == 0);
+    translation_memory_destroy(memory);
+
+    // One entry per shard
+    config = LIMDY_TRANSLATION_MEMORY_CONFIG_DEFAULT;
+    config.max_entries = LIMDY_TRANSLATION_MEMORY_SHARDS;
+    assert(translation_memory_create(&config, &memory) == ERROR_SUCCESS);
+    char text[32];
+    for (int i = 0; i < 200; i++)
+    {
+        snprintf(text, sizeof(text), "sentence %d", i);
+        assert(translation_memory_insert(memory, text, "en", "fr", text, NULL) == ERROR_SUCCESS);
+    }
+    translation_memory_get_stats(memory, &stats);
+    assert(stats.entries <= LIMDY_TRANSLATION_MEMORY_SHARDS);
+    assert(stats.evictions == 200 - stats.entries);
+    translation_memory_destroy(memory);
+
+    // A byte budget too small for the matrix keeps nothing, but fails nothing
+    config = LIMDY_TRANSLATION_MEMORY_CONFIG_DEFAULT;
+    config.max_bytes = 64 * 1024;
+    assert(translation_memory_create(&config, &memory) == ERROR_SUCCESS);
+    LimdyMatrix attention;
+    make_attention(&attention, 64, 64);
+    assert(translation_memory_insert(memory, "long", "en", "fr", "long", &attention) == ERROR_SUCCESS);
+    limdy_matrix_free(&attention);
+    assert(translation_memory_lookup(memory, "long", "en", "fr", &hit) == LIMDY_TRANSLATION_MEMORY_ERROR_MISS);
+
+    // Small entries are evicted to stay within each shard's share of the bytes
+    make_attention(&attention, 4, 16);
+    for (int i = 0; i < 1000; i++)
+    {
+        snprintf(text, sizeof(text), "sentence %d", i);
+        assert(translation_memory_insert(memory, text, "en", "fr", text, &attention) == ERROR_SUCCESS);
+    }
+    limdy_matrix_free(&attention);
+    translation_memory_get_stats(memory, &stats);
+    assert(stats.evictions > 0);
+    assert(stats.bytes <= config.max_bytes);
+    translation_memory_destroy(memory);
+    printf("test_ttl_and_limits() passed.\n");
+}
+
+void test_file_store()
+{
+    char path[] = "/tmp/limdy_tm_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    TranslationMemoryConfig config = LIMDY_TRANSLATION_MEMORY_CONFIG_DEFAULT;
+    TranslationMemory *memory;
+    assert(translation_memory_file_store_create(path, &config.store) == ERROR_SUCCESS);
+    assert(translation_memory_create(&config, &memory) == ERROR_SUCCESS);
+
+    LimdyMatrix attention;
+    make_attention(&attention, 3, 2);
+    assert(translation_memory_insert(memory, "thank you", "en", "fr", "merci", &attention) == ERROR_SUCCESS);
+    assert(translation_memory_insert(memory, "yes", "en", "fr", "oui", NULL) == ERROR_SUCCESS);
+    limdy_matrix_free(&attention);
+    translation_memory_destroy(memory);
+
+    // A crash mid-append leaves a torn record at the end
+    FILE *file = fopen(path, "ab");
+    fwrite("TMR1garbage", 1, 11, file);
+    fclose(file);
+
+    // A warm restart starts with what the last run learned
+    assert(translation_memory_file_store_create(path, &config.store) == ERROR_SUCCESS);
+    assert(translation_memory_create(&config, &memory) == ERROR_SUCCESS);
+    TranslationMemoryStats stats;
+    translation_memory_get_stats(memory, &stats);
+    assert(stats.loaded == 2 && stats.entries == 2);
+
+    const TranslationMemoryHit *hit;
+    assert(translation_memory_lookup(memory, "thank you", "en", "fr", &hit) == ERROR_SUCCESS);
+    assert(strcmp(hit->translated_text, "merci") == 0);
+    assert(hit->rows == 3 && hit->cols == 2 && hit->attention[5] == 21.0f);
+    translation_memory_release(hit);
+
+    // Appends after the truncated tail are read back on the next start
+    config.ttl_ms = 20;
+    translation_memory_destroy(memory);
+    assert(translation_memory_file_store_create(path, &config.store) == ERROR_SUCCESS);
+    assert(translation_memory_create(&config, &memory) == ERROR_SUCCESS);
+    assert(translation_memory_insert(memory, "soon gone", "en", "fr", "bientôt parti", NULL) == ERROR_SUCCESS);
+    assert(translation_memory_insert(memory, "no", "en", "fr", "non", NULL) == ERROR_SUCCESS);
+    translation_memory_destroy(memory);
+    sleep_ms(50);
+
+    config.ttl_ms = 0;
+    assert(translation_memory_file_store_create(path, &config.store) == ERROR_SUCCESS);
+    assert(translation_memory_create(&config, &memory) == ERROR_SUCCESS);
+    translation_memory_get_stats(memory, &stats);
+    // Records from the short-lived run have expired, the rest survive
+    assert(stats.loaded == 2);
+    assert(translation_memory_lookup(memory, "yes", "en", "fr", &hit) == ERROR_SUCCESS);
+    translation_memory_release(hit);
+    assert(translation_memory_lookup(memory, "no", "en", "fr", &hit) == LIMDY_TRANSLATION_MEMORY_ERROR_MISS);
+    translation_memory_destroy(memory);
+
+    // Anything else is refused rather than misread
+    file = fopen(path, "wb");
+    fputs("not a translation memory", file);
+    fclose(file);
+    assert(translation_memory_file_store_create(path, &config.store) == ERROR_SUCCESS);
+    assert(translation_memory_create(&config, &memory) == LIMDY_TRANSLATION_MEMORY_ERROR_BAD_STORE);
+
+    remove(path);
+    printf("test_file_store() passed.\n");
+}
+
+static void *memory_worker(void *arg)
+{
+    TranslationMemory *memory = arg;
+    char text[32];
+    for (int i = 0; i < MEMORY_ROUNDS; i++)
+    {
+        const TranslationMemoryHit *hit;
+        snprintf(text, sizeof(text), "lesson line %d", i % 64);
+        if (translation_memory_lookup(memory, text, "en", "fr", &hit) == ERROR_SUCCESS)
+        {
+            assert(strcmp(hit->translated_text, text) == 0);
+            translation_memory_release(hit);
+        }
+        else
+        {
+            assert(translation_memory_insert(memory, text, "en", "fr", text, NULL) == ERROR_SUCCESS);
+        }
+    }
+    return NULL;
+}
+
+void test_concurrent()
+{
+    TranslationMemoryConfig config = LIMDY_TRANSLATION_MEMORY_CONFIG_DEFAULT;
+    TranslationMemory *memory;
+    assert(translation_memory_create(&config, &memory) == ERROR_SUCCESS);
+
+    pthread_t threads[MEMORY_THREADS];
+    for (int i = 0; i < MEMORY_THREADS; i++)
+    {
+        assert(pthread_create(&threads[i], NULL, memory_worker, memory) == 0);
+    }
+    for (int i = 0; i < MEMORY_THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    TranslationMemoryStats stats;
+    translation_memory_get_stats(memory, &stats);
+    assert(stats.hits + stats.misses == MEMORY_THREADS * MEMORY_ROUNDS);
+    // Racing misses on one text keep a single entry
+    assert(stats.entries == 64 && stats.evictions == 0);
+
+    translation_memory_destroy(memory);
+    printf("test_concurrent() passed.\n");
+}
+
+int main()
+{
+    error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+
+    test_lookup_and_insert();
+    test_ttl_and_limits();
+    test_file_store();
+    test_concurrent();
+
+    limdy_memory_pool_cleanup();
+    error_cleanup();
+
+    printf("All tests passed successfully.\n");
+    return 0;
+}
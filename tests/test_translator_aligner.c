@@ -2,9 +2,24 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
 #include "translator_aligner.h"
 #include "error_handler.h"
 
+#define THROUGHPUT_THREADS 8
+#define THROUGHPUT_CALLS 16
+#define MOCK_REMOTE_LATENCY_NS 2000000L
+#define ASYNC_REQUESTS 200
+
+static const LimdyMemoryPoolConfig test_config = {
+    .small_block_size = LIMDY_SMALL_BLOCK_SIZE,
+    .small_pool_size = LIMDY_SMALL_POOL_SIZE,
+    .large_pool_size = LIMDY_LARGE_POOL_SIZE,
+    .max_pools = 4,
+    .slab_objects_per_slab = LIMDY_DEFAULT_SLAB_OBJECTS_PER_SLAB};
+
 // Mock TranslationService
 ErrorCode mock_translate(const char *text, const char *source_lang, const char *target_lang, char **translated_text)
 {
@@ -28,9 +43,181 @@ ErrorCode mock_get_attention_matrix(const char *source_text, const char *transla
     return ERROR_SUCCESS;
 }
 
+void mock_free_translation(char *translated_text, float **attention_matrix, size_t rows)
+{
+    free(translated_text);
+    for (size_t i = 0; attention_matrix && i < rows; i++)
+    {
+        free(attention_matrix[i]);
+    }
+    free(attention_matrix);
+}
+
+// Remote calls under way, and the most there have been at once
+static atomic_int remote_in_flight;
+static atomic_int remote_peak_in_flight;
+
+static void remote_call_started()
+{
+    int in_flight = atomic_fetch_add(&remote_in_flight, 1) + 1;
+    int peak = atomic_load(&remote_peak_in_flight);
+    while (in_flight > peak && !atomic_compare_exchange_weak(&remote_peak_in_flight, &peak, in_flight))
+    {
+    }
+}
+
+static void remote_call_finished()
+{
+    atomic_fetch_sub(&remote_in_flight, 1);
+}
+
+static void reset_remote_calls()
+{
+    atomic_store(&remote_in_flight, 0);
+    atomic_store(&remote_peak_in_flight, 0);
+}
+
+// Stands in for a blocking call to a remote model server
+ErrorCode mock_slow_translate(const char *text, const char *source_lang, const char *target_lang, char **translated_text)
+{
+    remote_call_started();
+    struct timespec latency = {0, MOCK_REMOTE_LATENCY_NS};
+    nanosleep(&latency, NULL);
+    remote_call_finished();
+    return mock_translate(text, source_lang, target_lang, translated_text);
+}
+
+typedef struct
+{
+    TranslationDoneFn done;
+    void *context;
+} MockAsyncCall;
+
+static void *mock_remote_reply(void *arg)
+{
+    MockAsyncCall *call = arg;
+    struct timespec latency = {0, MOCK_REMOTE_LATENCY_NS};
+    nanosleep(&latency, NULL);
+    remote_call_finished();
+
+    LimdyMatrix attention;
+    assert(limdy_matrix_init(&attention, 2, 2) == ERROR_SUCCESS);
+    for (size_t i = 0; i < 2; i++)
+    {
+        limdy_matrix_row(&attention, i)[0] = limdy_matrix_row(&attention, i)[1] = 0.5f;
+    }
+    call->done(call->context, ERROR_SUCCESS, "Mocked translation", &attention);
+
+    limdy_matrix_free(&attention);
+    free(call);
+    return NULL;
+}
+
+// Replies from a thread of its own, like a network client's event loop would
+ErrorCode mock_translate_async(const char *text, const char *source_lang, const char *target_lang,
+                               TranslationDoneFn done, void *context)
+{
+    MockAsyncCall *call = malloc(sizeof(MockAsyncCall));
+    call->done = done;
+    call->context = context;
+
+    remote_call_started();
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, mock_remote_reply, call) != 0)
+    {
+        remote_call_finished();
+        free(call);
+        return ERROR_THREAD_INIT;
+    }
+    pthread_detach(thread);
+    return ERROR_SUCCESS;
+}
+
 TranslationService mock_translation_service = {
     .translate = mock_translate,
-    .get_attention_matrix = mock_get_attention_matrix};
+    .get_attention_matrix = mock_get_attention_matrix,
+    .free_translation = mock_free_translation};
+
+TranslationService mock_async_translation_service = {
+    .translate = mock_slow_translate,
+    .get_attention_matrix = mock_get_attention_matrix,
+    .free_translation = mock_free_translation,
+    .translate_async = mock_translate_async};
+
+// Produces the translation a word at a time
+ErrorCode mock_translate_stream(const char *text, const char *source_lang, const char *target_lang,
+                                TranslationPartialFn partial, void *context, char **translated_text)
+{
+    partial(context, "Mocked", 6);
+    partial(context, "Mocked translation", 18);
+    return mock_translate(text, source_lang, target_lang, translated_text);
+}
+
+TranslationService mock_stream_translation_service = {
+    .translate = mock_translate,
+    .get_attention_matrix = mock_get_attention_matrix,
+    .free_translation = mock_free_translation,
+    .translate_stream = mock_translate_stream};
+
+TranslationService mock_slow_translation_service = {
+    .translate = mock_slow_translate,
+    .get_attention_matrix = mock_get_attention_matrix,
+    .free_translation = mock_free_translation};
+
+// Translates any text into mock_translation_length bytes
+static size_t mock_translation_length = 16;
+
+ErrorCode mock_sized_translate(const char *text, const char *source_lang, const char *target_lang, char **translated_text)
+{
+    *translated_text = malloc(mock_translation_length + 1);
+    memset(*translated_text, 'x', mock_translation_length);
+    (*translated_text)[mock_translation_length] = '\0';
+    return ERROR_SUCCESS;
+}
+
+TranslationService mock_sized_translation_service = {
+    .translate = mock_sized_translate,
+    .get_attention_matrix = mock_get_attention_matrix,
+    .free_translation = mock_free_translation};
+
+static atomic_int service_translations;
+
+// Batch translation that counts every text it is sent
+ErrorCode mock_translate_batch(const char **texts, size_t count, const char *source_lang, const char *target_lang,
+                               char **translated_texts, LimdyMatrix *attention)
+{
+    atomic_fetch_add(&service_translations, (int)count);
+    for (size_t i = 0; i < count; i++)
+    {
+        translated_texts[i] = malloc(strlen(texts[i]) + 4);
+        sprintf(translated_texts[i], "fr:%s", texts[i]);
+        assert(limdy_matrix_init(&attention[i], 1, 3) == ERROR_SUCCESS);
+        limdy_matrix_row(&attention[i], 0)[2] = (float)strlen(texts[i]);
+    }
+    return ERROR_SUCCESS;
+}
+
+ErrorCode mock_counting_translate(const char *text, const char *source_lang, const char *target_lang, char **translated_text)
+{
+    atomic_fetch_add(&service_translations, 1);
+    return mock_translate(text, source_lang, target_lang, translated_text);
+}
+
+void mock_free_batch_translation(char *translated_text, float **attention_matrix, size_t rows)
+{
+    free(translated_text);
+}
+
+TranslationService mock_counting_translation_service = {
+    .translate = mock_counting_translate,
+    .get_attention_matrix = mock_get_attention_matrix,
+    .free_translation = mock_free_translation};
+
+TranslationService mock_batch_translation_service = {
+    .translate = mock_counting_translate,
+    .get_attention_matrix = mock_get_attention_matrix,
+    .free_translation = mock_free_batch_translation,
+    .translate_batch = mock_translate_batch};
 
 // Mock AlignmentService
 ErrorCode mock_align_tokens(const char **source_tokens, size_t source_count,
@@ -39,7 +226,7 @@ ErrorCode mock_align_tokens(const char **source_tokens, size_t source_count,
                             int **alignment, size_t *alignment_size)
 {
     *alignment_size = 2;
-    *alignment = malloc((*alignment_size) * sizeof(int));
+    *alignment = limdy_memory_pool_alloc((*alignment_size) * sizeof(int));
     (*alignment)[0] = 0;
     (*alignment)[1] = 1;
     return ERROR_SUCCESS;
@@ -49,27 +236,64 @@ AlignmentService mock_alignment_service = {
     .align_tokens = mock_align_tokens};
 
 // Mock Renderer
-ErrorCode mock_tokenize(const char *text, char ***tokens, size_t *token_count)
+ErrorCode mock_tokenize(const char *text, Language lang, Token **tokens, size_t *token_count)
 {
     *token_count = 2;
-    *tokens = malloc((*token_count) * sizeof(char *));
-    (*tokens)[0] = strdup("Token1");
-    (*tokens)[1] = strdup("Token2");
+    *tokens = calloc(*token_count, sizeof(Token));
+    (*tokens)[0].text = strdup("Token1");
+    (*tokens)[0].length = 6;
+    (*tokens)[1].text = strdup("Token2");
+    (*tokens)[1].length = 6;
     return ERROR_SUCCESS;
 }
 
-void mock_free_tokens(char **tokens, size_t token_count)
+void mock_free_tokens(Token *tokens, size_t token_count)
 {
     for (size_t i = 0; i < token_count; i++)
     {
-        free(tokens[i]);
+        free(tokens[i].text);
     }
     free(tokens);
 }
 
-Renderer mock_renderer = {
-    .tokenize = mock_tokenize,
-    .free_tokens = mock_free_tokens};
+ErrorCode mock_classify(Token *tokens, size_t token_count)
+{
+    return ERROR_SUCCESS;
+}
+
+static LimdyMemoryPool *renderer_pool;
+static Renderer *mock_renderer;
+
+static void mock_renderer_create()
+{
+    assert(limdy_memory_pool_create(LIMDY_SMALL_POOL_SIZE, &renderer_pool) == ERROR_SUCCESS);
+
+    // The renderer frees its services to its pool
+    TokenizationService *tokenization = limdy_memory_pool_alloc_from(renderer_pool, sizeof(TokenizationService));
+    ClassificationService *classification = limdy_memory_pool_alloc_from(renderer_pool, sizeof(ClassificationService));
+    *tokenization = (TokenizationService){.tokenize = mock_tokenize, .free_tokens = mock_free_tokens};
+    *classification = (ClassificationService){.classify = mock_classify};
+
+    mock_renderer = renderer_create(renderer_pool, tokenization, classification);
+    assert(mock_renderer != NULL);
+}
+
+static void mock_renderer_destroy()
+{
+    renderer_destroy(mock_renderer);
+    limdy_memory_pool_destroy(renderer_pool);
+}
+
+typedef struct
+{
+    TranslatorAligner *ta;
+    size_t calls;
+} ThroughputArgs;
+
+static double elapsed_seconds(const struct timespec *start, const struct timespec *end)
+{
+    return (double)(end->tv_sec - start->tv_sec) + (double)(end->tv_nsec - start->tv_nsec) / 1e9;
+}
 
 // Custom error handler for testing
 static ErrorContext last_error;
@@ -103,19 +327,168 @@ void test_translator_translate()
     printf("test_translator_translate() passed.\n");
 }
 
+void test_translator_memory()
+{
+    Translator *translator = translator_create(&mock_counting_translation_service);
+    TranslationMemoryConfig config = LIMDY_TRANSLATION_MEMORY_CONFIG_DEFAULT;
+    assert(translator_enable_memory(translator, &config) == ERROR_SUCCESS);
+
+    atomic_store(&service_translations, 0);
+    TranslationResult first = {0};
+    TranslationResult second = {0};
+    assert(translator_translate(translator, "Hello", "en", "fr", &first) == ERROR_SUCCESS);
+    assert(translator_translate(translator, "Hello", "en", "fr", &second) == ERROR_SUCCESS);
+    assert(atomic_load(&service_translations) == 1);
+    // The remembered result is a copy of its own, matrix included
+    assert(strcmp(second.translated_text, "Mocked translation") == 0);
+    assert(second.translated_text != first.translated_text);
+    assert(second.rows == 2 && second.cols == 2 && second.attention_matrix[1][1] == 0.5f);
+    free_translation_result(&first);
+    free_translation_result(&second);
+
+    // The language pair is part of the key
+    assert(translator_translate(translator, "Hello", "en", "de", &first) == ERROR_SUCCESS);
+    assert(atomic_load(&service_translations) == 2);
+    free_translation_result(&first);
+
+    TranslationMemoryStats stats;
+    translator_get_memory_stats(translator, &stats);
+    assert(stats.hits == 1 && stats.misses == 2 && stats.entries == 2);
+    translator_destroy(translator);
+
+    // A batch only sends the texts the memory does not hold
+    translator = translator_create(&mock_batch_translation_service);
+    assert(translator_enable_memory(translator, &config) == ERROR_SUCCESS);
+    const char *warm[] = {"one", "three"};
+    const char *texts[] = {"one", "two", "three", "four"};
+    TranslationResult results[4] = {0};
+    atomic_store(&service_translations, 0);
+    assert(translator_translate_batch(translator, warm, 2, "en", "fr", results) == ERROR_SUCCESS);
+    free_translation_result(&results[0]);
+    free_translation_result(&results[1]);
+    assert(translator_translate_batch(translator, texts, 4, "en", "fr", results) == ERROR_SUCCESS);
+    assert(atomic_load(&service_translations) == 4);
+    for (size_t i = 0; i < 4; i++)
+    {
+        assert(strncmp(results[i].translated_text, "fr:", 3) == 0 && strcmp(results[i].translated_text + 3, texts[i]) == 0);
+        assert(results[i].rows == 1 && results[i].cols == 3);
+        assert(results[i].attention_matrix[0][2] == (float)strlen(texts[i]));
+        free_translation_result(&results[i]);
+    }
+    translator_destroy(translator);
+    printf("test_translator_memory() passed.\n");
+}
+
+void test_translator_result_pools()
+{
+    Translator *translator = translator_create(&mock_sized_translation_service);
+    TranslationPoolRecycler *recycler = &translator->recycler;
+    TranslationResult result = {0};
+
+    // The first result gets a new pool, which goes idle when the result is freed
+    mock_translation_length = 16;
+    assert(translator_translate(translator, "Hello", "en", "fr", &result) == ERROR_SUCCESS);
+    LimdyMemoryPool *pool = result.pool;
+    assert(pool != NULL && result.recycler == recycler && recycler->count == 0);
+    size_t used_size = 0;
+    limdy_memory_pool_get_pool_stats(pool, NULL, &used_size);
+    free_translation_result(&result);
+    assert(recycler->count == 1 && recycler->pools[0] == pool);
+    // The first sample sets the estimate outright
+    assert(recycler->estimate > 0 && recycler->estimate <= used_size);
+    size_t small_estimate = recycler->estimate;
+
+    // A result that fits reuses the idle pool
+    assert(translator_translate(translator, "Hello", "en", "fr", &result) == ERROR_SUCCESS);
+    assert(result.pool == pool && recycler->count == 0);
+    free_translation_result(&result);
+    assert(recycler->count == 1 && recycler->pools[0] == pool);
+    assert(recycler->estimate == small_estimate);
+
+    // One far larger than the estimate gets a pool of its own and moves the estimate up. That pool is
+    // more than four times the new estimate, so it is destroyed instead of kept
+    mock_translation_length = 16 * LIMDY_TRANSLATOR_POOL_GRANULE;
+    assert(translator_translate(translator, "Hello", "en", "fr", &result) == ERROR_SUCCESS);
+    assert(result.pool != pool && recycler->count == 1);
+    size_t large_total = 0;
+    limdy_memory_pool_get_pool_stats(result.pool, &large_total, NULL);
+    free_translation_result(&result);
+    assert(recycler->estimate > small_estimate);
+    assert(large_total > recycler->estimate * 4);
+    assert(recycler->count == 1 && recycler->pools[0] == pool);
+
+    // Small results keep coming from the idle pool, and pull the estimate back down
+    size_t large_estimate = recycler->estimate;
+    mock_translation_length = 16;
+    assert(translator_translate(translator, "Hello", "en", "fr", &result) == ERROR_SUCCESS);
+    assert(result.pool == pool);
+    free_translation_result(&result);
+    assert(recycler->estimate < large_estimate);
+
+    translator_destroy(translator);
+    printf("test_translator_result_pools() passed.\n");
+}
+
+typedef struct
+{
+    size_t calls;
+    char last[64];
+} PartialLog;
+
+static void record_partial(void *context, const char *partial_text, size_t length)
+{
+    PartialLog *log = context;
+    // Every partial translation extends the one before
+    assert(length >= strlen(log->last) && strncmp(partial_text, log->last, strlen(log->last)) == 0);
+    memcpy(log->last, partial_text, length);
+    log->last[length] = '\0';
+    log->calls++;
+}
+
+void test_translator_translate_stream()
+{
+    Translator *translator = translator_create(&mock_stream_translation_service);
+    TranslationMemoryConfig config = LIMDY_TRANSLATION_MEMORY_CONFIG_DEFAULT;
+    assert(translator_enable_memory(translator, &config) == ERROR_SUCCESS);
+
+    PartialLog log = {0};
+    TranslationResult result = {0};
+    assert(translator_translate_stream(translator, "Hello", "en", "fr", record_partial, &log, &result) == ERROR_SUCCESS);
+    assert(log.calls == 2 && strcmp(log.last, "Mocked translation") == 0);
+    assert(strcmp(result.translated_text, "Mocked translation") == 0 && result.rows == 2);
+    free_translation_result(&result);
+
+    // A remembered translation arrives whole
+    log = (PartialLog){0};
+    assert(translator_translate_stream(translator, "Hello", "en", "fr", record_partial, &log, &result) == ERROR_SUCCESS);
+    assert(log.calls == 1 && strcmp(log.last, "Mocked translation") == 0);
+    free_translation_result(&result);
+    translator_destroy(translator);
+
+    // So does one from a service that cannot stream
+    translator = translator_create(&mock_translation_service);
+    log = (PartialLog){0};
+    assert(translator_translate_stream(translator, "Hello", "en", "fr", record_partial, &log, &result) == ERROR_SUCCESS);
+    assert(log.calls == 1 && strcmp(log.last, "Mocked translation") == 0);
+    free_translation_result(&result);
+    assert(translator_translate_stream(translator, "Hello", "en", "fr", NULL, &log, &result) == ERROR_NULL_POINTER);
+    translator_destroy(translator);
+    printf("test_translator_translate_stream() passed.\n");
+}
+
 void test_aligner_create()
 {
-    Aligner *aligner = aligner_create(&mock_alignment_service, &mock_renderer);
+    Aligner *aligner = aligner_create(&mock_alignment_service, mock_renderer);
     assert(aligner != NULL);
     assert(aligner->service == &mock_alignment_service);
-    assert(aligner->renderer == &mock_renderer);
+    assert(aligner->renderer == mock_renderer);
     aligner_destroy(aligner);
     printf("test_aligner_create() passed.\n");
 }
 
 void test_aligner_align()
 {
-    Aligner *aligner = aligner_create(&mock_alignment_service, &mock_renderer);
+    Aligner *aligner = aligner_create(&mock_alignment_service, mock_renderer);
     char **aligned_text;
     size_t aligned_size;
     float **attention_matrix = malloc(2 * sizeof(float *));
@@ -139,9 +512,89 @@ void test_aligner_align()
     printf("test_aligner_align() passed.\n");
 }
 
+// Services get the token texts as C strings
+ErrorCode checking_align_tokens(const char **source_tokens, size_t source_count,
+                                const char **target_tokens, size_t target_count,
+                                float **attention_matrix, size_t rows, size_t cols,
+                                int **alignment, size_t *alignment_size)
+{
+    assert(source_count == 2 && target_count == 2);
+    assert(strcmp(source_tokens[1], "Token2") == 0 && strcmp(target_tokens[0], "Token1") == 0);
+    // The second link points past the target tokens and is dropped
+    *alignment_size = 2;
+    *alignment = limdy_memory_pool_alloc((*alignment_size) * sizeof(int));
+    (*alignment)[0] = 1;
+    (*alignment)[1] = 5;
+    return ERROR_SUCCESS;
+}
+
+void test_aligner_align_result()
+{
+    AlignmentService checking_service = {.align_tokens = checking_align_tokens};
+    Aligner *aligner = aligner_create(&checking_service, mock_renderer);
+    float row0[] = {0.25f, 0.75f};
+    float row1[] = {0.5f, 0.5f};
+    float *attention_matrix[] = {row0, row1};
+
+    AlignmentResult result;
+    assert(aligner_align_result(aligner, "Source", "Target", attention_matrix, 2, 2, &result) == ERROR_SUCCESS);
+    assert(result.source_count == 2 && result.target_count == 2);
+    assert(result.source_tokens[1].length == 6 && strcmp(result.source_tokens[1].text, "Token2") == 0);
+    assert(result.link_count == 1);
+    assert(result.links[0].source_index == 0 && result.links[0].target_index == 1 && result.links[0].score == 0.75f);
+
+    AlignedTextBuffer buffer = {0};
+    assert(alignment_result_format(&result, &buffer) == ERROR_SUCCESS);
+    assert(strcmp(buffer.data, "[Token1] [Token2]\n") == 0);
+    char *data = buffer.data;
+    assert(alignment_result_format(&result, &buffer) == ERROR_SUCCESS);
+    assert(strcmp(buffer.data, "[Token1] [Token2]\n[Token1] [Token2]\n") == 0);
+    assert(buffer.data == data && buffer.length == 36);
+    free_alignment_result(&result);
+    assert(result.buffer == NULL && result.link_count == 0);
+
+    // The dense form gives the same links as the string entries
+    LimdyMatrix dense;
+    assert(limdy_matrix_init(&dense, 2, 2) == ERROR_SUCCESS);
+    limdy_matrix_row(&dense, 0)[0] = 0.9f;
+    limdy_matrix_row(&dense, 1)[1] = 0.8f;
+    Aligner *builtin = aligner_create(NULL, mock_renderer);
+    assert(aligner_align_matrix_result(builtin, "Source", "Target", &dense, &result) == ERROR_SUCCESS);
+    char **aligned_text;
+    size_t aligned_size;
+    assert(aligner_align_matrix(builtin, "Source", "Target", &dense, &aligned_text, &aligned_size) == ERROR_SUCCESS);
+    assert(aligned_size == result.link_count && aligned_size == 2);
+    buffer.length = 0;
+    assert(alignment_result_format(&result, &buffer) == ERROR_SUCCESS);
+    assert(strcmp(buffer.data, "[Token1] [Token1]\n[Token2] [Token2]\n") == 0);
+    assert(strcmp(aligned_text[0], "[Token1] [Token1]") == 0);
+    free_aligned_text(aligned_text, aligned_size);
+    free_alignment_result(&result);
+    aligned_text_buffer_free(&buffer);
+    limdy_matrix_free(&dense);
+
+    // Source tokens kept from earlier are not tokenized again
+    Token kept[] = {{.text = "Kept1", .length = 5}, {.text = "Kept2", .length = 5, .offset = 6}};
+    RendererResult source_tokens = {.tokens = kept, .token_count = 2, .source = "Kept1 Kept2"};
+    assert(limdy_matrix_init(&dense, 2, 2) == ERROR_SUCCESS);
+    limdy_matrix_row(&dense, 0)[1] = 0.9f;
+    assert(aligner_align_tokens_result(builtin, &source_tokens, "Target", &dense, &result) == ERROR_SUCCESS);
+    assert(result.source_count == 2 && strcmp(result.source_tokens[1].text, "Kept2") == 0 && result.source_tokens[1].offset == 6);
+    assert(result.target_count == 2 && strcmp(result.target_tokens[0].text, "Token1") == 0);
+    assert(result.link_count >= 1 && result.links[0].source_index == 0 && result.links[0].target_index == 1);
+    free_alignment_result(&result);
+    limdy_matrix_free(&dense);
+
+    assert(aligner_align_result(aligner, "Source", "Target", NULL, 2, 2, &result) == ERROR_NULL_POINTER);
+    assert(alignment_result_format(NULL, &buffer) == ERROR_NULL_POINTER);
+    aligner_destroy(builtin);
+    aligner_destroy(aligner);
+    printf("test_aligner_align_result() passed.\n");
+}
+
 void test_translator_aligner_create()
 {
-    TranslatorAligner *ta = translator_aligner_create(&mock_translation_service, &mock_alignment_service, &mock_renderer);
+    TranslatorAligner *ta = translator_aligner_create(&mock_translation_service, &mock_alignment_service, mock_renderer);
     assert(ta != NULL);
     assert(ta->translator != NULL);
     assert(ta->aligner != NULL);
@@ -151,7 +604,7 @@ void test_translator_aligner_create()
 
 void test_translator_aligner_process()
 {
-    TranslatorAligner *ta = translator_aligner_create(&mock_translation_service, &mock_alignment_service, &mock_renderer);
+    TranslatorAligner *ta = translator_aligner_create(&mock_translation_service, &mock_alignment_service, mock_renderer);
     char **aligned_text;
     size_t aligned_size;
     ErrorCode error = translator_aligner_process(ta, "Hello", "en", "fr", &aligned_text, &aligned_size);
@@ -164,6 +617,209 @@ void test_translator_aligner_process()
     printf("test_translator_aligner_process() passed.\n");
 }
 
+static atomic_int alignment_calls;
+
+// Fails the second text it is asked to align
+ErrorCode mock_align_tokens_failing_once(const char **source_tokens, size_t source_count,
+                                         const char **target_tokens, size_t target_count,
+                                         float **attention_matrix, size_t rows, size_t cols,
+                                         int **alignment, size_t *alignment_size)
+{
+    if (atomic_fetch_add(&alignment_calls, 1) == 1)
+    {
+        return ERROR_INVALID_ARGUMENT;
+    }
+    return mock_align_tokens(source_tokens, source_count, target_tokens, target_count, attention_matrix, rows, cols, alignment, alignment_size);
+}
+
+static void check_batch_text(const AlignedTextBatch *batch, size_t index)
+{
+    assert(batch->status[index] == ERROR_SUCCESS);
+    assert(batch->offsets[index + 1] - batch->offsets[index] == 2);
+    assert(strcmp(batch->entries[batch->offsets[index]], "[Token1] [Token1]") == 0);
+    assert(strcmp(batch->entries[batch->offsets[index] + 1], "[Token2] [Token2]") == 0);
+}
+
+void test_translator_aligner_process_batch()
+{
+    const char *texts[] = {"one", "two", "three", "four", "five"};
+    const size_t count = sizeof(texts) / sizeof(texts[0]);
+    AlignedTextBatch batch;
+
+    // Without a translate_batch hook every text is translated on its own
+    TranslatorAligner *ta = translator_aligner_create(&mock_counting_translation_service, &mock_alignment_service, mock_renderer);
+    atomic_store(&service_translations, 0);
+    assert(translator_aligner_process_batch(ta, texts, count, "en", "fr", &batch) == ERROR_SUCCESS);
+    assert(atomic_load(&service_translations) == (int)count);
+    assert(batch.count == count && batch.entry_count == 2 * count);
+    for (size_t i = 0; i < count; i++)
+    {
+        assert(batch.offsets[i] == 2 * i);
+        check_batch_text(&batch, i);
+    }
+    assert(batch.offsets[count] == batch.entry_count);
+    // Entries are packed back to back in input order
+    for (size_t i = 0; i + 1 < batch.entry_count; i++)
+    {
+        assert(batch.entries[i + 1] == batch.entries[i] + strlen(batch.entries[i]) + 1);
+    }
+    free_aligned_text_batch(&batch);
+    assert(batch.buffer == NULL && batch.count == 0);
+    translator_aligner_destroy(ta);
+
+    // With one, the whole batch goes to the service in a single call
+    ta = translator_aligner_create(&mock_batch_translation_service, &mock_alignment_service, mock_renderer);
+    atomic_store(&service_translations, 0);
+    assert(translator_aligner_process_batch(ta, texts, count, "en", "fr", &batch) == ERROR_SUCCESS);
+    assert(atomic_load(&service_translations) == (int)count);
+    assert(batch.count == count && batch.entry_count == 2 * count);
+    for (size_t i = 0; i < count; i++)
+    {
+        check_batch_text(&batch, i);
+    }
+    free_aligned_text_batch(&batch);
+    translator_aligner_destroy(ta);
+
+    // A text that fails to align gets no entries and keeps its error; the others are unaffected
+    AlignmentService failing_service = {.align_tokens = mock_align_tokens_failing_once};
+    ta = translator_aligner_create(&mock_translation_service, &failing_service, mock_renderer);
+    atomic_store(&alignment_calls, 0);
+    assert(translator_aligner_process_batch(ta, texts, count, "en", "fr", &batch) == ERROR_SUCCESS);
+    assert(batch.count == count && batch.entry_count == 2 * (count - 1));
+    size_t failed = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (batch.status[i] == ERROR_INVALID_ARGUMENT)
+        {
+            assert(batch.offsets[i + 1] == batch.offsets[i]);
+            failed++;
+        }
+        else
+        {
+            check_batch_text(&batch, i);
+        }
+    }
+    assert(failed == 1);
+    assert(batch.offsets[count] == batch.entry_count);
+    free_aligned_text_batch(&batch);
+
+    // An empty batch succeeds with nothing in it
+    assert(translator_aligner_process_batch(ta, texts, 0, "en", "fr", &batch) == ERROR_SUCCESS);
+    assert(batch.count == 0 && batch.entry_count == 0 && batch.offsets[0] == 0);
+    free_aligned_text_batch(&batch);
+
+    assert(translator_aligner_process_batch(ta, NULL, count, "en", "fr", &batch) == ERROR_NULL_POINTER);
+    translator_aligner_destroy(ta);
+    printf("test_translator_aligner_process_batch() passed.\n");
+}
+
+static void *throughput_worker(void *arg)
+{
+    ThroughputArgs *args = arg;
+    for (size_t i = 0; i < args->calls; i++)
+    {
+        char **aligned_text;
+        size_t aligned_size;
+        assert(translator_aligner_process(args->ta, "Hello", "en", "fr", &aligned_text, &aligned_size) == ERROR_SUCCESS);
+        assert(aligned_size == 2);
+        assert(strcmp(aligned_text[1], "[Token2] [Token2]") == 0);
+        free_aligned_text(aligned_text, aligned_size);
+    }
+    return NULL;
+}
+
+void test_translator_aligner_throughput()
+{
+    TranslatorAligner *ta = translator_aligner_create(&mock_slow_translation_service, &mock_alignment_service, mock_renderer);
+    assert(ta != NULL);
+    struct timespec start, end;
+
+    // One thread doing all the calls sets the baseline
+    reset_remote_calls();
+    ThroughputArgs serial = {ta, THROUGHPUT_THREADS * THROUGHPUT_CALLS};
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    throughput_worker(&serial);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double serial_time = elapsed_seconds(&start, &end);
+    assert(atomic_load(&remote_peak_in_flight) == 1);
+
+    reset_remote_calls();
+    pthread_t threads[THROUGHPUT_THREADS];
+    ThroughputArgs args = {ta, THROUGHPUT_CALLS};
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < THROUGHPUT_THREADS; i++)
+    {
+        assert(pthread_create(&threads[i], NULL, throughput_worker, &args) == 0);
+    }
+    for (size_t i = 0; i < THROUGHPUT_THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double parallel_time = elapsed_seconds(&start, &end);
+
+    printf("  %d calls: %.1f ms on 1 thread, %.1f ms on %d threads, at most %d at once\n", THROUGHPUT_THREADS * THROUGHPUT_CALLS,
+           serial_time * 1e3, parallel_time * 1e3, THROUGHPUT_THREADS, atomic_load(&remote_peak_in_flight));
+
+    // With per-call state only, concurrent remote calls overlap instead of queueing
+    assert(atomic_load(&remote_peak_in_flight) > 1);
+
+    translator_aligner_destroy(ta);
+    printf("test_translator_aligner_throughput() passed.\n");
+}
+
+static atomic_int completed_requests;
+
+static void count_completion(TranslationRequest *request, ErrorCode error, char **aligned_text, size_t aligned_size, void *user_data)
+{
+    assert(error == ERROR_SUCCESS);
+    assert(aligned_size == 2);
+    assert(strcmp(aligned_text[0], "[Token1] [Token1]") == 0);
+    assert(user_data == &completed_requests);
+    atomic_fetch_add(&completed_requests, 1);
+}
+
+void test_translator_aligner_submit()
+{
+    // Without an async hook the synchronous translate runs on a worker
+    TranslatorAligner *ta = translator_aligner_create(&mock_translation_service, &mock_alignment_service, mock_renderer);
+    TranslationRequest *request;
+    char **aligned_text;
+    size_t aligned_size;
+    assert(translator_aligner_submit(ta, "Hello", "en", "fr", NULL, NULL, &request) == ERROR_SUCCESS);
+    assert(translation_request_wait(request, &aligned_text, &aligned_size) == ERROR_SUCCESS);
+    assert(translation_request_is_done(request));
+    assert(aligned_size == 2);
+    assert(strcmp(aligned_text[1], "[Token2] [Token2]") == 0);
+    translation_request_release(request);
+    translator_aligner_destroy(ta);
+
+    // Hundreds of requests in flight on a handful of workers
+    ta = translator_aligner_create(&mock_async_translation_service, &mock_alignment_service, mock_renderer);
+    TranslationRequest *requests[ASYNC_REQUESTS];
+    atomic_init(&completed_requests, 0);
+    reset_remote_calls();
+
+    for (size_t i = 0; i < ASYNC_REQUESTS; i++)
+    {
+        assert(translator_aligner_submit(ta, "Hello", "en", "fr", count_completion, &completed_requests, &requests[i]) == ERROR_SUCCESS);
+    }
+    for (size_t i = 0; i < ASYNC_REQUESTS; i++)
+    {
+        assert(translation_request_wait(requests[i], NULL, NULL) == ERROR_SUCCESS);
+        translation_request_release(requests[i]);
+    }
+
+    assert(atomic_load(&completed_requests) == ASYNC_REQUESTS);
+    // Workers do not wait on the remote calls, so more are in flight than there are workers
+    printf("  %d requests on %zu workers, at most %d remote calls at once\n", ASYNC_REQUESTS,
+           limdy_thread_pool_size(ta->workers), atomic_load(&remote_peak_in_flight));
+    assert((size_t)atomic_load(&remote_peak_in_flight) > limdy_thread_pool_size(ta->workers));
+
+    translator_aligner_destroy(ta);
+    printf("test_translator_aligner_submit() passed.\n");
+}
+
 void test_error_handling()
 {
     error_set_handler(test_error_handler);
@@ -174,7 +830,7 @@ void test_error_handling()
     assert(last_error.code == ERROR_NULL_POINTER);
 
     // Test invalid input error
-    TranslatorAligner *ta = translator_aligner_create(&mock_translation_service, &mock_alignment_service, &mock_renderer);
+    TranslatorAligner *ta = translator_aligner_create(&mock_translation_service, &mock_alignment_service, mock_renderer);
     char **aligned_text;
     size_t aligned_size;
     ErrorCode error = translator_aligner_process(ta, NULL, "en", "fr", &aligned_text, &aligned_size);
@@ -189,15 +845,26 @@ void test_error_handling()
 int main()
 {
     error_init();
+    assert(limdy_memory_pool_init(&test_config) == ERROR_SUCCESS);
+    mock_renderer_create();
 
     test_translator_create();
     test_translator_translate();
+    test_translator_memory();
+    test_translator_result_pools();
+    test_translator_translate_stream();
     test_aligner_create();
     test_aligner_align();
+    test_aligner_align_result();
     test_translator_aligner_create();
     test_translator_aligner_process();
+    test_translator_aligner_process_batch();
+    test_translator_aligner_throughput();
+    test_translator_aligner_submit();
     test_error_handling();
 
+    mock_renderer_destroy();
+    limdy_memory_pool_cleanup();
     error_cleanup();
 
     printf("All tests passed successfully.\n");